@@ -38,6 +38,8 @@
 
 #include "client/instance.h"
 
+#include "core/util/timestamp.h"
+
 namespace kovri
 {
 namespace app
@@ -108,6 +110,8 @@ bool DaemonSingleton::Start()
 {
   try
     {
+      // Per-message paths read the cached coarse clock from here on
+      core::StartCoarseClock();
       m_Client->Start();
     }
   catch (...)
@@ -134,6 +138,7 @@ bool DaemonSingleton::Stop()
   try
     {
       m_Client->Stop();
+      core::StopCoarseClock();
     }
   catch (...)
     {
@@ -143,6 +148,8 @@ bool DaemonSingleton::Stop()
 
   LOG(info) << "DaemonSingleton: successfully stopped";
   LOG(info) << "Goodbye!";
+  // Drain asynchronously queued records before exit
+  core::StopLogging();
   return true;
 }
 
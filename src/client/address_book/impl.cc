@@ -46,6 +46,8 @@
 
 #include "core/router/net_db/impl.h"
 
+#include "core/util/file_writer.h"
+
 namespace kovri {
 namespace client {
 
@@ -195,12 +197,15 @@ void AddressBook::LoadSubscriptionFromPublisher() {
     LOG(debug) << "AddressBook: creating new storage instance";
     m_Storage = GetNewStorageInstance();
   }
-  // If so, see if we have addresses from subscription already saved
+  // If so, see if we have addresses from subscription already saved.
+  // The binary cache is preferred: restarts then skip re-parsing and
+  // re-decoding the textual entries
   // TODO(anonimal): in order to load new fresh subscriptions,
   // we need to remove and/or work around this block and m_SubscriptionIsLoaded
-  if (m_Storage->Load(m_Addresses)) {
+  if (m_Storage->LoadBinaryCache(m_Addresses) || m_Storage->Load(m_Addresses)) {
     // If so, we don't need to download from a publisher
     LOG(debug) << "AddressBook: subscription is already loaded";
+    PublishAddressIndex();
     m_SubscriptionIsLoaded = true;
     return;
   }
@@ -226,28 +231,54 @@ void AddressBook::DownloadSubscription() {
   // Get number of available publishers (guaranteed > 0)
   auto publisher_count = m_Subscribers.size();
   LOG(debug)
-    << "AddressBook: picking random subscription from total publisher count: "
-    << publisher_count;
-  // Pick a random publisher to subscribe from
-  // TODO(oneiric): download all subscriptions not already stored
-  auto publisher = kovri::core::RandInRange32(0, publisher_count - 1);
+    << "AddressBook: fetching subscription from all "
+    << publisher_count << " publishers concurrently";
+  // Fetch every publisher in parallel: over slow in-net tunnels the
+  // round completes as soon as the fastest publisher delivers
   m_SubscriberIsDownloading = true;
+  m_DownloadSucceeded = false;
+  m_PendingDownloads = publisher_count;
   try {
-    m_Subscribers.at(publisher)->DownloadSubscription();
+    for (auto& subscriber : m_Subscribers)
+      subscriber->DownloadSubscription();
   } catch (const std::exception& ex) {
     LOG(error) << "AddressBook: download subscription exception: " << ex.what();
+    m_SubscriberIsDownloading = false;
   } catch (...) {
     LOG(error) << "AddressBook: download subscription unknown exception";
+    m_SubscriberIsDownloading = false;
+  }
+}
+
+void AddressBook::SubscriberDownloadComplete(
+    bool success) {
+  if (success && !m_DownloadSucceeded.exchange(true)) {
+    // First publisher to deliver wins: reset the timer with the regular
+    // update timeout while the remaining fetches run to completion
+    HostsDownloadComplete(true);
+  }
+  if (!--m_PendingDownloads) {
+    m_SubscriberIsDownloading = false;
+    if (!m_DownloadSucceeded)
+      HostsDownloadComplete(false);  // every publisher failed
   }
-  // Ensure false here if exception occured before subscriber completed download
-  m_SubscriberIsDownloading = false;
 }
 
 void AddressBookSubscriber::DownloadSubscription() {
   // TODO(unassigned): exception handling
   LOG(debug) << "AddressBookSubscriber: creating thread for download";
-  std::thread download(&AddressBookSubscriber::DownloadSubscriptionImpl, this);
-  download.join();
+  // reap the previous round's thread; kept joinable (not detached) so
+  // shutdown can wait for it instead of destroying what it runs on
+  Join();
+  m_DownloadThread =
+      std::make_unique<std::thread>(
+          &AddressBookSubscriber::DownloadSubscriptionImpl, this);
+}
+
+void AddressBookSubscriber::Join() {
+  if (m_DownloadThread && m_DownloadThread->joinable())
+    m_DownloadThread->join();
+  m_DownloadThread.reset(nullptr);
 }
 
 void AddressBookSubscriber::DownloadSubscriptionImpl() {
@@ -258,14 +289,20 @@ void AddressBookSubscriber::DownloadSubscriptionImpl() {
     << " ETag: " << m_HTTP.GetPreviousETag()
     << " Last-Modified: " << m_HTTP.GetPreviousLastModified();
   bool download_result = m_HTTP.Download();
-  if (download_result) {
+  if (download_result && m_HTTP.IsNotModified()) {
+    // Conditional fetch answered 304: the catalog is current, so skip
+    // re-validating and re-decoding it wholesale
+    LOG(info)
+      << "AddressBookSubscriber: subscription unchanged, nothing to merge";
+  } else if (download_result && !m_Book.HasDownloadSucceeded()) {
+    // Skip validation/storage if another publisher already delivered
     std::stringstream stream(m_HTTP.GetDownloadedContents());
     if (!m_Book.SaveSubscription(stream)) {
       // Error during validation or storage, download again later
       download_result = false;
     }
   }
-  m_Book.HostsDownloadComplete(download_result);
+  m_Book.SubscriberDownloadComplete(download_result);
 }
 
 void AddressBook::HostsDownloadComplete(
@@ -293,7 +330,8 @@ bool AddressBook::SaveSubscription(
   std::unique_lock<std::mutex> lock(m_AddressBookMutex);
   m_SubscriptionIsLoaded = false;  // TODO(anonimal): see TODO for multiple subscriptions
   try {
-    auto addresses = ValidateSubscription(stream);
+    std::size_t num_known = 0;
+    auto addresses = ValidateSubscription(stream, num_known);
     if (!addresses.empty()) {
       LOG(debug) << "AddressBook: processing " << addresses.size() << " addresses";
       // Stream may be a file or downloaded stream.
@@ -301,13 +339,10 @@ bool AddressBook::SaveSubscription(
       // TODO(oneiric): save unique entries to userhosts.txt
       if (file_name.empty())  // Use default filename if none given.
         file_name = (core::GetPath(core::Path::AddressBook) / GetDefaultSubscriptionFilename()).string();
-      LOG(debug) << "AddressBook: opening subscription file " << file_name;
+      LOG(debug) << "AddressBook: saving subscription file " << file_name;
       // TODO(anonimal): move file saving to storage class?
-      std::ofstream file;
-      file.open(file_name);
-      if (!file)
-        throw std::runtime_error("AddressBook: could not open subscription " + file_name);
       // Save hosts and matching identities
+      std::string lines;
       for (auto const& address : addresses) {
         const std::string& host = address.first;
         const auto& ident = address.second;
@@ -316,8 +351,7 @@ bool AddressBook::SaveSubscription(
             // Only stores subscription lines for addresses not already loaded
             InsertAddress(host, ident.GetIdentHash(), SubscriptionType::Default);
             // Write/overwrite Hostname=Base64Address pairing to subscription file
-            // TODO(anonimal): this is not optimal, especially for large subscriptions
-            file << host << "=" << ident.ToBase64() << '\n';
+            lines += host + "=" + ident.ToBase64() + '\n';
             m_Storage->AddAddress(ident);
           }
         catch (...)
@@ -326,10 +360,27 @@ bool AddressBook::SaveSubscription(
             continue;
           }
       }
-      // Flush subscription file
-      file << std::flush;
+      // Queue all pairings as one write so the subscription processing
+      // thread never blocks on disk. When merging into entries loaded on
+      // a previous cycle, append the new ones; a first load still
+      // overwrites any stale file
+      kovri::core::file_writer.QueueWrite(
+          file_name,
+          std::vector<std::uint8_t>(lines.begin(), lines.end()),
+          num_known != 0);
       // Save a *list* of hosts within subscription to a catalog (CSV) file
       m_Storage->Save(m_Addresses);
+      // Write the merged state to the binary cache so the next start
+      // skips re-parsing
+      m_Storage->SaveBinaryCache(m_Addresses);
+      PublishAddressIndex();
+      m_SubscriptionIsLoaded = true;
+    } else if (num_known) {
+      // Every entry was merged on a previous cycle: the loaded book and
+      // its caches are already current
+      LOG(debug)
+        << "AddressBook: subscription unchanged, "
+        << num_known << " entries already loaded";
       m_SubscriptionIsLoaded = true;
     }
   } catch (...) {
@@ -341,7 +392,9 @@ bool AddressBook::SaveSubscription(
 // TODO(anonimal): unit-test
 
 const std::map<std::string, kovri::core::IdentityEx>
-AddressBook::ValidateSubscription(std::istream& stream) {
+AddressBook::ValidateSubscription(
+    std::istream& stream,
+    std::size_t& num_known) {
   LOG(debug) << "AddressBook: validating subscription";
   // Map host to address identity
   std::map<std::string, kovri::core::IdentityEx> addresses;
@@ -367,6 +420,12 @@ AddressBook::ValidateSubscription(std::istream& stream) {
       std::size_t pos = line.find('=');
       if (pos != std::string::npos) {
         const std::string host = line.substr(0, pos++);
+        // Diff-merge: entries already loaded are skipped outright, with
+        // neither the hostname regex nor the Base64 decode
+        if (m_Addresses.find(host) != m_Addresses.end()) {
+          num_known++;
+          continue;
+        }
         const std::string addr = line.substr(pos);
         // Ensure only valid lines
         try
@@ -445,15 +504,29 @@ std::unique_ptr<const kovri::core::IdentHash> AddressBook::GetLoadedAddressIdent
   if (!m_SubscriptionIsLoaded)
     LoadSubscriptionFromPublisher();
   if (m_SubscriptionIsLoaded) {
-    auto it = m_Addresses.find(address);
-    if (it != m_Addresses.end()) {
-      return std::make_unique<const kovri::core::IdentHash>(
-          std::get<kovri::core::IdentHash>(it->second));
+    // Lock-free: look up in the current immutable index snapshot
+    const auto index = std::atomic_load(&m_AddressIndex);
+    if (index) {
+      auto it = index->find(address);
+      if (it != index->end())
+        return std::make_unique<const kovri::core::IdentHash>(it->second);
     }
   }
   return nullptr;
 }
 
+void AddressBook::PublishAddressIndex()
+{
+  auto index = std::make_shared<AddressIndex>();
+  index->reserve(m_Addresses.size());
+  for (const auto& entry : m_Addresses)
+    index->emplace(
+        entry.first, std::get<kovri::core::IdentHash>(entry.second));
+  std::atomic_store(
+      &m_AddressIndex,
+      std::shared_ptr<const AddressIndex>(std::move(index)));
+}
+
 // TODO(unassigned): return bool
 void AddressBook::InsertAddress(
     const std::string& host,
@@ -493,6 +566,7 @@ void AddressBook::InsertAddressIntoStorage(
       ident.FromBase64(base64);
       const auto& ident_hash = ident.GetIdentHash();
       InsertAddress(address, ident_hash, SubscriptionType::User);
+      PublishAddressIndex();
       if (!m_Storage)
         m_Storage = GetNewStorageInstance();
       m_Storage->AddAddress(ident);
@@ -526,12 +600,19 @@ void AddressBook::Stop() {
       }
       std::this_thread::sleep_for(std::chrono::seconds(1));
     }
-    LOG(error) << "AddressBook: subscription download hangs";
+    if (m_SubscriberIsDownloading)
+      LOG(error) << "AddressBook: subscription download hangs";
     m_SubscriberIsDownloading = false;
   }
+  // Join download threads before tearing anything down: they run on the
+  // subscriber objects and touch storage, so the bounded wait above is
+  // only a courtesy — the join is what makes the destruction safe
+  for (auto& subscriber : m_Subscribers)
+    subscriber->Join();
   // Save addresses to storage
   if (m_Storage) {
     m_Storage->Save(m_Addresses);
+    m_Storage->SaveBinaryCache(m_Addresses);
     m_Storage.reset(nullptr);
   }
   m_Subscribers.clear();
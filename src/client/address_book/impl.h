@@ -42,6 +42,8 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "client/address_book/storage.h"
@@ -107,7 +109,9 @@ class AddressBook : public AddressBookDefaults {
         m_SubscriberUpdateTimer(nullptr),
         m_SubscriptionIsLoaded(false),
         m_PublishersLoaded(false),
-        m_SubscriberIsDownloading(false) {}
+        m_SubscriberIsDownloading(false),
+        m_DownloadSucceeded(false),
+        m_PendingDownloads(0) {}
 
   /// @brief Starts address book fetching and processing of spec-related files
   /// @param local_destination Shared pointer to destination instance used to
@@ -182,10 +186,16 @@ class AddressBook : public AddressBookDefaults {
       std::string file_name = "");
 
   /// @brief Validates subscription, saves hosts to file
+  /// @details Hosts already present in the loaded address book are
+  ///   counted and skipped without a regex pass or Base64 decode, so a
+  ///   refresh costs proportional to the new entries
   /// @param stream Stream to process
-  /// @return Vector of paired hostname to identity
+  /// @param num_known Incremented for every entry already loaded
+  /// @return Vector of paired hostname to identity (new entries only)
   const std::map<std::string, kovri::core::IdentityEx>
-  ValidateSubscription(std::istream& stream);
+  ValidateSubscription(
+      std::istream& stream,
+      std::size_t& num_known);
 
   /// @brief Sets the download state as complete and resets timer as needed
   /// @details Resets update timer according to the state of completed download
@@ -195,6 +205,21 @@ class AddressBook : public AddressBookDefaults {
   void HostsDownloadComplete(
       bool success);
 
+  /// @brief Aggregates results of the concurrent publisher fetches
+  /// @details The first successful fetch short-circuits the round; the
+  ///   remaining fetches are ignored as they complete. The round ends
+  ///   (and the timer resets with a failure timeout) only when every
+  ///   publisher failed
+  /// @param success True if this publisher's fetch succeeded
+  void SubscriberDownloadComplete(
+      bool success);
+
+  /// @brief Has a publisher already delivered this round's subscription?
+  /// @notes Lets remaining fetches skip validation/storage of their copy
+  bool HasDownloadSucceeded() const {
+    return m_DownloadSucceeded;
+  }
+
   /// @brief Returns identity hash's .b32.i2p address
   /// @param ident Const reference to identity hash
   /// @return Identity hash's .b32.i2p address
@@ -248,6 +273,15 @@ class AddressBook : public AddressBookDefaults {
   /// @details Cancels update requests to publishers
   void StopSubscribing();
 
+  /// @alias AddressIndex
+  /// @brief Hash index of hostname to identity hash for read-mostly lookups
+  using AddressIndex = std::unordered_map<std::string, kovri::core::IdentHash>;
+
+  /// @brief Publishes a fresh lookup index snapshot built from m_Addresses
+  /// @details Readers atomically load the previous snapshot lock-free while
+  ///   the new one is built; call after any batch of address insertions
+  void PublishAddressIndex();
+
  private:
   /// @brief Exception handler
   core::Exception m_Exception;
@@ -265,6 +299,11 @@ class AddressBook : public AddressBookDefaults {
   /// @brief Map of human readable addresses to identity hashes and subscription source
   AddressMap m_Addresses;
 
+  /// @var m_AddressIndex
+  /// @brief Immutable lookup index snapshot, swapped atomically on update
+  /// @notes Proxy-path lookups load the snapshot without taking a mutex
+  std::shared_ptr<const AddressIndex> m_AddressIndex;
+
   /// @var m_Storage
   /// @brief Unique pointer to address book storage implementation
   std::unique_ptr<AddressBookStorage> m_Storage;
@@ -289,6 +328,14 @@ class AddressBook : public AddressBookDefaults {
   /// @var m_SubscriberIsDownloading
   /// @brief Are subscriptions in the process of being downloaded?
   std::atomic<bool> m_SubscriberIsDownloading;
+
+  /// @var m_DownloadSucceeded
+  /// @brief Has any publisher delivered a subscription this round?
+  std::atomic<bool> m_DownloadSucceeded;
+
+  /// @var m_PendingDownloads
+  /// @brief Publisher fetches still in flight this round
+  std::atomic<std::size_t> m_PendingDownloads;
 };
 
 /// @class AddressBookSubscriber
@@ -302,14 +349,28 @@ class AddressBookSubscriber {
       : m_Book(book),
         m_HTTP(uri) {}
 
+  /// @brief Joins an outstanding download thread before destruction
+  ~AddressBookSubscriber() {
+    Join();
+  }
+
   /// @brief Instantiates thread that fetches in-net subscriptions
   void DownloadSubscription();
 
+  /// @brief Waits for the in-flight download thread, if any, to finish
+  /// @details Must run before this subscriber (or the book's storage) is
+  ///   destroyed: the thread runs on this object for the whole fetch
+  void Join();
+
  private:
   /// @brief Implementation for downloading subscription (hosts.txt)
   /// @warning Must be run in separate thread
   void DownloadSubscriptionImpl();
 
+  /// @var m_DownloadThread
+  /// @brief Thread running DownloadSubscriptionImpl for the current round
+  std::unique_ptr<std::thread> m_DownloadThread;
+
   /// @var m_Book
   /// @brief Reference to address book implementation
   AddressBook& m_Book;
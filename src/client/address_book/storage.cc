@@ -32,11 +32,27 @@
 
 #include "client/address_book/storage.h"
 
+#include <array>
 #include <fstream>
+#include <vector>
+
+#include "core/util/byte_stream.h"
 
 namespace kovri {
 namespace client {
 
+namespace {
+/// @brief Binary address cache format constants
+/// @notes Layout: magic, version, record count, then records sorted by
+///   hostname: type byte, raw identity hash, hostname length, hostname
+enum BinaryCache : std::uint8_t {
+  Version = 1,
+};
+
+/// @brief Binary cache magic bytes ("KVAB": kovri address book)
+const std::array<std::uint8_t, 4> BinaryCacheMagic {{ 0x4B, 0x56, 0x41, 0x42 }};
+}  // namespace
+
 AddressBookStorage::AddressBookStorage() {
   kovri::core::EnsurePath(GetAddressesPath());
 }
@@ -146,5 +162,100 @@ std::size_t AddressBookStorage::Save(const AddressMap& addresses)
   return num;
 }
 
+std::size_t AddressBookStorage::LoadBinaryCache(AddressMap& addresses)
+{
+  auto filename = core::GetPath(core::Path::AddressBook)
+                  / GetDefaultAddressesBinaryFilename();
+  std::ifstream file(filename.string(), std::ifstream::binary);
+  if (!file) {
+    LOG(debug) << "AddressBookStorage: " << filename << " not found";
+    return 0;
+  }
+  // Read the whole cache in one pass; records are parsed in place
+  file.seekg(0, std::ios::end);
+  const std::size_t len = file.tellg();
+  file.seekg(0, std::ios::beg);
+  if (len < BinaryCacheMagic.size() + sizeof(std::uint8_t) + sizeof(std::uint32_t)) {
+    LOG(warning) << "AddressBookStorage: binary cache too short, ignoring";
+    return 0;
+  }
+  std::vector<std::uint8_t> buf(len);
+  if (!file.read(reinterpret_cast<char*>(buf.data()), len)) {
+    LOG(warning) << "AddressBookStorage: could not read binary cache";
+    return 0;
+  }
+  std::size_t num = 0;
+  try {
+    core::InputByteStream stream(buf.data(), buf.size());
+    // Reject caches from other formats or older writers
+    if (!std::equal(
+            BinaryCacheMagic.begin(),
+            BinaryCacheMagic.end(),
+            stream.ReadBytes(BinaryCacheMagic.size()))
+        || stream.Read<std::uint8_t>() != BinaryCache::Version) {
+      LOG(warning) << "AddressBookStorage: unknown binary cache format, ignoring";
+      return 0;
+    }
+    const std::uint32_t count = stream.Read<std::uint32_t>();
+    AddressMap loaded;
+    for (std::uint32_t entry = 0; entry < count; entry++) {
+      const auto type =
+          static_cast<SubscriptionType>(stream.Read<std::uint8_t>());
+      const kovri::core::IdentHash ident(
+          stream.ReadBytes(sizeof(kovri::core::IdentHash)));
+      const std::uint16_t host_len = stream.Read<std::uint16_t>();
+      if (!host_len || host_len > AddressBookSize::SubscriptionLine)
+        throw std::length_error("AddressBookStorage: invalid cached hostname");
+      const std::string host(
+          reinterpret_cast<const char*>(stream.ReadBytes(host_len)), host_len);
+      loaded[host] = std::make_pair(ident, type);
+      num++;
+    }
+    addresses.swap(loaded);
+  } catch (const std::exception& ex) {
+    // Corrupt/truncated cache: fall back to the textual formats
+    LOG(warning) << "AddressBookStorage: invalid binary cache: " << ex.what();
+    return 0;
+  }
+  LOG(debug) << "AddressBookStorage: " << num << " cached addresses loaded";
+  return num;
+}
+
+std::size_t AddressBookStorage::SaveBinaryCache(const AddressMap& addresses)
+{
+  auto filename = core::GetPath(core::Path::AddressBook)
+                  / GetDefaultAddressesBinaryFilename();
+  // Compute total record size (map iteration keeps records hostname-sorted)
+  std::size_t len =
+      BinaryCacheMagic.size() + sizeof(std::uint8_t) + sizeof(std::uint32_t);
+  for (auto const& it : addresses)
+    len += sizeof(std::uint8_t) + sizeof(kovri::core::IdentHash)
+           + sizeof(std::uint16_t) + it.first.size();
+  core::OutputByteStream stream(len);
+  stream.WriteData(BinaryCacheMagic.data(), BinaryCacheMagic.size());
+  stream.Write<std::uint8_t>(BinaryCache::Version);
+  stream.Write<std::uint32_t>(addresses.size());
+  std::size_t num = 0;
+  for (auto const& it : addresses) {
+    stream.Write<std::uint8_t>(
+        static_cast<std::uint8_t>(std::get<SubscriptionType>(it.second)));
+    stream.WriteData(
+        std::get<kovri::core::IdentHash>(it.second),
+        sizeof(kovri::core::IdentHash));
+    stream.Write<std::uint16_t>(it.first.size());
+    stream.WriteData(
+        reinterpret_cast<const std::uint8_t*>(it.first.data()),
+        it.first.size());
+    num++;
+  }
+  kovri::core::OutputFileStream file(filename.string(), std::ofstream::binary);
+  if (!file.Good() || !file.Write(stream.data(), stream.size())) {
+    LOG(error) << "AddressBookStorage: can't write binary cache " << filename;
+    return 0;
+  }
+  LOG(debug) << "AddressBookStorage: " << num << " addresses cached";
+  return num;
+}
+
 }  // namespace client
 }  // namespace kovri
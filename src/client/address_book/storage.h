@@ -121,6 +121,14 @@ struct AddressBookDefaults {
   std::string GetDefaultAddressesFilename() const {
     return "addresses.csv";
   }
+
+  /// @brief Gets binary address cache filename
+  /// @return Default binary cache filename
+  /// @notes Compact sorted records written after validation so restarts
+  ///   skip re-parsing and re-decoding the textual subscription
+  std::string GetDefaultAddressesBinaryFilename() const {
+    return "addresses.bin";
+  }
 };
 
 /// @class AddressBookStorage
@@ -162,6 +170,20 @@ class AddressBookStorage : public AddressBookDefaults {
   /// @param addresses Const reference to map of human-readable address to b32 hashes of address
   std::size_t Save(const AddressMap& addresses);
 
+  /// @brief Loads addresses from the binary cache file into memory
+  /// @return Number of addresses loaded (0 if cache is missing or invalid)
+  /// @param addresses Reference to map of human-readable addresses to hashes
+  /// @notes Records carry raw identity hashes, so loading avoids the
+  ///   per-entry Base32/Base64 decoding of the textual formats
+  std::size_t LoadBinaryCache(AddressMap& addresses);
+
+  /// @brief Saves addresses to the binary cache file
+  /// @return Number of addresses saved
+  /// @param addresses Const reference to map of human-readable addresses to hashes
+  /// @notes Written after validation; a stale or corrupt cache is simply
+  ///   ignored on load and rebuilt from the subscription
+  std::size_t SaveBinaryCache(const AddressMap& addresses);
+
  private:
   /// @return Address book path with appended addresses location
   boost::filesystem::path GetAddressesPath() const {
@@ -41,11 +41,13 @@
 #include "core/crypto/hash.h"
 #include "core/crypto/rand.h"
 #include "core/crypto/util/compression.h"
+#include "core/crypto/util/misc.h"
 
 #include "core/router/context.h"
 #include "core/router/tunnel/base.h"
 
 #include "core/util/log.h"
+#include "core/util/timestamp.h"
 
 namespace kovri {
 namespace client {
@@ -122,25 +124,102 @@ void DatagramDestination::SendDatagramTo(
     } else {
       m_Owner.Sign(buf1, len, signature);
     }
-    std::unique_ptr<kovri::core::I2NPMessage> msg
-        = CreateDataMessage(buf, len + header_len, from_port, to_port);
-    std::shared_ptr<const kovri::core::LeaseSet> remote
-        = m_Owner.FindLeaseSet(ident);
+    SendRawDatagram(
+        buf,
+        len + header_len,
+        ident,
+        from_port,
+        to_port,
+        kovri::client::PROTOCOL_TYPE_DATAGRAM);
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+    throw;
+  }
+}
 
-    ReleasableSharedPtr<kovri::core::I2NPMessage> temp_msg
-        = make_releasable_shared_ptr(msg.release());
-    if (remote) {
-      m_Owner.GetService().post([this, temp_msg, remote] {
-        SendMsg(std::unique_ptr<kovri::core::I2NPMessage>(release(temp_msg)), remote);
-      });
+void DatagramDestination::SendSessionDatagramTo(
+    const std::uint8_t* payload,
+    std::size_t len,
+    const kovri::core::IdentHash& ident,
+    std::uint16_t from_port,
+    std::uint16_t to_port) {
+  // TODO(anonimal): this try block should be larger or handled entirely by caller
+  try {
+    auto it = m_OutgoingSessions.find(ident);
+    if (it == m_OutgoingSessions.end()) {
+      OutgoingSession session;
+      do
+        session.session_ID = kovri::core::Rand<std::uint32_t>();
+      while (!session.session_ID);
+      kovri::core::RandBytes(session.key(), DATAGRAM_SESSION_KEY_SIZE);
+      session.last_establish_time = 0;
+      session.sent_since_establish = 0;
+      it = m_OutgoingSessions.insert(std::make_pair(ident, session)).first;
+    }
+    auto& session = it->second;
+    // the establishment itself is an unreliable datagram, so repeat it
+    // on a time and packet budget; the receiver treats a repeat as a
+    // plain key refresh
+    const auto now = kovri::core::GetSecondsSinceEpoch();
+    const bool establish =
+        !session.last_establish_time
+        || now - session.last_establish_time
+               >= DATAGRAM_SESSION_REFRESH_TIMEOUT
+        || session.sent_since_establish >= DATAGRAM_SESSION_REFRESH_PACKETS;
+    std::uint8_t buf[MAX_DATAGRAM_SIZE];
+    std::size_t size = 0;
+    if (establish) {
+      // signed establishment datagram, carrying the session key
+      // and the first payload
+      buf[size] = DATAGRAM_SESSION_ESTABLISH;
+      size++;
+      auto identity_len =
+        m_Owner.GetIdentity().ToBuffer(buf + size, MAX_DATAGRAM_SIZE - size);
+      size += identity_len;
+      std::uint8_t* signature = buf + size;
+      auto signature_len = m_Owner.GetIdentity().GetSignatureLen();
+      size += signature_len;
+      std::uint8_t* signed_part = buf + size;
+      core::OutputByteStream::Write<std::uint32_t>(
+          buf + size, session.session_ID);
+      size += 4;
+      memcpy(buf + size, session.key(), DATAGRAM_SESSION_KEY_SIZE);
+      size += DATAGRAM_SESSION_KEY_SIZE;
+      memcpy(buf + size, payload, len);
+      size += len;
+      std::size_t signed_len = size - (signed_part - buf);
+      if (m_Owner.GetIdentity().GetSigningKeyType()
+          == kovri::core::SIGNING_KEY_TYPE_DSA_SHA1) {
+        std::uint8_t hash[32];
+        kovri::core::SHA256().CalculateDigest(hash, signed_part, signed_len);
+        m_Owner.Sign(hash, 32, signature);
+      } else {
+        m_Owner.Sign(signed_part, signed_len, signature);
+      }
+      session.last_establish_time = now;
+      session.sent_since_establish = 0;
     } else {
-      m_Owner.RequestDestination(
-          ident,
-          [this, temp_msg](const std::shared_ptr<kovri::core::LeaseSet>& remote) {
-            HandleLeaseSetRequestComplete(
-                remote, std::unique_ptr<kovri::core::I2NPMessage>(release(temp_msg)));
-          });
+      // data datagram: session ID + HMAC instead of identity + signature
+      buf[size] = DATAGRAM_SESSION_DATA;
+      size++;
+      core::OutputByteStream::Write<std::uint32_t>(
+          buf + size, session.session_ID);
+      size += 4;
+      CalculateSessionMAC(
+          session.session_ID, session.key, payload, len, buf + size);
+      size += DATAGRAM_SESSION_MAC_SIZE;
+      memcpy(buf + size, payload, len);
+      size += len;
+      session.sent_since_establish++;
     }
+    SendRawDatagram(
+        buf,
+        size,
+        ident,
+        from_port,
+        to_port,
+        kovri::client::PROTOCOL_TYPE_DATAGRAM_SESSION);
   } catch (...) {
     m_Exception.Dispatch(__func__);
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
@@ -148,6 +227,47 @@ void DatagramDestination::SendDatagramTo(
   }
 }
 
+void DatagramDestination::SendRawDatagram(
+    const std::uint8_t* buf,
+    std::size_t len,
+    const kovri::core::IdentHash& ident,
+    std::uint16_t from_port,
+    std::uint16_t to_port,
+    std::uint8_t protocol) {
+  std::unique_ptr<kovri::core::I2NPMessage> msg
+      = CreateDataMessage(buf, len, from_port, to_port, protocol);
+  std::shared_ptr<const kovri::core::LeaseSet> remote
+      = m_Owner.FindLeaseSet(ident);
+
+  ReleasableSharedPtr<kovri::core::I2NPMessage> temp_msg
+      = make_releasable_shared_ptr(msg.release());
+  if (remote) {
+    m_Owner.GetService().post([this, temp_msg, remote] {
+      SendMsg(std::unique_ptr<kovri::core::I2NPMessage>(release(temp_msg)), remote);
+    });
+  } else {
+    m_Owner.RequestDestination(
+        ident,
+        [this, temp_msg](const std::shared_ptr<kovri::core::LeaseSet>& remote) {
+          HandleLeaseSetRequestComplete(
+              remote, std::unique_ptr<kovri::core::I2NPMessage>(release(temp_msg)));
+        });
+  }
+}
+
+void DatagramDestination::CalculateSessionMAC(
+    std::uint32_t session_id,
+    const kovri::core::MACKey& key,
+    const std::uint8_t* payload,
+    std::size_t len,
+    std::uint8_t* digest) {
+  // SHA-256 bound to the session ID, then HMAC-MD5 under the session key
+  std::uint8_t hash[36];
+  core::OutputByteStream::Write<std::uint32_t>(hash, session_id);
+  kovri::core::SHA256().CalculateDigest(hash + 4, payload, len);
+  kovri::core::HMACMD5Digest(hash, sizeof(hash), key, digest);
+}
+
 void DatagramDestination::HandleLeaseSetRequestComplete(
     std::shared_ptr<kovri::core::LeaseSet> remote,
     std::unique_ptr<kovri::core::I2NPMessage> msg) {
@@ -167,12 +287,12 @@ void DatagramDestination::SendMsg(
         remote,
         ToSharedI2NPMessage(std::move(msg)),
         true);
-    msgs.push_back(
-        kovri::core::TunnelMessageBlock{kovri::core::e_DeliveryTypeTunnel,
-                                        leases[i].tunnel_gateway,
-                                        leases[i].tunnel_ID,
-                                        garlic});
-    outbound_tunnel->SendTunnelDataMsg(msgs);
+    msgs.emplace_back(
+        kovri::core::e_DeliveryTypeTunnel,
+        leases[i].tunnel_gateway,
+        leases[i].tunnel_ID,
+        std::move(garlic));
+    outbound_tunnel->SendTunnelDataMsg(std::move(msgs));
   } else {
     if (outbound_tunnel)
       LOG(warning) << "DatagramDestination: failed to send: all leases expired";
@@ -202,15 +322,8 @@ void DatagramDestination::HandleDatagram(
         identity.Verify(buf + header_len, len - header_len, signature);
     }
     if (verified) {
-      auto it = m_ReceiversByPorts.find(to_port);
-      if (it != m_ReceiversByPorts.end())
-          it->second(
-              identity, from_port, to_port, buf + header_len, len - header_len);
-      else if (m_Receiver != nullptr)
-          m_Receiver(
-              identity, from_port, to_port, buf + header_len, len - header_len);
-      else
-          LOG(warning) << "DatagramDestination: receiver for datagram is not set";
+      DeliverDatagram(
+          identity, from_port, to_port, buf + header_len, len - header_len);
     } else {
       LOG(warning)
         << "DatagramDestination: datagram signature verification failed";
@@ -222,6 +335,111 @@ void DatagramDestination::HandleDatagram(
   }
 }
 
+void DatagramDestination::HandleSessionDatagram(
+    std::uint16_t from_port,
+    std::uint16_t to_port,
+    const std::uint8_t* buf,
+    std::size_t len) {
+  // TODO(anonimal): this try block should be handled entirely by caller
+  try {
+    if (!len) {
+      LOG(warning) << "DatagramDestination: empty session datagram";
+      return;
+    }
+    const std::uint8_t type = buf[0];
+    std::size_t offset = 1;
+    if (type == DATAGRAM_SESSION_ESTABLISH) {
+      kovri::core::IdentityEx identity;
+      offset += identity.FromBuffer(buf + offset, len - offset);
+      const std::uint8_t* signature = buf + offset;
+      offset += identity.GetSignatureLen();
+      if (len < offset + 4 + DATAGRAM_SESSION_KEY_SIZE) {
+        LOG(warning)
+          << "DatagramDestination: truncated session establishment";
+        return;
+      }
+      const std::uint8_t* signed_part = buf + offset;
+      std::size_t signed_len = len - offset;
+      bool verified = false;
+      if (identity.GetSigningKeyType()
+          == kovri::core::SIGNING_KEY_TYPE_DSA_SHA1) {
+        std::uint8_t hash[32];
+        kovri::core::SHA256().CalculateDigest(hash, signed_part, signed_len);
+        verified = identity.Verify(hash, 32, signature);
+      } else {
+        verified = identity.Verify(signed_part, signed_len, signature);
+      }
+      if (!verified) {
+        LOG(warning)
+          << "DatagramDestination: session establishment verification failed";
+        return;
+      }
+      auto const session_id =
+          core::InputByteStream::Read<std::uint32_t>(buf + offset);
+      offset += 4;
+      IncomingSession session;
+      session.identity = identity;
+      session.key = kovri::core::MACKey(buf + offset);
+      offset += DATAGRAM_SESSION_KEY_SIZE;
+      // re-establishment simply replaces the session key
+      m_IncomingSessions[session_id] = session;
+      DeliverDatagram(identity, from_port, to_port, buf + offset, len - offset);
+    } else if (type == DATAGRAM_SESSION_DATA) {
+      if (len < offset + 4 + DATAGRAM_SESSION_MAC_SIZE) {
+        LOG(warning) << "DatagramDestination: truncated session datagram";
+        return;
+      }
+      auto const session_id =
+          core::InputByteStream::Read<std::uint32_t>(buf + offset);
+      offset += 4;
+      auto it = m_IncomingSessions.find(session_id);
+      if (it == m_IncomingSessions.end()) {
+        // establishment was lost, or the session was never opened; drop,
+        // the sender repeats the establishment on a time/packet budget
+        LOG(warning)
+          << "DatagramDestination: datagram for unknown session "
+          << session_id;
+        return;
+      }
+      const std::uint8_t* mac = buf + offset;
+      offset += DATAGRAM_SESSION_MAC_SIZE;
+      std::uint8_t digest[DATAGRAM_SESSION_MAC_SIZE];
+      CalculateSessionMAC(
+          session_id, it->second.key, buf + offset, len - offset, digest);
+      if (!kovri::core::ConstTimeCmp(digest, mac, DATAGRAM_SESSION_MAC_SIZE)) {
+        LOG(warning)
+          << "DatagramDestination: session datagram MAC verification failed";
+        return;
+      }
+      DeliverDatagram(
+          it->second.identity, from_port, to_port, buf + offset, len - offset);
+    } else {
+      LOG(warning)
+        << "DatagramDestination: unexpected session datagram type "
+        << static_cast<std::uint16_t>(type);
+    }
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+    throw;
+  }
+}
+
+void DatagramDestination::DeliverDatagram(
+    const kovri::core::IdentityEx& from,
+    std::uint16_t from_port,
+    std::uint16_t to_port,
+    const std::uint8_t* buf,
+    std::size_t len) {
+  auto it = m_ReceiversByPorts.find(to_port);
+  if (it != m_ReceiversByPorts.end())
+    it->second(from, from_port, to_port, buf, len);
+  else if (m_Receiver != nullptr)
+    m_Receiver(from, from_port, to_port, buf, len);
+  else
+    LOG(warning) << "DatagramDestination: receiver for datagram is not set";
+}
+
 void DatagramDestination::HandleDataMessagePayload(
     std::uint16_t from_port,
     std::uint16_t to_port,
@@ -229,7 +447,7 @@ void DatagramDestination::HandleDataMessagePayload(
     std::size_t len) {
   // Gunzip it
   try {
-    kovri::core::Gunzip decompressor;
+    auto& decompressor = kovri::core::ThreadLocalGunzip();
     decompressor.Put(buf, len);
     std::uint8_t uncompressed[MAX_DATAGRAM_SIZE];
     auto uncompressed_len = decompressor.MaxRetrievable();
@@ -247,15 +465,43 @@ void DatagramDestination::HandleDataMessagePayload(
   }
 }
 
+void DatagramDestination::HandleSessionDataMessagePayload(
+    std::uint16_t from_port,
+    std::uint16_t to_port,
+    const std::uint8_t* buf,
+    std::size_t len) {
+  // Gunzip it
+  try {
+    auto& decompressor = kovri::core::ThreadLocalGunzip();
+    decompressor.Put(buf, len);
+    std::uint8_t uncompressed[MAX_DATAGRAM_SIZE];
+    auto uncompressed_len = decompressor.MaxRetrievable();
+    if (uncompressed_len <= MAX_DATAGRAM_SIZE) {
+      decompressor.Get(uncompressed, uncompressed_len);
+      HandleSessionDatagram(from_port, to_port, uncompressed, uncompressed_len);
+    } else {
+      LOG(warning)
+        << "DatagramDestination: the received session datagram size "
+        << uncompressed_len << " exceeds max size";
+    }
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+  }
+}
+
 // TODO(anonimal): bytestream refactor
 std::unique_ptr<kovri::core::I2NPMessage> DatagramDestination::CreateDataMessage(
     const std::uint8_t* payload,
     std::size_t len,
     std::uint16_t from_port,
-    std::uint16_t to_port) {
+    std::uint16_t to_port,
+    std::uint8_t protocol) {
   std::unique_ptr<kovri::core::I2NPMessage> msg = kovri::core::NewI2NPMessage();
-  kovri::core::Gzip compressor;  // default level
+  auto& compressor = kovri::core::ThreadLocalGzip();
   try {
+    // store-only when the application payload is already compressed
+    compressor.SetDeflateLevelFor(payload, len);
     compressor.Put(payload, len);
     std::size_t size = compressor.MaxRetrievable();
     std::uint8_t* buf = msg->GetPayload();
@@ -264,7 +510,7 @@ std::unique_ptr<kovri::core::I2NPMessage> DatagramDestination::CreateDataMessage
     compressor.Get(buf, size);
     core::OutputByteStream::Write<std::uint16_t>(buf + 4, from_port);  // source port
     core::OutputByteStream::Write<std::uint16_t>(buf + 6, to_port);  // destination port
-    buf[9] = kovri::client::PROTOCOL_TYPE_DATAGRAM;  // datagram protocol
+    buf[9] = protocol;  // datagram protocol (plain or session mode)
     msg->len += size + 4;
     msg->FillI2NPMessageHeader(kovri::core::I2NPData);
   } catch (...) {
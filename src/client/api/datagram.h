@@ -38,6 +38,9 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <unordered_map>
+
+#include "core/crypto/hmac.h"
 
 #include "core/router/i2np.h"
 #include "core/router/identity.h"
@@ -52,6 +55,22 @@ class ClientDestination;  // TODO(unassigned): remove forward declaration
 
 const std::size_t MAX_DATAGRAM_SIZE = 32768;
 
+// Session-mode datagrams (PROTOCOL_TYPE_DATAGRAM_SESSION, kovri extension):
+// only the establishment datagram carries a destination signature; data
+// datagrams are authenticated with HMAC-MD5 under the session key. The key
+// travels inside the establishment datagram, which (like every datagram)
+// is garlic-encrypted end to end
+const std::uint8_t DATAGRAM_SESSION_ESTABLISH = 0;
+const std::uint8_t DATAGRAM_SESSION_DATA = 1;
+const std::size_t DATAGRAM_SESSION_KEY_SIZE = 32;
+const std::size_t DATAGRAM_SESSION_MAC_SIZE = 16;
+// Establishment datagrams travel unreliably like everything else, so the
+// sender repeats them: after this many seconds or this many data
+// datagrams, whichever comes first, so a lost establishment can only
+// blackhole a bounded window of traffic
+const std::uint64_t DATAGRAM_SESSION_REFRESH_TIMEOUT = 30;  // seconds
+const std::uint32_t DATAGRAM_SESSION_REFRESH_PACKETS = 64;
+
 class DatagramDestination {
   typedef std::function<void (
       const kovri::core::IdentityEx& from,
@@ -73,12 +92,29 @@ class DatagramDestination {
       std::uint16_t from_port = 0,
       std::uint16_t to_port = 0);
 
+  /// @brief Sends a datagram over an HMAC-authenticated session to ident,
+  ///   establishing the session (one signed datagram) on first use.
+  ///   Subsequent datagrams skip the per-packet destination signature,
+  ///   which is the CPU bottleneck for high-rate unordered traffic
+  void SendSessionDatagramTo(
+      const std::uint8_t* payload,
+      std::size_t len,
+      const kovri::core::IdentHash& ident,
+      std::uint16_t from_port = 0,
+      std::uint16_t to_port = 0);
+
   void HandleDataMessagePayload(
       std::uint16_t from_port,
       std::uint16_t to_port,
       const std::uint8_t* buf,
       std::size_t len);
 
+  void HandleSessionDataMessagePayload(
+      std::uint16_t from_port,
+      std::uint16_t to_port,
+      const std::uint8_t* buf,
+      std::size_t len);
+
   void SetReceiver(
       const Receiver& receiver) {
     m_Receiver = receiver;
@@ -100,6 +136,18 @@ class DatagramDestination {
   }
 
  private:
+  struct OutgoingSession {
+    std::uint32_t session_ID;
+    kovri::core::MACKey key;
+    std::uint64_t last_establish_time;  // seconds; 0 = never sent
+    std::uint32_t sent_since_establish;  // data datagrams since then
+  };
+
+  struct IncomingSession {
+    kovri::core::IdentityEx identity;
+    kovri::core::MACKey key;
+  };
+
   void HandleLeaseSetRequestComplete(
       std::shared_ptr<kovri::core::LeaseSet> lease_set,
       std::unique_ptr<kovri::core::I2NPMessage> msg);
@@ -108,7 +156,18 @@ class DatagramDestination {
       const std::uint8_t* payload,
       std::size_t len,
       std::uint16_t from_port,
-      std::uint16_t to_port);
+      std::uint16_t to_port,
+      std::uint8_t protocol);
+
+  /// @brief Wraps a built datagram buffer and routes it to ident,
+  ///   requesting the LeaseSet first if necessary
+  void SendRawDatagram(
+      const std::uint8_t* buf,
+      std::size_t len,
+      const kovri::core::IdentHash& ident,
+      std::uint16_t from_port,
+      std::uint16_t to_port,
+      std::uint8_t protocol);
 
   void SendMsg(
       std::unique_ptr<kovri::core::I2NPMessage> msg,
@@ -120,10 +179,36 @@ class DatagramDestination {
       const std::uint8_t* buf,
       std::size_t len);
 
+  void HandleSessionDatagram(
+      std::uint16_t from_port,
+      std::uint16_t to_port,
+      const std::uint8_t* buf,
+      std::size_t len);
+
+  /// @brief Session-mode authenticator: HMAC-MD5 over the SHA-256 of the
+  ///   payload bound to the session ID. Hashing first keeps arbitrary
+  ///   datagram sizes within the single-block HMAC helper's limit
+  void CalculateSessionMAC(
+      std::uint32_t session_id,
+      const kovri::core::MACKey& key,
+      const std::uint8_t* payload,
+      std::size_t len,
+      std::uint8_t* digest);
+
+  /// @brief Hands a verified datagram payload to the port's receiver
+  void DeliverDatagram(
+      const kovri::core::IdentityEx& from,
+      std::uint16_t from_port,
+      std::uint16_t to_port,
+      const std::uint8_t* buf,
+      std::size_t len);
+
  private:
   kovri::client::ClientDestination& m_Owner;
   Receiver m_Receiver;  // default
   std::map<std::uint16_t, Receiver> m_ReceiversByPorts;
+  std::map<kovri::core::IdentHash, OutgoingSession> m_OutgoingSessions;
+  std::unordered_map<std::uint32_t, IncomingSession> m_IncomingSessions;
   kovri::core::Exception m_Exception;
 };
 
@@ -32,8 +32,8 @@
 #include "client/api/i2p_control/data.h"
 
 #include <boost/algorithm/string/predicate.hpp>
-#include <boost/property_tree/json_parser.hpp>
 
+#include <cstdio>
 #include <iomanip>
 #include <stdexcept>
 
@@ -43,39 +43,49 @@ namespace client
 {
 /**
  * @class SerializeVisitor
- * @brief JSON formatted output of a ValueType
+ * @brief JSON formatted output of a ValueType, appended to one output
+ *   buffer rather than stringified per value
  **/
-struct SerializeVisitor final : public boost::static_visitor<std::string>
+struct SerializeVisitor final : public boost::static_visitor<void>
 {
-  std::string operator()(bool value) const
+  explicit SerializeVisitor(std::string& out) : m_Out(out) {}
+
+  void operator()(bool value) const
   {
-    return value ? "true" : "false";
+    m_Out += value ? "true" : "false";
   }
 
-  std::string operator()(const std::size_t& value) const
+  void operator()(const std::size_t& value) const
   {
-    return std::to_string(value);
+    m_Out += std::to_string(value);
   }
 
-  std::string operator()(const double& value) const
+  void operator()(const double& value) const
   {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2) << value;
-    return oss.str();
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.2f", value);
+    m_Out += buf;
   }
 
-  std::string operator()(const std::string& value) const
+  void operator()(const std::string& value) const
   {
-    return (value.empty() ? "null" : "\"" + value + "\"");
+    if (value.empty())
+      {
+        m_Out += "null";
+        return;
+      }
+    m_Out.push_back('"');
+    m_Out += value;
+    m_Out.push_back('"');
   }
 
-  std::string operator()(const JsonObject& value) const
+  void operator()(const JsonObject& value) const
   {
-    auto str = value.ToString();
-    if (str.empty())
-      return "null";
-    return str;
+    auto const str = value.ToString();
+    m_Out += str.empty() ? "null" : str;
   }
+
+  std::string& m_Out;
 };
 
 /**
@@ -99,6 +109,8 @@ const std::string I2PControlDataTraits::GetTrait(Method method) const
         return "RouterManager";
       case Method::NetworkSetting:
         return "NetworkSetting";
+      case Method::Subscribe:
+        return "Subscribe";
       case Method::Unknown:
         return "";
     }
@@ -130,22 +142,32 @@ I2PControlDataTraits::Method I2PControlDataTraits::GetMethodFromString(
   else if (value == GetTrait(Method::NetworkSetting))
     return Method::NetworkSetting;
 
+  else if (value == GetTrait(Method::Subscribe))
+    return Method::Subscribe;
+
   else
     return Method::Unknown;
 }
 
 std::string I2PControlDataTraits::AbstractMethod::ToJsonString() const
 {
-  SerializeVisitor visitor;
-  std::ostringstream oss;
+  std::string out;
+  AppendJson(out);
+  return out;
+}
+
+void I2PControlDataTraits::AbstractMethod::AppendJson(std::string& out) const
+{
+  SerializeVisitor visitor(out);
   for (auto it = m_Params.begin(); it != m_Params.end(); ++it)
     {
       if (it != m_Params.begin())
-        oss << ',';
-      oss << '"' << GetTrait(it->first)
-          << "\":" << boost::apply_visitor(visitor, it->second);
+        out.push_back(',');
+      out.push_back('"');
+      out += GetTrait(it->first);
+      out += "\":";
+      boost::apply_visitor(visitor, it->second);
     }
-  return oss.str();
 }
 
 /**
@@ -416,6 +438,12 @@ const std::string I2PControlDataTraits::MethodRouterInfo::GetTrait(
         return "i2p.router.net.tunnels.inbound.list";
       case TunnelsOutList:
         return "i2p.router.net.tunnels.outbound.list";
+      case CryptoImpl:
+        return "i2p.router.crypto.impl";
+      case MemoryBudget:
+        return "i2p.router.memory.budget";
+      case LatencyStats:
+        return "i2p.router.latency.stats";
       case Unknown:
         return "";
     }
@@ -485,6 +513,15 @@ std::uint8_t I2PControlDataTraits::MethodRouterInfo::GetTrait(
   else if (value == GetTrait(TunnelsOutList))
     return TunnelsOutList;
 
+  else if (value == GetTrait(CryptoImpl))
+    return CryptoImpl;
+
+  else if (value == GetTrait(MemoryBudget))
+    return MemoryBudget;
+
+  else if (value == GetTrait(LatencyStats))
+    return LatencyStats;
+
   return Unknown;
 }
 
@@ -514,6 +551,9 @@ void I2PControlDataTraits::MethodRouterInfo::ParseResponse(const ptree& tree)
           case Status:
           case Version:
           case DataPath:
+          case CryptoImpl:
+          case MemoryBudget:
+          case LatencyStats:
             Set(option, pair.second.get_value<std::string>());
             break;
 
@@ -567,6 +607,14 @@ const std::string I2PControlDataTraits::MethodRouterManager::GetTrait(
     {
       case FindUpdates:
         return "FindUpdates";
+      case ProfileReport:
+        return "ProfileReport";
+      case ProfileStart:
+        return "ProfileStart";
+      case ProfileStop:
+        return "ProfileStop";
+      case ReloadTunnelsConfig:
+        return "ReloadTunnelsConfig";
       case Reseed:
         return "Reseed";
       case Restart:
@@ -591,6 +639,18 @@ std::uint8_t I2PControlDataTraits::MethodRouterManager::GetTrait(
   if (value == GetTrait(FindUpdates))
     return FindUpdates;
 
+  else if (value == GetTrait(ProfileReport))
+    return ProfileReport;
+
+  else if (value == GetTrait(ProfileStart))
+    return ProfileStart;
+
+  else if (value == GetTrait(ProfileStop))
+    return ProfileStop;
+
+  else if (value == GetTrait(ReloadTunnelsConfig))
+    return ReloadTunnelsConfig;
+
   else if (value == GetTrait(Reseed))
     return Reseed;
 
@@ -638,6 +698,7 @@ void I2PControlDataTraits::MethodRouterManager::ParseResponse(const ptree& tree)
             Set(option, pair.second.get_value<bool>());
             break;
 
+          case ReloadTunnelsConfig:
           case Reseed:
           case Restart:
           case RestartGraceful:
@@ -646,6 +707,9 @@ void I2PControlDataTraits::MethodRouterManager::ParseResponse(const ptree& tree)
             Set(option, std::string());
             break;
 
+          case ProfileReport:
+          case ProfileStart:
+          case ProfileStop:
           case Update:
             Set(option, pair.second.get_value<std::string>());
             break;
@@ -778,6 +842,50 @@ void I2PControlDataTraits::MethodNetworkSetting::ParseResponse(
     }
 }
 
+/**
+ * Subscribe
+ **/
+const std::string I2PControlDataTraits::MethodSubscribe::GetTrait(
+    std::uint8_t value) const
+{
+  switch (value)
+    {
+      case Result:
+        return "Result";
+      case Event:
+        return "Event";
+      case Subject:
+        return "Subject";
+      default:
+        throw std::domain_error("Invalid key " + std::to_string(value));
+    };
+}
+
+std::uint8_t I2PControlDataTraits::MethodSubscribe::GetTrait(
+    const std::string& value) const
+{
+  if (value == GetTrait(Result))
+    return Result;
+
+  else if (value == GetTrait(Event))
+    return Event;
+
+  else if (value == GetTrait(Subject))
+    return Subject;
+
+  return Unknown;
+}
+
+void I2PControlDataTraits::MethodSubscribe::ParseRequest(const ptree&)
+{
+  // No parameters besides the token: subscribers receive all events
+}
+
+void I2PControlDataTraits::MethodSubscribe::ParseResponse(const ptree& tree)
+{
+  Set(Result, tree.get<std::string>(GetTrait(Result)));
+}
+
 /**
  * ErrorCode
  **/
@@ -955,6 +1063,9 @@ void I2PControlData::SetMethod(Method method)
       case Method::NetworkSetting:
         m_Method.reset(new MethodNetworkSetting());
         break;
+      case Method::Subscribe:
+        m_Method.reset(new MethodSubscribe());
+        break;
       default:
         throw std::runtime_error("Invalid method");
     }
@@ -1004,26 +1115,35 @@ std::string I2PControlRequest::GetToken() const
 
 std::string I2PControlRequest::ToJsonString() const
 {
-  std::ostringstream oss;
-  SerializeVisitor visitor;
+  std::string out;
+  out.reserve(256);
+  SerializeVisitor visitor(out);
 
-  oss << "{\"id\":" << boost::apply_visitor(visitor, m_ID) << ",\"method\":\""
-      << GetTrait(m_Method->Which()) << "\",\"params\":{";
+  out += "{\"id\":";
+  boost::apply_visitor(visitor, m_ID);
+  out += ",\"method\":\"";
+  out += GetTrait(m_Method->Which());
+  out += "\",\"params\":{";
 
   if (!m_Token.empty())
-    oss << "\"Token\":\"" << m_Token << "\",";
+    {
+      out += "\"Token\":\"";
+      out += m_Token;
+      out += "\",";
+    }
 
   if (m_Method)
-    oss << m_Method->ToJsonString();
+    m_Method->AppendJson(out);
 
-  oss << "},\"jsonrpc\":\"" << m_Version << "\"}";
-  return oss.str();
+  out += "},\"jsonrpc\":\"";
+  out += m_Version;
+  out += "\"}";
+  return out;
 }
 
 void I2PControlRequest::Parse(std::stringstream& stream)
 {
-  boost::property_tree::ptree tree;
-  boost::property_tree::read_json(stream, tree);
+  auto const tree = ParseJson(stream.str());
   I2PControlData::Parse(tree);
   // Check for error
   auto method(GetMethodFromString(tree.get<std::string>("method")));
@@ -1058,29 +1178,40 @@ void I2PControlResponse::SetError(ErrorCode code)
 
 std::string I2PControlResponse::ToJsonString() const
 {
-  std::ostringstream oss;
-  SerializeVisitor visitor;
+  std::string out;
+  out.reserve(256);
+  SerializeVisitor visitor(out);
 
-  oss << "{\"id\":" << boost::apply_visitor(visitor, m_ID);
+  out += "{\"id\":";
+  boost::apply_visitor(visitor, m_ID);
 
   if (m_Method)
-    oss << ",\"result\":{" << m_Method->ToJsonString() << "}";
+    {
+      out += ",\"result\":{";
+      m_Method->AppendJson(out);
+      out += "}";
+    }
 
-  oss << ",\"jsonrpc\":\"" << m_Version << "\"";
+  out += ",\"jsonrpc\":\"";
+  out += m_Version;
+  out += "\"";
 
   if (m_Error != ErrorCode::None)
-    oss << ",\"error\":{\"code\":" << static_cast<int>(m_Error)
-        << ",\"message\":\"" << GetTrait(m_Error) << "\""
-        << "}";
+    {
+      out += ",\"error\":{\"code\":";
+      out += std::to_string(static_cast<int>(m_Error));
+      out += ",\"message\":\"";
+      out += GetTrait(m_Error);
+      out += "\"}";
+    }
 
-  oss << "}";
-  return oss.str();
+  out += "}";
+  return out;
 }
 
 void I2PControlResponse::Parse(Method method, std::stringstream& stream)
 {
-  boost::property_tree::ptree tree;
-  boost::property_tree::read_json(stream, tree);
+  auto const tree = ParseJson(stream.str());
   I2PControlData::Parse(tree);
   SetMethod(method);
   // Check for error
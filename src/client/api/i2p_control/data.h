@@ -69,6 +69,7 @@ struct I2PControlDataTraits
     RouterInfo,
     RouterManager,
     NetworkSetting,
+    Subscribe,
     Unknown
   };
 
@@ -126,6 +127,10 @@ struct I2PControlDataTraits
     /// @return Json serialization of m_Params
     std::string ToJsonString() const;
 
+    /// @brief Appends the Json serialization of m_Params to an output
+    ///   buffer shared across the whole message
+    void AppendJson(std::string& out) const;
+
    private:
     std::map<std::uint8_t, ValueType> m_Params{};
 
@@ -240,6 +245,9 @@ struct I2PControlDataTraits
       TunnelsCreationSuccessRate,
       TunnelsInList,
       TunnelsOutList,
+      CryptoImpl,
+      MemoryBudget,
+      LatencyStats,
       Unknown,
     };
     Method Which() const
@@ -257,6 +265,10 @@ struct I2PControlDataTraits
     enum Trait : std::uint8_t
     {
       FindUpdates,
+      ProfileReport,
+      ProfileStart,
+      ProfileStop,
+      ReloadTunnelsConfig,
       Reseed,
       Restart,
       RestartGraceful,
@@ -305,6 +317,29 @@ struct I2PControlDataTraits
     void ParseResponse(const ptree& tree);
   };
 
+  /// @note Extra method beyond the spec: turns the connection into a
+  ///   long-lived event stream. After the acknowledging response the
+  ///   router pushes one notification line per event (tunnel built or
+  ///   expired, transport session up or down) instead of being polled
+  struct MethodSubscribe final : public AbstractMethod
+  {
+    enum Trait : std::uint8_t
+    {
+      Result,
+      Event,
+      Subject,
+      Unknown
+    };
+    Method Which() const
+    {
+      return Method::Subscribe;
+    }
+    const std::string GetTrait(std::uint8_t value) const;
+    std::uint8_t GetTrait(const std::string& value) const;
+    void ParseRequest(const ptree& tree);
+    void ParseResponse(const ptree& tree);
+  };
+
   /// @enum ErrorCode
   /// @brief Error codes
   enum struct ErrorCode : std::int16_t
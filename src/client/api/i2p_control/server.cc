@@ -78,6 +78,17 @@ void I2PControlService::Stop() {
   if (m_IsRunning) {
     m_IsRunning = false;
     m_Acceptor.cancel();
+    {
+      // Detach event streams first: once Unsubscribe() returns the bus
+      // will not call back into this service
+      std::lock_guard<std::mutex> lock(m_SubscribersMutex);
+      for (const auto& subscriber : m_Subscribers) {
+        kovri::core::event_bus.Unsubscribe(subscriber.second);
+        boost::system::error_code e;
+        subscriber.first->close(e);
+      }
+      m_Subscribers.clear();
+    }
     m_Session->Stop();
     // Release ownership before the io_service is stopped and destroyed
     m_Session.reset();
@@ -166,6 +177,14 @@ void I2PControlService::HandleRequestReceived(
     }
     LOG(debug) << "I2PControlService: creating response";
     auto response = m_Session->HandleRequest(ss);
+    if (!is_html
+        && response->GetMethod() == I2PControlSession::Method::Subscribe
+        && response->GetError() == I2PControlSession::ErrorCode::None) {
+      // Plain JSON-RPC connection asked for the event stream: keep it
+      // open instead of the usual respond-and-close round trip
+      SubscribeSocket(socket, response->ToJsonString());
+      return;
+    }
     LOG(debug) << "I2PControlService: sending response";
     SendResponse(socket, buf, response->ToJsonString(), is_html);
   } catch (const std::exception& ex) {
@@ -223,5 +242,74 @@ void I2PControlService::HandleResponseSent(
   socket->close();
 }
 
+void I2PControlService::SubscribeSocket(
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+    const std::string& response) {
+  LOG(info)
+    << "I2PControlService: event stream subscribed from "
+    << socket->remote_endpoint();
+  const std::size_t id = kovri::core::event_bus.Subscribe(
+      [this, socket](
+          kovri::core::EventBus::Event event,
+          std::uint64_t subject) {
+        // Emitted on the tunnel/transport threads: hand off to the
+        // service thread, which owns all subscriber socket writes
+        m_Service.post([this, socket, event, subject]() {
+            PushEvent(socket, event, subject);
+          });
+      });
+  {
+    std::lock_guard<std::mutex> lock(m_SubscribersMutex);
+    m_Subscribers[socket] = id;
+  }
+  // Acknowledge the subscription; events follow on the same connection
+  PushMessage(socket, response + "\r\n");
+}
+
+void I2PControlService::UnsubscribeSocket(
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
+  std::size_t id;
+  {
+    std::lock_guard<std::mutex> lock(m_SubscribersMutex);
+    auto it = m_Subscribers.find(socket);
+    if (it == m_Subscribers.end())
+      return;  // already dropped (e.g. during Stop())
+    id = it->second;
+    m_Subscribers.erase(it);
+  }
+  kovri::core::event_bus.Unsubscribe(id);
+  boost::system::error_code e;
+  socket->close(e);
+}
+
+void I2PControlService::PushEvent(
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+    kovri::core::EventBus::Event event,
+    std::uint64_t subject) {
+  // One JSON-RPC notification (no id) per event, newline delimited
+  std::string message;
+  message.reserve(128);
+  message += "{\"method\":\"Subscribe\",\"params\":{\"Event\":\"";
+  message += kovri::core::EventBus::GetName(event);
+  message += "\",\"Subject\":";
+  message += std::to_string(subject);
+  message += "},\"jsonrpc\":\"2.0\"}\r\n";
+  PushMessage(socket, message);
+}
+
+void I2PControlService::PushMessage(
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+    const std::string& message) {
+  // Events are a few dozen bytes to a local consumer: a blocking write
+  // on the service thread keeps them ordered without a per-socket queue
+  boost::system::error_code ecode;
+  boost::asio::write(*socket, boost::asio::buffer(message), ecode);
+  if (ecode) {
+    LOG(debug)
+      << "I2PControlService: event subscriber gone: " << ecode.message();
+    UnsubscribeSocket(socket);
+  }
+}
+
 }  // namespace client
 }  // namespace kovri
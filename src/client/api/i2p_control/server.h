@@ -38,12 +38,15 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
 
 #include "client/api/i2p_control/session.h"
+#include "core/util/event_bus.h"
 
 namespace kovri {
 namespace client {
@@ -93,9 +96,36 @@ class I2PControlService {
       std::shared_ptr<boost::asio::ip::tcp::socket> socket,
       std::shared_ptr<I2PControlBuffer> buf);
 
+  // Turns the connection into a long-lived event stream: sends the
+  // acknowledging response, keeps the socket open and registers it on
+  // the router event bus. Push costs the router only when state changes,
+  // versus dashboards re-polling RouterInfo every second.
+  void SubscribeSocket(
+      std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+      const std::string& response);
+
+  void UnsubscribeSocket(
+      std::shared_ptr<boost::asio::ip::tcp::socket> socket);
+
+  // Writes one JSON-RPC notification line; on error the subscriber is
+  // dropped. Runs on the service thread only (event handlers post here)
+  void PushEvent(
+      std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+      kovri::core::EventBus::Event event,
+      std::uint64_t subject);
+
+  void PushMessage(
+      std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+      const std::string& message);
+
  private:
   std::shared_ptr<I2PControlSession> m_Session;
 
+  // Open event streams and their event bus subscription IDs
+  std::map<std::shared_ptr<boost::asio::ip::tcp::socket>, std::size_t>
+      m_Subscribers;
+  std::mutex m_SubscribersMutex;
+
   bool m_IsRunning;
   std::unique_ptr<std::thread> m_Thread;
 
@@ -38,13 +38,18 @@
 #include "client/context.h"
 
 #include "core/crypto/rand.h"
+#include "core/crypto/registry.h"
 
 #include "core/router/context.h"
 #include "core/router/net_db/impl.h"
 #include "core/router/transports/impl.h"
 
+#include "core/util/cpu_profiler.h"
 #include "core/util/filesystem.h"
+#include "core/util/histogram.h"
 #include "core/util/log.h"
+#include "core/util/memory_budget.h"
+#include "core/util/metrics.h"
 #include "core/util/timestamp.h"
 
 #include "version.h"
@@ -89,6 +94,8 @@ I2PControlSession::I2PControlSession(
   m_MethodHandlers[Method::RouterManager] =
       &I2PControlSession::HandleRouterManager;
 
+  m_MethodHandlers[Method::Subscribe] = &I2PControlSession::HandleSubscribe;
+
   // RouterManager handlers
   m_RouterManagerHandlers[RouterManager::Shutdown] =
       &I2PControlSession::HandleShutdown;
@@ -98,6 +105,18 @@ I2PControlSession::I2PControlSession(
 
   m_RouterManagerHandlers[RouterManager::Reseed] =
       &I2PControlSession::HandleReseed;
+
+  m_RouterManagerHandlers[RouterManager::ReloadTunnelsConfig] =
+      &I2PControlSession::HandleReloadTunnelsConfig;
+
+  m_RouterManagerHandlers[RouterManager::ProfileStart] =
+      &I2PControlSession::HandleProfileStart;
+
+  m_RouterManagerHandlers[RouterManager::ProfileStop] =
+      &I2PControlSession::HandleProfileStop;
+
+  m_RouterManagerHandlers[RouterManager::ProfileReport] =
+      &I2PControlSession::HandleProfileReport;
 }
 
 void I2PControlSession::Start() {
@@ -237,6 +256,9 @@ void I2PControlSession::HandleRouterInfo(
 {
   typedef I2PControlData::MethodRouterInfo RouterInfo;
   LOG(debug) << "I2PControlSession: HandleRouterInfo()";
+  // one lock-free snapshot serves the whole request; polling dashboards
+  // never touch the live tunnel/peer structures
+  const auto metrics = kovri::core::metrics.Get();
   for (const auto& pair : request.GetParams())
     {
       switch (pair.first)
@@ -279,11 +301,16 @@ void I2PControlSession::HandleRouterInfo(
 
           case RouterInfo::TunnelsParticipating:
             response->SetParam(
-                pair.first, core::tunnels.GetTransitTunnels().size());
+                pair.first,
+                static_cast<std::size_t>(
+                    metrics.gauges.at(core::Metrics::TransitTunnels)));
             break;
 
           case RouterInfo::ActivePeers:
-            response->SetParam(pair.first, core::transports.GetPeers().size());
+            response->SetParam(
+                pair.first,
+                static_cast<std::size_t>(
+                    metrics.gauges.at(core::Metrics::ActivePeers)));
             break;
 
           case RouterInfo::KnownPeers:
@@ -303,12 +330,20 @@ void I2PControlSession::HandleRouterInfo(
             response->SetParam(pair.first, core::netdb.GetNumLeaseSets());
             break;
 
-          case RouterInfo::TunnelsCreationSuccessRate:
+          case RouterInfo::TunnelsCreationSuccessRate: {
+            const std::uint64_t total =
+                metrics.counters.at(core::Metrics::TunnelBuildsSucceeded)
+                + metrics.counters.at(core::Metrics::TunnelBuildsFailed);
             response->SetParam(
                 pair.first,
                 static_cast<std::size_t>(
-                    core::tunnels.GetTunnelCreationSuccessRate()));
+                    total
+                        ? metrics.counters.at(
+                              core::Metrics::TunnelBuildsSucceeded)
+                            * 100 / total
+                        : 0));
             break;
+          }
 
           case RouterInfo::TunnelsInList:
             HandleTunnelsInList(response);
@@ -318,6 +353,20 @@ void I2PControlSession::HandleRouterInfo(
             HandleTunnelsOutList(response);
             break;
 
+          case RouterInfo::CryptoImpl:
+            response->SetParam(pair.first, core::crypto_registry.Report());
+            break;
+
+          case RouterInfo::MemoryBudget:
+            response->SetParam(pair.first, core::memory_budget.Report());
+            break;
+
+          case RouterInfo::LatencyStats:
+            // percentile summaries of the always-on latency histograms;
+            // p99/p999 expose the bimodal tails that averages hide
+            response->SetParam(pair.first, core::latency_histograms.Report());
+            break;
+
           case RouterInfo::BWIn15S:
           case RouterInfo::BWOut15S:
           case RouterInfo::FastPeers:
@@ -351,6 +400,15 @@ void I2PControlSession::HandleRouterManager(
     }
 }
 
+void I2PControlSession::HandleSubscribe(const Request&, Response* response)
+{
+  typedef I2PControlData::MethodSubscribe Keys;
+  LOG(debug) << "I2PControlSession: event subscription requested";
+  // The session only vets the request (token already checked); whether
+  // the connection can carry a push stream is the transport's call
+  response->SetParam(Keys::Result, std::string("subscribed"));
+}
+
 void I2PControlSession::HandleTunnelsInList(Response* response)
 {
   JsonObject list;
@@ -413,6 +471,15 @@ void I2PControlSession::HandleShutdownGraceful(Response* response)
       });
 }
 
+void I2PControlSession::HandleReloadTunnelsConfig(Response* response)
+{
+  LOG(info) << "I2PControlSession: tunnels config reload requested";
+  response->SetParam(RouterManager::ReloadTunnelsConfig, "");
+  // Same diff path as SIGHUP: only changed tunnels restart, warmed
+  // destinations with unchanged keys stay up
+  kovri::client::context.RequestReload();
+}
+
 void I2PControlSession::HandleReseed(Response* response)
 {
   LOG(info) << "I2PControlSession: reseed requested";
@@ -422,6 +489,33 @@ void I2PControlSession::HandleReseed(Response* response)
     LOG(error) << "I2PControlSession: reseed failed";
 }
 
+void I2PControlSession::HandleProfileStart(Response* response)
+{
+  LOG(info) << "I2PControlSession: CPU profiling start requested";
+  response->SetParam(
+      RouterManager::ProfileStart,
+      kovri::core::cpu_profiler.Start() ? std::string("started")
+                                        : std::string("unavailable"));
+}
+
+void I2PControlSession::HandleProfileStop(Response* response)
+{
+  LOG(info) << "I2PControlSession: CPU profiling stop requested";
+  response->SetParam(
+      RouterManager::ProfileStop,
+      kovri::core::cpu_profiler.Stop() ? std::string("stopped")
+                                       : std::string("not running"));
+}
+
+void I2PControlSession::HandleProfileReport(Response* response)
+{
+  LOG(debug) << "I2PControlSession: CPU profile report requested";
+  // Folded stacks, one line per distinct stack: feed straight to
+  // flamegraph.pl (or c++filt first to demangle)
+  response->SetParam(
+      RouterManager::ProfileReport, kovri::core::cpu_profiler.Report());
+}
+
 void I2PControlSession::ExpireTokens(
     const boost::system::error_code& error) {
   if (error == boost::asio::error::operation_aborted)
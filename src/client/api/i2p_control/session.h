@@ -112,6 +112,9 @@ class I2PControlSession
   void HandleI2PControl(const Request& request, Response* response);
   void HandleRouterInfo(const Request& request, Response* response);
   void HandleRouterManager(const Request& request, Response* response);
+  // Acknowledges an event subscription; the transport layer keeps the
+  // connection open and pushes events (see I2PControlService)
+  void HandleSubscribe(const Request& request, Response* response);
 
   // RouterInfo handlers
   void HandleTunnelsInList(Response* response);
@@ -121,6 +124,11 @@ class I2PControlSession
   void HandleShutdown(Response* response);
   void HandleShutdownGraceful(Response* response);
   void HandleReseed(Response* response);
+  void HandleReloadTunnelsConfig(Response* response);
+  // Embedded sampling CPU profiler, for nodes where perf can't attach
+  void HandleProfileStart(Response* response);
+  void HandleProfileStop(Response* response);
+  void HandleProfileReport(Response* response);
 
   std::string m_Password;
   std::map<std::string, std::uint64_t> m_Tokens;
@@ -33,6 +33,7 @@
 #include "client/api/streaming.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "client/destination.h"
 
@@ -42,12 +43,203 @@
 #include "core/router/context.h"
 #include "core/router/info.h"
 
+#include "core/util/histogram.h"
 #include "core/util/log.h"
+#include "core/util/memory_budget.h"
 #include "core/util/timestamp.h"
 
 namespace kovri {
 namespace client {
 
+namespace {
+/// @brief Configured congestion window cap, clamped to the protocol bounds
+int ReadMaxWindowSize() {
+  const int window =
+      kovri::core::context.GetOpts()["streaming-max-window"].as<std::uint16_t>();
+  return std::min(std::max(window, MIN_WINDOW_SIZE), MAX_WINDOW_SIZE);
+}
+
+/// @brief Configured multipath path count, clamped to [1, MAX_STREAM_PATHS]
+std::size_t ReadNumPaths() {
+  const std::size_t paths =
+      kovri::core::context.GetOpts()["streaming-paths"].as<std::uint16_t>();
+  return std::min(std::max<std::size_t>(paths, 1), MAX_STREAM_PATHS);
+}
+
+/// @brief Whether the "streaming-fec" option asks to negotiate the XOR
+///   parity mode on new streams
+bool ReadFecEnabled() {
+  return kovri::core::context.GetOpts()["streaming-fec"].as<bool>();
+}
+}  // namespace
+
+SendBufferQueue::~SendBufferQueue() {
+  for (Segment* list : {m_Head, m_Free}) {
+    while (list) {
+      Segment* next = list->next;
+      delete list;
+      list = next;
+    }
+  }
+}
+
+SendBufferQueue::Segment* SendBufferQueue::Allocate() {
+  Segment* seg;
+  if (m_Free) {
+    seg = m_Free;
+    m_Free = m_Free->next;
+    m_FreeCount--;
+  } else {
+    seg = new Segment;
+  }
+  seg->begin = seg->end = 0;
+  seg->next = nullptr;
+  return seg;
+}
+
+void SendBufferQueue::Append(
+    const std::uint8_t* buf,
+    std::size_t len) {
+  m_Size += len;
+  while (len) {
+    if (!m_Tail || m_Tail->end == Size::SegmentSize) {
+      Segment* seg = Allocate();
+      if (m_Tail)
+        m_Tail->next = seg;
+      else
+        m_Head = seg;
+      m_Tail = seg;
+    }
+    const std::size_t count =
+        std::min<std::size_t>(len, Size::SegmentSize - m_Tail->end);
+    memcpy(m_Tail->buf + m_Tail->end, buf, count);
+    m_Tail->end += count;
+    buf += count;
+    len -= count;
+  }
+}
+
+std::size_t SendBufferQueue::Read(
+    std::uint8_t* buf,
+    std::size_t len) {
+  std::size_t read = 0;
+  while (len && m_Head) {
+    const std::size_t count =
+        std::min<std::size_t>(len, m_Head->end - m_Head->begin);
+    memcpy(buf + read, m_Head->buf + m_Head->begin, count);
+    m_Head->begin += count;
+    read += count;
+    len -= count;
+    if (m_Head->begin == m_Head->end) {
+      Segment* drained = m_Head;
+      m_Head = m_Head->next;
+      if (!m_Head)
+        m_Tail = nullptr;
+      if (m_FreeCount < Size::MaxFreeSegments) {
+        drained->next = m_Free;
+        m_Free = drained;
+        m_FreeCount++;
+      } else {
+        delete drained;
+      }
+    }
+  }
+  m_Size -= read;
+  return read;
+}
+
+void PacketList::Insert(
+    Packet* packet) {
+  packet->next = nullptr;
+  m_Size++;
+  if (!m_Head) {
+    m_Head = m_Tail = packet;
+    return;
+  }
+  if (packet->GetSeqn() >= m_Tail->GetSeqn()) {
+    m_Tail->next = packet;
+    m_Tail = packet;
+    return;
+  }
+  if (packet->GetSeqn() < m_Head->GetSeqn()) {
+    packet->next = m_Head;
+    m_Head = packet;
+    return;
+  }
+  Packet* prev = m_Head;
+  while (prev->next && prev->next->GetSeqn() <= packet->GetSeqn())
+    prev = prev->next;
+  packet->next = prev->next;
+  prev->next = packet;
+}
+
+Packet* PacketList::PopFront() {
+  return EraseAfter(nullptr);
+}
+
+Packet* PacketList::EraseAfter(
+    Packet* prev) {
+  Packet* packet = prev ? prev->next : m_Head;
+  if (!packet)
+    return nullptr;
+  if (prev)
+    prev->next = packet->next;
+  else
+    m_Head = packet->next;
+  if (m_Tail == packet)
+    m_Tail = prev;
+  packet->next = nullptr;
+  m_Size--;
+  return packet;
+}
+
+PacketPool::~PacketPool() {
+  while (m_Free) {
+    Packet* next = m_Free->next;
+    kovri::core::memory_budget.Sub(
+        kovri::core::MemoryBudget::Streaming, sizeof(Packet));
+    delete m_Free;
+    m_Free = next;
+  }
+}
+
+Packet* PacketPool::Acquire() {
+  {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    if (m_Free) {
+      Packet* packet = m_Free;
+      m_Free = m_Free->next;
+      m_FreeCount--;
+      l.unlock();
+      packet->len = 0;
+      packet->offset = 0;
+      packet->send_time = 0;
+      packet->path = 0;
+      packet->next = nullptr;
+      return packet;
+    }
+  }
+  // budgeted while allocated, live or pooled
+  kovri::core::memory_budget.Add(
+      kovri::core::MemoryBudget::Streaming, sizeof(Packet));
+  return new Packet();
+}
+
+void PacketPool::Release(
+    Packet* packet) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (m_FreeCount < Size::MaxFreePackets) {
+    packet->next = m_Free;
+    m_Free = packet;
+    m_FreeCount++;
+  } else {
+    l.unlock();
+    kovri::core::memory_budget.Sub(
+        kovri::core::MemoryBudget::Streaming, sizeof(Packet));
+    delete packet;
+  }
+}
+
 Stream::Stream(
     boost::asio::io_service& service,
     StreamingDestination& local,
@@ -59,22 +251,35 @@ Stream::Stream(
       m_LastReceivedSequenceNumber(-1),
       m_Status(eStreamStatusNew),
       m_IsAckSendScheduled(false),
+      m_UnackedReceivedCount(0),
+      m_DrainRate(0),
+      m_LastDrainTime(0),
+      m_SendDelayUntil(0),
+      m_IsSendDelayScheduled(false),
       m_LocalDestination(local),
       m_RemoteLeaseSet(remote),
-      m_ReceiveTimer(m_Service),
-      m_ResendTimer(m_Service),
-      m_AckSendTimer(m_Service),
+      m_NumPaths(ReadNumPaths()),
+      m_ReceiveTimer(0),
+      m_ResendTimer(0),
+      m_AckSendTimer(0),
       m_NumSentBytes(0),
       m_NumReceivedBytes(0),
       m_Port(port),
       m_WindowSize(MIN_WINDOW_SIZE),
       m_RTT(INITIAL_RTT),
+      m_RTTVAR(-1),
       m_RTO(INITIAL_RTO),
+      m_MinRTT(INITIAL_RTT),
+      m_MaxWindowSize(ReadMaxWindowSize()),
+      m_SSThresh(m_MaxWindowSize),
+      m_MinRTTSampleTime(0),
       m_LastWindowSizeIncreaseTime(0),
       m_NumResendAttempts(0),
+      m_FecConfigured(ReadFecEnabled()),
+      m_FecEnabled(false),
       m_Exception(__func__) {
         m_RecvStreamID = kovri::core::Rand<std::uint32_t>();
-        m_RemoteIdentity = remote->GetIdentity();
+        m_RemoteIdentity = remote->GetSharedIdentity();
         // TODO(unassigned):
         // This type of initialization is a friendly reminder of overall poor design.
         // Though we *should* initialize all m_CurrentRemoteLease members before use,
@@ -104,43 +309,66 @@ Stream::Stream(
       m_LastReceivedSequenceNumber(-1),
       m_Status(eStreamStatusNew),
       m_IsAckSendScheduled(false),
+      m_UnackedReceivedCount(0),
+      m_DrainRate(0),
+      m_LastDrainTime(0),
+      m_SendDelayUntil(0),
+      m_IsSendDelayScheduled(false),
       m_LocalDestination(local),
       m_CurrentRemoteLease{},
-      m_ReceiveTimer(m_Service),
-      m_ResendTimer(m_Service),
-      m_AckSendTimer(m_Service),
+      m_NumPaths(ReadNumPaths()),
+      m_ReceiveTimer(0),
+      m_ResendTimer(0),
+      m_AckSendTimer(0),
       m_NumSentBytes(0),
       m_NumReceivedBytes(0),
       m_Port(0),
       m_WindowSize(MIN_WINDOW_SIZE),
       m_RTT(INITIAL_RTT),
+      m_RTTVAR(-1),
       m_RTO(INITIAL_RTO),
+      m_MinRTT(INITIAL_RTT),
+      m_MaxWindowSize(ReadMaxWindowSize()),
+      m_SSThresh(m_MaxWindowSize),
+      m_MinRTTSampleTime(0),
       m_LastWindowSizeIncreaseTime(0),
       m_NumResendAttempts(0),
+      m_FecConfigured(ReadFecEnabled()),
+      m_FecEnabled(false),
       m_Exception(__func__) {
         m_RecvStreamID = kovri::core::Rand<std::uint32_t>();
       }
 
 Stream::~Stream() {
   Terminate();
-  while (!m_ReceiveQueue.empty()) {
-    auto packet = m_ReceiveQueue.front();
-    m_ReceiveQueue.pop();
-    delete packet;
-  }
-  for (auto it : m_SentPackets)
-    delete it;
-  m_SentPackets.clear();
-  for (auto it : m_SavedPackets)
-    delete it;
-  m_SavedPackets.clear();
+  auto& pool = m_LocalDestination.GetPacketPool();
+  while (auto packet = m_ReceiveQueue.PopFront())
+    pool.Release(packet);
+  while (auto packet = m_SentPackets.PopFront())
+    pool.Release(packet);
+  while (auto packet = m_SavedPackets.PopFront())
+    pool.Release(packet);
   LOG(debug) << "Stream: stream deleted";
 }
 
+void Stream::Cancel() {
+  // The receive timer doubles as the data-arrival notification, so the
+  // pending handler must still run (with operation_aborted) on the
+  // service thread, exactly as deadline_timer::cancel would have it
+  auto s = shared_from_this();
+  m_Service.post([s] {
+      s->m_LocalDestination.GetTimerWheel().Cancel(s->m_ReceiveTimer, true);
+    });
+}
+
 void Stream::Terminate() {
-  m_AckSendTimer.cancel();
-  m_ReceiveTimer.cancel();
-  m_ResendTimer.cancel();
+  auto& wheel = m_LocalDestination.GetTimerWheel();
+  wheel.Cancel(m_AckSendTimer);
+  // a pending receive still gets its handler, see Cancel()
+  wheel.Cancel(m_ReceiveTimer, true);
+  wheel.Cancel(m_ResendTimer);
+  // paced packets are owned by m_SentPackets, only the references go
+  m_LocalDestination.CancelPacedPackets(this);
   if (m_SendHandler) {
     auto handler = m_SendHandler;
     m_SendHandler = nullptr;
@@ -157,39 +385,70 @@ void Stream::HandleNextPacket(
     m_SendStreamID = packet->GetReceiveStreamID();
   if (!packet->IsNoAck())  // ack received
     ProcessAck(packet);
+  if (packet->IsFecParity()) {
+    HandleFecParity(packet);  // consumes the packet
+    return;
+  }
   int32_t received_seqn = packet->GetSeqn();
   bool is_syn = packet->IsSYN();
+  if (is_syn && m_FecConfigured && !m_FecEnabled &&
+      (packet->GetFlags() & PACKET_FLAG_FEC_SUPPORTED)) {
+    // both ends announced support: parity starts flowing both ways
+    m_FecEnabled = true;
+    m_FecSendGroup = std::make_unique<FecGroup>();
+    m_FecRecvGroups = std::make_unique<FecGroup[]>(FEC_GROUP_SLOTS);
+    LOG(debug) << "Stream: FEC negotiated, group size " << FEC_GROUP_SIZE;
+  }
   if (!received_seqn && !is_syn) {
-    // plain ack
+    // plain ack; may still carry receiver flow control (plain acks never
+    // reach ProcessPacket, so the option is parsed here)
+    if (packet->GetFlags() & PACKET_FLAG_DELAY_REQUESTED)
+      SetRemoteRequestedDelay(
+          core::InputByteStream::Read<std::uint16_t>(
+              packet->GetOptionData()));
+    else if (m_SendDelayUntil)
+      SetRemoteRequestedDelay(0);  // the peer's queue drained, resume early
     LOG(debug) << "Stream: plain ACK received";
-    delete packet;
+    m_LocalDestination.GetPacketPool().Release(packet);
     return;
   }
   LOG(debug) << "Stream: received seqn=" << received_seqn;
+  if (m_FecEnabled)
+    FecAccumulate(packet);
   if (is_syn || received_seqn == m_LastReceivedSequenceNumber + 1) {
+    // hard queue cap: a consumer this far behind gets no more buffering;
+    // the unacknowledged packet is the sender's cue to retransmit after
+    // the delay the quick ACK advertises
+    if (!is_syn && m_ReceiveQueue.GetSize() >= MAX_RECEIVE_QUEUE_PACKETS) {
+      LOG(warning)
+        << "Stream: receive queue full, dropping seqn=" << received_seqn;
+      m_LocalDestination.GetPacketPool().Release(packet);
+      SendQuickAck();
+      return;
+    }
     // we have received next in sequence message
     ProcessPacket(packet);
+    m_UnackedReceivedCount++;
     // we should also try stored messages if any
-    for (auto it = m_SavedPackets.begin(); it != m_SavedPackets.end();) {
-      if ((*it)->GetSeqn() == (std::uint32_t)(m_LastReceivedSequenceNumber + 1)) {
-        Packet* savedPacket = *it;
-        m_SavedPackets.erase(it++);
-        ProcessPacket(savedPacket);
-      } else {
+    while (Packet* saved = m_SavedPackets.GetFront()) {
+      if (saved->GetSeqn()
+          != (std::uint32_t)(m_LastReceivedSequenceNumber + 1))
         break;
-      }
+      m_SavedPackets.PopFront();
+      ProcessPacket(saved);
+      m_UnackedReceivedCount++;
     }
-    // schedule ack for last message
+    // delayed ACK: every second in-order packet acks immediately, a lone
+    // packet waits for the timer or for outbound data to piggyback on
     if (m_Status == eStreamStatusOpen) {
-      if (!m_IsAckSendScheduled) {
-        m_IsAckSendScheduled = true;
-        m_AckSendTimer.expires_from_now(
-            boost::posix_time::milliseconds(ACK_SEND_TIMEOUT));
-        m_AckSendTimer.async_wait(
-            std::bind(
-              &Stream::HandleAckSendTimer,
-              shared_from_this(),
-              std::placeholders::_1));
+      if (m_UnackedReceivedCount >= DELAYED_ACK_PACKET_LIMIT) {
+        if (m_IsAckSendScheduled) {
+          m_IsAckSendScheduled = false;
+          m_LocalDestination.GetTimerWheel().Cancel(m_AckSendTimer);
+        }
+        SendQuickAck();
+      } else if (!m_IsAckSendScheduled) {
+        ScheduleAckSend();
       }
     } else if (is_syn) {
       // we have to send SYN back to incoming connection
@@ -201,7 +460,7 @@ void Stream::HandleNextPacket(
       LOG(warning)
         << "Stream: duplicate message " << received_seqn << " received";
       SendQuickAck();  // resend ack for previous message again
-      delete packet;  // packet dropped
+      m_LocalDestination.GetPacketPool().Release(packet);  // packet dropped
     } else {
       LOG(warning)
         << "Stream: missing messages from "
@@ -210,31 +469,190 @@ void Stream::HandleNextPacket(
       // save message and wait for missing message again
       SavePacket(packet);
       if (m_LastReceivedSequenceNumber >= 0) {
-        // send NACKs for missing messages ASAP
-        if (m_IsAckSendScheduled) {
-          m_IsAckSendScheduled = false;
-          m_AckSendTimer.cancel();
+        // NACK the first gap right away so the sender can retransmit;
+        // further out-of-order arrivals coalesce onto the pending timer,
+        // which sends one ACK covering every gap seen by then instead of
+        // a quick ACK per arriving packet
+        if (!m_IsAckSendScheduled) {
+          SendQuickAck();
+          ScheduleAckSend();
         }
-        SendQuickAck();
-      } else {
+      } else if (!m_IsAckSendScheduled) {
         // wait for SYN
-        m_IsAckSendScheduled = true;
-        m_AckSendTimer.expires_from_now(
-            boost::posix_time::milliseconds(
-              ACK_SEND_TIMEOUT));
-        m_AckSendTimer.async_wait(
-            std::bind(
-              &Stream::HandleAckSendTimer,
-              shared_from_this(),
-              std::placeholders::_1));
+        ScheduleAckSend();
       }
     }
   }
 }
 
+void Stream::ScheduleAckSend() {
+  m_IsAckSendScheduled = true;
+  auto s = shared_from_this();
+  m_AckSendTimer = m_LocalDestination.GetTimerWheel().Add(
+      ACK_SEND_TIMEOUT,
+      [s](bool) {
+        s->HandleAckSendTimer(boost::system::error_code());
+      });
+}
+
 void Stream::SavePacket(
     Packet* packet) {
-  m_SavedPackets.insert(packet);
+  m_SavedPackets.Insert(packet);
+}
+
+void Stream::FecAccumulateSent(
+    const std::uint8_t* payload,
+    std::size_t len,
+    std::uint32_t seqn,
+    std::vector<Packet *>& parity) {
+  FecGroup& group = *m_FecSendGroup;
+  if (len + 2 > sizeof(group.acc))
+    return;
+  const std::uint32_t id = seqn / FEC_GROUP_SIZE;
+  if (group.group != id || !group.mask)
+    group.Reset(id);
+  group.FoldData(payload, len);
+  group.mask |= 1 << (seqn % FEC_GROUP_SIZE);
+  // parity goes out only over a fully covered group, so a stream that
+  // negotiated FEC mid-group simply skips that group's parity
+  if (group.mask == (1 << FEC_GROUP_SIZE) - 1) {
+    parity.push_back(CreateFecParityPacket(group));
+    group.mask = 0;
+  }
+}
+
+// TODO(anonimal): bytestream refactor
+Packet* Stream::CreateFecParityPacket(
+    const FecGroup& group) {
+  Packet* p = m_LocalDestination.GetPacketPool().Acquire();
+  std::uint8_t* packet = p->GetBuffer();
+  std::size_t size = 0;
+  core::OutputByteStream::Write<std::uint32_t>(packet + size, m_SendStreamID);
+  size += 4;  // sendStreamID
+  core::OutputByteStream::Write<std::uint32_t>(packet + size, m_RecvStreamID);
+  size += 4;  // receiveStreamID
+  // first covered sequence number; parity consumes no seqn of its own
+  core::OutputByteStream::Write<std::uint32_t>(
+      packet + size, group.group * FEC_GROUP_SIZE);
+  size += 4;  // sequenceNum
+  core::OutputByteStream::Write<std::uint32_t>(
+      packet + size, m_LastReceivedSequenceNumber);
+  size += 4;  // ack Through
+  packet[size] = 0;
+  size++;  // NACK count
+  packet[size] = m_RTO/1000;
+  size++;  // resend delay
+  core::OutputByteStream::Write<std::uint16_t>(
+      packet + size, PACKET_FLAG_FEC_PARITY);
+  size += 2;  // flags
+  core::OutputByteStream::Write<std::uint16_t>(packet + size, 0, false);
+  size += 2;  // options size
+  memcpy(packet + size, group.acc, group.width);
+  size += group.width;  // XOR of the group's length-prefixed payloads
+  p->len = size;
+  return p;
+}
+
+void Stream::FecAccumulate(
+    Packet* packet) {
+  const std::uint32_t seqn = packet->GetSeqn();
+  const std::uint32_t id = seqn / FEC_GROUP_SIZE;
+  FecGroup& group = m_FecRecvGroups[id & (FEC_GROUP_SLOTS - 1)];
+  if (group.group != id || !group.mask) {
+    if (group.mask && group.group > id)
+      return;  // slot already tracks a newer group
+    group.Reset(id);
+  }
+  const std::uint16_t bit = 1 << (seqn % FEC_GROUP_SIZE);
+  if (group.mask & bit)
+    return;  // duplicate, already folded in
+  const std::uint8_t* payload = packet->GetPayload();
+  const std::size_t len = packet->buf + packet->len - payload;
+  if (len + 2 > sizeof(group.acc))
+    return;  // oversized, cannot be a group member
+  group.FoldData(payload, len);
+  group.mask |= bit;
+  FecTryRecover(group);
+}
+
+void Stream::HandleFecParity(
+    Packet* packet) {
+  auto& pool = m_LocalDestination.GetPacketPool();
+  if (!m_FecEnabled) {
+    pool.Release(packet);  // not negotiated
+    return;
+  }
+  const std::uint32_t id = packet->GetSeqn() / FEC_GROUP_SIZE;
+  const std::uint8_t* payload = packet->GetPayload();
+  const std::size_t len = packet->buf + packet->len - payload;
+  FecGroup& group = m_FecRecvGroups[id & (FEC_GROUP_SLOTS - 1)];
+  if (len && len <= sizeof(group.acc) &&
+      !(group.mask && group.group > id)) {
+    if (group.group != id || !group.mask)
+      group.Reset(id);
+    const std::uint16_t parity_bit = 1 << FEC_GROUP_SIZE;
+    if (!(group.mask & parity_bit)) {
+      group.FoldParity(payload, len);
+      group.mask |= parity_bit;
+      FecTryRecover(group);
+    }
+  }
+  pool.Release(packet);
+}
+
+// TODO(anonimal): bytestream refactor
+void Stream::FecTryRecover(
+    FecGroup& group) {
+  if (!(group.mask & (1 << FEC_GROUP_SIZE)))
+    return;  // no parity yet
+  const std::uint16_t full = (1 << (FEC_GROUP_SIZE + 1)) - 1;
+  const std::uint16_t missing = full & ~group.mask;
+  if (!missing || (missing & (missing - 1)))
+    return;  // group complete, or more than one loss
+  std::size_t index = 0;
+  while (!(missing & (1 << index)))
+    index++;
+  const std::uint32_t seqn = group.group * FEC_GROUP_SIZE + index;
+  group.mask |= missing;  // never reconstruct the same member twice
+  if (!seqn)
+    return;  // a lost SYN carries options we cannot rebuild from payload
+  if (static_cast<std::int32_t>(seqn) <= m_LastReceivedSequenceNumber)
+    return;  // delivered in order before the slot was (re)filled
+  if (group.width < 2)
+    return;
+  const std::size_t len =
+      (static_cast<std::size_t>(group.acc[0]) << 8) | group.acc[1];
+  if (len + 2 > group.width) {
+    LOG(warning) << "Stream: FEC parity mismatch for seqn=" << seqn;
+    return;
+  }
+  // synthesize the lost packet and run it through the normal receive
+  // path; NO_ACK keeps the fabricated ack fields out of ProcessAck
+  Packet* p = m_LocalDestination.GetPacketPool().Acquire();
+  std::uint8_t* packet = p->GetBuffer();
+  std::size_t size = 0;
+  core::OutputByteStream::Write<std::uint32_t>(packet + size, m_RecvStreamID);
+  size += 4;  // sendStreamID (the peer's)
+  core::OutputByteStream::Write<std::uint32_t>(packet + size, m_SendStreamID);
+  size += 4;  // receiveStreamID (ours)
+  core::OutputByteStream::Write<std::uint32_t>(packet + size, seqn);
+  size += 4;  // sequenceNum
+  core::OutputByteStream::Write<std::uint32_t>(packet + size, 0, false);
+  size += 4;  // ack Through
+  packet[size] = 0;
+  size++;  // NACK count
+  packet[size] = 0;
+  size++;  // resend delay
+  core::OutputByteStream::Write<std::uint16_t>(
+      packet + size, PACKET_FLAG_NO_ACK);
+  size += 2;  // flags
+  core::OutputByteStream::Write<std::uint16_t>(packet + size, 0, false);
+  size += 2;  // options size
+  memcpy(packet + size, group.acc + 2, len);
+  size += len;  // payload
+  p->len = size;
+  LOG(debug) << "Stream: FEC recovered seqn=" << seqn;
+  HandleNextPacket(p);
 }
 
 void Stream::ProcessPacket(
@@ -247,19 +665,21 @@ void Stream::ProcessPacket(
   if (flags & PACKET_FLAG_SYNCHRONIZE)
     LOG(debug) << "Stream: synchronize";
   if (flags & PACKET_FLAG_DELAY_REQUESTED) {
+    SetRemoteRequestedDelay(
+        core::InputByteStream::Read<std::uint16_t>(option_data));
     option_data += 2;
   }
   if (flags & PACKET_FLAG_FROM_INCLUDED) {
-    option_data += m_RemoteIdentity.FromBuffer(
-        option_data,
-        packet->GetOptionSize());
+    kovri::core::IdentityEx from;
+    option_data += from.FromBuffer(option_data, packet->GetOptionSize());
+    m_RemoteIdentity = kovri::core::InternIdentity(from);
     LOG(debug)
       << "Stream: from identity "
-      << m_RemoteIdentity.GetIdentHash().ToBase64();
+      << kovri::core::ToBase64Cached(m_RemoteIdentity->GetIdentHash());
     if (!m_RemoteLeaseSet)
       LOG(debug)
         << "Stream: incoming stream from "
-        << m_RemoteIdentity.GetIdentHash().ToBase64();
+        << kovri::core::ToBase64Cached(m_RemoteIdentity->GetIdentHash());
   }
   if (flags & PACKET_FLAG_MAX_PACKET_SIZE_INCLUDED) {
     std::uint16_t const max_packet_size =
@@ -271,10 +691,10 @@ void Stream::ProcessPacket(
     LOG(debug) << "Stream: signature";
     // TODO(unassigned): ensure option data isn't overwritten if sig length > 256.
     //   Note: not relevant once #498 / #755 is resolved (first check if they are resolved).
-    std::vector<std::uint8_t> signature(m_RemoteIdentity.GetSignatureLen());
+    std::vector<std::uint8_t> signature(m_RemoteIdentity->GetSignatureLen());
     memcpy(signature.data(), option_data, signature.size());
     memset(const_cast<std::uint8_t*>(option_data), 0, signature.size());
-    if (!m_RemoteIdentity.Verify(
+    if (!m_RemoteIdentity->Verify(
           packet->GetBuffer(),
           packet->GetLength(),
           signature.data())) {
@@ -290,10 +710,11 @@ void Stream::ProcessPacket(
   }
   packet->offset = packet->GetPayload() - packet->buf;
   if (packet->GetLength() > 0) {
-    m_ReceiveQueue.push(packet);
-    m_ReceiveTimer.cancel();
+    m_ReceiveQueue.Insert(packet);
+    // wake a pending AsyncReceive: its handler delivers the data
+    m_LocalDestination.GetTimerWheel().Cancel(m_ReceiveTimer, true);
   } else {
-    delete packet;
+    m_LocalDestination.GetPacketPool().Release(packet);
   }
   m_LastReceivedSequenceNumber = received_seqn;
   if (flags & (PACKET_FLAG_CLOSE | PACKET_FLAG_RESET)) {
@@ -309,8 +730,11 @@ void Stream::ProcessAck(
   auto ts = kovri::core::GetMillisecondsSinceEpoch();
   std::uint32_t ack_through = packet->GetAckThrough();
   int nack_count = packet->GetNACKCount();
-  for (auto it = m_SentPackets.begin(); it != m_SentPackets.end();) {
-    auto seqn = (*it)->GetSeqn();
+  Packet* prev = nullptr;
+  Packet* sent_packet = m_SentPackets.GetFront();
+  while (sent_packet) {
+    Packet* next = sent_packet->next;
+    auto seqn = sent_packet->GetSeqn();
     if (seqn <= ack_through) {
       if (nack_count > 0) {
         bool nacked = false;
@@ -321,26 +745,53 @@ void Stream::ProcessAck(
           }
         if (nacked) {
           LOG(debug) << "Stream: packet " << seqn << " NACK";
-          it++;
+          prev = sent_packet;
+          sent_packet = next;
           continue;
         }
       }
-      auto sent_packet = *it;
-      std::uint64_t rtt = ts - sent_packet->send_time;
-      m_RTT = (m_RTT * seqn + rtt) / (seqn + 1);
-      m_RTO = m_RTT * 1.5;  // TODO(unassigned): implement this better
+      const int rtt = ts - sent_packet->send_time;
+      // the raw sample feeds the distribution; the smoothed estimator
+      // below would hide exactly the tail spikes worth seeing
+      kovri::core::latency_histograms.Record(
+          kovri::core::LatencyHistograms::StreamRTT, rtt > 0 ? rtt : 0);
+      // smoothed RTT/variance estimator per RFC 6298
+      if (m_RTTVAR < 0) {
+        m_RTT = rtt;
+        m_RTTVAR = rtt / 2;
+      } else {
+        m_RTTVAR = (3 * m_RTTVAR + std::abs(rtt - m_RTT)) / 4;
+        m_RTT = (7 * m_RTT + rtt) / 8;
+      }
+      m_RTO = std::min(std::max(m_RTT + 4 * m_RTTVAR, MIN_RTO), MAX_RTO);
+      // windowed minimum RTT drives the pacing rate
+      if (rtt < m_MinRTT || ts > m_MinRTTSampleTime + MIN_RTT_WINDOW) {
+        m_MinRTT = rtt;
+        m_MinRTTSampleTime = ts;
+      }
+      // attribute the sample to the path the packet went out on
+      if (m_NumPaths > 1 && sent_packet->path < m_Paths.size()) {
+        StreamPath& path = m_Paths[sent_packet->path];
+        if (path.outbound_tunnel) {
+          path.rtt = path.rtt ? (7 * path.rtt + rtt) / 8 : rtt;
+          path.losses = 0;
+          if (path.in_flight > 0)
+            path.in_flight--;
+        }
+      }
       LOG(debug) << "Stream: packet " << seqn << " acknowledged rtt=" << rtt;
-      m_SentPackets.erase(it++);
-      delete sent_packet;
+      m_SentPackets.EraseAfter(prev);
+      m_LocalDestination.GetPacketPool().Release(sent_packet);
+      sent_packet = next;
       acknowledged = true;
-      if (m_WindowSize < WINDOW_SIZE) {
+      if (m_WindowSize < m_SSThresh) {
         m_WindowSize++;  // slow start
       } else {
         // linear growth
         if (ts > m_LastWindowSizeIncreaseTime + m_RTT) {
           m_WindowSize++;
-          if (m_WindowSize > MAX_WINDOW_SIZE)
-            m_WindowSize = MAX_WINDOW_SIZE;
+          if (m_WindowSize > m_MaxWindowSize)
+            m_WindowSize = m_MaxWindowSize;
           m_LastWindowSizeIncreaseTime = ts;
         }
       }
@@ -348,8 +799,8 @@ void Stream::ProcessAck(
       break;
     }
   }
-  if (m_SentPackets.empty())
-    m_ResendTimer.cancel();
+  if (m_SentPackets.IsEmpty())
+    m_LocalDestination.GetTimerWheel().Cancel(m_ResendTimer);
   if (acknowledged) {
     m_NumResendAttempts = 0;
     SendBuffer();
@@ -363,8 +814,7 @@ std::size_t Stream::Send(
     std::size_t len) {
   if (len > 0 && buf) {
     std::unique_lock<std::mutex> l(m_SendBufferMutex);
-    m_SendBuffer.clear();
-    m_SendBuffer.write((const char *)buf, len);
+    m_SendBuffer.Append(buf, len);
   }
   m_Service.post(
       std::bind(
@@ -388,15 +838,36 @@ void Stream::AsyncSend(
 
 // TODO(anonimal): bytestream refactor
 void Stream::SendBuffer() {
-  int num_msgs = m_WindowSize - m_SentPackets.size();
+  // the peer's receive queue is backing up: hold fresh data until the
+  // requested delay expires, then try again
+  if (m_SendDelayUntil) {
+    const auto ts = kovri::core::GetMillisecondsSinceEpoch();
+    if (ts < m_SendDelayUntil) {
+      if (!m_IsSendDelayScheduled) {
+        m_IsSendDelayScheduled = true;
+        auto s = shared_from_this();
+        m_LocalDestination.GetTimerWheel().Add(
+            m_SendDelayUntil - ts,
+            [s](bool aborted) {
+              s->m_IsSendDelayScheduled = false;
+              if (!aborted)
+                s->SendBuffer();
+            });
+      }
+      return;
+    }
+    m_SendDelayUntil = 0;
+  }
+  int num_msgs = m_WindowSize - m_SentPackets.GetSize();
   if (num_msgs <= 0)
     return;  // window is full
   bool is_no_ack = m_LastReceivedSequenceNumber < 0;  // first packet
-  std::vector<Packet *> packets; {
+  std::vector<Packet *> packets;
+  std::vector<Packet *> parity; {
     std::unique_lock<std::mutex> l(m_SendBufferMutex);
     while ((m_Status == eStreamStatusNew) || (IsEstablished() &&
-          !m_SendBuffer.eof() && num_msgs > 0)) {
-      Packet* p = new Packet();
+          !m_SendBuffer.IsEmpty() && num_msgs > 0)) {
+      Packet* p = m_LocalDestination.GetPacketPool().Acquire();
       std::uint8_t* packet = p->GetBuffer();
       // TODO(unassigned): implement setters
       std::size_t size = 0;
@@ -406,15 +877,17 @@ void Stream::SendBuffer() {
       size += 4;  // receiveStreamID
       core::OutputByteStream::Write<std::uint32_t>(packet + size, m_SequenceNumber++);
       size += 4;  // sequenceNum
-      if (is_no_ack)
-        core::OutputByteStream::Write<std::uint32_t>(packet + size, m_LastReceivedSequenceNumber);
-      else
-        core::OutputByteStream::Write<std::uint32_t>(packet + size, 0, false);
+      // every data packet carries the latest in-order sequence number,
+      // so an ACK suppressed in favor of outbound data is not lost (the
+      // peer ignores the field when the NO_ACK flag is set)
+      core::OutputByteStream::Write<std::uint32_t>(packet + size, m_LastReceivedSequenceNumber);
       size += 4;  // ack Through
       packet[size] = 0;
       size++;  // NACK count
       packet[size] = m_RTO/1000;
       size++;  // resend delay
+      const std::uint8_t* payload = nullptr;
+      std::size_t payload_len = 0;
       if (m_Status == eStreamStatusNew) {
         // initial packet
         m_Status = eStreamStatusOpen;
@@ -423,6 +896,8 @@ void Stream::SendBuffer() {
           PACKET_FLAG_SIGNATURE_INCLUDED | PACKET_FLAG_MAX_PACKET_SIZE_INCLUDED;
         if (is_no_ack)
           flags |= PACKET_FLAG_NO_ACK;
+        if (m_FecConfigured)
+          flags |= PACKET_FLAG_FEC_SUPPORTED;  // announce the FEC option
         core::OutputByteStream::Write<std::uint16_t>(packet + size, flags);
         size += 2;  // flags
         std::size_t identity_len =
@@ -443,10 +918,9 @@ void Stream::SendBuffer() {
         // zeroes for now
         memset(signature, 0, signature_len);
         size += signature_len;  // signature
-        m_SendBuffer.read(
-            reinterpret_cast<char *>(packet + size),
-            STREAMING_MTU - size);
-        size += m_SendBuffer.gcount();  // payload
+        payload = packet + size;
+        payload_len = m_SendBuffer.Read(packet + size, STREAMING_MTU - size);
+        size += payload_len;  // payload
         m_LocalDestination.GetOwner().Sign(
             packet,
             size,
@@ -458,31 +932,41 @@ void Stream::SendBuffer() {
         // no options
 	core::OutputByteStream::Write<std::uint16_t>(packet + size, 0, false);
         size += 2;  // options size
-        m_SendBuffer.read(
-            reinterpret_cast<char *>(packet + size),
-            STREAMING_MTU - size);
-        size += m_SendBuffer.gcount();  // payload
+        payload = packet + size;
+        payload_len = m_SendBuffer.Read(packet + size, STREAMING_MTU - size);
+        size += payload_len;  // payload
       }
       p->len = size;
+      if (m_FecEnabled)
+        FecAccumulateSent(payload, payload_len, m_SequenceNumber - 1, parity);
       packets.push_back(p);
       num_msgs--;
     }
-    if (m_SendBuffer.eof() && m_SendHandler) {
+    if (m_SendBuffer.IsEmpty() && m_SendHandler) {
       m_SendHandler(boost::system::error_code());
       m_SendHandler = nullptr;
     }
   }
   if (packets.size() > 0) {
+    // the data packets piggyback our ACK state, drop the pending quick ACK
     m_IsAckSendScheduled = false;
-    m_AckSendTimer.cancel();
-    bool is_empty = m_SentPackets.empty();
+    m_UnackedReceivedCount = 0;
+    m_LocalDestination.GetTimerWheel().Cancel(m_AckSendTimer);
+    bool is_empty = m_SentPackets.IsEmpty();
     auto ts = kovri::core::GetMillisecondsSinceEpoch();
     for (auto it : packets) {
       it->send_time = ts;
-      m_SentPackets.insert(it);
+      m_SentPackets.Insert(it);
     }
-    SendPackets(packets);
-    if (m_Status == eStreamStatusClosing && m_SendBuffer.eof())
+    SendPacketsPaced(packets);
+    // parity rides outside the window and the retransmit bookkeeping: the
+    // receiver either recovers with it or falls back to NACK/resend
+    if (!parity.empty()) {
+      SendPackets(parity);
+      for (auto it : parity)
+        m_LocalDestination.GetPacketPool().Release(it);
+    }
+    if (m_Status == eStreamStatusClosing && m_SendBuffer.IsEmpty())
       SendClose();
     if (is_empty)
       ScheduleResend();
@@ -491,8 +975,8 @@ void Stream::SendBuffer() {
 
 void Stream::SendQuickAck() {
   int32_t last_received_seqn = m_LastReceivedSequenceNumber;
-  if (!m_SavedPackets.empty()) {
-    int32_t seqn = (*m_SavedPackets.rbegin())->GetSeqn();
+  if (!m_SavedPackets.IsEmpty()) {
+    int32_t seqn = m_SavedPackets.GetBack()->GetSeqn();
     if (seqn > last_received_seqn)
       last_received_seqn = seqn;
   }
@@ -517,7 +1001,7 @@ void Stream::SendQuickAck() {
     // fill NACKs
     std::uint8_t* nacks = packet + size + 1;
     auto next_seqn = m_LastReceivedSequenceNumber + 1;
-    for (auto it : m_SavedPackets) {
+    for (Packet* it = m_SavedPackets.GetFront(); it; it = it->next) {
       auto seqn = it->GetSeqn();
       if (num_nacks + (seqn - next_seqn) >= 256) {
         LOG(error)
@@ -542,14 +1026,27 @@ void Stream::SendQuickAck() {
     size++;  // NACK count
   }
   size++;  // resend delay
-  // no flags set
-  core::OutputByteStream::Write<std::uint16_t>(packet + size, 0, false);
-  size += 2;  // flags
-  // no options
-  core::OutputByteStream::Write<std::uint16_t>(packet + size, 0, false);
-  size += 2;  // options size
+  // advertise consumer-paced flow control while the queue is backing up
+  std::uint16_t const delay = GetAdvertisedDelay();
+  if (delay) {
+    core::OutputByteStream::Write<std::uint16_t>(
+        packet + size, PACKET_FLAG_DELAY_REQUESTED);
+    size += 2;  // flags
+    core::OutputByteStream::Write<std::uint16_t>(packet + size, 2);
+    size += 2;  // options size
+    core::OutputByteStream::Write<std::uint16_t>(packet + size, delay);
+    size += 2;  // requested delay
+  } else {
+    // no flags set
+    core::OutputByteStream::Write<std::uint16_t>(packet + size, 0, false);
+    size += 2;  // flags
+    // no options
+    core::OutputByteStream::Write<std::uint16_t>(packet + size, 0, false);
+    size += 2;  // options size
+  }
   p.len = size;
   SendPackets(std::vector<Packet *> { &p });
+  m_UnackedReceivedCount = 0;
   LOG(debug) << "Stream: quick Ack sent. " << static_cast<int>(num_nacks) << " NACKs";
 }
 
@@ -567,7 +1064,7 @@ void Stream::Close() {
       m_LocalDestination.DeleteStream(shared_from_this());
     break;
     case eStreamStatusClosing:
-      if (m_SentPackets.empty() && m_SendBuffer.eof()) {  // nothing to send
+      if (m_SentPackets.IsEmpty() && m_SendBuffer.IsEmpty()) {  // nothing to send
         m_Status = eStreamStatusClosed;
         SendClose();
         Terminate();
@@ -587,7 +1084,7 @@ void Stream::Close() {
 
 // TODO(anonimal): bytestream refactor
 void Stream::SendClose() {
-  Packet* p = new Packet();
+  Packet* p = m_LocalDestination.GetPacketPool().Acquire();
   std::uint8_t* packet = p->GetBuffer();
   std::size_t size = 0;
   core::OutputByteStream::Write<std::uint32_t>(
@@ -631,35 +1128,102 @@ std::size_t Stream::ConcatenatePackets(
     std::uint8_t* buf,
     std::size_t len) {
   std::size_t pos = 0;
-  while (pos < len && !m_ReceiveQueue.empty()) {
-    Packet* packet = m_ReceiveQueue.front();
+  while (pos < len && !m_ReceiveQueue.IsEmpty()) {
+    Packet* packet = m_ReceiveQueue.GetFront();
     std::size_t l = std::min(packet->GetLength(), len - pos);
     memcpy(buf + pos, packet->GetBuffer(), l);
     pos += l;
     packet->offset += l;
     if (!packet->GetLength()) {
-      m_ReceiveQueue.pop();
-      delete packet;
+      m_ReceiveQueue.PopFront();
+      m_LocalDestination.GetPacketPool().Release(packet);
     }
   }
+  SampleDrainRate(pos);
+  return pos;
+}
+
+std::size_t Stream::ReceiveSegments(
+    std::vector<Packet*>& segments,
+    std::size_t max_bytes) {
+  std::size_t pos = 0;
+  while (!m_ReceiveQueue.IsEmpty()) {
+    Packet* packet = m_ReceiveQueue.GetFront();
+    const std::size_t l = packet->GetLength();
+    if (pos && pos + l > max_bytes)
+      break;  // the cap is soft: a lone oversized packet still goes out
+    m_ReceiveQueue.PopFront();
+    segments.push_back(packet);
+    pos += l;
+  }
+  SampleDrainRate(pos);
   return pos;
 }
 
+void Stream::ReleaseReceivedSegments(
+    const std::vector<Packet*>& segments) {
+  for (auto packet : segments)
+    m_LocalDestination.GetPacketPool().Release(packet);
+}
+
+// sample the consumer's drain rate for the advertised-delay estimate
+void Stream::SampleDrainRate(std::size_t drained) {
+  if (!drained)
+    return;
+  const auto ts = kovri::core::GetMillisecondsSinceEpoch();
+  if (m_LastDrainTime && ts > m_LastDrainTime) {
+    const std::size_t rate = drained * 1000 / (ts - m_LastDrainTime);
+    m_DrainRate = m_DrainRate ? (3 * m_DrainRate + rate) / 4 : rate;
+  }
+  m_LastDrainTime = ts;
+}
+
+std::uint16_t Stream::GetAdvertisedDelay() const {
+  const std::size_t depth = m_ReceiveQueue.GetSize();
+  if (depth < RECEIVE_QUEUE_DELAY_THRESHOLD)
+    return 0;  // consumer keeps up: no throttle, the window can open wide
+  const std::size_t excess = depth - RECEIVE_QUEUE_DELAY_THRESHOLD + 1;
+  std::uint64_t delay;
+  if (m_DrainRate) {
+    // time to drain the backlog at the measured consumption rate
+    delay = excess * STREAMING_MTU * 1000 / m_DrainRate;
+  } else {
+    // no sample yet: scale linearly toward the hard cap
+    delay = excess * MAX_REQUESTED_DELAY
+        / (MAX_RECEIVE_QUEUE_PACKETS - RECEIVE_QUEUE_DELAY_THRESHOLD);
+  }
+  return std::min<std::uint64_t>(delay, MAX_REQUESTED_DELAY);
+}
+
+void Stream::SetRemoteRequestedDelay(std::uint16_t delay) {
+  if (delay > MAX_REQUESTED_DELAY)
+    delay = MAX_REQUESTED_DELAY;
+  if (delay) {
+    LOG(debug) << "Stream: peer requested a " << delay << "ms send delay";
+    m_SendDelayUntil =
+        kovri::core::GetMillisecondsSinceEpoch() + delay;
+  } else {
+    m_SendDelayUntil = 0;
+  }
+}
+
 bool Stream::SendPacket(
     Packet* packet) {
   if (packet) {
     if (m_IsAckSendScheduled) {
+      // the packet's ackThrough field covers the pending quick ACK
       m_IsAckSendScheduled = false;
-      m_AckSendTimer.cancel();
+      m_UnackedReceivedCount = 0;
+      m_LocalDestination.GetTimerWheel().Cancel(m_AckSendTimer);
     }
     SendPackets(std::vector<Packet *> { packet });
     if (m_Status == eStreamStatusOpen) {
-      bool is_empty = m_SentPackets.empty();
-      m_SentPackets.insert(packet);
+      bool is_empty = m_SentPackets.IsEmpty();
+      m_SentPackets.Insert(packet);
       if (is_empty)
         ScheduleResend();
     } else {
-      delete packet;
+      m_LocalDestination.GetPacketPool().Release(packet);
     }
     return true;
   } else {
@@ -677,6 +1241,35 @@ void Stream::SendPackets(
       return;
     }
   }
+  if (m_NumPaths > 1) {
+    UpdatePaths();
+    std::vector<std::vector<kovri::core::TunnelMessageBlock>> msgs(
+        m_Paths.size());
+    for (auto it : packets) {
+      const std::size_t index = SelectPath();
+      if (index == m_Paths.size()) {
+        LOG(error) << "Stream: no usable send paths";
+        return;
+      }
+      StreamPath& path = m_Paths[index];
+      it->path = index;
+      path.in_flight++;
+      auto msg = m_RoutingSession->WrapSingleMessage(
+          CreateDataMessage(
+            it->GetBuffer(),
+            it->GetLength()));
+      msgs[index].emplace_back(
+          kovri::core::e_DeliveryTypeTunnel,
+          path.remote_lease.tunnel_gateway,
+          path.remote_lease.tunnel_ID,
+          std::move(msg));
+      m_NumSentBytes += it->GetLength();
+    }
+    for (std::size_t i = 0; i < m_Paths.size(); i++)
+      if (!msgs[i].empty())
+        m_Paths[i].outbound_tunnel->SendTunnelDataMsg(std::move(msgs[i]));
+    return;
+  }
   if (!m_CurrentOutboundTunnel || !m_CurrentOutboundTunnel->IsEstablished())
     m_CurrentOutboundTunnel =
       m_LocalDestination.GetOwner().GetTunnelPool()->GetNewOutboundTunnel(
@@ -697,31 +1290,112 @@ void Stream::SendPackets(
           CreateDataMessage(
             it->GetBuffer(),
             it->GetLength()));
-      msgs.push_back(
-          kovri::core::TunnelMessageBlock {
-            kovri::core::e_DeliveryTypeTunnel,
-            m_CurrentRemoteLease.tunnel_gateway,
-            m_CurrentRemoteLease.tunnel_ID,
-            msg
-          });
+      msgs.emplace_back(
+          kovri::core::e_DeliveryTypeTunnel,
+          m_CurrentRemoteLease.tunnel_gateway,
+          m_CurrentRemoteLease.tunnel_ID,
+          std::move(msg));
       m_NumSentBytes += it->GetLength();
     }
-    m_CurrentOutboundTunnel->SendTunnelDataMsg(msgs);
+    m_CurrentOutboundTunnel->SendTunnelDataMsg(std::move(msgs));
   } else {
     LOG(warning) << "Stream: all leases are expired";
   }
 }
 
+void Stream::UpdatePaths() {
+  if (m_Paths.empty())
+    m_Paths.resize(m_NumPaths);
+  if (!m_RoutingSession)
+    m_RoutingSession =
+      m_LocalDestination.GetOwner().GetRoutingSession(
+        m_RemoteLeaseSet, 32);
+  auto ts = kovri::core::GetMillisecondsSinceEpoch();
+  // shed dead tunnels and expiring leases; slots keep their index so
+  // in-flight packets still attribute ACKs to the right path
+  for (auto& path : m_Paths) {
+    if (!path.outbound_tunnel)
+      continue;
+    if (!path.outbound_tunnel->IsEstablished() ||
+        ts >= path.remote_lease.end_date -
+        kovri::core::TUNNEL_EXPIRATION_THRESHOLD * 1000)
+      path = StreamPath();
+  }
+  // same lease fallback order as UpdateCurrentRemoteLease
+  auto leases = m_RemoteLeaseSet->GetNonExpiredLeases(false);
+  if (leases.empty()) {
+    m_LocalDestination.GetOwner().RequestDestination(
+        m_RemoteIdentity->GetIdentHash());
+    leases = m_RemoteLeaseSet->GetNonExpiredLeases(true);
+  }
+  if (leases.empty())
+    return;
+  auto tunnels =
+    m_LocalDestination.GetOwner().GetTunnelPool()->GetOutboundTunnels(
+        m_NumPaths);
+  std::size_t next_lease =
+    kovri::core::RandInRange32(0, leases.size() - 1);
+  for (auto& tunnel : tunnels) {
+    bool used = false;
+    for (const auto& path : m_Paths)
+      if (path.outbound_tunnel == tunnel) {
+        used = true;
+        break;
+      }
+    if (used)
+      continue;
+    for (auto& path : m_Paths) {
+      if (path.outbound_tunnel)
+        continue;
+      path.outbound_tunnel = tunnel;
+      path.remote_lease = leases[next_lease++ % leases.size()];
+      break;
+    }
+  }
+}
+
+std::size_t Stream::SelectPath() const {
+  std::size_t best = m_Paths.size();
+  std::int64_t best_score = 0;
+  for (std::size_t i = 0; i < m_Paths.size(); i++) {
+    const StreamPath& path = m_Paths[i];
+    if (!path.outbound_tunnel)
+      continue;
+    // queue depth scaled by the path's smoothed RTT approximates time
+    // to drain; a sampleless path scores as fast so it gets probed
+    const std::int64_t score =
+        static_cast<std::int64_t>(path.in_flight + 1)
+        * (path.rtt ? path.rtt : 1);
+    if (best == m_Paths.size() || score < best_score) {
+      best = i;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+void Stream::SendPacketsPaced(
+    const std::vector<Packet *>& packets) {
+  // with no RTT sample yet, or once the per-stream interval rounds below
+  // a millisecond, pacing buys nothing over a plain burst
+  if (!GetPacingInterval()) {
+    SendPackets(packets);
+    return;
+  }
+  // the destination-wide pacer interleaves every stream's emission, so
+  // concurrent responses do not burst into the shared tunnels in phase
+  m_LocalDestination.PacePackets(shared_from_this(), packets);
+}
+
 void Stream::ScheduleResend() {
-  m_ResendTimer.cancel();
-  m_ResendTimer.expires_from_now(
-      boost::posix_time::milliseconds(
-        m_RTO));
-  m_ResendTimer.async_wait(
-      std::bind(
-        &Stream::HandleResendTimer,
-        shared_from_this(),
-        std::placeholders::_1));
+  auto& wheel = m_LocalDestination.GetTimerWheel();
+  wheel.Cancel(m_ResendTimer);
+  auto s = shared_from_this();
+  m_ResendTimer = wheel.Add(
+      m_RTO,
+      [s](bool) {
+        s->HandleResendTimer(boost::system::error_code());
+      });
 }
 
 void Stream::HandleResendTimer(
@@ -739,7 +1413,7 @@ void Stream::HandleResendTimer(
     // collect packets to resend
     auto ts = kovri::core::GetMillisecondsSinceEpoch();
     std::vector<Packet *> packets;
-    for (auto it : m_SentPackets) {
+    for (Packet* it = m_SentPackets.GetFront(); it; it = it->next) {
       if (ts >= it->send_time + m_RTO) {
         it->send_time = ts;
         packets.push_back(it);
@@ -754,26 +1428,53 @@ void Stream::HandleResendTimer(
           m_WindowSize /= 2;
           if (m_WindowSize < MIN_WINDOW_SIZE)
             m_WindowSize = MIN_WINDOW_SIZE;
+          // leave slow start where congestion appeared
+          m_SSThresh = std::max(m_WindowSize, WINDOW_SIZE);
         break;
         case 2:
           // drop RTO to initial upon tunnels pair change first time
           m_RTO = INITIAL_RTO;
           // fall-through
         case 4:
-          UpdateCurrentRemoteLease();  // pick another lease
-          LOG(warning)
-            << "Stream: another remote lease has been selected for stream";
+          if (m_NumPaths == 1) {
+            UpdateCurrentRemoteLease();  // pick another lease
+            LOG(warning)
+              << "Stream: another remote lease has been selected for stream";
+          }
         break;
         case 3:
-          // pick another outbound tunnel
-          m_CurrentOutboundTunnel =
-            m_LocalDestination.GetOwner().GetTunnelPool()->GetNextOutboundTunnel(
-                m_CurrentOutboundTunnel);
-          LOG(warning)
-            << "Stream: another outbound tunnel has been selected for stream";
+          if (m_NumPaths == 1) {
+            // pick another outbound tunnel
+            m_CurrentOutboundTunnel =
+              m_LocalDestination.GetOwner().GetTunnelPool()->GetNextOutboundTunnel(
+                  m_CurrentOutboundTunnel);
+            LOG(warning)
+              << "Stream: another outbound tunnel has been selected for stream";
+          }
         break;
         default: {}
       }
+      if (m_NumPaths > 1) {
+        // charge each path one loss per resend round; lossy paths get
+        // their tunnel replaced on the next UpdatePaths refill
+        bool lost[MAX_STREAM_PATHS] = {};
+        for (auto it : packets) {
+          if (it->path < m_Paths.size()) {
+            lost[it->path] = true;
+            if (m_Paths[it->path].in_flight > 0)
+              m_Paths[it->path].in_flight--;
+          }
+        }
+        for (std::size_t i = 0; i < m_Paths.size(); i++) {
+          StreamPath& path = m_Paths[i];
+          if (!path.outbound_tunnel || !lost[i])
+            continue;
+          if (++path.losses >= STREAM_PATH_LOSS_LIMIT) {
+            LOG(warning) << "Stream: dropping lossy send path " << i;
+            path = StreamPath();
+          }
+        }
+      }
       SendPackets(packets);
     }
     ScheduleResend();
@@ -802,11 +1503,11 @@ void Stream::UpdateCurrentRemoteLease(
   if (!m_RemoteLeaseSet) {
     m_RemoteLeaseSet =
       m_LocalDestination.GetOwner().FindLeaseSet(
-        m_RemoteIdentity.GetIdentHash());
+        m_RemoteIdentity->GetIdentHash());
     if (!m_RemoteLeaseSet)
       LOG(debug)
         << "Stream: LeaseSet "
-        << m_RemoteIdentity.GetIdentHash().ToBase64() << " not found";
+        << kovri::core::ToBase64Cached(m_RemoteIdentity->GetIdentHash()) << " not found";
   }
   if (m_RemoteLeaseSet) {
     if (!m_RoutingSession)
@@ -818,7 +1519,7 @@ void Stream::UpdateCurrentRemoteLease(
     if (leases.empty()) {
       expired = false;
       m_LocalDestination.GetOwner().RequestDestination(
-          m_RemoteIdentity.GetIdentHash());  // time to re-request
+          m_RemoteIdentity->GetIdentHash());  // time to re-request
       // then with threshold
       leases = m_RemoteLeaseSet->GetNonExpiredLeases(true);
     }
@@ -858,13 +1559,13 @@ std::shared_ptr<kovri::core::I2NPMessage> Stream::CreateDataMessage(
     std::size_t len) {
   auto msg = kovri::core::ToSharedI2NPMessage(kovri::core::NewI2NPShortMessage());
   try {
-    kovri::core::Gzip compressor;
+    auto& compressor = kovri::core::ThreadLocalGzip();
     if (len <= kovri::client::COMPRESSION_THRESHOLD_SIZE)
       compressor.SetDeflateLevel(
           compressor.GetMinDeflateLevel());
     else
-      compressor.SetDeflateLevel(
-          compressor.GetDefaultDeflateLevel());
+      // store-only when the application payload is already compressed
+      compressor.SetDeflateLevelFor(payload, len);
     compressor.Put(
         payload,
         len);
@@ -890,28 +1591,123 @@ std::shared_ptr<kovri::core::I2NPMessage> Stream::CreateDataMessage(
   return msg;
 }
 
+StreamingDestination::StreamingDestination(
+    kovri::client::ClientDestination& owner,
+    std::uint16_t local_port)
+    : m_Owner(owner),
+      m_LocalPort(local_port),
+      m_AcceptHead(0),
+      m_AcceptTail(0),
+      m_AcceptRingEnabled(false),
+      m_TimerWheel(owner.GetService()),
+      m_PacerTimer(0),
+      m_IsPacing(false),
+      m_Exception(__func__) {}
+
 void StreamingDestination::Start() {}
 
 void StreamingDestination::Stop() {
-  ResetAcceptor(); {
-    std::unique_lock<std::mutex> l(m_StreamsMutex);
-    m_Streams.clear();
+  ResetAcceptor();
+  for (auto& shard : m_Shards) {
+    std::unique_lock<std::mutex> l(shard.mutex);
+    shard.streams.clear();
+  }
+  for (auto& pending : m_AcceptRing)
+    pending = nullptr;
+  m_AcceptHead = 0;
+  m_AcceptTail = 0;
+  m_TimerWheel.Cancel(m_PacerTimer);
+  m_PacedStreams.clear();  // the streams' sent-packet lists own the packets
+  m_IsPacing = false;
+  m_TimerWheel.Stop();
+}
+
+void StreamingDestination::PacePackets(
+    std::shared_ptr<Stream> stream,
+    const std::vector<Packet*>& packets) {
+  if (packets.empty())
+    return;  // every queue entry must have at least one packet
+  auto it = std::find_if(
+      m_PacedStreams.begin(),
+      m_PacedStreams.end(),
+      [&stream](const auto& entry) { return entry.first == stream; });
+  if (it == m_PacedStreams.end()) {
+    m_PacedStreams.emplace_back(std::move(stream), std::deque<Packet*>());
+    it = std::prev(m_PacedStreams.end());
+  }
+  for (auto packet : packets)
+    it->second.push_back(packet);
+  if (!m_IsPacing) {
+    m_IsPacing = true;
+    // emit the head right away, the timer paces the rest
+    HandleAggregatePacingTimer();
+  }
+}
+
+void StreamingDestination::CancelPacedPackets(
+    const Stream* stream) {
+  for (auto it = m_PacedStreams.begin(); it != m_PacedStreams.end(); it++)
+    if (it->first.get() == stream) {
+      m_PacedStreams.erase(it);
+      break;
+    }
+}
+
+void StreamingDestination::HandleAggregatePacingTimer() {
+  if (!m_PacedStreams.empty()) {
+    auto entry = std::move(m_PacedStreams.front());
+    m_PacedStreams.pop_front();
+    auto packet = entry.second.front();
+    entry.second.pop_front();
+    // stamp at actual wire time so RTT samples exclude the pacing delay
+    packet->send_time = kovri::core::GetMillisecondsSinceEpoch();
+    entry.first->SendPackets(std::vector<Packet*>{packet});
+    if (!entry.second.empty())
+      m_PacedStreams.push_back(std::move(entry));
+  }
+  if (m_PacedStreams.empty()) {
+    m_IsPacing = false;
+    return;
   }
+  m_PacerTimer = m_TimerWheel.Add(
+      AggregatePacingInterval(),
+      [this](bool aborted) {
+        if (!aborted)
+          HandleAggregatePacingTimer();
+      });
+}
+
+std::uint64_t StreamingDestination::AggregatePacingInterval() const {
+  // sum the claimants' own rates (window over windowed min RTT, i.e. what
+  // their tunnels' congestion feedback currently allows) and emit one
+  // packet per interval of the aggregate
+  std::uint64_t rate = 0;  // packets per second, each claimant counts >= 1
+  for (const auto& entry : m_PacedStreams) {
+    const int interval = entry.first->GetPacingInterval();
+    rate += interval > 0 ? std::max(1000 / interval, 1) : 1000;
+  }
+  const std::uint64_t interval = 1000 / rate;
+  return interval > 0 ? interval : 1;
 }
 
 void StreamingDestination::HandleNextPacket(
     Packet* packet) {
   std::uint32_t send_stream_ID = packet->GetSendStreamID();
   if (send_stream_ID) {
-    auto it = m_Streams.find(
-        send_stream_ID);
-    if (it != m_Streams.end()) {
-      it->second->HandleNextPacket(
-          packet);
+    std::shared_ptr<Stream> stream;
+    {
+      auto& shard = GetShard(send_stream_ID);
+      std::unique_lock<std::mutex> l(shard.mutex);
+      auto it = shard.streams.find(send_stream_ID);
+      if (it != shard.streams.end())
+        stream = it->second;
+    }
+    if (stream) {
+      stream->HandleNextPacket(packet);
     } else {
       LOG(warning)
         << "StreamingDestination: unknown stream " << send_stream_ID;
-      delete packet;
+      m_PacketPool.Release(packet);
     }
   } else {
     if (packet->IsSYN() && !packet->GetSeqn()) {  // new incoming stream
@@ -919,6 +1715,13 @@ void StreamingDestination::HandleNextPacket(
       incoming_stream->HandleNextPacket(packet);
       if (m_Acceptor != nullptr) {
         m_Acceptor(incoming_stream);
+      } else if (m_AcceptRingEnabled) {
+        if (!PushPendingAccept(incoming_stream)) {
+          LOG(warning)
+            << "StreamingDestination: pending-accept ring full, "
+            << "dropping incoming stream";
+          DeleteStream(incoming_stream);
+        }
       } else {
         LOG(warning)
           << "StreamingDestination: acceptor for incoming stream is not set";
@@ -926,52 +1729,87 @@ void StreamingDestination::HandleNextPacket(
       }
     } else {  // follow on packet without SYN
       std::uint32_t receive_stream_ID = packet->GetReceiveStreamID();
-      for (auto it : m_Streams)
-        if (it.second->GetSendStreamID() == receive_stream_ID) {
-          // found
-          it.second->HandleNextPacket(packet);
-          return;
-        }
+      for (auto& shard : m_Shards) {
+        std::unique_lock<std::mutex> l(shard.mutex);
+        for (const auto& it : shard.streams)
+          if (it.second->GetSendStreamID() == receive_stream_ID) {
+            // found
+            auto stream = it.second;
+            l.unlock();
+            stream->HandleNextPacket(packet);
+            return;
+          }
+      }
       // TODO(unassigned): should queue it up
       LOG(warning)
         << "StreamingDestination: Unknown stream " << receive_stream_ID;
-      delete packet;
+      m_PacketPool.Release(packet);
     }
   }
 }
 
+bool StreamingDestination::PushPendingAccept(
+    std::shared_ptr<Stream> stream) {
+  std::size_t const tail = m_AcceptTail.load(std::memory_order_relaxed);
+  if (tail - m_AcceptHead.load(std::memory_order_acquire)
+      >= STREAMING_ACCEPT_RING_SIZE)
+    return false;  // ring full
+  m_AcceptRing[tail & (STREAMING_ACCEPT_RING_SIZE - 1)] = std::move(stream);
+  m_AcceptTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+std::size_t StreamingDestination::AcceptMany(
+    std::size_t max,
+    const Acceptor& acceptor) {
+  std::size_t head = m_AcceptHead.load(std::memory_order_relaxed);
+  std::size_t num_accepted = 0;
+  while (num_accepted < max
+      && head != m_AcceptTail.load(std::memory_order_acquire)) {
+    auto& slot = m_AcceptRing[head & (STREAMING_ACCEPT_RING_SIZE - 1)];
+    auto stream = std::move(slot);
+    slot = nullptr;
+    head++;
+    m_AcceptHead.store(head, std::memory_order_release);
+    acceptor(stream);
+    num_accepted++;
+  }
+  return num_accepted;
+}
+
 std::shared_ptr<Stream> StreamingDestination::CreateNewOutgoingStream(
     std::shared_ptr<const kovri::core::LeaseSet> remote,
     std::uint16_t port) {
   auto s = std::make_shared<Stream>(m_Owner.GetService(), *this, remote, port);
-  std::unique_lock<std::mutex> l(m_StreamsMutex);
-  m_Streams[s->GetReceiveStreamID()] = s;
+  auto& shard = GetShard(s->GetReceiveStreamID());
+  std::unique_lock<std::mutex> l(shard.mutex);
+  shard.streams[s->GetReceiveStreamID()] = s;
   return s;
 }
 
 std::shared_ptr<Stream> StreamingDestination::CreateNewIncomingStream() {
   auto s = std::make_shared<Stream>(m_Owner.GetService(), *this);
-  std::unique_lock<std::mutex> l(m_StreamsMutex);
-  m_Streams[s->GetReceiveStreamID()] = s;
+  auto& shard = GetShard(s->GetReceiveStreamID());
+  std::unique_lock<std::mutex> l(shard.mutex);
+  shard.streams[s->GetReceiveStreamID()] = s;
   return s;
 }
 
 void StreamingDestination::DeleteStream(
     std::shared_ptr<Stream> stream) {
   if (stream) {
-    std::unique_lock<std::mutex> l(m_StreamsMutex);
-    auto it = m_Streams.find(stream->GetReceiveStreamID());
-    if (it != m_Streams.end())
-      m_Streams.erase(it);
+    auto& shard = GetShard(stream->GetReceiveStreamID());
+    std::unique_lock<std::mutex> l(shard.mutex);
+    shard.streams.erase(stream->GetReceiveStreamID());
   }
 }
 
 void StreamingDestination::HandleDataMessagePayload(
     const std::uint8_t* buf,
     std::size_t len) {
-  Packet* uncompressed = new Packet;
+  Packet* uncompressed = m_PacketPool.Acquire();
   try {
-    kovri::core::Gunzip decompressor;
+    auto& decompressor = kovri::core::ThreadLocalGunzip();
     decompressor.Put(buf, len);
     uncompressed->offset = 0;
     uncompressed->len = decompressor.MaxRetrievable();
@@ -979,14 +1817,14 @@ void StreamingDestination::HandleDataMessagePayload(
       LOG(debug)
         << "StreamingDestination: received packet size "
         << uncompressed->len << " exceeds max packet size, skipped";
-      delete uncompressed;
+      m_PacketPool.Release(uncompressed);
       return;
     }
     decompressor.Get(uncompressed->buf, uncompressed->len);
     HandleNextPacket(uncompressed);
   } catch (...) {
     m_Exception.Dispatch(__func__);
-    delete uncompressed;
+    m_PacketPool.Release(uncompressed);
   }
 }
 
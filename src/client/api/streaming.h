@@ -35,16 +35,18 @@
 
 #include <boost/asio.hpp>
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
-#include <set>
-#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "core/router/garlic.h"
@@ -54,6 +56,7 @@
 #include "core/router/tunnel/impl.h"
 
 #include "core/util/exception.h"
+#include "core/util/timer_wheel.h"
 
 namespace kovri {
 namespace client {
@@ -72,27 +75,81 @@ const std::uint16_t PACKET_FLAG_PROFILE_INTERACTIVE = 0x0100;
 const std::uint16_t PACKET_FLAG_ECHO = 0x0200;
 const std::uint16_t PACKET_FLAG_NO_ACK = 0x0400;
 
+// Local extension flags (reserved range in the upstream spec): forward
+// error correction negotiated through the SYN exchange, see FEC_GROUP_SIZE
+const std::uint16_t PACKET_FLAG_FEC_SUPPORTED = 0x0800;
+const std::uint16_t PACKET_FLAG_FEC_PARITY = 0x1000;
+
 const std::size_t STREAMING_MTU = 1730;
 const std::size_t MAX_PACKET_SIZE = 4096;
 const std::size_t COMPRESSION_THRESHOLD_SIZE = 66;
 const int ACK_SEND_TIMEOUT = 200;  // in milliseconds
+
+/// @brief In-order packets received before a delayed ACK is forced out
+///   (RFC-1122-style ack-every-second-packet); a lone packet waits for
+///   ACK_SEND_TIMEOUT or for outbound data to piggyback on
+const int DELAYED_ACK_PACKET_LIMIT = 2;
 const int MAX_NUM_RESEND_ATTEMPTS = 6;
 const int WINDOW_SIZE = 6;  // in messages
 const int MIN_WINDOW_SIZE = 1;
-const int MAX_WINDOW_SIZE = 128;
+const int MAX_WINDOW_SIZE = 512;  // upper bound for streaming-max-window
 const int INITIAL_RTT = 8000;  // in milliseconds
 const int INITIAL_RTO = 9000;  // in milliseconds
+const int MIN_RTO = 1000;  // RFC 6298 lower bound, in milliseconds
+const int MAX_RTO = 60000;  // in milliseconds
+const int MIN_RTT_WINDOW = 30000;  // min-RTT sample lifetime, in milliseconds
+
+/// @brief Upper bound for the "streaming-paths" option: tunnel pairs one
+///   stream may stripe packets across
+const std::size_t MAX_STREAM_PATHS = 3;
+
+/// @brief Receive-queue depth (in packets) past which outgoing ACKs start
+///   advertising a requested send delay to the peer
+const std::size_t RECEIVE_QUEUE_DELAY_THRESHOLD = 64;
+
+/// @brief Hard per-stream receive-queue cap, in packets: arrivals beyond
+///   it are dropped unacknowledged for the sender to retransmit once the
+///   advertised delay expires
+const std::size_t MAX_RECEIVE_QUEUE_PACKETS = 256;
+
+/// @brief Largest send delay (in milliseconds) we advertise or honor
+const std::uint16_t MAX_REQUESTED_DELAY = 10000;
+
+/// @brief Resend rounds a path survives before its tunnel is replaced
+const int STREAM_PATH_LOSS_LIMIT = 2;
+
+/// @brief Data packets covered by one XOR parity packet in the negotiated
+///   FEC mode; groups are aligned (first seqn divisible by the group size)
+///   so both ends derive membership from the sequence number alone
+const std::size_t FEC_GROUP_SIZE = 8;
+
+/// @brief Receive-side FEC group slots kept per stream (reordering across
+///   more groups loses recovery, not data); must be a power of two
+const std::size_t FEC_GROUP_SLOTS = 4;
+
+/// @brief Number of independently locked shards in the streamID->stream
+///   table; must be a power of two (receive stream IDs are random)
+const std::size_t STREAMING_DEMUX_SHARDS = 16;
+
+/// @brief Capacity of the pending-accept ring; must be a power of two
+const std::size_t STREAMING_ACCEPT_RING_SIZE = 256;
 
 // TODO(anonimal): bytestream refactor
 struct Packet {
   std::size_t len, offset;
   std::uint8_t buf[MAX_PACKET_SIZE];  // TODO(anonimal): zero-initialize
   std::uint64_t send_time;
+  // index of the multipath send path this packet last went out on
+  std::uint8_t path;
+  // intrusive link for PacketList/PacketPool membership
+  Packet* next;
 
   Packet()
       : len(0),
         offset(0),
-        send_time(0) {}
+        send_time(0),
+        path(0),
+        next(nullptr) {}
 
   std::uint8_t* GetBuffer() {
     return buf + offset;
@@ -150,12 +207,144 @@ struct Packet {
   bool IsNoAck() const {
     return GetFlags() & PACKET_FLAG_NO_ACK;
   }
+  bool IsFecParity() const {
+    return GetFlags() & PACKET_FLAG_FEC_PARITY;
+  }
+};
+
+/// @class PacketList
+/// @brief Intrusive singly-linked list of packets ordered by sequence
+///   number: the link lives inside Packet, so membership costs no node
+///   allocations. A packet belongs to at most one list at a time
+class PacketList {
+ public:
+  PacketList()
+      : m_Head(nullptr),
+        m_Tail(nullptr),
+        m_Size(0) {}
+
+  bool IsEmpty() const {
+    return !m_Head;
+  }
+
+  std::size_t GetSize() const {
+    return m_Size;
+  }
+
+  /// @brief Lowest sequence number; iterate onward through Packet::next
+  Packet* GetFront() const {
+    return m_Head;
+  }
+
+  /// @brief Highest sequence number
+  Packet* GetBack() const {
+    return m_Tail;
+  }
+
+  /// @brief Links packet at its sequence-ordered position (a plain append
+  ///   in the common in-order case)
+  void Insert(Packet* packet);
+
+  Packet* PopFront();
+
+  /// @brief Unlinks the packet following prev (the head when prev is null)
+  /// @return The unlinked packet
+  Packet* EraseAfter(Packet* prev);
+
+ private:
+  Packet *m_Head, *m_Tail;
+  std::size_t m_Size;
+};
+
+/// @class PacketPool
+/// @brief Free list recycling Packet objects across a destination's
+///   streams; locked because the last reference to a stream (and so its
+///   queued packets) can die on another thread
+class PacketPool {
+ public:
+  PacketPool()
+      : m_Free(nullptr),
+        m_FreeCount(0) {}
+
+  ~PacketPool();
+
+  /// @brief Returns a reset packet from the free list, or a fresh one
+  Packet* Acquire();
+
+  void Release(Packet* packet);
+
+ private:
+  /// @enum Size
+  /// @brief Pool traits
+  enum Size : std::uint16_t {
+    /// @brief Packets kept for reuse before being freed
+    MaxFreePackets = 256,
+  };
+
+  std::mutex m_Mutex;
+  Packet* m_Free;
+  std::size_t m_FreeCount;
 };
 
-struct PacketCmp {
-  bool operator() (const Packet * p1, const Packet * p2) const {
-    return p1->GetSeqn() < p2->GetSeqn();
+/// @class SendBufferQueue
+/// @brief Outbound stream data buffered as a queue of fixed-size segments:
+///   Send() appends into the tail segment, packetization drains from the
+///   head, and emptied segments go onto a free list for reuse, so buffering
+///   does no stringstream-style reallocations on the send hot path
+class SendBufferQueue {
+ public:
+  SendBufferQueue()
+      : m_Head(nullptr),
+        m_Tail(nullptr),
+        m_Free(nullptr),
+        m_FreeCount(0),
+        m_Size(0) {}
+
+  ~SendBufferQueue();
+
+  /// @brief Copies len bytes from buf onto the tail of the queue
+  void Append(
+      const std::uint8_t* buf,
+      std::size_t len);
+
+  /// @brief Copies up to len buffered bytes into buf, recycling segments
+  ///   as they drain
+  /// @return Number of bytes copied
+  std::size_t Read(
+      std::uint8_t* buf,
+      std::size_t len);
+
+  std::size_t GetSize() const {
+    return m_Size;
+  }
+
+  bool IsEmpty() const {
+    return !m_Size;
   }
+
+ private:
+  /// @enum Size
+  /// @brief Segment/pool traits
+  enum Size : std::uint16_t {
+    /// @brief Payload capacity of one segment
+    SegmentSize = 4096,
+
+    /// @brief Drained segments kept for reuse before being freed
+    MaxFreeSegments = 32,
+  };
+
+  struct Segment {
+    std::uint8_t buf[SegmentSize];
+    std::size_t begin, end;
+    Segment* next;
+  };
+
+  /// @brief Takes a segment from the free list or allocates a fresh one
+  Segment* Allocate();
+
+ private:
+  Segment *m_Head, *m_Tail, *m_Free;
+  std::size_t m_FreeCount, m_Size;
 };
 
 enum StreamStatus {
@@ -196,7 +385,7 @@ class Stream : public std::enable_shared_from_this<Stream> {
   }
 
   const kovri::core::IdentityEx& GetRemoteIdentity() const {
-    return m_RemoteIdentity;
+    return *m_RemoteIdentity;
   }
 
   bool IsOpen() const {
@@ -233,6 +422,31 @@ class Stream : public std::enable_shared_from_this<Stream> {
       ReceiveHandler handler,
       int timeout = 0);
 
+  /// @brief Zero-copy variant of AsyncReceive: the handler is given the
+  ///   reassembled pooled packets themselves instead of a copy into a
+  ///   caller buffer, and must hand every one back through
+  ///   ReleaseReceivedSegments once done with the payloads (for a socket
+  ///   relay: after the write completes)
+  /// @param max_bytes Soft cap on payload bytes handed out per call; at
+  ///   least one queued packet is always delivered
+  template<typename SegmentHandler>
+  void AsyncReceiveSegments(
+      std::size_t max_bytes,
+      SegmentHandler handler,
+      int timeout = 0);
+
+  /// @brief Pops reassembled packets off the receive queue without
+  ///   copying; consume payloads via Packet::GetBuffer/GetLength
+  /// @return Total payload bytes across the appended segments
+  std::size_t ReceiveSegments(
+      std::vector<Packet*>& segments,
+      std::size_t max_bytes);
+
+  /// @brief Recycles segments obtained from ReceiveSegments into the
+  ///   destination's packet pool
+  void ReleaseReceivedSegments(
+      const std::vector<Packet*>& segments);
+
   std::size_t ReadSome(
       std::uint8_t* buf,
       std::size_t len) {
@@ -240,9 +454,7 @@ class Stream : public std::enable_shared_from_this<Stream> {
   }
   void Close();
 
-  void Cancel() {
-    m_ReceiveTimer.cancel();
-  }
+  void Cancel();
 
   std::size_t GetNumSentBytes() const {
     return m_NumSentBytes;
@@ -253,15 +465,15 @@ class Stream : public std::enable_shared_from_this<Stream> {
   }
 
   std::size_t GetSendQueueSize() const {
-    return m_SentPackets.size();
+    return m_SentPackets.GetSize();
   }
 
   std::size_t GetReceiveQueueSize() const {
-    return m_ReceiveQueue.size();
+    return m_ReceiveQueue.GetSize();
   }
 
   std::size_t GetSendBufferSize() const {
-    return m_SendBuffer.rdbuf()->in_avail();
+    return m_SendBuffer.GetSize();
   }
 
   int GetWindowSize() const {
@@ -272,7 +484,18 @@ class Stream : public std::enable_shared_from_this<Stream> {
     return m_RTT;
   }
 
+  /// @brief Pacing interval this stream would use on its own: the
+  ///   windowed min RTT spread over twice the current window, in
+  ///   milliseconds (0 until the first RTT sample, or when the interval
+  ///   rounds below a millisecond and pacing buys nothing over a burst)
+  int GetPacingInterval() const {
+    return m_RTTVAR < 0 ? 0 : m_MinRTT / (2 * m_WindowSize);
+  }
+
  private:
+  // the destination's aggregate pacer emits through SendPackets
+  friend class StreamingDestination;
+
   void Terminate();
 
   void SendBuffer();
@@ -287,6 +510,14 @@ class Stream : public std::enable_shared_from_this<Stream> {
   void SendPackets(
       const std::vector<Packet *>& packets);
 
+  /// @brief Queues fresh data packets for paced transmission through the
+  ///   destination's aggregate pacer: instead of bursting the whole window
+  ///   into the tunnel, packets are spread at the rate implied by the
+  ///   windowed min RTT and the current window, interleaved with every
+  ///   other stream of the destination
+  void SendPacketsPaced(
+      const std::vector<Packet *>& packets);
+
   void SavePacket(
       Packet* packet);
 
@@ -308,42 +539,179 @@ class Stream : public std::enable_shared_from_this<Stream> {
       const Buffer& buffer,
       ReceiveHandler handler);
 
+  template<typename SegmentHandler>
+  void HandleReceiveSegmentsTimer(
+      const boost::system::error_code& ecode,
+      std::size_t max_bytes,
+      SegmentHandler handler);
+
+  /// @brief Feeds a drain of the receive queue into the advertised-delay
+  ///   rate estimate
+  void SampleDrainRate(std::size_t drained);
+
   void ScheduleResend();
 
   void HandleResendTimer(
       const boost::system::error_code& ecode);
 
+  /// @brief Arms the delayed-ACK timer on the destination's timing wheel
+  void ScheduleAckSend();
+
+  /// @brief Send delay to advertise on outgoing ACKs: zero while the
+  ///   consumer keeps up, otherwise the estimated time to drain the
+  ///   receive-queue backlog at the measured consumption rate
+  std::uint16_t GetAdvertisedDelay() const;
+
+  /// @brief Records a peer-requested send delay; fresh data is held back
+  ///   until it expires (zero lifts the hold)
+  void SetRemoteRequestedDelay(std::uint16_t delay);
+
   void HandleAckSendTimer(
       const boost::system::error_code& ecode);
 
   std::shared_ptr<kovri::core::I2NPMessage> CreateDataMessage(
       const std::uint8_t * payload, std::size_t len);
 
+  /// @brief One multipath send slot: an outbound tunnel and remote lease
+  ///   pair with its own smoothed RTT, loss and in-flight accounting.
+  ///   An empty tunnel marks a free slot for UpdatePaths to refill, so
+  ///   slot indices stamped on in-flight packets stay stable
+  struct StreamPath {
+    std::shared_ptr<kovri::core::OutboundTunnel> outbound_tunnel;
+    kovri::core::Lease remote_lease;
+    int rtt = 0;  // 0 until the first sample
+    int losses = 0;  // resend rounds since the last ACK on this path
+    int in_flight = 0;
+  };
+
+  /// @brief Drops dead tunnels and expired leases from the path table
+  ///   and refills free slots from the tunnel pool and remote LeaseSet
+  void UpdatePaths();
+
+  /// @brief Valid path with the least in-flight data scaled by its
+  ///   smoothed RTT; paths without a sample count as fast so they get
+  ///   probed
+  /// @return Path index, or m_Paths.size() when no path is usable
+  std::size_t SelectPath() const;
+
+  /// @brief One FEC group accumulator holding the XOR of the
+  ///   length-prefixed payloads folded in so far. Bit i of mask marks data
+  ///   member i, bit FEC_GROUP_SIZE the parity packet; once every
+  ///   contribution but one is folded in, the accumulator is exactly the
+  ///   missing one
+  struct FecGroup {
+    std::uint32_t group = 0;  // sequence number / FEC_GROUP_SIZE
+    std::uint16_t mask = 0;
+    std::size_t width = 0;  // widest contribution folded in, in bytes
+    std::uint8_t acc[STREAMING_MTU] = {};
+
+    void Reset(std::uint32_t id) {
+      group = id;
+      mask = 0;
+      width = 0;
+      memset(acc, 0, sizeof(acc));
+    }
+
+    /// @brief Folds a data payload in, prefixed with its 16-bit length
+    void FoldData(const std::uint8_t* payload, std::size_t len) {
+      acc[0] ^= static_cast<std::uint8_t>(len >> 8);
+      acc[1] ^= static_cast<std::uint8_t>(len);
+      for (std::size_t i = 0; i < len; i++)
+        acc[2 + i] ^= payload[i];
+      if (2 + len > width)
+        width = 2 + len;
+    }
+
+    /// @brief Folds a parity payload in (already a XOR of prefixed
+    ///   payloads, so no prefix of its own)
+    void FoldParity(const std::uint8_t* payload, std::size_t len) {
+      for (std::size_t i = 0; i < len; i++)
+        acc[i] ^= payload[i];
+      if (len > width)
+        width = len;
+    }
+  };
+
+  /// @brief Sender half of the negotiated FEC mode: folds a freshly
+  ///   packetized payload into the current group and appends the finished
+  ///   group's parity packet to parity (caller sends and releases it)
+  void FecAccumulateSent(
+      const std::uint8_t* payload,
+      std::size_t len,
+      std::uint32_t seqn,
+      std::vector<Packet *>& parity);
+
+  Packet* CreateFecParityPacket(
+      const FecGroup& group);
+
+  /// @brief Folds a received data packet into its group's accumulator
+  void FecAccumulate(
+      Packet* packet);
+
+  /// @brief Folds a parity packet in and releases it back to the pool
+  void HandleFecParity(
+      Packet* packet);
+
+  /// @brief Reconstructs the single missing data packet of a group once
+  ///   every other contribution has been folded in, and runs it through
+  ///   the normal receive path
+  void FecTryRecover(
+      FecGroup& group);
+
  private:
   boost::asio::io_service& m_Service;
   std::uint32_t m_SendStreamID, m_RecvStreamID, m_SequenceNumber;
   std::int32_t m_LastReceivedSequenceNumber;
   StreamStatus m_Status;
   bool m_IsAckSendScheduled;
+  // in-order packets whose ACK has not left yet, in any form: reset when
+  // a quick ACK goes out or outbound data carries the ACK instead
+  int m_UnackedReceivedCount;
+  // receiver-side flow control: EWMA of the consumer's drain rate
+  // (bytes/second, 0 until the first sample) feeding GetAdvertisedDelay
+  std::size_t m_DrainRate;
+  std::uint64_t m_LastDrainTime;
+  // sender side: hold fresh data until this time when the peer advertised
+  // a requested delay (0 = unthrottled)
+  std::uint64_t m_SendDelayUntil;
+  bool m_IsSendDelayScheduled;
   StreamingDestination& m_LocalDestination;
-  kovri::core::IdentityEx m_RemoteIdentity;
+  // interned: shared with every other holder of this peer's identity
+  std::shared_ptr<const kovri::core::IdentityEx> m_RemoteIdentity;
   std::shared_ptr<const kovri::core::LeaseSet> m_RemoteLeaseSet;
   std::shared_ptr<kovri::core::GarlicRoutingSession> m_RoutingSession;
   kovri::core::Lease m_CurrentRemoteLease;
   std::shared_ptr<kovri::core::OutboundTunnel> m_CurrentOutboundTunnel;
-  std::queue<Packet*> m_ReceiveQueue;
-  std::set<Packet*, PacketCmp> m_SavedPackets;
-  std::set<Packet*, PacketCmp> m_SentPackets;
-  boost::asio::deadline_timer m_ReceiveTimer, m_ResendTimer, m_AckSendTimer;
+  // multipath striping state; unused (m_Paths stays empty) when the
+  // configured path count is 1
+  std::vector<StreamPath> m_Paths;
+  std::size_t m_NumPaths;
+  PacketList m_ReceiveQueue;
+  PacketList m_SavedPackets;
+  PacketList m_SentPackets;
+  // Logical timers on the destination's timing wheel (0 = not armed).
+  // Stale tokens are harmless: cancelling a fired timer is a no-op
+  kovri::core::TimerWheel::Token m_ReceiveTimer, m_ResendTimer, m_AckSendTimer;
   std::size_t m_NumSentBytes, m_NumReceivedBytes;
   std::uint16_t m_Port;
 
   std::mutex m_SendBufferMutex;
-  std::stringstream m_SendBuffer;
-  int m_WindowSize, m_RTT, m_RTO;
+  SendBufferQueue m_SendBuffer;
+  // m_RTT/m_RTTVAR track the RFC 6298 smoothed estimator (m_RTTVAR < 0
+  // until the first sample); m_MinRTT is the windowed minimum driving the
+  // pacing rate, m_MaxWindowSize the configured congestion window cap
+  int m_WindowSize, m_RTT, m_RTTVAR, m_RTO, m_MinRTT, m_MaxWindowSize,
+      m_SSThresh;
+  std::uint64_t m_MinRTTSampleTime;
   std::uint64_t m_LastWindowSizeIncreaseTime;
   int m_NumResendAttempts;
   SendHandler m_SendHandler;
+  // negotiated FEC mode: m_FecConfigured mirrors the "streaming-fec"
+  // option (and is announced in our SYN); parity flows only once the peer
+  // announced support too and m_FecEnabled is set
+  bool m_FecConfigured, m_FecEnabled;
+  std::unique_ptr<FecGroup> m_FecSendGroup;
+  std::unique_ptr<FecGroup[]> m_FecRecvGroups;
 
   kovri::core::Exception m_Exception;
 };
@@ -354,10 +722,7 @@ class StreamingDestination {
 
   StreamingDestination(
       kovri::client::ClientDestination& owner,
-      std::uint16_t local_port = 0)
-      : m_Owner(owner),
-        m_LocalPort(local_port),
-        m_Exception(__func__) {}
+      std::uint16_t local_port = 0);
 
   ~StreamingDestination() {}
 
@@ -387,6 +752,20 @@ class StreamingDestination {
     return m_Acceptor != nullptr;
   }
 
+  /// @brief Routes new incoming streams without an acceptor to the
+  ///   pending-accept ring (drained by AcceptMany) instead of dropping
+  ///   them; call before Start from the consuming server loop
+  void EnableAcceptRing() {
+    m_AcceptRingEnabled = true;
+  }
+
+  /// @brief Delivers up to max pending incoming streams to acceptor in one
+  ///   call; lock-free against the destination thread (single consumer)
+  /// @return Number of streams delivered
+  std::size_t AcceptMany(
+      std::size_t max,
+      const Acceptor& acceptor);
+
   kovri::client::ClientDestination& GetOwner() {
     return m_Owner;
   }
@@ -400,6 +779,30 @@ class StreamingDestination {
     m_LocalPort = port;
   }
 
+  /// @brief Packet pool shared by this destination's streams
+  PacketPool& GetPacketPool() {
+    return m_PacketPool;
+  }
+
+  /// @brief Timing wheel shared by this destination's streams; all of
+  ///   their retransmit/ACK/pacing/receive timers are multiplexed onto it
+  kovri::core::TimerWheel& GetTimerWheel() {
+    return m_TimerWheel;
+  }
+
+  /// @brief Queues packetized stream data for aggregate paced emission:
+  ///   one pacer per destination interleaves the packets of all active
+  ///   streams round-robin at their summed rate, so concurrent responses
+  ///   trickle into the shared tunnels instead of bursting in phase
+  void PacePackets(
+      std::shared_ptr<Stream> stream,
+      const std::vector<Packet*>& packets);
+
+  /// @brief Drops whatever a terminating stream still has queued in the
+  ///   aggregate pacer (the stream's sent-packet list owns the packets)
+  void CancelPacedPackets(
+      const Stream* stream);
+
   void HandleDataMessagePayload(
       const std::uint8_t* buf,
       std::size_t len);
@@ -409,12 +812,50 @@ class StreamingDestination {
       Packet* packet);
   std::shared_ptr<Stream> CreateNewIncomingStream();
 
+  /// @brief Shard holding the streams whose receive stream ID hashes to it
+  struct StreamShard {
+    std::mutex mutex;
+    std::map<std::uint32_t, std::shared_ptr<Stream> > streams;
+  };
+
+  StreamShard& GetShard(
+      std::uint32_t receive_stream_ID) {
+    return m_Shards[receive_stream_ID & (STREAMING_DEMUX_SHARDS - 1)];
+  }
+
+  /// @brief Pushes a newly accepted stream onto the pending-accept ring
+  /// @return False when the ring is full (stream should be dropped)
+  bool PushPendingAccept(
+      std::shared_ptr<Stream> stream);
+
+  /// @brief Emits the head packet of the front claimant stream, rotates
+  ///   it to the back, and re-arms the pacer at the aggregate interval
+  void HandleAggregatePacingTimer();
+
+  /// @return Milliseconds between aggregate emissions: one packet per
+  ///   harmonic sum of the claimant streams' own pacing intervals, i.e.
+  ///   the sum of the rates their windows and RTTs (the tunnels'
+  ///   congestion feedback) currently allow
+  std::uint64_t AggregatePacingInterval() const;
+
  private:
   kovri::client::ClientDestination& m_Owner;
   std::uint16_t m_LocalPort;
-  std::mutex m_StreamsMutex;
-  std::map<std::uint32_t, std::shared_ptr<Stream> > m_Streams;
+  std::array<StreamShard, STREAMING_DEMUX_SHARDS> m_Shards;
   Acceptor m_Acceptor;
+  // SPSC ring of streams awaiting AcceptMany: the destination thread
+  // produces at m_AcceptTail, the server loop consumes at m_AcceptHead
+  std::array<std::shared_ptr<Stream>, STREAMING_ACCEPT_RING_SIZE> m_AcceptRing;
+  std::atomic<std::size_t> m_AcceptHead, m_AcceptTail;
+  std::atomic<bool> m_AcceptRingEnabled;
+  PacketPool m_PacketPool;
+  kovri::core::TimerWheel m_TimerWheel;
+  // round-robin pacing queue: the front stream emits one packet, then
+  // rotates to the back; entries hold the stream alive while it waits
+  std::deque<std::pair<std::shared_ptr<Stream>, std::deque<Packet*>>>
+      m_PacedStreams;
+  kovri::core::TimerWheel::Token m_PacerTimer;
+  bool m_IsPacing;
   kovri::core::Exception m_Exception;
 };
 
@@ -425,20 +866,21 @@ void Stream::AsyncReceive(
     const Buffer& buffer, ReceiveHandler handler, int timeout) {
   auto s = shared_from_this();
   m_Service.post([=](void) {
-    if (!m_ReceiveQueue.empty() || m_Status == eStreamStatusReset) {
+    if (!m_ReceiveQueue.IsEmpty() || m_Status == eStreamStatusReset) {
     s->HandleReceiveTimer(
         boost::asio::error::make_error_code(
           boost::asio::error::operation_aborted),
         buffer,
         handler);
       } else {
-      s->m_ReceiveTimer.expires_from_now(
-          boost::posix_time::seconds(
-            timeout));
-      s->m_ReceiveTimer.async_wait([=](
-            const boost::system::error_code& ecode) {
+      s->m_ReceiveTimer = s->m_LocalDestination.GetTimerWheel().Add(
+          static_cast<std::uint64_t>(timeout) * 1000,
+          [=](bool aborted) {
           s->HandleReceiveTimer(
-              ecode,
+              aborted
+                  ? boost::asio::error::make_error_code(
+                      boost::asio::error::operation_aborted)
+                  : boost::system::error_code(),
               buffer,
               handler); });
     }
@@ -469,6 +911,55 @@ void Stream::HandleReceiveTimer(
   }
 }
 
+template<typename SegmentHandler>
+void Stream::AsyncReceiveSegments(
+    std::size_t max_bytes, SegmentHandler handler, int timeout) {
+  auto s = shared_from_this();
+  m_Service.post([=](void) {
+    if (!m_ReceiveQueue.IsEmpty() || m_Status == eStreamStatusReset) {
+    s->HandleReceiveSegmentsTimer(
+        boost::asio::error::make_error_code(
+          boost::asio::error::operation_aborted),
+        max_bytes,
+        handler);
+      } else {
+      s->m_ReceiveTimer = s->m_LocalDestination.GetTimerWheel().Add(
+          static_cast<std::uint64_t>(timeout) * 1000,
+          [=](bool aborted) {
+          s->HandleReceiveSegmentsTimer(
+              aborted
+                  ? boost::asio::error::make_error_code(
+                      boost::asio::error::operation_aborted)
+                  : boost::system::error_code(),
+              max_bytes,
+              handler); });
+    }
+  });
+}
+
+template<typename SegmentHandler>
+void Stream::HandleReceiveSegmentsTimer(
+    const boost::system::error_code& ecode,
+    std::size_t max_bytes, SegmentHandler handler) {
+  std::vector<Packet*> segments;
+  ReceiveSegments(segments, max_bytes);
+  if (!segments.empty()) {
+    handler(boost::system::error_code(), std::move(segments));
+  } else if (ecode == boost::asio::error::operation_aborted) {
+    // timeout not expired
+    if (m_Status == eStreamStatusReset)
+      handler(boost::asio::error::make_error_code(
+            boost::asio::error::connection_reset), std::move(segments));
+    else
+      handler(boost::asio::error::make_error_code(
+            boost::asio::error::operation_aborted), std::move(segments));
+  } else {
+    // timeout expired
+    handler(boost::asio::error::make_error_code(
+          boost::asio::error::timed_out), std::move(segments));
+  }
+}
+
 }  // namespace client
 }  // namespace kovri
 
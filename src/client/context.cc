@@ -32,6 +32,8 @@
 
 #include "client/context.h"
 
+#include "client/executor.h"
+
 #include <fstream>
 #include <iostream>
 #include <set>
@@ -122,6 +124,7 @@ void ClientContext::Stop() {
     it.second->Stop();
   m_Destinations.clear();
   m_SharedLocalDestination = nullptr;
+  destination_executor.Stop();
 }
 
 void ClientContext::RequestShutdown() {
@@ -130,6 +133,13 @@ void ClientContext::RequestShutdown() {
     m_ShutdownHandler();
 }
 
+void ClientContext::RequestReload() {
+  if (m_ReloadHandler)
+    m_ReloadHandler();
+  else
+    LOG(warning) << "ClientContext: no reload handler registered";
+}
+
 kovri::core::PrivateKeys ClientContext::LoadPrivateKeys(
     const std::string& filename) {
   kovri::core::PrivateKeys keys;
@@ -225,7 +235,8 @@ void ClientContext::CreateDestTextFiles(
 
 std::shared_ptr<ClientDestination> ClientContext::LoadLocalDestination(
     const std::string& filename,
-    bool is_public) {
+    bool is_public,
+    std::int16_t hops) {
   auto keys = LoadPrivateKeys(filename);
   std::shared_ptr<ClientDestination> local_destination = nullptr;
   std::unique_lock<std::mutex> l(m_DestinationsMutex);
@@ -237,7 +248,15 @@ std::shared_ptr<ClientDestination> ClientContext::LoadLocalDestination(
       << " already exists";
     local_destination = it->second;
   } else {
-    local_destination = std::make_shared<ClientDestination>(keys, is_public);
+    // a configured length (notably 0 for zero-hop pools) overrides the
+    // I2CP default for both directions
+    std::map<std::string, std::string> params;
+    if (hops >= 0) {
+      params[I2CP_PARAM_INBOUND_TUNNEL_LENGTH] = std::to_string(hops);
+      params[I2CP_PARAM_OUTBOUND_TUNNEL_LENGTH] = std::to_string(hops);
+    }
+    local_destination = std::make_shared<ClientDestination>(
+        keys, is_public, hops >= 0 ? &params : nullptr);
     m_Destinations[local_destination->GetIdentHash()] = local_destination;
     local_destination->Start();
   }
@@ -421,7 +440,8 @@ bool ClientContext::AddServerTunnel(
     const TunnelAttributes& tunnel,
     bool is_http)
 {
-  auto local_destination = LoadLocalDestination(tunnel.keys, true);
+  auto local_destination =
+      LoadLocalDestination(tunnel.keys, true, tunnel.hops);
   auto server_tunnel =
       is_http ? std::make_unique<kovri::client::I2PServerTunnelHTTP>(
                     tunnel, local_destination)
@@ -444,7 +464,8 @@ bool ClientContext::AddClientTunnel(const TunnelAttributes& tunnel)
 {
   std::shared_ptr<kovri::client::ClientDestination> local_destination;
   if (!tunnel.keys.empty())
-    local_destination = LoadLocalDestination(tunnel.keys, false);
+    local_destination =
+        LoadLocalDestination(tunnel.keys, false, tunnel.hops);
   // Insert client tunnel
   auto client_tunnel = std::make_unique<kovri::client::I2PClientTunnel>(
       tunnel, local_destination);
@@ -461,6 +482,11 @@ void ClientContext::RegisterShutdownHandler(
   m_ShutdownHandler = handler;
 }
 
+void ClientContext::RegisterReloadHandler(
+    std::function<void(void)> handler) {
+  m_ReloadHandler = handler;
+}
+
 bool ClientContext::InsertClientTunnel(
     int port,
     std::unique_ptr<I2PClientTunnel> tunnel) {
@@ -68,6 +68,13 @@ class ClientContext {
    */
   void RequestShutdown();
 
+  /**
+   * Asks the owning instance to reload the tunnels configuration, diffing
+   *  against the running tunnel set instead of restarting the router.
+   * @note nothing happens if there is no registered reload handler
+   */
+  void RequestReload();
+
   std::shared_ptr<ClientDestination> GetSharedLocalDestination() const {
     return m_SharedLocalDestination;
   }
@@ -102,9 +109,12 @@ class ClientContext {
   kovri::core::PrivateKeys LoadPrivateKeys(
       const std::string& filename);
 
+  /// @param hops Tunnel length for the destination's pool; 0 builds
+  ///   zero-hop tunnels, negative keeps the I2CP default length
   std::shared_ptr<ClientDestination> LoadLocalDestination(
       const std::string& filename,
-      bool is_public);
+      bool is_public,
+      std::int16_t hops = -1);
 
   AddressBook& GetAddressBook() {
     return m_AddressBook;
@@ -153,6 +163,10 @@ class ClientContext {
   /// @param handler The handler to be called on shutdown
   void RegisterShutdownHandler(std::function<void(void)> handler);
 
+  /// @brief Registers a reload handler, called by ClientContext::RequestReload.
+  /// @param handler The handler to be called on tunnels config reload
+  void RegisterReloadHandler(std::function<void(void)> handler);
+
   /// @brief Inserts a client tunnel.
   /// @return true if the tunnel was inserted, false otherwise
   bool InsertClientTunnel(
@@ -231,6 +245,8 @@ class ClientContext {
 
   std::function<void(void)> m_ShutdownHandler;
 
+  std::function<void(void)> m_ReloadHandler;
+
   kovri::core::Exception m_Exception;
 };
 
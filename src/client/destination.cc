@@ -40,11 +40,15 @@
 #include <vector>
 
 #include "client/address_book/impl.h"
+#include "client/executor.h"
 
 #include "core/crypto/elgamal.h"
 #include "core/crypto/rand.h"
 
+#include "core/util/filesystem.h"
+#include "core/util/histogram.h"
 #include "core/util/log.h"
+#include "core/util/thread_registry.h"
 #include "core/util/timestamp.h"
 
 namespace kovri {
@@ -58,13 +62,27 @@ ClientDestination::ClientDestination(
     const std::map<std::string, std::string> * params)
     : m_IsRunning(false),
       m_Thread(nullptr),
-      m_Work(m_Service),
+      m_OwnService(
+          UseSharedExecutor(params)
+              ? nullptr
+              : std::make_unique<boost::asio::io_service>()),
+      m_Service(
+          m_OwnService
+              ? *m_OwnService
+              : destination_executor.AllocateService()),
+      m_Work(
+          m_OwnService
+              ? std::make_unique<boost::asio::io_service::work>(*m_OwnService)
+              : nullptr),
       m_Keys(keys),
       m_IsPublic(is_public),
       m_PublishReplyToken(0),
+      m_LeaseSetBatchPending(false),
       m_DatagramDestination(nullptr),
       m_PublishConfirmationTimer(m_Service),
       m_CleanupTimer(m_Service),
+      m_LeaseSetBatchTimer(m_Service),
+      m_LastLeaseSetCleanupTime(0),
       m_Exception(__func__) {
   // TODO(anonimal): this try block should be handled entirely by caller
   try {
@@ -74,13 +92,16 @@ ClientDestination::ClientDestination(
     int inbound_tunnel_len = DEFAULT_INBOUND_TUNNEL_LENGTH,
         outbound_tunnel_len = DEFAULT_OUTBOUND_TUNNEL_LENGTH,
         inbound_tunnels_quantity = DEFAULT_INBOUND_TUNNELS_QUANTITY,
-        outbound_tunnels_quantity = DEFAULT_OUTBOUND_TUNNELS_QUANTITY;
+        outbound_tunnels_quantity = DEFAULT_OUTBOUND_TUNNELS_QUANTITY,
+        target_latency = 0,
+        standby_tunnels_quantity = -1,
+        standby_lead_time = 0;
     std::shared_ptr<std::vector<kovri::core::IdentHash> > explicit_peers;
     if (params) {
       auto it = params->find(I2CP_PARAM_INBOUND_TUNNEL_LENGTH);
       if (it != params->end()) {
         int len = boost::lexical_cast<int>(it->second);
-        if (len > 0) {
+        if (len >= 0) {  // 0 = zero-hop (no anonymity)
           inbound_tunnel_len = len;
           LOG(debug) << "ClientDestination: inbound tunnel length set to " << len;
         }
@@ -88,7 +109,7 @@ ClientDestination::ClientDestination(
       it = params->find(I2CP_PARAM_OUTBOUND_TUNNEL_LENGTH);
       if (it != params->end()) {
         int len = boost::lexical_cast<int>(it->second);
-        if (len > 0) {
+        if (len >= 0) {  // 0 = zero-hop (no anonymity)
           outbound_tunnel_len = len;
           LOG(debug)
             << "ClientDestination: outbound tunnel length set to " << len;
@@ -124,6 +145,33 @@ ClientDestination::ClientDestination(
         }
         LOG(debug) << "ClientDestination: explicit peers set to " << it->second;
       }
+      it = params->find(I2CP_PARAM_TARGET_LATENCY);
+      if (it != params->end()) {
+        int latency = boost::lexical_cast<int>(it->second);
+        if (latency > 0) {
+          target_latency = latency;
+          LOG(debug)
+            << "ClientDestination: target tunnel latency set to " << latency;
+        }
+      }
+      it = params->find(I2CP_PARAM_STANDBY_TUNNELS_QUANTITY);
+      if (it != params->end()) {
+        int quantity = boost::lexical_cast<int>(it->second);
+        if (quantity >= 0) {
+          standby_tunnels_quantity = quantity;
+          LOG(debug)
+            << "ClientDestination: standby tunnels quantity set to " << quantity;
+        }
+      }
+      it = params->find(I2CP_PARAM_STANDBY_LEAD_TIME);
+      if (it != params->end()) {
+        int lead_time = boost::lexical_cast<int>(it->second);
+        if (lead_time > 0) {
+          standby_lead_time = lead_time;
+          LOG(debug)
+            << "ClientDestination: standby lead time set to " << lead_time;
+        }
+      }
     }
     m_Pool =
       kovri::core::tunnels.CreateTunnelPool(
@@ -134,6 +182,12 @@ ClientDestination::ClientDestination(
           outbound_tunnels_quantity);
     if (explicit_peers)
       m_Pool->SetExplicitPeers(explicit_peers);
+    if (target_latency)
+      m_Pool->SetTargetLatency(target_latency);
+    if (standby_tunnels_quantity >= 0)
+      m_Pool->SetStandbyTunnels(standby_tunnels_quantity);
+    if (standby_lead_time)
+      m_Pool->SetRecreationLeadTime(standby_lead_time);
     if (m_IsPublic)
       LOG(debug)
         << "ClientDestination: created local address "
@@ -156,9 +210,20 @@ ClientDestination::~ClientDestination() {
     delete it.second;
   if (m_DatagramDestination)
     delete m_DatagramDestination;
+  if (!m_OwnService)
+    destination_executor.ReleaseService(m_Service);
+}
+
+bool ClientDestination::UseSharedExecutor(
+    const std::map<std::string, std::string>* params) {
+  if (!params)
+    return false;
+  auto it = params->find(I2CP_PARAM_SHARED_EXECUTOR);
+  return it != params->end() && it->second == "true";
 }
 
 void ClientDestination::Run() {
+  kovri::core::thread_registry.Register("client-dest");
   while (m_IsRunning) {
     try {
       m_Service.run();
@@ -168,22 +233,32 @@ void ClientDestination::Run() {
   }
 }
 
+std::string ClientDestination::GetGarlicStatePath() const {
+  return (kovri::core::EnsurePath(
+              kovri::core::GetPath(kovri::core::Path::ClientKeys))
+          / (kovri::core::ToBase32Cached(GetIdentHash()) + ".garlic"))
+      .string();
+}
+
 void ClientDestination::Start() {
   if (!m_IsRunning) {
     m_IsRunning = true;
+    // a warm restart resumes tag-based garlic to known peers
+    LoadGarlicSessions(GetGarlicStatePath());
     m_Pool->SetLocalDestination(this);
     m_Pool->SetActive(true);
-    m_Thread =
-      std::make_unique<std::thread>(
-          std::bind(
-              &ClientDestination::Run,
-              this));
+    if (m_OwnService)
+      m_Thread =
+        std::make_unique<std::thread>(
+            std::bind(
+                &ClientDestination::Run,
+                this));
     m_StreamingDestination->Start();
     for (auto it : m_StreamingDestinationsByPorts)
       it.second->Start();
     m_CleanupTimer.expires_from_now(
-        boost::posix_time::minutes(
-            DESTINATION_CLEANUP_TIMEOUT));
+        boost::posix_time::seconds(
+            DESTINATION_SWEEP_INTERVAL));
     m_CleanupTimer.async_wait(
         std::bind(
             &ClientDestination::HandleCleanupTimer,
@@ -195,10 +270,19 @@ void ClientDestination::Start() {
 void ClientDestination::Stop() {
   if (m_IsRunning) {
     m_CleanupTimer.cancel();
+    m_PublishConfirmationTimer.cancel();
+    m_LeaseSetBatchTimer.cancel();
+    for (auto& it : m_LeaseSetRequests)
+      it.second->request_timeout_timer.cancel();
     m_IsRunning = false;
     m_StreamingDestination->Stop();
     for (auto it : m_StreamingDestinationsByPorts)
       it.second->Stop();
+    if (!m_OwnService)
+      // Pending handlers may reference the datagram destination and the
+      // pool; a dedicated thread discards them at stop, but the shared
+      // shard lives on, so flush them before tearing those down
+      destination_executor.Drain(m_Service);
     if (m_DatagramDestination) {
       auto d = m_DatagramDestination;
       m_DatagramDestination = nullptr;
@@ -208,11 +292,21 @@ void ClientDestination::Stop() {
       m_Pool->SetLocalDestination(nullptr);
       kovri::core::tunnels.DeleteTunnelPool(m_Pool);
     }
-    m_Service.stop();
-    if (m_Thread) {
-      m_Thread->join();
-      m_Thread.reset(nullptr);
+    // no new garlic arrives once the pool is detached; wait out any
+    // decrypts the shared workers still hold for us
+    kovri::core::garlic_workers.Drain();
+    if (m_OwnService) {
+      m_Service.stop();
+      if (m_Thread) {
+        m_Thread->join();
+        m_Thread.reset(nullptr);
+      }
+    } else {
+      destination_executor.Drain(m_Service);
     }
+    // everything quiesced: persist session keys and live tags so the
+    // next run skips re-establishment to these peers
+    SaveGarlicSessions(GetGarlicStatePath());
   }
 }
 
@@ -234,6 +328,20 @@ std::shared_ptr<const kovri::core::LeaseSet> ClientDestination::FindLeaseSet(
   return nullptr;
 }
 
+void ClientDestination::PrefetchLeaseSet(
+    const kovri::core::IdentHash& dest) {
+  if (!m_Pool || !IsReady())
+    return;
+  m_Service.post([this, dest] {
+      auto it = m_RemoteLeaseSets.find(dest);
+      if (it != m_RemoteLeaseSets.end() && it->second->HasNonExpiredLeases())
+        return;  // already warm
+      // RequestLeaseSet coalesces onto an in-flight lookup and respects
+      // the negative cache; a nullptr callback makes this fire-and-forget
+      RequestLeaseSet(dest, nullptr);
+    });
+}
+
 std::shared_ptr<const kovri::core::LeaseSet> ClientDestination::GetLeaseSet() {
   if (!m_Pool)
     return nullptr;
@@ -269,6 +377,15 @@ void ClientDestination::ProcessGarlicMessage(
           msg));
 }
 
+void ClientDestination::ProcessGarlicMessages(
+    std::vector<std::shared_ptr<kovri::core::I2NPMessage>> msgs) {
+  // one wakeup for the whole endpoint cycle
+  m_Service.post([this, batch = std::move(msgs)]() mutable {
+      for (auto& msg : batch)
+        HandleGarlicMessage(std::move(msg));
+    });
+}
+
 void ClientDestination::ProcessDeliveryStatusMessage(
     std::shared_ptr<kovri::core::I2NPMessage> msg) {
   m_Service.post(
@@ -363,9 +480,21 @@ void ClientDestination::HandleDatabaseStoreMessage(
   }
   auto it1 = m_LeaseSetRequests.find(buf + kovri::core::DATABASE_STORE_KEY_OFFSET);
   if (it1 != m_LeaseSetRequests.end()) {
+    // First response wins: parallel queries for the same key find no
+    // request here and fall through
+    if (lease_set) {
+      m_NegativeLeaseSetCache.erase(it1->first);
+      if (it1->second->start_time)
+        kovri::core::latency_histograms.Record(
+            kovri::core::LatencyHistograms::LeaseSetLookup,
+            kovri::core::GetMillisecondsSinceEpoch()
+                - it1->second->start_time);
+    } else {
+      m_NegativeLeaseSetCache[it1->first] =
+          kovri::core::GetSecondsSinceEpoch() + LEASESET_NEGATIVE_CACHE_TIMEOUT;
+    }
     it1->second->request_timeout_timer.cancel();
-    if (it1->second->request_complete)
-      it1->second->request_complete(lease_set);
+    it1->second->Complete(lease_set);
     delete it1->second;
     m_LeaseSetRequests.erase(it1);
   }
@@ -378,7 +507,7 @@ void ClientDestination::HandleDatabaseSearchReplyMessage(
   int num = buf[32];  // num
   LOG(debug)
     << "ClientDestination: DatabaseSearchReply for "
-    << key.ToBase64() << " num=" << num;
+    << kovri::core::ToBase64Cached(key) << " num=" << num;
   auto it = m_LeaseSetRequests.find(key);
   if (it != m_LeaseSetRequests.end()) {
     LeaseSetRequest* request = it->second;
@@ -390,7 +519,8 @@ void ClientDestination::HandleDatabaseSearchReplyMessage(
         if (floodfill) {
           LOG(debug)
             << "ClientDestination: requesting "
-            << key.ToBase64() << " at " << peer_hash.ToBase64();
+            << kovri::core::ToBase64Cached(key) << " at "
+            << kovri::core::ToBase64Cached(peer_hash);
           if (SendLeaseSetRequest(key, floodfill, request))
             found = true;
         } else {
@@ -403,18 +533,20 @@ void ClientDestination::HandleDatabaseSearchReplyMessage(
           << "ClientDestination: suggested floodfills are not found in NetDb";
     } else {
       LOG(debug)
-        << "ClientDestination: " << key.ToBase64() << " was not found on "
+        << "ClientDestination: " << kovri::core::ToBase64Cached(key) << " was not found on "
         << MAX_NUM_FLOODFILLS_PER_REQUEST << " floodfills";
     }
     if (!found) {
-      if (request->request_complete)
-        request->request_complete(nullptr);
+      m_NegativeLeaseSetCache[key] =
+          kovri::core::GetSecondsSinceEpoch() + LEASESET_NEGATIVE_CACHE_TIMEOUT;
+      request->Complete(nullptr);
       delete request;
       m_LeaseSetRequests.erase(key);
     }
   } else {
     LOG(warning)
-      << "ClientDestination: request for " << key.ToBase64() << " not found";
+      << "ClientDestination: request for "
+      << kovri::core::ToBase64Cached(key) << " not found";
   }
 }
 
@@ -433,11 +565,62 @@ void ClientDestination::HandleDeliveryStatusMessage(
 
 void ClientDestination::SetLeaseSetUpdated() {
   kovri::core::GarlicDestination::SetLeaseSetUpdated();
+  // A rotation wave updates several tunnels back to back; hold the window
+  // open and fold them into a single re-sign/publish when it closes
+  if (m_LeaseSetBatchPending)
+    return;
+  m_LeaseSetBatchPending = true;
+  m_LeaseSetBatchTimer.expires_from_now(
+      boost::posix_time::seconds(
+          LEASESET_PUBLISH_BATCH_WINDOW));
+  m_LeaseSetBatchTimer.async_wait(
+      std::bind(
+          &ClientDestination::HandleLeaseSetBatchTimer,
+          this,
+          std::placeholders::_1));
+}
+
+void ClientDestination::HandleLeaseSetBatchTimer(
+    const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted)
+    return;
+  m_LeaseSetBatchPending = false;
+  if (IsLeaseSetCurrent()) {
+    LOG(debug)
+      << "ClientDestination: lease content unchanged, publish suppressed";
+    return;
+  }
   UpdateLeaseSet();
   if (m_IsPublic)
     Publish();
 }
 
+bool ClientDestination::IsLeaseSetCurrent() const {
+  if (!m_Pool || !m_LeaseSet || !m_LeaseSet->IsValid())
+    return false;
+  auto tunnels = m_Pool->GetInboundTunnels(5);
+  const auto& leases = m_LeaseSet->GetLeases();
+  if (tunnels.empty() || tunnels.size() != leases.size())
+    return false;
+  auto ts = kovri::core::GetMillisecondsSinceEpoch();
+  for (auto tunnel : tunnels) {
+    bool found = false;
+    for (const auto& lease : leases) {
+      if (lease.tunnel_ID == tunnel->GetNextTunnelID() &&
+          lease.tunnel_gateway == tunnel->GetNextIdentHash()) {
+        // A rebuild would recompute the same end date modulo the random
+        // stagger, so the published lease only needs to remain alive
+        found =
+          lease.end_date > ts + kovri::core::TUNNEL_EXPIRATION_THRESHOLD * 1000;
+        break;
+      }
+    }
+    if (!found)
+      return false;
+  }
+  return true;
+}
+
 void ClientDestination::Publish() {
   if (!m_LeaseSet || !m_Pool) {
     LOG(error) << "ClientDestination: can't publish non-existing LeaseSet";
@@ -467,7 +650,8 @@ void ClientDestination::Publish() {
   }
   m_ExcludedFloodfills.insert(floodfill->GetIdentHash());
   LOG(debug)
-    << "ClientDestination: publish LeaseSet of " << GetIdentHash().ToBase32();
+    << "ClientDestination: publish LeaseSet of "
+    << kovri::core::ToBase32Cached(GetIdentHash());
   m_PublishReplyToken = kovri::core::Rand<std::uint32_t>();
   auto msg =
     WrapMessage(
@@ -533,6 +717,17 @@ void ClientDestination::HandleDataMessage(const std::uint8_t* buf, std::size_t)
       else
         LOG(warning) << "ClientDestination: missing streaming destination";
     break;
+    case PROTOCOL_TYPE_DATAGRAM_SESSION:
+      // session-mode datagram protocol
+      if (m_DatagramDestination)
+        m_DatagramDestination->HandleSessionDataMessagePayload(
+            source_port,
+            dest_port,
+            payload.data(),
+            payload.size());
+      else
+        LOG(warning) << "ClientDestination: missing datagram destination";
+    break;
     default:
       LOG(warning) << "ClientDestination: " << __func__
                    << ": unexpected protocol "
@@ -545,6 +740,7 @@ void ClientDestination::CreateStream(
     const kovri::core::IdentHash& dest,
     std::uint16_t port) {
   assert(stream_request_complete);
+  TouchDestination(dest);
   auto lease_set = FindLeaseSet(dest);
   if (lease_set) {
     stream_request_complete(
@@ -643,38 +839,58 @@ bool ClientDestination::RequestDestination(
 void ClientDestination::RequestLeaseSet(
     const kovri::core::IdentHash& dest,
     RequestComplete request_complete) {
-  std::set<kovri::core::IdentHash> excluded;
-  auto floodfill =
-    kovri::core::netdb.GetClosestFloodfill(
+  // Coalesce: attach to an already in-flight lookup for this destination
+  auto pending = m_LeaseSetRequests.find(dest);
+  if (pending != m_LeaseSetRequests.end()) {
+    LOG(debug)
+      << "ClientDestination: request of "
+      << kovri::core::ToBase64Cached(dest)
+      << " is pending, waiting on in-flight lookup";
+    pending->second->request_completes.push_back(request_complete);
+    return;
+  }
+  // Negative cache: recently unresolved destinations fail fast
+  auto negative = m_NegativeLeaseSetCache.find(dest);
+  if (negative != m_NegativeLeaseSetCache.end()) {
+    if (kovri::core::GetSecondsSinceEpoch() < negative->second) {
+      LOG(debug)
+        << "ClientDestination: "
+        << kovri::core::ToBase64Cached(dest) << " is negatively cached";
+      if (request_complete)
+        request_complete(nullptr);
+      return;
+    }
+    m_NegativeLeaseSetCache.erase(negative);
+  }
+  // Query the closest floodfills in parallel; the first response wins
+  auto floodfills =
+    kovri::core::netdb.GetClosestFloodfills(
         dest,
-        excluded);
-  if (floodfill) {
+        NUM_PARALLEL_LEASESET_REQUESTS);
+  if (!floodfills.empty()) {
     LeaseSetRequest* request = new LeaseSetRequest(m_Service);
-    request->request_complete = request_complete;
-    auto ret =
-      m_LeaseSetRequests.insert(
-          std::pair<kovri::core::IdentHash, LeaseSetRequest *>(
-            dest,
-            request));
-    if (ret.second) {  // inserted
-      if (!SendLeaseSetRequest(dest, floodfill, request)) {
-        // request failed
-        if (request->request_complete)
-          request->request_complete(nullptr);
-        delete request;
-        m_LeaseSetRequests.erase(dest);
-      }
-    } else {  // duplicate
-      LOG(error)
-        << "ClientDestination: request of "
-        << dest.ToBase64() << " is pending already";
-      // TODO(unassigned): queue up requests
-      if (request->request_complete)
-        request->request_complete(nullptr);
+    request->start_time = kovri::core::GetMillisecondsSinceEpoch();
+    request->request_completes.push_back(request_complete);
+    m_LeaseSetRequests.insert(
+        std::pair<kovri::core::IdentHash, LeaseSetRequest *>(
+          dest,
+          request));
+    bool sent = false;
+    for (const auto& peer_hash : floodfills) {
+      auto floodfill = kovri::core::netdb.FindRouter(peer_hash);
+      if (floodfill && SendLeaseSetRequest(dest, floodfill, request))
+        sent = true;
+    }
+    if (!sent) {
+      // request failed
+      request->Complete(nullptr);
       delete request;
+      m_LeaseSetRequests.erase(dest);
     }
   } else {
     LOG(error) << "ClientDestination: no floodfills found";
+    if (request_complete)
+      request_complete(nullptr);
   }
 }
 
@@ -710,7 +926,7 @@ bool ClientDestination::SendLeaseSetRequest(
             kovri::core::e_DeliveryTypeRouter,
             next_floodfill->GetIdentHash(),
             0,
-            msg
+            std::move(msg)
         }
     });
     request->request_timeout_timer.expires_from_now(
@@ -748,13 +964,14 @@ void ClientDestination::HandleRequestTimoutTimer(
       } else {
         LOG(debug)
           << "ClientDestination: "
-          << dest.ToBase64() << " was not found within "
+          << kovri::core::ToBase64Cached(dest) << " was not found within "
           << MAX_LEASESET_REQUEST_TIMEOUT << " seconds";
         done = true;
       }
       if (done) {
-        if (it->second->request_complete)
-          it->second->request_complete(nullptr);
+        m_NegativeLeaseSetCache[dest] =
+            ts + LEASESET_NEGATIVE_CACHE_TIMEOUT;
+        it->second->Complete(nullptr);
         delete it->second;
         m_LeaseSetRequests.erase(it);
       }
@@ -765,11 +982,18 @@ void ClientDestination::HandleRequestTimoutTimer(
 void ClientDestination::HandleCleanupTimer(
     const boost::system::error_code& ecode) {
   if (ecode != boost::asio::error::operation_aborted) {
-    CleanupRoutingSessions();
-    CleanupRemoteLeaseSets();
+    // Bounded garlic sweep every tick; the full LeaseSet cleanup keeps
+    // its original cadence
+    SweepExpiredTags();
+    RefreshHotLeaseSets();
+    std::uint64_t const ts = kovri::core::GetSecondsSinceEpoch();
+    if (ts - m_LastLeaseSetCleanupTime >= DESTINATION_CLEANUP_TIMEOUT * 60) {
+      m_LastLeaseSetCleanupTime = ts;
+      CleanupRemoteLeaseSets();
+    }
     m_CleanupTimer.expires_from_now(
-        boost::posix_time::minutes(
-            DESTINATION_CLEANUP_TIMEOUT));
+        boost::posix_time::seconds(
+            DESTINATION_SWEEP_INTERVAL));
     m_CleanupTimer.async_wait(
         std::bind(
             &ClientDestination::HandleCleanupTimer,
@@ -778,17 +1002,62 @@ void ClientDestination::HandleCleanupTimer(
   }
 }
 
+void ClientDestination::TouchDestination(
+    const kovri::core::IdentHash& dest) {
+  auto& usage = m_DestinationUsage[dest];
+  usage.use_count++;
+  usage.last_use = kovri::core::GetSecondsSinceEpoch();
+}
+
+void ClientDestination::RefreshHotLeaseSets() {
+  if (!m_Pool || !IsReady())
+    return;
+  std::uint64_t const now = kovri::core::GetSecondsSinceEpoch();
+  for (auto it = m_DestinationUsage.begin();
+       it != m_DestinationUsage.end();) {
+    if (now - it->second.last_use > LEASESET_USAGE_WINDOW * 60) {
+      // went cold: the normal lookup path pays again on the next use
+      it = m_DestinationUsage.erase(it);
+      continue;
+    }
+    if (it->second.use_count >= LEASESET_REFRESH_MIN_USES &&
+        !m_LeaseSetRequests.count(it->first)) {
+      auto ls = m_RemoteLeaseSets.find(it->first);
+      // expired out of the cache, or the last lease runs out within the
+      // lead time: refresh now so streams keep finding a live LeaseSet
+      if (ls == m_RemoteLeaseSets.end() ||
+          ls->second->GetLatestLeaseEndDate() <
+              (now + LEASESET_REFRESH_LEAD_TIME) * 1000) {
+        LOG(debug)
+          << "ClientDestination: proactively refreshing LeaseSet of "
+          << kovri::core::ToBase64Cached(it->first);
+        RequestLeaseSet(it->first, nullptr);
+      }
+    }
+    it++;
+  }
+}
+
 void ClientDestination::CleanupRemoteLeaseSets() {
   for (auto it = m_RemoteLeaseSets.begin(); it != m_RemoteLeaseSets.end();) {
     if (!it->second->HasNonExpiredLeases()) {  // all leases expired
       LOG(debug)
         << "ClientDestination: remote LeaseSet "
-        << it->second->GetIdentHash().ToBase64() << " expired";
+        << kovri::core::ToBase64Cached(it->second->GetIdentHash()) << " expired";
       it = m_RemoteLeaseSets.erase(it);
     } else {
       it++;
     }
   }
+  // Drop expired negative cache entries
+  std::uint64_t ts = kovri::core::GetSecondsSinceEpoch();
+  for (auto it = m_NegativeLeaseSetCache.begin();
+       it != m_NegativeLeaseSetCache.end();) {
+    if (ts >= it->second)
+      it = m_NegativeLeaseSetCache.erase(it);
+    else
+      it++;
+  }
 }
 
 }  // namespace client
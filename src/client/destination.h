@@ -43,6 +43,7 @@
 #include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "client/api/datagram.h"
 #include "client/api/streaming.h"
@@ -61,11 +62,27 @@ namespace client {
 const std::uint8_t PROTOCOL_TYPE_STREAMING = 6;
 const std::uint8_t PROTOCOL_TYPE_DATAGRAM = 17;
 const std::uint8_t PROTOCOL_TYPE_RAW = 18;
+// Kovri extension: datagrams authenticated per-session instead of per-packet
+const std::uint8_t PROTOCOL_TYPE_DATAGRAM_SESSION = 19;
 const int PUBLISH_CONFIRMATION_TIMEOUT = 5;  // in seconds
+/// @brief Window over which lease changes are batched so one rotation
+///   wave costs one re-sign/publish, in seconds
+const int LEASESET_PUBLISH_BATCH_WINDOW = 2;
 const int LEASESET_REQUEST_TIMEOUT = 5;  // in seconds
 const int MAX_LEASESET_REQUEST_TIMEOUT = 40;  // in seconds
 const int MAX_NUM_FLOODFILLS_PER_REQUEST = 7;
+const int NUM_PARALLEL_LEASESET_REQUESTS = 3;  // closest floodfills queried at once
+const int LEASESET_NEGATIVE_CACHE_TIMEOUT = 60;  // in seconds
+/// @brief Outgoing streams within the usage window that make a remote
+///   destination hot enough for proactive LeaseSet refresh
+const std::size_t LEASESET_REFRESH_MIN_USES = 3;
+/// @brief Refresh a hot destination's LeaseSet once its last lease is due
+///   to expire within this many seconds
+const int LEASESET_REFRESH_LEAD_TIME = 60;
+/// @brief A destination unused for this long goes cold again, in minutes
+const int LEASESET_USAGE_WINDOW = 10;
 const int DESTINATION_CLEANUP_TIMEOUT = 20;  // in minutes
+const int DESTINATION_SWEEP_INTERVAL = 30;  // in seconds; incremental garlic tag sweep
 
 // I2CP
 const char I2CP_PARAM_INBOUND_TUNNEL_LENGTH[] = "inbound.length";
@@ -77,6 +94,10 @@ const int DEFAULT_INBOUND_TUNNELS_QUANTITY = 5;
 const char I2CP_PARAM_OUTBOUND_TUNNELS_QUANTITY[] = "outbound.quantity";
 const int DEFAULT_OUTBOUND_TUNNELS_QUANTITY = 5;
 const char I2CP_PARAM_EXPLICIT_PEERS[] = "explicitPeers";
+const char I2CP_PARAM_TARGET_LATENCY[] = "latency";  // in milliseconds
+const char I2CP_PARAM_STANDBY_TUNNELS_QUANTITY[] = "standby.quantity";
+const char I2CP_PARAM_STANDBY_LEAD_TIME[] = "standby.leadtime";  // in seconds
+const char I2CP_PARAM_SHARED_EXECUTOR[] = "executor.shared";  // run on the shared executor instead of a dedicated thread
 const int STREAM_REQUEST_TIMEOUT = 60;  // in seconds
 
 typedef std::function<void (std::shared_ptr<kovri::client::Stream> stream)> StreamRequestComplete;
@@ -91,8 +112,26 @@ class ClientDestination : public kovri::core::GarlicDestination {
           request_timeout_timer(service) {}
     std::set<kovri::core::IdentHash> excluded;
     std::uint64_t request_time;
+    // when the lookup started (in milliseconds), for the latency
+    // histogram; request_time above is per-floodfill and second-resolution
+    std::uint64_t start_time = 0;
     boost::asio::deadline_timer request_timeout_timer;
-    RequestComplete request_complete;
+    // All waiters coalesced onto this in-flight lookup
+    std::vector<RequestComplete> request_completes;
+    // Fans the result out to every coalesced waiter
+    void Complete(std::shared_ptr<kovri::core::LeaseSet> lease_set) {
+      for (auto& request_complete : request_completes)
+        if (request_complete)
+          request_complete(lease_set);
+      request_completes.clear();
+    }
+  };
+
+  // Recent outgoing-stream usage of a remote destination; drives the
+  // proactive LeaseSet refresh (see RefreshHotLeaseSets)
+  struct DestinationUsage {
+    std::size_t use_count = 0;
+    std::uint64_t last_use = 0;  // seconds since epoch
   };
 
  public:
@@ -115,6 +154,12 @@ class ClientDestination : public kovri::core::GarlicDestination {
     return m_Service;
   }
 
+  /// @brief Offloaded tag-miss garlic decrypts re-inject their cloves
+  ///   through our service thread
+  boost::asio::io_service* GetGarlicDispatchService() {
+    return &m_Service;
+  }
+
   std::shared_ptr<kovri::core::TunnelPool> GetTunnelPool() {
     return m_Pool;
   }
@@ -128,6 +173,14 @@ class ClientDestination : public kovri::core::GarlicDestination {
   std::shared_ptr<const kovri::core::LeaseSet> FindLeaseSet(
       const kovri::core::IdentHash& ident);
 
+  /// @brief Starts resolving a destination's LeaseSet in the background
+  ///   unless a non-expired one is already cached
+  /// @notes Called on address-book hits so the stream that follows (or
+  ///   the next one, when a pooled stream short-circuits creation) does
+  ///   not block on a floodfill lookup
+  void PrefetchLeaseSet(
+      const kovri::core::IdentHash& dest);
+
   bool RequestDestination(
       const kovri::core::IdentHash& dest,
       RequestComplete request_complete = nullptr);
@@ -196,6 +249,9 @@ class ClientDestination : public kovri::core::GarlicDestination {
   void ProcessGarlicMessage(
       std::shared_ptr<kovri::core::I2NPMessage> msg);
 
+  void ProcessGarlicMessages(
+      std::vector<std::shared_ptr<kovri::core::I2NPMessage>> msgs);
+
   void ProcessDeliveryStatusMessage(
       std::shared_ptr<kovri::core::I2NPMessage> msg);
 
@@ -209,8 +265,20 @@ class ClientDestination : public kovri::core::GarlicDestination {
  private:
   void Run();
 
+  /// @brief File the persisted garlic session state lives in, next to
+  ///   this destination's keys
+  std::string GetGarlicStatePath() const;
+
   void UpdateLeaseSet();
 
+  /// @brief Whether the published LeaseSet still matches what a rebuild
+  ///   from the pool would produce (same gateways and tunnel IDs, every
+  ///   lease comfortably alive); true means re-sign/publish can be skipped
+  bool IsLeaseSetCurrent() const;
+
+  void HandleLeaseSetBatchTimer(
+      const boost::system::error_code& ecode);
+
   void Publish();
 
   void HandlePublishConfirmationTimer(
@@ -245,11 +313,27 @@ class ClientDestination : public kovri::core::GarlicDestination {
 
   void CleanupRemoteLeaseSets();
 
+  // Records an outgoing stream to dest for refresh bookkeeping
+  void TouchDestination(
+      const kovri::core::IdentHash& dest);
+
+  /// @brief Re-requests the LeaseSets of hot destinations shortly before
+  ///   their last lease expires, so regular peers never pay a blocking
+  ///   floodfill lookup; destinations idle past the usage window are
+  ///   forgotten
+  void RefreshHotLeaseSets();
+
+  /// @brief Whether params select the shared executor (see DestinationExecutor)
+  static bool UseSharedExecutor(
+      const std::map<std::string, std::string>* params);
+
  private:
   volatile bool m_IsRunning;
   std::unique_ptr<std::thread> m_Thread;
-  boost::asio::io_service m_Service;
-  boost::asio::io_service::work m_Work;
+  // Owned in dedicated-thread mode; null when riding the shared executor
+  std::unique_ptr<boost::asio::io_service> m_OwnService;
+  boost::asio::io_service& m_Service;
+  std::unique_ptr<boost::asio::io_service::work> m_Work;
 
   kovri::core::PrivateKeys m_Keys;
   std::uint8_t m_EncryptionPublicKey[256], m_EncryptionPrivateKey[256];
@@ -260,12 +344,22 @@ class ClientDestination : public kovri::core::GarlicDestination {
   std::map<kovri::core::IdentHash,
            LeaseSetRequest *> m_LeaseSetRequests;
 
+  // Recently unresolved destinations -> expiration (seconds since epoch);
+  // lookups fail fast instead of re-querying dead hosts
+  std::map<kovri::core::IdentHash, std::uint64_t> m_NegativeLeaseSetCache;
+
+  // Usage frequency per remote destination (see RefreshHotLeaseSets)
+  std::map<kovri::core::IdentHash, DestinationUsage> m_DestinationUsage;
+
   std::shared_ptr<kovri::core::TunnelPool> m_Pool;
   std::shared_ptr<kovri::core::LeaseSet> m_LeaseSet;
 
   bool m_IsPublic;
 
   std::uint32_t m_PublishReplyToken;
+
+  // a lease-set batch window is open: further tunnel changes fold into it
+  bool m_LeaseSetBatchPending;
   std::set<kovri::core::IdentHash> m_ExcludedFloodfills;  // for publishing
 
   std::shared_ptr<kovri::client::StreamingDestination> m_StreamingDestination;  // default
@@ -275,7 +369,11 @@ class ClientDestination : public kovri::core::GarlicDestination {
 
   DatagramDestination* m_DatagramDestination;
 
-  boost::asio::deadline_timer m_PublishConfirmationTimer, m_CleanupTimer;
+  boost::asio::deadline_timer m_PublishConfirmationTimer, m_CleanupTimer,
+      m_LeaseSetBatchTimer;
+  // last full remote LeaseSet cleanup (seconds since epoch); the cleanup
+  // timer itself ticks at the shorter garlic sweep interval
+  std::uint64_t m_LastLeaseSetCleanupTime;
 
   kovri::core::Exception m_Exception;
 };
@@ -0,0 +1,131 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "client/executor.h"
+
+#include <functional>
+#include <future>
+#include <utility>
+
+#include "core/util/log.h"
+#include "core/util/thread_registry.h"
+
+namespace kovri {
+namespace client {
+
+// Simply instantiating in namespace scope ties into, and is limited by, the current singleton design
+DestinationExecutor destination_executor;
+
+DestinationExecutor::DestinationExecutor()
+    : m_IsRunning(false) {}
+
+DestinationExecutor::~DestinationExecutor() {
+  Stop();
+}
+
+void DestinationExecutor::Start(
+    std::size_t num_shards) {
+  if (m_IsRunning)
+    return;
+  if (!num_shards)
+    num_shards = EXECUTOR_NUM_SHARDS;
+  LOG(debug) << "DestinationExecutor: starting " << num_shards << " shards";
+  m_IsRunning = true;
+  for (std::size_t i = 0; i < num_shards; i++) {
+    auto shard = std::make_unique<Shard>();
+    shard->thread =
+      std::make_unique<std::thread>(
+          std::bind(
+              &DestinationExecutor::Run,
+              this,
+              shard.get()));
+    m_Shards.push_back(std::move(shard));
+  }
+}
+
+void DestinationExecutor::Stop() {
+  if (!m_IsRunning)
+    return;
+  m_IsRunning = false;
+  for (auto& shard : m_Shards) {
+    shard->service.stop();
+    if (shard->thread) {
+      shard->thread->join();
+      shard->thread.reset(nullptr);
+    }
+  }
+  m_Shards.clear();
+}
+
+void DestinationExecutor::Run(Shard* shard) {
+  kovri::core::thread_registry.Register("dest-executor");
+  while (m_IsRunning) {
+    try {
+      shard->service.run();
+    } catch (const std::exception& ex) {
+      LOG(error) << "DestinationExecutor::Run() exception: " << ex.what();
+    }
+  }
+}
+
+boost::asio::io_service& DestinationExecutor::AllocateService() {
+  if (!m_IsRunning)
+    Start();
+  std::unique_lock<std::mutex> l(m_ShardsMutex);
+  Shard* best = nullptr;
+  for (auto& shard : m_Shards)
+    if (!best || shard->num_destinations < best->num_destinations)
+      best = shard.get();
+  best->num_destinations++;
+  return best->service;
+}
+
+void DestinationExecutor::ReleaseService(
+    boost::asio::io_service& service) {
+  std::unique_lock<std::mutex> l(m_ShardsMutex);
+  for (auto& shard : m_Shards)
+    if (&shard->service == &service) {
+      if (shard->num_destinations)
+        shard->num_destinations--;
+      return;
+    }
+}
+
+void DestinationExecutor::Drain(
+    boost::asio::io_service& service) {
+  if (!m_IsRunning)
+    return;
+  std::promise<void> barrier;
+  service.post([&barrier] { barrier.set_value(); });
+  barrier.get_future().wait();
+}
+
+}  // namespace client
+}  // namespace kovri
@@ -0,0 +1,111 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CLIENT_EXECUTOR_H_
+#define SRC_CLIENT_EXECUTOR_H_
+
+#include <boost/asio.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kovri {
+namespace client {
+
+/// @brief Shard threads serving all shared-executor destinations
+const std::size_t EXECUTOR_NUM_SHARDS = 4;
+
+/// @class DestinationExecutor
+/// @brief Shared pool of io_service shards for client destinations
+/// @details Destinations opting in (see the "executor.shared" I2CP
+///   parameter) are assigned the least-loaded shard instead of spawning a
+///   dedicated thread. Each shard runs on exactly one pool thread, so the
+///   single-threaded handler execution destinations rely on is preserved
+///   while idle destinations cost no thread of their own
+class DestinationExecutor {
+ public:
+  DestinationExecutor();
+
+  ~DestinationExecutor();
+
+  /// @brief Spawns the shard threads; called lazily by AllocateService
+  void Start(
+      std::size_t num_shards = EXECUTOR_NUM_SHARDS);
+
+  /// @brief Stops all shards and joins their threads
+  void Stop();
+
+  bool IsRunning() const {
+    return m_IsRunning;
+  }
+
+  /// @brief Assigns the least-loaded shard to a new destination,
+  ///   starting the executor on first use
+  /// @return The assigned shard's io_service
+  boost::asio::io_service& AllocateService();
+
+  /// @brief Returns a destination's shard assignment to the pool
+  void ReleaseService(
+      boost::asio::io_service& service);
+
+  /// @brief Runs a barrier task through the shard and waits for it,
+  ///   guaranteeing all previously queued handlers have completed
+  /// @notes Must not be called from a shard thread
+  void Drain(
+      boost::asio::io_service& service);
+
+ private:
+  struct Shard {
+    Shard()
+        : work(service),
+          num_destinations(0) {}
+    boost::asio::io_service service;
+    boost::asio::io_service::work work;
+    std::unique_ptr<std::thread> thread;
+    std::size_t num_destinations;
+  };
+
+  void Run(Shard* shard);
+
+ private:
+  volatile bool m_IsRunning;
+  std::mutex m_ShardsMutex;
+  std::vector<std::unique_ptr<Shard>> m_Shards;
+};
+
+extern DestinationExecutor destination_executor;
+
+}  // namespace client
+}  // namespace kovri
+
+#endif  // SRC_CLIENT_EXECUTOR_H_
@@ -79,6 +79,11 @@ void Instance::Initialize()
   /*context.RegisterShutdownHandler(
     [this]() { m_IsRunning = false; });*/
 
+  // Tunnels config reload: I2PControl requests land here, on the same
+  // diff path SIGHUP takes through the daemon (only changed tunnels are
+  // restarted; warmed destinations with unchanged keys are reused)
+  context.RegisterReloadHandler([this]() { Reload(); });
+
   // Initialize proxies
   std::shared_ptr<ClientDestination> local_destination;
   auto const& map = m_Config.GetCoreConfig().GetMap();
@@ -254,7 +259,8 @@ void Instance::Stop()
 void Instance::Reload()
 {
   LOG(info) << "Instance: reloading client";
-  // TODO(unassigned): locking etc.
+  // Reload may come from the signal path or from I2PControl concurrently
+  std::lock_guard<std::mutex> lock(m_ReloadMutex);
   // TODO(unassigned): core instance
   m_IsReloading = true;
   m_Config.ParseConfig();
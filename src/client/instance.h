@@ -31,6 +31,7 @@
 #ifndef SRC_CLIENT_INSTANCE_H_
 #define SRC_CLIENT_INSTANCE_H_
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -106,6 +107,9 @@ class Instance
   /// @brief Is client configuration in the process of reloading?
   /// TODO(unassigned): expand types of reloading
   bool m_IsReloading;
+
+  /// @brief Serializes reload requests (SIGHUP vs. I2PControl)
+  std::mutex m_ReloadMutex;
 };
 
 }  // namespace client
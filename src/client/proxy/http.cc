@@ -34,13 +34,10 @@
 
 #include <atomic>
 #include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/regex.hpp>
 
 
 #include <boost/network/uri/decode.hpp>
 #include <boost/lexical_cast.hpp>
-#include <boost/regex.hpp>
-#include <boost/tokenizer.hpp>
 #include <cassert>
 #include <cstring>
 #include <map>
@@ -154,7 +151,7 @@ HTTPProxyServer::HTTPProxyServer(
 std::shared_ptr<kovri::client::I2PServiceHandler>
 HTTPProxyServer::CreateHandler(
     std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
-  return std::make_shared<HTTPProxyHandler>(this, socket);
+  return AcquireHandler<HTTPProxyHandler>(this, socket);
 }
 
 void HTTPProxyHandler::Handle() {
@@ -318,47 +315,49 @@ void HTTPProxyHandler::HandleSockRecv(
 }
 
 bool HTTPMessage::HandleData(const std::string& protocol_string) {
-  std::vector<std::string> header_body;
-  std::vector<std::string> tokens_header_body;
-  // get header info
+  // Single pass over the receive buffer: the request line and each
+  // header are sliced in place, with no regex work and no per-header
+  // re-splitting. Bytes past the blank line (pipelined or body data)
+  // are left for the caller to forward unchanged
   // initially set error response to bad_request
   m_ErrorResponse.set(HTTPResponse::bad_request);
-  if (boost::algorithm::split_regex(
-          header_body, protocol_string, boost::regex("\r\n\r\n")).size()
-      != HEADERBODY_LEN)
+  std::size_t const header_end = protocol_string.find("\r\n\r\n");
+  if (header_end == std::string::npos)
     return false;
-  if (boost::algorithm::split_regex(tokens_header_body, header_body[0],
-        boost::regex("\r\n"))
-          .size()
-      < REQUESTLINE_HEADERS_MIN)
+  // request line: exactly method SP url SP version
+  std::size_t const line_end =
+      std::min(protocol_string.find("\r\n"), header_end);
+  m_RequestLine = protocol_string.substr(0, line_end);
+  std::size_t const first_sep = m_RequestLine.find_first_of(" \t");
+  if (first_sep == std::string::npos)
     return false;
-  m_RequestLine = tokens_header_body[0];
-  // requestline
-  std::vector<std::string> tokens_request;
-  boost::split(tokens_request, m_RequestLine, boost::is_any_of(" \t"));
-  if (tokens_request.size() == 3) {
-    m_Method = tokens_request[0];
-    m_URL = tokens_request[1];
-    m_Version = tokens_request[2];
-  } else {
+  std::size_t const second_sep =
+      m_RequestLine.find_first_of(" \t", first_sep + 1);
+  if (second_sep == std::string::npos
+      || m_RequestLine.find_first_of(" \t", second_sep + 1)
+         != std::string::npos)
     return false;
+  m_Method = m_RequestLine.substr(0, first_sep);
+  m_URL = m_RequestLine.substr(first_sep + 1, second_sep - first_sep - 1);
+  m_Version = m_RequestLine.substr(second_sep + 1);
+  // header lines: key up to the first colon, value the rest verbatim
+  m_Headers.clear();
+  m_HeaderMap.clear();
+  std::size_t pos = line_end == header_end ? header_end : line_end + 2;
+  while (pos < header_end) {
+    std::size_t eol = protocol_string.find("\r\n", pos);
+    if (eol > header_end)
+      eol = header_end;
+    m_Headers.push_back(protocol_string.substr(pos, eol - pos));
+    const std::string& line = m_Headers.back();
+    std::size_t const colon = line.find(':');
+    if (colon == std::string::npos)
+      m_HeaderMap.push_back(std::make_pair(line, std::string()));
+    else
+      m_HeaderMap.push_back(
+          std::make_pair(line.substr(0, colon), line.substr(colon + 1)));
+    pos = eol + 2;
   }
-  // headersline
-  m_Headers = tokens_header_body;
-  // remove start line
-  m_Headers.erase(m_Headers.begin());
-  std::vector<std::pair<std::string, std::string>> headers;
-  for (auto it = m_Headers.begin(); it != m_Headers.end(); it++) {
-    std::vector<std::string> keyElement;
-    boost::split(keyElement, *it, boost::is_any_of(":"));
-    std::string key = keyElement[0];
-    keyElement.erase(keyElement.begin());
-    std::string value = boost::algorithm::join(keyElement, ":");
-    // concatenate remaining : values ie times
-    headers.push_back(std::pair<std::string, std::string>(key, value));
-  }
-
-  m_HeaderMap = headers;
   // reset error response to ok
   m_ErrorResponse.set(HTTPResponse::ok);
   return true;
@@ -371,10 +370,12 @@ void HTTPProxyHandler::HandleStreamRequestComplete(
       return;
     LOG(info) << "HTTPProxyHandler: new I2PTunnel connection";
     auto connection =
-      std::make_shared<kovri::client::I2PTunnelConnection>(
+      GetOwner()->AcquireHandler<kovri::client::I2PTunnelConnection>(
           GetOwner(),
           m_Socket,
-          stream);
+          stream,
+          true,  // park the stream for reuse on teardown
+          m_Protocol.m_Port);
     GetOwner()->AddHandler(connection);
     connection->I2PConnect(
         reinterpret_cast<const std::uint8_t*>(m_Protocol.m_Request.c_str()),
@@ -473,17 +474,26 @@ bool HTTPMessage::ExtractIncomingRequest() {
   LOG(debug)
     << "HTTPProxyHandler: method is: " << m_Method
     << " request is: " << m_URL;
-  //  Set defaults and regexp
+  //  Set defaults
   std::string server = "", port = "80";
-  boost::regex regex("http://(.*?)(:(\\d+))?(/.*)");
-  boost::smatch smatch;
   std::string path;
-  // Ensure path is legitimate
-  if (boost::regex_search(m_URL, smatch, regex, boost::match_extra)) {
-    server = smatch[1].str();
-    if (smatch[2].str() != "")
-      port = smatch[3].str();
-    path = smatch[4].str();
+  // Ensure path is legitimate: http://host[:port]/path
+  const char scheme[] = "http://";
+  std::size_t const scheme_len = sizeof(scheme) - 1;
+  if (m_URL.compare(0, scheme_len, scheme) == 0) {
+    std::size_t const path_begin = m_URL.find('/', scheme_len);
+    if (path_begin != std::string::npos) {
+      server = m_URL.substr(scheme_len, path_begin - scheme_len);
+      path = m_URL.substr(path_begin);
+      // a trailing :digits in the authority is the port
+      std::size_t const colon = server.rfind(':');
+      if (colon != std::string::npos && colon + 1 < server.size()
+          && server.find_first_not_of("0123456789", colon + 1)
+             == std::string::npos) {
+        port = server.substr(colon + 1);
+        server.erase(colon);
+      }
+    }
   }
   LOG(debug)
     << "HTTPProxyHandler: server is: " << server
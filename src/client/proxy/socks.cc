@@ -35,7 +35,9 @@
 #include <atomic>
 #include <cassert>
 #include <cstring>
+#include <vector>
 
+#include "client/api/datagram.h"
 #include "client/api/streaming.h"
 #include "client/context.h"
 #include "client/destination.h"
@@ -61,7 +63,8 @@ SOCKSHandler::SOCKSHandler(
         m_AuthChosen(Invalid),
         m_AddressType(IPv4),
         m_SOCKSVersion(SOCKS5),
-        m_Command(Connect) {
+        m_Command(Connect),
+        m_UDPLocalPort(0) {
           m_Address.ip = 0;
           EnterState(GetSOCKSVersion);
         }
@@ -94,6 +97,14 @@ void SOCKSHandler::AsyncSocketRead() {
 
 void SOCKSHandler::Terminate() {
   if (Kill()) return;
+  if (m_UDPRelaySocket) {
+    LOG(debug) << "SOCKSHandler: close UDP relay";
+    auto datagram = GetOwner()->GetLocalDestination()->GetDatagramDestination();
+    if (datagram)
+      datagram->ResetReceiver(m_UDPLocalPort);
+    m_UDPRelaySocket->close();
+    m_UDPRelaySocket.reset();
+  }
   if (m_Socket) {
     LOG(debug) << "SOCKSHandler: close socket";
     m_Socket->close();
@@ -280,6 +291,11 @@ void SOCKSHandler::EnterState(
 }
 
 bool SOCKSHandler::ValidateSOCKSRequest() {
+  if (m_Command == UDP) {
+    // DST.ADDR only hints where the client will send datagrams from;
+    // the actual targets arrive per encapsulated datagram
+    return true;
+  }
   if (m_Command != Connect) {
     // TODO(unassigned): we need to support binds and other features!
     LOG(error) << "SOCKSHandler: unsupported command: " << m_Command;
@@ -502,8 +518,18 @@ void SOCKSHandler::HandleSocketReceive(
     Terminate();
     return;
   }
+  if (m_State == Complete && m_Command == UDP) {
+    // Association established: the control connection carries nothing
+    // further, it only scopes the association's lifetime
+    AsyncSocketRead();
+    return;
+  }
   if (HandleData(m_SocketBuffer, len)) {
     if (m_State == Complete) {
+      if (m_Command == UDP) {
+        StartUDPAssociate();
+        return;
+      }
       LOG(info)
         << "SOCKSHandler: SOCKS requested "
         << m_Address.dns.ToString() << ":"  << m_Port;
@@ -536,7 +562,7 @@ void SOCKSHandler::SentSOCKSDone(
       return;
     LOG(info) << "SOCKSHandler: new I2PTunnel connection";
     auto connection =
-      std::make_shared<kovri::client::I2PTunnelConnection>(
+      GetOwner()->AcquireHandler<kovri::client::I2PTunnelConnection>(
           GetOwner(),
           m_Socket,
           m_Stream);
@@ -576,6 +602,167 @@ void SOCKSHandler::HandleStreamRequestComplete(
   }
 }
 
+bool SOCKSHandler::StartUDPAssociate() {
+  boost::asio::ip::tcp::endpoint local;
+  try {
+    local = m_Socket->local_endpoint();
+    m_UDPRelaySocket = std::make_unique<boost::asio::ip::udp::socket>(
+        GetOwner()->GetService(),
+        boost::asio::ip::udp::endpoint(local.address(), 0));
+  } catch (const std::exception& e) {
+    LOG(error) << "SOCKSHandler: could not bind UDP relay: " << e.what();
+    SOCKSRequestFailed(SOCKS5Fail);
+    return false;
+  }
+  // The OS-assigned relay port doubles as our I2CP port, so every
+  // association gets its own datagram receiver
+  m_UDPLocalPort = m_UDPRelaySocket->local_endpoint().port();
+  auto local_destination = GetOwner()->GetLocalDestination();
+  auto datagram = local_destination->GetDatagramDestination();
+  if (!datagram)
+    datagram = local_destination->CreateDatagramDestination();
+  datagram->SetReceiver(
+      std::bind(
+          &SOCKSHandler::HandleI2PDatagram,
+          shared_from_this(),
+          std::placeholders::_1,
+          std::placeholders::_2,
+          std::placeholders::_3,
+          std::placeholders::_4,
+          std::placeholders::_5),
+      m_UDPLocalPort);
+  LOG(info)
+    << "SOCKSHandler: SOCKS5 UDP association on port " << m_UDPLocalPort;
+  UDPRelayReceive();
+  Address address;
+  address.ip = local.address().to_v4().to_ulong();
+  boost::asio::async_write(
+      *m_Socket,
+      GenerateSOCKS5Response(SOCKS5Success, IPv4, address, m_UDPLocalPort),
+      std::bind(
+          &SOCKSHandler::SentSOCKSResponse,
+          shared_from_this(),
+          std::placeholders::_1));
+  // Keep reading: EOF on the control connection ends the association
+  AsyncSocketRead();
+  return true;
+}
+
+void SOCKSHandler::UDPRelayReceive() {
+  m_UDPRelaySocket->async_receive_from(
+      boost::asio::buffer(
+          m_UDPRelayBuffer,
+          MAX_SOCKS_BUFFER_SIZE),
+      m_UDPSenderEndpoint,
+      std::bind(
+          &SOCKSHandler::HandleUDPRelayReceive,
+          shared_from_this(),
+          std::placeholders::_1,
+          std::placeholders::_2));
+}
+
+void SOCKSHandler::HandleUDPRelayReceive(
+    const boost::system::error_code& ecode,
+    std::size_t len) {
+  if (ecode) {
+    if (ecode != boost::asio::error::operation_aborted) {
+      LOG(error) << "SOCKSHandler: UDP relay receive got error: " << ecode;
+      Terminate();
+    }
+    return;
+  }
+  // Replies go back to wherever the client last sent from
+  m_UDPClientEndpoint = m_UDPSenderEndpoint;
+  // SOCKS5 UDP request header: RSV(2) FRAG(1) ATYP(1) DST.ADDR DST.PORT
+  do {
+    if (len < 5 || m_UDPRelayBuffer[2]) {
+      // Fragmented datagrams are an optional feature we don't support
+      LOG(warning) << "SOCKSHandler: dropping malformed or fragmented datagram";
+      break;
+    }
+    if (m_UDPRelayBuffer[3] != DNS) {
+      // I2P targets are hostnames; IP address types cannot name them
+      LOG(warning)
+        << "SOCKSHandler: dropping datagram with unsupported address type: "
+        << static_cast<int>(m_UDPRelayBuffer[3]);
+      break;
+    }
+    std::size_t const host_size = m_UDPRelayBuffer[4];
+    std::size_t const payload_offset = 7 + host_size;
+    if (len < payload_offset) {
+      LOG(warning) << "SOCKSHandler: dropping truncated datagram";
+      break;
+    }
+    std::string const host(
+        reinterpret_cast<const char*>(m_UDPRelayBuffer + 5), host_size);
+    kovri::core::IdentHash ident;
+    if (!ResolveUDPTargetIdent(host, ident)) {
+      LOG(warning) << "SOCKSHandler: dropping datagram for unknown host: " << host;
+      break;
+    }
+    std::uint16_t const port =
+        core::InputByteStream::Read<std::uint16_t>(
+            m_UDPRelayBuffer + 5 + host_size);
+    GetOwner()->GetLocalDestination()->GetDatagramDestination()->SendDatagramTo(
+        m_UDPRelayBuffer + payload_offset,
+        len - payload_offset,
+        ident,
+        m_UDPLocalPort,
+        port);
+  } while (false);
+  UDPRelayReceive();
+}
+
+void SOCKSHandler::HandleI2PDatagram(
+    const kovri::core::IdentityEx& from,
+    std::uint16_t from_port,
+    std::uint16_t to_port,
+    const std::uint8_t* buf,
+    std::size_t len) {
+  if (!m_UDPRelaySocket || !m_UDPClientEndpoint.port()) {
+    // No datagram from the client yet, so nowhere to relay to
+    return;
+  }
+  LOG(debug)
+    << "SOCKSHandler: I2P datagram " << from_port << " -> " << to_port
+    << ": " << len;
+  auto const host =
+      kovri::client::context.GetAddressBook().GetB32AddressFromIdentHash(
+          from.GetIdentHash());
+  std::vector<std::uint8_t> packet(7 + host.size() + len);
+  // RSV + FRAG
+  packet[0] = packet[1] = packet[2] = 0;
+  packet[3] = DNS;
+  packet[4] = host.size();
+  memcpy(packet.data() + 5, host.c_str(), host.size());
+  core::OutputByteStream::Write<std::uint16_t>(
+      packet.data() + 5 + host.size(), from_port);
+  memcpy(packet.data() + 7 + host.size(), buf, len);
+  boost::system::error_code ecode;
+  m_UDPRelaySocket->send_to(
+      boost::asio::buffer(packet.data(), packet.size()),
+      m_UDPClientEndpoint,
+      0,
+      ecode);
+  if (ecode)
+    LOG(warning) << "SOCKSHandler: UDP relay send got error: " << ecode;
+}
+
+bool SOCKSHandler::ResolveUDPTargetIdent(
+    const std::string& host,
+    kovri::core::IdentHash& ident) {
+  auto it = m_UDPResolvedIdents.find(host);
+  if (it != m_UDPResolvedIdents.end()) {
+    ident = it->second;
+    return true;
+  }
+  if (!kovri::client::context.GetAddressBook().CheckAddressIdentHashFound(
+          host, ident))
+    return false;
+  m_UDPResolvedIdents[host] = ident;
+  return true;
+}
+
 SOCKSServer::SOCKSServer(
     const std::string& address, int port,
     std::shared_ptr<kovri::client::ClientDestination> local_destination)
@@ -588,7 +775,7 @@ SOCKSServer::SOCKSServer(
 
 std::shared_ptr<kovri::client::I2PServiceHandler> SOCKSServer::CreateHandler(
     std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
-  return std::make_shared<SOCKSHandler> (this, socket);
+  return AcquireHandler<SOCKSHandler>(this, socket);
 }
 
 std::string SOCKSServer::GetName() const
@@ -35,6 +35,7 @@
 
 #include <boost/asio.hpp>
 
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -42,6 +43,8 @@
 
 #include "client/service.h"
 
+#include "core/router/identity.h"
+
 namespace kovri {
 namespace client {
 
@@ -304,6 +307,38 @@ class SOCKSHandler
   void HandleStreamRequestComplete(
       std::shared_ptr<kovri::client::Stream> stream);
 
+  /// @brief Set up the UDP ASSOCIATE relay: bind a local UDP socket,
+  ///  register a datagram receiver on the local destination and reply
+  ///  with the relay endpoint; the TCP connection only scopes the
+  ///  association's lifetime from then on
+  /// @return false if the relay could not be set up
+  bool StartUDPAssociate();
+
+  /// @brief Wait for the next encapsulated datagram from the client
+  void UDPRelayReceive();
+
+  /// @brief Strip the SOCKS5 UDP header and forward the payload as an
+  ///  I2P datagram, skipping the streaming layer entirely
+  void HandleUDPRelayReceive(
+      const boost::system::error_code& ecode,
+      std::size_t len);
+
+  /// @brief Wrap an inbound I2P datagram in a SOCKS5 UDP header and
+  ///  relay it back to the client's last known endpoint
+  void HandleI2PDatagram(
+      const kovri::core::IdentityEx& from,
+      std::uint16_t from_port,
+      std::uint16_t to_port,
+      const std::uint8_t* buf,
+      std::size_t len);
+
+  /// @brief Resolve a datagram target through the per-association cache,
+  ///  falling back to the address book on a miss
+  /// @return false if the hostname cannot be resolved
+  bool ResolveUDPTargetIdent(
+      const std::string& host,
+      kovri::core::IdentHash& ident);
+
   std::uint8_t m_SocketBuffer[MAX_SOCKS_BUFFER_SIZE];
   std::shared_ptr<boost::asio::ip::tcp::socket> m_Socket;
   std::shared_ptr<kovri::client::Stream> m_Stream;
@@ -327,6 +362,18 @@ class SOCKSHandler
   /// @brief Command requested
   CommandTypes m_Command;
   State m_State;
+  /// @brief Relay socket for UDP ASSOCIATE
+  std::unique_ptr<boost::asio::ip::udp::socket> m_UDPRelaySocket;
+  std::uint8_t m_UDPRelayBuffer[MAX_SOCKS_BUFFER_SIZE];
+  /// @brief Where replies go; learned from the client's first datagram
+  boost::asio::ip::udp::endpoint m_UDPClientEndpoint;
+  boost::asio::ip::udp::endpoint m_UDPSenderEndpoint;
+  /// @brief Hostnames already resolved during this association;
+  ///  repeated datagrams skip the address book
+  std::map<std::string, kovri::core::IdentHash> m_UDPResolvedIdents;
+  /// @brief Local I2CP port keying our datagram receiver
+  ///  (reuses the relay socket's OS-assigned port, unique per association)
+  std::uint16_t m_UDPLocalPort;
 
  public:
   SOCKSHandler(
@@ -35,8 +35,13 @@
 #include <boost/filesystem.hpp>
 #include <boost/endian/conversion.hpp>
 
+#include <algorithm>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <regex>
+#include <thread>
+#include <utility>
 
 #include "client/util/http.h"
 
@@ -69,42 +74,54 @@ bool Reseed::Start() {
       LOG(error) << "Reseed: failed to load certificates";
       return false;
     }
-  // Fetch SU3 stream for reseed
+  // Fetch and implement SU3 stream for reseed
+  // With default reseed, hosts are raced and we retry (with ranged
+  // resume of anything truncated) until 6 attempts are spent.
+  // With CLI reseed, we break after the first failed attempt.
+  const bool user_stream = !m_Stream.empty();
   std::size_t attempts = 0;
   const std::size_t max_attempts = 6;
   while (attempts != max_attempts) {
-    // With default reseed, we won't break until 6 attempts are made.
-    // With CLI reseed, we'll break after first failed attempt.
     if (!FetchStream()) {
       attempts++;
       LOG(error)
         << "Reseed: fetch failed after "
         << attempts << " of " << max_attempts << " attempts";
-      if (!m_Stream.empty() || attempts == max_attempts)
+      if (user_stream || attempts == max_attempts)
         return false;
-    } else {
-      LOG(debug) << "Reseed: fetch successful";
-      break;
+      continue;
+    }
+    LOG(debug) << "Reseed: fetch successful";
+    // Implement SU3
+    SU3 su3(
+        m_Stream,
+        m_SigningKeys,
+        core::context.GetOpts()["disable-su3-verification"].as<bool>()
+            ? false
+            : true);
+    // Hand each RI straight to NetDb as it is decompressed rather than
+    // buffering the whole extracted set, so the first stream to verify
+    // starts populating NetDb immediately (extraction runs after the
+    // SU3 signature has been verified)
+    su3.SetContentHandler(
+        [](const std::uint8_t* data, std::size_t len) {
+          return kovri::core::netdb.AddRouterInfo(data, len);
+        });
+    if (su3.SU3Impl()) {
+      LOG(info) << "Reseed: implementation successful";
+      return true;
     }
-  }
-  // Implement SU3
-  SU3 su3(
-      m_Stream,
-      m_SigningKeys,
-      core::context.GetOpts()["disable-su3-verification"].as<bool>() ? false
-                                                                     : true);
-  if (!su3.SU3Impl()) {
     LOG(error) << "Reseed: SU3 implementation failed";
-    return false;
-  }
-  // Insert extracted RI's into NetDb
-  for (auto const& router : su3.m_RouterInfos)
-    if (!kovri::core::netdb.AddRouterInfo(
-          router.second.data(),
-          router.second.size()))
+    attempts++;
+    if (user_stream || attempts == max_attempts)
       return false;
-  LOG(info) << "Reseed: implementation successful";
-  return true;
+    // Keep what we have: if the stream was merely truncated, the next
+    // attempt against this host resumes with a ranged request
+    if (!m_LastFetched.empty() && m_Stream.size() < RESEED_MAX_SU3_SIZE)
+      m_Partial[m_LastFetched] = std::move(m_Stream);
+    m_Stream.clear();  // Back to host selection, not a URL
+  }
+  return false;
 }
 
 bool Reseed::ProcessCerts(
@@ -181,17 +198,76 @@ bool Reseed::FetchStream() {
       return FetchStream(ifs);
     }
   } else {
-    m_Stream =
-      m_Hosts.at(
-          kovri::core::RandInRange32(0, m_Hosts.size() - 1)) +
-      m_Filename;
-    if (FetchStream(m_Stream))
-      return true;
-    m_Stream.clear();
+    return FetchAny();
   }
   return false;
 }
 
+bool Reseed::FetchAny() {
+  // Pick distinct hosts at random (partial Fisher-Yates)
+  std::vector<std::string> pool(m_Hosts);
+  const std::size_t count =
+      std::min<std::size_t>(RESEED_CONCURRENT_FETCHES, pool.size());
+  for (std::size_t i = 0; i < count; i++)
+    std::swap(
+        pool.at(i),
+        pool.at(kovri::core::RandInRange32(i, pool.size() - 1)));
+  // Shared between this thread and the detached workers; a worker that
+  // outlives this call (stalled host riding out its HTTP timeout) only
+  // touches the race state, never the Reseed object
+  struct Race {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::string winner, winner_url;
+    std::size_t remaining;
+  };
+  auto race = std::make_shared<Race>();
+  race->remaining = count;
+  for (std::size_t i = 0; i < count; i++) {
+    const std::string url = pool.at(i) + m_Filename;
+    // Resume a truncated earlier download of this URL, if any
+    std::string prefix;
+    auto partial = m_Partial.find(url);
+    if (partial != m_Partial.end())
+      prefix = partial->second;
+    std::thread([race, url, prefix]() {
+      LOG(info) << "Reseed: fetching from " << url;
+      HTTP http(url);
+      if (!prefix.empty())
+        http.SetResumeOffset(prefix.size());
+      std::string contents;
+      if (http.Download()) {
+        if (http.IsPartialContent())
+          contents = prefix + http.GetDownloadedContents();
+        else
+          contents = http.GetDownloadedContents();
+      }
+      std::lock_guard<std::mutex> lock(race->mutex);
+      race->remaining--;
+      if (!contents.empty() && contents.size() <= RESEED_MAX_SU3_SIZE
+          && race->winner.empty()) {
+        race->winner = std::move(contents);
+        race->winner_url = url;
+      }
+      race->done.notify_all();
+    }).detach();
+  }
+  // First complete download wins; late finishers drop their results
+  std::unique_lock<std::mutex> lock(race->mutex);
+  race->done.wait(lock, [&race]() {
+    return !race->winner.empty() || !race->remaining;
+  });
+  if (race->winner.empty()) {
+    LOG(error) << "Reseed: no raced host completed";
+    return false;
+  }
+  LOG(info) << "Reseed: first complete download from " << race->winner_url;
+  m_Stream = std::move(race->winner);
+  m_LastFetched = race->winner_url;
+  m_Partial.erase(m_LastFetched);
+  return true;
+}
+
 bool Reseed::FetchStream(
     const std::string& url) {
   LOG(info) << "Reseed: fetching from " << url;
@@ -248,7 +324,9 @@ bool SU3::SU3Impl()
       LOG(warning) << "SU3: verification disabled !";
       // TODO(unassigned): detection and implemention of other formats
       // Note: currently only zip format is implemented. Checks done in ZIP impl
-      m_Data->content_length = m_Stream.Str().size();
+      m_Stream.Seekg(0, std::ios::end);
+      m_Data->content_length = m_Stream.Tellg();
+      m_Stream.Seekg(0, std::ios::beg);
       m_Data->content_position = 0;
     }
   else
@@ -385,13 +463,11 @@ bool SU3::PrepareStream() {
     }
     // Save position
     m_Data->signature_position = m_Stream.Tellg();
-    // Prepare to read in both content length + signature length
+    // The signed region spans the header and content; only the signature
+    // itself is buffered, the region is streamed through the verifier
     m_Data->content_length += m_Data->signature_position;
-    m_Data->content.resize(m_Data->content_length);
     m_Data->signature.resize(m_Data->signature_length);
-    // Read in content and signature for verification against signer ID
-    m_Stream.Seekg(0, std::ios::beg);
-    m_Stream.Read(m_Data->content.data(), m_Data->content.size());
+    m_Stream.Seekg(m_Data->content_length, std::ios::beg);
     m_Stream.Read(m_Data->signature.data(), m_Data->signature.size());
     // Go back to prepare for RI extraction
     m_Stream.Seekg(m_Data->signature_position, std::ios::beg);
@@ -417,7 +493,19 @@ bool SU3::VerifySignature() {
   switch (m_Data->signature_type) {
     case kovri::core::SIGNING_KEY_TYPE_RSA_SHA512_4096: {
       kovri::core::RSASHA5124096RawVerifier verifier(signing_key_it->second);
-      verifier.Update(m_Data->content.data(), m_Data->content.size());
+      // Stream the signed region through the verifier in bounded chunks
+      // so verification overlaps parsing without a second content buffer
+      std::vector<std::uint8_t> chunk(SU3_STREAM_CHUNK_SIZE);
+      m_Stream.Seekg(0, std::ios::beg);
+      std::uint64_t remaining = m_Data->content_length;
+      while (remaining) {
+        std::size_t const count =
+            std::min<std::uint64_t>(remaining, chunk.size());
+        m_Stream.Read(chunk.data(), count);
+        verifier.Update(chunk.data(), count);
+        remaining -= count;
+      }
+      m_Stream.Seekg(m_Data->signature_position, std::ios::beg);
       if (!verifier.Verify(m_Data->signature.data())) {
         LOG(error) << "SU3: signature failed";
         return false;
@@ -440,15 +528,18 @@ bool SU3::VerifySignature() {
 bool SU3::ExtractContent() {
   LOG(debug) << "SU3: unzipping stream";
   kovri::client::ZIP zip(
-      m_Stream.Str(),
+      m_Input,
       m_Data->content_length,
       m_Data->content_position);
+  if (m_Handler)
+    zip.SetContentHandler(m_Handler);
   if (!zip.Unzip()) {
     LOG(error) << "SU3: unzip failed";
     return false;
   }
-  // Get unzipped RI's for Reseed
-  m_RouterInfos = zip.m_Contents;
+  // Get unzipped RI's for Reseed when not streamed through the handler
+  if (!m_Handler)
+    m_RouterInfos = std::move(zip.m_Contents);
   LOG(debug) << "SU3: extraction successful";
   return true;
 }
@@ -456,11 +547,18 @@ bool SU3::ExtractContent() {
 bool SU3::Extract(kovri::core::OutputFileStream* output)
 {
   LOG(debug) << "SU3: extracting payload";
-  std::size_t content_length =
-      m_Data->content_length - m_Data->signature_position;
-  if (!output->Write(
-          m_Data->content.data() + m_Data->content_position, content_length))
-    return false;
+  std::vector<std::uint8_t> chunk(SU3_STREAM_CHUNK_SIZE);
+  m_Stream.Seekg(m_Data->content_position, std::ios::beg);
+  std::uint64_t remaining =
+      m_Data->content_length - m_Data->content_position;
+  while (remaining) {
+    std::size_t const count =
+        std::min<std::uint64_t>(remaining, chunk.size());
+    m_Stream.Read(chunk.data(), count);
+    if (!output->Write(chunk.data(), count))
+      return false;
+    remaining -= count;
+  }
   return true;
 }
 
@@ -34,6 +34,7 @@
 #define SRC_CLIENT_RESEED_H_
 
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -59,6 +60,16 @@ namespace client {
  * https://geti2p.net/en/docs/spec/updates
  */
 
+/// @brief Chunk size for streaming SU3 verification and extraction
+const std::size_t SU3_STREAM_CHUNK_SIZE = 64 * 1024;
+
+/// @brief Reseed hosts raced concurrently; the first complete download
+///   wins and the stragglers are discarded
+const std::size_t RESEED_CONCURRENT_FETCHES = 3;
+
+/// @brief Largest SU3 we accept (also caps kept partial downloads)
+const std::size_t RESEED_MAX_SU3_SIZE = 128 * 1024;
+
 /**
  * @class Reseed
  * @brief Reseed implementation
@@ -93,6 +104,13 @@ class Reseed {
   /// @return false on failure
   bool FetchStream();
 
+  /// @brief Races several random reseed hosts concurrently; the first
+  ///   complete download becomes m_Stream, late finishers are dropped.
+  ///   A stalled host then costs nothing beyond its own worker thread
+  ///   instead of blocking bootstrap until its timeout
+  /// @return false when every raced host failed
+  bool FetchAny();
+
   /// @brief Downloads stream via HTTP/S
   /// @param URL
   /// @return false on failure
@@ -115,6 +133,14 @@ class Reseed {
   // The URI which will be the SU3
   std::string m_Stream;
 
+  // URL the current m_Stream contents came from
+  std::string m_LastFetched;
+
+  // Truncated downloads kept across retries, keyed by URL; the next
+  // attempt against the same host asks for the remainder with a ranged
+  // request instead of starting over
+  std::map<std::string, std::string> m_Partial;
+
   // Spec constant
   const std::string m_Filename = "i2pseeds.su3";
 
@@ -149,7 +175,8 @@ class SU3 {
   SU3(const std::string& su3,
       std::map<std::string, kovri::core::PublicKey>& keys,
       bool verify = true)
-      : m_Stream(su3),
+      : m_Input(su3),
+        m_Stream(su3),
         m_SigningKeys(keys),
         m_Verify(verify),
         m_Data(std::make_unique<Data>()) {}
@@ -157,6 +184,18 @@ class SU3 {
   // Extracted RI's (map of router info files)
   std::unordered_map<std::size_t, std::vector<std::uint8_t>> m_RouterInfos;
 
+  /// @brief Handler receiving each extracted file as it is decompressed;
+  ///   a false return aborts extraction
+  typedef std::function<bool (const std::uint8_t* data, std::size_t len)>
+      ContentHandler;
+
+  /// @brief Streams extracted files to handler as they are decompressed
+  ///   instead of buffering them all in m_RouterInfos; call before SU3Impl
+  void SetContentHandler(
+      const ContentHandler& handler) {
+    m_Handler = handler;
+  }
+
   /// @brief SU3 implementation
   /// @return False on failure
   bool SU3Impl();
@@ -275,9 +314,12 @@ class SU3 {
     std::uint64_t content_length;
     std::size_t content_position;  // ZIP/Router Infos/etc.
     std::size_t signature_position;
-    std::vector<std::uint8_t> content, signature;
+    std::vector<std::uint8_t> signature;
   };
 
+  // Original SU3 bytes (outlives this object; see callers)
+  const std::string& m_Input;
+
   // Complete SU3 Stream
   kovri::core::StringStream m_Stream;
 
@@ -287,6 +329,9 @@ class SU3 {
   /// @brief Enable SU3 verification?
   bool m_Verify;
 
+  /// @brief Streaming consumer for extracted files (optional)
+  ContentHandler m_Handler;
+
   // Spec-defined data
   std::unique_ptr<Data> m_Data;
 };
@@ -34,9 +34,86 @@
 
 #include "client/context.h"
 
+#include "core/util/timestamp.h"
+
 namespace kovri {
 namespace client {
 
+std::shared_ptr<Stream> StreamPool::Checkout(
+    const kovri::core::IdentHash& ident,
+    std::uint16_t port) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  auto it = m_Idle.find(ident);
+  if (it == m_Idle.end())
+    return nullptr;
+  auto& idle = it->second;
+  Sweep(idle, kovri::core::GetSecondsSinceEpoch());
+  while (!idle.empty()) {
+    auto entry = idle.begin();
+    while (entry != idle.end() && entry->port != port)
+      ++entry;
+    if (entry == idle.end())
+      break;
+    auto stream = entry->stream;
+    idle.erase(entry);
+    if (!stream->IsOpen() || stream->GetReceiveQueueSize()) {
+      // died or received stray data while parked
+      stream->Close();
+      continue;
+    }
+    if (idle.empty())
+      m_Idle.erase(it);
+    LOG(debug) << "StreamPool: reusing warm stream";
+    return stream;
+  }
+  if (idle.empty())
+    m_Idle.erase(it);
+  return nullptr;
+}
+
+void StreamPool::Return(
+    std::shared_ptr<Stream> stream,
+    std::uint16_t port) {
+  if (!stream)
+    return;
+  if (!stream->IsOpen() || stream->GetReceiveQueueSize()
+      || stream->GetSendBufferSize()) {
+    // not cleanly idle: never hand it to the next request
+    stream->Close();
+    return;
+  }
+  const auto now = kovri::core::GetSecondsSinceEpoch();
+  std::unique_lock<std::mutex> l(m_Mutex);
+  auto& idle = m_Idle[stream->GetRemoteIdentity().GetIdentHash()];
+  Sweep(idle, now);
+  if (idle.size() >= STREAM_POOL_MAX_PER_DESTINATION) {
+    stream->Close();
+    return;
+  }
+  idle.push_back({std::move(stream), port, now});
+}
+
+void StreamPool::CloseAll() {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  for (auto& entry : m_Idle)
+    for (auto& idle : entry.second)
+      idle.stream->Close();
+  m_Idle.clear();
+}
+
+void StreamPool::Sweep(
+    std::vector<PooledStream>& idle,
+    std::uint64_t now) {
+  for (auto it = idle.begin(); it != idle.end();) {
+    if (it->idle_since + STREAM_POOL_IDLE_TIMEOUT < now) {
+      it->stream->Close();
+      it = idle.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 I2PService::I2PService(
     std::shared_ptr<ClientDestination> local_destination)
     : m_LocalDestination(
@@ -56,6 +133,14 @@ void I2PService::CreateStream(
   assert(stream_request_complete);
   kovri::core::IdentHash ident_hash;
   if (kovri::client::context.GetAddressBook().CheckAddressIdentHashFound(dest, ident_hash)) {
+    // address-book hit: start warming the LeaseSet cache so neither this
+    // stream nor a later one blocks on a floodfill lookup
+    m_LocalDestination->PrefetchLeaseSet(ident_hash);
+    // a warm pooled stream skips the whole SYN exchange
+    if (auto stream = m_StreamPool.Checkout(ident_hash, port)) {
+      stream_request_complete(stream);
+      return;
+    }
     m_LocalDestination->CreateStream(
         stream_request_complete,
         ident_hash,
@@ -68,12 +153,19 @@ void I2PService::CreateStream(
 
 void TCPIPAcceptor::Start() {
   m_Acceptor.listen();
-  Accept();
+  // non-blocking so DrainAcceptBacklog() can poll the backlog without
+  // ever stalling the destination's io_service thread
+  m_Acceptor.non_blocking(true);
+  // several pending accepts overlap, so one completion still building
+  // its handler never leaves the listener without an armed accept
+  for (std::size_t worker = 0; worker < TCPIP_ACCEPTOR_NUM_WORKERS; worker++)
+    Accept();
 }
 
 void TCPIPAcceptor::Stop() {
   m_Acceptor.close();
   m_Timer.cancel();
+  GetStreamPool().CloseAll();
   ClearHandlers();
 }
 
@@ -114,14 +206,10 @@ void TCPIPAcceptor::HandleAccept(
     const boost::system::error_code& ecode,
     std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
   if (!ecode) {
-    LOG(info) << "I2PService: " << GetName() << " accepted";
-    auto handler = CreateHandler(socket);
-    if (handler) {
-      AddHandler(handler);
-      handler->Handle();
-    } else {
-      socket->close();
-    }
+    ProcessAccepted(socket);
+    // a completion means the backlog was non-empty an instant ago, so a
+    // connection burst has likely queued more behind it
+    DrainAcceptBacklog();
     Accept();
   } else {
     if (ecode != boost::asio::error::operation_aborted)
@@ -131,5 +219,37 @@ void TCPIPAcceptor::HandleAccept(
   }
 }
 
+void TCPIPAcceptor::ProcessAccepted(
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
+  LOG(info) << "I2PService: " << GetName() << " accepted";
+  auto handler = CreateHandler(socket);
+  if (handler) {
+    AddHandler(handler);
+    handler->Handle();
+  } else {
+    socket->close();
+  }
+}
+
+void TCPIPAcceptor::DrainAcceptBacklog() {
+  for (std::size_t drained = 0; drained < TCPIP_ACCEPT_BATCH; drained++) {
+    auto socket =
+      std::make_shared<boost::asio::ip::tcp::socket>(GetService());
+    boost::system::error_code ecode;
+    m_Acceptor.accept(*socket, ecode);
+    if (ecode) {
+      // would_block simply means the backlog is empty again
+      if (ecode != boost::asio::error::would_block
+          && ecode != boost::asio::error::try_again
+          && ecode != boost::asio::error::operation_aborted)
+        LOG(error)
+          << "I2PService: " << GetName()
+          << " closing socket on accept because: " << ecode.message();
+      break;
+    }
+    ProcessAccepted(socket);
+  }
+}
+
 }  // namespace client
 }  // namespace kovri
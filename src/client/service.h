@@ -35,11 +35,16 @@
 
 #include <boost/asio.hpp>
 
+#include <array>
 #include <atomic>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "client/destination.h"
 
@@ -49,6 +54,160 @@ namespace kovri {
 namespace client {
 
 class I2PServiceHandler;
+
+const int NUM_HANDLER_SHARDS = 8;  // power of two; shard picked from the handler address
+
+/// @brief Concurrent pending accepts per listener; overlapped completions
+///   keep admission going while an earlier accept still builds its handler
+const std::size_t TCPIP_ACCEPTOR_NUM_WORKERS = 4;
+
+/// @brief Connections drained synchronously per accept completion; a
+///   burst that queued in the listen backlog is admitted in a few
+///   completions instead of one round trip through the reactor each
+const std::size_t TCPIP_ACCEPT_BATCH = 16;
+
+/// @brief Idle established streams kept warm per remote destination
+const std::size_t STREAM_POOL_MAX_PER_DESTINATION = 8;
+
+/// @brief Seconds an idle pooled stream survives before it is closed
+const std::uint64_t STREAM_POOL_IDLE_TIMEOUT = 120;
+
+/// @class StreamPool
+/// @brief Bounded per-destination cache of idle established streams
+/// @details Client-side handlers (the HTTP proxy) return a stream here
+///   instead of closing it when the local socket goes away while the
+///   stream itself is still open; the next request to the same destination
+///   checks one out and skips the SYN round-trip. Expired and remotely
+///   closed entries are swept lazily on checkout/return
+class StreamPool {
+ public:
+  /// @brief Checks out an idle stream to the given destination and port
+  /// @return An open stream, or nullptr when none is pooled
+  std::shared_ptr<Stream> Checkout(
+      const kovri::core::IdentHash& ident,
+      std::uint16_t port);
+
+  /// @brief Parks an open stream for reuse; beyond the per-destination
+  ///   cap (or with unconsumed data pending) the stream is closed instead
+  void Return(
+      std::shared_ptr<Stream> stream,
+      std::uint16_t port);
+
+  /// @brief Closes and drops every pooled stream
+  void CloseAll();
+
+ private:
+  struct PooledStream {
+    std::shared_ptr<Stream> stream;
+    std::uint16_t port{};
+    std::uint64_t idle_since{};  // seconds since epoch
+  };
+
+  /// @brief Closes entries idle past STREAM_POOL_IDLE_TIMEOUT (lock held)
+  void Sweep(
+      std::vector<PooledStream>& idle,
+      std::uint64_t now);
+
+  std::mutex m_Mutex;
+  std::map<kovri::core::IdentHash, std::vector<PooledStream>> m_Idle;
+};
+
+/// @class HandlerMemoryPool
+/// @brief Free list of raw blocks backing handler allocations
+/// @details Each service creates handlers of only a few distinct sizes, so
+///   blocks are kept in exact-size buckets and reused verbatim; after
+///   warm-up connection setup/teardown touches no heap. Held by
+///   shared_ptr: the allocators embedded in handler control blocks keep
+///   the pool alive past the owning service if callbacks linger
+class HandlerMemoryPool {
+ public:
+  ~HandlerMemoryPool() {
+    for (auto& bucket : m_Buckets)
+      for (auto* block : bucket.second)
+        ::operator delete(block);
+  }
+
+  /// @brief Pops a recycled block of exactly the given size, or allocates
+  void* Acquire(std::size_t size) {
+    {
+      std::unique_lock<std::mutex> l(m_Mutex);
+      for (auto& bucket : m_Buckets) {
+        if (bucket.first == size && !bucket.second.empty()) {
+          auto* block = bucket.second.back();
+          bucket.second.pop_back();
+          return block;
+        }
+      }
+    }
+    return ::operator new(size);
+  }
+
+  /// @brief Retains the block for reuse, up to a per-size cap
+  void Release(void* block, std::size_t size) {
+    {
+      std::unique_lock<std::mutex> l(m_Mutex);
+      for (auto& bucket : m_Buckets) {
+        if (bucket.first == size) {
+          if (bucket.second.size() < MaxRetainedPerBucket) {
+            bucket.second.push_back(block);
+            return;
+          }
+          break;
+        }
+      }
+      if (m_Buckets.size() < MaxBuckets) {
+        m_Buckets.emplace_back(size, std::vector<void*>{block});
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+
+ private:
+  enum : std::size_t { MaxRetainedPerBucket = 64, MaxBuckets = 8 };
+  std::mutex m_Mutex;
+  std::vector<std::pair<std::size_t, std::vector<void*>>> m_Buckets;
+};
+
+/// @class HandlerAllocator
+/// @brief Standard allocator over a HandlerMemoryPool, for allocate_shared
+///   so a handler and its control block come from one recycled block
+template <class T>
+class HandlerAllocator {
+ public:
+  typedef T value_type;
+
+  explicit HandlerAllocator(
+      std::shared_ptr<HandlerMemoryPool> pool)
+      : m_Pool(std::move(pool)) {}
+
+  template <class U>
+  HandlerAllocator(
+      const HandlerAllocator<U>& other)
+      : m_Pool(other.m_Pool) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(m_Pool->Acquire(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) {
+    m_Pool->Release(p, n * sizeof(T));
+  }
+
+  template <class U>
+  bool operator==(const HandlerAllocator<U>& other) const {
+    return m_Pool == other.m_Pool;
+  }
+
+  template <class U>
+  bool operator!=(const HandlerAllocator<U>& other) const {
+    return m_Pool != other.m_Pool;
+  }
+
+ private:
+  template <class U> friend class HandlerAllocator;
+  std::shared_ptr<HandlerMemoryPool> m_Pool;
+};
 /// @class I2PService abstract class for service
 /// @brief base class for i2p service
 class I2PService {
@@ -64,20 +223,33 @@ class I2PService {
   /// @param conn I2pService pointer handler to add
   inline void AddHandler(
       std::shared_ptr<I2PServiceHandler> conn) {
-    std::unique_lock<std::mutex> l(m_HandlersMutex);
-    m_Handlers.insert(conn);
+    auto& shard = GetHandlerShard(conn.get());
+    std::unique_lock<std::mutex> l(shard.mutex);
+    shard.handlers.insert(conn);
   }
   /// @brief remove handler from set
   /// @param conn I2PServiceHandler pointer to remove
   inline void RemoveHandler(
       std::shared_ptr<I2PServiceHandler> conn) {
-    std::unique_lock<std::mutex> l(m_HandlersMutex);
-    m_Handlers.erase(conn);
+    auto& shard = GetHandlerShard(conn.get());
+    std::unique_lock<std::mutex> l(shard.mutex);
+    shard.handlers.erase(conn);
   }
   /// @brief  clear out handlers from set
   inline void ClearHandlers() {
-    std::unique_lock<std::mutex> l(m_HandlersMutex);
-    m_Handlers.clear();
+    for (auto& shard : m_HandlerShards) {
+      std::unique_lock<std::mutex> l(shard.mutex);
+      shard.handlers.clear();
+    }
+  }
+  /// @brief Constructs a handler in a block recycled from this service's
+  ///   pool; the returned pointer is a drop-in for make_shared
+  template <class THandler, typename... Args>
+  std::shared_ptr<THandler> AcquireHandler(
+      Args&&... args) {
+    return std::allocate_shared<THandler>(
+        HandlerAllocator<THandler>(m_HandlerPool),
+        std::forward<Args>(args)...);
   }
   /// @brief returns pointer to member local destination
   inline std::shared_ptr<ClientDestination> GetLocalDestination() {
@@ -96,6 +268,11 @@ class I2PService {
       StreamRequestComplete stream_request_complete,
       const std::string& dest,
       std::uint16_t port = 0);
+  /// @brief Idle-stream cache shared by this service's handlers;
+  ///   CreateStream checks it before opening a fresh stream
+  StreamPool& GetStreamPool() {
+    return m_StreamPool;
+  }
   /// @brief return io_service reference of member local destination
   inline boost::asio::io_service& GetService() {
     return m_LocalDestination->GetService();
@@ -112,9 +289,27 @@ class I2PService {
   virtual std::string GetName() const = 0;
 
  private:
+  // live handlers, sharded so concurrent connection setup and teardown
+  // rarely contend on one lock
+  struct HandlerShard {
+    std::mutex mutex;
+    std::unordered_set<std::shared_ptr<I2PServiceHandler> > handlers;
+  };
+
+  // The block allocator hands out aligned addresses, so the low bits
+  // above the alignment spread handlers across shards
+  HandlerShard& GetHandlerShard(
+      const I2PServiceHandler* conn) {
+    return m_HandlerShards[
+        (reinterpret_cast<std::uintptr_t>(conn) >> 6)
+        & (NUM_HANDLER_SHARDS - 1)];
+  }
+
   std::shared_ptr<ClientDestination> m_LocalDestination;
-  std::unordered_set<std::shared_ptr<I2PServiceHandler> > m_Handlers;
-  std::mutex m_HandlersMutex;
+  std::array<HandlerShard, NUM_HANDLER_SHARDS> m_HandlerShards;
+  StreamPool m_StreamPool;
+  std::shared_ptr<HandlerMemoryPool> m_HandlerPool =
+      std::make_shared<HandlerMemoryPool>();
 };
 
 /// @class I2PServiceHandler
@@ -218,6 +413,8 @@ class TCPIPAcceptor : public I2PService {
  private:
   /// @brief accept connection ; create socket for handler to listen on
   /// pass handler function; this is what starts the communication
+  /// @note Start() primes TCPIP_ACCEPTOR_NUM_WORKERS of these chains so
+  /// several accepts stay pending on the shared acceptor at once
   void Accept();
   /// @brief callback function to handle data transfers ;
   /// @param ecode boost error code; reference variable to hold error code when app
@@ -225,6 +422,13 @@ class TCPIPAcceptor : public I2PService {
   void HandleAccept(
       const boost::system::error_code& ecode,
       std::shared_ptr<boost::asio::ip::tcp::socket> socket);
+  /// @brief hand a freshly accepted socket to its handler
+  void ProcessAccepted(
+      std::shared_ptr<boost::asio::ip::tcp::socket> socket);
+  /// @brief synchronously admit connections still queued in the listen
+  /// backlog, up to TCPIP_ACCEPT_BATCH, so a burst does not pay one
+  /// reactor round trip per connection
+  void DrainAcceptBacklog();
 
   boost::asio::ip::tcp::acceptor m_Acceptor;
   boost::asio::deadline_timer m_Timer;
@@ -42,6 +42,31 @@
 namespace kovri {
 namespace client {
 
+std::mutex TunnelBufferPool::m_Mutex;
+std::vector<std::unique_ptr<TunnelBufferPool::Buffer>>
+    TunnelBufferPool::m_FreeBuffers;
+
+std::unique_ptr<TunnelBufferPool::Buffer> TunnelBufferPool::Acquire() {
+  {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    if (!m_FreeBuffers.empty()) {
+      auto buffer = std::move(m_FreeBuffers.back());
+      m_FreeBuffers.pop_back();
+      return buffer;
+    }
+  }
+  return std::make_unique<Buffer>();
+}
+
+void TunnelBufferPool::Release(
+    std::unique_ptr<TunnelBufferPool::Buffer> buffer) {
+  if (!buffer)
+    return;
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (m_FreeBuffers.size() < Size::MaxFreeBuffers)
+    m_FreeBuffers.push_back(std::move(buffer));
+}
+
 //
 // Tunnel connection implementation for all client/server tunnel types
 //
@@ -54,7 +79,9 @@ I2PTunnelConnection::I2PTunnelConnection(
     : I2PServiceHandler(owner),
       m_Socket(socket),
       m_RemoteEndpoint(socket->remote_endpoint()),
-      m_IsQuiet(true) {
+      m_IsQuiet(true),
+      m_IsPooled(false),
+      m_PoolPort(0) {
         m_Stream = GetOwner()->GetLocalDestination()->CreateStream(
             lease_set,
             port);
@@ -63,12 +90,16 @@ I2PTunnelConnection::I2PTunnelConnection(
 I2PTunnelConnection::I2PTunnelConnection(
     I2PService* owner,
     std::shared_ptr<boost::asio::ip::tcp::socket> socket,
-    std::shared_ptr<kovri::client::Stream> stream)
+    std::shared_ptr<kovri::client::Stream> stream,
+    bool pooled,
+    std::uint16_t pool_port)
     : I2PServiceHandler(owner),
       m_Socket(socket),
       m_Stream(stream),
       m_RemoteEndpoint(socket->remote_endpoint()),
-      m_IsQuiet(true) {}
+      m_IsQuiet(true),
+      m_IsPooled(pooled),
+      m_PoolPort(pool_port) {}
 
 I2PTunnelConnection::I2PTunnelConnection(
     I2PService* owner,
@@ -80,18 +111,36 @@ I2PTunnelConnection::I2PTunnelConnection(
       m_Socket(socket),
       m_Stream(stream),
       m_RemoteEndpoint(target),
-      m_IsQuiet(quiet) {}
-
-I2PTunnelConnection::~I2PTunnelConnection() {}
+      m_IsQuiet(quiet),
+      m_IsPooled(false),
+      m_PoolPort(0) {}
+
+I2PTunnelConnection::~I2PTunnelConnection() {
+  // All pending handlers are done (they held our reference), so the
+  // chunks can go back to the shared pool
+  TunnelBufferPool::Release(std::move(m_Buffer));
+  TunnelBufferPool::Release(std::move(m_StreamBuffer));
+}
 
 void I2PTunnelConnection::I2PConnect(
     const std::uint8_t* msg,
     std::size_t len) {
   if (m_Stream) {
-    if (msg)
+    if (msg && len) {
       m_Stream->Send(msg, len);  // connect and send
-    else
-      m_Stream->Send(m_Buffer, 0);  // connect
+    } else {
+      // Hold the SYN briefly so the first bytes read from the socket can
+      // ride it instead of chasing an empty SYN one RTT behind; the timer
+      // still opens the stream for server-speaks-first protocols when the
+      // local side stays quiet
+      auto stream = m_Stream;
+      stream->GetLocalDestination().GetTimerWheel().Add(
+          I2P_TUNNEL_SYN_PAYLOAD_GRACE,
+          [stream](bool aborted) {
+            if (!aborted && stream->GetStatus() == eStreamStatusNew)
+              stream->Send(nullptr, 0);  // bare connect
+          });
+    }
   }
   StreamReceive();
   Receive();
@@ -111,7 +160,14 @@ void I2PTunnelConnection::Terminate() {
   if (Kill())
     return;
   if (m_Stream) {
-    m_Stream->Close();
+    if (m_IsPooled) {
+      // flush the receive pending on this connection, then park the
+      // stream for the next request to the same destination
+      m_Stream->Cancel();
+      GetOwner()->GetStreamPool().Return(std::move(m_Stream), m_PoolPort);
+    } else {
+      m_Stream->Close();
+    }
     m_Stream.reset();
   }
   m_Socket->close();
@@ -119,9 +175,11 @@ void I2PTunnelConnection::Terminate() {
 }
 
 void I2PTunnelConnection::Receive() {
+  if (!m_Buffer)
+    m_Buffer = TunnelBufferPool::Acquire();
   m_Socket->async_read_some(
       boost::asio::buffer(
-          m_Buffer,
+          m_Buffer->data(),
           I2P_TUNNEL_CONNECTION_BUFFER_SIZE),
       std::bind(
           &I2PTunnelConnection::HandleReceived,
@@ -145,7 +203,7 @@ void I2PTunnelConnection::HandleReceived(
     if (m_Stream) {
       auto s = shared_from_this();
       m_Stream->AsyncSend(
-          m_Buffer,
+          m_Buffer->data(),
           bytes_transferred,
           [s](const boost::system::error_code& ecode) {
           if (!ecode)
@@ -169,17 +227,18 @@ void I2PTunnelConnection::HandleWrite(
 }
 
 void I2PTunnelConnection::StreamReceive() {
-  if (m_Stream)
-    m_Stream->AsyncReceive(
-        boost::asio::buffer(
-            m_StreamBuffer,
-            I2P_TUNNEL_CONNECTION_BUFFER_SIZE),
-        std::bind(
-            &I2PTunnelConnection::HandleStreamReceive,
-            shared_from_this(),
-            std::placeholders::_1,
-            std::placeholders::_2),
+  if (m_Stream) {
+    // drain the stream's pooled segments directly: inbound payloads go
+    // from the receive queue to the socket with no intermediate copy
+    auto s = shared_from_this();
+    m_Stream->AsyncReceiveSegments(
+        I2P_TUNNEL_CONNECTION_BUFFER_SIZE,
+        [s](const boost::system::error_code& ecode,
+            std::vector<kovri::client::Packet*> segments) {
+          s->HandleStreamReceiveSegments(ecode, std::move(segments));
+        },
         I2P_TUNNEL_CONNECTION_MAX_IDLE);
+  }
 }
 
 void I2PTunnelConnection::HandleStreamReceive(
@@ -193,10 +252,49 @@ void I2PTunnelConnection::HandleStreamReceive(
         Terminate();
       }
   } else {
-    Write(m_StreamBuffer, bytes_transferred);
+    Write(m_StreamBuffer->data(), bytes_transferred);
+  }
+}
+
+void I2PTunnelConnection::HandleStreamReceiveSegments(
+    const boost::system::error_code& ecode,
+    std::vector<kovri::client::Packet*> segments) {
+  if (ecode) {
+    if (ecode != boost::asio::error::operation_aborted)
+      {
+        LOG(error) << "I2PTunnelConnection: " << __func__ << ": '"
+                   << ecode.message() << "'";
+        Terminate();
+      }
+  } else {
+    WriteSegments(std::move(segments));
   }
 }
 
+void I2PTunnelConnection::WriteSegments(
+    std::vector<kovri::client::Packet*> segments) {
+  // gather-write straight from the pooled packet payloads; the closure
+  // keeps the stream and packets alive until the socket write completes,
+  // then hands the packets back to the stream's pool
+  auto s = shared_from_this();
+  auto stream = m_Stream;
+  auto segs = std::make_shared<std::vector<kovri::client::Packet*>>(
+      std::move(segments));
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(segs->size());
+  for (auto packet : *segs)
+    buffers.emplace_back(packet->GetBuffer(), packet->GetLength());
+  boost::asio::async_write(
+      *m_Socket,
+      buffers,
+      [s, stream, segs](
+          const boost::system::error_code& ecode, std::size_t) {
+        if (stream)
+          stream->ReleaseReceivedSegments(*segs);
+        s->HandleWrite(ecode);
+      });
+}
+
 void I2PTunnelConnection::Write(
     const std::uint8_t* buf,
     std::size_t len) {
@@ -223,8 +321,10 @@ void I2PTunnelConnection::HandleConnect(
       // send destination first like received from I2P
       std::string dest = m_Stream->GetRemoteIdentity().ToBase64();
       dest += "\n";
+      if (!m_StreamBuffer)
+        m_StreamBuffer = TunnelBufferPool::Acquire();
       memcpy(
-          m_StreamBuffer,
+          m_StreamBuffer->data(),
           dest.c_str(),
           dest.size());
       HandleStreamReceive(
@@ -249,6 +349,25 @@ I2PTunnelConnectionHTTP::I2PTunnelConnectionHTTP(
       m_Host(host),
       m_HeaderSent(false) {}
 
+void I2PTunnelConnectionHTTP::WriteSegments(
+    std::vector<kovri::client::Packet*> segments) {
+  if (m_HeaderSent) {
+    I2PTunnelConnection::WriteSegments(std::move(segments));
+    return;
+  }
+  // still rewriting the header: concatenate this batch for the parsing
+  // Write below (it buffers the bytes synchronously, so a local copy is
+  // safe), and recycle the packets right away
+  std::string data;
+  for (auto packet : segments)
+    data.append(
+        reinterpret_cast<const char*>(packet->GetBuffer()),
+        packet->GetLength());
+  if (get_stream())
+    get_stream()->ReleaseReceivedSegments(segments);
+  Write(reinterpret_cast<const std::uint8_t*>(data.data()), data.size());
+}
+
 void I2PTunnelConnectionHTTP::Write(
     const std::uint8_t* buf,
     std::size_t len) {
@@ -277,11 +396,11 @@ void I2PTunnelConnectionHTTP::Write(
               {
                 // Append X-I2P headers as a server-side courtesy
                 m_OutHeader
-                    << "X-I2P-DestHash: " << ident.GetIdentHash().ToBase64()
+                    << "X-I2P-DestHash: " << kovri::core::ToBase64Cached(ident.GetIdentHash())
                     << "\r\n";
 
                 m_OutHeader
-                    << "X-I2P-DestB32: " << ident.GetIdentHash().ToBase32()
+                    << "X-I2P-DestB32: " << kovri::core::ToBase32Cached(ident.GetIdentHash())
                     << ".b32.i2p\r\n";
 
                 m_OutHeader << "X-I2P-DestB64: " << ident.ToBase64() << "\r\n";
@@ -324,6 +443,14 @@ void I2PTunnelConnectionHTTP::Write(
       m_Socket(socket) {}
 
 void I2PClientTunnelHandler::Handle() {
+  // Bind to the pre-warmed spare stream when one is ready: its
+  // establishment latency was paid before this local connect arrived
+  auto stream =
+      static_cast<I2PClientTunnel*>(GetOwner())->AcquireSpareStream();
+  if (stream) {
+    HandleStreamRequestComplete(stream);
+    return;
+  }
   GetOwner()->GetLocalDestination()->CreateStream(
       std::bind(
           &I2PClientTunnelHandler::HandleStreamRequestComplete,
@@ -340,7 +467,7 @@ void I2PClientTunnelHandler::HandleStreamRequestComplete(
       return;
     LOG(debug) << "I2PClientTunnelHandler: new I2PTunnel connection";
     auto connection =
-      std::make_shared<I2PTunnelConnection>(
+      GetOwner()->AcquireHandler<I2PTunnelConnection>(
           GetOwner(),
           m_Socket,
           stream);
@@ -377,21 +504,32 @@ I2PClientTunnel::I2PClientTunnel(
           tunnel.port,
           local_destination),
       m_TunnelAttributes(tunnel),
-      m_DestinationIdentHash(nullptr) {}
+      m_DestinationIdentHash(nullptr),
+      m_SpareStreamPending(false) {}
 
 
 void I2PClientTunnel::Start() {
   TCPIPAcceptor::Start();
   GetDestIdentHash();
+  // Pay resolution and stream establishment before the first local connect
+  PrewarmStream();
 }
 
 void I2PClientTunnel::Stop() {
   TCPIPAcceptor::Stop();
+  {
+    std::unique_lock<std::mutex> l(m_SpareStreamMutex);
+    if (m_SpareStream) {
+      m_SpareStream->Close();
+      m_SpareStream = nullptr;
+    }
+    m_SpareStreamPending = false;
+  }
   m_DestinationIdentHash.reset(nullptr);
 }
 
 // TODO(unassigned): HACK: maybe we should create a caching IdentHash provider in AddressBook?
-std::unique_ptr<const kovri::core::IdentHash> I2PClientTunnel::GetDestIdentHash() {
+const kovri::core::IdentHash* I2PClientTunnel::GetDestIdentHash() {
   if (!m_DestinationIdentHash) {
     kovri::core::IdentHash ident_hash;
     AddressBook& book = kovri::client::context.GetAddressBook();
@@ -403,15 +541,64 @@ std::unique_ptr<const kovri::core::IdentHash> I2PClientTunnel::GetDestIdentHash(
         << "I2PClientTunnel: remote destination " << dest << " not found";
     }
   }
-  return std::move(m_DestinationIdentHash);
+  return m_DestinationIdentHash.get();
+}
+
+std::shared_ptr<kovri::client::Stream> I2PClientTunnel::AcquireSpareStream() {
+  std::shared_ptr<kovri::client::Stream> stream;
+  {
+    std::unique_lock<std::mutex> l(m_SpareStreamMutex);
+    stream.swap(m_SpareStream);
+  }
+  // A spare that idled long enough for the remote to drop it is useless;
+  // streams still establishing are handed out like the CreateStream path does
+  if (stream &&
+      stream->GetStatus() != eStreamStatusNew &&
+      stream->GetStatus() != eStreamStatusOpen) {
+    stream->Close();
+    stream = nullptr;
+  }
+  PrewarmStream();
+  return stream;
+}
+
+void I2PClientTunnel::PrewarmStream() {
+  {
+    std::unique_lock<std::mutex> l(m_SpareStreamMutex);
+    if (m_SpareStream || m_SpareStreamPending)
+      return;
+    m_SpareStreamPending = true;
+  }
+  const auto* ident_hash = GetDestIdentHash();
+  if (!ident_hash) {
+    std::unique_lock<std::mutex> l(m_SpareStreamMutex);
+    m_SpareStreamPending = false;
+    return;
+  }
+  GetLocalDestination()->CreateStream(
+      std::bind(
+          &I2PClientTunnel::HandleSpareStream,
+          this,
+          std::placeholders::_1),
+      *ident_hash,
+      GetTunnelAttributes().dest_port);
+}
+
+void I2PClientTunnel::HandleSpareStream(
+    std::shared_ptr<kovri::client::Stream> stream) {
+  // A null stream means the LeaseSet is not available yet; the next
+  // accepted connection retries the pre-warm
+  std::unique_lock<std::mutex> l(m_SpareStreamMutex);
+  m_SpareStreamPending = false;
+  m_SpareStream = stream;
 }
 
 std::shared_ptr<I2PServiceHandler> I2PClientTunnel::CreateHandler(
     std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
-  auto ident_hash = GetDestIdentHash();
+  const auto* ident_hash = GetDestIdentHash();
   auto port = GetTunnelAttributes().dest_port;
   if (ident_hash) {
-    return std::make_shared<I2PClientTunnelHandler>(this, *ident_hash, port, socket);
+    return AcquireHandler<I2PClientTunnelHandler>(this, *ident_hash, port, socket);
   } else {
     return nullptr;
   }
@@ -571,7 +758,7 @@ void I2PServerTunnel::HandleAccept(
       return;
     LOG(info)
       << "I2PServerTunnel: creating connection with "
-      << stream->GetRemoteIdentity().GetIdentHash().ToBase32() + ".b32.i2p";
+      << kovri::core::GetB32Address(stream->GetRemoteIdentity().GetIdentHash());
     CreateI2PConnection(stream);
   }
 }
@@ -584,7 +771,7 @@ bool I2PServerTunnel::EnforceACL(
   }
   auto ident = stream->GetRemoteIdentity().GetIdentHash();
   bool is_on_list = GetACL().count(ident);
-  auto b32 = ident.ToBase32() + ".b32.i2p";
+  auto b32 = kovri::core::GetB32Address(ident);
   LOG(info) << "I2PServerTunnel: enforcing ACL for " << b32;
   if (GetTunnelAttributes().acl.is_white) {
     LOG(info) << "I2PServerTunnel: whitelist enabled";
@@ -611,7 +798,7 @@ bool I2PServerTunnel::EnforceACL(
 void I2PServerTunnel::CreateI2PConnection(
     std::shared_ptr<kovri::client::Stream> stream) {
   auto conn =
-    std::make_shared<I2PTunnelConnection>(
+    AcquireHandler<I2PTunnelConnection>(
         this,
         stream,
         std::make_shared<boost::asio::ip::tcp::socket>(GetService()),
@@ -630,7 +817,7 @@ I2PServerTunnelHTTP::I2PServerTunnelHTTP(
 void I2PServerTunnelHTTP::CreateI2PConnection(
     std::shared_ptr<kovri::client::Stream> stream) {
   auto conn =
-    std::make_shared<I2PTunnelConnectionHTTP>(
+    AcquireHandler<I2PTunnelConnectionHTTP>(
         this,
         stream,
         std::make_shared<boost::asio::ip::tcp::socket>(GetService()),
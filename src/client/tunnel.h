@@ -35,12 +35,15 @@
 
 #include <boost/asio.hpp>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "client/api/streaming.h"
 #include "client/destination.h"
@@ -64,15 +67,48 @@ struct ACL {
 /// @brief Attributes for client/server tunnel
 /// @notes For details, see tunnels configuration key
 struct TunnelAttributes {
-  TunnelAttributes() : port(0), dest_port(0), in_port(0) {}
+  TunnelAttributes() : port(0), dest_port(0), in_port(0), hops(-1) {}
   std::string name, type, dest, address, keys;
   std::uint16_t port, dest_port, in_port;
+  // tunnel length of the local destination; 0 = zero-hop (no anonymity,
+  // near-direct latency), -1 = I2CP default
+  std::int16_t hops;
   ACL acl{};
 };
 
 const std::size_t I2P_TUNNEL_CONNECTION_BUFFER_SIZE = 8192;
 const int I2P_TUNNEL_CONNECTION_MAX_IDLE = 3600;  // in seconds
 const int I2P_TUNNEL_DESTINATION_REQUEST_TIMEOUT = 10;  // in seconds
+// How long a freshly connected client tunnel holds its SYN waiting for the
+// first local bytes, so they can be bundled into the SYN (0-RTT open)
+const int I2P_TUNNEL_SYN_PAYLOAD_GRACE = 20;  // in milliseconds
+
+/// @class TunnelBufferPool
+/// @brief Shared pool of fixed-size relay buffers
+/// @details Every proxied connection (HTTP, SOCKS, and plain client/server
+///   tunnels relay through I2PTunnelConnection) leases its socket and stream
+///   buffers here on first use and recycles them on teardown, so bursts of
+///   short-lived connections reuse a bounded set of chunks instead of each
+///   carrying its own arrays
+class TunnelBufferPool {
+ public:
+  using Buffer = std::array<std::uint8_t, I2P_TUNNEL_CONNECTION_BUFFER_SIZE>;
+
+  /// @brief Leases a buffer from the pool, allocating only when empty
+  static std::unique_ptr<Buffer> Acquire();
+
+  /// @brief Recycles a buffer for reuse (null is ignored)
+  /// @notes Buffers beyond the retention cap are simply freed
+  static void Release(std::unique_ptr<Buffer> buffer);
+
+ private:
+  enum Size : std::uint8_t {
+    MaxFreeBuffers = 64,  // retention cap; 512KB of pooled chunks
+  };
+
+  static std::mutex m_Mutex;
+  static std::vector<std::unique_ptr<Buffer>> m_FreeBuffers;
+};
 
 class I2PTunnelConnection
     : public I2PServiceHandler,
@@ -85,11 +121,14 @@ class I2PTunnelConnection
       std::shared_ptr<const kovri::core::LeaseSet> lease_set,
       std::uint16_t port = 0);
 
-  // To I2P using simplified API
+  // To I2P using simplified API; pooled connections give their stream
+  // back to the owner's StreamPool on teardown instead of closing it
   I2PTunnelConnection(
       I2PService* owner,
       std::shared_ptr<boost::asio::ip::tcp::socket> socket,
-      std::shared_ptr<kovri::client::Stream> stream);
+      std::shared_ptr<kovri::client::Stream> stream,
+      bool pooled = false,
+      std::uint16_t pool_port = 0);
 
   // From I2P
   I2PTunnelConnection(
@@ -121,6 +160,11 @@ class I2PTunnelConnection
       const std::uint8_t* buf,
       std::size_t len);
 
+  // relays drained stream segments to the socket without an intermediate
+  // copy; overloaded where the byte stream must be inspected first
+  virtual void WriteSegments(
+      std::vector<kovri::client::Packet*> segments);
+
   void HandleWrite(
       const boost::system::error_code& ecode);
 
@@ -135,17 +179,24 @@ class I2PTunnelConnection
       const boost::system::error_code& ecode,
       std::size_t bytes_transferred);
 
+  void HandleStreamReceiveSegments(
+      const boost::system::error_code& ecode,
+      std::vector<kovri::client::Packet*> segments);
+
   void HandleConnect(
       const boost::system::error_code& ecode);
 
  private:
-  std::uint8_t m_Buffer[I2P_TUNNEL_CONNECTION_BUFFER_SIZE],
-  m_StreamBuffer[I2P_TUNNEL_CONNECTION_BUFFER_SIZE];
+  // Leased from the shared pool on first use, recycled by the destructor
+  // (only after all pending handlers released their reference)
+  std::unique_ptr<TunnelBufferPool::Buffer> m_Buffer, m_StreamBuffer;
 
   std::shared_ptr<boost::asio::ip::tcp::socket> m_Socket;
   std::shared_ptr<kovri::client::Stream> m_Stream;
   boost::asio::ip::tcp::endpoint m_RemoteEndpoint;
   bool m_IsQuiet;  // don't send destination
+  bool m_IsPooled;  // see StreamPool
+  std::uint16_t m_PoolPort;  // remote port the pooled stream targets
 };
 
 class I2PTunnelConnectionHTTP: public I2PTunnelConnection {
@@ -162,6 +213,11 @@ class I2PTunnelConnectionHTTP: public I2PTunnelConnection {
       const std::uint8_t* buf,
       std::size_t len);
 
+  // header rewriting needs the byte stream contiguous, so segments are
+  // concatenated (one copy) until the rewritten header is out
+  void WriteSegments(
+      std::vector<kovri::client::Packet*> segments);
+
  private:
   std::string m_Host;
   std::stringstream m_InHeader, m_OutHeader;
@@ -202,6 +258,15 @@ class I2PClientTunnel : public TCPIPAcceptor {
     m_TunnelAttributes = tunnel;
   }
 
+  /// @brief Takes the pre-warmed spare stream, kicking off its replacement
+  /// @return Null when none is ready (caller falls back to CreateStream)
+  std::shared_ptr<kovri::client::Stream> AcquireSpareStream();
+
+  /// @brief Pre-opens a spare stream to the remote destination so the next
+  ///   local connect binds to an already-established stream
+  /// @notes Also warms the LeaseSet cache; no-op while one is in flight
+  void PrewarmStream();
+
  protected:
   /// @brief Implements TCPIPAcceptor
   std::shared_ptr<I2PServiceHandler> CreateHandler(
@@ -213,11 +278,20 @@ class I2PClientTunnel : public TCPIPAcceptor {
   TunnelAttributes m_TunnelAttributes;
 
   /// @brief Gets ident hash of tunnel attribute remote destination
-  /// @return Unique pointer to ident hash
-  std::unique_ptr<const kovri::core::IdentHash> GetDestIdentHash();
+  /// @return Observer pointer to cached ident hash, null when unresolved
+  const kovri::core::IdentHash* GetDestIdentHash();
+
+  /// @brief Completion handler for the spare stream pre-warm
+  void HandleSpareStream(
+      std::shared_ptr<kovri::client::Stream> stream);
 
-  /// @brief Destination ident hash
+  /// @brief Destination ident hash, resolved once and cached
   std::unique_ptr<const kovri::core::IdentHash> m_DestinationIdentHash;
+
+  /// @brief Pre-warmed spare stream state (see PrewarmStream)
+  std::mutex m_SpareStreamMutex;
+  std::shared_ptr<kovri::client::Stream> m_SpareStream;
+  bool m_SpareStreamPending;
 };
 
 // TODO(anonimal): more documentation
@@ -92,6 +92,7 @@ void Configuration::ParseConfig()
           tunnel.address =
               value.get<std::string>(GetAttribute(Key::Address), "127.0.0.1");
           tunnel.port = value.get<std::uint16_t>(GetAttribute(Key::Port));
+          tunnel.hops = value.get<std::int16_t>(GetAttribute(Key::Hops), -1);
 
           // Test which type of tunnel (client or server), add unique attributes
           if (tunnel.type == GetAttribute(Key::Client)
@@ -213,6 +214,9 @@ const std::string Configuration::GetAttribute(Key key) const
       case Key::Keys:
         return "keys";
         break;
+      case Key::Hops:
+        return "hops";
+        break;
       default:
         return "";  // not needed (avoids nagging -Wreturn-type)
         break;
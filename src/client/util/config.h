@@ -96,6 +96,11 @@ enum struct Key : std::uint8_t
   /// @brief Key for client tunnel identity
   ///   or file with LeaseSet of local service I2P address
   Keys,
+  /// @var Hops
+  /// @brief Key for tunnel length of the tunnel's local destination.
+  ///   0 builds zero-hop tunnels (no anonymity, near-direct latency);
+  ///   unset keeps the I2CP default length
+  Hops,
 };
 
 /// @class Configuration
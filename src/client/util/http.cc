@@ -54,6 +54,21 @@ namespace client {
 
 namespace http = boost::network::http;
 
+std::mutex HTTP::m_ClientsMutex;
+std::map<std::string, std::shared_ptr<HTTP::Client>> HTTP::m_Clients;
+
+std::shared_ptr<HTTP::Client> HTTP::AcquireClient(
+    const std::string& host,
+    const Options& options) {
+  std::unique_lock<std::mutex> l(m_ClientsMutex);
+  auto it = m_Clients.find(host);
+  if (it != m_Clients.end())
+    return it->second;
+  auto client = std::make_shared<Client>(options);
+  m_Clients[host] = client;
+  return client;
+}
+
 // TODO(unassigned): currently unused but will be useful
 // without needing to create a new object for each given URI
 bool HTTP::Download(
@@ -67,6 +82,8 @@ bool HTTP::Download() {
     LOG(error) << "URI: invalid URI";
     return false;
   }
+  SetNotModified(false);  // Only a fresh 304 response may set this
+  m_PartialContent = false;  // Only a fresh 206 response may set this
   // TODO(anonimal): ideally, we simply swapout the request/response handler
   // with cpp-netlib so we don't need two separate functions
   if (HostIsI2P())
@@ -146,8 +163,9 @@ bool HTTP::DownloadViaClearnet() {
       LOG(warning) << "HTTP: not using HTTPS";
     }
 
-  // Create client with options
-  Client client(options);
+  // Reuse the per-host keep-alive client (options only matter on first
+  // use per host: they carry that host's certificate and SNI settings)
+  auto client = AcquireClient(uri.host(), options);
   // TODO(unassigned): this top try block is specifically for Windows and ARMv8
   // but is harmless for all platforms (see #453 and cpp-netlib/cpp-netlib#696)
   try {
@@ -156,6 +174,13 @@ bool HTTP::DownloadViaClearnet() {
       Request request(uri.string());  // A fully-qualified, completed URI
       // Add required Java I2P defined user-agent
       request << boost::network::header("User-Agent", "Wget/1.11.4");
+      // Ask for the remainder only when resuming a truncated transfer
+      if (m_ResumeOffset)
+        {
+          LOG(debug) << "HTTP: resuming from byte " << m_ResumeOffset;
+          request << boost::network::header(
+              "Range", "bytes=" + std::to_string(m_ResumeOffset) + "-");
+        }
       // Are we requesting the same file?
       if (uri.path() == GetPreviousPath()) {
           LOG(debug) << "HTTP: Same URI already requested";
@@ -180,7 +205,7 @@ bool HTTP::DownloadViaClearnet() {
       }
       // Create response object, send request and receive response
       LOG(trace) << "HTTP: Request " << kovri::core::LogNetMessageToString(request);
-      Response response = client.get(request);
+      Response response = client->get(request);
       LOG(trace) << "HTTP: Response " << kovri::core::LogNetMessageToString(response);
       // Test HTTP response status code
       switch (response.status()) {
@@ -200,9 +225,15 @@ bool HTTP::DownloadViaClearnet() {
           // Save downloaded content
           SetDownloadedContents(boost::network::http::body(response));
           break;
+        // Ranged resume honored: body is the remainder from the offset
+        case 206:
+          m_PartialContent = true;
+          SetDownloadedContents(boost::network::http::body(response));
+          break;
         // File requested is unchanged since previous download
         case http::basic_response<http::tags::http_server>::status_type::not_modified:
           LOG(info) << "HTTP: no new updates available from " << uri.host();
+          SetNotModified(true);
           break;
         // Useless response code
         default:
@@ -387,6 +418,7 @@ bool HTTP::ProcessI2PResponse() {
 		http::basic_response<http::tags::http_server>::
 			status_type::not_modified) {
     LOG(info) << "HTTP: no new updates available from " << GetURI().host();
+    SetNotModified(true);
   } else {
     LOG(warning) << "HTTP: response code: " << response_code;
     return false;
@@ -41,6 +41,8 @@
 #include <fstream>
 #include <iosfwd>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <sstream>
 #include <string>
@@ -105,6 +107,21 @@ class HTTPStorage {
     return m_LastModified;
   }
 
+  /// @brief Record whether the server answered 304 Not Modified
+  /// @notes Cleared at the start of every download attempt
+  void SetNotModified(
+      bool not_modified) {
+    m_NotModified = not_modified;
+  }
+
+  /// @brief Did the last conditional request answer 304 Not Modified?
+  /// @return True if the cached copy is still current
+  /// @notes Consumers can then skip re-processing the unchanged contents
+  bool IsNotModified() const
+  {
+    return m_NotModified;
+  }
+
   /// @brief Sets downloaded contents to stream
   /// @notes Called after completed download
   void SetDownloadedContents(
@@ -136,6 +153,10 @@ class HTTPStorage {
   /// @notes Used primarily for subscriptions. Can be extended to auto-update
   std::string m_LastModified;
 
+  /// @var m_NotModified
+  /// @brief Whether the last conditional request answered 304 Not Modified
+  bool m_NotModified = false;
+
   /// @var m_Stream
   /// @brief Downloaded contents
   std::string m_Stream;  // TODO(anonimal): consider refactoring into an actual stream
@@ -194,6 +215,23 @@ class HTTP : public HTTPStorage {
   /// @return False on failure
   bool Download();
 
+  /// @brief Requests only bytes from offset onward on the next download
+  ///   (ranged resume of an earlier truncated transfer)
+  /// @param offset Bytes the caller already holds
+  void SetResumeOffset(std::size_t offset)
+  {
+    m_ResumeOffset = offset;
+  }
+
+  /// @return True when the server answered 206 Partial Content, i.e.
+  ///   the downloaded contents are a tail to append at the resume offset
+  /// @notes A server without range support answers 200 with the whole
+  ///   file, in which case this stays false and the contents are complete
+  bool IsPartialContent() const
+  {
+    return m_PartialContent;
+  }
+
  private:
   /// @brief Set default ports for in-net downloading
   /// @notes The default port is 80, for HTTPS it is 443
@@ -214,6 +252,14 @@ class HTTP : public HTTPStorage {
   /// @brief cpp-netlib URI instance
   boost::network::uri::uri m_URI;
 
+  /// @var m_ResumeOffset
+  /// @brief Byte offset for a ranged request, 0 for a full download
+  std::size_t m_ResumeOffset = 0;
+
+  /// @var m_PartialContent
+  /// @brief Whether the last response was 206 Partial Content
+  bool m_PartialContent = false;
+
   // TODO(anonimal): consider removing typedefs after refactor
   // TODO(anonimal): remove the following notes after refactor
 
@@ -233,6 +279,18 @@ class HTTP : public HTTPStorage {
   /// @notes Currently only applies to clearnet download
   typedef boost::network::http::client::response Response;
 
+  /// @brief Returns the shared keep-alive client for host, creating it on
+  ///   first use. cpp-netlib clients persist their underlying connections
+  ///   between requests, so every consumer of the same host (address book
+  ///   refresh, reseed fallback) skips repeated TCP/TLS handshakes
+  static std::shared_ptr<Client> AcquireClient(
+      const std::string& host,
+      const Options& options);
+
+  /// @brief Keep-alive clients keyed by host, shared across HTTP instances
+  static std::mutex m_ClientsMutex;
+  static std::map<std::string, std::shared_ptr<Client>> m_Clients;
+
  public:
   // TODO(anonimal): remove after refactor
   /// @brief Prepares header for in-net request
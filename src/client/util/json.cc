@@ -31,7 +31,10 @@
 
 #include "client/util/json.h"
 
+#include <cctype>
 #include <iomanip>
+#include <stdexcept>
+#include <utility>
 
 namespace kovri
 {
@@ -108,5 +111,278 @@ std::string JsonObject::ToString() const {
   return oss.str();
 }
 
+namespace {
+
+/// @class JsonReader
+/// @brief Recursive-descent JSON parser producing read_json's tree layout
+class JsonReader {
+ public:
+  JsonReader(const char* begin, const char* end)
+      : m_Cur(begin),
+        m_End(end) {}
+
+  boost::property_tree::ptree Parse() {
+    SkipSpace();
+    if (m_Cur == m_End || (*m_Cur != '{' && *m_Cur != '['))
+      Fail("document root must be an object or array");
+    auto tree = ParseValue(0);
+    SkipSpace();
+    if (m_Cur != m_End)
+      Fail("trailing characters after document");
+    return tree;
+  }
+
+ private:
+  typedef boost::property_tree::ptree ptree;
+
+  /// @brief Nesting cap; malformed (e.g. fuzzed) documents must not be
+  ///   able to exhaust the stack through recursion
+  enum { MaxDepth = 128 };
+
+  void Fail(const char* what) const {
+    throw std::runtime_error(std::string("JsonReader: ") + what);
+  }
+
+  void SkipSpace() {
+    while (m_Cur != m_End
+           && (*m_Cur == ' ' || *m_Cur == '\t' || *m_Cur == '\r'
+               || *m_Cur == '\n'))
+      ++m_Cur;
+  }
+
+  char Next() {
+    if (m_Cur == m_End)
+      Fail("unexpected end of document");
+    return *m_Cur++;
+  }
+
+  void Expect(char c) {
+    if (Next() != c)
+      Fail("unexpected character");
+  }
+
+  ptree ParseValue(unsigned depth) {
+    if (depth > MaxDepth)
+      Fail("nesting too deep");
+    SkipSpace();
+    if (m_Cur == m_End)
+      Fail("unexpected end of document");
+    switch (*m_Cur) {
+      case '{':
+        return ParseObject(depth);
+      case '[':
+        return ParseArray(depth);
+      case '"': {
+        ptree tree;
+        tree.put_value(ParseString());
+        return tree;
+      }
+      default: {
+        ptree tree;
+        tree.put_value(ParseLiteral());
+        return tree;
+      }
+    }
+  }
+
+  ptree ParseObject(unsigned depth) {
+    ptree tree;
+    ++m_Cur;  // '{'
+    SkipSpace();
+    if (m_Cur != m_End && *m_Cur == '}') {
+      ++m_Cur;
+      return tree;
+    }
+    for (;;) {
+      SkipSpace();
+      if (m_Cur == m_End || *m_Cur != '"')
+        Fail("expected member name");
+      std::string key = ParseString();
+      SkipSpace();
+      Expect(':');
+      tree.push_back(std::make_pair(key, ParseValue(depth + 1)));
+      SkipSpace();
+      char const c = Next();
+      if (c == '}')
+        return tree;
+      if (c != ',')
+        Fail("expected ',' or '}'");
+    }
+  }
+
+  ptree ParseArray(unsigned depth) {
+    ptree tree;
+    ++m_Cur;  // '['
+    SkipSpace();
+    if (m_Cur != m_End && *m_Cur == ']') {
+      ++m_Cur;
+      return tree;
+    }
+    for (;;) {
+      tree.push_back(std::make_pair(std::string(), ParseValue(depth + 1)));
+      SkipSpace();
+      char const c = Next();
+      if (c == ']')
+        return tree;
+      if (c != ',')
+        Fail("expected ',' or ']'");
+    }
+  }
+
+  std::string ParseString() {
+    Expect('"');
+    std::string out;
+    for (;;) {
+      char const c = Next();
+      if (c == '"')
+        return out;
+      if (static_cast<unsigned char>(c) < 0x20)
+        Fail("unescaped control character in string");
+      if (c != '\\') {
+        out.push_back(c);
+        continue;
+      }
+      char const escape = Next();
+      switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+          out.push_back(escape);
+          break;
+        case 'b':
+          out.push_back('\b');
+          break;
+        case 'f':
+          out.push_back('\f');
+          break;
+        case 'n':
+          out.push_back('\n');
+          break;
+        case 'r':
+          out.push_back('\r');
+          break;
+        case 't':
+          out.push_back('\t');
+          break;
+        case 'u':
+          AppendCodePoint(out);
+          break;
+        default:
+          Fail("invalid escape sequence");
+      }
+    }
+  }
+
+  unsigned ReadHex4() {
+    unsigned value = 0;
+    for (int i = 0; i < 4; i++) {
+      char const c = Next();
+      value <<= 4;
+      if (c >= '0' && c <= '9')
+        value |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+        value |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+        value |= c - 'A' + 10;
+      else
+        Fail("invalid \\u escape");
+    }
+    return value;
+  }
+
+  /// @brief Decodes \uXXXX (combining surrogate pairs) to UTF-8
+  void AppendCodePoint(std::string& out) {
+    unsigned cp = ReadHex4();
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+      Expect('\\');
+      Expect('u');
+      unsigned const low = ReadHex4();
+      if (low < 0xDC00 || low > 0xDFFF)
+        Fail("invalid surrogate pair");
+      cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+      Fail("lone surrogate");
+    }
+    if (cp < 0x80) {
+      out.push_back(cp);
+    } else if (cp < 0x800) {
+      out.push_back(0xC0 | (cp >> 6));
+      out.push_back(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+      out.push_back(0xE0 | (cp >> 12));
+      out.push_back(0x80 | ((cp >> 6) & 0x3F));
+      out.push_back(0x80 | (cp & 0x3F));
+    } else {
+      out.push_back(0xF0 | (cp >> 18));
+      out.push_back(0x80 | ((cp >> 12) & 0x3F));
+      out.push_back(0x80 | ((cp >> 6) & 0x3F));
+      out.push_back(0x80 | (cp & 0x3F));
+    }
+  }
+
+  /// @return Literal token (number, true, false or null) as its
+  ///   document text, matching read_json's scalar mapping
+  std::string ParseLiteral() {
+    const char* const start = m_Cur;
+    while (m_Cur != m_End
+           && (std::isalnum(static_cast<unsigned char>(*m_Cur)) || *m_Cur == '-'
+               || *m_Cur == '+' || *m_Cur == '.'))
+      ++m_Cur;
+    std::string token(start, m_Cur);
+    if (token == "true" || token == "false" || token == "null")
+      return token;
+    if (!IsNumber(token))
+      Fail("invalid literal");
+    return token;
+  }
+
+  static bool IsNumber(const std::string& token) {
+    std::size_t pos = 0;
+    std::size_t const len = token.size();
+    if (pos < len && token[pos] == '-')
+      pos++;
+    std::size_t digits = 0;
+    while (pos < len && token[pos] >= '0' && token[pos] <= '9') {
+      pos++;
+      digits++;
+    }
+    if (!digits)
+      return false;
+    if (pos < len && token[pos] == '.') {
+      pos++;
+      digits = 0;
+      while (pos < len && token[pos] >= '0' && token[pos] <= '9') {
+        pos++;
+        digits++;
+      }
+      if (!digits)
+        return false;
+    }
+    if (pos < len && (token[pos] == 'e' || token[pos] == 'E')) {
+      pos++;
+      if (pos < len && (token[pos] == '+' || token[pos] == '-'))
+        pos++;
+      digits = 0;
+      while (pos < len && token[pos] >= '0' && token[pos] <= '9') {
+        pos++;
+        digits++;
+      }
+      if (!digits)
+        return false;
+    }
+    return pos == len;
+  }
+
+  const char* m_Cur;
+  const char* m_End;
+};
+
+}  // namespace
+
+boost::property_tree::ptree ParseJson(const std::string& input) {
+  JsonReader reader(input.data(), input.data() + input.size());
+  return reader.Parse();
+}
+
 }  // namespace client
 }  // namespace kovri
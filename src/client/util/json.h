@@ -85,6 +85,20 @@ class JsonObject {
 
 std::ostream& operator<<(std::ostream& os, const JsonObject&);
 
+/**
+ * @brief Parses a JSON document into a property tree laid out as
+ *   boost's read_json would: object members become named children,
+ *   array elements unnamed children, and scalars keep their literal
+ *   text as the node value.
+ * @details Single recursive-descent pass with a nesting cap; avoids
+ *   instantiating the property_tree JSON grammar per call, which
+ *   dominates 1-second I2PControl polling.
+ * @param input Complete JSON document (the root must be an object or array)
+ * @return Parsed tree
+ * @throw std::runtime_error on malformed input or excessive nesting
+ */
+boost::property_tree::ptree ParseJson(const std::string& input);
+
 }  // namespace client
 }  // namespace kovri
 
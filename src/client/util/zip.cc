@@ -212,9 +212,20 @@ bool ZIP::DecompressLocalFile() {
                   m_Data->crc_32.data(),
                   m_Data->uncompressed.data(),
                   m_Data->uncompressed.size()))) {  // Checksum passed
-            // Store/map the uncompressed file
-            m_Contents.insert(
-                { m_Data->local_file_count, std::move(m_Data->uncompressed) });
+            if (m_Handler) {
+              // Hand the uncompressed file straight to the consumer
+              if (!m_Handler(
+                      m_Data->uncompressed.data(),
+                      m_Data->uncompressed.size())) {
+                LOG(error) << "ZIP: content handler failed";
+                return false;
+              }
+            } else {
+              // Store/map the uncompressed file
+              m_Contents.insert(
+                  { m_Data->local_file_count,
+                    std::move(m_Data->uncompressed) });
+            }
           } else {
             LOG(error) << "ZIP: CRC-32 Failed";
             return false;
@@ -229,9 +240,19 @@ bool ZIP::DecompressLocalFile() {
       }
       case static_cast<std::size_t>(Method::stored): {
         LOG(debug) << "ZIP: file uses compression method 'stored'";
-        // Store/map the local file as-is
-        m_Contents.insert(
-            { m_Data->local_file_count, std::move(m_Data->compressed) });
+        if (m_Handler) {
+          // Hand the local file straight to the consumer
+          if (!m_Handler(
+                  m_Data->compressed.data(),
+                  m_Data->compressed.size())) {
+            LOG(error) << "ZIP: content handler failed";
+            return false;
+          }
+        } else {
+          // Store/map the local file as-is
+          m_Contents.insert(
+              { m_Data->local_file_count, std::move(m_Data->compressed) });
+        }
         break;
       }
       default:
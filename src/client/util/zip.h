@@ -34,7 +34,9 @@
 #define SRC_CLIENT_UTIL_ZIP_H_
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -78,6 +80,18 @@ class ZIP {
   /// @param Local file content
   std::unordered_map<std::size_t, std::vector<std::uint8_t>> m_Contents;
 
+  /// @brief Handler receiving each extracted file as it is decompressed;
+  ///   a false return aborts unzipping
+  typedef std::function<bool (const std::uint8_t* data, std::size_t len)>
+      ContentHandler;
+
+  /// @brief Streams extracted files to handler as they are decompressed
+  ///   instead of buffering them all in m_Contents; call before Unzip
+  void SetContentHandler(
+      const ContentHandler& handler) {
+    m_Handler = handler;
+  }
+
   /// @brief Unzip'ing implementation
   /// @return false on failure
   bool Unzip();
@@ -157,6 +171,9 @@ class ZIP {
   // ZIP spec-defined data
   std::unique_ptr<Data> m_Data;
 
+  // Streaming consumer for extracted files (optional)
+  ContentHandler m_Handler;
+
   kovri::core::Exception m_Exception;
 };
 
@@ -0,0 +1,122 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_CRYPTO_AEAD_H_
+#define SRC_CORE_CRYPTO_AEAD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// NIST SP 800-38D (GCM)
+// https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication800-38d.pdf
+
+namespace kovri {
+namespace core {
+
+/// @enum AEADSize
+/// @brief Sizes for AES-256-GCM framing
+enum AEADSize : std::uint8_t
+{
+  Key = 32,
+  Nonce = 12,
+  Tag = 16,
+};
+
+/// @class AEADEncryption
+/// @brief AES-256-GCM sealing: one pass over the payload produces
+///   ciphertext plus a 16-byte tag, hardware-accelerated where AES-NI and
+///   CLMUL are available. Replaces separate encrypt + digest passes on
+///   the transport framing path
+class AEADEncryption {
+ public:
+  AEADEncryption();
+  ~AEADEncryption();
+
+  void SetKey(
+      const std::uint8_t* key);
+
+  /// @brief Seals len payload bytes under the given nonce
+  /// @param nonce Nonce (Nonce bytes, must never repeat under one key)
+  /// @param ad Additional authenticated data (may be nullptr when empty)
+  /// @param ad_len Additional data length
+  /// @param in Payload
+  /// @param len Payload length
+  /// @param out Receives len ciphertext bytes followed by the Tag bytes
+  void Encrypt(
+      const std::uint8_t* nonce,
+      const std::uint8_t* ad,
+      std::size_t ad_len,
+      const std::uint8_t* in,
+      std::size_t len,
+      std::uint8_t* out);
+
+ private:
+  class AEADEncryptionImpl;
+  std::unique_ptr<AEADEncryptionImpl> m_AEADEncryptionPimpl;
+};
+
+/// @class AEADDecryption
+/// @brief AES-256-GCM opening, verifying the trailing tag
+class AEADDecryption {
+ public:
+  AEADDecryption();
+  ~AEADDecryption();
+
+  void SetKey(
+      const std::uint8_t* key);
+
+  /// @brief Opens len ciphertext+tag bytes under the given nonce
+  /// @param nonce Nonce (Nonce bytes)
+  /// @param ad Additional authenticated data (may be nullptr when empty)
+  /// @param ad_len Additional data length
+  /// @param in Ciphertext followed by the Tag bytes
+  /// @param len Total input length including the tag
+  /// @param out Receives len - Tag payload bytes
+  /// @return False when authentication fails (out is undefined)
+  bool Decrypt(
+      const std::uint8_t* nonce,
+      const std::uint8_t* ad,
+      std::size_t ad_len,
+      const std::uint8_t* in,
+      std::size_t len,
+      std::uint8_t* out);
+
+ private:
+  class AEADDecryptionImpl;
+  std::unique_ptr<AEADDecryptionImpl> m_AEADDecryptionPimpl;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_CRYPTO_AEAD_H_
@@ -0,0 +1,163 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_CRYPTO_CIPHER_POOL_H_
+#define SRC_CORE_CRYPTO_CIPHER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "core/crypto/aes.h"
+
+namespace kovri {
+namespace core {
+
+/// @brief Max idle contexts cached per direction; released contexts
+///   beyond this are simply freed
+const std::size_t CIPHER_POOL_MAX_IDLE = 64;
+
+/// @class CBCCipherPool
+/// @brief Recycles AES-CBC cipher contexts across sessions and packets.
+///   CBCEncryption/CBCDecryption allocate their implementation through a
+///   pimpl on every construction, so building one per session (or worse,
+///   per packet) pays a heap allocation plus a fresh key schedule each
+///   time. Released contexts are cached keyed by the AES key they were
+///   last scheduled with: re-acquiring with the same session key skips
+///   both costs, any other key still skips the allocation.
+class CBCCipherPool {
+ public:
+  /// @brief Pops a context already scheduled with key when one is cached,
+  ///   otherwise reschedules an idle context (or allocates a fresh one)
+  std::unique_ptr<CBCEncryption> AcquireEncryption(
+      const AESKey& key);
+
+  std::unique_ptr<CBCDecryption> AcquireDecryption(
+      const AESKey& key);
+
+  /// @brief Returns a context to the pool under the key it is scheduled with
+  void Release(
+      const AESKey& key,
+      std::unique_ptr<CBCEncryption> cipher);
+
+  void Release(
+      const AESKey& key,
+      std::unique_ptr<CBCDecryption> cipher);
+
+ private:
+  mutable std::mutex m_Mutex;
+  std::multimap<AESKey, std::unique_ptr<CBCEncryption>> m_IdleEncryption;
+  std::multimap<AESKey, std::unique_ptr<CBCDecryption>> m_IdleDecryption;
+};
+
+/// @brief Process-wide cipher context pool shared by the transports
+extern CBCCipherPool cipher_pool;
+
+/// @class PooledCBCEncryption
+/// @brief Drop-in replacement for a CBCEncryption member or local: holds a
+///   pooled context for its lifetime and returns it on destruction.
+///   Default construction acquires nothing; a key must be set through
+///   Rekey (or a keyed constructor) before the forwarding calls are used
+class PooledCBCEncryption {
+ public:
+  PooledCBCEncryption() {}
+
+  explicit PooledCBCEncryption(
+      const AESKey& key);
+
+  PooledCBCEncryption(
+      const AESKey& key,
+      const std::uint8_t* iv);
+
+  ~PooledCBCEncryption();
+
+  PooledCBCEncryption(const PooledCBCEncryption&) = delete;
+  PooledCBCEncryption& operator=(const PooledCBCEncryption&) = delete;
+
+  /// @brief (Re)schedules the held context with a new session key,
+  ///   acquiring one from the pool on first use
+  void Rekey(
+      const AESKey& key);
+
+  void SetIV(
+      const std::uint8_t* iv);
+
+  void Encrypt(
+      const std::uint8_t* in,
+      std::size_t len,
+      std::uint8_t* out);
+
+ private:
+  AESKey m_Key;
+  std::unique_ptr<CBCEncryption> m_Cipher;
+};
+
+/// @class PooledCBCDecryption
+/// @brief Decryption counterpart of PooledCBCEncryption
+class PooledCBCDecryption {
+ public:
+  PooledCBCDecryption() {}
+
+  explicit PooledCBCDecryption(
+      const AESKey& key);
+
+  PooledCBCDecryption(
+      const AESKey& key,
+      const std::uint8_t* iv);
+
+  ~PooledCBCDecryption();
+
+  PooledCBCDecryption(const PooledCBCDecryption&) = delete;
+  PooledCBCDecryption& operator=(const PooledCBCDecryption&) = delete;
+
+  /// @brief (Re)schedules the held context with a new session key,
+  ///   acquiring one from the pool on first use
+  void Rekey(
+      const AESKey& key);
+
+  void SetIV(
+      const std::uint8_t* iv);
+
+  void Decrypt(
+      const std::uint8_t* in,
+      std::size_t len,
+      std::uint8_t* out);
+
+ private:
+  AESKey m_Key;
+  std::unique_ptr<CBCDecryption> m_Cipher;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_CRYPTO_CIPHER_POOL_H_
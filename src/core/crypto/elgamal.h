@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_CRYPTO_ELGAMAL_H_
 #define SRC_CORE_CRYPTO_ELGAMAL_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -57,6 +58,15 @@ class ElGamalEncryption {
   std::unique_ptr<ElGamalEncryptionImpl> m_ElGamalEncryptionPimpl;
 };
 
+/// @brief Pre-generates up to count ephemeral (k, g^k) pairs into a shared
+///   pool during idle time; ElGamalEncryption construction then only has to
+///   compute y^k, roughly halving its bignum cost
+void PrecomputeElGamal(
+    std::size_t count);
+
+/// @brief Number of precomputed (k, g^k) pairs currently pooled
+std::size_t GetNumPrecomputedElGamal();
+
 bool ElGamalDecrypt(
     const std::uint8_t* key,
     const std::uint8_t* encrypted,
@@ -98,6 +98,14 @@ class SHA256 {
   std::unique_ptr<SHA256Impl> m_SHA256Pimpl;
 };
 
+/// @brief The calling thread's reusable SHA256 context
+/// @details Hot per-message paths (I2NP checksums, tunnel message
+///   digests) hash through this instead of constructing a fresh SHA256,
+///   which allocates its implementation through a pimpl every time.
+///   Hardware acceleration (SHA-NI/AVX2) is the implementation's runtime
+///   dispatch concern and applies here automatically where available
+SHA256& ThreadLocalSHA256();
+
 /// @class SHA512
 class SHA512 {
  public:
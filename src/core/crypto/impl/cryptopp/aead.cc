@@ -0,0 +1,157 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "core/crypto/aead.h"
+
+#include <cryptopp/aes.h>
+#include <cryptopp/filters.h>
+#include <cryptopp/gcm.h>
+#include <cryptopp/secblock.h>
+
+namespace kovri {
+namespace core {
+
+/// @class AEADEncryptionImpl
+/// @brief AES-256-GCM sealing implementation
+class AEADEncryption::AEADEncryptionImpl {
+ public:
+  void SetKey(
+      const std::uint8_t* key) {
+    m_Key.Assign(key, AEADSize::Key);
+  }
+
+  void Encrypt(
+      const std::uint8_t* nonce,
+      const std::uint8_t* ad,
+      std::size_t ad_len,
+      const std::uint8_t* in,
+      std::size_t len,
+      std::uint8_t* out) {
+    m_Encryption.SetKeyWithIV(
+        m_Key.data(), m_Key.size(), nonce, AEADSize::Nonce);
+    if (ad_len)
+      m_Encryption.Update(ad, ad_len);
+    m_Encryption.ProcessData(out, in, len);
+    m_Encryption.TruncatedFinal(out + len, AEADSize::Tag);
+  }
+
+ private:
+  CryptoPP::SecByteBlock m_Key;
+  CryptoPP::GCM<CryptoPP::AES>::Encryption m_Encryption;
+};
+
+AEADEncryption::AEADEncryption()
+    : m_AEADEncryptionPimpl(
+          std::make_unique<AEADEncryptionImpl>()) {}
+
+AEADEncryption::~AEADEncryption() {}
+
+void AEADEncryption::SetKey(
+    const std::uint8_t* key) {
+  m_AEADEncryptionPimpl->SetKey(key);
+}
+
+void AEADEncryption::Encrypt(
+    const std::uint8_t* nonce,
+    const std::uint8_t* ad,
+    std::size_t ad_len,
+    const std::uint8_t* in,
+    std::size_t len,
+    std::uint8_t* out) {
+  m_AEADEncryptionPimpl->Encrypt(nonce, ad, ad_len, in, len, out);
+}
+
+/// @class AEADDecryptionImpl
+/// @brief AES-256-GCM opening implementation
+class AEADDecryption::AEADDecryptionImpl {
+ public:
+  void SetKey(
+      const std::uint8_t* key) {
+    m_Key.Assign(key, AEADSize::Key);
+  }
+
+  bool Decrypt(
+      const std::uint8_t* nonce,
+      const std::uint8_t* ad,
+      std::size_t ad_len,
+      const std::uint8_t* in,
+      std::size_t len,
+      std::uint8_t* out) {
+    if (len < AEADSize::Tag)
+      return false;
+    m_Decryption.SetKeyWithIV(
+        m_Key.data(), m_Key.size(), nonce, AEADSize::Nonce);
+    try {
+      CryptoPP::AuthenticatedDecryptionFilter filter(
+          m_Decryption,
+          new CryptoPP::ArraySink(out, len - AEADSize::Tag),
+          CryptoPP::AuthenticatedDecryptionFilter::MAC_AT_END
+              | CryptoPP::AuthenticatedDecryptionFilter::THROW_EXCEPTION,
+          AEADSize::Tag);
+      if (ad_len)
+        filter.ChannelPut(CryptoPP::AAD_CHANNEL, ad, ad_len);
+      filter.ChannelPut(CryptoPP::DEFAULT_CHANNEL, in, len);
+      filter.ChannelMessageEnd(CryptoPP::DEFAULT_CHANNEL);
+    } catch (const CryptoPP::Exception&) {
+      return false;  // tag mismatch
+    }
+    return true;
+  }
+
+ private:
+  CryptoPP::SecByteBlock m_Key;
+  CryptoPP::GCM<CryptoPP::AES>::Decryption m_Decryption;
+};
+
+AEADDecryption::AEADDecryption()
+    : m_AEADDecryptionPimpl(
+          std::make_unique<AEADDecryptionImpl>()) {}
+
+AEADDecryption::~AEADDecryption() {}
+
+void AEADDecryption::SetKey(
+    const std::uint8_t* key) {
+  m_AEADDecryptionPimpl->SetKey(key);
+}
+
+bool AEADDecryption::Decrypt(
+    const std::uint8_t* nonce,
+    const std::uint8_t* ad,
+    std::size_t ad_len,
+    const std::uint8_t* in,
+    std::size_t len,
+    std::uint8_t* out) {
+  return m_AEADDecryptionPimpl->Decrypt(nonce, ad, ad_len, in, len, out);
+}
+
+}  // namespace core
+}  // namespace kovri
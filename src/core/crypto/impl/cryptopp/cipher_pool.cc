@@ -0,0 +1,186 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/crypto/cipher_pool.h"
+
+#include <utility>
+
+namespace kovri {
+namespace core {
+
+// Simply instantiating in namespace scope ties into, and is limited by, the current singleton design
+CBCCipherPool cipher_pool;
+
+std::unique_ptr<CBCEncryption> CBCCipherPool::AcquireEncryption(
+    const AESKey& key) {
+  std::unique_ptr<CBCEncryption> cipher;
+  bool scheduled = false;
+  {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    auto it = m_IdleEncryption.find(key);
+    if (it != m_IdleEncryption.end()) {
+      scheduled = true;  // key schedule still valid for this key
+    } else if (!m_IdleEncryption.empty()) {
+      it = m_IdleEncryption.begin();
+    }
+    if (it != m_IdleEncryption.end()) {
+      cipher = std::move(it->second);
+      m_IdleEncryption.erase(it);
+    }
+  }
+  if (!cipher)
+    cipher = std::make_unique<CBCEncryption>();
+  if (!scheduled)
+    cipher->SetKey(key);
+  return cipher;
+}
+
+std::unique_ptr<CBCDecryption> CBCCipherPool::AcquireDecryption(
+    const AESKey& key) {
+  std::unique_ptr<CBCDecryption> cipher;
+  bool scheduled = false;
+  {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    auto it = m_IdleDecryption.find(key);
+    if (it != m_IdleDecryption.end()) {
+      scheduled = true;  // key schedule still valid for this key
+    } else if (!m_IdleDecryption.empty()) {
+      it = m_IdleDecryption.begin();
+    }
+    if (it != m_IdleDecryption.end()) {
+      cipher = std::move(it->second);
+      m_IdleDecryption.erase(it);
+    }
+  }
+  if (!cipher)
+    cipher = std::make_unique<CBCDecryption>();
+  if (!scheduled)
+    cipher->SetKey(key);
+  return cipher;
+}
+
+void CBCCipherPool::Release(
+    const AESKey& key,
+    std::unique_ptr<CBCEncryption> cipher) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (m_IdleEncryption.size() >= CIPHER_POOL_MAX_IDLE)
+    return;  // cipher freed on scope exit
+  m_IdleEncryption.emplace(key, std::move(cipher));
+}
+
+void CBCCipherPool::Release(
+    const AESKey& key,
+    std::unique_ptr<CBCDecryption> cipher) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (m_IdleDecryption.size() >= CIPHER_POOL_MAX_IDLE)
+    return;  // cipher freed on scope exit
+  m_IdleDecryption.emplace(key, std::move(cipher));
+}
+
+PooledCBCEncryption::PooledCBCEncryption(
+    const AESKey& key)
+    : m_Key(key),
+      m_Cipher(cipher_pool.AcquireEncryption(key)) {}
+
+PooledCBCEncryption::PooledCBCEncryption(
+    const AESKey& key,
+    const std::uint8_t* iv)
+    : PooledCBCEncryption(key) {
+  m_Cipher->SetIV(iv);
+}
+
+PooledCBCEncryption::~PooledCBCEncryption() {
+  if (m_Cipher)
+    cipher_pool.Release(m_Key, std::move(m_Cipher));
+}
+
+void PooledCBCEncryption::Rekey(
+    const AESKey& key) {
+  if (!m_Cipher) {
+    m_Cipher = cipher_pool.AcquireEncryption(key);
+  } else {
+    m_Cipher->SetKey(key);
+  }
+  m_Key = key;
+}
+
+void PooledCBCEncryption::SetIV(
+    const std::uint8_t* iv) {
+  m_Cipher->SetIV(iv);
+}
+
+void PooledCBCEncryption::Encrypt(
+    const std::uint8_t* in,
+    std::size_t len,
+    std::uint8_t* out) {
+  m_Cipher->Encrypt(in, len, out);
+}
+
+PooledCBCDecryption::PooledCBCDecryption(
+    const AESKey& key)
+    : m_Key(key),
+      m_Cipher(cipher_pool.AcquireDecryption(key)) {}
+
+PooledCBCDecryption::PooledCBCDecryption(
+    const AESKey& key,
+    const std::uint8_t* iv)
+    : PooledCBCDecryption(key) {
+  m_Cipher->SetIV(iv);
+}
+
+PooledCBCDecryption::~PooledCBCDecryption() {
+  if (m_Cipher)
+    cipher_pool.Release(m_Key, std::move(m_Cipher));
+}
+
+void PooledCBCDecryption::Rekey(
+    const AESKey& key) {
+  if (!m_Cipher) {
+    m_Cipher = cipher_pool.AcquireDecryption(key);
+  } else {
+    m_Cipher->SetKey(key);
+  }
+  m_Key = key;
+}
+
+void PooledCBCDecryption::SetIV(
+    const std::uint8_t* iv) {
+  m_Cipher->SetIV(iv);
+}
+
+void PooledCBCDecryption::Decrypt(
+    const std::uint8_t* in,
+    std::size_t len,
+    std::uint8_t* out) {
+  m_Cipher->Decrypt(in, len, out);
+}
+
+}  // namespace core
+}  // namespace kovri
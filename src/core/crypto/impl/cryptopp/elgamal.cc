@@ -37,6 +37,8 @@
 #include <cryptopp/sha.h>
 
 #include <array>
+#include <mutex>
+#include <vector>
 
 #include "crypto_const.h"
 
@@ -48,17 +50,113 @@
 namespace kovri {
 namespace core {
 
+namespace {
+
+/// @class FixedBaseElGamal
+/// @brief Radix-2^4 fixed-base exponentiation for the ElGamal group
+///   generator: g and p are protocol constants, so g^(j * 16^i) mod p
+///   is tabulated once and g^k costs one modular multiplication per
+///   non-zero exponent nibble (~512) instead of a full generic modexp
+///   (~2400 multiplications). The table is ~2 MB and is built on first
+///   use, which the idle-time precompute pool triggers at startup
+class FixedBaseElGamal {
+ public:
+  static FixedBaseElGamal& Instance() {
+    static FixedBaseElGamal table;
+    return table;
+  }
+
+  /// @return g^exponent mod p
+  CryptoPP::Integer Exponentiate(const CryptoPP::Integer& exponent) const {
+    CryptoPP::Integer result = CryptoPP::Integer::One();
+    for (std::size_t i = 0; i < Blocks; i++) {
+      unsigned const nibble = exponent.GetBits(i * Window, Window);
+      if (nibble)
+        result =
+          a_times_b_mod_c(result, m_Table[i * Entries + nibble - 1], elgp);
+    }
+    return result;
+  }
+
+ private:
+  enum : std::size_t {
+    Window = 4,  // exponent bits consumed per block
+    Blocks = 512,  // covers the full 2048-bit exponent range
+    Entries = 15,  // g^(j * 16^i) for j = 1..15
+  };
+
+  FixedBaseElGamal() : m_Table(Blocks * Entries) {
+    CryptoPP::Integer base = elgg;  // g^(16^i) as blocks advance
+    for (std::size_t i = 0; i < Blocks; i++) {
+      m_Table[i * Entries] = base;
+      for (std::size_t j = 1; j < Entries; j++)
+        m_Table[i * Entries + j] =
+          a_times_b_mod_c(m_Table[i * Entries + j - 1], base, elgp);
+      if (i + 1 < Blocks)
+        base = a_times_b_mod_c(
+            m_Table[i * Entries + Entries - 1], base, elgp);  // base^16
+    }
+  }
+
+  std::vector<CryptoPP::Integer> m_Table;
+};
+
+/// @brief Idle-time pool of ephemeral (k, g^k) pairs shared by all
+///   ElGamalEncryption instances (see PrecomputeElGamal)
+struct ElGamalPrecomputed {
+  CryptoPP::Integer k, a;  // a = g^k mod p
+};
+std::mutex g_PrecomputedElGamalMutex;
+std::vector<ElGamalPrecomputed> g_PrecomputedElGamal;
+const std::size_t MaxPrecomputedElGamal = 64;
+
+bool GetPrecomputedElGamal(
+    ElGamalPrecomputed& pair) {
+  std::unique_lock<std::mutex> l(g_PrecomputedElGamalMutex);
+  if (g_PrecomputedElGamal.empty())
+    return false;
+  pair = g_PrecomputedElGamal.back();
+  g_PrecomputedElGamal.pop_back();
+  return true;
+}
+}  // namespace
+
+void PrecomputeElGamal(
+    std::size_t count) {
+  CryptoPP::AutoSeededRandomPool prng;
+  for (std::size_t i = 0; i < count; i++) {
+    ElGamalPrecomputed pair;
+    pair.k = CryptoPP::Integer(prng, CryptoPP::Integer::One(), elgp - 1);
+    pair.a = FixedBaseElGamal::Instance().Exponentiate(pair.k);
+    std::unique_lock<std::mutex> l(g_PrecomputedElGamalMutex);
+    if (g_PrecomputedElGamal.size() >= MaxPrecomputedElGamal)
+      return;
+    g_PrecomputedElGamal.push_back(pair);
+  }
+}
+
+std::size_t GetNumPrecomputedElGamal() {
+  std::unique_lock<std::mutex> l(g_PrecomputedElGamalMutex);
+  return g_PrecomputedElGamal.size();
+}
+
 /// @class ElGamalEncryptionImpl
 /// @brief ElGamal encryption
 class ElGamalEncryption::ElGamalEncryptionImpl {
  public:
   ElGamalEncryptionImpl(
       const std::uint8_t* key) {
+    CryptoPP::Integer y(key, 256);
+    ElGamalPrecomputed pair;
+    if (GetPrecomputedElGamal(pair)) {
+      // g^k came from the idle-time pool; only y^k is left to compute
+      a = pair.a;
+      b1 = a_exp_b_mod_c(y, pair.k, elgp);
+      return;
+    }
     CryptoPP::AutoSeededRandomPool prng;
-    CryptoPP::Integer
-      y(key, 256),
-      k(prng, CryptoPP::Integer::One(), elgp - 1);
-    a = a_exp_b_mod_c(elgg, k, elgp);
+    CryptoPP::Integer k(prng, CryptoPP::Integer::One(), elgp - 1);
+    a = FixedBaseElGamal::Instance().Exponentiate(k);
     b1 = a_exp_b_mod_c(y, k, elgp);
   }
 
@@ -156,10 +254,9 @@ void GenerateElGamalKeyPair(
     std::uint8_t* pub) {
 #if defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER)
   RandBytes(priv, 256);
-  a_exp_b_mod_c(
-      elgg,
-      CryptoPP::Integer(priv, 256),
-      elgp).Encode(pub, 256);
+  FixedBaseElGamal::Instance()
+      .Exponentiate(CryptoPP::Integer(priv, 256))
+      .Encode(pub, 256);
 #else
     DiffieHellman().GenerateKeyPair(priv, pub);
 #endif
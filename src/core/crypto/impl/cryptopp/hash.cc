@@ -129,6 +129,11 @@ std::size_t SHA256::VerifyDigest(
   return m_SHA256Pimpl->VerifyDigest(digest, input, length);
 }
 
+SHA256& ThreadLocalSHA256() {
+  static thread_local SHA256 hasher;
+  return hasher;
+}
+
 /**
  *
  * SHA512
@@ -0,0 +1,135 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "core/crypto/precompute.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+#include "core/crypto/elgamal.h"
+#include "core/crypto/rand.h"
+
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+CryptoPrecomputePool crypto_precompute;
+
+CryptoPrecomputePool::CryptoPrecomputePool()
+    : m_LowWatermark(16),
+      m_HighWatermark(64),
+      m_IsRunning(false),
+      m_Thread(nullptr),
+      m_Exception(__func__) {}
+
+CryptoPrecomputePool::~CryptoPrecomputePool() {
+  Stop();
+}
+
+void CryptoPrecomputePool::SetWatermarks(
+    std::size_t low_watermark,
+    std::size_t high_watermark) {
+  m_LowWatermark = low_watermark;
+  m_HighWatermark = high_watermark;
+}
+
+void CryptoPrecomputePool::Start() {
+  LOG(debug) << "CryptoPrecomputePool: starting";
+  m_IsRunning = true;
+  m_Thread =
+    std::make_unique<std::thread>(
+        std::bind(
+            &CryptoPrecomputePool::Run,
+            this));
+}
+
+void CryptoPrecomputePool::Stop() {
+  m_IsRunning = false;
+  m_Consumed.notify_one();
+  if (m_Thread) {
+    m_Thread->join();
+    m_Thread.reset(nullptr);
+  }
+}
+
+void CryptoPrecomputePool::Run() {
+  LOG(debug) << "CryptoPrecomputePool: running";
+  while (m_IsRunning) {
+    try {
+      const std::size_t num_elgamal = GetNumPrecomputedElGamal();
+      if (num_elgamal < m_LowWatermark)
+        PrecomputeElGamal(m_HighWatermark - num_elgamal);
+      if (GetNumSessionTags() < m_LowWatermark) {
+        std::vector<std::uint8_t> tags(
+            m_HighWatermark * CRYPTO_PRECOMPUTE_TAG_SIZE);
+        RandBytes(tags.data(), tags.size());
+        std::unique_lock<std::mutex> l(m_TagsMutex);
+        m_Tags.insert(m_Tags.end(), tags.begin(), tags.end());
+      }
+    } catch (...) {
+      m_Exception.Dispatch(__func__);
+    }
+    // ElGamal consumption has no wakeup hook, so also poll on a timeout
+    std::unique_lock<std::mutex> l(m_ConsumedMutex);
+    m_Consumed.wait_for(l, std::chrono::seconds(1));
+  }
+}
+
+void CryptoPrecomputePool::AcquireSessionTags(
+    std::uint8_t* tags,
+    std::size_t count) {
+  std::size_t bytes = count * CRYPTO_PRECOMPUTE_TAG_SIZE;
+  {
+    std::unique_lock<std::mutex> l(m_TagsMutex);
+    const std::size_t pooled = std::min(bytes, m_Tags.size());
+    if (pooled) {
+      memcpy(tags, m_Tags.data() + m_Tags.size() - pooled, pooled);
+      m_Tags.resize(m_Tags.size() - pooled);
+      tags += pooled;
+      bytes -= pooled;
+    }
+  }
+  if (bytes)  // pool ran dry, fall back to inline generation
+    RandBytes(tags, bytes);
+  m_Consumed.notify_one();
+}
+
+std::size_t CryptoPrecomputePool::GetNumSessionTags() const {
+  std::unique_lock<std::mutex> l(m_TagsMutex);
+  return m_Tags.size() / CRYPTO_PRECOMPUTE_TAG_SIZE;
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -30,14 +30,17 @@
 
 #include "core/crypto/radix.h"
 
-#include <cryptopp/base32.h>
-#include <cryptopp/base64.h>
-
-#include <array>
 #include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+#include <immintrin.h>
+#endif
+
+#include "core/util/cpu.h"
+
 namespace kovri
 {
 namespace core
@@ -64,34 +67,6 @@ std::array<const int, 256> Radix<T>::m_Base32Table{
      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
      -1, -1, -1, -1, -1, -1, -1, -1, -1}};
 
-const std::string& Base32::GetAlphabet() noexcept
-{
-  return m_Base32Alphabet;
-}
-
-std::string Base32::Encode(const std::uint8_t* in, const std::uint64_t len)
-{
-  // Prepare encoder
-  CryptoPP::AlgorithmParameters static const params(CryptoPP::MakeParameters(
-      CryptoPP::Name::EncodingLookupArray(),
-      reinterpret_cast<const CryptoPP::byte*>(m_Base32Alphabet.c_str())));
-
-  // Encode
-  return Radix::Encode<CryptoPP::Base32Encoder>(params, in, len);
-}
-
-std::vector<std::uint8_t> Base32::Decode(
-    const char* in,
-    const std::uint64_t len)
-{
-  // Prepare decoder
-  CryptoPP::AlgorithmParameters static const params(CryptoPP::MakeParameters(
-      CryptoPP::Name::DecodingLookupArray(), m_Base32Table.data(), false));
-
-  // Decode
-  return Radix::Decode<CryptoPP::Base32Decoder>(params, in, len);
-}
-
 /// @brief Base64 custom I2P alphabet
 template <typename T>
 std::string Radix<T>::m_Base64Alphabet(
@@ -115,6 +90,208 @@ std::array<const int, 256> Radix<T>::m_Base64Table{
      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
      -1, -1, -1, -1, -1, -1, -1, -1, -1}};
 
+namespace
+{
+/// @brief Table-driven bit-accumulator decoder shared by both radices
+/// @notes Bytes outside the alphabet (padding, whitespace) are skipped,
+///   matching the lookup-array behavior of the former library decoder
+void DecodeBits(
+    const int* table,
+    const unsigned bits_per_char,
+    const char* in,
+    const std::uint64_t len,
+    std::uint64_t& in_pos,
+    std::uint8_t* out,
+    std::uint64_t& out_pos)
+{
+  std::uint32_t acc = 0;
+  unsigned bits = 0;
+  for (; in_pos < len; in_pos++)
+    {
+      const int value = table[static_cast<std::uint8_t>(in[in_pos])];
+      if (value < 0)
+        continue;
+      acc = (acc << bits_per_char) | value;
+      bits += bits_per_char;
+      if (bits >= 8)
+        {
+          bits -= 8;
+          out[out_pos++] = (acc >> bits) & 0xFF;
+        }
+    }
+}
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+/// @brief Maps 6-bit values to the I2P Base64 alphabet in-register
+/// @details Classic range-offset technique: 0-25 'A'..., 26-51 'a'...,
+///   52-61 '0'..., 62 '-', 63 '~'
+__attribute__((target("avx2")))
+inline __m256i TranslateBase64(const __m256i indices)
+{
+  const __m256i offsets = _mm256_setr_epi8(
+      71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 63, 65, 0, 0,
+      71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 63, 65, 0, 0);
+  __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+  const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+  result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+  result = _mm256_shuffle_epi8(offsets, result);
+  return _mm256_add_epi8(result, indices);
+}
+
+/// @brief Encodes whole 24-byte blocks to 32 Base64 chars per iteration
+/// @notes Advances in_pos/out_pos; the scalar loop finishes the tail
+__attribute__((target("avx2")))
+void EncodeBlocksAVX2(
+    const std::uint8_t* in,
+    const std::uint64_t len,
+    char* out,
+    std::uint64_t& in_pos,
+    std::uint64_t& out_pos)
+{
+  const __m256i shuf = _mm256_setr_epi8(
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  // the second lane loads at +12, so the last iteration reads 28 bytes
+  while (in_pos + 32 <= len)
+    {
+      const __m128i lo =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + in_pos));
+      const __m128i hi =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + in_pos + 12));
+      const __m256i data = _mm256_shuffle_epi8(
+          _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuf);
+      // spread each 3-byte group into four 6-bit indices
+      const __m256i t0 = _mm256_and_si256(data, _mm256_set1_epi32(0x0FC0FC00));
+      const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+      const __m256i t2 = _mm256_and_si256(data, _mm256_set1_epi32(0x003F03F0));
+      const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(out + out_pos),
+          TranslateBase64(_mm256_or_si256(t1, t3)));
+      in_pos += 24;
+      out_pos += 32;
+    }
+}
+
+/// @brief Decodes whole 32-char blocks to 24 bytes per iteration
+/// @notes Stops at the first block holding a byte outside the alphabet
+///   (padding included); the scalar loop finishes from in_pos
+__attribute__((target("avx2")))
+void DecodeBlocksAVX2(
+    const char* in,
+    const std::uint64_t len,
+    std::uint8_t* out,
+    std::uint64_t& in_pos,
+    std::uint64_t& out_pos)
+{
+  // nibble-indexed validity masks for the I2P alphabet: a byte is invalid
+  // when its low-nibble row and high-nibble column share a class bit
+  const __m256i lut_lo = _mm256_setr_epi8(
+      0x19, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+      0x18, 0x18, 0x1C, 0x3E, 0x3E, 0x36, 0x1E, 0x3E,
+      0x19, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+      0x18, 0x18, 0x1C, 0x3E, 0x3E, 0x36, 0x1E, 0x3E);
+  const __m256i lut_hi = _mm256_setr_epi8(
+      0x10, 0x10, 0x08, 0x04, 0x01, 0x02, 0x01, 0x20,
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+      0x10, 0x10, 0x08, 0x04, 0x01, 0x02, 0x01, 0x20,
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  // per-high-nibble offset from ASCII to 6-bit value; '~' shares high
+  // nibble 7 with 'p'-'z' so it is steered to slot 15 below
+  const __m256i lut_roll = _mm256_setr_epi8(
+      0, 0, 17, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, -63,
+      0, 0, 17, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, -63);
+  const __m256i pack_shuf = _mm256_setr_epi8(
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  while (in_pos + 32 <= len)
+    {
+      const __m256i str =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + in_pos));
+      const __m256i hi_nibbles = _mm256_and_si256(
+          _mm256_srli_epi32(str, 4), _mm256_set1_epi8(0x0F));
+      const __m256i lo_nibbles = _mm256_and_si256(str, _mm256_set1_epi8(0x0F));
+      if (!_mm256_testz_si256(
+              _mm256_shuffle_epi8(lut_lo, lo_nibbles),
+              _mm256_shuffle_epi8(lut_hi, hi_nibbles)))
+        return;
+      const __m256i eq_tilde =
+          _mm256_cmpeq_epi8(str, _mm256_set1_epi8(0x7E));
+      const __m256i roll = _mm256_shuffle_epi8(
+          lut_roll,
+          _mm256_add_epi8(
+              hi_nibbles, _mm256_and_si256(eq_tilde, _mm256_set1_epi8(8))));
+      const __m256i values = _mm256_add_epi8(str, roll);
+      // pack four 6-bit values per dword into three bytes
+      const __m256i merged =
+          _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+      const __m256i packed =
+          _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+      const __m256i compact = _mm256_permutevar8x32_epi32(
+          _mm256_shuffle_epi8(packed, pack_shuf),
+          _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(out + out_pos),
+          _mm256_castsi256_si128(compact));
+      _mm_storel_epi64(
+          reinterpret_cast<__m128i*>(out + out_pos + 16),
+          _mm256_extracti128_si256(compact, 1));
+      in_pos += 32;
+      out_pos += 24;
+    }
+}
+#endif
+}  // namespace
+
+const std::string& Base32::GetAlphabet() noexcept
+{
+  return m_Base32Alphabet;
+}
+
+std::string Base32::Encode(const std::uint8_t* in, const std::uint64_t len)
+{
+  if (!in || !len)
+    throw std::runtime_error("Encoder: null arg(s)");
+
+  std::string out((len * 8 + 4) / 5, '\0');
+  std::uint64_t out_pos = 0;
+  std::uint32_t acc = 0;
+  unsigned bits = 0;
+  for (std::uint64_t i = 0; i < len; i++)
+    {
+      acc = (acc << 8) | in[i];
+      bits += 8;
+      while (bits >= 5)
+        {
+          bits -= 5;
+          out[out_pos++] = m_Base32Alphabet[(acc >> bits) & 0x1F];
+        }
+    }
+  // final partial group is zero-filled; RFC 4648 padding is not emitted
+  if (bits)
+    out[out_pos] = m_Base32Alphabet[(acc << (5 - bits)) & 0x1F];
+
+  return out;
+}
+
+std::vector<std::uint8_t> Base32::Decode(
+    const char* in,
+    const std::uint64_t len)
+{
+  if (!in || !len)
+    throw std::runtime_error("Decoder: null arg(s)");
+
+  std::vector<std::uint8_t> out((len * 5) / 8 + 1);
+  std::uint64_t in_pos = 0, out_pos = 0;
+  DecodeBits(m_Base32Table.data(), 5, in, len, in_pos, out.data(), out_pos);
+
+  if (!out_pos)
+    throw std::length_error("Radix: invalid decoded size");
+
+  out.resize(out_pos);
+  return out;
+}
+
 const std::string& Base64::GetAlphabet() noexcept
 {
   return m_Base64Alphabet;
@@ -122,26 +299,64 @@ const std::string& Base64::GetAlphabet() noexcept
 
 std::string Base64::Encode(const std::uint8_t* in, const std::uint64_t len)
 {
-  // Prepare encoder
-  CryptoPP::AlgorithmParameters static const params(
-      CryptoPP::MakeParameters(CryptoPP::Name::InsertLineBreaks(), false)(
-          CryptoPP::Name::EncodingLookupArray(),
-          reinterpret_cast<const CryptoPP::byte*>(m_Base64Alphabet.c_str())));
-
-  // Encode
-  return Radix::Encode<CryptoPP::Base64Encoder>(params, in, len);
+  if (!in || !len)
+    throw std::runtime_error("Encoder: null arg(s)");
+
+  // pre-filling with '=' leaves the tail padding in place
+  std::string out(((len + 2) / 3) * 4, '=');
+  std::uint64_t in_pos = 0, out_pos = 0;
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+  if (HasAVX2())
+    EncodeBlocksAVX2(in, len, &out[0], in_pos, out_pos);
+#endif
+
+  while (in_pos + 3 <= len)
+    {
+      const std::uint32_t group =
+          (in[in_pos] << 16) | (in[in_pos + 1] << 8) | in[in_pos + 2];
+      out[out_pos++] = m_Base64Alphabet[(group >> 18) & 0x3F];
+      out[out_pos++] = m_Base64Alphabet[(group >> 12) & 0x3F];
+      out[out_pos++] = m_Base64Alphabet[(group >> 6) & 0x3F];
+      out[out_pos++] = m_Base64Alphabet[group & 0x3F];
+      in_pos += 3;
+    }
+  if (in_pos < len)
+    {
+      std::uint32_t group = in[in_pos] << 16;
+      if (in_pos + 1 < len)
+        group |= in[in_pos + 1] << 8;
+      out[out_pos++] = m_Base64Alphabet[(group >> 18) & 0x3F];
+      out[out_pos++] = m_Base64Alphabet[(group >> 12) & 0x3F];
+      if (in_pos + 1 < len)
+        out[out_pos] = m_Base64Alphabet[(group >> 6) & 0x3F];
+    }
+
+  return out;
 }
 
 std::vector<std::uint8_t> Base64::Decode(
     const char* in,
     const std::uint64_t len)
 {
-  // Prepare decoder
-  CryptoPP::AlgorithmParameters static const params(CryptoPP::MakeParameters(
-      CryptoPP::Name::DecodingLookupArray(), m_Base64Table.data(), false));
+  if (!in || !len)
+    throw std::runtime_error("Decoder: null arg(s)");
+
+  std::vector<std::uint8_t> out((len * 6) / 8 + 1);
+  std::uint64_t in_pos = 0, out_pos = 0;
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+  if (HasAVX2())
+    DecodeBlocksAVX2(in, len, out.data(), in_pos, out_pos);
+#endif
+
+  DecodeBits(m_Base64Table.data(), 6, in, len, in_pos, out.data(), out_pos);
+
+  if (!out_pos)
+    throw std::length_error("Radix: invalid decoded size");
 
-  // Decode
-  return Radix::Decode<CryptoPP::Base64Decoder>(params, in, len);
+  out.resize(out_pos);
+  return out;
 }
 
 }  // namespace core
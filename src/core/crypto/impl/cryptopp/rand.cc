@@ -32,21 +32,110 @@
 
 #include <cryptopp/osrng.h>
 
+#include <cstring>
+
 namespace kovri {
 namespace core {
 
+namespace {
+
+/// @return This thread's CSPRNG
+/// @notes Constructing AutoSeededRandomPool per call (the previous
+///   behavior) paid an OS entropy read on every message's padding
+CryptoPP::AutoSeededRandomPool& GetPRNG() {
+  static thread_local CryptoPP::AutoSeededRandomPool prng;
+  return prng;
+}
+
+enum RandPoolSize : std::uint16_t {
+  /// @brief Bytes buffered per refill; one GenerateBlock amortizes the
+  ///   CSPRNG across many per-message requests
+  Pool = 4096,
+  /// @brief Requests above this bypass the pool
+  MaxRequest = 512,
+};
+
+/// @return Pointer to length buffered CSPRNG bytes (never handed out twice)
+std::uint8_t* PoolBytes(
+    std::size_t length) {
+  static thread_local std::uint8_t pool[RandPoolSize::Pool];
+  static thread_local std::size_t offset = RandPoolSize::Pool;  // empty
+  if (offset + length > sizeof(pool)) {
+    GetPRNG().GenerateBlock(pool, sizeof(pool));
+    offset = 0;
+  }
+  std::uint8_t* bytes = pool + offset;
+  offset += length;
+  return bytes;
+}
+
+}  // namespace
+
 void RandBytes(
     std::uint8_t* dataptr,
     std::size_t datalen) {
-  CryptoPP::AutoSeededRandomPool prng;
-  prng.GenerateBlock(dataptr, datalen);
+  if (datalen <= RandPoolSize::MaxRequest) {
+    std::memcpy(dataptr, PoolBytes(datalen), datalen);
+    return;
+  }
+  GetPRNG().GenerateBlock(dataptr, datalen);
+}
+
+void RandNonZeroBytes(
+    std::uint8_t* dataptr,
+    std::size_t datalen) {
+  RandBytes(dataptr, datalen);
+  // rejection-fill the (rare, ~1/256) zeros from the pool
+  for (std::size_t i = 0; i < datalen; i++)
+    while (!dataptr[i])
+      dataptr[i] = *PoolBytes(1);
 }
 
 std::uint32_t RandInRange32(
     std::uint32_t min,
     std::uint32_t max) {
-  CryptoPP::AutoSeededRandomPool prng;
-  return prng.GenerateWord32(min, max);
+  return GetPRNG().GenerateWord32(min, max);
+}
+
+namespace {
+
+/// @brief xoshiro256** state, seeded once per thread from the CSPRNG
+struct FastRandState {
+  std::uint64_t s[4];
+  FastRandState() {
+    do {
+      RandBytes(reinterpret_cast<std::uint8_t*>(s), sizeof(s));
+    } while (!(s[0] | s[1] | s[2] | s[3]));  // all-zero state is absorbing
+  }
+};
+
+std::uint64_t Rotl64(std::uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+}  // namespace
+
+std::uint64_t FastRand64() {
+  static thread_local FastRandState state;
+  std::uint64_t* s = state.s;
+  std::uint64_t const result = Rotl64(s[1] * 5, 7) * 9;
+  std::uint64_t const t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = Rotl64(s[3], 45);
+  return result;
+}
+
+std::uint32_t FastRandInRange32(
+    std::uint32_t min,
+    std::uint32_t max) {
+  // the range is at most 2^32 so the 64-bit modulo bias is negligible
+  // for the load-balancing and jitter choices this tier serves
+  std::uint64_t const range = static_cast<std::uint64_t>(max) - min + 1;
+  return min + static_cast<std::uint32_t>(FastRand64() % range);
 }
 
 }  // namespace core
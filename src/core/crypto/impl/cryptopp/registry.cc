@@ -0,0 +1,204 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "core/crypto/registry.h"
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include "core/crypto/aead.h"
+#include "core/crypto/aes.h"
+#include "core/crypto/hash.h"
+#include "core/crypto/rand.h"
+#include "core/crypto/signature.h"
+
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+CryptoImplRegistry crypto_registry;
+
+namespace {
+
+/// @brief Payload bytes per bulk-primitive calibration pass; large enough
+///   that per-call overhead does not decide the ranking
+const std::size_t CalibrationBlock = 16384;
+
+/// @brief Message bytes per signing calibration pass
+const std::size_t CalibrationMessage = 1024;
+
+std::size_t RunAES() {
+  static AESKey key(std::vector<std::uint8_t>(32, 0x42).data());
+  static const std::uint8_t iv[16] = {};
+  static CBCEncryption aes(key, iv);
+  static std::vector<std::uint8_t> buf(CalibrationBlock);
+  aes.Encrypt(buf.data(), buf.size(), buf.data());
+  return buf.size();
+}
+
+std::size_t RunSHA256() {
+  static std::vector<std::uint8_t> buf(CalibrationBlock);
+  std::uint8_t digest[32];
+  ThreadLocalSHA256().CalculateDigest(digest, buf.data(), buf.size());
+  return buf.size();
+}
+
+std::size_t RunEd25519() {
+  static std::uint8_t sk[crypto::SkLen::Ed25519], pk[crypto::PkLen::Ed25519];
+  static bool keyed = false;
+  if (!keyed) {
+    CreateEd25519KeyPair(sk, pk);
+    keyed = true;
+  }
+  static Ed25519Signer signer(sk);
+  static std::vector<std::uint8_t> buf(CalibrationMessage);
+  std::uint8_t sig[crypto::SigLen::Ed25519];
+  signer.Sign(buf.data(), buf.size(), sig);
+  return buf.size();
+}
+
+std::size_t RunAEAD() {
+  static std::uint8_t key[AEADSize::Key] = {};
+  static std::uint8_t nonce[AEADSize::Nonce] = {};
+  static AEADEncryption aead;
+  static bool keyed = false;
+  if (!keyed) {
+    aead.SetKey(key);
+    keyed = true;
+  }
+  static std::vector<std::uint8_t> in(CalibrationBlock);
+  static std::vector<std::uint8_t> out(CalibrationBlock + AEADSize::Tag);
+  aead.Encrypt(nonce, nullptr, 0, in.data(), in.size(), out.data());
+  return in.size();
+}
+
+}  // namespace
+
+void CryptoImplRegistry::RegisterDefaults() {
+  // Crypto++ dispatches to AES-NI/SHA-NI/AVX2 kernels internally at
+  // runtime, so the one built-in backend registers under a name carrying
+  // what it detected; an alternative backend (bitsliced, OpenSSL, ...)
+  // registers alongside and the calibration arbitrates
+  Register(
+      Primitive::AES,
+      UsingAESNI() ? "cryptopp-aesni" : "cryptopp-portable",
+      RunAES);
+  Register(Primitive::SHA256, "cryptopp", RunSHA256);
+  Register(Primitive::Ed25519, "cryptopp", RunEd25519);
+  Register(Primitive::AEAD, "cryptopp-gcm", RunAEAD);
+}
+
+void CryptoImplRegistry::Register(
+    Primitive primitive,
+    const std::string& name,
+    std::function<std::size_t (void)> run) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  m_Candidates[primitive].push_back(Candidate{name, std::move(run)});
+}
+
+void CryptoImplRegistry::Calibrate() {
+  typedef std::chrono::steady_clock Clock;
+  {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    if (m_Candidates.empty()) {
+      l.unlock();
+      RegisterDefaults();
+      l.lock();
+    }
+  }
+  std::unique_lock<std::mutex> l(m_Mutex);
+  for (const auto& primitive : m_Candidates) {
+    Selection best{std::string(), 0};
+    for (const auto& candidate : primitive.second) {
+      candidate.run();  // warm caches and lazy key schedules
+      std::size_t bytes = 0;
+      auto const start = Clock::now();
+      // enough passes to ride out scheduler noise at startup
+      for (std::size_t i = 0; i < 64; i++)
+        bytes += candidate.run();
+      auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Clock::now() - start).count();
+      double const mb_per_sec =
+          ns ? bytes * 1000.0 / ns : 0;  // bytes per microsecond == MB/s
+      if (mb_per_sec > best.mb_per_sec)
+        best = Selection{candidate.name, mb_per_sec};
+    }
+    m_Selected[primitive.first] = best;
+    LOG(info) << "CryptoImplRegistry: " << PrimitiveName(primitive.first)
+              << " -> " << best.name << " ("
+              << static_cast<std::uint64_t>(best.mb_per_sec) << " MB/s)";
+  }
+}
+
+std::string CryptoImplRegistry::GetSelectedName(Primitive primitive) const {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  auto it = m_Selected.find(primitive);
+  return it != m_Selected.end() ? it->second.name : std::string();
+}
+
+double CryptoImplRegistry::GetThroughput(Primitive primitive) const {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  auto it = m_Selected.find(primitive);
+  return it != m_Selected.end() ? it->second.mb_per_sec : 0;
+}
+
+std::string CryptoImplRegistry::Report() const {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  std::stringstream ss;
+  for (auto it = m_Selected.begin(); it != m_Selected.end(); ++it) {
+    if (it != m_Selected.begin())
+      ss << ", ";
+    ss << PrimitiveName(it->first) << "=" << it->second.name << " ("
+       << static_cast<std::uint64_t>(it->second.mb_per_sec) << " MB/s)";
+  }
+  return ss.str();
+}
+
+std::string CryptoImplRegistry::PrimitiveName(Primitive primitive) {
+  switch (primitive) {
+    case Primitive::AES:
+      return "aes";
+    case Primitive::SHA256:
+      return "sha256";
+    case Primitive::Ed25519:
+      return "ed25519";
+    case Primitive::AEAD:
+      return "aead";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -59,6 +59,18 @@ namespace core {
 
 // TODO(anonimal): remove pimpl, see #785
 
+namespace {
+
+/// @return This thread's CSPRNG for signature nonces and padding
+/// @notes Constructing AutoSeededRandomPool per signature (the previous
+///   behavior) paid an OS entropy read on every signing call
+CryptoPP::AutoSeededRandomPool& SignerPRNG() {
+  static thread_local CryptoPP::AutoSeededRandomPool prng;
+  return prng;
+}
+
+}  // namespace
+
 /**
  *
  * DSA
@@ -112,7 +124,7 @@ class DSASigner::DSASignerImpl {
  public:
   DSASignerImpl(
       const std::uint8_t* private_signing_key) {
-    m_PrivateKey.Initialize(
+    m_Signer.AccessKey().Initialize(
         dsap,
         dsaq,
         dsag,
@@ -125,13 +137,13 @@ class DSASigner::DSASignerImpl {
       const std::uint8_t* buf,
       std::size_t len,
       std::uint8_t* signature) const {
-    CryptoPP::DSA::Signer signer(m_PrivateKey);
-    CryptoPP::AutoSeededRandomPool prng;
-    signer.SignMessage(prng, buf, len, signature);
+    m_Signer.SignMessage(SignerPRNG(), buf, len, signature);
   }
 
  private:
-  CryptoPP::DSA::PrivateKey m_PrivateKey;
+  /// @brief Keyed signing context, built once; SignMessage is const and
+  ///   safe to share across threads
+  CryptoPP::DSA::Signer m_Signer;
 };
 
 DSASigner::DSASigner(
@@ -224,7 +236,7 @@ class ECDSASigner : public Signer {
       Curve curve,
       const std::uint8_t* private_signing_key,
       std::size_t key_length) {
-    m_PrivateKey.Initialize(
+    m_Signer.AccessKey().Initialize(
         curve,
         CryptoPP::Integer(
             private_signing_key,
@@ -235,16 +247,13 @@ class ECDSASigner : public Signer {
       const std::uint8_t* buf,
       std::size_t len,
       std::uint8_t* signature) const {
-    typename CryptoPP::ECDSA<CryptoPP::ECP, Hash>::Signer
-      signer(m_PrivateKey);
-    CryptoPP::AutoSeededRandomPool prng;
-    signer.SignMessage(prng, buf, len, signature);
+    m_Signer.SignMessage(SignerPRNG(), buf, len, signature);
   }
 
  private:
-  typedef typename CryptoPP::ECDSA<CryptoPP::ECP, Hash>::PrivateKey
-    SignKey;
-  SignKey m_PrivateKey;
+  /// @brief Keyed signing context, built once; SignMessage is const and
+  ///   safe to share across threads
+  typename CryptoPP::ECDSA<CryptoPP::ECP, Hash>::Signer m_Signer;
 };
 
 // Create keys
@@ -521,7 +530,7 @@ class RSASigner {
   RSASigner(
       const std::uint8_t* private_signing_key,
       std::size_t key_length) {
-    m_PrivateKey.Initialize(
+    m_Signer.AccessKey().Initialize(
         CryptoPP::Integer(
             private_signing_key,
             key_length / 2),
@@ -535,14 +544,13 @@ class RSASigner {
       const std::uint8_t* buf,
       std::size_t len,
       std::uint8_t* signature) const {
-    CryptoPP::AutoSeededRandomPool prng;
-    typename CryptoPP::RSASS<CryptoPP::PKCS1v15, Hash>::Signer
-    signer(m_PrivateKey);
-    signer.SignMessage(prng, buf, len, signature);
+    m_Signer.SignMessage(SignerPRNG(), buf, len, signature);
   }
 
  private:
-  CryptoPP::RSA::PrivateKey m_PrivateKey;
+  /// @brief Keyed signing context, built once; SignMessage is const and
+  ///   safe to share across threads
+  typename CryptoPP::RSASS<CryptoPP::PKCS1v15, Hash>::Signer m_Signer;
 };
 
 // Create keys
@@ -895,14 +903,17 @@ class Ed25519Signer::Ed25519SignerImpl
     // Signed message length
     CryptoPP::word64 smlen;
 
-    // Sign message
-    std::vector<std::uint8_t> sm(crypto::SigLen::Ed25519 + mlen);
+    // Sign message into a per-thread scratch buffer: destinations that
+    // re-sign LeaseSets, streaming packets and datagrams would otherwise
+    // pay a heap allocation per signature
+    static thread_local std::vector<std::uint8_t> sm;
+    sm.resize(crypto::SigLen::Ed25519 + mlen);
     if (CryptoPP::NaCl::crypto_sign(sm.data(), &smlen, m, mlen, m_Sk.data()))
       throw CryptoPP::Exception(
           CryptoPP::Exception::OTHER_ERROR, "could not ed25519 sign message");
 
     // We only want the signature
-    std::copy(sm.begin(), sm.end() - mlen, signature);
+    std::copy(sm.begin(), sm.begin() + crypto::SigLen::Ed25519, signature);
   }
 
  private:
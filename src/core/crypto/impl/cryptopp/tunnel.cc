@@ -125,6 +125,14 @@ void TunnelEncryption::Encrypt(
   m_TunnelEncryptionPimpl->Encrypt(in, out);
 }
 
+void TunnelEncryption::EncryptBatch(
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t count) {
+  for (std::size_t i = 0; i < count; i++)
+    m_TunnelEncryptionPimpl->Encrypt(in[i], out[i]);
+}
+
 /// @class TunnelDecryptionImpl
 /// @brief Tunnel decryption implementation
 class TunnelDecryption::TunnelDecryptionImpl {
@@ -212,5 +220,13 @@ void TunnelDecryption::Decrypt(
   m_TunnelDecryptionPimpl->Decrypt(in, out);
 }
 
+void TunnelDecryption::DecryptBatch(
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t count) {
+  for (std::size_t i = 0; i < count; i++)
+    m_TunnelDecryptionPimpl->Decrypt(in[i], out[i]);
+}
+
 }  // namespace core
 }  // namespace kovri
@@ -30,56 +30,155 @@
 
 #include "core/crypto/util/checksum.h"
 
-#include <cryptopp/adler32.h>
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+#include <immintrin.h>
+#endif
 
-#include "core/util/log.h"
+#include "core/util/cpu.h"
 
 namespace kovri {
 namespace core {
 
-/// @class Adler32Impl
-/// @brief Adler-32 implementation
-class Adler32::Adler32Impl {
- public:
-  Adler32Impl() {}
-  ~Adler32Impl() {}
-
-  void CalculateDigest(
-      std::uint8_t* digest,
-      const std::uint8_t* input,
-      std::size_t length) {
-    m_Adler32.CalculateDigest(digest, input, length);
+namespace {
+
+/// @brief Adler-32 modulus (largest prime below 2^16)
+const std::uint32_t AdlerBase = 65521;
+
+/// @brief Most bytes processable before s2 can overflow 32 bits: largest
+///   n with 255 * n * (n + 1) / 2 + (n + 1) * (AdlerBase - 1) < 2^32
+///   (zlib's bound); both sums reduce once per chunk instead of per byte
+const std::size_t AdlerChunk = 5552;
+
+/// @brief Portable kernel: deferred modulo with an unrolled inner loop;
+///   compilers vectorize this well even without the AVX2 path
+void AdlerScalar(
+    const std::uint8_t* input,
+    std::size_t length,
+    std::uint32_t& s1,
+    std::uint32_t& s2) {
+  while (length) {
+    std::size_t chunk = length < AdlerChunk ? length : AdlerChunk;
+    length -= chunk;
+    while (chunk >= 8) {
+      s1 += input[0]; s2 += s1;
+      s1 += input[1]; s2 += s1;
+      s1 += input[2]; s2 += s1;
+      s1 += input[3]; s2 += s1;
+      s1 += input[4]; s2 += s1;
+      s1 += input[5]; s2 += s1;
+      s1 += input[6]; s2 += s1;
+      s1 += input[7]; s2 += s1;
+      input += 8;
+      chunk -= 8;
+    }
+    while (chunk--) {
+      s1 += *input++;
+      s2 += s1;
+    }
+    s1 %= AdlerBase;
+    s2 %= AdlerBase;
   }
+}
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+
+/// @brief Sums the eight 32-bit lanes
+__attribute__((target("avx2")))
+inline std::uint32_t HorizontalSum32(const __m256i v)
+{
+  const __m128i quad = _mm_add_epi32(
+      _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  const __m128i pair = _mm_add_epi32(quad, _mm_srli_si128(quad, 8));
+  const __m128i single = _mm_add_epi32(pair, _mm_srli_si128(pair, 4));
+  return _mm_cvtsi128_si32(single);
+}
 
-  std::size_t VerifyDigest(
-      std::uint8_t* digest,
-      const std::uint8_t* input,
-      std::size_t length) {
-    return m_Adler32.VerifyDigest(digest, input, length);
+/// @brief Whole 32-byte blocks per iteration: byte sums via SAD, weighted
+///   sums via multiply-add against descending weights, plus a running
+///   prefix of the byte sums so every block sees s2 += 32 * s1
+/// @notes The scalar kernel finishes the tail behind in_pos
+__attribute__((target("avx2")))
+void AdlerBlocksAVX2(
+    const std::uint8_t* input,
+    const std::size_t length,
+    std::size_t& in_pos,
+    std::uint32_t& s1,
+    std::uint32_t& s2)
+{
+  // 173 blocks = 5536 bytes, under the same overflow bound as AdlerChunk
+  const std::size_t blocks_per_chunk = AdlerChunk / 32;
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i weights = _mm256_setr_epi8(
+      32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+      16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  const __m256i ones16 = _mm256_set1_epi16(1);
+  while (in_pos + 32 <= length) {
+    std::size_t blocks = (length - in_pos) / 32;
+    if (blocks > blocks_per_chunk)
+      blocks = blocks_per_chunk;
+    __m256i vs1 = zero;       // byte sums
+    __m256i vs2 = zero;       // weighted byte sums
+    __m256i vs1_prefix = zero;  // sum of vs1 before each block
+    for (std::size_t i = 0; i < blocks; i++) {
+      const __m256i data = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(input + in_pos + i * 32));
+      vs1_prefix = _mm256_add_epi32(vs1_prefix, vs1);
+      // SAD leaves one 16-bit sum per 64-bit lane; 32-bit adds suffice
+      vs1 = _mm256_add_epi32(vs1, _mm256_sad_epu8(data, zero));
+      vs2 = _mm256_add_epi32(
+          vs2,
+          _mm256_madd_epi16(_mm256_maddubs_epi16(data, weights), ones16));
+    }
+    s2 += 32 * (static_cast<std::uint32_t>(blocks) * s1
+                + HorizontalSum32(vs1_prefix))
+          + HorizontalSum32(vs2);
+    s1 += HorizontalSum32(vs1);
+    s1 %= AdlerBase;
+    s2 %= AdlerBase;
+    in_pos += blocks * 32;
   }
+}
 
- private:
-  CryptoPP::Adler32 m_Adler32;
-};
+#endif
 
-Adler32::Adler32()
-    : m_Adler32Pimpl(
-          std::make_unique<Adler32Impl>()) {}
+}  // namespace
 
-Adler32::~Adler32() {}
+std::uint32_t Adler32Digest(
+    const std::uint8_t* input,
+    std::size_t length) {
+  std::uint32_t s1 = 1, s2 = 0;
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+  if (length >= 64 && HasAVX2()) {
+    std::size_t in_pos = 0;
+    AdlerBlocksAVX2(input, length, in_pos, s1, s2);
+    input += in_pos;
+    length -= in_pos;
+  }
+#endif
+  AdlerScalar(input, length, s1, s2);
+  return (s2 << 16) | s1;
+}
 
 void Adler32::CalculateDigest(
     std::uint8_t* digest,
     const std::uint8_t* input,
     std::size_t length) {
-  m_Adler32Pimpl->CalculateDigest(digest, input, length);
+  std::uint32_t const adler = Adler32Digest(input, length);
+  // big-endian wire layout, as the former library digest wrote it
+  digest[0] = adler >> 24;
+  digest[1] = adler >> 16;
+  digest[2] = adler >> 8;
+  digest[3] = adler;
 }
 
 std::size_t Adler32::VerifyDigest(
     std::uint8_t* digest,
     const std::uint8_t* input,
     std::size_t length) {
-  return m_Adler32Pimpl->VerifyDigest(digest, input, length);
+  std::uint8_t computed[4];
+  CalculateDigest(computed, input, length);
+  return digest[0] == computed[0] && digest[1] == computed[1]
+         && digest[2] == computed[2] && digest[3] == computed[3];
 }
 
 }  // namespace core
@@ -34,6 +34,8 @@
 #include <cryptopp/gzip.h>
 #include <cryptopp/zinflate.h>
 
+#include <algorithm>
+
 #include "core/util/log.h"
 
 namespace kovri {
@@ -142,6 +144,33 @@ class Gzip::GzipImpl {
     return m_Gzip.MaxRetrievable();
   }
 
+  void SetDeflateLevelFor(
+      const std::uint8_t* buffer,
+      std::size_t length) {
+    // Already-compressed (or encrypted) payloads use nearly the whole
+    // byte alphabet even in a small sample, so deflate would only burn
+    // CPU re-packing them into stored blocks anyway
+    std::size_t const sample =
+        std::min(length, static_cast<std::size_t>(512));
+    bool seen[256] = {};
+    std::size_t distinct = 0;
+    for (std::size_t i = 0; i < sample; i++) {
+      if (!seen[buffer[i]]) {
+        seen[buffer[i]] = true;
+        distinct++;
+      }
+    }
+    if (sample >= 256 && distinct >= 200)
+      m_Gzip.SetDeflateLevel(CryptoPP::Gzip::MIN_DEFLATE_LEVEL);
+    else
+      m_Gzip.SetDeflateLevel(CryptoPP::Gzip::DEFAULT_DEFLATE_LEVEL);
+  }
+
+  void Reset() {
+    m_Gzip.Skip(m_Gzip.MaxRetrievable());
+    m_Gzip.SetDeflateLevel(CryptoPP::Gzip::DEFAULT_DEFLATE_LEVEL);
+  }
+
  private:
   CryptoPP::Gzip m_Gzip;
 };
@@ -185,6 +214,16 @@ std::size_t Gzip::MaxRetrievable() {
   return m_GzipPimpl->MaxRetrievable();
 }
 
+void Gzip::SetDeflateLevelFor(
+    const std::uint8_t* buffer,
+    std::size_t length) {
+  m_GzipPimpl->SetDeflateLevelFor(buffer, length);
+}
+
+void Gzip::Reset() {
+  m_GzipPimpl->Reset();
+}
+
 /// @class GunzipImpl
 /// @brief RFC 1952 GZIP Decompressor
 class Gunzip::GunzipImpl {
@@ -208,6 +247,10 @@ class Gunzip::GunzipImpl {
     return m_Gunzip.MaxRetrievable();
   }
 
+  void Reset() {
+    m_Gunzip.Skip(m_Gunzip.MaxRetrievable());
+  }
+
  private:
   CryptoPP::Gunzip m_Gunzip;
 };
@@ -234,5 +277,21 @@ std::size_t Gunzip::MaxRetrievable() {
   return m_GunzipPimpl->MaxRetrievable();
 }
 
+void Gunzip::Reset() {
+  m_GunzipPimpl->Reset();
+}
+
+Gzip& ThreadLocalGzip() {
+  static thread_local Gzip compressor;
+  compressor.Reset();
+  return compressor;
+}
+
+Gunzip& ThreadLocalGunzip() {
+  static thread_local Gunzip decompressor;
+  decompressor.Reset();
+  return decompressor;
+}
+
 }  // namespace core
 }  // namespace kovri
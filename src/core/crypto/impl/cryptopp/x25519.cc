@@ -0,0 +1,73 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "core/crypto/x25519.h"
+
+#include <cryptopp/naclite.h>
+
+#include <algorithm>
+
+#include "core/crypto/rand.h"
+
+namespace kovri {
+namespace core {
+
+void X25519::GenerateKeyPair(
+    std::uint8_t* private_key,
+    std::uint8_t* public_key) {
+  RandBytes(private_key, X25519Size::PrivKey);
+  // RFC 7748 clamp; scalarmult clamps again internally, this just keeps
+  // the stored private key in canonical form
+  private_key[0] &= 248;
+  private_key[31] &= 127;
+  private_key[31] |= 64;
+  CryptoPP::NaCl::crypto_scalarmult_base(public_key, private_key);
+}
+
+bool X25519::Agree(
+    std::uint8_t* agreed_value,
+    const std::uint8_t* private_key,
+    const std::uint8_t* other_public_key) {
+  // the all-zero point maps every scalar to the all-zero secret
+  if (std::all_of(
+          other_public_key,
+          other_public_key + X25519Size::PubKey,
+          [](std::uint8_t byte) { return !byte; }))
+    return false;
+  return !CryptoPP::NaCl::crypto_scalarmult(
+      agreed_value,
+      private_key,
+      other_public_key);
+}
+
+}  // namespace core
+}  // namespace kovri
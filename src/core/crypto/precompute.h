@@ -0,0 +1,99 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_CRYPTO_PRECOMPUTE_H_
+#define SRC_CORE_CRYPTO_PRECOMPUTE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/util/exception.h"
+
+namespace kovri {
+namespace core {
+
+/// @brief Session tags are 32 random bytes (see garlic routing)
+const std::size_t CRYPTO_PRECOMPUTE_TAG_SIZE = 32;
+
+/// @class CryptoPrecomputePool
+/// @brief Background service keeping expensive crypto precomputations warm:
+///   refills the shared ElGamal ephemeral (k, g^k) pool (see elgamal.h) and
+///   a pool of random session tags between configurable low/high watermarks,
+///   so tunnel-build bursts and garlic tag delivery never block on bignum
+///   math or the system entropy source
+class CryptoPrecomputePool {
+ public:
+  CryptoPrecomputePool();
+  ~CryptoPrecomputePool();
+
+  void Start();
+
+  void Stop();
+
+  /// @brief Sets refill watermarks for both pools; call before Start
+  void SetWatermarks(
+      std::size_t low_watermark,
+      std::size_t high_watermark);
+
+  /// @brief Copies count pre-generated 32-byte session tags into tags,
+  ///   generating inline when the pool runs dry
+  void AcquireSessionTags(
+      std::uint8_t* tags,
+      std::size_t count);
+
+  std::size_t GetNumSessionTags() const;
+
+ private:
+  void Run();
+
+ private:
+  std::size_t m_LowWatermark, m_HighWatermark;
+  volatile bool m_IsRunning;
+  std::unique_ptr<std::thread> m_Thread;
+  std::vector<std::uint8_t> m_Tags;  // flat pool of 32-byte tags
+  mutable std::mutex m_TagsMutex;
+  std::condition_variable m_Consumed;
+  std::mutex m_ConsumedMutex;
+  core::Exception m_Exception;
+};
+
+extern CryptoPrecomputePool crypto_precompute;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_CRYPTO_PRECOMPUTE_H_
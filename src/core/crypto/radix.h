@@ -36,9 +36,6 @@
 #include <string>
 #include <vector>
 
-#include <cryptopp/base32.h>
-#include <cryptopp/base64.h>
-
 namespace kovri
 {
 namespace core
@@ -87,50 +84,6 @@ class Radix : public RadixBase
  protected:
   static std::string m_Base32Alphabet, m_Base64Alphabet;
   static std::array<const int, 256> m_Base32Table, m_Base64Table;
-
-  template <typename Base_N>
-  static std::string Encode(
-      const CryptoPP::AlgorithmParameters& params,
-      const std::uint8_t* in,
-      const std::uint64_t len)
-  {
-    if (!in || !len)
-      throw std::runtime_error("Encoder: null arg(s)");
-
-    Base_N encoder;
-    encoder.IsolatedInitialize(params);
-
-    std::string out;
-    encoder.Attach(new CryptoPP::StringSink(out));
-    encoder.Put(in, len);
-    encoder.MessageEnd();
-
-    return out;
-  }
-
-  template <typename Base_N>
-  static std::vector<std::uint8_t> Decode(
-      const CryptoPP::AlgorithmParameters& params,
-      const char* in,
-      const std::uint64_t len)
-  {
-    if (!in || !len)
-      throw std::runtime_error("Decoder: null arg(s)");
-
-    Base_N decoder;
-    decoder.IsolatedInitialize(params);
-    decoder.Put(reinterpret_cast<const CryptoPP::byte*>(in), len);
-    decoder.MessageEnd();
-
-    const CryptoPP::word64 size = decoder.MaxRetrievable();
-    if (!size || size > SIZE_MAX)
-      throw std::length_error("Radix: invalid decoded size");
-
-    std::vector<std::uint8_t> out(size);
-    decoder.Get(reinterpret_cast<CryptoPP::byte*>(&out[0]), out.size());
-
-    return out;
-  }
 };
 
 /// @brief Base32 implementation
@@ -44,6 +44,14 @@ namespace core {
       std::uint8_t* data,
       std::size_t length);
 
+  /// @brief Generates non-zero CSPRNG bytes in bulk
+  ///   (tunnel-data padding must not contain zero bytes)
+  /// @param data Buffer to store result
+  /// @param length Size of buffer
+  void RandNonZeroBytes(
+      std::uint8_t* data,
+      std::size_t length);
+
   /// @brief Generates a random of type T
   /// @return Random value of type T
   template<class T>
@@ -77,6 +85,30 @@ namespace core {
           begin + RandInRange32(0, end - begin - 1));
   }
 
+  /// @brief Fast non-cryptographic PRNG draw (per-thread xoshiro256**,
+  ///   seeded from the CSPRNG on first use per thread)
+  /// @warning Explicitly NOT for security-relevant randomness: never use
+  ///   for keys, tags, padding, or any value an observer must not predict.
+  ///   Intended for local choices like peer-list shuffling, load-balancing
+  ///   picks and timer jitter, where CSPRNG draws show up in profiles
+  /// @return 64 uniform pseudo-random bits
+  std::uint64_t FastRand64();
+
+  /// @brief Like RandInRange32 but drawn from the non-crypto tier
+  /// @warning See FastRand64 for what this must not be used for
+  /// @return Pseudo-random number in range [min, max]
+  std::uint32_t FastRandInRange32(std::uint32_t min, std::uint32_t max);
+
+  /// @brief Like Shuffle but drawn from the non-crypto tier
+  /// @warning See FastRand64 for what this must not be used for
+  template <class IT>
+  void FastShuffle(IT begin, IT end) {
+    for (; begin != end; ++begin)
+      std::iter_swap(
+          begin,
+          begin + FastRandInRange32(0, end - begin - 1));
+  }
+
 }  // namespace core
 }  // namespace kovri
 
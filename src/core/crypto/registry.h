@@ -0,0 +1,115 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_CRYPTO_REGISTRY_H_
+#define SRC_CORE_CRYPTO_REGISTRY_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @class CryptoImplRegistry
+/// @brief Registry of crypto implementations per primitive with startup
+///   micro-calibration
+/// @details Backends register one candidate per primitive they provide;
+///   Calibrate() times each candidate on this CPU, keeps the fastest and
+///   logs the choice with its measured throughput. One binary then runs
+///   hardware-optimal across a heterogeneous fleet. The winning names and
+///   rates are exposed for I2PControl via Report()
+class CryptoImplRegistry {
+ public:
+  enum struct Primitive : std::uint8_t {
+    AES,
+    SHA256,
+    Ed25519,
+    AEAD,
+  };
+
+  /// @brief One registered implementation of a primitive
+  struct Candidate {
+    std::string name;
+    /// @brief Runs the implementation over its workload once and
+    ///   returns the number of payload bytes processed
+    std::function<std::size_t (void)> run;
+  };
+
+  /// @brief Registers a candidate implementation for a primitive
+  /// @note Call before Calibrate(); later registrations are picked up by
+  ///   the next calibration run
+  void Register(
+      Primitive primitive,
+      const std::string& name,
+      std::function<std::size_t (void)> run);
+
+  /// @brief Times every registered candidate and selects the fastest per
+  ///   primitive, logging each choice
+  /// @note Takes a few milliseconds; run once at startup
+  void Calibrate();
+
+  /// @return Name of the selected implementation, empty before calibration
+  std::string GetSelectedName(Primitive primitive) const;
+
+  /// @return Measured throughput of the selected implementation in MB/s,
+  ///   0 before calibration
+  double GetThroughput(Primitive primitive) const;
+
+  /// @return One line per primitive ("aes=cryptopp-aesni (2940 MB/s)"),
+  ///   for logs and the I2PControl crypto trait
+  std::string Report() const;
+
+ private:
+  /// @brief Registers the built-in backend's candidates; called by the
+  ///   first calibration so the registry is usable without setup code
+  void RegisterDefaults();
+
+  struct Selection {
+    std::string name;
+    double mb_per_sec;
+  };
+
+  static std::string PrimitiveName(Primitive primitive);
+
+  mutable std::mutex m_Mutex;
+  std::map<Primitive, std::vector<Candidate>> m_Candidates;
+  std::map<Primitive, Selection> m_Selected;
+};
+
+extern CryptoImplRegistry crypto_registry;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_CRYPTO_REGISTRY_H_
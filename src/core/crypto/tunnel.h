@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_CRYPTO_TUNNEL_H_
 #define SRC_CORE_CRYPTO_TUNNEL_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -55,6 +56,15 @@ class TunnelEncryption {  // with double IV encryption
       const std::uint8_t* in,
       std::uint8_t* out);  // 1024 bytes (16 IV + 1008 data)
 
+  /// @brief Encrypts count independent 1024-byte tunnel data blocks in one
+  ///   call, crossing the pimpl boundary once and keeping key schedules hot
+  /// @notes in and out may alias for in-place encryption: both the AES-NI
+  ///   and the CBC implementation read each block before writing it
+  void EncryptBatch(
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t count);
+
  private:
   class TunnelEncryptionImpl;
   std::unique_ptr<TunnelEncryptionImpl> m_TunnelEncryptionPimpl;
@@ -74,6 +84,13 @@ class TunnelDecryption {  // with double IV encryption
       const std::uint8_t* in,
       std::uint8_t* out);  // 1024 bytes (16 IV + 1008 data)
 
+  /// @brief Decrypts count independent 1024-byte tunnel data blocks in one
+  ///   call, crossing the pimpl boundary once and keeping key schedules hot
+  void DecryptBatch(
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t count);
+
  private:
   class TunnelDecryptionImpl;
   std::unique_ptr<TunnelDecryptionImpl> m_TunnelDecryptionPimpl;
@@ -32,46 +32,43 @@
 #define SRC_CORE_CRYPTO_UTIL_CHECKSUM_H_
 
 #include <cstdint>
-#include <memory>
 
 namespace kovri {
 namespace core {
 
+/// @brief One-shot Adler-32 over a whole buffer (RFC 1950)
+/// @details Runs a hand-vectorized AVX2 kernel when the CPU supports it
+///   and an unrolled portable loop otherwise; NTCP checksums every frame
+///   with this, so the per-message cost matters
+/// @return The checksum as (s2 << 16) | s1
+std::uint32_t Adler32Digest(
+    const std::uint8_t* input,
+    std::size_t length);
+
 /// @class Adler32
-/// @brief Adler-32
+/// @brief Adler-32 one-shot digest in the big-endian wire layout
+/// @notes Allocation-free wrapper over Adler32Digest(); kept for the
+///   digest/verify call shape the transports use
 class Adler32 {
  public:
-  Adler32();
-  ~Adler32();
-
-  /// @brief Updates the hash with additional input and
-  ///   computes the hash of the current message
-  /// @details Only use this if your input is in one piece
-  /// @details CalculateDigest() restarts the hash for the next message
-  /// @param digest A pointer to the buffer to receive the hash
-  /// @param input The additional input as a buffer
+  /// @brief Computes the hash of the message in one piece
+  /// @param digest A pointer to the buffer to receive the 4-byte hash
+  /// @param input The input as a buffer
   /// @param length The size of the buffer, in bytes
   void CalculateDigest(
       std::uint8_t* digest,
       const std::uint8_t* input,
       std::size_t length);
 
-  /// @brief Updates the hash with additional input and
-  ///   verifies the hash of the current message
-  /// @details Only use this if your input is in one piece
-  /// @details Restarts the hash for the next nmessage.
-  /// @param digest A pointer to the buffer of an existing hash
-  /// @param input The additional input as a buffer
+  /// @brief Verifies the hash of the message in one piece
+  /// @param digest A pointer to the buffer of an existing 4-byte hash
+  /// @param input The input as a buffer
   /// @param length The size of the buffer, in bytes
   /// @returns True if the existing hash matches the computed hash
   std::size_t VerifyDigest(
       std::uint8_t* digest,
       const std::uint8_t* input,
       std::size_t length);
-
- private:
-  class Adler32Impl;
-  std::unique_ptr<Adler32Impl> m_Adler32Pimpl;
 };
 
 }  // namespace core
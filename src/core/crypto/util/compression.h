@@ -104,6 +104,19 @@ class Gzip {
   void SetDeflateLevel(
       std::size_t level);
 
+  /// @brief Sets the deflate level from a cheap entropy probe of the
+  ///   payload: already-compressed (or encrypted) data is stored
+  ///   instead of deflated again
+  /// @param buffer The payload about to be compressed
+  /// @param length The size of the payload, in bytes
+  void SetDeflateLevelFor(
+      const std::uint8_t* buffer,
+      std::size_t length);
+
+  /// @brief Discards any unretrieved output and restores the default
+  ///   deflate level, readying the context for the next message
+  void Reset();
+
   /// @brief Input a byte buffer for processing
   /// @param buffer The byte buffer to process
   /// @param length The size of the string, in bytes
@@ -160,11 +173,25 @@ class Gunzip {
   /// @returns The number of bytes ready for retrieval
   std::size_t MaxRetrievable();
 
+  /// @brief Discards any unretrieved output, readying the context for
+  ///   the next message
+  void Reset();
+
  private:
   class GunzipImpl;
   std::unique_ptr<GunzipImpl> m_GunzipPimpl;
 };
 
+/// @brief The calling thread's reusable GZIP compressor, returned reset
+///   and at the default deflate level
+/// @details Hot paths (DatabaseStore publish, datagram and streaming
+///   payloads) compress through this instead of paying deflate context
+///   setup and teardown per message
+Gzip& ThreadLocalGzip();
+
+/// @brief The calling thread's reusable GZIP decompressor, returned reset
+Gunzip& ThreadLocalGunzip();
+
 }  // namespace core
 }  // namespace kovri
 
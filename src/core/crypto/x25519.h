@@ -0,0 +1,88 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_CRYPTO_X25519_H_
+#define SRC_CORE_CRYPTO_X25519_H_
+
+#include <array>
+#include <cstdint>
+
+// RFC 7748 (Elliptic Curves for Security)
+// https://tools.ietf.org/html/rfc7748
+
+namespace kovri {
+namespace core {
+
+/// @enum X25519Size
+/// @brief Key and shared-secret sizes for Curve25519 key agreement
+enum X25519Size : std::uint8_t
+{
+  PubKey = 32,
+  PrivKey = 32,
+  SharedKey = 32,
+};
+
+/// @class X25519KeysPair
+/// @brief Transient Curve25519 keys for transport sessions
+struct X25519KeysPair
+{
+  std::array<std::uint8_t, X25519Size::PubKey> public_key {{}};
+  std::array<std::uint8_t, X25519Size::PrivKey> private_key {{}};
+};
+
+/// @class X25519
+/// @brief Curve25519 key agreement. An order of magnitude cheaper than
+///   the 2048-bit classic DH used by the NTCP handshake
+class X25519 {
+ public:
+  /// @brief Generate private/public key pair
+  /// @param private_key Private key (PrivKey bytes, clamped)
+  /// @param public_key Public key (PubKey bytes)
+  static void GenerateKeyPair(
+      std::uint8_t* private_key,
+      std::uint8_t* public_key);
+
+  /// @brief Agreed value from your private key and other party's public key
+  /// @param agreed_value Shared secret (SharedKey bytes)
+  /// @param private_key Your private key
+  /// @param other_public_key Other party's public key
+  /// @return False on failure (all-zero peer point)
+  static bool Agree(
+      std::uint8_t* agreed_value,
+      const std::uint8_t* private_key,
+      const std::uint8_t* other_public_key);
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_CRYPTO_X25519_H_
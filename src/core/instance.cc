@@ -39,12 +39,19 @@
 // TODO(anonimal): we musn't use client code in core...
 #include "client/reseed.h"
 
+#include "core/crypto/precompute.h"
+#include "core/crypto/registry.h"
+
 #include "core/router/context.h"
+#include "core/router/garlic.h"
 #include "core/router/net_db/impl.h"
 #include "core/router/transports/impl.h"
 #include "core/router/tunnel/impl.h"
 
+#include "core/util/file_writer.h"
 #include "core/util/log.h"
+#include "core/util/memory_budget.h"
+#include "core/util/startup.h"
 
 #include "version.h"
 
@@ -98,26 +105,47 @@ void Instance::Start()
 {
   try
     {
-      // NetDb
-      LOG(debug) << "Instance: starting NetDb";
-      if (!netdb.Start())
-        throw std::runtime_error("Instance: NetDb failed to start");
-
-      // Reseed
-      if (netdb.GetNumRouters() < NetDb::Size::MinRequiredRouters)
+      std::uint32_t const budget_mb =
+          m_Config.GetMap()["memory-budget-mb"].as<std::uint32_t>();
+      if (budget_mb)
         {
-          LOG(debug) << "Instance: reseeding NetDb";
-          // TODO(anonimal): we musn't use client code in core...
-          client::Reseed reseed;
-          if (!reseed.Start())
-            throw std::runtime_error("Instance: reseed failed");
+          memory_budget.SetCeiling(static_cast<std::size_t>(budget_mb) << 20);
+          // transit relaying is the expendable load: stop accepting and
+          // let existing transit tunnels age out of their 10-minute term
+          memory_budget.RegisterShedder(
+              0, "transit", [] { context.SetAcceptsTunnels(false); });
+          // answer caches rebuild on demand, so they go next
+          memory_budget.RegisterShedder(
+              1, "netdb-cache", [] { netdb.ShedReplyCaches(); });
+          LOG(info) << "Instance: memory budget " << budget_mb << " MB";
         }
-
-      LOG(debug) << "Instance: starting transports";
-      transports.Start();
-
-      LOG(debug) << "Instance: starting tunnels";
-      tunnels.Start();
+      // Independent stages run concurrently: the NetDb file load no
+      // longer serializes behind transport socket setup and the
+      // precompute pool. Tunnel building still waits for a verified
+      // router set and live transports
+      StartupExecutor startup;
+      startup.AddStage("netdb", [] {
+        if (!netdb.Start())
+          throw std::runtime_error("Instance: NetDb failed to start");
+        if (netdb.GetNumRouters() < NetDb::Size::MinRequiredRouters)
+          {
+            LOG(debug) << "Instance: reseeding NetDb";
+            // TODO(anonimal): we musn't use client code in core...
+            client::Reseed reseed;
+            if (!reseed.Start())
+              throw std::runtime_error("Instance: reseed failed");
+          }
+      });
+      startup.AddStage("precompute", [] { crypto_precompute.Start(); });
+      startup.AddStage("garlic-workers", [] { garlic_workers.Start(); });
+      startup.AddStage("file-writer", [] { file_writer.Start(); });
+      startup.AddStage("crypto-calibrate", [] { crypto_registry.Calibrate(); });
+      startup.AddStage("context", [] { context.Start(); });
+      startup.AddStage(
+          "transports", [] { transports.Start(); }, {"context"});
+      startup.AddStage(
+          "tunnels", [] { tunnels.Start(); }, {"netdb", "transports"});
+      startup.Run();
     }
   catch (...)
     {
@@ -138,8 +166,21 @@ void Instance::Stop()
       LOG(debug) << "Instance: stopping transports";
       transports.Stop();
 
+      LOG(debug) << "Instance: stopping garlic decrypt workers";
+      garlic_workers.Stop();
+
+      LOG(debug) << "Instance: stopping crypto precompute pool";
+      crypto_precompute.Stop();
+
       LOG(debug) << "Instance: stopping NetDb";
       netdb.Stop();
+
+      LOG(debug) << "Instance: stopping router context RI flusher";
+      context.Stop();
+
+      // last: NetDb and context teardown queue their final snapshots here
+      LOG(debug) << "Instance: stopping async file writer";
+      file_writer.Stop();
     }
   catch (...)
     {
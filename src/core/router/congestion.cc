@@ -0,0 +1,76 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/router/congestion.h"
+
+#include "core/router/context.h"
+#include "core/router/transports/impl.h"
+#include "core/router/tunnel/impl.h"
+
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+// Simply instantiating in namespace scope ties into, and is limited by, the current singleton design
+CongestionController congestion;
+
+CongestionController::Level CongestionController::TransitAdmission() {
+  const int queue = kovri::core::tunnels.GetQueueSize();
+  if (queue >= CONGESTION_QUEUE_HARD_LIMIT) {
+    LOG(warning)
+      << "CongestionController: tunnel-crypto queue at " << queue
+      << ", dropping transit builds";
+    return Level::Drop;
+  }
+  const std::size_t transit_limit =
+      MAX_NUM_TRANSIT_TUNNELS * CONGESTION_TRANSIT_PERCENT / 100;
+  // Hysteresis on the queue threshold: once congested, stay congested
+  // until the queue drains to half the limit, so the advertised caps
+  // (and the RI republish behind them) don't flap around the threshold
+  const int queue_limit =
+      m_Congested ? CONGESTION_QUEUE_SOFT_LIMIT / 2 : CONGESTION_QUEUE_SOFT_LIMIT;
+  const bool congested =
+      queue >= queue_limit ||
+      kovri::core::tunnels.GetNumTransitTunnels() >= transit_limit ||
+      kovri::core::transports.IsBandwidthExceeded();
+  if (congested != m_Congested) {
+    m_Congested = congested;
+    LOG(info)
+      << "CongestionController: "
+      << (congested ? "entering" : "leaving")
+      << " congestion (queue depth " << queue << ")";
+    context.SetCongested(congested);
+  }
+  return congested ? Level::Reject : Level::Accept;
+}
+
+}  // namespace core
+}  // namespace kovri
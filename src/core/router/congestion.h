@@ -0,0 +1,84 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_ROUTER_CONGESTION_H_
+#define SRC_CORE_ROUTER_CONGESTION_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace kovri {
+namespace core {
+
+/// @brief Tunnel-crypto queue depth at which new transit builds are
+///   rejected (with a reply), and at which the router stops advertising
+///   high bandwidth
+const int CONGESTION_QUEUE_SOFT_LIMIT = 256;
+
+/// @brief Queue depth at which transit build requests are dropped
+///   outright, before the ElGamal record decrypt
+const int CONGESTION_QUEUE_HARD_LIMIT = 1024;
+
+/// @brief Transit tunnel count (as percent of MAX_NUM_TRANSIT_TUNNELS)
+///   at which new transit builds are rejected
+const std::size_t CONGESTION_TRANSIT_PERCENT = 80;
+
+/// @class CongestionController
+/// @brief Tracks the router's own load (tunnel-crypto queue depth,
+///   transit tunnel count, transport bandwidth) and gates transit
+///   tunnel admission on it. Without this the router keeps accepting
+///   transit builds while saturated, degrading every tunnel it carries,
+///   and pays the ElGamal record decrypt before any admission decision.
+class CongestionController {
+ public:
+  /// @enum Level
+  /// @brief Admission decision for a new transit build request
+  enum struct Level : std::uint8_t {
+    Accept,  ///< Not congested
+    Reject,  ///< Decrypt and send a rejection reply
+    Drop,    ///< Severely overloaded: drop before the ElGamal decrypt
+  };
+
+  /// @brief Samples current load and returns the admission decision.
+  ///   On congestion state changes, updates the advertised capacity
+  ///   through RouterContext::SetCongested
+  Level TransitAdmission();
+
+ private:
+  std::atomic<bool> m_Congested{false};
+};
+
+// Simply instantiating in namespace scope ties into, and is limited by, the current singleton design
+extern CongestionController congestion;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_CONGESTION_H_
@@ -35,11 +35,15 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
 
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <tuple>
 #include <vector>
 #include <utility>
 
+#include "core/crypto/radix.h"
+
 #include "core/router/i2np.h"
 #include "core/router/info.h"
 #include "core/router/net_db/impl.h"
@@ -47,6 +51,8 @@
 #include "core/util/byte_stream.h"
 #include "core/util/filesystem.h"
 #include "core/util/mtu.h"
+#include "core/util/numa_slab.h"
+#include "core/util/thread_registry.h"
 #include "core/util/timestamp.h"
 #include "core/util/config.h"
 
@@ -61,8 +67,18 @@ RouterContext context;
 RouterContext::RouterContext()
     : m_LastUpdateTime(0),
       m_AcceptsTunnels(true),
+      m_IsCongested(false),
+      m_CongestionSavedCaps(0),
+      m_SustainedBandwidth(0),
       m_StartupTime(0),
-      m_State(RouterState::OK) {}
+      m_State(RouterState::OK),
+      m_IsDirty(false),
+      m_IsFlushing(false) {}
+
+RouterContext::~RouterContext()
+{
+  Stop();
+}
 
 // TODO(anonimal): review context's RI initialization options
 // TODO(anonimal): determine which functions are truly context and which are RI
@@ -71,6 +87,17 @@ void RouterContext::Initialize(const boost::program_options::variables_map& map)
   // TODO(anonimal): we want context ctor initialization with non-bpo object
   m_Opts = map;
 
+  // Thread roles registered after this point pick up their policy
+  if (m_Opts.count("thread-policy"))
+    core::thread_registry.SetPolicy(m_Opts["thread-policy"].as<std::string>());
+
+  // Message-pool backing must be decided before the transports start
+  // allocating (earlier blocks stay heap-backed, which Free() handles)
+  if (m_Opts.count("enable-numa-pools"))
+    core::numa_slabs.Configure(
+        m_Opts["enable-numa-pools"].as<bool>(),
+        m_Opts["enable-huge-pages"].as<bool>());
+
   // Set paths
   auto path = core::EnsurePath(core::GetPath(core::Path::Core));
   auto keys_path = (path / GetTrait(Trait::KeyFile)).string();
@@ -186,6 +213,45 @@ void RouterContext::Initialize(const boost::program_options::variables_map& map)
         SetReachable();
     }
 
+  // Load or create the static X25519 garlic keys, published as an RI
+  // option so peers can skip the ElGamal session bootstrap
+  auto garlic_keys_path = (path / GetTrait(Trait::GarlicKeyFile)).string();
+  core::InputFileStream garlic_keys(garlic_keys_path, std::ifstream::binary);
+  if (garlic_keys.Fail())
+    {
+      LOG(debug) << "RouterContext: creating garlic keys";
+      core::X25519::GenerateKeyPair(
+          m_GarlicKeys.private_key.data(), m_GarlicKeys.public_key.data());
+
+      LOG(debug) << "RouterContext: writing garlic keys";
+      core::OutputFileStream garlic_keys(
+          garlic_keys_path, std::ofstream::binary);
+      garlic_keys.Write(
+          m_GarlicKeys.private_key.data(), m_GarlicKeys.private_key.size());
+      garlic_keys.Write(
+          m_GarlicKeys.public_key.data(), m_GarlicKeys.public_key.size());
+    }
+  else
+    {
+      LOG(debug) << "RouterContext: reading existing garlic keys";
+      std::vector<std::uint8_t> buf = garlic_keys.ReadAll();
+      if (buf.size()
+          != m_GarlicKeys.private_key.size() + m_GarlicKeys.public_key.size())
+        throw std::length_error("RouterContext: invalid garlic key file");
+      std::memcpy(
+          m_GarlicKeys.private_key.data(),
+          buf.data(),
+          m_GarlicKeys.private_key.size());
+      std::memcpy(
+          m_GarlicKeys.public_key.data(),
+          buf.data() + m_GarlicKeys.private_key.size(),
+          m_GarlicKeys.public_key.size());
+    }
+  m_RouterInfo.SetOption(
+      GetTrait(Trait::GarlicKey),
+      core::Base64::Encode(
+          m_GarlicKeys.public_key.data(), m_GarlicKeys.public_key.size()));
+
   LOG(info) << "RouterContext: will listen on host " << hosts.raw_data;
   LOG(info) << "RouterContext: will listen on port " << port;
 
@@ -235,7 +301,77 @@ void RouterContext::Initialize(const boost::program_options::variables_map& map)
   UpdateRouterInfo();
 }
 
+void RouterContext::Start()
+{
+  LOG(debug) << "RouterContext: starting RI flusher";
+  m_IsFlushing = true;
+  m_FlushThread =
+      std::make_unique<std::thread>(std::bind(&RouterContext::Flush, this));
+}
+
+void RouterContext::Stop()
+{
+  {
+    std::unique_lock<std::mutex> l(m_FlushMutex);
+    if (!m_IsFlushing && !m_IsDirty)
+      return;
+    m_IsFlushing = false;
+  }
+  m_FlushCv.notify_one();
+  if (m_FlushThread)
+    {
+      m_FlushThread->join();
+      m_FlushThread.reset(nullptr);
+    }
+  // Commit any coalesced update so a clean shutdown never loses state
+  bool dirty;
+  {
+    std::unique_lock<std::mutex> l(m_FlushMutex);
+    dirty = m_IsDirty;
+    m_IsDirty = false;
+  }
+  if (dirty)
+    CommitRouterInfo();
+}
+
+void RouterContext::Flush()
+{
+  while (true)
+    {
+      bool dirty = false;
+      {
+        std::unique_lock<std::mutex> l(m_FlushMutex);
+        if (!m_IsFlushing)
+          break;
+        m_FlushCv.wait_for(l, std::chrono::seconds(Interval::Flush));
+        if (!m_IsFlushing)
+          break;
+        dirty = m_IsDirty;
+        m_IsDirty = false;
+      }
+      if (dirty)
+        CommitRouterInfo();
+    }
+}
+
 void RouterContext::UpdateRouterInfo() {
+  auto const timestamp = kovri::core::GetSecondsSinceEpoch();
+  {
+    std::unique_lock<std::mutex> l(m_FlushMutex);
+    // Address updates and cap changes arrive in storms under dynamic
+    // IPs; within the flush window the re-sign and disk write are
+    // deferred to the flusher thread, which coalesces them into one
+    if (m_IsFlushing && timestamp < m_LastUpdateTime + Interval::Flush)
+      {
+        m_IsDirty = true;
+        return;
+      }
+    m_IsDirty = false;
+  }
+  CommitRouterInfo();
+}
+
+void RouterContext::CommitRouterInfo() {
   LOG(debug) << "RouterContext: updating RI, saving to file";
   m_RouterInfo.CreateBuffer(m_Keys);
   m_RouterInfo.SaveToFile(
@@ -251,6 +387,19 @@ void RouterContext::UpdateAddress(
   // Set new host address as IPv4 or IPv6
   boost::asio::ip::address new_host(BytesToAddress(host, size));
 
+  // While testing reachability, several peers report our endpoint in
+  // parallel; wait until a quorum of them agrees before trusting any
+  // single observation
+  bool confirmed = false;
+  if (GetState() == RouterState::Testing)
+    {
+      std::lock_guard<std::mutex> lock(m_AddressVotesMutex);
+      if (++m_AddressVotes[new_host] < ADDRESS_VOTE_QUORUM)
+        return;
+      m_AddressVotes.clear();
+      confirmed = true;
+    }
+
   // Set new host if applicable
   bool updated = false;
   for (auto& address : m_RouterInfo.GetAddresses())
@@ -263,9 +412,10 @@ void RouterContext::UpdateAddress(
         }
     }
 
-  // Update RI if applicable
+  // Update RI if applicable; a confirmed quorum publishes immediately so
+  // peers see an accurate address as soon as testing converges
   auto const timestamp = core::GetSecondsSinceEpoch();
-  if (updated || timestamp > m_LastUpdateTime + Interval::Update)
+  if (updated || confirmed || timestamp > m_LastUpdateTime + Interval::Update)
     {
       LOG(debug) << "RouterContext:" << __func__ << ": our external address is "
                  << new_host.to_string()
@@ -293,6 +443,66 @@ void RouterContext::RemoveIntroducer(
     UpdateRouterInfo();
 }
 
+void RouterContext::SetCongested(
+    bool congested) {
+  if (congested == m_IsCongested)
+    return;
+  m_IsCongested = congested;
+  std::uint8_t caps = m_RouterInfo.GetCaps();
+  const std::uint8_t bandwidth_caps =
+      core::RouterInfo::Cap::HighBandwidth |
+      core::RouterInfo::Cap::UnlimitedBandwidth;
+  if (congested) {
+    m_CongestionSavedCaps = caps & bandwidth_caps;
+    caps &= ~bandwidth_caps;
+  } else {
+    caps |= m_CongestionSavedCaps;
+    m_CongestionSavedCaps = 0;
+  }
+  m_RouterInfo.SetCaps(caps);
+  UpdateRouterInfo();
+}
+
+void RouterContext::UpdateAdvertisedBandwidth(
+    std::uint32_t bytes_per_second) {
+  if (!m_Opts.count("auto-bandwidth") || !m_Opts["auto-bandwidth"].as<bool>())
+    return;
+  // smooth the coarse transport samples so one busy or idle interval
+  // doesn't flap the advertised class
+  m_SustainedBandwidth = m_SustainedBandwidth
+      ? (3 * m_SustainedBandwidth + bytes_per_second) / 4
+      : bytes_per_second;
+  if (m_IsCongested)
+    return;  // SetCongested already stripped the high caps
+  const auto bandwidth = m_Opts["bandwidth"].as<std::string>();
+  if (!bandwidth.empty() && bandwidth[0] > 'L')
+    return;  // operator floor is already the high class
+  // the shaper's configured ceiling (KBps, 0 = unshaped) bounds what we
+  // may claim: no high class without headroom to actually sustain it
+  const std::uint64_t limit =
+      m_Opts["bandwidth-limit"].as<std::uint32_t>() * 1024ull;
+  const bool advertised =
+      m_RouterInfo.HasCap(core::RouterInfo::Cap::HighBandwidth);
+  if (!advertised
+      && m_SustainedBandwidth > AUTO_BANDWIDTH_HIGH_THRESHOLD
+      && (!limit || limit > AUTO_BANDWIDTH_HIGH_THRESHOLD)) {
+    LOG(info)
+      << "RouterContext: sustaining " << m_SustainedBandwidth
+      << " B/s, advertising the high bandwidth class";
+    m_RouterInfo.SetCaps(
+        m_RouterInfo.GetCaps() | core::RouterInfo::Cap::HighBandwidth);
+    UpdateRouterInfo();
+  } else if (advertised
+      && m_SustainedBandwidth < AUTO_BANDWIDTH_LOW_THRESHOLD) {
+    LOG(info)
+      << "RouterContext: sustained rate fell to " << m_SustainedBandwidth
+      << " B/s, back to the configured bandwidth class";
+    m_RouterInfo.SetCaps(
+        m_RouterInfo.GetCaps() & ~core::RouterInfo::Cap::HighBandwidth);
+    UpdateRouterInfo();
+  }
+}
+
 bool RouterContext::IsUnreachable() const {
   return m_RouterInfo.GetCaps() & core::RouterInfo::Cap::Unreachable;
 }
@@ -37,11 +37,16 @@
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+
+#include "core/crypto/x25519.h"
 
 #include "core/router/garlic.h"
 #include "core/router/identity.h"
@@ -52,6 +57,19 @@ namespace kovri
 namespace core
 {
 
+/// @brief Peer-test observations that must agree on our external address
+///   before it is trusted while the router state is still Testing
+const std::size_t ADDRESS_VOTE_QUORUM = 3;
+
+/// @brief Sustained relay throughput (bytes per second) above which an
+///   auto-bandwidth router raises its advertised class to high
+const std::uint32_t AUTO_BANDWIDTH_HIGH_THRESHOLD = 48 * 1024;
+
+/// @brief Sustained throughput below which the advertised class falls
+///   back to the configured floor; half the raise threshold, so the
+///   caps (and the RI republish behind them) don't flap around it
+const std::uint32_t AUTO_BANDWIDTH_LOW_THRESHOLD = 24 * 1024;
+
 enum struct RouterState : std::uint8_t
 {
   /// @brief Context is fully port forwarded
@@ -68,10 +86,20 @@ class RouterContext : public RouterInfoTraits, public GarlicDestination {
  public:
   RouterContext();
 
+  ~RouterContext();
+
   /// @brief Initializes the router context, must be called before further context use
   /// @param map Variable map used to initialize context options
   void Initialize(const boost::program_options::variables_map& map);
 
+  /// @brief Starts the background RouterInfo flusher
+  /// @notes Coalesced RI updates are re-signed and persisted off the
+  ///   calling thread, at most once per flush interval
+  void Start();
+
+  /// @brief Stops the flusher, committing any pending RI update first
+  void Stop();
+
   // @return This RouterContext's RouterInfo
   kovri::core::RouterInfo& GetRouterInfo() {
     return m_RouterInfo;
@@ -116,6 +144,9 @@ class RouterContext : public RouterInfoTraits, public GarlicDestination {
   /// @param port Our port number
   /// @notes Default port paramter set for UPnP
   /// @notes Rebuilds RouterInfo
+  /// @notes While the router state is Testing, parallel peer testers each
+  ///   report an observation; the address is applied (and the RouterInfo
+  ///   published) as soon as a quorum of them agrees
   void UpdateAddress(
       const std::uint8_t* host,
       const std::uint8_t host_size,
@@ -162,6 +193,27 @@ class RouterContext : public RouterInfoTraits, public GarlicDestination {
     m_AcceptsTunnels = acceptsTunnels;
   }
 
+  // @return true if we are currently advertising reduced capacity
+  bool IsCongested() const {
+    return m_IsCongested;
+  }
+
+  // Advertise reduced capacity while congested by dropping the
+  // high/unlimited bandwidth caps from the RI (restored on exit).
+  // Rebuilds RouterInfo on state changes.
+  // @param congested true while the router is congested
+  void SetCongested(
+      bool congested);
+
+  // Feeds a fresh transport throughput sample (bytes per second) to the
+  // measured bandwidth-class logic: with auto-bandwidth enabled, the
+  // advertised class follows the smoothed sustained rate between the
+  // configured "bandwidth" floor and the high class, republishing
+  // through the usual RI update path on changes. No-op while congested
+  // @param bytes_per_second current transport rate, higher direction
+  void UpdateAdvertisedBandwidth(
+      std::uint32_t bytes_per_second);
+
   // @return true if we support IPv6 connectivity otherwise false
   bool SupportsV6() const {
     return m_RouterInfo.HasV6();
@@ -193,6 +245,12 @@ class RouterContext : public RouterInfoTraits, public GarlicDestination {
 
   void SetLeaseSetUpdated() {}
 
+  // override GarlicDestination: static X25519 key for garlic
+  // establishment, published in the RI (see Initialize)
+  const std::uint8_t* GetX25519PrivateKey() const noexcept {
+    return m_GarlicKeys.private_key.data();
+  }
+
   // implements GarlicDestination
   std::shared_ptr<const kovri::core::LeaseSet> GetLeaseSet() {
     return nullptr;
@@ -232,15 +290,36 @@ class RouterContext : public RouterInfoTraits, public GarlicDestination {
 
  private:
   void UpdateRouterInfo();
+
+  // Re-signs the RI and writes it to disk (see UpdateRouterInfo)
+  void CommitRouterInfo();
+
+  // Flusher thread loop
+  void Flush();
+
   void RemoveTransport(core::RouterInfo::Transport transport);
 
  private:
   kovri::core::RouterInfo m_RouterInfo;
   kovri::core::PrivateKeys m_Keys;
+  // static X25519 garlic keys, persisted next to the router keys
+  kovri::core::X25519KeysPair m_GarlicKeys;
   std::uint64_t m_LastUpdateTime;
   bool m_AcceptsTunnels;
+  bool m_IsCongested;
+  std::uint8_t m_CongestionSavedCaps;  // bandwidth caps restored on exit
+  std::uint32_t m_SustainedBandwidth;  // smoothed transport rate, bytes/second
   std::uint64_t m_StartupTime;  // in seconds since epoch
   RouterState m_State;
+  // external address observations tallied while testing (see UpdateAddress)
+  std::mutex m_AddressVotesMutex;
+  std::map<boost::asio::ip::address, std::size_t> m_AddressVotes;
+  // RI persistence coalescing (see UpdateRouterInfo)
+  bool m_IsDirty;
+  bool m_IsFlushing;
+  std::mutex m_FlushMutex;
+  std::condition_variable m_FlushCv;
+  std::unique_ptr<std::thread> m_FlushThread;
   std::mutex m_GarlicMutex;
   std::string m_CustomDataDir;
   boost::program_options::variables_map m_Opts;
@@ -32,9 +32,19 @@
 
 #include "core/router/garlic.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "core/crypto/aead.h"
 #include "core/crypto/hash.h"
+#include "core/crypto/x25519.h"
 
 #include "core/router/context.h"
 #include "core/router/tunnel/pool.h"
@@ -42,6 +52,8 @@
 
 #include "core/util/byte_stream.h"
 #include "core/util/log.h"
+#include "core/util/memory_budget.h"
+#include "core/util/thread_registry.h"
 #include "core/util/timestamp.h"
 
 namespace kovri {
@@ -49,6 +61,13 @@ namespace core {
 
 // TODO(anonimal): bytestream refactor
 
+namespace {
+/// @brief Budget estimate per stored incoming tag: 32-byte tag plus
+///   timestamp, shared_ptr slot and map node overhead (the CBCDecryption
+///   itself is shared across a whole tag batch and not charged per tag)
+const std::size_t INCOMING_TAG_ENTRY_SIZE = 96;
+}  // namespace
+
 GarlicRoutingSession::GarlicRoutingSession(
     GarlicDestination* owner,
     std::shared_ptr<const kovri::core::RoutingDestination> destination,
@@ -57,6 +76,9 @@ GarlicRoutingSession::GarlicRoutingSession(
     : m_Owner(owner),
       m_Destination(destination),
       m_NumTags(num_tags),
+      m_TagWindow(num_tags),
+      m_TagsDelivered(false),
+      m_MessagesSinceAckRequest(0),
       m_LeaseSetUpdateStatus(
           attach_leaseset ? eLeaseSetUpdated : eLeaseSetDoNotSend),
       m_LeaseSetUpdateMsgID(0),
@@ -79,6 +101,9 @@ GarlicRoutingSession::GarlicRoutingSession(
     : m_Owner(nullptr),
       m_Destination(nullptr),
       m_NumTags(1),
+      m_TagWindow(1),
+      m_TagsDelivered(false),
+      m_MessagesSinceAckRequest(0),
       m_LeaseSetUpdateStatus(eLeaseSetDoNotSend),
       m_LeaseSetUpdateMsgID(0),
       m_LeaseSetSubmissionTime(0),
@@ -104,16 +129,32 @@ GarlicRoutingSession::~GarlicRoutingSession() {
 
 GarlicRoutingSession::UnconfirmedTags*
 GarlicRoutingSession::GenerateSessionTags() {
-  auto tags = new UnconfirmedTags(m_NumTags);
+  auto tags = new UnconfirmedTags(m_TagWindow);
   tags->tags_creation_time = kovri::core::GetSecondsSinceEpoch();
+  // One RNG call for the whole batch; tags are carved out of the arena
+  std::vector<std::uint8_t> arena(tags->num_tags * 32);
+  kovri::core::RandBytes(arena.data(), arena.size());
   // TODO(unassigned): change int to std::size_t, adjust related code
-  for (int i = 0; i < m_NumTags; i++) {
-    kovri::core::RandBytes(tags->session_tags[i], 32);
+  for (int i = 0; i < tags->num_tags; i++) {
+    memcpy(tags->session_tags[i], arena.data() + i * 32, 32);
     tags->session_tags[i].creation_time = tags->tags_creation_time;
   }
   return tags;
 }
 
+void GarlicRoutingSession::AdjustTagWindow(
+    bool exhausted) {
+  if (exhausted) {
+    // Transfer outpaced the batch: double it (capped) so the session stops
+    // falling back to ElGamal blocks mid-stream
+    m_TagWindow =
+        std::min(m_TagWindow * 2, m_NumTags * SESSION_TAG_WINDOW_MAX_FACTOR);
+  } else if (m_TagWindow > m_NumTags) {
+    // Tags expired unused: consumption dropped, decay toward configured count
+    m_TagWindow = std::max(m_TagWindow / 2, m_NumTags);
+  }
+}
+
 void GarlicRoutingSession::MessageConfirmed(
     std::uint32_t msg_ID) {
   TagsConfirmed(msg_ID);
@@ -127,27 +168,53 @@ void GarlicRoutingSession::MessageConfirmed(
 
 void GarlicRoutingSession::TagsConfirmed(std::uint32_t msg_ID) {
   auto it = m_UnconfirmedTagsMsgs.find(msg_ID);
-  if (it != m_UnconfirmedTagsMsgs.end()) {
-    std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-    UnconfirmedTags* tags = it->second;
-    if (ts < tags->tags_creation_time + OUTGOING_TAGS_EXPIRATION_TIMEOUT) {
-      // TODO(unassigned): change int to std::size_t, adjust related code
-      for (int i = 0; i < tags->num_tags; i++)
-        m_SessionTags.push_back(tags->session_tags[i]);
+  if (it == m_UnconfirmedTagsMsgs.end())
+    return;
+  std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
+  UnconfirmedTags* tags = it->second;
+  if (ts < tags->tags_creation_time + OUTGOING_TAGS_EXPIRATION_TIMEOUT) {
+    // TODO(unassigned): change int to std::size_t, adjust related code
+    for (int i = 0; i < tags->num_tags; i++)
+      m_SessionTags.push_back(tags->session_tags[i]);
+    m_TagsDelivered = true;
+  }
+  std::uint32_t const confirmed_time = tags->tags_creation_time;
+  m_UnconfirmedTagsMsgs.erase(it);
+  delete tags;
+  // One ack settles the whole window: batches minted before the
+  // confirmed one were superseded and their acks are no longer awaited,
+  // so the pending state clears in batch instead of lingering until
+  // expiry (their tags are discarded, never promoted unconfirmed)
+  for (auto batch = m_UnconfirmedTagsMsgs.begin();
+       batch != m_UnconfirmedTagsMsgs.end();) {
+    if (batch->second->tags_creation_time <= confirmed_time) {
+      if (m_Owner)
+        m_Owner->RemoveCreatedSession(batch->first);
+      delete batch->second;
+      batch = m_UnconfirmedTagsMsgs.erase(batch);
+    } else {
+      ++batch;
     }
-    m_UnconfirmedTagsMsgs.erase(it);
-    delete tags;
   }
 }
 
 bool GarlicRoutingSession::CleanupExpiredTags() {
   std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-  for (auto it = m_SessionTags.begin(); it != m_SessionTags.end();) {
-    if (ts >= it->creation_time + OUTGOING_TAGS_EXPIRATION_TIMEOUT)
-      it = m_SessionTags.erase(it);
-    else
-      it++;
+  int num_expired_tags = 0;
+  // Tag batches are appended in confirmation order, so the list is
+  // (near) creation-time ordered: expiry pops from the front and stops
+  // at the first live tag instead of scanning every tag. Any expired
+  // straggler behind a live tag is filtered again at use in
+  // WrapSingleMessage
+  while (!m_SessionTags.empty() &&
+         ts >= m_SessionTags.front().creation_time +
+             OUTGOING_TAGS_EXPIRATION_TIMEOUT) {
+    m_SessionTags.pop_front();
+    num_expired_tags++;
   }
+  // Over half a batch aged out unused: the window outgrew consumption
+  if (num_expired_tags > m_TagWindow / 2)
+    AdjustTagWindow(false);
   // delete expired unconfirmed tags
   for (auto it = m_UnconfirmedTagsMsgs.begin();
       it != m_UnconfirmedTagsMsgs.end();) {
@@ -163,6 +230,16 @@ bool GarlicRoutingSession::CleanupExpiredTags() {
   return !m_SessionTags.empty() || m_UnconfirmedTagsMsgs.empty();
 }
 
+void GarlicRoutingSession::RestoreState(
+    const kovri::core::AESKey& session_key,
+    std::list<SessionTag>&& tags) {
+  m_SessionKey = session_key;
+  m_Encryption.SetKey(m_SessionKey);
+  m_SessionTags = std::move(tags);
+  // the peer confirmed these tags in the previous run
+  m_TagsDelivered = true;
+}
+
 std::shared_ptr<I2NPMessage> GarlicRoutingSession::WrapSingleMessage(
     std::shared_ptr<const I2NPMessage> msg) {
   auto m = ToSharedI2NPMessage(NewI2NPMessage());
@@ -190,36 +267,48 @@ std::shared_ptr<I2NPMessage> GarlicRoutingSession::WrapSingleMessage(
     }
     // create message
     if (!tag_found) {
-      LOG(debug) << "GarlicRoutingSession: no garlic tag available, using ElGamal";
+      LOG(debug)
+        << "GarlicRoutingSession: no garlic tag available, establishing session";
+      // Exhaustion mid-session (tags were confirmed before): grow the window
+      if (m_NumTags > 0 && m_TagsDelivered)
+        AdjustTagWindow(true);
       if (!m_Destination) {
         LOG(warning)
           << "GarlicRoutingSession: can't use ElGamal for unknown destination";
         return nullptr;
       }
-      // create ElGamal block
-      ElGamalBlock eg_block;
-      memcpy(eg_block.session_key.data(), m_SessionKey, 32);
-      kovri::core::RandBytes(eg_block.pre_IV.data(), 32);  // Pre-IV
-      std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
-      kovri::core::SHA256().CalculateDigest(
-          iv.data(),
-          eg_block.pre_IV.data(),
-          iv.size());
-      m_Destination->GetElGamalEncryption()->Encrypt(
-          reinterpret_cast<std::uint8_t *>(&eg_block),
-          sizeof(eg_block),
-          buf,
-          true);
-      m_Encryption.SetIV(iv.data());
-      buf += 514;
-      len += 514;
+      // Prefer an X25519 establishment when the peer published a static
+      // key; ElGamal remains the fallback for old peers
+      const std::uint8_t* static_key = m_Destination->GetX25519StaticKey();
+      if (static_key && CreateX25519Block(buf, static_key)) {
+        buf += X25519_GARLIC_BLOCK_SIZE;
+        len += X25519_GARLIC_BLOCK_SIZE;
+      } else {
+        // create ElGamal block
+        ElGamalBlock eg_block;
+        memcpy(eg_block.session_key.data(), m_SessionKey, 32);
+        kovri::core::RandBytes(eg_block.pre_IV.data(), 32);  // Pre-IV
+        std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
+        kovri::core::ThreadLocalSHA256().CalculateDigest(
+            iv.data(),
+            eg_block.pre_IV.data(),
+            iv.size());
+        m_Destination->GetElGamalEncryption()->Encrypt(
+            reinterpret_cast<std::uint8_t *>(&eg_block),
+            sizeof(eg_block),
+            buf,
+            true);
+        m_Encryption.SetIV(iv.data());
+        buf += 514;
+        len += 514;
+      }
     } else {
       LOG(debug)
         << "GarlicRoutingSession: garlic tag available, using existing session";
       // session tag
       memcpy(buf, tag, 32);
       std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
-      kovri::core::SHA256().CalculateDigest(iv.data(), tag, iv.size());
+      kovri::core::ThreadLocalSHA256().CalculateDigest(iv.data(), tag, iv.size());
       m_Encryption.SetIV(iv.data());
       buf += iv.size();
       len += iv.size();
@@ -237,6 +326,52 @@ std::shared_ptr<I2NPMessage> GarlicRoutingSession::WrapSingleMessage(
   return m;
 }
 
+bool GarlicRoutingSession::CreateX25519Block(
+    std::uint8_t* buf,
+    const std::uint8_t* static_key) {
+  // Ephemeral key pair, used for this establishment only
+  kovri::core::X25519KeysPair ephemeral;
+  kovri::core::X25519::GenerateKeyPair(
+      ephemeral.private_key.data(),
+      ephemeral.public_key.data());
+  std::array<std::uint8_t, X25519Size::SharedKey> shared;
+  if (!kovri::core::X25519::Agree(
+          shared.data(), ephemeral.private_key.data(), static_key))
+    return false;
+  // AEAD key = SHA256(shared secret || ephemeral key): unique per
+  // establishment, so the nonce can stay zero
+  std::array<std::uint8_t, 64> key_material;
+  memcpy(key_material.data(), shared.data(), shared.size());
+  memcpy(
+      key_material.data() + shared.size(),
+      ephemeral.public_key.data(),
+      ephemeral.public_key.size());
+  std::array<std::uint8_t, AEADSize::Key> aead_key;
+  kovri::core::ThreadLocalSHA256().CalculateDigest(
+      aead_key.data(), key_material.data(), key_material.size());
+  // Session key + pre-IV: the meaningful prefix of an ElGamalBlock
+  std::array<std::uint8_t, 64> plain;
+  memcpy(plain.data(), m_SessionKey, 32);
+  kovri::core::RandBytes(plain.data() + 32, 32);  // Pre-IV
+  std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
+  kovri::core::ThreadLocalSHA256().CalculateDigest(
+      iv.data(), plain.data() + 32, iv.size());
+  buf[0] = X25519_GARLIC_MARKER;
+  memcpy(buf + 1, ephemeral.public_key.data(), ephemeral.public_key.size());
+  const std::array<std::uint8_t, AEADSize::Nonce> nonce{{}};
+  kovri::core::AEADEncryption aead;
+  aead.SetKey(aead_key.data());
+  aead.Encrypt(
+      nonce.data(),
+      buf + 1,  // ephemeral key as AD
+      ephemeral.public_key.size(),
+      plain.data(),
+      plain.size(),
+      buf + 1 + ephemeral.public_key.size());
+  m_Encryption.SetIV(iv.data());
+  return true;
+}
+
 // TODO(anonimal): bytestream refactor
 std::size_t GarlicRoutingSession::CreateAESBlock(
     std::uint8_t* buf,
@@ -245,7 +380,17 @@ std::size_t GarlicRoutingSession::CreateAESBlock(
   bool create_new_tags =
     m_Owner &&
     m_NumTags &&
-    (static_cast<int>(m_SessionTags.size()) <= m_NumTags * 2 / 3);
+    (static_cast<int>(m_SessionTags.size()) <= m_TagWindow * 2 / 3);
+  // Aggregated acknowledgment: while a batch is already awaiting its
+  // DeliveryStatus, don't mint another one per wrapped message — ask
+  // again at most once per window, so a busy session draws one ack
+  // through our inbound tunnels per window instead of one per message.
+  // Exhaustion overrides the window: an empty tag list would force the
+  // session back to full establishment blocks
+  if (create_new_tags && !m_UnconfirmedTagsMsgs.empty()
+      && !m_SessionTags.empty()
+      && m_MessagesSinceAckRequest < GARLIC_ACK_REQUEST_WINDOW)
+    create_new_tags = false;
   UnconfirmedTags* new_tags = create_new_tags ? GenerateSessionTags() : nullptr;
   core::OutputByteStream::Write<std::uint16_t>(
       buf, new_tags ? new_tags->num_tags : 0);  // tag count
@@ -264,11 +409,15 @@ std::size_t GarlicRoutingSession::CreateAESBlock(
   block_size++;
   std::size_t len = CreateGarlicPayload(buf + block_size, msg, new_tags);
   core::OutputByteStream::Write<std::uint32_t>(payload_size, len);
-  kovri::core::SHA256().CalculateDigest(payload_hash, buf + block_size, len);
+  kovri::core::ThreadLocalSHA256().CalculateDigest(payload_hash, buf + block_size, len);
   block_size += len;
   std::size_t rem = block_size % 16;
-  if (rem)
-    block_size += (16-rem);  // TODO(anonimal): MUST BE RANDOM PADDING!
+  if (rem) {
+    // random padding up to the AES block boundary; also keeps stale heap
+    // bytes out of the ciphertext
+    kovri::core::RandBytes(buf + block_size, 16 - rem);
+    block_size += (16 - rem);
+  }
   // TODO(anonimal): this try block should be larger or handled entirely by caller
   try {
     m_Encryption.Encrypt(buf, block_size, buf);
@@ -291,6 +440,7 @@ std::size_t GarlicRoutingSession::CreateGarlicPayload(
   *num_cloves = 0;
   size++;
   if (m_Owner) {
+    m_MessagesSinceAckRequest++;  // reset below when an ack is requested
     // resubmit non-confirmed LeaseSet
     if (m_LeaseSetUpdateStatus == eLeaseSetSubmitted &&
         kovri::core::GetMillisecondsSinceEpoch() >
@@ -307,6 +457,7 @@ std::size_t GarlicRoutingSession::CreateGarlicPayload(
         if (new_tags)  // new tags created
           m_UnconfirmedTagsMsgs[msg_ID] = new_tags;
         m_Owner->DeliveryStatusSent(shared_from_this(), msg_ID);
+        m_MessagesSinceAckRequest = 0;
       } else {
         LOG(warning)
           << "GarlicRoutingSession: DeliveryStatus clove was not created";
@@ -418,7 +569,13 @@ std::size_t GarlicRoutingSession::CreateDeliveryStatusClove(
   return size;
 }
 
-GarlicDestination::~GarlicDestination() {}
+GarlicDestination::~GarlicDestination() {
+  std::size_t tags = 0;
+  for (const auto& shard : m_TagShards)
+    tags += shard.tags.size();
+  memory_budget.Sub(
+      MemoryBudget::GarlicTags, tags * INCOMING_TAG_ENTRY_SIZE);
+}
 
 void GarlicDestination::AddSessionKey(
     const std::uint8_t* key,
@@ -429,7 +586,14 @@ void GarlicDestination::AddSessionKey(
       std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
       auto decryption = std::make_shared<kovri::core::CBCDecryption>();
       decryption->SetKey(key);
-      m_Tags[SessionTag(tag, ts)] = decryption;
+      SessionTag session_tag(tag, ts);
+      auto& shard = GetTagShard(session_tag);
+      std::unique_lock<std::mutex> l(shard.mutex);
+      auto const before = shard.tags.size();
+      shard.tags[session_tag] = decryption;
+      if (shard.tags.size() > before)  // operator[] may only refresh
+        memory_budget.Add(
+            MemoryBudget::GarlicTags, INCOMING_TAG_ENTRY_SIZE);
     }
   } catch (...) {
     m_Exception.Dispatch(__func__);
@@ -445,6 +609,37 @@ bool GarlicDestination::SubmitSessionKey(
   return true;
 }
 
+bool GarlicDestination::OpenX25519Block(
+    const std::uint8_t* private_key,
+    const std::uint8_t* buf,
+    std::uint8_t* out) {
+  const std::uint8_t* ephemeral_key = buf + 1;
+  std::array<std::uint8_t, X25519Size::SharedKey> shared;
+  if (!kovri::core::X25519::Agree(shared.data(), private_key, ephemeral_key))
+    return false;
+  // AEAD key = SHA256(shared secret || ephemeral key), see
+  // GarlicRoutingSession::CreateX25519Block
+  std::array<std::uint8_t, 64> key_material;
+  memcpy(key_material.data(), shared.data(), shared.size());
+  memcpy(
+      key_material.data() + shared.size(),
+      ephemeral_key,
+      X25519Size::PubKey);
+  std::array<std::uint8_t, AEADSize::Key> aead_key;
+  kovri::core::ThreadLocalSHA256().CalculateDigest(
+      aead_key.data(), key_material.data(), key_material.size());
+  const std::array<std::uint8_t, AEADSize::Nonce> nonce{{}};
+  kovri::core::AEADDecryption aead;
+  aead.SetKey(aead_key.data());
+  return aead.Decrypt(
+      nonce.data(),
+      ephemeral_key,  // ephemeral key as AD
+      X25519Size::PubKey,
+      buf + 1 + X25519Size::PubKey,
+      X25519_GARLIC_BLOCK_SIZE - 1 - X25519Size::PubKey,
+      out);
+}
+
 void GarlicDestination::HandleGarlicMessage(
     std::shared_ptr<I2NPMessage> msg) {
   // TODO(anonimal): this try block should be handled entirely by caller
@@ -458,72 +653,51 @@ void GarlicDestination::HandleGarlicMessage(
       return;
     }
     buf += 4;  // length
-    auto it = m_Tags.find(SessionTag(buf));
-    if (it != m_Tags.end()) {
-      // tag found. Use AES
+    SessionTag session_tag(buf);
+    std::shared_ptr<kovri::core::CBCDecryption> decryption;
+    {
+      auto& shard = GetTagShard(session_tag);
+      std::unique_lock<std::mutex> l(shard.mutex);
+      auto it = shard.tags.find(session_tag);
+      if (it != shard.tags.end()) {
+        decryption = it->second;
+        shard.tags.erase(it);  // tag might be used only once
+        memory_budget.Sub(
+            MemoryBudget::GarlicTags, INCOMING_TAG_ENTRY_SIZE);
+      }
+    }
+    if (decryption) {
+      // tag found. Use AES (decryption happens outside of the shard lock)
       if (length >= 32) {
         std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
-        kovri::core::SHA256().CalculateDigest(
+        kovri::core::ThreadLocalSHA256().CalculateDigest(
             iv.data(),
             buf,
             iv.size());
-        it->second->SetIV(iv.data());
-        it->second->Decrypt(
+        decryption->SetIV(iv.data());
+        decryption->Decrypt(
             buf + iv.size(),
             length - iv.size(),
             buf + iv.size());
         HandleAESBlock(
             buf + iv.size(),
             length - iv.size(),
-            it->second, msg->from);
+            decryption, msg->from);
       } else {
         LOG(error)
           << "GarlicDestination: message length "
           << length << " is less than 32 bytes";
       }
-      m_Tags.erase(it);  // tag might be used only once
     } else {
-      // tag not found. Use ElGamal
-      ElGamalBlock eg_block;
-      if (length >= 514 &&
-          kovri::core::ElGamalDecrypt(
-              GetEncryptionPrivateKey(),
-              buf,
-              reinterpret_cast<std::uint8_t *>(&eg_block),
-              true)) {
-        auto decryption = std::make_shared<kovri::core::CBCDecryption>();
-        decryption->SetKey(eg_block.session_key.data());
-        std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
-        kovri::core::SHA256().CalculateDigest(
-            iv.data(),
-            eg_block.pre_IV.data(),
-            iv.size());
-        decryption->SetIV(iv.data());
-        decryption->Decrypt(buf + 514, length - 514, buf + 514);
-        HandleAESBlock(buf + 514, length - 514, decryption, msg->from);
-      } else {
-        LOG(error) << "GarlicDestination: failed to decrypt garlic";
-      }
-    }
-    // cleanup expired tags
-    std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-    if (ts > m_LastTagsCleanupTime + INCOMING_TAGS_EXPIRATION_TIMEOUT) {
-      if (m_LastTagsCleanupTime) {
-        int num_expired_tags = 0;
-        for (auto it = m_Tags.begin(); it != m_Tags.end();) {
-          if (ts > it->first.creation_time + INCOMING_TAGS_EXPIRATION_TIMEOUT) {
-            num_expired_tags++;
-            it = m_Tags.erase(it);
-          } else {
-            it++;
-          }
-        }
-        LOG(debug)
-          << "GarlicDestination: " << num_expired_tags
-          << " tags expired for " << GetIdentHash().ToBase64();
-      }
-      m_LastTagsCleanupTime = ts;
+      // tag not found: an establishment decrypt (X25519 or ElGamal) is
+      // the expensive path, so hand it to the shared workers when they
+      // run and this destination can take the cloves back on its thread
+      if (garlic_workers.Offload(this, msg))
+        return;
+      DecryptTagMiss(msg, false);
     }
+    // expired incoming tags are reclaimed incrementally by
+    // SweepExpiredTags, off the message path
   } catch (...) {
     m_Exception.Dispatch(__func__);
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
@@ -531,6 +705,88 @@ void GarlicDestination::HandleGarlicMessage(
   }
 }
 
+void GarlicDestination::DecryptTagMiss(
+    std::shared_ptr<I2NPMessage> msg,
+    bool reinject) {
+  // length was validated against the I2NP length before the tag lookup
+  std::uint8_t* buf = msg->GetPayload();
+  const std::uint32_t length = core::InputByteStream::Read<std::uint32_t>(buf);
+  buf += 4;  // length
+  std::shared_ptr<kovri::core::CBCDecryption> decryption;
+  std::size_t offset = 0;
+  if (!DecryptGarlicBlock(buf, length, decryption, offset)) {
+    LOG(error) << "GarlicDestination: failed to decrypt garlic";
+    return;
+  }
+  if (reinject) {
+    auto* service = GetGarlicDispatchService();
+    if (service) {
+      // hand the decrypted clove set back to the owning thread; the
+      // message keeps the buffer (and inbound tunnel) alive
+      service->post([this, msg, decryption, offset, length] {
+            HandleAESBlock(
+                msg->GetPayload() + 4 + offset,
+                length - offset,
+                decryption,
+                msg->from);
+          });
+      return;
+    }
+  }
+  HandleAESBlock(buf + offset, length - offset, decryption, msg->from);
+}
+
+bool GarlicDestination::DecryptGarlicBlock(
+    std::uint8_t* buf,
+    std::size_t length,
+    std::shared_ptr<kovri::core::CBCDecryption>& decryption,
+    std::size_t& offset) {
+  // try an X25519 establishment block first
+  const std::uint8_t* x25519_key = GetX25519PrivateKey();
+  if (x25519_key && length >= X25519_GARLIC_BLOCK_SIZE &&
+      buf[0] == X25519_GARLIC_MARKER) {
+    std::array<std::uint8_t, 64> plain;  // session key + pre-IV
+    if (OpenX25519Block(x25519_key, buf, plain.data())) {
+      decryption = std::make_shared<kovri::core::CBCDecryption>();
+      decryption->SetKey(plain.data());
+      std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
+      kovri::core::ThreadLocalSHA256().CalculateDigest(
+          iv.data(),
+          plain.data() + 32,
+          iv.size());
+      decryption->SetIV(iv.data());
+      decryption->Decrypt(
+          buf + X25519_GARLIC_BLOCK_SIZE,
+          length - X25519_GARLIC_BLOCK_SIZE,
+          buf + X25519_GARLIC_BLOCK_SIZE);
+      offset = X25519_GARLIC_BLOCK_SIZE;
+      return true;
+    }
+    // marker collision with a random ElGamal first byte, fall through
+  }
+  // Use ElGamal
+  ElGamalBlock eg_block;
+  if (length >= 514 &&
+      kovri::core::ElGamalDecrypt(
+          GetEncryptionPrivateKey(),
+          buf,
+          reinterpret_cast<std::uint8_t *>(&eg_block),
+          true)) {
+    decryption = std::make_shared<kovri::core::CBCDecryption>();
+    decryption->SetKey(eg_block.session_key.data());
+    std::array<std::uint8_t, 32> iv;  // IV is first 16 bytes
+    kovri::core::ThreadLocalSHA256().CalculateDigest(
+        iv.data(),
+        eg_block.pre_IV.data(),
+        iv.size());
+    decryption->SetIV(iv.data());
+    decryption->Decrypt(buf + 514, length - 514, buf + 514);
+    offset = 514;
+    return true;
+  }
+  return false;
+}
+
 void GarlicDestination::HandleAESBlock(
     std::uint8_t* buf,
     std::size_t len,
@@ -550,8 +806,16 @@ void GarlicDestination::HandleAESBlock(
         return;
       }
       std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-      for (int i = 0; i < tag_count; i++)
-        m_Tags[SessionTag(buf + i * 32, ts)] = decryption;
+      for (int i = 0; i < tag_count; i++) {
+        SessionTag session_tag(buf + i * 32, ts);
+        auto& shard = GetTagShard(session_tag);
+        std::unique_lock<std::mutex> l(shard.mutex);
+        auto const before = shard.tags.size();
+        shard.tags[session_tag] = decryption;
+        if (shard.tags.size() > before)  // operator[] may only refresh
+          memory_budget.Add(
+              MemoryBudget::GarlicTags, INCOMING_TAG_ENTRY_SIZE);
+      }
     }
     buf += tag_count * 32;
     len -= tag_count * 32;
@@ -568,7 +832,7 @@ void GarlicDestination::HandleAESBlock(
       buf += 32;  // new session key
     buf++;  // flag
     // payload
-    if (!kovri::core::SHA256().VerifyDigest(payload_hash, buf, payload_size)) {
+    if (!kovri::core::ThreadLocalSHA256().VerifyDigest(payload_hash, buf, payload_size)) {
       // payload hash doesn't match
       LOG(error) << "GarlicDestination: wrong payload hash";
       return;
@@ -693,10 +957,14 @@ std::shared_ptr<I2NPMessage> GarlicDestination::WrapMessage(
 std::shared_ptr<GarlicRoutingSession> GarlicDestination::GetRoutingSession(
     std::shared_ptr<const kovri::core::RoutingDestination> destination,
     bool attach_leaseset) {
-  auto it = m_Sessions.find(destination->GetIdentHash());
   std::shared_ptr<GarlicRoutingSession> session;
-  if (it != m_Sessions.end())
-    session = it->second;
+  {
+    // Held only for the map lookup, not for wrapping
+    std::unique_lock<std::mutex> l(m_SessionsMutex);
+    auto it = m_Sessions.find(destination->GetIdentHash());
+    if (it != m_Sessions.end())
+      session = it->second;
+  }
   if (!session) {
     session = std::make_shared<GarlicRoutingSession>(
         this,
@@ -704,22 +972,202 @@ std::shared_ptr<GarlicRoutingSession> GarlicDestination::GetRoutingSession(
         // 40 tags for connections and 4 for LS requests
         attach_leaseset ? 40 : 4, attach_leaseset);
     std::unique_lock<std::mutex> l(m_SessionsMutex);
+    // state persisted by a previous run resumes this peer tag-based
+    auto restored = m_RestoredSessions.find(destination->GetIdentHash());
+    if (restored != m_RestoredSessions.end()) {
+      session->RestoreState(
+          restored->second.key, std::move(restored->second.tags));
+      m_RestoredSessions.erase(restored);
+    }
     m_Sessions[destination->GetIdentHash()] = session;
   }
   return session;
 }
 
-void GarlicDestination::CleanupRoutingSessions() {
-  std::unique_lock<std::mutex> l(m_SessionsMutex);
-  for (auto it = m_Sessions.begin(); it != m_Sessions.end();) {
-    if (!it->second->CleanupExpiredTags()) {
-      LOG(debug)
-        << "GarlicDestination: routing session to "
-        << it->first.ToBase32() << " deleted";
-      it = m_Sessions.erase(it);
-    } else {
-      it++;
+void GarlicDestination::SweepExpiredTags() {
+  // Bounded slice of routing sessions, resuming at the cursor so the
+  // full set is covered over successive ticks without ever holding the
+  // session mutex for a scan proportional to session count
+  {
+    std::unique_lock<std::mutex> l(m_SessionsMutex);
+    auto it = m_Sessions.lower_bound(m_SessionSweepCursor);
+    for (std::size_t processed = 0;
+         processed < GARLIC_SESSIONS_PER_SWEEP && it != m_Sessions.end();
+         processed++) {
+      if (!it->second->CleanupExpiredTags()) {
+        LOG(debug)
+          << "GarlicDestination: routing session to "
+          << ToBase32Cached(it->first) << " deleted";
+        it = m_Sessions.erase(it);
+      } else {
+        it++;
+      }
+    }
+    m_SessionSweepCursor =
+      (it != m_Sessions.end()) ? it->first : kovri::core::IdentHash();
+  }
+  // One incoming-tag shard per call, round-robin
+  std::uint32_t const ts = kovri::core::GetSecondsSinceEpoch();
+  auto& shard = m_TagShards[m_TagSweepShard];
+  m_TagSweepShard = (m_TagSweepShard + 1) % NUM_INCOMING_TAG_SHARDS;
+  int num_expired_tags = 0;
+  {
+    std::unique_lock<std::mutex> l(shard.mutex);
+    for (auto it = shard.tags.begin(); it != shard.tags.end();) {
+      if (ts > it->first.creation_time + INCOMING_TAGS_EXPIRATION_TIMEOUT) {
+        num_expired_tags++;
+        it = shard.tags.erase(it);
+      } else {
+        it++;
+      }
+    }
+  }
+  if (num_expired_tags)
+    memory_budget.Sub(
+        MemoryBudget::GarlicTags, num_expired_tags * INCOMING_TAG_ENTRY_SIZE);
+  if (num_expired_tags)
+    LOG(debug)
+      << "GarlicDestination: " << num_expired_tags
+      << " tags expired for " << ToBase64Cached(GetIdentHash());
+}
+
+// Persisted session file: "GSS" + version byte, a random IV, then the
+// AES-CBC ciphertext of { count, count x { ident, key, num_tags,
+// num_tags x { tag, creation_time } } }, zero-padded to the block size
+// (the layout is self-describing, so the padding parses away)
+static const char GARLIC_STATE_MAGIC[4] = {'G', 'S', 'S', 0x01};
+
+void GarlicDestination::DeriveStateKey(
+    kovri::core::AESKey& key) const {
+  static const char salt[] = "kovri.garlic.session.state";
+  std::array<std::uint8_t, 256 + sizeof(salt)> input;
+  std::memcpy(input.data(), GetEncryptionPrivateKey(), 256);
+  std::memcpy(input.data() + 256, salt, sizeof(salt));
+  kovri::core::SHA256().CalculateDigest(key(), input.data(), input.size());
+}
+
+void GarlicDestination::SaveGarlicSessions(const std::string& path) {
+  const std::uint32_t now = kovri::core::GetSecondsSinceEpoch();
+  // Gather exportable state first; file I/O stays outside the lock
+  std::vector<std::pair<kovri::core::IdentHash, RestoredSession>> exports;
+  {
+    std::unique_lock<std::mutex> l(m_SessionsMutex);
+    for (const auto& it : m_Sessions) {
+      const auto& session = it.second;
+      if (!session->HasDeliveredTags())
+        continue;
+      RestoredSession entry;
+      entry.key = session->GetSessionKey();
+      for (const auto& tag : session->GetSessionTags())
+        if (now < tag.creation_time + OUTGOING_TAGS_EXPIRATION_TIMEOUT)
+          entry.tags.push_back(tag);
+      if (!entry.tags.empty())
+        exports.emplace_back(it.first, std::move(entry));
+    }
+    // restored sessions never claimed this run are still valid state
+    for (auto& it : m_RestoredSessions) {
+      it.second.tags.remove_if([now](const SessionTag& tag) {
+        return now >= tag.creation_time + OUTGOING_TAGS_EXPIRATION_TIMEOUT;
+      });
+      if (!it.second.tags.empty())
+        exports.emplace_back(it.first, std::move(it.second));
+    }
+    m_RestoredSessions.clear();
+  }
+  if (exports.empty()) {
+    std::remove(path.c_str());
+    return;
+  }
+  std::size_t plain_len = 4;
+  for (const auto& entry : exports)
+    plain_len += 32 + 32 + 2 + entry.second.tags.size() * 36;
+  const std::size_t padded = (plain_len + 15) & ~static_cast<std::size_t>(15);
+  std::vector<std::uint8_t> plain(padded, 0);
+  core::OutputByteStream stream(plain.data(), plain.size());
+  stream.Write<std::uint32_t>(exports.size());
+  for (const auto& entry : exports) {
+    stream.WriteData(entry.first(), 32);
+    stream.WriteData(entry.second.key(), 32);
+    stream.Write<std::uint16_t>(entry.second.tags.size());
+    for (const auto& tag : entry.second.tags) {
+      stream.WriteData(tag(), 32);
+      stream.Write<std::uint32_t>(tag.creation_time);
+    }
+  }
+  kovri::core::AESKey key;
+  DeriveStateKey(key);
+  std::array<std::uint8_t, 16> IV;
+  kovri::core::RandBytes(IV.data(), IV.size());
+  std::vector<std::uint8_t> cipher(padded);
+  kovri::core::CBCEncryption encryption(key, IV.data());
+  encryption.Encrypt(plain.data(), padded, cipher.data());
+  std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+  if (!file) {
+    LOG(error) << "GarlicDestination: could not write session state " << path;
+    return;
+  }
+  file.write(GARLIC_STATE_MAGIC, sizeof(GARLIC_STATE_MAGIC));
+  file.write(reinterpret_cast<const char*>(IV.data()), IV.size());
+  file.write(reinterpret_cast<const char*>(cipher.data()), cipher.size());
+  LOG(debug)
+    << "GarlicDestination: saved " << exports.size() << " garlic sessions";
+}
+
+void GarlicDestination::LoadGarlicSessions(const std::string& path) {
+  std::ifstream file(path, std::ifstream::binary);
+  if (!file)
+    return;
+  std::vector<char> contents(
+      (std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  file.close();
+  // the tags in here are single-use: never offer the file twice
+  std::remove(path.c_str());
+  const std::size_t header = sizeof(GARLIC_STATE_MAGIC) + 16;
+  if (contents.size() <= header || (contents.size() - header) % 16
+      || std::memcmp(
+             contents.data(), GARLIC_STATE_MAGIC, sizeof(GARLIC_STATE_MAGIC))) {
+    LOG(warning) << "GarlicDestination: malformed session state " << path;
+    return;
+  }
+  kovri::core::AESKey key;
+  DeriveStateKey(key);
+  const std::size_t cipher_len = contents.size() - header;
+  const auto* cipher =
+      reinterpret_cast<const std::uint8_t*>(contents.data());
+  std::vector<std::uint8_t> plain(cipher_len);
+  kovri::core::CBCDecryption decryption(
+      key, cipher + sizeof(GARLIC_STATE_MAGIC));
+  decryption.Decrypt(cipher + header, cipher_len, plain.data());
+  const std::uint32_t now = kovri::core::GetSecondsSinceEpoch();
+  try {
+    core::InputByteStream stream(plain.data(), plain.size());
+    const std::uint32_t count = stream.Read<std::uint32_t>();
+    std::unique_lock<std::mutex> l(m_SessionsMutex);
+    for (std::uint32_t i = 0; i < count; i++) {
+      const kovri::core::IdentHash ident(stream.ReadBytes(32));
+      RestoredSession restored;
+      restored.key = kovri::core::AESKey(stream.ReadBytes(32));
+      const std::uint16_t num_tags = stream.Read<std::uint16_t>();
+      for (std::uint16_t tag_num = 0; tag_num < num_tags; tag_num++) {
+        const std::uint8_t* tag = stream.ReadBytes(32);
+        const std::uint32_t created = stream.Read<std::uint32_t>();
+        if (now < created + OUTGOING_TAGS_EXPIRATION_TIMEOUT)
+          restored.tags.push_back(SessionTag(tag, created));
+      }
+      if (!restored.tags.empty())
+        m_RestoredSessions[ident] = std::move(restored);
     }
+    if (!m_RestoredSessions.empty())
+      LOG(info)
+        << "GarlicDestination: restored " << m_RestoredSessions.size()
+        << " garlic sessions from the previous run";
+  } catch (const std::exception& ex) {
+    // garbage after a destination key change decrypts to noise and the
+    // bounds checks trip; drop whatever parsed
+    LOG(warning)
+      << "GarlicDestination: session state unreadable: " << ex.what();
+    m_RestoredSessions.clear();
   }
 }
 
@@ -758,10 +1206,101 @@ void GarlicDestination::ProcessGarlicMessage(
   HandleGarlicMessage(msg);
 }
 
+void GarlicDestination::ProcessGarlicMessages(
+    std::vector<std::shared_ptr<I2NPMessage>> msgs) {
+  for (auto& msg : msgs)
+    ProcessGarlicMessage(std::move(msg));
+}
+
 void GarlicDestination::ProcessDeliveryStatusMessage(
     std::shared_ptr<I2NPMessage> msg) {
   HandleDeliveryStatusMessage(msg);
 }
 
+GarlicWorkerPool garlic_workers;
+
+void GarlicWorkerPool::Start() {
+  std::size_t num_workers = 0;
+  if (context.GetOpts().count("garlic-decrypt-workers"))
+    num_workers =
+      context.GetOpts()["garlic-decrypt-workers"].as<std::uint16_t>();
+  if (!num_workers)
+    return;
+  m_IsRunning = true;
+  for (std::size_t worker = 0; worker < num_workers; worker++)
+    m_Workers.push_back(
+        std::make_unique<std::thread>(
+            std::bind(
+              &GarlicWorkerPool::RunWorker,
+              this)));
+}
+
+void GarlicWorkerPool::Stop() {
+  if (m_Workers.empty())
+    return;
+  m_IsRunning = false;
+  m_Queue.WakeUp();
+  for (auto& worker : m_Workers)
+    worker->join();
+  m_Workers.clear();
+  // drop whatever the workers never picked up
+  std::vector<GarlicWorkItem> dropped;
+  while (m_Queue.GetBatch(dropped, GARLIC_DECRYPT_QUEUE_LIMIT))
+    dropped.clear();
+  m_Pending = 0;
+}
+
+bool GarlicWorkerPool::Offload(
+    GarlicDestination* destination,
+    std::shared_ptr<I2NPMessage> msg) {
+  if (m_Workers.empty() || !destination->GetGarlicDispatchService())
+    return false;
+  if (m_Pending.load() >= GARLIC_DECRYPT_QUEUE_LIMIT)
+    return false;  // bounded: under overload the caller decrypts inline
+  m_Pending++;
+  m_Queue.Put(GarlicWorkItem{destination, std::move(msg)});
+  return true;
+}
+
+void GarlicWorkerPool::RunWorker() {
+  thread_registry.Register("garlic-decrypt");
+  const std::size_t max_batch = 16;
+  std::vector<GarlicWorkItem> batch;
+  while (m_IsRunning) {
+    try {
+      if (m_Queue.GetBatchWithTimeout(batch, max_batch, 1000)) {  // 1 sec
+        for (auto& item : batch) {
+          // decremented only once the destination call has returned, so
+          // Drain() cannot hand a stopping destination to teardown while
+          // a worker still runs on it; the guard keeps the barrier from
+          // wedging if the call throws
+          struct ItemGuard {
+            std::atomic<std::size_t>& pending;
+            ~ItemGuard() {
+              pending--;
+            }
+          } guard{m_Pending};
+          try {
+            item.destination->DecryptTagMiss(std::move(item.msg), true);
+          } catch (const std::exception& ex) {
+            LOG(error)
+              << "GarlicWorkerPool: " << __func__
+              << " exception: " << ex.what();
+          }
+        }
+        batch.clear();
+      }
+    } catch (const std::exception& ex) {
+      LOG(error)
+        << "GarlicWorkerPool: " << __func__ << " exception: " << ex.what();
+    }
+  }
+}
+
+void GarlicWorkerPool::Drain() {
+  while (!m_Workers.empty() && m_Pending.load())
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
 }  // namespace core
 }  // namespace kovri
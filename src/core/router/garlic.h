@@ -33,7 +33,10 @@
 #ifndef SRC_CORE_ROUTER_GARLIC_H_
 #define SRC_CORE_ROUTER_GARLIC_H_
 
+#include <boost/asio.hpp>
+
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <list>
 #include <map>
@@ -41,6 +44,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "core/crypto/aes.h"
 #include "core/crypto/rand.h"
@@ -75,9 +79,25 @@ struct ElGamalBlock {
 };
 #pragma pack()
 
+/// @brief First byte of an X25519 garlic establishment block, used to
+///   tell it apart from a 514-byte ElGamal block on the tag-miss path.
+///   A random ElGamal first byte can collide (~1/256), so receivers fall
+///   back to ElGamal whenever the X25519 open fails
+const std::uint8_t X25519_GARLIC_MARKER = 0xEC;
+
+/// @brief marker (1) + ephemeral public key (32) + sealed session
+///   key/pre-IV (64) + AEAD tag (16)
+const std::size_t X25519_GARLIC_BLOCK_SIZE = 113;
+
 const int INCOMING_TAGS_EXPIRATION_TIMEOUT = 960;  // 16 minutes
+
+/// @brief Routing sessions processed per incremental expiry sweep
+const std::size_t GARLIC_SESSIONS_PER_SWEEP = 8;
 const int OUTGOING_TAGS_EXPIRATION_TIMEOUT = 720;  // 12 minutes
 const int LEASET_CONFIRMATION_TIMEOUT = 4000;  // in milliseconds
+const int NUM_INCOMING_TAG_SHARDS = 16;  // power of two; shard picked by first tag byte
+const int SESSION_TAG_WINDOW_MAX_FACTOR = 4;  // adaptive batch cap, in multiples of the configured tag count
+const int GARLIC_ACK_REQUEST_WINDOW = 16;  // messages wrapped between DeliveryStatus requests while a batch is in flight
 
 struct SessionTag
     : public kovri::core::Tag<32> {
@@ -130,6 +150,28 @@ class GarlicRoutingSession
 
   bool CleanupExpiredTags();  // returns true if something left
 
+  /// @brief Seeds this fresh session with key and tags a previous run
+  ///   persisted, so wrapping resumes tag-based immediately instead of
+  ///   re-running establishment
+  void RestoreState(
+      const kovri::core::AESKey& session_key,
+      std::list<SessionTag>&& tags);
+
+  /// @return Session key, for export (see SaveGarlicSessions)
+  const kovri::core::AESKey& GetSessionKey() const {
+    return m_SessionKey;
+  }
+
+  /// @return Confirmed outgoing tags, for export
+  const std::list<SessionTag>& GetSessionTags() const {
+    return m_SessionTags;
+  }
+
+  /// @return Has the peer confirmed a tag batch?
+  bool HasDeliveredTags() const {
+    return m_TagsDelivered;
+  }
+
   void SetLeaseSetUpdated() {
     if (m_LeaseSetUpdateStatus != eLeaseSetDoNotSend)
       m_LeaseSetUpdateStatus = eLeaseSetUpdated;
@@ -156,6 +198,18 @@ class GarlicRoutingSession
   };
 
  private:
+  /// @brief Writes an X25519 establishment block: ephemeral key
+  ///   agreement against the peer's published static key, sealing the
+  ///   session key and pre-IV. Replaces the 2048-bit ElGamal bootstrap
+  /// @param buf Receives X25519_GARLIC_BLOCK_SIZE bytes; the session IV
+  ///   is set as a side effect, mirroring the ElGamal path
+  /// @param static_key Peer's static X25519 key
+  /// @return False when the peer key is degenerate (caller falls back
+  ///   to ElGamal)
+  bool CreateX25519Block(
+      std::uint8_t* buf,
+      const std::uint8_t* static_key);
+
   std::size_t CreateAESBlock(
       std::uint8_t* buf,
       std::shared_ptr<const I2NPMessage> msg);
@@ -179,12 +233,20 @@ class GarlicRoutingSession
 
   UnconfirmedTags* GenerateSessionTags();
 
+  // Grows the batch size after running dry (ElGamal fallback mid-session)
+  // or decays it toward the configured count when tags expire unused
+  void AdjustTagWindow(
+      bool exhausted);
+
  private:
   GarlicDestination* m_Owner;
   std::shared_ptr<const kovri::core::RoutingDestination> m_Destination;
   kovri::core::AESKey m_SessionKey;
   std::list<SessionTag> m_SessionTags;
   int m_NumTags;
+  int m_TagWindow;  // adaptive count of tags generated per batch
+  bool m_TagsDelivered;  // a tag batch has been confirmed by the peer
+  int m_MessagesSinceAckRequest;  // messages wrapped since the last DeliveryStatus clove
   std::map<std::uint32_t, UnconfirmedTags *> m_UnconfirmedTagsMsgs;
 
   LeaseSetUpdateStatus m_LeaseSetUpdateStatus;
@@ -200,7 +262,7 @@ class GarlicDestination
     : public kovri::core::LocalDestination {
  public:
   GarlicDestination()
-      : m_LastTagsCleanupTime(0),
+      : m_TagSweepShard(0),
         m_Exception(__func__) {}
 
   ~GarlicDestination();
@@ -209,7 +271,23 @@ class GarlicDestination
       std::shared_ptr<const kovri::core::RoutingDestination> destination,
       bool attach_lease_set);
 
-  void CleanupRoutingSessions();
+  /// @brief Incremental expiry sweep, run periodically off the message
+  ///   path: processes a bounded slice of routing sessions plus one
+  ///   incoming-tag shard per call, resuming where the last call left off
+  void SweepExpiredTags();
+
+  /// @brief Persists every outbound session's key and unexpired tag set
+  ///   to path, encrypted at rest with a key derived from this
+  ///   destination's encryption private key. Call at shutdown
+  void SaveGarlicSessions(const std::string& path);
+
+  /// @brief Restores sessions saved by a previous run; each one seeds
+  ///   the next session created to the same peer (GetRoutingSession),
+  ///   which then wraps tag-based without a fresh ElGamal/X25519
+  ///   establishment. Consumes the file: the restored tags are
+  ///   single-use on the receiving side, so they must never be
+  ///   restored twice
+  void LoadGarlicSessions(const std::string& path);
 
   void RemoveCreatedSession(
       std::uint32_t msg_ID);
@@ -232,9 +310,34 @@ class GarlicDestination
       std::uint32_t msg_ID);
 
   virtual void ProcessGarlicMessage(std::shared_ptr<I2NPMessage> msg);
+  /// @brief Batch variant: a tunnel endpoint hands over all garlic
+  ///   messages of one processing cycle in a single call
+  virtual void ProcessGarlicMessages(
+      std::vector<std::shared_ptr<I2NPMessage>> msgs);
   virtual void ProcessDeliveryStatusMessage(std::shared_ptr<I2NPMessage> msg);
   virtual void SetLeaseSetUpdated();
 
+  /// @return Static X25519 private key for garlic establishment, or
+  ///   nullptr when this destination only accepts ElGamal
+  virtual const std::uint8_t* GetX25519PrivateKey() const noexcept {
+    return nullptr;
+  }
+
+  /// @return Service owning this destination's message processing, or
+  ///   nullptr: only destinations with one can have tag-miss decrypts
+  ///   offloaded, since the clove set is re-injected through it
+  virtual boost::asio::io_service* GetGarlicDispatchService() {
+    return nullptr;
+  }
+
+  /// @brief Tag-miss path: asymmetric establishment decrypt (X25519 or
+  ///   ElGamal) plus the AES block, then clove handling
+  /// @param reinject Post clove handling back to the dispatch service
+  ///   instead of running it on the calling (worker) thread
+  void DecryptTagMiss(
+      std::shared_ptr<I2NPMessage> msg,
+      bool reinject);
+
   // TODO(unassigned): ???
   virtual std::shared_ptr<const kovri::core::LeaseSet> GetLeaseSet() = 0;
   virtual std::shared_ptr<kovri::core::TunnelPool> GetTunnelPool() const = 0;
@@ -249,26 +352,76 @@ class GarlicDestination
   void HandleDeliveryStatusMessage(std::shared_ptr<I2NPMessage> msg);
 
  private:
+  /// @brief Opens an X25519 establishment block
+  /// @param private_key Our static X25519 private key
+  /// @param buf Block of X25519_GARLIC_BLOCK_SIZE bytes
+  /// @param out Receives the 64-byte session key and pre-IV
+  /// @return False when key agreement or authentication fails
+  static bool OpenX25519Block(
+      const std::uint8_t* private_key,
+      const std::uint8_t* buf,
+      std::uint8_t* out);
+
   void HandleAESBlock(
       std::uint8_t* buf,
       std::size_t len,
       std::shared_ptr<kovri::core::CBCDecryption> decryption,
       std::shared_ptr<kovri::core::InboundTunnel> from);
 
+  /// @brief Tries X25519 then ElGamal on a tag-miss block and AES-decrypts
+  ///   the remainder in place
+  /// @param offset Receives the establishment block size on success
+  /// @return False when neither establishment form opens the block
+  bool DecryptGarlicBlock(
+      std::uint8_t* buf,
+      std::size_t length,
+      std::shared_ptr<kovri::core::CBCDecryption>& decryption,
+      std::size_t& offset);
+
   void HandleGarlicPayload(
       std::uint8_t* buf,
       std::size_t len,
       std::shared_ptr<kovri::core::InboundTunnel> from);
 
+ private:
+  // incoming session tags, sharded so concurrent messages for different
+  // peers look up and decrypt in parallel under separate locks
+  struct TagShard {
+    std::mutex mutex;
+    std::map<SessionTag,
+             std::shared_ptr<kovri::core::CBCDecryption>> tags;
+  };
+
+  // Session tags are uniformly random, so the first byte picks a shard
+  TagShard& GetTagShard(
+      const SessionTag& tag) {
+    return m_TagShards[tag()[0] & (NUM_INCOMING_TAG_SHARDS - 1)];
+  }
+
+  /// @brief Derives the at-rest key for the persisted session file from
+  ///   the destination's encryption private key (domain separated): any
+  ///   reader of that key could mint these sessions anyway
+  void DeriveStateKey(
+      kovri::core::AESKey& key) const;
+
+  // outbound session state persisted by a previous run, claimed by the
+  // next session created to the same peer
+  struct RestoredSession {
+    kovri::core::AESKey key;
+    std::list<SessionTag> tags;
+  };
+
  private:
   // outgoing sessions
   std::mutex m_SessionsMutex;
   std::map<kovri::core::IdentHash,
            std::shared_ptr<GarlicRoutingSession>> m_Sessions;
+  std::map<kovri::core::IdentHash, RestoredSession> m_RestoredSessions;
   // incoming
-  std::map<SessionTag,
-           std::shared_ptr<kovri::core::CBCDecryption>> m_Tags;
-  std::uint32_t m_LastTagsCleanupTime;
+  std::array<TagShard, NUM_INCOMING_TAG_SHARDS> m_TagShards;
+  // incremental sweep cursors (see SweepExpiredTags)
+  kovri::core::IdentHash m_SessionSweepCursor;
+  std::size_t m_TagSweepShard;
   // DeliveryStatus  (msg_ID -> session)
   std::map<std::uint32_t,
            std::shared_ptr<GarlicRoutingSession>> m_CreatedSessions;
@@ -276,6 +429,53 @@ class GarlicDestination
   core::Exception m_Exception;
 };
 
+/// @brief Tag-miss decrypts queued before Offload applies backpressure
+///   (callers then pay the asymmetric decrypt inline)
+const std::size_t GARLIC_DECRYPT_QUEUE_LIMIT = 1024;
+
+/// @class GarlicWorkerPool
+/// @brief Shared workers for tag-miss garlic decrypts
+/// @details A garlic message that misses the session-tag cache costs a
+///   full private-key operation; run inline, a burst of new sessions
+///   freezes every stream of the receiving destination. Destinations
+///   exposing a dispatch service hand the establishment decrypt to this
+///   pool and get the clove set posted back onto their own thread
+class GarlicWorkerPool {
+ public:
+  /// @brief Spawns workers per the garlic-decrypt-workers option
+  void Start();
+
+  /// @brief Wakes and joins the workers, dropping queued work
+  void Stop();
+
+  /// @brief Queues a tag-miss message for worker-side decryption
+  /// @return False when the pool is off, the destination has no dispatch
+  ///   service to re-inject through, or the queue is over its bound
+  bool Offload(
+      GarlicDestination* destination,
+      std::shared_ptr<I2NPMessage> msg);
+
+  /// @brief Blocks until every queued decrypt has finished; destinations
+  ///   must drain before destruction (workers hold raw pointers)
+  void Drain();
+
+ private:
+  void RunWorker();
+
+ private:
+  struct GarlicWorkItem {
+    GarlicDestination* destination;
+    std::shared_ptr<I2NPMessage> msg;
+  };
+
+  bool m_IsRunning = false;
+  std::atomic<std::size_t> m_Pending{0};
+  kovri::core::Queue<GarlicWorkItem> m_Queue;
+  std::vector<std::unique_ptr<std::thread>> m_Workers;
+};
+
+extern GarlicWorkerPool garlic_workers;
+
 }  // namespace core
 }  // namespace kovri
 
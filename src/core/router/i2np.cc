@@ -35,12 +35,14 @@
 #include <string.h>
 
 #include <atomic>
+#include <utility>
 
 #include "core/crypto/elgamal.h"
 #include "core/crypto/rand.h"
 #include "core/crypto/util/compression.h"
 #include "core/crypto/util/misc.h"
 
+#include "core/router/congestion.h"
 #include "core/router/context.h"
 #include "core/router/garlic.h"
 #include "core/router/net_db/impl.h"
@@ -48,6 +50,7 @@
 #include "core/router/tunnel/impl.h"
 
 #include "core/util/log.h"
+#include "core/util/metrics.h"
 #include "core/util/timestamp.h"
 
 #include "version.h"  // NOLINT(build/include)
@@ -89,7 +92,16 @@ void I2NPMessage::FillI2NPMessageHeader(
       kovri::core::GetMillisecondsSinceEpoch() +
       I2NP_HEADER_DEFAULT_EXPIRATION_TIME);
   UpdateSize();
-  UpdateChks();
+  // Tunnel message integrity is already covered by the layered tunnel
+  // AES and each transport's own MAC, and the chks byte only goes on
+  // the wire in the full NTCP header (SSU sends the short header). So
+  // their checksum is deferred to NTCP framing and never computed for
+  // SSU-bound or locally delivered messages; store-and-forward types
+  // (DatabaseStore et al.) keep the eager checksum
+  if (msg_type == I2NPTunnelData || msg_type == I2NPTunnelGateway)
+    SetChks(0);  // completed in NTCPSession::CreateMsgBuffer when needed
+  else
+    UpdateChks();
 }
 
 void I2NPMessage::RenewI2NPMessageHeader() {
@@ -142,24 +154,48 @@ std::shared_ptr<I2NPMessage> CreateI2NPMessage(
   return ToSharedI2NPMessage(std::move(msg));
 }
 
+namespace {
+/// @brief Message aliasing another message's buffer. Deliberately plain
+///   heap allocated (no pooled operator new): a view owns no block of its
+///   own and must never hand the parent's block back to the recycler; the
+///   held reference is what keeps that block alive instead
+struct I2NPMessageView : public I2NPMessage {
+  explicit I2NPMessageView(std::shared_ptr<I2NPMessage> parent)
+      : m_Parent(std::move(parent)) {
+    buf = m_Parent->buf;
+    max_len = m_Parent->max_len;
+    from = m_Parent->from;
+    transit = m_Parent->transit;
+  }
+  std::shared_ptr<I2NPMessage> m_Parent;
+};
+}  // namespace
+
+std::shared_ptr<I2NPMessage> CreateI2NPMessageView(
+    std::shared_ptr<I2NPMessage> parent,
+    std::size_t offset,
+    std::size_t length) {
+  auto view = std::make_shared<I2NPMessageView>(std::move(parent));
+  view->offset = offset;
+  view->len = offset + length;
+  return view;
+}
+
 // TODO(anonimal): bytestream refactor
 std::shared_ptr<I2NPMessage> CreateDeliveryStatusMsg(
     std::uint32_t msg_ID) {
   std::unique_ptr<I2NPMessage> m = NewI2NPShortMessage();
   std::uint8_t* buf = m->GetPayload();
   if (msg_ID) {
-      core::OutputByteStream::Write<std::uint32_t>(
-          buf + DELIVERY_STATUS_MSGID_OFFSET, msg_ID);
-      core::OutputByteStream::Write<std::uint64_t>(
-          buf + DELIVERY_STATUS_TIMESTAMP_OFFSET,
-          core::GetMillisecondsSinceEpoch());
+    core::OutputByteStream::WriteFixed(
+        buf + DELIVERY_STATUS_MSGID_OFFSET,
+        msg_ID,
+        core::GetMillisecondsSinceEpoch());
   } else {  // for SSU establishment
-    core::OutputByteStream::Write<std::uint32_t>(
+    core::OutputByteStream::WriteFixed(
         buf + DELIVERY_STATUS_MSGID_OFFSET,
-        kovri::core::Rand<std::uint32_t>());
-    core::OutputByteStream::Write<std::uint64_t>(
-        buf + DELIVERY_STATUS_TIMESTAMP_OFFSET,
-        I2P_NETWORK_ID);
+        kovri::core::Rand<std::uint32_t>(),
+        static_cast<std::uint64_t>(I2P_NETWORK_ID));
   }
   m->len += DELIVERY_STATUS_SIZE;
   m->FillI2NPMessageHeader(I2NPDeliveryStatus);
@@ -272,7 +308,8 @@ std::shared_ptr<I2NPMessage> CreateDatabaseSearchReply(
 // TODO(anonimal): bytestream refactor
 std::shared_ptr<I2NPMessage> CreateDatabaseStoreMsg(
     std::shared_ptr<const kovri::core::RouterInfo> router,
-    std::uint32_t reply_token) {
+    std::uint32_t reply_token,
+    std::shared_ptr<const std::vector<std::uint8_t>> compressed) {
   if (!router)  // we send own RouterInfo
     router = context.GetSharedRouterInfo();
   auto m = ToSharedI2NPMessage(NewI2NPShortMessage());
@@ -289,9 +326,14 @@ std::shared_ptr<I2NPMessage> CreateDatabaseStoreMsg(
       memcpy(buf, router->GetIdentHash(), 32);
       buf += 32;
     }
-    kovri::core::Gzip compressor;
-    compressor.Put(router->data(), router->size());
-    auto size = compressor.MaxRetrievable();
+    std::uint64_t size;
+    if (compressed) {
+      size = compressed->size();
+    } else {
+      auto& compressor = kovri::core::ThreadLocalGzip();
+      compressor.Put(router->data(), router->size());
+      size = compressor.MaxRetrievable();
+    }
     core::OutputByteStream::Write<std::uint16_t>(buf, size);  // size
     buf += 2;
     m->len += (buf - payload);  // payload size
@@ -304,7 +346,10 @@ std::shared_ptr<I2NPMessage> CreateDatabaseStoreMsg(
       m = new_msg;
       buf = m->buf + m->len;
     }
-    compressor.Get(buf, size);
+    if (compressed)
+      memcpy(buf, compressed->data(), size);
+    else
+      kovri::core::ThreadLocalGzip().Get(buf, size);
     m->len += size;
     m->FillI2NPMessageHeader(I2NPDatabaseStore);
   } catch (...) {
@@ -349,6 +394,11 @@ bool HandleBuildRequestRecords(
     int num,
     std::uint8_t* records,
     std::uint8_t* clear_text) {
+  // Admission decision first: when severely overloaded, drop the build
+  // request before paying for the ElGamal record decrypt below
+  const auto admission = kovri::core::congestion.TransitAdmission();
+  if (admission == kovri::core::CongestionController::Level::Drop)
+    return false;
   // TODO(anonimal): this try block should be handled entirely by caller
   try {
     /**
@@ -387,7 +437,8 @@ bool HandleBuildRequestRecords(
          * higher levels of rejection.
          */
         if (context.AcceptsTunnels() &&
-            kovri::core::tunnels.GetTransitTunnels().size() <=
+            admission == kovri::core::CongestionController::Level::Accept &&
+            kovri::core::tunnels.GetNumTransitTunnels() <=
             MAX_NUM_TRANSIT_TUNNELS &&
             !kovri::core::transports.IsBandwidthExceeded()) {
           kovri::core::TransitTunnel* transit_tunnel =
@@ -436,7 +487,7 @@ bool HandleBuildRequestRecords(
             record + BUILD_RESPONSE_RECORD_RANDPAD_OFFSET,
             BUILD_RESPONSE_RECORD_RANDPAD_SIZE);
         // Get SHA256 of complete record
-        kovri::core::SHA256().CalculateDigest(
+        kovri::core::ThreadLocalSHA256().CalculateDigest(
             record + BUILD_RESPONSE_RECORD_SHA256HASH_OFFSET,
             record + BUILD_RESPONSE_RECORD_RANDPAD_OFFSET,
             BUILD_RESPONSE_RECORD_RANDPAD_SIZE + 1);  // + 1 byte for status/reply
@@ -617,10 +668,10 @@ std::unique_ptr<I2NPMessage> CreateTunnelGatewayMsg(
     std::size_t len) {
   std::unique_ptr<I2NPMessage> msg = NewI2NPMessage(len);
   std::uint8_t* payload = msg->GetPayload();
-  core::OutputByteStream::Write<std::uint32_t>(
-      payload + TUNNEL_GATEWAY_HEADER_TUNNELID_OFFSET, tunnel_ID);
-  core::OutputByteStream::Write<std::uint16_t>(
-      payload + TUNNEL_GATEWAY_HEADER_LENGTH_OFFSET, len);
+  core::OutputByteStream::WriteFixed(
+      payload + TUNNEL_GATEWAY_HEADER_TUNNELID_OFFSET,
+      tunnel_ID,
+      static_cast<std::uint16_t>(len));
   memcpy(payload + TUNNEL_GATEWAY_HEADER_SIZE, buf, len);
   msg->len += TUNNEL_GATEWAY_HEADER_SIZE + len;
   msg->FillI2NPMessageHeader(I2NPTunnelGateway);
@@ -633,11 +684,11 @@ std::shared_ptr<I2NPMessage> CreateTunnelGatewayMsg(
   if (msg->offset >= I2NP_HEADER_SIZE + TUNNEL_GATEWAY_HEADER_SIZE) {
     // message is capable to be used without copying
     std::uint8_t* payload = msg->GetBuffer() - TUNNEL_GATEWAY_HEADER_SIZE;
-    core::OutputByteStream::Write<std::uint32_t>(
-        payload + TUNNEL_GATEWAY_HEADER_TUNNELID_OFFSET, tunnel_ID);
     int len = msg->GetLength();
-    core::OutputByteStream::Write<std::uint16_t>(
-        payload + TUNNEL_GATEWAY_HEADER_LENGTH_OFFSET, len);
+    core::OutputByteStream::WriteFixed(
+        payload + TUNNEL_GATEWAY_HEADER_TUNNELID_OFFSET,
+        tunnel_ID,
+        static_cast<std::uint16_t>(len));
     msg->offset -= (I2NP_HEADER_SIZE + TUNNEL_GATEWAY_HEADER_SIZE);
     msg->len = msg->offset + I2NP_HEADER_SIZE + TUNNEL_GATEWAY_HEADER_SIZE +len;
     msg->FillI2NPMessageHeader(I2NPTunnelGateway);
@@ -667,10 +718,10 @@ std::unique_ptr<I2NPMessage> CreateTunnelGatewayMsg(
   len = msg->GetLength();
   msg->offset -= gateway_msg_offset;
   std::uint8_t* payload = msg->GetPayload();
-  core::OutputByteStream::Write<std::uint32_t>(
-      payload + TUNNEL_GATEWAY_HEADER_TUNNELID_OFFSET, tunnel_ID);
-  core::OutputByteStream::Write<std::uint16_t>(
-      payload + TUNNEL_GATEWAY_HEADER_LENGTH_OFFSET, len);
+  core::OutputByteStream::WriteFixed(
+      payload + TUNNEL_GATEWAY_HEADER_TUNNELID_OFFSET,
+      tunnel_ID,
+      static_cast<std::uint16_t>(len));
   msg->FillI2NPMessageHeader(I2NPTunnelGateway);  // gateway message
   return msg;
 }
@@ -719,56 +770,97 @@ void HandleI2NPMessage(
   }
 }
 
+// Sinks for the flat dispatch table below. Ownership moves into the
+// selected sink: each hand-off is the last use of msg on its path, so no
+// refcount pair is paid per layer
+namespace {
+
+void DispatchTunnelData(std::shared_ptr<I2NPMessage> msg) {
+  LOG(debug) << "I2NPMessage: TunnelData";
+  kovri::core::tunnels.PostTunnelData(std::move(msg));
+}
+
+void DispatchTunnelGateway(std::shared_ptr<I2NPMessage> msg) {
+  LOG(debug) << "I2NPMessage: TunnelGateway";
+  kovri::core::tunnels.PostTunnelData(std::move(msg));
+}
+
+void DispatchGarlic(std::shared_ptr<I2NPMessage> msg) {
+  LOG(debug) << "I2NPMessage: Garlic";
+  if (msg->from) {
+    // hoisted so the move cannot precede the object expression
+    auto pool = msg->from->GetTunnelPool();
+    if (pool)
+      pool->ProcessGarlicMessage(std::move(msg));
+    else
+      LOG(debug)
+        << "I2NPMessage: local destination for garlic doesn't exist anymore";
+  } else {
+    context.ProcessGarlicMessage(std::move(msg));
+  }
+}
+
+void DispatchDatabase(std::shared_ptr<I2NPMessage> msg) {
+  // forward to netDb
+  kovri::core::netdb.PostI2NPMsg(std::move(msg));
+}
+
+void DispatchDeliveryStatus(std::shared_ptr<I2NPMessage> msg) {
+  LOG(debug) << "I2NPMessage: DeliveryStatus";
+  if (msg->from && msg->from->GetTunnelPool()) {
+    auto pool = msg->from->GetTunnelPool();
+    pool->ProcessDeliveryStatus(std::move(msg));
+  } else {
+    context.ProcessDeliveryStatusMessage(std::move(msg));
+  }
+}
+
+void DispatchTunnelBuild(std::shared_ptr<I2NPMessage> msg) {
+  // forward to tunnel thread
+  kovri::core::tunnels.PostTunnelData(std::move(msg));
+}
+
+// Everything rare or unexpected lands here, keeping the hot entries
+// above free of administrative branches
+void DispatchCold(std::shared_ptr<I2NPMessage> msg) {
+  HandleI2NPMessage(msg->GetBuffer(), msg->GetLength());
+}
+
+typedef void (*I2NPDispatchEntry)(std::shared_ptr<I2NPMessage>);
+
+struct I2NPDispatchTable {
+  I2NPDispatchEntry entry[256];
+};
+
+// Built at compile time: one flat, branch-free lookup on the type byte
+constexpr I2NPDispatchTable CreateI2NPDispatchTable() {
+  I2NPDispatchTable table{};
+  for (auto& entry : table.entry)
+    entry = &DispatchCold;
+  table.entry[I2NPTunnelData] = &DispatchTunnelData;
+  table.entry[I2NPTunnelGateway] = &DispatchTunnelGateway;
+  table.entry[I2NPGarlic] = &DispatchGarlic;
+  table.entry[I2NPDatabaseStore] = &DispatchDatabase;
+  table.entry[I2NPDatabaseSearchReply] = &DispatchDatabase;
+  table.entry[I2NPDatabaseLookup] = &DispatchDatabase;
+  table.entry[I2NPDeliveryStatus] = &DispatchDeliveryStatus;
+  table.entry[I2NPVariableTunnelBuild] = &DispatchTunnelBuild;
+  table.entry[I2NPVariableTunnelBuildReply] = &DispatchTunnelBuild;
+  table.entry[I2NPTunnelBuild] = &DispatchTunnelBuild;
+  table.entry[I2NPTunnelBuildReply] = &DispatchTunnelBuild;
+  return table;
+}
+
+constexpr I2NPDispatchTable I2NP_DISPATCH = CreateI2NPDispatchTable();
+
+}  // namespace
+
 void HandleI2NPMessage(
     std::shared_ptr<I2NPMessage> msg) {
-  if (msg) {
-    switch (msg->GetTypeID()) {
-      case I2NPTunnelData:
-        LOG(debug) << "I2NPMessage: TunnelData";
-        kovri::core::tunnels.PostTunnelData(msg);
-      break;
-      case I2NPTunnelGateway:
-        LOG(debug) << "I2NPMessage: TunnelGateway";
-        kovri::core::tunnels.PostTunnelData(msg);
-      break;
-      case I2NPGarlic: {
-        LOG(debug) << "I2NPMessage: Garlic";
-        if (msg->from) {
-          if (msg->from->GetTunnelPool())
-            msg->from->GetTunnelPool()->ProcessGarlicMessage(msg);
-          else
-            LOG(debug)
-              << "I2NPMessage: local destination for garlic doesn't exist anymore";
-        } else {
-          context.ProcessGarlicMessage(msg);
-        }
-        break;
-      }
-      case I2NPDatabaseStore:
-      case I2NPDatabaseSearchReply:
-      case I2NPDatabaseLookup:
-        // forward to netDb
-        kovri::core::netdb.PostI2NPMsg(msg);
-      break;
-      case I2NPDeliveryStatus: {
-        LOG(debug) << "I2NPMessage: DeliveryStatus";
-        if (msg->from && msg->from->GetTunnelPool())
-          msg->from->GetTunnelPool()->ProcessDeliveryStatus(msg);
-        else
-          context.ProcessDeliveryStatusMessage(msg);
-        break;
-      }
-      case I2NPVariableTunnelBuild:
-      case I2NPVariableTunnelBuildReply:
-      case I2NPTunnelBuild:
-      case I2NPTunnelBuildReply:
-        // forward to tunnel thread
-        kovri::core::tunnels.PostTunnelData(msg);
-      break;
-      default:
-        HandleI2NPMessage(msg->GetBuffer(), msg->GetLength());
-    }
-  }
+  if (!msg)
+    return;
+  std::uint8_t const type_ID = msg->GetTypeID();
+  I2NP_DISPATCH.entry[type_ID](std::move(msg));
 }
 
 I2NPMessagesHandler::~I2NPMessagesHandler() {
@@ -778,15 +870,22 @@ I2NPMessagesHandler::~I2NPMessagesHandler() {
 void I2NPMessagesHandler::PutNextMessage(
     std::shared_ptr<I2NPMessage> msg) {
   if (msg) {
+    // dead on arrival: shed it here, before tunnel crypto or routing
+    if (msg->IsExpired(kovri::core::GetMillisecondsSinceEpoch())) {
+      LOG(debug)
+        << "I2NPMessagesHandler: received message already expired, dropped";
+      metrics.Inc(Metrics::ExpiredMsgDrops);
+      return;
+    }
     switch (msg->GetTypeID()) {
       case I2NPTunnelData:
-        m_TunnelMsgs.push_back(msg);
+        m_TunnelMsgs.push_back(std::move(msg));
       break;
       case I2NPTunnelGateway:
-        m_TunnelGatewayMsgs.push_back(msg);
+        m_TunnelGatewayMsgs.push_back(std::move(msg));
       break;
       default:
-        HandleI2NPMessage(msg);
+        HandleI2NPMessage(std::move(msg));
     }
   }
 }
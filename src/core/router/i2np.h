@@ -47,6 +47,8 @@
 #include "core/router/lease_set.h"
 
 #include "core/util/exception.h"
+#include "core/util/memory_budget.h"
+#include "core/util/numa_slab.h"
 
 namespace kovri {
 namespace core {
@@ -146,6 +148,40 @@ enum I2NPMessageType {
   I2NPVariableTunnelBuildReply = 24
 };
 
+/// @enum I2NPMessagePriority
+/// @brief Priority classes for outbound I2NP messages. Control-plane
+///   messages (tunnel builds/replies, DeliveryStatus acks) are
+///   latency-critical and must not sit behind queued tunnel data during
+///   bulk transfers; see the transport send queues
+enum struct I2NPMessagePriority : std::uint8_t {
+  Control = 0,
+  Interactive = 1,
+  Bulk = 2,
+};
+
+const std::size_t I2NP_NUM_PRIORITIES = 3;
+
+/// @brief Slack in milliseconds before an expiration header is enforced,
+///   absorbing sender clock skew
+const std::uint64_t I2NP_MESSAGE_CLOCK_SKEW = 2 * 1000;
+
+/// @brief Classifies a message by its I2NP type ID
+inline I2NPMessagePriority GetI2NPMessagePriority(std::uint8_t type_ID) {
+  switch (type_ID) {
+    case I2NPDeliveryStatus:
+    case I2NPTunnelBuild:
+    case I2NPTunnelBuildReply:
+    case I2NPVariableTunnelBuild:
+    case I2NPVariableTunnelBuildReply:
+      return I2NPMessagePriority::Control;
+    case I2NPTunnelData:
+    case I2NPTunnelGateway:
+      return I2NPMessagePriority::Bulk;
+    default:
+      return I2NPMessagePriority::Interactive;
+  }
+}
+
 class InboundTunnel;
 class TunnelPool;
 
@@ -154,6 +190,9 @@ struct I2NPMessage {
   std::uint8_t* buf;
   std::size_t len, offset, max_len;
   std::shared_ptr<kovri::core::InboundTunnel> from;
+  /// @brief True when relayed on behalf of another router's tunnel;
+  ///   selects the transit class in the transport bandwidth scheduler
+  bool transit;
   core::Exception exception;
 
   I2NPMessage()
@@ -162,8 +201,13 @@ struct I2NPMessage {
         offset(2),
         max_len(0),
         from(nullptr),
+        transit(false),
         exception(__func__) {}
 
+  // virtual so deleting through an I2NPMessage pointer reaches the
+  // derived buffer's class-level operator delete (the recycling pool)
+  virtual ~I2NPMessage() {}
+
   // header accessors
   std::uint8_t* GetHeader() {
     return GetBuffer();
@@ -200,6 +244,13 @@ struct I2NPMessage {
         GetHeader() + I2NP_HEADER_EXPIRATION_OFFSET);
   }
 
+  /// @brief Past the expiration header (skew slack applied)?
+  /// @param now Milliseconds since epoch
+  bool IsExpired(std::uint64_t now) const {
+    const std::uint64_t expiration = GetExpiration();
+    return expiration && now > expiration + I2NP_MESSAGE_CLOCK_SKEW;
+  }
+
   void SetSize(std::uint16_t size) {
     core::OutputByteStream::Write<std::uint16_t>(
         GetHeader() + I2NP_HEADER_SIZE_OFFSET, size);
@@ -222,7 +273,8 @@ struct I2NPMessage {
     // TODO(anonimal): this try block should be handled entirely by caller
     try {
       std::uint8_t hash[32];
-      kovri::core::SHA256().CalculateDigest(hash, GetPayload(), GetPayloadLength());
+      kovri::core::ThreadLocalSHA256().CalculateDigest(
+          hash, GetPayload(), GetPayloadLength());
       GetHeader()[I2NP_HEADER_CHKS_OFFSET] = hash[0];
     } catch (...) {
       exception.Dispatch(__func__);
@@ -267,6 +319,7 @@ struct I2NPMessage {
     memcpy(buf + offset, other.buf + other.offset, other.GetLength());
     len = offset + other.GetLength();
     from = other.from;
+    transit = other.transit;
     max_len = other.max_len;
     return *this;
   }
@@ -316,12 +369,79 @@ struct I2NPMessage {
   void RenewI2NPMessageHeader();
 };
 
+/// @brief Thread-local free list of fixed-size message blocks: steady-state
+///   relaying recycles buffers instead of hitting malloc once per message
+/// @notes Blocks may be released on a different thread than they were
+///   acquired on; each thread simply caches what it frees, which matches the
+///   stable producer/consumer roles of the transport and tunnel threads
+template<int SZ>
+class I2NPMessagePool {
+ public:
+  static void* Acquire(
+      std::size_t size) {
+    auto& cache = Cache();
+    if (!cache.m_Blocks.empty()) {
+      void* block = cache.m_Blocks.back();
+      cache.m_Blocks.pop_back();
+      return block;
+    }
+    memory_budget.Add(MemoryBudget::I2NPPool, BlockSize);
+    // Miss path draws from the slab pool (plain heap when not enabled),
+    // so refills land NUMA-local and, optionally, on huge pages
+    return numa_slabs.Allocate(size);
+  }
+
+  static void Release(
+      void* block) {
+    auto& cache = Cache();
+    if (cache.m_Blocks.size() < MaxCachedBlocks) {
+      cache.m_Blocks.push_back(block);
+      return;
+    }
+    memory_budget.Sub(MemoryBudget::I2NPPool, BlockSize);
+    numa_slabs.Free(block);
+  }
+
+ private:
+  // per-thread cap; two size classes exist so worst case per thread is
+  // MaxCachedBlocks * (I2NP_MAX_MESSAGE_SIZE + I2NP_MAX_SHORT_MESSAGE_SIZE)
+  enum : std::size_t { MaxCachedBlocks = 64 };
+
+  // budgeted per block while allocated (live or cached); Release has no
+  // size argument, so the buffer size stands in for the exact figure (the
+  // I2NPMessage base adds a constant not worth plumbing through)
+  enum : std::size_t { BlockSize = SZ + 16 };
+
+  struct BlockCache {
+    ~BlockCache() {
+      memory_budget.Sub(
+          MemoryBudget::I2NPPool, m_Blocks.size() * BlockSize);
+      for (auto block : m_Blocks)
+        numa_slabs.Free(block);
+    }
+    std::vector<void*> m_Blocks;
+  };
+
+  static BlockCache& Cache() {
+    static thread_local BlockCache cache;
+    return cache;
+  }
+};
+
 template<int SZ>
 struct I2NPMessageBuffer : public I2NPMessage {
   I2NPMessageBuffer() {
     buf = m_Buffer;
     max_len = SZ;
   }
+  static void* operator new(
+      std::size_t size) {
+    return I2NPMessagePool<SZ>::Acquire(size);
+  }
+  static void operator delete(
+      void* block) {
+    I2NPMessagePool<SZ>::Release(block);
+  }
   std::uint8_t m_Buffer[SZ + 16] = {};
 };
 
@@ -348,6 +468,21 @@ std::shared_ptr<I2NPMessage> CreateI2NPMessage(
     int len,
     std::shared_ptr<kovri::core::InboundTunnel> from = nullptr);
 
+/// @brief Creates an aliasing view of a message embedded in another
+///   message's buffer: the view shares the parent's bytes (no allocation
+///   of a pooled block, no copy) but keeps its own offset/len bookkeeping,
+///   so several consumers can each hold an independent view of the same
+///   buffer. The view holds a reference on the parent, keeping the pooled
+///   buffer alive for as long as any view does
+/// @param parent Message whose buffer contains the embedded message
+/// @param offset Byte offset of the embedded message's I2NP header within
+///   the parent's buffer (absolute, i.e. counted from parent->buf)
+/// @param length Length of the embedded message in bytes
+std::shared_ptr<I2NPMessage> CreateI2NPMessageView(
+    std::shared_ptr<I2NPMessage> parent,
+    std::size_t offset,
+    std::size_t length);
+
 std::shared_ptr<I2NPMessage> CreateDeliveryStatusMsg(std::uint32_t msg_ID);
 
 std::shared_ptr<I2NPMessage> CreateRouterInfoDatabaseLookupMsg(
@@ -368,9 +503,12 @@ std::shared_ptr<I2NPMessage> CreateDatabaseSearchReply(
     const kovri::core::IdentHash& ident,
     std::vector<kovri::core::IdentHash> routers);
 
+/// @param compressed Optional pre-compressed RI payload (e.g. NetDb's
+///   per-entry reply cache); when set, the gzip pass is skipped
 std::shared_ptr<I2NPMessage> CreateDatabaseStoreMsg(
     std::shared_ptr<const kovri::core::RouterInfo> router = nullptr,
-    std::uint32_t reply_token = 0);
+    std::uint32_t reply_token = 0,
+    std::shared_ptr<const std::vector<std::uint8_t>> compressed = nullptr);
 std::shared_ptr<I2NPMessage> CreateDatabaseStoreMsg(
     std::shared_ptr<const kovri::core::LeaseSet> lease_set,
     std::uint32_t reply_token = 0);
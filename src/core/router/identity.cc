@@ -35,6 +35,11 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/date_time/gregorian/gregorian_types.hpp>
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
 #include "core/crypto/hash.h"
 #include "core/crypto/rand.h"
 #include "core/crypto/signature.h"
@@ -48,6 +53,123 @@ namespace core {
 
 // TODO(unassigned): identity implementation needs a big refactor
 
+namespace {
+
+/// @brief Max ready verifiers kept by the cache
+const std::size_t VERIFIER_CACHE_SIZE = 512;
+
+/// @brief Hashes an ident hash's leading bytes (already uniformly random)
+struct VerifierCacheHasher {
+  std::size_t operator()(const IdentHash& ident) const {
+    std::uint64_t hash;
+    std::memcpy(&hash, ident(), sizeof(hash));
+    return hash;
+  }
+};
+
+/// @class VerifierCache
+/// @brief LRU cache of ready signature verifiers keyed by ident hash.
+///   Transient IdentityEx copies (LeaseSet refreshes, streaming packet
+///   verification) re-ran CreateVerifier and re-imported the public key
+///   into the crypto backend on every verification; the cache keeps the
+///   imported key alive across those copies
+class VerifierCache {
+ public:
+  std::shared_ptr<kovri::core::Verifier> Get(
+      const IdentHash& ident) {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    auto it = m_Entries.find(ident);
+    if (it == m_Entries.end())
+      return nullptr;
+    m_LRU.splice(m_LRU.begin(), m_LRU, it->second.position);
+    return it->second.verifier;
+  }
+
+  void Put(
+      const IdentHash& ident,
+      std::shared_ptr<kovri::core::Verifier> verifier) {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    auto it = m_Entries.find(ident);
+    if (it != m_Entries.end()) {
+      m_LRU.splice(m_LRU.begin(), m_LRU, it->second.position);
+      it->second.verifier = std::move(verifier);
+      return;
+    }
+    if (m_Entries.size() >= VERIFIER_CACHE_SIZE) {
+      m_Entries.erase(m_LRU.back());
+      m_LRU.pop_back();
+    }
+    m_LRU.push_front(ident);
+    m_Entries[ident] = Entry{std::move(verifier), m_LRU.begin()};
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<kovri::core::Verifier> verifier;
+    std::list<IdentHash>::iterator position;
+  };
+
+  std::mutex m_Mutex;
+  std::list<IdentHash> m_LRU;  // most recently used at the front
+  std::unordered_map<IdentHash, Entry, VerifierCacheHasher> m_Entries;
+};
+
+VerifierCache verifier_cache;
+
+/// @brief Sweep cadence of the identity intern pool, in insertions
+const std::size_t IDENTITY_POOL_SWEEP_INTERVAL = 1024;
+
+/// @class IdentityPool
+/// @brief Intern pool of immutable identities keyed by ident hash. The
+///   same peer identity (~400 bytes plus certificate) used to be copied
+///   by value into every stream, lease set, and router info referencing
+///   it; the pool hands out one shared instance per peer, alive exactly
+///   as long as any holder keeps it
+class IdentityPool {
+ public:
+  std::shared_ptr<const IdentityEx> Intern(
+      const IdentityEx& identity) {
+    const IdentHash& ident = identity.GetIdentHash();
+    std::unique_lock<std::mutex> l(m_Mutex);
+    auto it = m_Entries.find(ident);
+    if (it != m_Entries.end()) {
+      if (auto interned = it->second.lock())
+        return interned;
+    }
+    auto interned = std::make_shared<const IdentityEx>(identity);
+    m_Entries[ident] = interned;
+    if (++m_InsertsSinceSweep >= IDENTITY_POOL_SWEEP_INTERVAL)
+      Sweep();
+    return interned;
+  }
+
+ private:
+  /// @brief Drops entries whose last holder has gone away
+  void Sweep() {
+    m_InsertsSinceSweep = 0;
+    for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+      if (it->second.expired())
+        it = m_Entries.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  std::mutex m_Mutex;
+  std::size_t m_InsertsSinceSweep = 0;
+  std::unordered_map<IdentHash, std::weak_ptr<const IdentityEx>,
+                     VerifierCacheHasher> m_Entries;
+};
+
+IdentityPool identity_pool;
+
+}  // namespace
+
+std::shared_ptr<const IdentityEx> InternIdentity(
+    const IdentityEx& identity) {
+  return identity_pool.Intern(identity);
+}
+
 // TODO(unassigned): keep an eye open for alignment issues and for hacks like:
 // copy public and signing keys together
 //memcpy(public_key, keys.public_key, sizeof(public_key) + sizeof(signing_key));
@@ -242,7 +364,9 @@ IdentityEx& IdentityEx::operator=(const IdentityEx& other) {
         throw std::runtime_error("IdentityEx: other extended buffer is null");
       memcpy(m_ExtendedBuffer.get(), other.m_ExtendedBuffer.get(), m_ExtendedLen);
     }
-    m_Verifier.reset(nullptr);
+    m_Verifier.reset();
+    m_CachedBase32.clear();
+    m_CachedBase64.clear();
   }
   return *this;
 }
@@ -252,7 +376,9 @@ IdentityEx& IdentityEx::operator=(const Identity& standard) {
   m_IdentHash = m_StandardIdentity.Hash();
   m_ExtendedBuffer.reset(nullptr);
   m_ExtendedLen = 0;
-  m_Verifier.reset(nullptr);
+  m_Verifier.reset();
+  m_CachedBase32.clear();
+  m_CachedBase64.clear();
   return *this;
 }
 
@@ -265,6 +391,8 @@ std::size_t IdentityEx::FromBuffer(
   }
   m_ExtendedLen = 0;
   m_ExtendedBuffer.reset(nullptr);
+  m_CachedBase32.clear();
+  m_CachedBase64.clear();
   memcpy(&m_StandardIdentity, buf, DEFAULT_IDENTITY_SIZE);
   if (m_StandardIdentity.certificate.length) {
     m_ExtendedLen = boost::endian::big_to_native(m_StandardIdentity.certificate.length);
@@ -286,7 +414,7 @@ std::size_t IdentityEx::FromBuffer(
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
     throw;
   }
-  m_Verifier.reset(nullptr);
+  m_Verifier.reset();
   return GetFullLen();
 }
 
@@ -325,21 +453,65 @@ void IdentityEx::FromBase64(const std::string& encoded)
 
 std::string IdentityEx::ToBase32() const
 {
-  // TODO(anonimal): this max size is arbitrary. Realistically,
-  //   we'll only need a max with 387 + 4 for EdDSA-Ed25519 routers
-  //   which is a majority of the network. Note: do not set that size
-  //   until we remove implementing other signatures.
-  core::Buffer<core::DEFAULT_IDENTITY_SIZE, 1024> buf;
-  buf(ToBuffer(buf.data(), buf.size()));
-  return core::Base32::Encode(buf.data(), buf.size());
+  if (m_CachedBase32.empty())
+    {
+      // TODO(anonimal): this max size is arbitrary. Realistically,
+      //   we'll only need a max with 387 + 4 for EdDSA-Ed25519 routers
+      //   which is a majority of the network. Note: do not set that size
+      //   until we remove implementing other signatures.
+      core::Buffer<core::DEFAULT_IDENTITY_SIZE, 1024> buf;
+      buf(ToBuffer(buf.data(), buf.size()));
+      m_CachedBase32 = core::Base32::Encode(buf.data(), buf.size());
+    }
+  return m_CachedBase32;
 }
 
 std::string IdentityEx::ToBase64() const
 {
-  std::array<std::uint8_t, 1024> buf{{}};
-  std::size_t len = ToBuffer(buf.data(), buf.size());
-  std::string const encoded(core::Base64::Encode(buf.data(), len));
-  return encoded;
+  if (m_CachedBase64.empty())
+    {
+      std::array<std::uint8_t, 1024> buf{{}};
+      std::size_t len = ToBuffer(buf.data(), buf.size());
+      m_CachedBase64 = core::Base64::Encode(buf.data(), len);
+    }
+  return m_CachedBase64;
+}
+
+namespace
+{
+/// @brief Slot count of each per-thread ident hash encoding cache
+constexpr std::size_t IdentHashCacheSize = 64;
+
+/// @brief One direct-mapped cache slot; empty until first use
+struct CachedIdentHash
+{
+  IdentHash hash;
+  std::string encoded;
+};
+}  // namespace
+
+const std::string& ToBase32Cached(const IdentHash& ident)
+{
+  static thread_local std::array<CachedIdentHash, IdentHashCacheSize> cache;
+  CachedIdentHash& slot = cache[ident.GetLL()[0] % IdentHashCacheSize];
+  if (slot.encoded.empty() || !(slot.hash == ident))
+    {
+      slot.hash = ident;
+      slot.encoded = ident.ToBase32();
+    }
+  return slot.encoded;
+}
+
+const std::string& ToBase64Cached(const IdentHash& ident)
+{
+  static thread_local std::array<CachedIdentHash, IdentHashCacheSize> cache;
+  CachedIdentHash& slot = cache[ident.GetLL()[0] % IdentHashCacheSize];
+  if (slot.encoded.empty() || !(slot.hash == ident))
+    {
+      slot.hash = ident;
+      slot.encoded = ident.ToBase64();
+    }
+  return slot.encoded;
 }
 
 std::string GetCertificateTypeName(std::uint8_t type)
@@ -475,6 +647,10 @@ CryptoKeyType IdentityEx::GetCryptoKeyType() const {
 }
 
 void IdentityEx::CreateVerifier() const  {
+  // Reuse the imported key when any copy of this identity verified before
+  m_Verifier = verifier_cache.Get(m_IdentHash);
+  if (m_Verifier)
+    return;
   auto key_type = GetSigningKeyType();
   switch (key_type) {
     case SIGNING_KEY_TYPE_DSA_SHA1:
@@ -537,10 +713,12 @@ void IdentityEx::CreateVerifier() const  {
         << "IdentityEx: signing key type "
         << static_cast<int>(key_type) << " is not supported";
   }
+  if (m_Verifier)
+    verifier_cache.Put(m_IdentHash, m_Verifier);
 }
 
-void IdentityEx::DropVerifier() {
-  m_Verifier.reset(nullptr);
+void IdentityEx::DropVerifier() const {
+  m_Verifier.reset();
 }
 
 /**
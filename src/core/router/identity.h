@@ -53,9 +53,19 @@ namespace core {
 
 typedef Tag<32> IdentHash;
 
+/// @brief Base32 form of an ident hash through a small per-thread cache
+/// @notes Logging and host resolution keep encoding the same few hashes;
+///   the returned reference stays valid until the calling thread encodes
+///   another hash landing in the same (direct-mapped) slot
+const std::string& ToBase32Cached(const IdentHash& ident);
+
+/// @brief Base64 form of an ident hash through a small per-thread cache
+/// @notes See ToBase32Cached for reference lifetime
+const std::string& ToBase64Cached(const IdentHash& ident);
+
 inline std::string GetB32Address(
     const kovri::core::IdentHash& ident) {
-  return ident.ToBase32().append(".b32.i2p");
+  return ToBase32Cached(ident) + ".b32.i2p";
 }
 
 #pragma pack(1)
@@ -196,7 +206,7 @@ class IdentityEx {
 
   CryptoKeyType GetCryptoKeyType() const;
 
-  void DropVerifier();  // to save memory
+  void DropVerifier() const;  // to save memory
 
  private:
   void CreateVerifier() const;
@@ -204,12 +214,24 @@ class IdentityEx {
  private:
   Identity m_StandardIdentity;
   IdentHash m_IdentHash;
-  mutable std::unique_ptr<kovri::core::Verifier> m_Verifier;
+  // shared with the global verifier cache (see CreateVerifier)
+  mutable std::shared_ptr<kovri::core::Verifier> m_Verifier;
   std::uint16_t m_ExtendedLen;
   std::unique_ptr<std::uint8_t[]> m_ExtendedBuffer;
+  // lazily memoized encodings, cleared whenever the identity changes
+  // (same unguarded mutable pattern as m_Verifier)
+  mutable std::string m_CachedBase32, m_CachedBase64;
   core::Exception m_Exception;
 };
 
+/// @brief Returns the canonical shared copy of the given identity
+/// @details Interned per ident hash: every holder of the same peer
+///   identity shares one immutable instance (and its cached verifier and
+///   encodings) instead of a ~400-byte copy each, and identity equality
+///   becomes pointer comparison
+std::shared_ptr<const IdentityEx> InternIdentity(
+    const IdentityEx& identity);
+
 class PrivateKeys {  // for eepsites
  public:
   PrivateKeys();
@@ -322,6 +344,12 @@ class RoutingDestination {
 
   virtual bool IsDestination() const = 0;  // for garlic
 
+  /// @return Static X25519 key for garlic session establishment,
+  ///   or nullptr when this destination only accepts ElGamal
+  virtual const std::uint8_t* GetX25519StaticKey() const noexcept {
+    return nullptr;
+  }
+
   std::unique_ptr<const kovri::core::ElGamalEncryption>& GetElGamalEncryption() const {
     if (!m_ElGamalEncryption)
       m_ElGamalEncryption.reset(
@@ -55,7 +55,9 @@ namespace kovri
 namespace core
 {
 
-RouterInfo::RouterInfo() : m_Exception(__func__)
+RouterInfo::RouterInfo()
+    : m_Exception(__func__),
+      m_RouterIdentity(std::make_shared<const IdentityEx>())
 {
 }
 
@@ -64,14 +66,14 @@ RouterInfo::RouterInfo(
     const std::vector<std::pair<std::string, std::uint16_t>>& points,
     const std::pair<bool, bool>& has_transport,
     const std::uint8_t caps)
-    : m_Exception(__func__), m_RouterIdentity(keys.GetPublic())
+    : m_Exception(__func__), m_RouterIdentity(InternIdentity(keys.GetPublic()))
 {
   // TODO(anonimal): in core config, we guarantee validity of host and port but
   //  we don't guarantee here without said caller in place.
 
   // Log our identity
-  const IdentHash& hash = m_RouterIdentity.GetIdentHash();
-  LOG(info) << "RouterInfo: our router's ident: " << m_RouterIdentity.ToBase64();
+  const IdentHash& hash = m_RouterIdentity->GetIdentHash();
+  LOG(info) << "RouterInfo: our router's ident: " << m_RouterIdentity->ToBase64();
   LOG(info) << "RouterInfo: our router's ident hash: " << hash.ToBase64();
 
   // Set default caps
@@ -110,11 +112,14 @@ RouterInfo::RouterInfo(const std::string& path)
   ReadFromBuffer(false);
 }
 
-RouterInfo::RouterInfo(const std::uint8_t* buf, std::uint16_t len)
+RouterInfo::RouterInfo(
+    const std::uint8_t* buf,
+    std::uint16_t len,
+    bool verify_signature)
     : m_Exception(__func__),
       m_Buffer(buf, len)
 {
-  ReadFromBuffer(true);
+  ReadFromBuffer(verify_signature);
   m_IsUpdated = true;
 }
 
@@ -145,34 +150,90 @@ void RouterInfo::ReadFromFile()
     }
 }
 
+std::shared_ptr<RouterInfo> RouterInfo::Create(
+    const std::uint8_t* buf,
+    std::uint16_t len,
+    bool verify_signature)
+{
+  auto router = std::make_shared<RouterInfo>();
+  router->m_Buffer(buf, len);
+  if (!router->TryReadFromBuffer(verify_signature))
+    return nullptr;
+  router->m_IsUpdated = true;
+  return router;
+}
+
 void RouterInfo::ReadFromBuffer(bool verify_signature)
+{
+  if (!TryReadFromBuffer(verify_signature))
+    throw std::length_error("malformed router info");
+}
+
+bool RouterInfo::TryReadFromBuffer(bool verify_signature)
 {
   try
     {
       // Get + verify identity length from existing RI in buffer
+      IdentityEx identity;
       std::size_t const ident_len =
-          m_RouterIdentity.FromBuffer(m_Buffer.data(), m_Buffer.size());
+          identity.FromBuffer(m_Buffer.data(), m_Buffer.size());
       if (!ident_len)
-        throw std::length_error("null ident length");
+        {
+          LOG(warning) << "RouterInfo: null ident length";
+          return false;
+        }
+      m_RouterIdentity = InternIdentity(identity);
 
-      // Parse existing RI from buffer
-      std::string router_info(
-          reinterpret_cast<const char*>(m_Buffer.data()) + ident_len,
-          m_Buffer.size() - ident_len);
+      if (m_Buffer.size() < ident_len + sizeof(m_Timestamp))
+        {
+          LOG(warning) << "RouterInfo: truncated router info";
+          return false;
+        }
 
-      ParseRouterInfo(router_info);
+      // Published timestamp is needed eagerly (update freshness checks)
+      std::memcpy(
+          &m_Timestamp, m_Buffer.data() + ident_len, sizeof(m_Timestamp));
+      boost::endian::big_to_native_inplace(m_Timestamp);
+
+      // Defer address/option decoding until first accessed
+      m_IsParsed = false;
 
       // Verify signature
       if (verify_signature)
         {
           Verify();
-          m_RouterIdentity.DropVerifier();
+          m_RouterIdentity->DropVerifier();
         }
     }
   catch (...)
     {
       m_Exception.Dispatch(__func__);
-      throw;
+      return false;
+    }
+  return true;
+}
+
+void RouterInfo::EnsureParsed() const noexcept
+{
+  if (m_IsParsed)
+    return;
+  // Deferred from ReadFromBuffer. Logically const: decoding only
+  // materializes state the buffer already carries
+  auto& self = const_cast<RouterInfo&>(*this);
+  self.m_IsParsed = true;
+  try
+    {
+      std::size_t const ident_len = m_RouterIdentity->GetFullLen();
+      std::string router_info(
+          reinterpret_cast<const char*>(m_Buffer.data()) + ident_len,
+          m_Buffer.size() - ident_len);
+
+      self.ParseRouterInfo(router_info);
+    }
+  catch (...)
+    {
+      m_Exception.Dispatch(__func__);
+      self.SetUnreachable(true);
     }
 }
 
@@ -414,6 +475,8 @@ void RouterInfo::ParseRouterInfo(const std::string& router_info)
       // TODO(anonimal): review setter implementation
       if (key == GetTrait(Trait::Caps))
         SetCaps(value);
+      else if (key == GetTrait(Trait::GarlicKey))
+        SetGarlicKey(value);
     }
 
   // Router *should* be unreachable
@@ -435,6 +498,30 @@ void RouterInfo::SetDefaultOptions()
   //   netdb starts. We'll need to ensure the 'known' opts are set *after* netdb starts.
 }
 
+void RouterInfo::SetGarlicKey(const std::string& value)
+{
+  std::vector<std::uint8_t> key;
+  try
+    {
+      key = core::Base64::Decode(value.c_str(), value.size());
+    }
+  catch (...)
+    {
+      m_Exception.Dispatch("RouterInfo: invalid garlic key option");
+      return;
+    }
+
+  if (key.size() != m_GarlicKey.size())
+    {
+      LOG(warning) << "RouterInfo: " << __func__ << ": unexpected key size "
+                   << key.size();
+      return;
+    }
+
+  std::memcpy(m_GarlicKey.data(), key.data(), m_GarlicKey.size());
+  m_HasGarlicKey = true;
+}
+
 void RouterInfo::SetCaps(const std::string& caps)
 {
   LOG(debug) << "RouterInfo: " << __func__ << ": setting caps " << caps;
@@ -645,7 +732,10 @@ void RouterInfo::DisableV6()
       std::end(m_Addresses));
 }
 
-void RouterInfo::Update(const std::uint8_t* buf, std::uint16_t len)
+void RouterInfo::Update(
+    const std::uint8_t* buf,
+    std::uint16_t len,
+    bool verify_signature)
 {
   m_Buffer(buf, len);
   m_IsUpdated = true;
@@ -654,7 +744,7 @@ void RouterInfo::Update(const std::uint8_t* buf, std::uint16_t len)
   m_Caps = 0;
   m_Addresses.clear();
   m_Options.clear();
-  ReadFromBuffer(true);
+  ReadFromBuffer(verify_signature);
   // don't delete buffer until saved to file
 }
 
@@ -678,10 +768,10 @@ void RouterInfo::CreateBuffer(const PrivateKeys& private_keys)
       core::StringStream router_info;
       CreateRouterInfo(router_info, private_keys);
 
-      // Create buffer
+      // Create buffer (hoisted: Str() returns a copy per call)
+      const std::string ri(router_info.Str());
       m_Buffer(
-          reinterpret_cast<const std::uint8_t*>(router_info.Str().c_str()),
-          router_info.Str().size());
+          reinterpret_cast<const std::uint8_t*>(ri.c_str()), ri.size());
 
       // Verify signature
       Verify();
@@ -697,14 +787,19 @@ void RouterInfo::Verify()
 {
   try
     {
-      // Get RI length without signature
-      std::size_t const len =
-          m_Buffer.size() - m_RouterIdentity.GetSignatureLen();
+      // Get RI length without signature. Guard the subtraction: a
+      // buffer shorter than the signature itself would underflow
+      std::size_t const sig_len = m_RouterIdentity->GetSignatureLen();
+      if (m_Buffer.size() < sig_len + Size::MinUnsignedBuffer)
+        {
+          m_IsUnreachable = true;
+          return;
+        }
+      std::size_t const len = m_Buffer.size() - sig_len;
 
       // Confirm if valid and usable
       const std::uint8_t* buf = m_Buffer.data();
-      if (len < Size::MinUnsignedBuffer
-          || !m_RouterIdentity.Verify(buf, len, &buf[len]))
+      if (!m_RouterIdentity->Verify(buf, len, &buf[len]))
         m_IsUnreachable = true;
     }
   catch (...)
@@ -1085,12 +1180,13 @@ const std::string RouterInfo::GetDescription(
 
 const std::string RouterInfo::GetDescription(const std::string& tabs) const
 {
+  EnsureParsed();
   std::stringstream ss;
   boost::posix_time::ptime time_epoch(boost::gregorian::date(1970, 1, 1));
   boost::posix_time::ptime timestamp =
       time_epoch + boost::posix_time::milliseconds(m_Timestamp);
   ss << "RouterInfo: " << std::endl
-     << m_RouterIdentity.GetDescription(tabs + "\t") << tabs
+     << m_RouterIdentity->GetDescription(tabs + "\t") << tabs
      << "\tPublished: " << boost::posix_time::to_simple_string(timestamp)
      << std::endl
      << tabs << "\tOptions(" << m_Options.size() << "): " << std::endl;
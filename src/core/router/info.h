@@ -35,6 +35,7 @@
 
 #include <boost/asio.hpp>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
@@ -53,6 +54,7 @@
 #include "core/util/exception.h"
 #include "core/util/tag.h"
 #include "core/util/filesystem.h"
+#include "core/util/timestamp.h"
 
 namespace kovri {
 namespace core {
@@ -61,7 +63,11 @@ struct RouterInfoTraits
 {
   /// @enum Interval
   /// @brief RI intervals
-  enum Interval { Update = 1800 };  // 30 minutes
+  enum Interval
+  {
+    Update = 1800,  // 30 minutes
+    Flush = 30,  // re-sign/persist coalescing window, in seconds
+  };
 
   /// @enum Size
   /// @brief Router Info size constants
@@ -144,12 +150,14 @@ struct RouterInfoTraits
     // File-specific
     InfoFile,
     KeyFile,
+    GarlicKeyFile,
 
     // Option-specific
     RouterVersion,
     LeaseSets,
     Routers,
     NetID,
+    GarlicKey,
 
     // Address-specific
     NTCP,
@@ -190,6 +198,9 @@ struct RouterInfoTraits
         case Trait::KeyFile:
           return "router.key";
 
+        case Trait::GarlicKeyFile:
+          return "garlic.key";
+
         // Option-specific
         case Trait::RouterVersion:
           return "router.version";
@@ -203,6 +214,9 @@ struct RouterInfoTraits
         case Trait::NetID:
           return "netId";
 
+        case Trait::GarlicKey:
+          return "crypto.garlic.x25519";
+
         // Address-specific
         case Trait::NTCP:
           return "NTCP";
@@ -461,7 +475,27 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @brief Create RI from buffer
   /// @param buf RI buffer
   /// @param len RI length
-  RouterInfo(const std::uint8_t* buf, std::uint16_t len);
+  /// @param verify_signature Verify RI signature against its identity
+  /// @notes Pass false only when the buffer's signature has already been
+  ///   verified (e.g., by NetDb's verification workers)
+  /// @notes Only ident, timestamp and signature are processed eagerly;
+  ///   addresses and options are decoded on first access
+  RouterInfo(
+      const std::uint8_t* buf,
+      std::uint16_t len,
+      bool verify_signature = true);
+
+  /// @brief Create RI from buffer without unwinding on malformed input
+  /// @param buf RI buffer
+  /// @param len RI length
+  /// @param verify_signature Verify RI signature against its identity
+  /// @return Created RI, or nullptr if the buffer is malformed
+  /// @notes Preferred over the buffer constructor on paths fed from the
+  ///   network (flooding, reseed) where malformed input is routine
+  static std::shared_ptr<RouterInfo> Create(
+      const std::uint8_t* buf,
+      std::uint16_t len,
+      bool verify_signature = true);
 
   /// @class Introducer
   struct Introducer
@@ -518,7 +552,11 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @brief Updates RI with new RI from buffer
   /// @param buf New RI buffer
   /// @param len New RI length
-  void Update(const std::uint8_t* buf, std::uint16_t len);
+  /// @param verify_signature Verify new RI signature against its identity
+  void Update(
+      const std::uint8_t* buf,
+      std::uint16_t len,
+      bool verify_signature = true);
 
   /// @brief Loads RI buffer (by reading) if buffer is not yet available
   /// @notes Required by NetDb
@@ -585,11 +623,18 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   void clear()
   {
     // TODO(unassigned): we may also want to clear all options
+    EnsureParsed();  // addresses/options can't be decoded once buffer is gone
     m_Buffer.clear();
   }
 
   /// @return RI's router identity
   const IdentityEx& GetRouterIdentity() const noexcept
+  {
+    return *m_RouterIdentity;
+  }
+
+  /// @return Interned identity, for holders outliving this RI
+  std::shared_ptr<const IdentityEx> GetSharedRouterIdentity() const noexcept
   {
     return m_RouterIdentity;
   }
@@ -598,19 +643,30 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @notes implements RoutingDestination
   const IdentHash& GetIdentHash() const noexcept
   {
-    return m_RouterIdentity.GetIdentHash();
+    return m_RouterIdentity->GetIdentHash();
   }
 
   /// @return Abbreviated ident hash in base64
   std::string GetIdentHashAbbreviation() const
   {
-    return GetIdentHash().ToBase64().substr(0, 4);
+    return ToBase64Cached(GetIdentHash()).substr(0, 4);
   }
 
   /// @return RI's ident pubkey
   const std::uint8_t* GetEncryptionPublicKey() const noexcept
   {
-    return m_RouterIdentity.GetStandardIdentity().public_key;
+    return m_RouterIdentity->GetStandardIdentity().public_key;
+  }
+
+  /// @return Router's static X25519 garlic key, or nullptr when the
+  ///   router did not publish one
+  /// @notes implements RoutingDestination. Cached outside m_Options at
+  ///   parse time because NetDb clears options for regular routers
+  ///   after load (see NetDb::Load)
+  const std::uint8_t* GetX25519StaticKey() const noexcept
+  {
+    EnsureParsed();
+    return m_HasGarlicKey ? m_GarlicKey.data() : nullptr;
   }
 
   /// @brief Sets RI timestamp
@@ -625,6 +681,21 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
     return m_Timestamp;
   }
 
+  /// @brief Marks the RI as accessed now (tunnel candidate selection,
+  ///   answered lookups); NetDb retention demotes the least recently
+  ///   accessed entries first
+  void Touch() noexcept
+  {
+    m_LastAccess = kovri::core::GetMillisecondsSinceEpoch();
+  }
+
+  /// @return Milliseconds-since-epoch of the last recorded access
+  ///   (0 if never accessed)
+  std::uint64_t GetLastAccess() const noexcept
+  {
+    return m_LastAccess;
+  }
+
   /// @brief Sets RI capabilities *and* options
   /// @param caps capabiliti(es) to set
   void SetCaps(std::uint8_t caps);
@@ -632,6 +703,7 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @return RI capabilities
   std::uint8_t GetCaps() const noexcept
   {
+    EnsureParsed();
     return m_Caps;
   }
 
@@ -652,12 +724,14 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @return Mutable RI options
   std::map<std::string, std::string>& GetOptions() noexcept
   {
+    EnsureParsed();
     return m_Options;
   }
 
   /// @return Immutable RI options
   const std::map<std::string, std::string>& GetOptions() const noexcept
   {
+    EnsureParsed();
     return m_Options;
   }
 
@@ -672,6 +746,7 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @return True if reachable
   bool IsUnreachable() const noexcept
   {
+    EnsureParsed();  // reachability is determined while decoding addresses
     return m_IsUnreachable;
   }
 
@@ -692,12 +767,14 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @return Mutable RI addresses
   std::vector<Address>& GetAddresses() noexcept
   {
+    EnsureParsed();
     return m_Addresses;
   }
 
   /// @return Immutable RI addresses
   const std::vector<Address>& GetAddresses() const noexcept
   {
+    EnsureParsed();
     return m_Addresses;
   }
 
@@ -707,9 +784,17 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @return True if supports
   bool HasTransport(const std::uint8_t transport) const noexcept
   {
+    EnsureParsed();
     return m_SupportedTransports & transport;
   }
 
+  /// @return Supported transport bits, see Transport
+  std::uint8_t GetSupportedTransports() const noexcept
+  {
+    EnsureParsed();
+    return m_SupportedTransports;
+  }
+
   /// @brief Does RI support NTCP?
   /// @return True if supports
   bool HasNTCP(bool has_v6 = false) const noexcept
@@ -743,6 +828,8 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @return True if compatible
   bool HasCompatibleTransports(const RouterInfo& other) const noexcept
   {
+    EnsureParsed();
+    other.EnsureParsed();
     return m_SupportedTransports & other.m_SupportedTransports;
   }
 
@@ -751,6 +838,7 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @return True if available
   bool HasCap(Cap cap) const noexcept
   {
+    EnsureParsed();
     return m_Caps & cap;
   }
 
@@ -767,13 +855,6 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
     return false;
   }
 
-  /// @brief Save RI profile
-  void SaveProfile()
-  {
-    if (m_Profile)
-      m_Profile->Save();
-  }
-
   /// @brief Human readable description of Introducer members
   /// @param introducer Introducer class to get description from
   /// @param tabs Prefix for tabulations
@@ -803,8 +884,22 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
 
   /// @brief Read RI from byte stream buffer
   /// @param verify_signature True if we should verify RI signature against identity
+  /// @notes Defers address/option decoding, see EnsureParsed
+  / @throws std::length_error if the buffer is malformed
   void ReadFromBuffer(bool verify_signature);
 
+  /// @brief Read RI from byte stream buffer, reporting malformed input
+  ///   through the return value instead of unwinding
+  /// @param verify_signature True if we should verify RI signature against identity
+  /// @return false if the buffer is malformed
+  bool TryReadFromBuffer(bool verify_signature);
+
+  /// @brief Decodes deferred addresses/options from the RI buffer
+  /// @notes Most RIs received in floods are only ever used for their
+  ///   ident, so the expensive decode is paid on first real use.
+  ///   A malformed body marks the RI unreachable instead of throwing
+  void EnsureParsed() const noexcept;
+
   /// @brief Parses complete RI
   /// @param router_info Object to write RI to
   void ParseRouterInfo(const std::string& router_info);
@@ -812,6 +907,10 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   /// @brief Set RI capabilities from string of caps flag(s)
   void SetCaps(const std::string& caps);
 
+  /// @brief Decodes and caches the published static X25519 garlic key
+  /// @param value Base64-encoded key option value
+  void SetGarlicKey(const std::string& value);
+
   /// @return Capabilities flags in string form
   const std::string GetCapsFlags() const;
 
@@ -832,12 +931,19 @@ class RouterInfo : public RouterInfoTraits, public RoutingDestination
   core::Exception m_Exception;
   core::Buffer<Size::MinBuffer, Size::MaxBuffer> m_Buffer;
   std::string m_Path;
-  IdentityEx m_RouterIdentity;
+  // interned: shared with every other holder of this router's identity
+  std::shared_ptr<const IdentityEx> m_RouterIdentity;
   std::uint64_t m_Timestamp{};
+  // coarse last-access stamp for NetDb retention (0 = never accessed)
+  std::uint64_t m_LastAccess{};
   std::vector<Address> m_Addresses;
   std::map<std::string, std::string> m_Options;
   bool m_IsUpdated = false, m_IsUnreachable = false;
+  bool m_IsParsed = true;  // buffer-built RIs reset this, see EnsureParsed
   std::uint8_t m_SupportedTransports{}, m_Caps{};
+  // static X25519 garlic key, cached so it survives option clearing
+  std::array<std::uint8_t, 32> m_GarlicKey{{}};
+  bool m_HasGarlicKey = false;
   mutable std::shared_ptr<RouterProfile> m_Profile;
 };
 
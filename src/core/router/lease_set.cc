@@ -34,6 +34,7 @@
 
 #include <cstring>
 
+#include "core/crypto/hash.h"
 #include "core/crypto/rand.h"
 
 #include "core/router/net_db/impl.h"
@@ -52,6 +53,9 @@ LeaseSet::LeaseSet(
   m_Buffer = std::make_unique<std::uint8_t[]>(len);
   memcpy(m_Buffer.get(), buf, len);
   m_BufferLen = len;
+  m_BufferCapacity = len;
+  kovri::core::ThreadLocalSHA256().CalculateDigest(
+      m_BufferHash.data(), m_Buffer.get(), m_BufferLen);
   ReadFromBuffer();
 }
 
@@ -63,11 +67,13 @@ LeaseSet::LeaseSet(
   if (!local_destination) {
     m_Buffer.reset(nullptr);
     m_BufferLen = 0;
+    m_BufferCapacity = 0;
     m_IsValid = false;
     LOG(error) << "LeaseSet: destination for local LeaseSet doesn't exist";
     return;
   }
   m_Buffer = std::make_unique<std::uint8_t[]>(MAX_LS_BUFFER_SIZE);
+  m_BufferCapacity = MAX_LS_BUFFER_SIZE;
   m_BufferLen = local_destination->GetIdentity().ToBuffer(
       m_Buffer.get(),
       MAX_LS_BUFFER_SIZE);
@@ -105,6 +111,8 @@ LeaseSet::LeaseSet(
       m_BufferLen,
       m_Buffer.get() + m_BufferLen);
   m_BufferLen += local_destination->GetIdentity().GetSignatureLen();
+  kovri::core::ThreadLocalSHA256().CalculateDigest(
+      m_BufferHash.data(), m_Buffer.get(), m_BufferLen);
   LOG(debug)
     << "LeaseSet: local LeaseSet of " << tunnels.size() << " leases created";
   ReadFromBuffer();
@@ -113,25 +121,72 @@ LeaseSet::LeaseSet(
 void LeaseSet::Update(
     const std::uint8_t* buf,
     std::size_t len) {
+  // Destinations republish every few minutes and the bytes are usually
+  // identical; the signature over them was already verified, so an
+  // unchanged digest means there is nothing to copy or re-parse
+  std::array<std::uint8_t, 32> digest;
+  kovri::core::ThreadLocalSHA256().CalculateDigest(digest.data(), buf, len);
+  if (m_IsValid && len == m_BufferLen && digest == m_BufferHash) {
+    LOG(debug) << "LeaseSet: unchanged, skipping reparse";
+    return;
+  }
+  // The identity block is immutable for a given destination; when its
+  // bytes match the previous buffer the expensive key parse is skipped
+  const std::size_t ident_len = m_Identity ? m_Identity->GetFullLen() : 0;
+  const bool reuse_identity =
+      m_IsValid &&
+      m_Identity &&
+      ident_len <= len &&
+      ident_len <= m_BufferLen &&
+      !memcmp(buf, m_Buffer.get(), ident_len);
   m_Leases.clear();
-  if (len > m_BufferLen) {
+  if (len > m_BufferCapacity) {
     m_Buffer = std::make_unique<std::uint8_t[]>(len);
+    m_BufferCapacity = len;
   }
   memcpy(m_Buffer.get(), buf, len);
   m_BufferLen = len;
-  ReadFromBuffer();
+  m_BufferHash = digest;
+  ReadFromBuffer(reuse_identity);
 }
 
-void LeaseSet::ReadFromBuffer() {
-  std::size_t size = m_Identity.FromBuffer(m_Buffer.get(), m_BufferLen);
+void LeaseSet::ReadFromBuffer(
+    bool reuse_identity) {
+  std::size_t size;
+  if (reuse_identity) {
+    size = m_Identity->GetFullLen();
+  } else {
+    IdentityEx identity;
+    size = identity.FromBuffer(m_Buffer.get(), m_BufferLen);
+    if (!size) {
+      LOG(warning) << "LeaseSet: malformed identity";
+      m_IsValid = false;
+      return;
+    }
+    m_Identity = InternIdentity(identity);
+  }
+  // bounds: encryption key + unused signing key + num byte
+  if (m_BufferLen
+      < size + 256 + m_Identity->GetSigningPublicKeyLen() + 1) {
+    LOG(warning) << "LeaseSet: truncated buffer";
+    m_IsValid = false;
+    return;
+  }
   memcpy(m_EncryptionKey.data(), m_Buffer.get() + size, 256);
   size += 256;  // encryption key
-  size += m_Identity.GetSigningPublicKeyLen();  // unused signing key
+  size += m_Identity->GetSigningPublicKeyLen();  // unused signing key
   std::uint8_t num = m_Buffer[size];
   size++;  // num
   LOG(debug) << "LeaseSet: num=" << static_cast<int>(num);
   if (!num)
     m_IsValid = false;
+  // bounds: leases (gateway + tunnel ID + end date each) + signature
+  if (m_BufferLen
+      < size + num * (32 + 4 + 8) + m_Identity->GetSignatureLen()) {
+    LOG(warning) << "LeaseSet: truncated leases";
+    m_IsValid = false;
+    return;
+  }
   // process leases
   const std::uint8_t* leases = m_Buffer.get() + size;
   for (int i = 0; i < num; i++) {
@@ -151,7 +206,7 @@ void LeaseSet::ReadFromBuffer() {
     }
   }
   // verify
-  if (!m_Identity.Verify(m_Buffer.get(), leases - m_Buffer.get(), leases)) {
+  if (!m_Identity->Verify(m_Buffer.get(), leases - m_Buffer.get(), leases)) {
     LOG(warning) << "LeaseSet: verification failed";
     m_IsValid = false;
   }
@@ -187,5 +242,13 @@ bool LeaseSet::HasNonExpiredLeases() const {
   return false;
 }
 
+std::uint64_t LeaseSet::GetLatestLeaseEndDate() const {
+  std::uint64_t latest = 0;
+  for (auto& it : m_Leases)
+    if (it.end_date > latest)
+      latest = it.end_date;
+  return latest;
+}
+
 }  // namespace core
 }  // namespace kovri
@@ -76,6 +76,11 @@ class LeaseSet : public RoutingDestination {
       std::size_t len);
 
   const IdentityEx& GetIdentity() const {
+    return *m_Identity;
+  }
+
+  /// @brief Interned identity, for holders outliving this LeaseSet
+  std::shared_ptr<const IdentityEx> GetSharedIdentity() const {
     return m_Identity;
   }
 
@@ -94,7 +99,7 @@ class LeaseSet : public RoutingDestination {
 
   // implements RoutingDestination
   const IdentHash& GetIdentHash() const {
-    return m_Identity.GetIdentHash();
+    return m_Identity->GetIdentHash();
   }
 
   const std::vector<Lease>& GetLeases() const {
@@ -108,6 +113,10 @@ class LeaseSet : public RoutingDestination {
 
   bool HasNonExpiredLeases() const;
 
+  /// @brief Milliseconds-since-epoch end date of the latest-expiring lease
+  /// @return 0 for a LeaseSet without leases
+  std::uint64_t GetLatestLeaseEndDate() const;
+
   const std::uint8_t* GetEncryptionPublicKey() const {
     return m_EncryptionKey.data();
   }
@@ -117,15 +126,23 @@ class LeaseSet : public RoutingDestination {
   }
 
  private:
-  void ReadFromBuffer();
+  /// @param reuse_identity  skip re-parsing the identity block; only valid
+  ///   when the caller has checked its bytes are unchanged
+  void ReadFromBuffer(
+      bool reuse_identity = false);
 
  private:
   bool m_IsValid;
   std::vector<Lease> m_Leases;
-  IdentityEx m_Identity;
+  // interned: shared with every other holder of this peer's identity
+  std::shared_ptr<const IdentityEx> m_Identity;
   std::array<std::uint8_t, 256> m_EncryptionKey;
   std::unique_ptr<std::uint8_t[]> m_Buffer;
   std::size_t m_BufferLen;
+  std::size_t m_BufferCapacity;
+  // SHA-256 of the current buffer; updates carrying identical bytes are
+  // detected here and skip the copy and re-parse entirely
+  std::array<std::uint8_t, 32> m_BufferHash{{}};
 };
 
 }  // namespace core
@@ -36,9 +36,13 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
+#include <map>
+#include <vector>
 
+#include "core/crypto/hash.h"
 #include "core/crypto/radix.h"
 #include "core/crypto/rand.h"
 #include "core/crypto/util/compression.h"
@@ -49,6 +53,8 @@
 
 #include "core/util/filesystem.h"
 #include "core/util/log.h"
+#include "core/util/memory_budget.h"
+#include "core/util/thread_registry.h"
 #include "core/util/timestamp.h"
 
 namespace kovri {
@@ -61,6 +67,13 @@ NetDb netdb;
 NetDb::NetDb()
     : m_IsRunning(false),
       m_Thread(nullptr),
+      m_ManageRequestsTimer(m_Service),
+      m_SaveTimer(m_Service),
+      m_ProfilesTimer(m_Service),
+      m_PublishTimer(m_Service),
+      m_FilterRotateTimer(m_Service),
+      m_ExploratoryTimer(m_Service),
+      m_Persister(nullptr),
       m_Exception(__func__) {}
 
 NetDb::~NetDb() {
@@ -71,113 +84,336 @@ bool NetDb::Start() {
   if (!Load())
     return false;
   m_IsRunning = true;
+  if (context.GetOpts().count("netdb-budget-mb"))
+    m_RetentionBudget =
+        static_cast<std::size_t>(
+            context.GetOpts()["netdb-budget-mb"].as<std::uint16_t>()) << 20;
+  std::uint16_t const num_workers = GetNumVerificationWorkers();
+  for (std::uint16_t i = 0; i < num_workers; i++)
+    m_VerificationWorkers.push_back(
+        std::make_unique<std::thread>(
+            std::bind(&NetDb::RunVerificationWorker, this)));
+  m_Persister =
+    std::make_unique<std::thread>(std::bind(&NetDb::RunPersister, this));
+  m_Work = std::make_unique<boost::asio::io_service::work>(m_Service);
+  ScheduleHousekeeping();
   m_Thread = std::make_unique<std::thread>(std::bind(&NetDb::Run, this));
   return m_IsRunning;
 }
 
+std::uint16_t NetDb::GetNumVerificationWorkers() const {
+  if (context.GetOpts().count("netdb-verify-workers"))
+    return context.GetOpts()["netdb-verify-workers"].as<std::uint16_t>();
+  return 0;
+}
+
 void NetDb::Stop() {
   if (m_IsRunning) {
-    for (auto it : m_RouterInfos)
-      it.second->SaveProfile();
     DeleteObsoleteProfiles();
-    m_RouterInfos.clear();
-    m_Floodfills.clear();
+    SaveRouterProfiles();
+    m_RouterInfos.Clear();
+    m_Floodfills.Clear();
     if (m_Thread) {
       m_IsRunning = false;
-      m_Queue.WakeUp();
+      m_ManageRequestsTimer.cancel();
+      m_SaveTimer.cancel();
+      m_ProfilesTimer.cancel();
+      m_PublishTimer.cancel();
+      m_FilterRotateTimer.cancel();
+      m_ExploratoryTimer.cancel();
+      m_Work.reset(nullptr);
+      m_Service.stop();
       m_Thread->join();
       m_Thread.reset(nullptr);
     }
-    m_LeaseSets.clear();
+    m_UnverifiedRouterInfos.WakeUp();
+    for (auto& worker : m_VerificationWorkers)
+      worker->join();
+    m_VerificationWorkers.clear();
+    if (m_Persister) {
+      // the persister drains whatever is still queued before exiting
+      m_PersistQueue.WakeUp();
+      m_Persister->join();
+      m_Persister.reset(nullptr);
+    }
+    m_LeaseSets.Clear();
     m_Requests.Stop();
+    m_StoreReplyCache.clear();
+    m_SearchReplyCache.clear();
+    m_StoreReplyCacheBytes = 0;
+    AccountReplyCaches();
   }
 }
 
 void NetDb::Run() {
-  std::uint32_t last_save = 0,
-           last_publish = 0,
-           last_exploratory = 0,
-           last_manage_request = 0;
+  thread_registry.Register("netdb");
   while (m_IsRunning) {
     try {
-      // if there are no messages a timeout is executed to wait
-      // for messages to be received
-      auto msg =
-        m_Queue.GetNextWithTimeout(Time::WaitForMessageTimeout);
-      if (msg) {
-        std::uint8_t num_msgs = 0;
-        while (msg) {
-          switch (msg->GetTypeID()) {
-            case I2NPDatabaseStore:
-              LOG(debug) << "NetDb: DatabaseStore";
-              HandleDatabaseStoreMsg(msg);
-            break;
-            case I2NPDatabaseSearchReply:
-              LOG(debug) << "NetDb: DatabaseSearchReply";
-              HandleDatabaseSearchReplyMsg(msg);
-            break;
-            case I2NPDatabaseLookup:
-              LOG(debug) << "NetDb: DatabaseLookup";
-              HandleDatabaseLookupMsg(msg);
-            break;
-            default:
-              // TODO(unassigned): error handling
-              LOG(error) << "NetDb: unexpected message type " << msg->GetTypeID();
-              // kovri::HandleI2NPMessage(msg);
-          }
-          if (num_msgs > Size::MaxMessagesRead)
-            break;
-          msg = m_Queue.Get();
-          num_msgs++;
-        }
-      }
-      if (!m_IsRunning)
+      m_Service.run();
+    } catch (const std::exception& ex) {
+      LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
+    }
+  }
+}
+
+void NetDb::HandleQueue() {
+  try {
+    // messages are drained in batches so one handler invocation
+    // amortizes the queue lock across them
+    std::vector<std::shared_ptr<const I2NPMessage>> msgs;
+    if (!m_Queue.GetBatch(msgs, Size::MaxMessagesRead))
+      return;
+    for (const auto& msg : msgs) {
+      switch (msg->GetTypeID()) {
+        case I2NPDatabaseStore:
+          LOG(debug) << "NetDb: DatabaseStore";
+          HandleDatabaseStoreMsg(msg);
         break;
-      std::uint64_t ts = kovri::core::GetSecondsSinceEpoch();
-      // builds tunnels for requested destinations
-      if (ts - last_manage_request >= Time::ManageRequests) {
-        m_Requests.ManageRequests();
-        last_manage_request = ts;
+        case I2NPDatabaseSearchReply:
+          LOG(debug) << "NetDb: DatabaseSearchReply";
+          HandleDatabaseSearchReplyMsg(msg);
+        break;
+        case I2NPDatabaseLookup:
+          LOG(debug) << "NetDb: DatabaseLookup";
+          HandleDatabaseLookupMsg(msg);
+        break;
+        default:
+          // TODO(unassigned): error handling
+          LOG(error) << "NetDb: unexpected message type " << msg->GetTypeID();
+          // kovri::HandleI2NPMessage(msg);
       }
-      // save routers, manage leasesets and validate subscriptions
-      if (ts - last_save >= Time::Save) {
-        if (last_save) {
-          SaveUpdated();
-          ManageLeaseSets();
+    }
+    // a full batch means more may be waiting: yield to timers and
+    // reschedule rather than starving housekeeping under a flood
+    if (msgs.size() == Size::MaxMessagesRead)
+      m_Service.post(std::bind(&NetDb::HandleQueue, this));
+  } catch (const std::exception& ex) {
+    LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
+  }
+}
+
+void NetDb::ScheduleHousekeeping() {
+  m_ManageRequestsTimer.expires_from_now(
+      boost::posix_time::seconds(Time::ManageRequests));
+  m_ManageRequestsTimer.async_wait(
+      std::bind(
+          &NetDb::HandleManageRequestsTimer, this, std::placeholders::_1));
+  m_SaveTimer.expires_from_now(boost::posix_time::seconds(Time::Save));
+  m_SaveTimer.async_wait(
+      std::bind(&NetDb::HandleSaveTimer, this, std::placeholders::_1));
+  m_ProfilesTimer.expires_from_now(
+      boost::posix_time::seconds(Time::SaveProfiles));
+  m_ProfilesTimer.async_wait(
+      std::bind(&NetDb::HandleProfilesTimer, this, std::placeholders::_1));
+  // first publish soon after startup (matching the old loop's first
+  // pass), then at the regular cadence
+  m_PublishTimer.expires_from_now(
+      boost::posix_time::seconds(Time::ManageRequests));
+  m_PublishTimer.async_wait(
+      std::bind(&NetDb::HandlePublishTimer, this, std::placeholders::_1));
+  m_FilterRotateTimer.expires_from_now(
+      boost::posix_time::seconds(Time::SeenStoreRotate));
+  m_FilterRotateTimer.async_wait(
+      std::bind(&NetDb::HandleFilterRotateTimer, this, std::placeholders::_1));
+  m_ExploratoryTimer.expires_from_now(
+      boost::posix_time::seconds(Time::ExploratoryBurst));
+  m_ExploratoryTimer.async_wait(
+      std::bind(&NetDb::HandleExploratoryTimer, this, std::placeholders::_1));
+}
+
+void NetDb::HandleManageRequestsTimer(
+    const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted)
+    return;
+  try {
+    // builds tunnels for requested destinations
+    m_Requests.ManageRequests();
+  } catch (const std::exception& ex) {
+    LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
+  }
+  m_ManageRequestsTimer.expires_from_now(
+      boost::posix_time::seconds(Time::ManageRequests));
+  m_ManageRequestsTimer.async_wait(
+      std::bind(
+          &NetDb::HandleManageRequestsTimer, this, std::placeholders::_1));
+}
+
+void NetDb::HandleSaveTimer(const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted)
+    return;
+  try {
+    // save routers, manage leasesets and validate subscriptions
+    SaveUpdated();
+    EnforceRetention();
+    ManageLeaseSets();
+  } catch (const std::exception& ex) {
+    LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
+  }
+  m_SaveTimer.expires_from_now(boost::posix_time::seconds(Time::Save));
+  m_SaveTimer.async_wait(
+      std::bind(&NetDb::HandleSaveTimer, this, std::placeholders::_1));
+}
+
+void NetDb::HandleProfilesTimer(const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted)
+    return;
+  try {
+    // sweep expired profiles and flush the table as one snapshot
+    DeleteObsoleteProfiles();
+    SaveRouterProfiles();
+  } catch (const std::exception& ex) {
+    LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
+  }
+  m_ProfilesTimer.expires_from_now(
+      boost::posix_time::seconds(Time::SaveProfiles));
+  m_ProfilesTimer.async_wait(
+      std::bind(&NetDb::HandleProfilesTimer, this, std::placeholders::_1));
+}
+
+void NetDb::HandlePublishTimer(const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted)
+    return;
+  try {
+    // publishes router info to a floodfill
+    Publish();
+  } catch (const std::exception& ex) {
+    LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
+  }
+  m_PublishTimer.expires_from_now(
+      boost::posix_time::seconds(Time::PublishRouterInfo));
+  m_PublishTimer.async_wait(
+      std::bind(&NetDb::HandlePublishTimer, this, std::placeholders::_1));
+}
+
+void NetDb::HandleFilterRotateTimer(const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted)
+    return;
+  // age the flood deduplication filters
+  m_SeenStores.Rotate();
+  m_FloodedTuples.Rotate();
+  m_FilterRotateTimer.expires_from_now(
+      boost::posix_time::seconds(Time::SeenStoreRotate));
+  m_FilterRotateTimer.async_wait(
+      std::bind(&NetDb::HandleFilterRotateTimer, this, std::placeholders::_1));
+}
+
+void NetDb::HandleExploratoryTimer(const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted)
+    return;
+  // adaptive exploration: cadence and fan-out follow how much of the
+  // network we already know, whether floodfills have been answering
+  // our exploratory lookups, and whether we have capacity to spare
+  std::uint64_t interval = Time::DelayedExploratory;
+  try {
+    auto const known_routers = GetNumRouters();
+    std::size_t replied = 0, expired = 0;
+    m_Requests.GetExploratoryStats(replied, expired);
+    std::uint16_t exploratory_count = Size::MinExploratoryTunnels;
+    if (known_routers < Size::MinKnownRouters) {
+      // bootstrap burst: short cadence, many parallel lookups each
+      // going to a different floodfill for fast convergence
+      interval = Time::ExploratoryBurst;
+      exploratory_count = Size::BurstExploratoryTunnels;
+    } else if (known_routers < Size::DesiredKnownRouters) {
+      interval = Time::Exploratory;
+      exploratory_count = Size::MaxExploratoryTunnels;
+    }
+    // advertise how many exploratory tunnels are worth keeping: wide
+    // while bootstrapping or while the lookup backlog grows, pared back
+    // to the floor once the database is warm, so the build and probe
+    // overhead returns to client pools (see Tunnels::ManageTunnelPools)
+    std::size_t desired = Size::ExploratoryPoolMin
+        + m_Requests.GetNumRequests() / Size::LookupsPerExploratoryTunnel;
+    if (known_routers < Size::MinKnownRouters)
+      desired = Size::ExploratoryPoolMax;
+    else if (expired > replied)
+      desired++;  // failing lookups: keep extra path diversity for retries
+    m_DesiredExploratoryTunnels =
+        std::min<std::size_t>(desired, Size::ExploratoryPoolMax);
+    if (context.IsCongested()
+        || kovri::core::transports.IsBandwidthExceeded()) {
+      // exploration is strictly lower priority than relayed
+      // traffic: sit this round out entirely
+    } else {
+      // when recent rounds mostly expired unanswered, hammering
+      // more floodfills just wastes tunnel bandwidth: halve fan-out
+      if (expired > replied
+          && exploratory_count > Size::MinExploratoryTunnels)
+        exploratory_count = std::max<std::uint16_t>(
+            Size::MinExploratoryTunnels, exploratory_count / 2);
+      m_Requests.ManageRequests();
+      Explore(exploratory_count);
+    }
+  } catch (const std::exception& ex) {
+    LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
+  }
+  m_ExploratoryTimer.expires_from_now(boost::posix_time::seconds(interval));
+  m_ExploratoryTimer.async_wait(
+      std::bind(&NetDb::HandleExploratoryTimer, this, std::placeholders::_1));
+}
+
+void NetDb::RunVerificationWorker() {
+  thread_registry.Register("netdb-verify");
+  while (m_IsRunning) {
+    try {
+      std::vector<std::shared_ptr<PendingRouterInfo>> batch;
+      if (!m_UnverifiedRouterInfos.GetBatchWithTimeout(
+              batch,
+              Size::MaxMessagesRead,
+              Time::WaitForMessageTimeout))
+        continue;
+      std::vector<std::shared_ptr<PendingRouterInfo>> verified;
+      for (const auto& pending : batch) {
+        const std::uint8_t* buf = pending->buffer.data();
+        std::size_t const len = pending->buffer.size();
+        IdentityEx identity;
+        if (!identity.FromBuffer(buf, len)) {
+          LOG(error) << "NetDb: unable to parse queued RouterInfo, dropped";
+          if (pending->stored)
+            pending->stored->SetUnreachable(true);
+          continue;
         }
-        last_save = ts;
-      }
-      // publishes router info to a floodfill at Nth interval
-      if (ts - last_publish >= Time::PublishRouterInfo) {
-        Publish();
-        last_publish = ts;
-      }
-      // builds exploratory tunnels at Nth interval to find more peers
-      if (ts - last_exploratory >= Time::Exploratory) {
-        // Set default exploratory count
-        std::uint16_t exploratory_count = Size::MinExploratoryTunnels;
-        // Get number of current available routers
-        auto known_routers = GetNumRouters();
-        // Evaluates if a router has a sufficient number of known routers
-        // to use for building tunnels and sets exploratory count as needed
-        if (known_routers < Size::DesiredKnownRouters
-            || ts - last_exploratory >= Time::DelayedExploratory) {
-          // Test if we're below the desired threshold
-          if (known_routers < Size::MinKnownRouters) {
-            // Set the max exploratory count
-            exploratory_count = Size::MaxExploratoryTunnels;
+        std::size_t const sig_len = identity.GetSignatureLen();
+        if (len < sig_len + RouterInfo::Size::MinUnsignedBuffer
+            || !identity.Verify(buf, len - sig_len, buf + len - sig_len)) {
+          if (pending->stored) {
+            // loaded as trusted; the next save cycle deletes it
+            LOG(error)
+              << "NetDb: stored RouterInfo failed re-verification, "
+              << "marked unreachable";
+            pending->stored->SetUnreachable(true);
+          } else {
+            LOG(error) << "NetDb: RouterInfo signature verification failed, dropped";
           }
+          continue;
         }
-        m_Requests.ManageRequests();
-        Explore(exploratory_count);
-        last_exploratory = ts;
+        if (pending->stored)
+          continue;  // already inserted at load; nothing more to do
+        verified.push_back(pending);
+      }
+      if (!verified.empty()) {
+        m_VerifiedRouterInfos.Put(verified);
+        // the NetDb thread inserts them
+        m_Service.post(std::bind(&NetDb::FlushVerifiedRouterInfos, this));
       }
-    } catch(const std::exception& ex) {
+    } catch (const std::exception& ex) {
       LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
     }
   }
 }
 
+void NetDb::FlushVerifiedRouterInfos() {
+  std::vector<std::shared_ptr<PendingRouterInfo>> verified;
+  if (!m_VerifiedRouterInfos.GetBatch(verified, Size::MaxMessagesRead))
+    return;
+  for (const auto& pending : verified)
+    AddRouterInfo(
+        pending->ident,
+        pending->buffer.data(),
+        pending->buffer.size(),
+        false);  // already checked by the worker
+}
+
 bool NetDb::AddRouterInfo(const std::uint8_t* buf, std::uint16_t len)
 {
   IdentityEx identity;
@@ -192,24 +428,32 @@ bool NetDb::AddRouterInfo(const std::uint8_t* buf, std::uint16_t len)
 void NetDb::AddRouterInfo(
     const IdentHash& ident,
     const std::uint8_t* buf,
-    std::uint16_t len)
+    std::uint16_t len,
+    bool verify_signature)
 {
   auto r = FindRouter(ident);
   if (r) {
     auto ts = r->GetTimestamp();
-    r->Update(buf, len);
-    if (r->GetTimestamp() > ts)
+    r->Update(buf, len, verify_signature);
+    if (r->GetTimestamp() > ts) {
       LOG(debug) << "NetDb: RouterInfo updated";
-  } else {
-    LOG(debug) << "NetDb: new RouterInfo added";
-    r = std::make_shared<RouterInfo> (buf, len); {
-      std::unique_lock<std::mutex> l(m_RouterInfosMutex);
-      m_RouterInfos[r->GetIdentHash()] = r;
+      // re-insert so the bucket descriptor reflects the new caps/addresses
+      m_RouterInfos.Insert(ident, r);
     }
-    if (r->HasCap(RouterInfo::Cap::Floodfill)) {
-      std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-      m_Floodfills.push_back(r);
+  } else {
+    r = RouterInfo::Create(buf, len, verify_signature);
+    if (!r) {
+      LOG(error) << "NetDb: malformed RouterInfo, dropping";
+      return;
     }
+    LOG(debug) << "NetDb: new RouterInfo added";
+    m_RouterInfos.Insert(r->GetIdentHash(), r);
+    if (r->HasCap(RouterInfo::Cap::Floodfill))
+      m_Floodfills.Insert(r);
+    // continuous retention: re-check the byte budget as the table
+    // grows instead of waiting out the next save cycle
+    if (++m_RoutersSinceRetention >= Size::RetentionCheckGrowth)
+      EnforceRetention();
   }
   // take care about requested destination
   m_Requests.RequestComplete(ident, r);
@@ -222,20 +466,22 @@ void NetDb::AddLeaseSet(
     std::shared_ptr<kovri::core::InboundTunnel> from)
 {
   if (!from) {  // unsolicited LS must be received directly
-    auto it = m_LeaseSets.find(ident);
-    if (it != m_LeaseSets.end()) {
-      it->second->Update(buf, len);
-      if (it->second->IsValid()) {
+    auto existing = m_LeaseSets.Find(ident);
+    if (existing) {
+      existing->Update(buf, len);
+      if (existing->IsValid()) {
         LOG(debug) << "NetDb: LeaseSet updated";
+        // reinsert so the expiry heap sees the refreshed lease ends
+        m_LeaseSets.Insert(ident, existing);
       } else {
         LOG(error) << "NetDb: LeaseSet update failed";
-        m_LeaseSets.erase(it);
+        m_LeaseSets.Erase(ident);
       }
     } else {
       auto lease_set = std::make_shared<LeaseSet>(buf, len);
       if (lease_set->IsValid()) {
         LOG(debug) << "NetDb: new LeaseSet added";
-        m_LeaseSets[ident] = lease_set;
+        m_LeaseSets.Insert(ident, lease_set);
       } else {
         LOG(error) << "NetDb: new LeaseSet validation failed";
       }
@@ -245,29 +491,23 @@ void NetDb::AddLeaseSet(
 
 std::shared_ptr<RouterInfo> NetDb::FindRouter(
     const IdentHash& ident) const {
-  std::unique_lock<std::mutex> l(m_RouterInfosMutex);
-  auto it = m_RouterInfos.find(ident);
-  if (it != m_RouterInfos.end())
-    return it->second;
-  else
-    return nullptr;
+  auto router = m_RouterInfos.Find(ident);
+  if (router)
+    router->Touch();  // retention recency
+  return router;
 }
 
 std::shared_ptr<LeaseSet> NetDb::FindLeaseSet(
     const IdentHash& destination) const {
-  auto it = m_LeaseSets.find(destination);
-  if (it != m_LeaseSets.end())
-    return it->second;
-  else
-    return nullptr;
+  return m_LeaseSets.Find(destination);
 }
 
 void NetDb::SetUnreachable(
     const IdentHash& ident,
     bool is_unreachable) {
-  auto it = m_RouterInfos.find(ident);
-  if (it != m_RouterInfos.end())
-    return it->second->SetUnreachable(is_unreachable);
+  auto router = m_RouterInfos.Find(ident);
+  if (router)
+    router->SetUnreachable(is_unreachable);
 }
 
 // TODO(unassigned): Move to reseed and/or scheduled tasks.
@@ -317,147 +557,320 @@ bool NetDb::Load()
   if (!CreateNetDb(path))
     return false;
   // Cleanup the database from previous attempts
-  m_RouterInfos.clear();
-  m_Floodfills.clear();
+  m_RouterInfos.Clear();
+  m_Floodfills.Clear();
   // Load RI's from given path
   std::size_t num_routers = 0;
-  auto LoadRouterInfos = [&](const boost::filesystem::path& path) {
-    std::uint64_t timestamp = kovri::core::GetMillisecondsSinceEpoch();
-    boost::filesystem::directory_iterator end;
-    for (boost::filesystem::directory_iterator dir(path); dir != end; ++dir)
+  std::uint64_t timestamp = kovri::core::GetMillisecondsSinceEpoch();
+  // With a worker pool configured, stored entries are re-checked there
+  // after startup instead of serially here
+  const bool recheck_stored = GetNumVerificationWorkers() > 0;
+  // Accepts a freshly parsed router unless it has expired
+  auto AddLoadedRouter = [&](const std::shared_ptr<RouterInfo>& router) {
+    if (router->IsUnreachable()
+        || (router->UsesIntroducer()
+            && timestamp >= router->GetTimestamp() + Time::RouterExpiration))
+      return false;
+    router->GetOptions().clear();  // options are not used for regular routers  // TODO(anonimal): review
+    m_RouterInfos.Insert(router->GetIdentHash(), router);
+    if (router->HasCap(RouterInfo::Cap::Floodfill))
+      m_Floodfills.Insert(router);
+    if (recheck_stored)
       {
-        if (boost::filesystem::is_directory(dir->status()))
+        auto pending = std::make_shared<PendingRouterInfo>();
+        pending->ident = router->GetIdentHash();
+        pending->buffer.assign(
+            router->data(), router->data() + router->size());
+        pending->stored = router;
+        m_UnverifiedRouterInfos.Put(pending);
+      }
+    num_routers++;
+    return true;
+  };
+  const auto pack_path = path / "router_infos.pack";
+  if (m_PackedStore.Open(pack_path))
+    {
+      // Parse straight out of the read-only mapping: RI bytes come from
+      // shared page cache and startup skips thousands of per-file opens
+      std::vector<IdentHash> expired;
+      m_PackedStore.ForEach(
+          [&](const IdentHash& ident,
+              const std::uint8_t* data,
+              std::uint16_t len) {
+            // Stored entries passed signature verification when first
+            // accepted, so loading trusts them; with a worker pool
+            // configured they are re-checked in the background
+            auto router = RouterInfo::Create(data, len, false);
+            if (router && AddLoadedRouter(router))
+              router->clear();
+            else
+              expired.push_back(ident);
+          });
+      for (const auto& ident : expired)
+        m_PackedStore.Erase(ident);
+    }
+  else
+    {
+      // Legacy per-file layout: scan once, migrating into the packed store
+      const bool migrate = m_PackedStore.Create(pack_path);
+      auto LoadRouterInfos = [&](const boost::filesystem::path& path) {
+        boost::filesystem::directory_iterator end;
+        for (boost::filesystem::directory_iterator dir(path); dir != end; ++dir)
           {
-            for (boost::filesystem::directory_iterator it(dir->path());
-                 it != end;
-                 ++it)
+            if (boost::filesystem::is_directory(dir->status()))
               {
-                const std::string& full_path = it->path().string();
-                auto router = std::make_shared<RouterInfo>(full_path);
-                if (!router->IsUnreachable()
-                    && (!router->UsesIntroducer()
-                        || timestamp < router->GetTimestamp()
-                                    + Time::RouterExpiration))
-                  {
-                    router->clear();
-                    router->GetOptions().clear();  // options are not used for regular routers  // TODO(anonimal): review
-                    m_RouterInfos.insert(std::make_pair(router->GetIdentHash(), router));
-                    if (router->HasCap(RouterInfo::Cap::Floodfill))
-                      m_Floodfills.push_back(router);
-                    num_routers++;
-                  }
-                else
+                for (boost::filesystem::directory_iterator it(dir->path());
+                     it != end;
+                     ++it)
                   {
-                    // Remove unreachable routers
-                    if (boost::filesystem::remove(full_path))
-                      LOG(debug) << "NetDb: " << full_path
-                                 << " unreachable router removed";
+                    const std::string& full_path = it->path().string();
+                    auto router = std::make_shared<RouterInfo>(full_path);
+                    if (AddLoadedRouter(router))
+                      {
+                        if (migrate)
+                          m_PackedStore.Append(
+                              router->GetIdentHash(),
+                              router->data(),
+                              router->size());
+                        router->clear();
+                      }
+                    else
+                      {
+                        // Remove unreachable routers
+                        if (boost::filesystem::remove(full_path))
+                          LOG(debug) << "NetDb: " << full_path
+                                     << " unreachable router removed";
+                      }
                   }
               }
           }
-      }
-  };
+      };
 // TODO(unassigned): this is a patch for #520 until we implement a database in #385
 #if defined(_WIN32) || defined(__APPLE__)
-  LoadRouterInfos(path / "uppercase");
-  LoadRouterInfos(path / "lowercase");
+      LoadRouterInfos(path / "uppercase");
+      LoadRouterInfos(path / "lowercase");
 #else
-  LoadRouterInfos(path);
+      LoadRouterInfos(path);
 #endif
+    }
   LOG(debug) << "NetDb: " << num_routers << " routers loaded";
-  LOG(debug) << "NetDb: " << m_Floodfills.size() << " floodfills loaded";
+  LOG(debug) << "NetDb: " << m_Floodfills.Size() << " floodfills loaded";
   return true;
 }
 
-void NetDb::SaveUpdated() {
-  auto GetFilePath = [](
-      const boost::filesystem::path& directory,
-      const RouterInfo* router_info) {
-    const std::string base64(router_info->GetIdentHash().ToBase64());
-    // TODO(unassigned): this is a patch for #520 until we implement a database in #385
-    std::string sub_dir;
+static boost::filesystem::path GetRouterFilePath(
+    const boost::filesystem::path& directory,
+    const RouterInfo* router_info) {
+  const std::string base64(ToBase64Cached(router_info->GetIdentHash()));
+  // TODO(unassigned): this is a patch for #520 until we implement a database in #385
+  std::string sub_dir;
 #if defined(_WIN32) || defined(__APPLE__)
-    sub_dir = std::isupper(base64[0]) ? "uppercase" : "lowercase";
+  sub_dir = std::isupper(base64[0]) ? "uppercase" : "lowercase";
 #endif
-    return directory / sub_dir / (std::string("r") + base64[0]) / ("router_info_" + base64 + ".dat");
-  };
+  return directory / sub_dir / (std::string("r") + base64[0]) / ("router_info_" + base64 + ".dat");
+}
+
+void NetDb::SaveUpdated() {
   boost::filesystem::path full_directory(core::GetPath(core::Path::NetDb));
   std::size_t count{}, deleted_count{}, total = GetNumRouters();
   std::uint64_t ts = kovri::core::GetMillisecondsSinceEpoch();
-  for (auto it : m_RouterInfos) {
-    if (it.second->IsUpdated()) {
-      std::string f = GetFilePath(full_directory, it.second.get()).string();
-      LOG(debug) << "NetDb: " << __func__ << " saving " << f;
-      it.second->SaveToFile(f);
-      it.second->SetUpdated(false);
-      it.second->SetUnreachable(false);
-      it.second->clear();
+  m_RouterInfos.ForEach([&](
+      const IdentHash&,
+      const std::shared_ptr<RouterInfo>& router) {
+    if (router->IsUpdated()) {
+      // queue a snapshot for the persister instead of writing inline;
+      // the buffer is copied because clear() below releases it
+      auto op = std::make_shared<PersistOp>();
+      op->type = PersistOp::Write;
+      op->ident = router->GetIdentHash();
+      op->path = GetRouterFilePath(full_directory, router.get()).string();
+      op->buffer.assign(router->data(), router->data() + router->size());
+      m_PersistQueue.Put(std::move(op));
+      router->SetUpdated(false);
+      router->clear();  // forces any deferred decode; must precede flag reset
+      router->SetUnreachable(false);
       count++;
     } else {
       // RouterInfo expires after N minutes if it uses an introducer
-      if (it.second->UsesIntroducer() && ts > it.second->GetTimestamp()
+      if (router->UsesIntroducer() && ts > router->GetTimestamp()
           + Time::RouterExpiration) {
-        it.second->SetUnreachable(true);
+        router->SetUnreachable(true);
         // if the router count is greater than the threshold check, and the router
         // is no longer starting up, then continue to check for unreachable routers
       } else if (total > Size::RouterUnreachableThreshold
           && ts > (context.GetStartupTime()
             + Time::RouterStartupPeriod) * 1000LL) {
         if (context.IsFloodfill()) {
-          if (ts > it.second->GetTimestamp()
+          if (ts > router->GetTimestamp()
               + Time::RouterExpiration) {
-            it.second->SetUnreachable(true);
+            router->SetUnreachable(true);
             total--;
           }
           //  if router count is higher, expiration date for unreachable
           //  peers is shorter
         } else if (total > Size::MaxRouterUnreachable) {
-          if (ts > it.second->GetTimestamp()
+          if (ts > router->GetTimestamp()
               + Time::RouterMinGracePeriod
               * Time::RouterExpiration) {
-            it.second->SetUnreachable(true);
+            router->SetUnreachable(true);
             total--;
           }
           //  if router count is low, expiration date for unreachable
           //  peers is longer
         } else if (total > Size::MinRouterUnreachable) {
-           if (ts > it.second->GetTimestamp()
+           if (ts > router->GetTimestamp()
                + Time::RouterMaxGracePeriod
                * Time::RouterExpiration) {
-            it.second->SetUnreachable(true);
+            router->SetUnreachable(true);
             total--;
           }
         }
       }
-      if (it.second->IsUnreachable()) {
+      if (router->IsUnreachable()) {
         total--;
-        // delete RI file
-        bool is_removed =
-	  boost::filesystem::remove(
-	      GetFilePath(full_directory, it.second.get()));
-	 if (is_removed)
-	   deleted_count++;
+        // queue RI file deletion
+        auto op = std::make_shared<PersistOp>();
+        op->type = PersistOp::Remove;
+        op->ident = router->GetIdentHash();
+        op->path = GetRouterFilePath(full_directory, router.get()).string();
+        m_PersistQueue.Put(std::move(op));
+        deleted_count++;
         // delete from floodfills list
-        if (it.second->HasCap(RouterInfo::Cap::Floodfill)) {
-          std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-          m_Floodfills.remove(it.second);
-        }
+        if (router->HasCap(RouterInfo::Cap::Floodfill))
+          m_Floodfills.Erase(router->GetIdentHash());
       }
     }
-  }
+  });
   if (count)
-    LOG(debug) << "NetDb: " << count << " new/updated routers saved";
+    LOG(debug) << "NetDb: " << count << " new/updated routers queued for save";
   if (deleted_count) {
-    LOG(debug) << "NetDb: " << deleted_count << " routers deleted";
+    LOG(debug) << "NetDb: " << deleted_count << " routers queued for deletion";
     // clean up RouterInfos table
-    std::unique_lock<std::mutex> l(m_RouterInfosMutex);
-    for (auto it = m_RouterInfos.begin(); it != m_RouterInfos.end();) {
-      if (it->second->IsUnreachable()) {
-        it->second->SaveProfile();
-        it = m_RouterInfos.erase(it);
-      } else {
-        it++;
+    // profiles outlive the RouterInfo in the in-memory table
+    m_RouterInfos.EraseIf(
+        [](const IdentHash&, const std::shared_ptr<RouterInfo>& router) {
+          return router->IsUnreachable();
+        });
+  }
+}
+
+void NetDb::EnforceRetention() {
+  if (!m_RetentionBudget)
+    return;
+  m_RoutersSinceRetention = 0;
+  struct Candidate {
+    std::uint64_t last_access;
+    std::shared_ptr<RouterInfo> router;
+  };
+  // approximate footprint: per-entry overhead plus held buffer bytes
+  std::size_t footprint = 0;
+  std::vector<Candidate> hot, warm;
+  m_RouterInfos.ForEach([&](
+      const IdentHash&,
+      const std::shared_ptr<RouterInfo>& router) {
+    footprint += Size::RouterEntryOverhead + router->size();
+    if (router->size())
+      hot.push_back({router->GetLastAccess(), router});
+    else if (!router->HasCap(RouterInfo::Cap::Floodfill))
+      warm.push_back({router->GetLastAccess(), router});
+  });
+  if (footprint <= m_RetentionBudget)
+    return;
+  auto Colder = [](const Candidate& a, const Candidate& b) {
+    return a.last_access < b.last_access;
+  };
+  // hot -> warm: evict serialized buffers, coldest first; entries not
+  // yet saved are snapshotted to the persister so no bytes are lost
+  std::sort(hot.begin(), hot.end(), Colder);
+  boost::filesystem::path full_directory(core::GetPath(core::Path::NetDb));
+  std::size_t demoted = 0, dropped = 0;
+  for (const auto& candidate : hot) {
+    if (footprint <= m_RetentionBudget)
+      break;
+    const auto& router = candidate.router;
+    if (router->IsUpdated()) {
+      auto op = std::make_shared<PersistOp>();
+      op->type = PersistOp::Write;
+      op->ident = router->GetIdentHash();
+      op->path = GetRouterFilePath(full_directory, router.get()).string();
+      op->buffer.assign(router->data(), router->data() + router->size());
+      m_PersistQueue.Put(std::move(op));
+      router->SetUpdated(false);
+    }
+    footprint -= router->size();
+    router->clear();
+    demoted++;
+  }
+  // warm -> cold: drop the whole entry; its bytes remain in the packed
+  // store (and per-router file) for the next load. Floodfills, recently
+  // accessed routers and a minimum working set are spared
+  if (footprint > m_RetentionBudget) {
+    std::sort(warm.begin(), warm.end(), Colder);
+    const std::uint64_t spare_after =
+        kovri::core::GetMillisecondsSinceEpoch()
+        - Time::RetentionAccessWindow * 1000ULL;
+    for (const auto& candidate : warm) {
+      if (footprint <= m_RetentionBudget
+          || candidate.last_access > spare_after  // sorted: rest are newer
+          || m_RouterInfos.Size() <= Size::MinKnownRouters)
+        break;
+      m_RouterInfos.Erase(candidate.router->GetIdentHash());
+      footprint -= Size::RouterEntryOverhead;
+      dropped++;
+    }
+  }
+  if (demoted || dropped)
+    LOG(debug) << "NetDb: retention demoted " << demoted
+               << " router buffers, dropped " << dropped << " cold entries";
+}
+
+void NetDb::RunPersister() {
+  thread_registry.Register("netdb-persist");
+  // keep draining after shutdown so queued snapshots reach disk
+  while (m_IsRunning || !m_PersistQueue.IsEmpty()) {
+    try {
+      std::vector<std::shared_ptr<PersistOp>> ops;
+      if (!m_PersistQueue.GetBatchWithTimeout(
+              ops,
+              Size::MaxPersistBatch,
+              Time::WaitForMessageTimeout))
+        continue;
+      // coalesce by path: a router queued several times in one backlog
+      // hits disk once, and a later removal supersedes earlier writes
+      std::map<std::string, std::shared_ptr<PersistOp>> coalesced;
+      for (auto& op : ops)
+        coalesced[op->path] = std::move(op);
+      std::size_t written = 0, removed = 0;
+      for (const auto& entry : coalesced) {
+        const auto& op = entry.second;
+        if (op->type == PersistOp::Write) {
+          LOG(debug) << "NetDb: " << __func__ << " saving " << op->path;
+          core::OutputFileStream stream(op->path, std::ofstream::binary);
+          if (stream.Fail()
+              || !stream.Write(op->buffer.data(), op->buffer.size())) {
+            LOG(error) << "NetDb: cannot save " << op->path;
+            continue;
+          }
+          m_PackedStore.Append(op->ident, op->buffer.data(), op->buffer.size());
+          written++;
+        } else {
+          if (boost::filesystem::remove(op->path))
+            removed++;
+          m_PackedStore.Erase(op->ident);
+        }
+      }
+      // Off the message path: rewrite the packed store once superseded
+      // records outweigh live ones
+      if (m_PackedStore.NeedsCompaction()) {
+        LOG(debug) << "NetDb: compacting packed router store";
+        m_PackedStore.Compact();
       }
+      if (written)
+        LOG(debug) << "NetDb: " << written << " new/updated routers saved";
+      if (removed)
+        LOG(debug) << "NetDb: " << removed << " routers deleted";
+    } catch (const std::exception& ex) {
+      LOG(error) << "NetDb: " << __func__ << " exception: " << ex.what();
     }
   }
 }
@@ -472,23 +885,27 @@ void NetDb::RequestDestination(
         request_complete);  // non-exploratory
   if (!dest) {
     LOG(debug)
-      << "NetDb: destination " << destination.ToBase64()
-      << " was already requested";
+      << "NetDb: destination " << ToBase64Cached(destination)
+      << " was already requested, completion attached";
     return;
   }
-  auto floodfill =
-    GetClosestFloodfill(
+  // Query the closest floodfills in parallel; the first reply wins and
+  // the rest are already excluded from any retry round
+  auto floodfills =
+    GetClosestFloodfills(
         destination,
+        NETDB_REQUEST_PARALLEL_LOOKUPS,
         dest->GetExcludedPeers());
-  if (floodfill) {
-    kovri::core::transports.SendMessage(
-        floodfill->GetIdentHash(),
-        dest->CreateRequestMessage(
-            floodfill->GetIdentHash()));
-  } else {
+  if (floodfills.empty()) {
     LOG(error) << "NetDb: no floodfills found";
     m_Requests.RequestComplete(destination, nullptr);
+    return;
   }
+  for (const auto& floodfill : floodfills)
+    kovri::core::transports.SendMessage(
+        floodfill,
+        dest->CreateRequestMessage(floodfill));
+  dest->ScheduleRetry();  // one round, regardless of fan-out
 }
 
 // TODO(anonimal): bytestream refactor
@@ -521,27 +938,50 @@ void NetDb::HandleDatabaseStoreMsg(
         LOG(error) << "NetDb: no outbound tunnels for DatabaseStore reply found";
     }
     offset += 32;
-    if (context.IsFloodfill()) {
-      // flood it
-      auto flood_msg = ToSharedI2NPMessage(NewI2NPShortMessage());
-      std::uint8_t* payload = flood_msg->GetPayload();
-      memcpy(payload, buf, 33);  // key + type
-      // zero reply token
-      core::OutputByteStream::Write<std::uint32_t>(
-          payload + DATABASE_STORE_REPLY_TOKEN_OFFSET, 0);
-      memcpy(payload + DATABASE_STORE_HEADER_SIZE, buf + offset, len - offset);
-      flood_msg->len += DATABASE_STORE_HEADER_SIZE + len -offset;
-      flood_msg->FillI2NPMessageHeader(I2NPDatabaseStore);
-      std::set<IdentHash> excluded;
-      for (std::uint8_t i = 0; i < 3; i++) {  // TODO(anonimal): enumerate
-        auto floodfill = GetClosestFloodfill(ident, excluded);
-        if (floodfill)
+  }
+  // One digest over the stored payload, folded to 64 bits: identifies
+  // this exact entry version for the deduplication filters below
+  std::uint64_t content_key;
+  {
+    std::array<std::uint8_t, 32> digest;
+    kovri::core::ThreadLocalSHA256().CalculateDigest(
+        digest.data(), buf + offset, len - offset);
+    memcpy(&content_key, digest.data(), sizeof(content_key));
+  }
+  if (reply_token && context.IsFloodfill()) {
+    // flood it
+    auto flood_msg = ToSharedI2NPMessage(NewI2NPShortMessage());
+    std::uint8_t* payload = flood_msg->GetPayload();
+    memcpy(payload, buf, 33);  // key + type
+    // zero reply token
+    core::OutputByteStream::Write<std::uint32_t>(
+        payload + DATABASE_STORE_REPLY_TOKEN_OFFSET, 0);
+    memcpy(payload + DATABASE_STORE_HEADER_SIZE, buf + offset, len - offset);
+    flood_msg->len += DATABASE_STORE_HEADER_SIZE + len -offset;
+    flood_msg->FillI2NPMessageHeader(I2NPDatabaseStore);
+    std::set<IdentHash> excluded;
+    for (std::uint8_t i = 0; i < 3; i++) {  // TODO(anonimal): enumerate
+      auto floodfill = GetClosestFloodfill(ident, excluded);
+      if (floodfill) {
+        // at most one send per (entry version, peer) per filter window
+        std::uint64_t peer_key;
+        memcpy(&peer_key, floodfill->GetIdentHash(), sizeof(peer_key));
+        if (m_FloodedTuples.Insert(
+                content_key ^ (peer_key * 0x9E3779B97F4A7C15ULL)))
           kovri::core::transports.SendMessage(
               floodfill->GetIdentHash(),
               flood_msg);
       }
     }
   }
+  // Re-received copy of an entry version processed moments ago: skip
+  // the decompression and signature verification entirely
+  if (!m_SeenStores.Insert(content_key)) {
+    LOG(debug)
+      << "NetDb: duplicate DatabaseStore for " << ToBase64Cached(ident)
+      << ", skipped";
+    return;
+  }
   if (buf[DATABASE_STORE_TYPE_OFFSET]) {  // type
     LOG(debug) << "NetDb: LeaseSet";
     AddLeaseSet(ident, buf + offset, len - offset, m->from);
@@ -556,7 +996,7 @@ void NetDb::HandleDatabaseStoreMsg(
       return;
     }
     try {
-      kovri::core::Gunzip decompressor;
+      auto& decompressor = kovri::core::ThreadLocalGunzip();
       decompressor.Put(buf + offset, size);
       std::array<std::uint8_t, RouterInfo::Size::MaxBuffer> uncompressed {{}};
       std::size_t uncompressed_size = decompressor.MaxRetrievable();
@@ -567,7 +1007,17 @@ void NetDb::HandleDatabaseStoreMsg(
 	return;
       }
       decompressor.Get(uncompressed.data(), uncompressed_size);
-      AddRouterInfo(ident, uncompressed.data(), uncompressed_size);
+      if (!m_VerificationWorkers.empty()) {
+        // signature check runs on a worker; the RI is inserted once the
+        // worker hands it back through the verified queue
+        auto pending = std::make_shared<PendingRouterInfo>();
+        pending->ident = ident;
+        pending->buffer.assign(
+            uncompressed.data(), uncompressed.data() + uncompressed_size);
+        m_UnverifiedRouterInfos.Put(pending);
+      } else {
+        AddRouterInfo(ident, uncompressed.data(), uncompressed_size);
+      }
     } catch (...) {
       m_Exception.Dispatch(__func__);
     }
@@ -593,43 +1043,38 @@ void NetDb::HandleDatabaseSearchReplyMsg(
         // reply to our destination. Try other floodfills
         if (outbound && inbound) {
           std::vector<kovri::core::TunnelMessageBlock> msgs;
-          auto count = dest->GetExcludedPeers().size();
-          std::uint8_t max_ff = 7;  // TODO(anonimal): enumerate or algorithm
-          if (count < max_ff) {
+          if (dest->GetNumAttempts() < NETDB_REQUEST_MAX_ATTEMPTS) {
             auto next_floodfill = GetClosestFloodfill(
                 dest->GetDestination(),
                 dest->GetExcludedPeers());
             if (next_floodfill) {
               // tell floodfill about us
-              msgs.push_back(
-                  kovri::core::TunnelMessageBlock {
+              msgs.emplace_back(
                   kovri::core::e_DeliveryTypeRouter,
                   next_floodfill->GetIdentHash(),
                   0,
-                  CreateDatabaseStoreMsg()
-                  });
+                  CreateDatabaseStoreMsg());
               // request destination
               LOG(debug)
                 << "NetDb: trying " << key
-                << " at " << count
-                << " floodfill " << next_floodfill->GetIdentHash().ToBase64();
+                << " at attempt " << dest->GetNumAttempts()
+                << " floodfill " << ToBase64Cached(next_floodfill->GetIdentHash());
               auto msg = dest->CreateRequestMessage(next_floodfill, inbound);
-              msgs.push_back(
-                  kovri::core::TunnelMessageBlock {
+              msgs.emplace_back(
                   kovri::core::e_DeliveryTypeRouter,
                   next_floodfill->GetIdentHash(),
                   0,
-                  msg
-                });
+                  std::move(msg));
+              dest->ScheduleRetry();
               delete_dest = false;
             }
           } else {
             LOG(warning)
-              << "NetDb: " << key << " was not found in "
-              << static_cast<std::size_t>(max_ff) << " floodfills";
+              << "NetDb: " << key << " was not found after "
+              << NETDB_REQUEST_MAX_ATTEMPTS << " attempts";
           }
           if (!msgs.empty())
-            outbound->SendTunnelDataMsg(msgs);
+            outbound->SendTunnelDataMsg(std::move(msgs));
         }
       }
       if (delete_dest)
@@ -660,6 +1105,52 @@ void NetDb::HandleDatabaseSearchReplyMsg(
   }
 }
 
+std::shared_ptr<const std::vector<std::uint8_t>> NetDb::GetCachedStoreReply(
+    const std::shared_ptr<const RouterInfo>& router) {
+  const IdentHash& ident = router->GetIdentHash();
+  auto it = m_StoreReplyCache.find(ident);
+  if (it != m_StoreReplyCache.end()) {
+    if (it->second.timestamp == router->GetTimestamp())
+      return it->second.payload;
+    // stale entry, replaced below
+    m_StoreReplyCacheBytes -= it->second.payload->size();
+  }
+  // Compress once, then serve from the cache until the router is updated
+  auto& compressor = kovri::core::ThreadLocalGzip();
+  compressor.Put(router->data(), router->size());
+  auto payload =
+      std::make_shared<std::vector<std::uint8_t>>(compressor.MaxRetrievable());
+  compressor.Get(payload->data(), payload->size());
+  if (m_StoreReplyCache.size() >= Size::MaxStoreReplyCache) {
+    m_StoreReplyCache.clear();
+    m_StoreReplyCacheBytes = 0;
+  }
+  m_StoreReplyCache[ident] = {router->GetTimestamp(), payload};
+  m_StoreReplyCacheBytes += payload->size();
+  AccountReplyCaches();
+  return payload;
+}
+
+void NetDb::AccountReplyCaches() {
+  // payloads dominate; the search cache is charged a flat per-entry
+  // figure (timestamp, three idents, node overhead)
+  memory_budget.Set(
+      MemoryBudget::NetDbCache,
+      m_StoreReplyCacheBytes + m_SearchReplyCache.size() * 160);
+}
+
+void NetDb::ShedReplyCaches() {
+  m_Service.post([this]() {
+    LOG(warning) << "NetDb: dropping " << m_StoreReplyCache.size()
+                 << " store / " << m_SearchReplyCache.size()
+                 << " search reply cache entries";
+    m_StoreReplyCache.clear();
+    m_SearchReplyCache.clear();
+    m_StoreReplyCacheBytes = 0;
+    AccountReplyCaches();
+  });
+}
+
 void NetDb::HandleDatabaseLookupMsg(
     std::shared_ptr<const I2NPMessage> msg) {
   const std::uint8_t* buf = msg->GetPayload();
@@ -715,7 +1206,8 @@ void NetDb::HandleDatabaseLookupMsg(
         LOG(debug) << "NetDb: requested RouterInfo " << key << " found";
         router->LoadBuffer();
         if (router->data())
-          reply_msg = CreateDatabaseStoreMsg(router);
+          reply_msg =
+              CreateDatabaseStoreMsg(router, 0, GetCachedStoreReply(router));
       }
     }
     if (!reply_msg && (lookup_type == DATABASE_LOOKUP_TYPE_LEASESET_LOOKUP  ||
@@ -735,12 +1227,29 @@ void NetDb::HandleDatabaseLookupMsg(
         excluded_routers.insert(excluded);
         excluded += 32;
       }
-      reply_msg = CreateDatabaseSearchReply(
-          ident,
-          GetClosestFloodfills(
-              ident,
-              3,  // TODO(anonimal): enumerate or algorithm
-              excluded_routers));
+      // Closest-floodfill picks for hot keys are cached briefly; lookups
+      // that exclude peers expect a tailored answer and bypass the cache
+      std::vector<IdentHash> closest;
+      const std::uint64_t now = kovri::core::GetSecondsSinceEpoch();
+      if (excluded_routers.empty()) {
+        auto it = m_SearchReplyCache.find(ident);
+        if (it != m_SearchReplyCache.end()
+            && now < it->second.timestamp + Time::SearchReplyCacheTTL)
+          closest = it->second.routers;
+      }
+      if (closest.empty()) {
+        closest = GetClosestFloodfills(
+            ident,
+            3,  // TODO(anonimal): enumerate or algorithm
+            excluded_routers);
+        if (excluded_routers.empty()) {
+          if (m_SearchReplyCache.size() >= Size::MaxSearchReplyCache)
+            m_SearchReplyCache.clear();
+          m_SearchReplyCache[ident] = {now, closest};
+          AccountReplyCaches();
+        }
+      }
+      reply_msg = CreateDatabaseSearchReply(ident, closest);
     }
   }
   if (reply_msg) {
@@ -803,34 +1312,32 @@ void NetDb::Explore(std::uint16_t num_destinations)
       if (kovri::core::transports.IsConnected(floodfill->GetIdentHash()))
         through_tunnels = false;
       if (through_tunnels) {
-        msgs.push_back(
-            kovri::core::TunnelMessageBlock {
+        msgs.emplace_back(
             kovri::core::e_DeliveryTypeRouter,
             floodfill->GetIdentHash(),
             0,
-            CreateDatabaseStoreMsg()  // tell floodfill about us
-          });
-        msgs.push_back(
-            kovri::core::TunnelMessageBlock  {
+            CreateDatabaseStoreMsg());  // tell floodfill about us
+        msgs.emplace_back(
             kovri::core::e_DeliveryTypeRouter,
             floodfill->GetIdentHash(),
             0,
             dest->CreateRequestMessage(
                 floodfill,
-                inbound)  // explore
-          });
+                inbound));  // explore
       } else {
         kovri::core::transports.SendMessage(
             floodfill->GetIdentHash(),
             dest->CreateRequestMessage(
               floodfill->GetIdentHash()));
       }
+      // keeps the request alive until the reply window closes
+      dest->ScheduleRetry();
     } else {
       m_Requests.RequestComplete(random_hash.data(), nullptr);
     }
   }
   if (through_tunnels && !msgs.empty())
-    outbound->SendTunnelDataMsg(msgs);
+    outbound->SendTunnelDataMsg(std::move(msgs));
 }
 
 void NetDb::Publish() {
@@ -856,90 +1363,97 @@ void NetDb::Publish() {
 }
 
 // TODO(anonimal): refactor these getters into fewer functions
+// NOTE: hidden routers and capability bits are filtered by cohort
+// membership at insert time, so the lambdas below only reject what a
+// flat index cannot know in advance: self, the excluded peer and
+// transport incompatibility
 std::shared_ptr<const RouterInfo> NetDb::GetRandomRouter() const {
-  return GetRandomRouter([](std::shared_ptr<const RouterInfo> router) -> bool {
-    return !router->HasCap(RouterInfo::Cap::Hidden)
-           && (router->GetIdentHash()
-               != core::context.GetRouterInfo().GetIdentHash());
-  });
+  return GetRandomRouter(
+      RouterInfoTable::CohortAny,
+      [](const IdentHash& ident, const RouterDescriptor&) -> bool {
+        return ident != core::context.GetRouterInfo().GetIdentHash();
+      });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetRandomRouter(
     std::shared_ptr<const RouterInfo> compatible_with) const {
+  const std::uint8_t transports = compatible_with->GetSupportedTransports();
+  const IdentHash& excluded = compatible_with->GetIdentHash();
   return GetRandomRouter(
-      [compatible_with](std::shared_ptr<const RouterInfo> router) -> bool {
-        return !router->HasCap(RouterInfo::Cap::Hidden)
-               && router != compatible_with
-               && router->HasCompatibleTransports(*compatible_with)
-               && (router->GetIdentHash()
-                   != core::context.GetRouterInfo().GetIdentHash());
+      RouterInfoTable::CohortAny,
+      [transports, &excluded](
+          const IdentHash& ident, const RouterDescriptor& desc) -> bool {
+        return ident != excluded
+               && (desc.transports & transports)
+               && ident != core::context.GetRouterInfo().GetIdentHash();
       });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetRandomPeerTestRouter() const {
-  return GetRandomRouter([](std::shared_ptr<const RouterInfo> router) -> bool {
-    return !router->HasCap(RouterInfo::Cap::Hidden)
-           && router->HasCap(RouterInfo::Cap::SSUTesting)
-           && (router->GetIdentHash()
-               != core::context.GetRouterInfo().GetIdentHash());
-  });
+  return GetRandomRouter(
+      RouterInfoTable::CohortSSUTesting,
+      [](const IdentHash& ident, const RouterDescriptor&) -> bool {
+        return ident != core::context.GetRouterInfo().GetIdentHash();
+      });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetRandomIntroducer() const {
-  return GetRandomRouter([](std::shared_ptr<const RouterInfo> router) -> bool {
-    return !router->HasCap(RouterInfo::Cap::Hidden)
-           && router->HasCap(RouterInfo::Cap::SSUIntroducer)
-           && (router->GetIdentHash()
-               != core::context.GetRouterInfo().GetIdentHash());
-  });
+  return GetRandomRouter(
+      RouterInfoTable::CohortSSUIntroducer,
+      [](const IdentHash& ident, const RouterDescriptor&) -> bool {
+        return ident != core::context.GetRouterInfo().GetIdentHash();
+      });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetHighBandwidthRandomRouter(
     std::shared_ptr<const RouterInfo> compatible_with) const {
+  if (!compatible_with)  // no compatibility constraint, any fast router
+    return GetRandomRouter(
+        RouterInfoTable::CohortHighBandwidth,
+        [](const IdentHash& ident, const RouterDescriptor&) -> bool {
+          return ident != core::context.GetRouterInfo().GetIdentHash();
+        });
+  const std::uint8_t transports = compatible_with->GetSupportedTransports();
+  const IdentHash& excluded = compatible_with->GetIdentHash();
   return GetRandomRouter(
-      [compatible_with](std::shared_ptr<const RouterInfo> router) -> bool {
-        return !router->HasCap(RouterInfo::Cap::Hidden)
-               && router != compatible_with
-               && router->HasCompatibleTransports(*compatible_with)
-               && (router->GetCaps() & RouterInfo::Cap::HighBandwidth)
-               && (router->GetIdentHash()
-                   != core::context.GetRouterInfo().GetIdentHash());
+      RouterInfoTable::CohortHighBandwidth,
+      [transports, &excluded](
+          const IdentHash& ident, const RouterDescriptor& desc) -> bool {
+        return ident != excluded
+               && (desc.transports & transports)
+               && ident != core::context.GetRouterInfo().GetIdentHash();
       });
 }
 
 template<typename Filter>
 std::shared_ptr<const RouterInfo> NetDb::GetRandomRouter(
+    RouterInfoTable::SelectionCohort cohort,
     Filter filter) const {
-
-  // Lock RI's
-  std::unique_lock<std::mutex> l(m_RouterInfosMutex);
-
-  // Instead of using expensive map copying (in an attempt to shuffle),
-  // we'll create a vector of pointers to map's key, randomize, then iterate
-  // to ensure that a random RI will be selected for test-case
-  std::vector<std::unique_ptr<IdentHash>> idents;
-
-  // Save pointers to keys
-  for (auto const& ri : m_RouterInfos)
-    idents.push_back(std::make_unique<IdentHash>(ri.first));
-
-  // Randomize they keys for selection
-  kovri::core::Shuffle(idents.begin(), idents.end());
-
-  // Use keys for test-case
-  for (auto const& i : idents) {
-    if (!m_RouterInfos.at(*i)->IsUnreachable() && filter(m_RouterInfos.at(*i)))
-      return m_RouterInfos.at(*i);
-  }
-
-  // We don't have enough routers which fit criteria
-  return nullptr;
+  // One draw into the cohort's flat slot index: every candidate already
+  // advertises the wanted capability. Only survivors of the filter are
+  // dereferenced, for the reachability flag, which can change after insert
+  auto router = m_RouterInfos.SelectRandom(
+      cohort,
+      kovri::core::Rand<std::size_t>(),
+      [&filter](
+          const IdentHash& ident,
+          const RouterDescriptor& desc,
+          const std::shared_ptr<RouterInfo>& router) -> bool {
+        return filter(ident, desc) && !router->IsUnreachable();
+      });
+  if (router)
+    router->Touch();  // retention recency
+  return router;
 }
 
 void NetDb::PostI2NPMsg(
     std::shared_ptr<const I2NPMessage> msg) {
-  if (msg)
-    m_Queue.Put(msg);
+  if (msg) {
+    m_Queue.Put(std::move(msg));
+    // wake the NetDb io_service; the handler drains in batches, so
+    // redundant posts under a burst just find an empty queue
+    m_Service.post(std::bind(&NetDb::HandleQueue, this));
+  }
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetClosestFloodfill(
@@ -948,22 +1462,7 @@ std::shared_ptr<const RouterInfo> NetDb::GetClosestFloodfill(
   std::shared_ptr<const RouterInfo> r;
   try
    {
-      XORMetric min_metric;
-      IdentHash dest_key = CreateRoutingKey(destination);
-      min_metric.SetMax();
-      std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-      for (const auto& it : m_Floodfills)
-        {
-          if (!it->IsUnreachable() && !excluded.count(it->GetIdentHash()))
-            {
-              XORMetric m = dest_key ^ it->GetIdentHash();
-              if (m < min_metric)
-                {
-                  min_metric = m;
-                  r = it;
-                }
-            }
-        }
+      r = m_Floodfills.FindClosest(CreateRoutingKey(destination), excluded);
     }
   catch (...)
     {
@@ -981,36 +1480,7 @@ std::vector<IdentHash> NetDb::GetClosestFloodfills(
   std::vector<IdentHash> res;
   try
     {
-      IdentHash dest_key = CreateRoutingKey(destination);
-      struct Sorted
-      {
-        std::shared_ptr<const RouterInfo> r;
-        XORMetric metric;
-        bool operator<(const Sorted& other) const
-        {
-          return metric < other.metric;
-        }
-      };
-      std::set<Sorted> sorted;
-      {
-        std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-        for (const auto& it : m_Floodfills)
-          {
-            if (!it->IsUnreachable() && !excluded.count(it->GetIdentHash()))
-              {
-                XORMetric m = dest_key ^ it->GetIdentHash();
-                sorted.insert({it, m});
-              }
-          }
-      }
-
-      std::uint8_t i{};
-      for (auto it = sorted.begin(); it != sorted.end() && i < num; ++it)
-        {
-          const auto& ident = it->r->GetIdentHash();
-          res.push_back(ident);
-          ++i;
-        }
+      res = m_Floodfills.FindClosest(CreateRoutingKey(destination), num, excluded);
     }
   catch (...)
     {
@@ -1029,20 +1499,20 @@ std::shared_ptr<const RouterInfo> NetDb::GetClosestNonFloodfill(
       XORMetric min_metric;
       IdentHash dest_key = CreateRoutingKey(destination);
       min_metric.SetMax();
-      std::unique_lock<std::mutex> l(m_RouterInfosMutex);
-      for (const auto& it : m_RouterInfos)
-        {
-          if (!it.second->HasCap(RouterInfo::Cap::Floodfill)
-              && !excluded.count(it.first))
-            {
-              XORMetric m = dest_key ^ it.first;
-              if (m < min_metric)
-                {
-                  min_metric = m;
-                  r = it.second;
-                }
-            }
-        }
+      m_RouterInfos.ForEach([&](
+          const IdentHash& ident,
+          const std::shared_ptr<RouterInfo>& router) {
+        if (!router->HasCap(RouterInfo::Cap::Floodfill)
+            && !excluded.count(ident))
+          {
+            XORMetric m = dest_key ^ ident;
+            if (m < min_metric)
+              {
+                min_metric = m;
+                r = router;
+              }
+          }
+      });
     }
   catch (...)
     {
@@ -1053,16 +1523,10 @@ std::shared_ptr<const RouterInfo> NetDb::GetClosestNonFloodfill(
 }
 
 void NetDb::ManageLeaseSets() {
-  for (auto it = m_LeaseSets.begin(); it != m_LeaseSets.end();) {
-    if (!it->second->HasNonExpiredLeases()) {  // all leases expired
-      LOG(debug)
-        << "NetDb: LeaseSet " << it->second->GetIdentHash().ToBase64()
-        << " expired";
-      it = m_LeaseSets.erase(it);
-    } else {
-      it++;
-    }
-  }
+  // Only entries whose latest lease end has passed leave the expiry heap
+  for (const auto& ident :
+       m_LeaseSets.EraseExpired(kovri::core::GetMillisecondsSinceEpoch()))
+    LOG(debug) << "NetDb: LeaseSet " << ToBase64Cached(ident) << " expired";
 }
 
 }  // namespace core
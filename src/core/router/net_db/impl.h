@@ -33,6 +33,8 @@
 #ifndef SRC_CORE_ROUTER_NET_DB_IMPL_H_
 #define SRC_CORE_ROUTER_NET_DB_IMPL_H_
 
+#include <boost/asio.hpp>
+
 #include <cstddef>
 #include <cstdint>
 #include <list>
@@ -47,10 +49,15 @@
 #include "core/router/i2np.h"
 #include "core/router/info.h"
 #include "core/router/lease_set.h"
+#include "core/router/net_db/kademlia_index.h"
+#include "core/router/net_db/lease_set_table.h"
+#include "core/router/net_db/packed_store.h"
 #include "core/router/net_db/requests.h"
+#include "core/router/net_db/router_table.h"
 #include "core/router/tunnel/pool.h"
 #include "core/router/tunnel/impl.h"
 
+#include "core/util/bloom_filter.h"
 #include "core/util/exception.h"
 #include "core/util/queue.h"
 
@@ -73,12 +80,20 @@ struct NetDbTraits
     /// @notes Measured in seconds
     Save = 60,
 
+    /// @brief Flush cadence of the in-memory peer profile table
+    /// @notes Measured in seconds
+    SaveProfiles = 600,
+
     /// @notes Measured in seconds
     PublishRouterInfo = 2400,
 
     /// @notes Measured in seconds
     Exploratory = 30,
 
+    /// @brief Exploration cadence while bootstrapping
+    /// @notes Measured in seconds
+    ExploratoryBurst = 10,
+
     /// @notes Measured in seconds
     DelayedExploratory = 90,
 
@@ -99,6 +114,21 @@ struct NetDbTraits
     ///   exceeds minimum unreachable routers
     /// @notes Measured in hours
     RouterMaxGracePeriod = 72,
+
+    /// @brief Lifetime of a cached closest-floodfills pick for a
+    ///   recently-asked lookup key
+    /// @notes Measured in seconds
+    SearchReplyCacheTTL = 30,
+
+    /// @brief Rotation cadence of the seen-store and flooded-tuple
+    ///   filters; an entry is remembered for one to two intervals
+    /// @notes Measured in seconds
+    SeenStoreRotate = 60,
+
+    /// @brief Routers accessed within this window are spared from
+    ///   cold demotion when the retention budget is enforced
+    /// @notes Measured in seconds
+    RetentionAccessWindow = 600,
   };
 
   /// @enum Size
@@ -124,9 +154,28 @@ struct NetDbTraits
     /// @notes Used when router count is less than min known routers
     MaxExploratoryTunnels = 9,
 
+    /// @brief Parallel exploratory lookups per bootstrap-burst round,
+    ///   each sent to a different floodfill
+    BurstExploratoryTunnels = 16,
+
+    /// @brief Exploratory tunnel pool size floor once the database is
+    ///   healthy; surplus build bandwidth returns to client pools
+    ExploratoryPoolMin = 2,
+
+    /// @brief Exploratory tunnel pool size during bootstrap, when NetDb
+    ///   lookups are the router's main traffic
+    ExploratoryPoolMax = 8,
+
+    /// @brief In-flight lookups per exploratory tunnel kept beyond the
+    ///   pool size floor
+    LookupsPerExploratoryTunnel = 4,
+
     /// @brief Max number of NetDb messages that can be processed in succession
     MaxMessagesRead = 100,
 
+    /// @brief Max queued disk operations drained per persister wakeup
+    MaxPersistBatch = 256,
+
     /// @brief Max number of excluded peers for handling database lookup messages
     MaxExcludedPeers = 512,
 
@@ -139,6 +188,19 @@ struct NetDbTraits
 
     /// @brief the maximum limit for number of routers to be set unreachable
     MaxRouterUnreachable = 300,
+
+    /// @brief Max cached compressed DatabaseStore payloads
+    MaxStoreReplyCache = 1024,
+
+    /// @brief Max cached closest-floodfills picks
+    MaxSearchReplyCache = 256,
+
+    /// @brief Approximate in-memory cost of one router store entry
+    ///   beyond its serialized buffer (object, addresses, table slots)
+    RouterEntryOverhead = 1024,
+
+    /// @brief New routers admitted between retention budget checks
+    RetentionCheckGrowth = 128,
   };
 };
 
@@ -156,7 +218,8 @@ class NetDb : public NetDbTraits {
   void AddRouterInfo(
       const IdentHash& ident,
       const std::uint8_t* buf,
-      std::uint16_t len);
+      std::uint16_t len,
+      bool verify_signature = true);
 
   void AddLeaseSet(
       const IdentHash& ident,
@@ -215,19 +278,33 @@ class NetDb : public NetDbTraits {
   void PostI2NPMsg(
       std::shared_ptr<const I2NPMessage> msg);
 
+  /// @brief Drops the floodfill answer caches to return memory; posted to
+  ///   the NetDb thread, entries rebuild on demand. Memory-budget shedding
+  ///   hook
+  void ShedReplyCaches();
+
   std::size_t GetNumRouters() const
   {
-    return m_RouterInfos.size();
+    return m_RouterInfos.Size();
   }
 
   std::size_t GetNumFloodfills() const
   {
-    return m_Floodfills.size();
+    return m_Floodfills.Size();
+  }
+
+  /// @brief How many exploratory tunnels are currently worth keeping
+  /// @notes Recomputed each exploration round from the known-router
+  ///   count, the lookup backlog, and the recent reply rate; consumed
+  ///   by Tunnels::ManageTunnelPools to size the exploratory pool
+  std::uint16_t GetDesiredExploratoryTunnels() const
+  {
+    return m_DesiredExploratoryTunnels;
   }
 
   std::size_t GetNumLeaseSets() const
   {
-    return m_LeaseSets.size();
+    return m_LeaseSets.Size();
   }
 
  private:
@@ -236,32 +313,180 @@ class NetDb : public NetDbTraits {
   /// @return False on failure
   bool Load();
   void SaveUpdated();
-  void Run();  // exploratory thread
+
+  /// @brief NetDb thread entry: runs the io_service hosting the message
+  ///   drain handler and the housekeeping timers
+  void Run();
+
+  /// @brief Batch-drains queued I2NP messages; posted by PostI2NPMsg so
+  ///   a lookup is handled as soon as the io_service picks it up instead
+  ///   of on the next timeout poll
+  void HandleQueue();
+
+  /// @brief Arms all housekeeping timers at their initial cadence
+  void ScheduleHousekeeping();
+
+  void HandleManageRequestsTimer(const boost::system::error_code& ecode);
+  void HandleSaveTimer(const boost::system::error_code& ecode);
+  void HandleProfilesTimer(const boost::system::error_code& ecode);
+  void HandlePublishTimer(const boost::system::error_code& ecode);
+  void HandleFilterRotateTimer(const boost::system::error_code& ecode);
+
+  /// @brief Adaptive exploration round; reschedules itself at a cadence
+  ///   following how much of the network is already known
+  void HandleExploratoryTimer(const boost::system::error_code& ecode);
+
+  /// @brief Verification worker loop: drains queued RouterInfo stores in
+  ///   batches and checks their signatures off the NetDb thread
+  void RunVerificationWorker();
+
+  /// @brief Inserts RouterInfos the workers have already verified,
+  ///   skipping the redundant signature check (NetDb thread only)
+  void FlushVerifiedRouterInfos();
+
+  /// @brief Configured size of the verification worker pool
+  std::uint16_t GetNumVerificationWorkers() const;
+
+  /// @brief Persister loop: drains queued disk operations in batches,
+  ///   coalescing repeated writes of the same router, so save cycles no
+  ///   longer stall the NetDb thread on file I/O
+  void RunPersister();
+
+  /// @brief Gzip-compressed RI payload for DatabaseStore lookup replies,
+  ///   cached per entry so popular routers are compressed once instead of
+  ///   per answered lookup. Entries self-invalidate on a timestamp
+  ///   mismatch when the router is updated (NetDb thread only)
+  std::shared_ptr<const std::vector<std::uint8_t>> GetCachedStoreReply(
+      const std::shared_ptr<const RouterInfo>& router);
+
+  /// @brief Pushes the reply caches' current footprint into the memory
+  ///   budget; call after mutating either cache (NetDb thread only)
+  void AccountReplyCaches();
+
   void Explore(std::uint16_t num_destinations);
   void Publish();
   void ManageLeaseSets();
   void ManageRequests();
 
+  /// @brief Enforces the retention byte budget over the router store in
+  ///   tiers: hot entries (serialized buffer held) are demoted to warm
+  ///   by evicting the buffer (their bytes stay on disk, updated ones
+  ///   are snapshotted to the persister first), then warm entries are
+  ///   demoted to cold (dropped from the table entirely, remaining in
+  ///   the packed store). Least recently accessed entries go first;
+  ///   floodfills and recently accessed routers are spared from the
+  ///   cold demotion (NetDb thread only)
+  void EnforceRetention();
+
   /// @brief Randomly selects a router from stored RI's according to filter
   ///   (and other criteria determined internally)
+  /// @param cohort Capability cohort the candidates are drawn from
   /// @param filter Template type which serves as filter for criteria
   template<typename Filter>
   std::shared_ptr<const RouterInfo> GetRandomRouter(
+      RouterInfoTable::SelectionCohort cohort,
       Filter filter) const;
 
  private:
-  std::map<IdentHash, std::shared_ptr<LeaseSet>> m_LeaseSets;
-  mutable std::mutex m_RouterInfosMutex;
-  std::map<IdentHash, std::shared_ptr<RouterInfo>> m_RouterInfos;
-  mutable std::mutex m_FloodfillsMutex;
-  std::list<std::shared_ptr<RouterInfo>> m_Floodfills;
+  /// @brief One RouterInfo store awaiting signature verification; the
+  ///   buffer is copied because the originating I2NP message is recycled
+  struct PendingRouterInfo {
+    IdentHash ident;
+    std::vector<std::uint8_t> buffer;
+    // Set for entries loaded from disk as trusted: they are already in the
+    // table, so a failed re-check marks them unreachable instead of dropping
+    std::shared_ptr<RouterInfo> stored;
+  };
+
+  /// @brief One deferred disk operation from a save cycle; writes carry a
+  ///   snapshot of the serialized RouterInfo so the NetDb thread may keep
+  ///   mutating (or expiring) the live entry while the persister flushes
+  struct PersistOp {
+    enum OpType { Write, Remove };
+    OpType type;
+    IdentHash ident;
+    std::string path;
+    std::vector<std::uint8_t> buffer;  // Write only
+  };
+
+  /// @brief Compressed DatabaseStore payload for one router; stale once
+  ///   the router's timestamp moves past the recorded one
+  struct CachedStoreReply {
+    std::uint64_t timestamp;
+    std::shared_ptr<const std::vector<std::uint8_t>> payload;
+  };
+
+  /// @brief Closest-floodfills pick for a recently-asked lookup key
+  struct CachedSearchReply {
+    std::uint64_t timestamp;  // seconds since epoch
+    std::vector<IdentHash> routers;
+  };
+
+ private:
+  // internally synchronized (reader-writer locked, lazy expiry heap)
+  LeaseSetTable m_LeaseSets;
+  // internally synchronized (reader-writer locked, open addressing)
+  RouterInfoTable m_RouterInfos;
+  // internally synchronized (XOR-metric trie keyed on router ident)
+  FloodfillIndex m_Floodfills;
+  // single packed RI file mapped at startup (loaded on the NetDb thread,
+  // then touched only by the persister thread)
+  RouterInfoPackedStore m_PackedStore;
 
   bool m_IsRunning;
   std::unique_ptr<std::thread> m_Thread;
 
+  // event-driven service: queue puts post a drain handler and the
+  // housekeeping below runs on discrete timers, so there is no timeout
+  // polling between a lookup arriving and it being handled
+  boost::asio::io_service m_Service;
+  std::unique_ptr<boost::asio::io_service::work> m_Work;
+  boost::asio::deadline_timer m_ManageRequestsTimer;
+  boost::asio::deadline_timer m_SaveTimer;
+  boost::asio::deadline_timer m_ProfilesTimer;
+  boost::asio::deadline_timer m_PublishTimer;
+  boost::asio::deadline_timer m_FilterRotateTimer;
+  boost::asio::deadline_timer m_ExploratoryTimer;
+
   // of I2NPDatabaseStoreMsg
   kovri::core::Queue<std::shared_ptr<const I2NPMessage>> m_Queue;
 
+  // optional verification worker pool: RouterInfo signature checks from
+  // flood bursts run here in drained batches, off the NetDb thread;
+  // entries loaded from disk as trusted are re-checked here after startup
+  std::vector<std::unique_ptr<std::thread>> m_VerificationWorkers;
+  kovri::core::Queue<std::shared_ptr<PendingRouterInfo>> m_UnverifiedRouterInfos;
+  kovri::core::Queue<std::shared_ptr<PendingRouterInfo>> m_VerifiedRouterInfos;
+
+  // write-behind persister: save cycles queue snapshots here and the
+  // dedicated I/O thread batches them to disk
+  std::unique_ptr<std::thread> m_Persister;
+  kovri::core::Queue<std::shared_ptr<PersistOp>> m_PersistQueue;
+
+  // floodfill answer caches, touched only on the NetDb thread: coarse
+  // clear on overflow, entries rebuild on demand
+  std::map<IdentHash, CachedStoreReply> m_StoreReplyCache;
+  std::map<IdentHash, CachedSearchReply> m_SearchReplyCache;
+  // compressed payload bytes held by m_StoreReplyCache (NetDb thread
+  // only); mirrored into the memory budget after each mutation
+  std::size_t m_StoreReplyCacheBytes = 0;
+
+  // retention: approximate byte budget for the in-memory router store
+  // (0 leaves retention to the age-based purges alone) and the number
+  // of routers admitted since the budget was last enforced
+  std::size_t m_RetentionBudget = 0;
+  std::size_t m_RoutersSinceRetention = 0;
+
+  // exploratory pool budget advertised to the tunnel manager; written
+  // on the NetDb thread each exploration round, read by Tunnels
+  std::uint16_t m_DesiredExploratoryTunnels = 5;
+
+  // flood-storm deduplication (NetDb thread only), rotated every
+  // Time::SeenStoreRotate: store payloads already verified, and
+  // (payload, peer) tuples already flooded
+  RotatingBloomFilter m_SeenStores;
+  RotatingBloomFilter m_FloodedTuples;
+
   friend class NetDbRequests;
   NetDbRequests m_Requests;
 
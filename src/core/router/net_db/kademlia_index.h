@@ -0,0 +1,193 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_ROUTER_NET_DB_KADEMLIA_INDEX_H_
+#define SRC_CORE_ROUTER_NET_DB_KADEMLIA_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "core/router/identity.h"
+#include "core/router/info.h"
+
+namespace kovri {
+namespace core {
+
+/// @class FloodfillIndex
+/// @brief XOR-metric index of floodfill routers: a binary trie over the
+///   256-bit ident hash. Descending the branch matching the target key
+///   first enumerates floodfills in strictly increasing XOR distance, so
+///   closest-peer queries touch O(log n) nodes instead of walking every
+///   known floodfill per LeaseSet publish and DatabaseLookup
+class FloodfillIndex {
+ public:
+  FloodfillIndex()
+      : m_Size(0) {}
+
+  /// @brief Inserts or replaces the floodfill stored under its ident
+  void Insert(
+      std::shared_ptr<RouterInfo> router) {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    Node* node = &m_Root;
+    const IdentHash& ident = router->GetIdentHash();
+    for (std::uint16_t depth = 0; depth < BitLength; depth++) {
+      auto& child = node->children[Bit(ident, depth)];
+      if (!child)
+        child = std::make_unique<Node>();
+      node = child.get();
+    }
+    if (!node->router)
+      m_Size++;
+    node->router = router;
+  }
+
+  bool Erase(
+      const IdentHash& ident) {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    bool erased = false;
+    EraseRecursive(m_Root, ident, 0, erased);
+    if (erased)
+      m_Size--;
+    return erased;
+  }
+
+  std::size_t Size() const {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    return m_Size;
+  }
+
+  void Clear() {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    m_Root.children[0].reset(nullptr);
+    m_Root.children[1].reset(nullptr);
+    m_Size = 0;
+  }
+
+  /// @brief Returns the reachable floodfill closest to key by XOR metric,
+  ///   skipping excluded idents
+  std::shared_ptr<const RouterInfo> FindClosest(
+      const IdentHash& key,
+      const std::set<IdentHash>& excluded) const {
+    std::shared_ptr<const RouterInfo> found;
+    std::unique_lock<std::mutex> l(m_Mutex);
+    Visit(m_Root, key, 0,
+        [&found, &excluded](const std::shared_ptr<RouterInfo>& router) {
+          if (router->IsUnreachable()
+              || excluded.count(router->GetIdentHash()))
+            return true;  // keep looking
+          found = router;
+          return false;
+        });
+    return found;
+  }
+
+  /// @brief Returns up to num reachable floodfills in increasing XOR
+  ///   distance from key, skipping excluded idents
+  std::vector<IdentHash> FindClosest(
+      const IdentHash& key,
+      const std::uint8_t num,
+      const std::set<IdentHash>& excluded) const {
+    std::vector<IdentHash> found;
+    std::unique_lock<std::mutex> l(m_Mutex);
+    Visit(m_Root, key, 0,
+        [&found, &excluded, num](const std::shared_ptr<RouterInfo>& router) {
+          if (!router->IsUnreachable()
+              && !excluded.count(router->GetIdentHash()))
+            found.push_back(router->GetIdentHash());
+          return found.size() < num;
+        });
+    return found;
+  }
+
+ private:
+  enum : std::uint16_t { BitLength = 256 };
+
+  struct Node {
+    std::unique_ptr<Node> children[2];
+    std::shared_ptr<RouterInfo> router;  // set on leaves only
+  };
+
+  static bool Bit(
+      const IdentHash& ident,
+      std::uint16_t index) {
+    return (ident()[index >> 3] >> (7 - (index & 7))) & 1;
+  }
+
+  /// @brief Visits leaves in increasing XOR distance from key;
+  ///   the visitor returns false to stop
+  template<typename Visitor>
+  static bool Visit(
+      const Node& node,
+      const IdentHash& key,
+      std::uint16_t depth,
+      Visitor visit) {
+    if (depth == BitLength)
+      return !node.router || visit(node.router);
+    const bool bit = Bit(key, depth);
+    for (int branch = 0; branch < 2; branch++) {
+      const auto& child = node.children[branch ? !bit : bit];
+      if (child && !Visit(*child, key, depth + 1, visit))
+        return false;
+    }
+    return true;
+  }
+
+  /// @return true when node has become empty and can be pruned
+  static bool EraseRecursive(
+      Node& node,
+      const IdentHash& ident,
+      std::uint16_t depth,
+      bool& erased) {
+    if (depth == BitLength) {
+      erased = (node.router != nullptr);
+      node.router = nullptr;
+      return true;
+    }
+    auto& child = node.children[Bit(ident, depth)];
+    if (child && EraseRecursive(*child, ident, depth + 1, erased))
+      child.reset(nullptr);
+    return !node.children[0] && !node.children[1] && !node.router;
+  }
+
+ private:
+  mutable std::mutex m_Mutex;
+  std::size_t m_Size;
+  Node m_Root;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_NET_DB_KADEMLIA_INDEX_H_
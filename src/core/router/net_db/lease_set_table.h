@@ -0,0 +1,151 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_ROUTER_NET_DB_LEASE_SET_TABLE_H_
+#define SRC_CORE_ROUTER_NET_DB_LEASE_SET_TABLE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/router/identity.h"
+#include "core/router/lease_set.h"
+
+namespace kovri {
+namespace core {
+
+/// @class LeaseSetTable
+/// @brief LeaseSets keyed by IdentHash behind a reader-writer lock, with a
+///   lazy expiry min-heap: cleanup pops only entries whose latest lease end
+///   has passed instead of scanning the whole table, and destination
+///   threads resolve LeaseSets under a shared lock without waiting on the
+///   NetDb thread's scans
+class LeaseSetTable {
+ public:
+  /// @brief Inserts or refreshes the entry for ident, queueing it on the
+  ///   expiry heap at its latest lease end
+  void Insert(
+      const IdentHash& ident,
+      std::shared_ptr<LeaseSet> lease_set) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    m_Expiry.emplace(lease_set->GetLatestLeaseEndDate(), ident);
+    m_LeaseSets[ident] = std::move(lease_set);
+  }
+
+  std::shared_ptr<LeaseSet> Find(
+      const IdentHash& ident) const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    auto it = m_LeaseSets.find(ident);
+    return it != m_LeaseSets.end() ? it->second : nullptr;
+  }
+
+  bool Erase(
+      const IdentHash& ident) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    // any heap entry for ident goes stale and pops harmlessly later
+    return m_LeaseSets.erase(ident) > 0;
+  }
+
+  std::size_t Size() const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    return m_LeaseSets.size();
+  }
+
+  void Clear() {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    m_LeaseSets.clear();
+    m_Expiry = ExpiryHeap();
+  }
+
+  /// @brief Erases every entry whose leases have all expired, touching
+  ///   only heap entries at or past now (in milliseconds since epoch)
+  /// @return Ident hashes of the erased entries, for logging
+  std::vector<IdentHash> EraseExpired(
+      std::uint64_t now) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    std::vector<IdentHash> expired;
+    while (!m_Expiry.empty() && m_Expiry.top().first <= now) {
+      const IdentHash ident = m_Expiry.top().second;
+      m_Expiry.pop();
+      auto it = m_LeaseSets.find(ident);
+      if (it == m_LeaseSets.end())
+        continue;  // erased since queued; stale heap entry
+      if (it->second->HasNonExpiredLeases()) {
+        // updated with fresher leases since queued: requeue at the new end
+        m_Expiry.emplace(it->second->GetLatestLeaseEndDate(), ident);
+        continue;
+      }
+      expired.push_back(ident);
+      m_LeaseSets.erase(it);
+    }
+    return expired;
+  }
+
+ private:
+  /// @brief Orders the earliest lease end on top
+  struct ExpiryCompare {
+    bool operator()(
+        const std::pair<std::uint64_t, IdentHash>& a,
+        const std::pair<std::uint64_t, IdentHash>& b) const {
+      return a.first > b.first;
+    }
+  };
+
+  /// @brief Uniformly random ident hashes hash to their first 8 bytes
+  struct IdentHasher {
+    std::size_t operator()(
+        const IdentHash& ident) const {
+      std::uint64_t hash;
+      std::memcpy(&hash, ident(), sizeof(hash));
+      return hash;
+    }
+  };
+
+  typedef std::priority_queue<
+      std::pair<std::uint64_t, IdentHash>,
+      std::vector<std::pair<std::uint64_t, IdentHash>>,
+      ExpiryCompare> ExpiryHeap;
+
+  mutable std::shared_timed_mutex m_Mutex;
+  std::unordered_map<IdentHash, std::shared_ptr<LeaseSet>, IdentHasher>
+      m_LeaseSets;
+  ExpiryHeap m_Expiry;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_NET_DB_LEASE_SET_TABLE_H_
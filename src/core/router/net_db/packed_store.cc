@@ -0,0 +1,257 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "core/router/net_db/packed_store.h"
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "core/util/byte_stream.h"
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+namespace {
+/// @brief Store file magic + format version
+const std::uint8_t PackMagic[4] = {'K', 'P', 'R', 'I'};
+const std::uint8_t PackVersion = 1;
+}  // namespace
+
+RouterInfoPackedStore::RouterInfoPackedStore()
+    : m_FileSize(0),
+      m_DeadBytes(0),
+      m_Exception(__func__) {}
+
+bool RouterInfoPackedStore::Open(const boost::filesystem::path& path) {
+  try {
+    m_Path = path;
+    m_Index.clear();
+    m_Region.reset(nullptr);
+    m_File.reset(nullptr);
+    m_FileSize = 0;
+    m_DeadBytes = 0;
+    if (!boost::filesystem::exists(path))
+      return false;
+    m_FileSize = boost::filesystem::file_size(path);
+    if (m_FileSize < Size::HeaderSize) {
+      LOG(error) << "PackedStore: " << path.string() << " is truncated";
+      return false;
+    }
+    m_File = std::make_unique<boost::interprocess::file_mapping>(
+        path.string().c_str(),
+        boost::interprocess::read_only);
+    m_Region = std::make_unique<boost::interprocess::mapped_region>(
+        *m_File,
+        boost::interprocess::read_only);
+    const auto* base =
+        static_cast<const std::uint8_t*>(m_Region->get_address());
+    if (std::memcmp(base, PackMagic, sizeof(PackMagic))
+        || base[sizeof(PackMagic)] != PackVersion) {
+      LOG(error) << "PackedStore: " << path.string() << " bad magic/version";
+      m_Region.reset(nullptr);
+      m_File.reset(nullptr);
+      return false;
+    }
+    // Sequential scan of the mapping rebuilds the offset index; later
+    // records supersede earlier ones for the same ident
+    std::uint64_t offset = Size::HeaderSize;
+    while (offset + Size::RecordOverhead <= m_FileSize) {
+      const std::uint8_t* record = base + offset;
+      const IdentHash ident(record + 1);
+      const std::uint16_t len =
+          InputByteStream::Read<std::uint16_t>(record + 1 + ident.size());
+      if (offset + Size::RecordOverhead + len > m_FileSize) {
+        LOG(warning) << "PackedStore: dropping truncated tail record";
+        break;
+      }
+      const auto it = m_Index.find(ident);
+      if (it != m_Index.end()) {
+        m_DeadBytes += Size::RecordOverhead + it->second.len;
+        m_Index.erase(it);
+      }
+      if (record[0] == Flag::Live)
+        m_Index[ident] = Record{offset, len};
+      else
+        m_DeadBytes += Size::RecordOverhead + len;
+      offset += Size::RecordOverhead + len;
+    }
+    LOG(debug) << "PackedStore: " << m_Index.size() << " records mapped from "
+               << path.string();
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    return false;
+  }
+  return true;
+}
+
+bool RouterInfoPackedStore::Create(const boost::filesystem::path& path) {
+  try {
+    m_Path = path;
+    m_Index.clear();
+    m_Region.reset(nullptr);
+    m_File.reset(nullptr);
+    m_DeadBytes = 0;
+    std::ofstream file(
+        path.string(),
+        std::ofstream::binary | std::ofstream::trunc);
+    if (!WriteHeader(file)) {
+      LOG(error) << "PackedStore: could not create " << path.string();
+      return false;
+    }
+    m_FileSize = Size::HeaderSize;
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    return false;
+  }
+  return true;
+}
+
+void RouterInfoPackedStore::Append(
+    const IdentHash& ident,
+    const std::uint8_t* buf,
+    std::uint16_t len) {
+  if (m_Path.empty() || !buf || !len)
+    return;
+  try {
+    std::ofstream file(
+        m_Path.string(),
+        std::ofstream::binary | std::ofstream::app);
+    std::uint8_t record[Size::RecordOverhead];
+    record[0] = Flag::Live;
+    std::memcpy(record + 1, ident(), ident.size());
+    OutputByteStream::Write<std::uint16_t>(record + 1 + ident.size(), len);
+    file.write(reinterpret_cast<const char*>(record), sizeof(record));
+    file.write(reinterpret_cast<const char*>(buf), len);
+    if (!file) {
+      LOG(error) << "PackedStore: append failed for " << m_Path.string();
+      return;
+    }
+    const auto it = m_Index.find(ident);
+    if (it != m_Index.end())
+      m_DeadBytes += Size::RecordOverhead + it->second.len;
+    m_Index[ident] = Record{m_FileSize, len};
+    m_FileSize += Size::RecordOverhead + len;
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+  }
+}
+
+void RouterInfoPackedStore::Erase(const IdentHash& ident) {
+  const auto it = m_Index.find(ident);
+  if (m_Path.empty() || it == m_Index.end())
+    return;
+  try {
+    std::ofstream file(
+        m_Path.string(),
+        std::ofstream::binary | std::ofstream::app);
+    std::uint8_t record[Size::RecordOverhead];
+    record[0] = Flag::Deleted;
+    std::memcpy(record + 1, ident(), ident.size());
+    OutputByteStream::Write<std::uint16_t>(record + 1 + ident.size(), 0);
+    file.write(reinterpret_cast<const char*>(record), sizeof(record));
+    if (!file) {
+      LOG(error) << "PackedStore: erase failed for " << m_Path.string();
+      return;
+    }
+    m_DeadBytes += 2 * Size::RecordOverhead + it->second.len;
+    m_Index.erase(it);
+    m_FileSize += Size::RecordOverhead;
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+  }
+}
+
+bool RouterInfoPackedStore::NeedsCompaction() const {
+  return m_DeadBytes >= Size::MinCompactionBytes
+      && m_DeadBytes * 2 > m_FileSize;
+}
+
+void RouterInfoPackedStore::Compact() {
+  if (m_Path.empty())
+    return;
+  try {
+    const boost::filesystem::path tmp(m_Path.string() + ".tmp");
+    std::map<IdentHash, Record> packed;
+    std::uint64_t offset = Size::HeaderSize;
+    {
+      std::ifstream src(m_Path.string(), std::ifstream::binary);
+      std::ofstream dst(
+          tmp.string(),
+          std::ofstream::binary | std::ofstream::trunc);
+      if (!src || !WriteHeader(dst)) {
+        LOG(error) << "PackedStore: compaction failed to open files";
+        return;
+      }
+      std::vector<char> record;
+      for (const auto& it : m_Index) {
+        record.resize(Size::RecordOverhead + it.second.len);
+        src.seekg(it.second.offset);
+        src.read(record.data(), record.size());
+        if (!src) {
+          LOG(error) << "PackedStore: skipping unreadable record";
+          src.clear();
+          continue;
+        }
+        dst.write(record.data(), record.size());
+        packed[it.first] = Record{offset, it.second.len};
+        offset += record.size();
+      }
+      if (!dst) {
+        LOG(error) << "PackedStore: compaction write failed";
+        return;
+      }
+    }
+    // The read-only mapping references the file about to be replaced
+    m_Region.reset(nullptr);
+    m_File.reset(nullptr);
+    const std::uint64_t dropped = m_FileSize - offset;
+    boost::filesystem::rename(tmp, m_Path);
+    m_Index = std::move(packed);
+    m_FileSize = offset;
+    m_DeadBytes = 0;
+    LOG(debug) << "PackedStore: compacted, " << dropped << " bytes dropped";
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+  }
+}
+
+bool RouterInfoPackedStore::WriteHeader(std::ofstream& file) {
+  file.write(reinterpret_cast<const char*>(PackMagic), sizeof(PackMagic));
+  file.put(static_cast<char>(PackVersion));
+  return static_cast<bool>(file);
+}
+
+}  // namespace core
+}  // namespace kovri
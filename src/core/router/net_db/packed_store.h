@@ -0,0 +1,155 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_ROUTER_NET_DB_PACKED_STORE_H_
+#define SRC_CORE_ROUTER_NET_DB_PACKED_STORE_H_
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+
+#include "core/router/identity.h"
+
+#include "core/util/exception.h"
+
+namespace kovri {
+namespace core {
+
+/// @class RouterInfoPackedStore
+/// @brief Append-only packed store of serialized RouterInfos: a single file
+///   with an in-memory index of offsets, mapped read-only at startup so RI
+///   bytes are parsed straight out of shared page cache instead of opening
+///   thousands of individual router_info_*.dat files
+/// @notes Accessed from the NetDb thread only (not internally synchronized)
+class RouterInfoPackedStore {
+ public:
+  RouterInfoPackedStore();
+
+  /// @brief Maps an existing store read-only and builds the offset index
+  /// @return False if the file is missing or malformed
+  bool Open(const boost::filesystem::path& path);
+
+  /// @brief Creates an empty store, truncating any existing file
+  /// @return False on failure
+  bool Create(const boost::filesystem::path& path);
+
+  /// @brief Appends a record for given ident, superseding any previous one
+  void Append(
+      const IdentHash& ident,
+      const std::uint8_t* buf,
+      std::uint16_t len);
+
+  /// @brief Appends a deletion marker and drops ident from the index
+  void Erase(const IdentHash& ident);
+
+  /// @brief Number of live records
+  std::size_t Size() const {
+    return m_Index.size();
+  }
+
+  /// @return True once superseded/deleted records outweigh live ones
+  bool NeedsCompaction() const;
+
+  /// @brief Rewrites live records into a fresh file, dropping dead bytes
+  void Compact();
+
+  /// @brief Visits every live record present when the store was opened
+  /// @param visit Callable of (const IdentHash&, const std::uint8_t*, std::uint16_t)
+  /// @notes Record pointers reference the read-only mapping and are only
+  ///   valid until the store is compacted
+  template<typename Visitor>
+  void ForEach(Visitor visit) const {
+    if (!m_Region)
+      return;
+    const auto* base =
+        static_cast<const std::uint8_t*>(m_Region->get_address());
+    for (const auto& it : m_Index)
+      if (it.second.offset + Size::RecordOverhead + it.second.len
+          <= m_Region->get_size())
+        visit(
+            it.first,
+            base + it.second.offset + Size::RecordOverhead,
+            it.second.len);
+  }
+
+ private:
+  /// @enum Flag
+  /// @brief On-disk record flag
+  enum Flag : std::uint8_t
+  {
+    Live = 0,
+    Deleted = 1,
+  };
+
+  /// @enum Size
+  /// @brief Store format/threshold traits
+  enum Size : std::uint32_t
+  {
+    /// @brief Magic + format version
+    HeaderSize = 5,
+
+    /// @brief Flag + ident hash + payload length
+    RecordOverhead = 1 + 32 + 2,
+
+    /// @brief Dead bytes required before compaction is worthwhile
+    MinCompactionBytes = 1 << 20,
+  };
+
+  /// @brief Writes the store header to a fresh stream
+  /// @return False on stream failure
+  bool WriteHeader(std::ofstream& file);
+
+ private:
+  /// @class Record
+  /// @brief Index entry locating a live record within the file
+  struct Record {
+    std::uint64_t offset;
+    std::uint16_t len;
+  };
+
+  boost::filesystem::path m_Path;
+  std::unique_ptr<boost::interprocess::file_mapping> m_File;
+  std::unique_ptr<boost::interprocess::mapped_region> m_Region;
+  std::map<IdentHash, Record> m_Index;
+  std::uint64_t m_FileSize, m_DeadBytes;
+  core::Exception m_Exception;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_NET_DB_PACKED_STORE_H_
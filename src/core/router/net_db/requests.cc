@@ -32,6 +32,10 @@
 
 #include "core/router/net_db/requests.h"
 
+#include <algorithm>
+
+#include "core/crypto/rand.h"
+
 #include "core/router/net_db/impl.h"
 #include "core/router/transports/impl.h"
 
@@ -71,19 +75,32 @@ void RequestedDestination::ClearExcludedPeers() {
   m_ExcludedPeers.clear();
 }
 
+void RequestedDestination::ScheduleRetry() {
+  m_NumAttempts++;
+  // 5, 10, 20, 40, 40, ... seconds
+  std::uint64_t delay = NETDB_REQUEST_RETRY_TIMEOUT;
+  for (std::size_t i = 1; i < m_NumAttempts && delay
+       < NETDB_REQUEST_MAX_RETRY_TIMEOUT; i++)
+    delay *= 2;
+  delay = std::min(delay, NETDB_REQUEST_MAX_RETRY_TIMEOUT);
+  m_NextRetryTime = kovri::core::GetSecondsSinceEpoch() + delay
+    + kovri::core::FastRandInRange32(0, delay / 2);  // jitter
+}
+
+void RequestedDestination::Complete(
+    std::shared_ptr<RouterInfo> r) {
+  for (const auto& request_complete : m_RequestCompletes)
+    request_complete(r);
+  m_RequestCompletes.clear();
+}
+
 void RequestedDestination::Success(
     std::shared_ptr<RouterInfo> r) {
-  if (m_RequestComplete) {
-    m_RequestComplete(r);
-    m_RequestComplete = nullptr;
-  }
+  Complete(r);
 }
 
 void RequestedDestination::Fail() {
-  if (m_RequestComplete) {
-    m_RequestComplete(nullptr);
-    m_RequestComplete = nullptr;
-  }
+  Complete(nullptr);
 }
 
 void NetDbRequests::Start() {}  // TODO(unassigned): ???
@@ -99,13 +116,16 @@ std::shared_ptr<RequestedDestination> NetDbRequests::CreateRequest(
   // request RouterInfo directly
   auto dest =
     std::make_shared<RequestedDestination>(destination, is_exploratory);
-  dest->SetRequestComplete(request_complete); {
+  dest->AddRequestComplete(request_complete); {
     std::unique_lock<std::mutex> l(m_RequestedDestinationsMutex);
-    if (!m_RequestedDestinations.insert(
-          std::make_pair(
-            destination,
-            std::shared_ptr<RequestedDestination>(dest))).second)  // not inserted
+    auto ret = m_RequestedDestinations.insert(
+        std::make_pair(
+          destination,
+          std::shared_ptr<RequestedDestination>(dest)));
+    if (!ret.second) {  // not inserted: coalesce onto the in-flight request
+      ret.first->second->AddRequestComplete(request_complete);
       return nullptr;
+    }
   }
   return dest;
 }
@@ -115,6 +135,10 @@ void NetDbRequests::RequestComplete(
     std::shared_ptr<RouterInfo> r) {
   auto it = m_RequestedDestinations.find(ident);
   if (it != m_RequestedDestinations.end()) {
+    // a sent exploratory round completing here means a floodfill answered
+    // (completion without an attempt is the no-floodfill short circuit)
+    if (it->second->IsExploratory() && it->second->GetNumAttempts())
+      m_ExploratoryReplied++;
     if (r)
       it->second->Success(r);
     else
@@ -140,12 +164,11 @@ void NetDbRequests::ManageRequests() {
     auto& dest = it->second;
     bool is_complete = false;
     // request is worthless after 1 minute
-    if (ts < dest->GetCreationTime() + 60) {
-      // no response for 5 seconds
-      if (ts > dest->GetCreationTime() + 5)  {
-        auto count = dest->GetExcludedPeers().size();
-        std::size_t attempts(7);
-        if (!dest->IsExploratory() && count < attempts) {
+    if (ts < dest->GetCreationTime() + NETDB_REQUEST_TIMEOUT) {
+      // backed-off retry interval elapsed without a response
+      if (ts >= dest->GetNextRetryTime()) {
+        if (!dest->IsExploratory()
+            && dest->GetNumAttempts() < NETDB_REQUEST_MAX_ATTEMPTS) {
           auto pool = kovri::core::tunnels.GetExploratoryPool();
           auto outbound = pool->GetNextOutboundTunnel();
           auto inbound = pool->GetNextInboundTunnel();
@@ -159,6 +182,7 @@ void NetDbRequests::ManageRequests() {
                 dest->CreateRequestMessage(
                   next_floodfill,
                   inbound));
+            dest->ScheduleRetry();
           } else {
             is_complete = true;
             if (!inbound)
@@ -173,21 +197,34 @@ void NetDbRequests::ManageRequests() {
         } else {
           if (!dest->IsExploratory())
             LOG(warning)
-              << "NetDbRequests: " << dest->GetDestination().ToBase64()
-              << " not found after " << attempts << " attempts";
+              << "NetDbRequests: " << ToBase64Cached(dest->GetDestination())
+              << " not found after " << NETDB_REQUEST_MAX_ATTEMPTS
+              << " attempts";
           is_complete = true;
         }
       }
     } else {  // delete obsolete request
       is_complete = true;
     }
-    if (is_complete)
+    if (is_complete) {
+      if (dest->IsExploratory())
+        m_ExploratoryExpired++;
       it = m_RequestedDestinations.erase(it);
-    else
+    } else {
       it++;
+    }
   }
 }
 
+void NetDbRequests::GetExploratoryStats(
+    std::size_t& replied,
+    std::size_t& expired) {
+  replied = m_ExploratoryReplied;
+  expired = m_ExploratoryExpired;
+  m_ExploratoryReplied = 0;
+  m_ExploratoryExpired = 0;
+}
+
 }  // namespace core
 }  // namespace kovri
 
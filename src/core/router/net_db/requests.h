@@ -37,6 +37,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <vector>
 
 #include "core/router/i2np.h"
 #include "core/router/identity.h"
@@ -45,6 +46,21 @@
 namespace kovri {
 namespace core {
 
+/// @brief Floodfills queried in parallel when a lookup starts
+const std::uint8_t NETDB_REQUEST_PARALLEL_LOOKUPS = 3;
+
+/// @brief Seconds before the first retry (doubled per round, with jitter)
+const std::uint64_t NETDB_REQUEST_RETRY_TIMEOUT = 5;
+
+/// @brief Ceiling on the backed-off retry interval, in seconds
+const std::uint64_t NETDB_REQUEST_MAX_RETRY_TIMEOUT = 40;
+
+/// @brief A request is worthless this many seconds after its last send
+const std::uint64_t NETDB_REQUEST_TIMEOUT = 60;
+
+/// @brief Lookup rounds before giving up on a destination
+const std::size_t NETDB_REQUEST_MAX_ATTEMPTS = 7;
+
 class RequestedDestination {
  public:
   typedef std::function<void (std::shared_ptr<RouterInfo>)> RequestComplete;
@@ -54,10 +70,11 @@ class RequestedDestination {
       bool is_exploratory = false)
       : m_Destination(destination),
         m_IsExploratory(is_exploratory),
-        m_CreationTime(0) {}
+        m_CreationTime(0),
+        m_NumAttempts(0),
+        m_NextRetryTime(0) {}
   ~RequestedDestination() {
-    if (m_RequestComplete)
-      m_RequestComplete(nullptr);
+    Fail();
   }
 
   const IdentHash& GetDestination() const {
@@ -93,24 +110,43 @@ class RequestedDestination {
   std::shared_ptr<I2NPMessage> CreateRequestMessage(
       const IdentHash& floodfill);
 
-  void SetRequestComplete(
+  /// @brief Attaches another completion handler to this in-flight request
+  /// @notes Coalescing: concurrent lookups of the same destination share
+  ///   one DatabaseLookup exchange and all get notified on completion
+  void AddRequestComplete(
       const RequestComplete& request_complete) {
-    m_RequestComplete = request_complete;
+    if (request_complete)
+      m_RequestCompletes.push_back(request_complete);
+  }
+
+  /// @return Lookup rounds sent so far
+  std::size_t GetNumAttempts() const {
+    return m_NumAttempts;
   }
 
-  bool IsRequestComplete() const {
-    return m_RequestComplete != nullptr;
+  /// @return Earliest time (seconds since epoch) the next round may go out
+  std::uint64_t GetNextRetryTime() const {
+    return m_NextRetryTime;
   }
 
+  /// @brief Records a sent lookup round and backs off the next retry
+  ///   exponentially (with jitter, to avoid synchronized floodfill load)
+  void ScheduleRetry();
+
   void Success(std::shared_ptr<RouterInfo> r);
   void Fail();
 
  private:
+  /// @brief Fans the result out to all attached completion handlers
+  void Complete(std::shared_ptr<RouterInfo> r);
+
   IdentHash m_Destination;
   bool m_IsExploratory;
   std::set<IdentHash> m_ExcludedPeers;
   std::uint64_t m_CreationTime;
-  RequestComplete m_RequestComplete;
+  std::size_t m_NumAttempts;
+  std::uint64_t m_NextRetryTime;
+  std::vector<RequestComplete> m_RequestCompletes;
 };
 
 class NetDbRequests {
@@ -118,6 +154,9 @@ class NetDbRequests {
   void Start();
   void Stop();
 
+  /// @brief Registers a lookup for destination
+  /// @return The new request, or nullptr if one is already in flight
+  ///   (request_complete is then attached to the existing request)
   std::shared_ptr<RequestedDestination> CreateRequest(
       const IdentHash& destination,
       bool is_exploratory,
@@ -130,12 +169,27 @@ class NetDbRequests {
   std::shared_ptr<RequestedDestination> FindRequest(
       const IdentHash& ident) const;
 
+  /// @return Number of lookups currently in flight
+  std::size_t GetNumRequests() const {
+    return m_RequestedDestinations.size();
+  }
+
   void ManageRequests();
 
+  /// @brief Samples and resets counters of exploratory lookups answered
+  ///   by a floodfill vs. expired unanswered since the previous call
+  /// @notes Feeds the adaptive exploration budget (see NetDb::Run)
+  void GetExploratoryStats(
+      std::size_t& replied,
+      std::size_t& expired);
+
  private:
   std::mutex m_RequestedDestinationsMutex;
   std::map<IdentHash, std::shared_ptr<RequestedDestination> >
     m_RequestedDestinations;
+  // exploratory outcomes since the last sample (netdb thread only)
+  std::size_t m_ExploratoryReplied{0};
+  std::size_t m_ExploratoryExpired{0};
 };
 
 }  // namespace core
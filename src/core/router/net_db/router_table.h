@@ -0,0 +1,350 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_ROUTER_NET_DB_ROUTER_TABLE_H_
+#define SRC_CORE_ROUTER_NET_DB_ROUTER_TABLE_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "core/router/identity.h"
+#include "core/router/info.h"
+
+namespace kovri {
+namespace core {
+
+/// @struct RouterDescriptor
+/// @brief Compact hot fields of a stored RouterInfo, snapshotted into the
+///   table bucket at insert time. Peer-selection scans filter on these
+///   without dereferencing the several-KB RouterInfo behind the pointer,
+///   so a scan touches the flat bucket array instead of one heap object
+///   per rejected candidate
+struct RouterDescriptor {
+  std::uint8_t caps{};        ///< RouterInfo::Cap bits
+  std::uint8_t transports{};  ///< RouterInfo::Transport bits
+};
+
+/// @class RouterInfoTable
+/// @brief Open-addressing hash table of RouterInfo keyed by IdentHash,
+///   guarded by a reader-writer lock. Ident hashes are uniformly random,
+///   so the first 8 bytes serve directly as the hash value; lookups are a
+///   short linear probe over a flat array instead of a red-black-tree walk
+class RouterInfoTable {
+ public:
+  /// @brief Capability cohorts kept as flat slot indexes, updated on
+  ///   insert/erase, so random peer selection draws from candidates
+  ///   directly instead of scanning the whole table for the few routers
+  ///   advertising a capability. Floodfills have their own XOR-metric
+  ///   trie and need no cohort here
+  enum SelectionCohort : std::uint8_t {
+    CohortAny = 0,        ///< every non-hidden router
+    CohortHighBandwidth,  ///< RouterInfo::Cap::HighBandwidth
+    CohortSSUTesting,     ///< RouterInfo::Cap::SSUTesting (peer test)
+    CohortSSUIntroducer,  ///< RouterInfo::Cap::SSUIntroducer
+    NumCohorts
+  };
+
+  explicit RouterInfoTable(
+      std::size_t initial_buckets = 1024)
+      : m_Size(0),
+        m_Tombstones(0),
+        m_Buckets(initial_buckets) {}
+
+  /// @brief Inserts or replaces the entry for ident
+  void Insert(
+      const IdentHash& ident,
+      std::shared_ptr<RouterInfo> router) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    // 0.75 load factor counting tombstones, so expiry pruning cannot
+    // deplete the empty slots that terminate probe scans; rehashing at
+    // the same size merely clears accumulated tombstones
+    if ((m_Size + m_Tombstones + 1) * 4 > m_Buckets.size() * 3)
+      Rehash(
+          (m_Size + 1) * 4 > m_Buckets.size() * 3
+              ? m_Buckets.size() * 2
+              : m_Buckets.size());
+    InsertNonThreadSafe(ident, router);
+  }
+
+  std::shared_ptr<RouterInfo> Find(
+      const IdentHash& ident) const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    const Bucket* bucket = FindBucket(ident);
+    return bucket ? bucket->router : nullptr;
+  }
+
+  bool Erase(
+      const IdentHash& ident) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    Bucket* bucket = const_cast<Bucket*>(FindBucket(ident));
+    if (!bucket)
+      return false;
+    bucket->router = nullptr;
+    bucket->state = Bucket::Tombstone;
+    m_Size--;
+    m_Tombstones++;
+    RetireFromCohorts(CohortMask(bucket->desc));
+    return true;
+  }
+
+  std::size_t Size() const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    return m_Size;
+  }
+
+  void Clear() {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    for (auto& bucket : m_Buckets)
+      bucket = Bucket();
+    m_Size = 0;
+    m_Tombstones = 0;
+    for (auto& index : m_Cohorts)
+      index.clear();
+    m_CohortDead.fill(0);
+  }
+
+  /// @brief Visits every entry under a shared lock; the visitor must not
+  ///   call back into this table
+  template<typename Visitor>
+  void ForEach(
+      Visitor visit) const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    for (const auto& bucket : m_Buckets)
+      if (bucket.state == Bucket::Full)
+        visit(bucket.ident, bucket.router);
+  }
+
+  /// @brief Returns the first cohort member at or after a random index
+  ///   position accepted by filter(ident, descriptor, router). Inserts
+  ///   keep the cohorts uniform, so a uniform starting point gives an
+  ///   (approximately) uniform pick among matching entries; almost every
+  ///   draw resolves on its first slot since cohort members already
+  ///   advertise the wanted capability. Slots whose bucket no longer
+  ///   holds a member are skipped here and reclaimed by RetireFromCohorts
+  ///   once dead slots outnumber live ones
+  template<typename Filter>
+  std::shared_ptr<RouterInfo> SelectRandom(
+      SelectionCohort cohort,
+      std::size_t random_start,
+      Filter filter) const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    const auto& index = m_Cohorts[cohort];
+    if (index.empty())
+      return nullptr;
+    const std::size_t start = random_start % index.size();
+    for (std::size_t probe = 0; probe < index.size(); probe++) {
+      const std::size_t slot = index[(start + probe) % index.size()];
+      const Bucket& bucket = m_Buckets[slot];
+      if (bucket.state == Bucket::Full
+          && (CohortMask(bucket.desc) & (1 << cohort))
+          && filter(bucket.ident, bucket.desc, bucket.router))
+        return bucket.router;
+    }
+    return nullptr;
+  }
+
+  /// @brief Erases every entry matching pred(ident, router)
+  /// @return Number of erased entries
+  template<typename Predicate>
+  std::size_t EraseIf(
+      Predicate pred) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    std::size_t erased = 0;
+    for (auto& bucket : m_Buckets) {
+      if (bucket.state == Bucket::Full && pred(bucket.ident, bucket.router)) {
+        bucket.router = nullptr;
+        bucket.state = Bucket::Tombstone;
+        m_Size--;
+        m_Tombstones++;
+        erased++;
+        RetireFromCohorts(CohortMask(bucket.desc));
+      }
+    }
+    return erased;
+  }
+
+ private:
+  struct Bucket {
+    enum State : std::uint8_t { Empty = 0, Full, Tombstone };
+    IdentHash ident;
+    std::shared_ptr<RouterInfo> router;
+    RouterDescriptor desc;
+    State state = Empty;
+  };
+
+  /// @brief Every insert path has already parsed the router (cap and
+  ///   reachability checks), so the snapshot costs two member reads
+  static RouterDescriptor Describe(
+      const RouterInfo& router) {
+    RouterDescriptor desc;
+    desc.caps = router.GetCaps();
+    desc.transports = router.GetSupportedTransports();
+    return desc;
+  }
+
+  static std::size_t Hash(
+      const IdentHash& ident) {
+    return ident.Hash64();
+  }
+
+  /// @brief Cohort membership bits derived from the descriptor snapshot
+  static std::uint8_t CohortMask(
+      const RouterDescriptor& desc) {
+    if (desc.caps & RouterInfo::Cap::Hidden)
+      return 0;  // hidden routers are never selection candidates
+    std::uint8_t mask = 1 << CohortAny;
+    if (desc.caps & RouterInfo::Cap::HighBandwidth)
+      mask |= 1 << CohortHighBandwidth;
+    if (desc.caps & RouterInfo::Cap::SSUTesting)
+      mask |= 1 << CohortSSUTesting;
+    if (desc.caps & RouterInfo::Cap::SSUIntroducer)
+      mask |= 1 << CohortSSUIntroducer;
+    return mask;
+  }
+
+  void AddToCohorts(
+      std::uint8_t mask,
+      std::size_t slot) {
+    for (std::size_t cohort = 0; cohort < NumCohorts; cohort++)
+      if (mask & (1 << cohort))
+        m_Cohorts[cohort].push_back(static_cast<std::uint32_t>(slot));
+  }
+
+  /// @brief Counts retired members; a cohort whose dead slots outnumber
+  ///   the live ones is rebuilt, which also sheds the duplicate slot
+  ///   entries a tombstone reuse can leave behind
+  void RetireFromCohorts(
+      std::uint8_t mask) {
+    for (std::size_t cohort = 0; cohort < NumCohorts; cohort++) {
+      if (!(mask & (1 << cohort)))
+        continue;
+      if (++m_CohortDead[cohort] * 2 > m_Cohorts[cohort].size())
+        RebuildCohort(static_cast<SelectionCohort>(cohort));
+    }
+  }
+
+  void RebuildCohort(
+      SelectionCohort cohort) {
+    auto& index = m_Cohorts[cohort];
+    index.clear();
+    for (std::size_t slot = 0; slot < m_Buckets.size(); slot++)
+      if (m_Buckets[slot].state == Bucket::Full
+          && (CohortMask(m_Buckets[slot].desc) & (1 << cohort)))
+        index.push_back(static_cast<std::uint32_t>(slot));
+    m_CohortDead[cohort] = 0;
+  }
+
+  const Bucket* FindBucket(
+      const IdentHash& ident) const {
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::size_t pos = Hash(ident) & mask;
+    for (std::size_t probe = 0; probe < m_Buckets.size(); probe++) {
+      const Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Empty)
+        return nullptr;
+      if (bucket.state == Bucket::Full && bucket.ident.Eq(ident))
+        return &bucket;
+      pos = (pos + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  void InsertNonThreadSafe(
+      const IdentHash& ident,
+      const std::shared_ptr<RouterInfo>& router) {
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::size_t pos = Hash(ident) & mask;
+    Bucket* tombstone = nullptr;
+    for (;;) {
+      Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Full && bucket.ident.Eq(ident)) {
+        const std::uint8_t old_mask = CohortMask(bucket.desc);
+        bucket.router = router;  // replace
+        bucket.desc = Describe(*router);
+        const std::uint8_t new_mask = CohortMask(bucket.desc);
+        AddToCohorts(new_mask & ~old_mask, pos);
+        RetireFromCohorts(old_mask & ~new_mask);
+        return;
+      }
+      if (bucket.state == Bucket::Tombstone && !tombstone) {
+        tombstone = &bucket;
+      } else if (bucket.state == Bucket::Empty) {
+        Bucket& target = tombstone ? *tombstone : bucket;
+        if (tombstone)
+          m_Tombstones--;
+        target.ident = ident;
+        target.router = router;
+        target.desc = Describe(*router);
+        target.state = Bucket::Full;
+        m_Size++;
+        AddToCohorts(
+            CohortMask(target.desc),
+            static_cast<std::size_t>(&target - m_Buckets.data()));
+        return;
+      }
+      pos = (pos + 1) & mask;
+    }
+  }
+
+  void Rehash(
+      std::size_t new_buckets) {
+    std::vector<Bucket> old = std::move(m_Buckets);
+    m_Buckets.assign(new_buckets, Bucket());
+    m_Size = 0;
+    m_Tombstones = 0;
+    // re-insertion below repopulates the cohort indexes with fresh slots
+    for (auto& index : m_Cohorts)
+      index.clear();
+    m_CohortDead.fill(0);
+    for (auto& bucket : old)
+      if (bucket.state == Bucket::Full)
+        InsertNonThreadSafe(bucket.ident, bucket.router);
+  }
+
+ private:
+  mutable std::shared_timed_mutex m_Mutex;
+  std::size_t m_Size;
+  std::size_t m_Tombstones;
+  std::vector<Bucket> m_Buckets;
+  // per-cohort flat arrays of bucket slots plus lazy-repair counters
+  std::array<std::vector<std::uint32_t>, NumCohorts> m_Cohorts;
+  std::array<std::size_t, NumCohorts> m_CohortDead{};
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_NET_DB_ROUTER_TABLE_H_
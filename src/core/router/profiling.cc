@@ -32,15 +32,21 @@
 
 #include "core/router/profiling.h"
 
-#include <boost/filesystem.hpp>
-#include <boost/property_tree/ini_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
-
-#include <cctype>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "core/util/exception.h"
+#include "core/util/file_writer.h"
 #include "core/util/filesystem.h"
 #include "core/util/log.h"
+#include "core/util/timestamp.h"
 
 namespace kovri {
 namespace core {
@@ -49,12 +55,21 @@ RouterProfile::RouterProfile(
     const IdentHash& ident_hash)
     : m_IdentHash(ident_hash),
       m_LastUpdateTime(boost::posix_time::second_clock::local_time()),
-      m_NumTunnelsAgreed(0),
-      m_NumTunnelsDeclined(0),
-      m_NumTunnelsNonReplied(0),
+      m_FastAgreed(0),
+      m_FastDeclined(0),
+      m_FastNonReplied(0),
+      m_SlowAgreed(0),
+      m_SlowDeclined(0),
+      m_SlowNonReplied(0),
+      m_LastDecay(kovri::core::GetMillisecondsSinceEpoch()),
       m_NumTimesTaken(0),
       m_NumTimesRejected(0),
-      m_Exception(__func__) {}
+      m_MeanRTT(0),
+      m_NumRTTSamples(0),
+      m_MeanNTCPHandshake(0),
+      m_NumNTCPHandshakes(0),
+      m_MeanSSUHandshake(0),
+      m_NumSSUHandshakes(0) {}
 
 boost::posix_time::ptime RouterProfile::GetTime() const {
   return boost::posix_time::second_clock::local_time();
@@ -64,172 +79,129 @@ void RouterProfile::UpdateTime() {
   m_LastUpdateTime = GetTime();
 }
 
-void RouterProfile::Save() {
-  // fill sections
-  boost::property_tree::ptree participation;
-  participation.put(
-      PEER_PROFILE_PARTICIPATION_AGREED,
-      m_NumTunnelsAgreed);
-  participation.put(
-      PEER_PROFILE_PARTICIPATION_DECLINED,
-      m_NumTunnelsDeclined);
-  participation.put(
-      PEER_PROFILE_PARTICIPATION_NON_REPLIED,
-      m_NumTunnelsNonReplied);
-  boost::property_tree::ptree usage;
-  usage.put(
-      PEER_PROFILE_USAGE_TAKEN,
-      m_NumTimesTaken);
-  usage.put(
-      PEER_PROFILE_USAGE_REJECTED,
-      m_NumTimesRejected);
-  // fill property tree
-  boost::property_tree::ptree pt;
-  pt.put(
-      PEER_PROFILE_LAST_UPDATE_TIME,
-      boost::posix_time::to_simple_string(
-        m_LastUpdateTime));
-  pt.put_child(
-      PEER_PROFILE_SECTION_PARTICIPATION,
-      participation);
-  pt.put_child(
-      PEER_PROFILE_SECTION_USAGE,
-      usage);
-  // Save to file
-  // TODO(unassigned): this entire block is a patch for #519 until we implement a database in #385
-  try
-    {
-      auto directory = core::GetPath(core::Path::Profiles);
-      std::string sub_dir;
-      if (!boost::filesystem::exists(directory))
-        {
-          LOG(debug) << "RouterProfile: ensuring " << directory;
-          core::EnsurePath(directory);
-#if defined(_WIN32) || defined(__APPLE__)
-          core::EnsurePath(directory / "uppercase");
-          core::EnsurePath(directory / "lowercase");
-#endif
-          for (const auto& ch : core::Base64::GetAlphabet())
-            {
-#if defined(_WIN32) || defined(__APPLE__)
-              sub_dir = std::isupper(ch) ? "uppercase" : "lowercase";
-#endif
-              const auto& path =
-                  directory / sub_dir / (std::string("p") + ch);
-              LOG(debug) << "RouterProfile: ensuring " << path;
-              core::EnsurePath(path);
-            }
-        }
-      std::string base64 = m_IdentHash.ToBase64();
-#if defined(_WIN32) || defined(__APPLE__)
-      sub_dir = std::isupper(base64[0]) ? "uppercase" : "lowercase";
-#endif
-      directory = directory / sub_dir / (std::string("p") + base64[0]);
-      const auto& filename =
-          directory / (std::string(PEER_PROFILE_PREFIX) + base64 + ".txt");
-      LOG(debug) << "RouterProfile: saving " << filename;
-      boost::property_tree::write_ini(filename.string(), pt);
-    }
-  catch (...)
-    {
-      m_Exception.Dispatch(__func__);
-      // TODO(unassigned): surely we don't want to simply return
-      return;
-    }
+void RouterProfile::Serialize(
+    OutputByteStream& stream) const {
+  std::uint64_t const last_update =
+      (m_LastUpdateTime - boost::posix_time::from_time_t(0)).total_seconds();
+  stream.Write<std::uint64_t>(last_update);
+  stream.Write<std::uint64_t>(m_LastDecay);
+  // decaying accumulators travel as 24.8 fixed point: they are bounded
+  // by the event rate over one time constant, so 24 integer bits suffice
+  stream.Write<std::uint32_t>(static_cast<std::uint32_t>(m_FastAgreed * 256));
+  stream.Write<std::uint32_t>(static_cast<std::uint32_t>(m_FastDeclined * 256));
+  stream.Write<std::uint32_t>(
+      static_cast<std::uint32_t>(m_FastNonReplied * 256));
+  stream.Write<std::uint32_t>(static_cast<std::uint32_t>(m_SlowAgreed * 256));
+  stream.Write<std::uint32_t>(static_cast<std::uint32_t>(m_SlowDeclined * 256));
+  stream.Write<std::uint32_t>(
+      static_cast<std::uint32_t>(m_SlowNonReplied * 256));
+  stream.Write<std::uint32_t>(m_NumTimesTaken);
+  stream.Write<std::uint32_t>(m_NumTimesRejected);
+  stream.Write<std::uint32_t>(m_MeanRTT);
+  stream.Write<std::uint32_t>(m_NumRTTSamples);
+  stream.Write<std::uint32_t>(m_MeanNTCPHandshake);
+  stream.Write<std::uint32_t>(m_NumNTCPHandshakes);
+  stream.Write<std::uint32_t>(m_MeanSSUHandshake);
+  stream.Write<std::uint32_t>(m_NumSSUHandshakes);
 }
 
-void RouterProfile::Load() {
-  std::string base64 = m_IdentHash.ToBase64();
-  auto directory = core::GetPath(core::Path::Profiles);
-  // TODO(unassigned): this is a patch for #519 until we implement a database in #385
-  std::string sub_dir;
-#if defined(_WIN32) || defined(__APPLE__)
-  sub_dir = std::isupper(base64[0]) ? "uppercase" : "lowercase";
-#endif
-  directory = directory / sub_dir / (std::string("p") + base64[0]);
-  auto filename = directory / sub_dir / (std::string(PEER_PROFILE_PREFIX) + base64 + ".txt");
-  if (boost::filesystem::exists(filename)) {
-    boost::property_tree::ptree pt;
-    try {
-      boost::property_tree::read_ini(filename.string(), pt);
-    } catch (const std::exception& ex) {
-      LOG(error) << "RouterProfile: can't read " << filename << ": " << ex.what();
-      return;
-    }
-    try {
-      auto t = pt.get(PEER_PROFILE_LAST_UPDATE_TIME, "");
-      if (t.length() > 0)
-        m_LastUpdateTime = boost::posix_time::time_from_string(t);
-      if ((GetTime() - m_LastUpdateTime).hours() <
-          PEER_PROFILE_EXPIRATION_TIMEOUT) {
-        try {
-          // read participations
-          auto participations = pt.get_child(
-              PEER_PROFILE_SECTION_PARTICIPATION);
-          m_NumTunnelsAgreed = participations.get(
-              PEER_PROFILE_PARTICIPATION_AGREED,
-              0);
-          m_NumTunnelsDeclined = participations.get(
-              PEER_PROFILE_PARTICIPATION_DECLINED,
-              0);
-          m_NumTunnelsNonReplied = participations.get(
-              PEER_PROFILE_PARTICIPATION_NON_REPLIED,
-              0);
-        } catch (const boost::property_tree::ptree_bad_path&) {
-          LOG(warning)
-            << "RouterProfile: Missing section "
-            << PEER_PROFILE_SECTION_PARTICIPATION;
-        }
-        try {
-          // read usage
-          auto usage = pt.get_child(PEER_PROFILE_SECTION_USAGE);
-          m_NumTimesTaken = usage.get(PEER_PROFILE_USAGE_TAKEN, 0);
-          m_NumTimesRejected = usage.get(PEER_PROFILE_USAGE_REJECTED, 0);
-        } catch (const boost::property_tree::ptree_bad_path&) {
-          LOG(warning)
-            << "RouterProfile: missing section " << PEER_PROFILE_SECTION_USAGE;
-        }
-      } else {
-        *this = RouterProfile(m_IdentHash);
-      }
-    } catch (const std::exception& ex) {
-      LOG(error)
-        << "RouterProfile: can't read profile " << base64 << " :" << ex.what();
-    }
+void RouterProfile::Deserialize(
+    InputByteStream& stream) {
+  m_LastUpdateTime = boost::posix_time::from_time_t(
+      static_cast<std::time_t>(stream.Read<std::uint64_t>()));
+  m_LastDecay = stream.Read<std::uint64_t>();
+  m_FastAgreed = stream.Read<std::uint32_t>() / 256.;
+  m_FastDeclined = stream.Read<std::uint32_t>() / 256.;
+  m_FastNonReplied = stream.Read<std::uint32_t>() / 256.;
+  m_SlowAgreed = stream.Read<std::uint32_t>() / 256.;
+  m_SlowDeclined = stream.Read<std::uint32_t>() / 256.;
+  m_SlowNonReplied = stream.Read<std::uint32_t>() / 256.;
+  m_NumTimesTaken = stream.Read<std::uint32_t>();
+  m_NumTimesRejected = stream.Read<std::uint32_t>();
+  m_MeanRTT = stream.Read<std::uint32_t>();
+  m_NumRTTSamples = stream.Read<std::uint32_t>();
+  m_MeanNTCPHandshake = stream.Read<std::uint32_t>();
+  m_NumNTCPHandshakes = stream.Read<std::uint32_t>();
+  m_MeanSSUHandshake = stream.Read<std::uint32_t>();
+  m_NumSSUHandshakes = stream.Read<std::uint32_t>();
+}
+
+void RouterProfile::Decay() {
+  std::uint64_t const now = kovri::core::GetMillisecondsSinceEpoch();
+  if (now > m_LastDecay) {
+    double const elapsed = now - m_LastDecay;
+    double const fast = std::exp(-elapsed / PEER_PROFILE_FAST_TIME_CONSTANT);
+    double const slow = std::exp(-elapsed / PEER_PROFILE_SLOW_TIME_CONSTANT);
+    m_FastAgreed *= fast;
+    m_FastDeclined *= fast;
+    m_FastNonReplied *= fast;
+    m_SlowAgreed *= slow;
+    m_SlowDeclined *= slow;
+    m_SlowNonReplied *= slow;
   }
+  m_LastDecay = now;
 }
 
 void RouterProfile::TunnelBuildResponse(
     std::uint8_t ret) {
   UpdateTime();
-  if (ret > 0)
-    m_NumTunnelsDeclined++;
-  else
-    m_NumTunnelsAgreed++;
+  Decay();
+  if (ret > 0) {
+    m_FastDeclined += 1;
+    m_SlowDeclined += 1;
+  } else {
+    m_FastAgreed += 1;
+    m_SlowAgreed += 1;
+  }
 }
 
 void RouterProfile::TunnelNonReplied() {
-  m_NumTunnelsNonReplied++;
   UpdateTime();
+  Decay();
+  m_FastNonReplied += 1;
+  m_SlowNonReplied += 1;
+}
+
+void RouterProfile::RecordRTT(
+    std::uint64_t rtt) {
+  UpdateTime();
+  if (!m_NumRTTSamples)
+    m_MeanRTT = rtt;
+  else  // recent measurements dominate, stale routes fade out
+    m_MeanRTT = (m_MeanRTT * 7 + rtt) / 8;
+  m_NumRTTSamples++;
+}
+
+void RouterProfile::RecordHandshakeLatency(
+    bool ssu,
+    std::uint64_t latency) {
+  UpdateTime();
+  std::uint32_t& mean = ssu ? m_MeanSSUHandshake : m_MeanNTCPHandshake;
+  std::uint32_t& samples = ssu ? m_NumSSUHandshakes : m_NumNTCPHandshakes;
+  if (!samples)
+    mean = latency;
+  else  // recent measurements dominate, stale routes fade out
+    mean = (mean * 7 + latency) / 8;
+  samples++;
 }
 
 bool RouterProfile::IsLowPartcipationRate() const {
-  return 4 * m_NumTunnelsAgreed < m_NumTunnelsDeclined;  // < 20% rate
+  return 4 * m_SlowAgreed < m_SlowDeclined;  // < 20% rate
 }
 
 bool RouterProfile::IsLowReplyRate() const {
-  auto total = m_NumTunnelsAgreed + m_NumTunnelsDeclined;
-  return m_NumTunnelsNonReplied > 10 * (total + 1);
+  auto total = m_SlowAgreed + m_SlowDeclined;
+  return m_SlowNonReplied > 10 * (total + 1);
 }
 
 bool RouterProfile::IsBad() {
+  Decay();
   auto is_bad =
     IsAlwaysDeclining() || IsLowPartcipationRate() /*|| IsLowReplyRate ()*/;
   if (is_bad && m_NumTimesRejected > 10 * (m_NumTimesTaken + 1)) {
     // reset profile
-    m_NumTunnelsAgreed = 0;
-    m_NumTunnelsDeclined = 0;
-    m_NumTunnelsNonReplied = 0;
+    m_FastAgreed = m_FastDeclined = m_FastNonReplied = 0;
+    m_SlowAgreed = m_SlowDeclined = m_SlowNonReplied = 0;
     is_bad = false;
   }
   if (is_bad)
@@ -239,51 +211,187 @@ bool RouterProfile::IsBad() {
   return is_bad;
 }
 
+double RouterProfile::GetScore() {
+  Decay();
+  // Participation: the fast rate converges within a few build attempts
+  // while the slow rate anchors the estimate in sustained behavior; both
+  // are Laplace-smoothed so an unknown peer starts neutral, not extreme
+  double const fast_total = m_FastAgreed + m_FastDeclined + m_FastNonReplied;
+  double const slow_total = m_SlowAgreed + m_SlowDeclined + m_SlowNonReplied;
+  double const fast_rate = (m_FastAgreed + 1) / (fast_total + 2);
+  double const slow_rate = (m_SlowAgreed + 1) / (slow_total + 2);
+  double score = 0.7 * fast_rate + 0.3 * slow_rate;
+  // Connection latency: the tunnel test round trip when measured,
+  // otherwise the transport handshake estimate; scale the score toward
+  // zero as the delay grows, leaving unmeasured peers at a neutral rank
+  std::uint32_t latency = PEER_PROFILE_NEUTRAL_LATENCY;
+  if (m_NumRTTSamples)
+    latency = m_MeanRTT;
+  else if (m_NumNTCPHandshakes && m_NumSSUHandshakes)
+    latency = std::min(m_MeanNTCPHandshake, m_MeanSSUHandshake);
+  else if (m_NumNTCPHandshakes)
+    latency = m_MeanNTCPHandshake;
+  else if (m_NumSSUHandshakes)
+    latency = m_MeanSSUHandshake;
+  return score
+         * PEER_PROFILE_NEUTRAL_LATENCY
+         / (PEER_PROFILE_NEUTRAL_LATENCY + latency);
+}
+
+namespace {
+
+/// All live profiles keyed by peer; persistence happens only in
+/// whole-table snapshots, never per profile
+std::map<IdentHash, std::shared_ptr<RouterProfile> > g_Profiles;
+std::mutex g_ProfilesMutex;
+bool g_ProfilesLoaded = false;
+
+// 2: adds per-transport handshake latency estimates
+// 3: decaying participation rates (24.8 fixed point) and decay stamp
+enum ProfileSnapshot : std::uint8_t { Version = 3 };
+const std::array<std::uint8_t, 4> ProfileSnapshotMagic {{
+    0x4B, 0x56, 0x50, 0x52 }};  // "KVPR"
+
+/// @brief One-time load of the snapshot into the table
+/// @notes Caller must hold g_ProfilesMutex
+void LoadProfiles() {
+  g_ProfilesLoaded = true;
+  auto const filename =
+      (core::GetPath(core::Path::Profiles) / PEER_PROFILES_SNAPSHOT_FILENAME)
+          .string();
+  std::ifstream file(filename, std::ifstream::binary);
+  if (!file) {
+    LOG(debug) << "Profiling: " << filename << " not found";
+    return;
+  }
+  // Read the whole snapshot in one pass; records are parsed in place
+  file.seekg(0, std::ios::end);
+  const std::size_t len = file.tellg();
+  file.seekg(0, std::ios::beg);
+  std::vector<std::uint8_t> buf(len);
+  if (len < ProfileSnapshotMagic.size() + sizeof(std::uint8_t)
+            + sizeof(std::uint32_t)
+      || !file.read(reinterpret_cast<char*>(buf.data()), len)) {
+    LOG(warning) << "Profiling: could not read profile snapshot";
+    return;
+  }
+  try {
+    core::InputByteStream stream(buf.data(), buf.size());
+    if (!std::equal(
+            ProfileSnapshotMagic.begin(),
+            ProfileSnapshotMagic.end(),
+            stream.ReadBytes(ProfileSnapshotMagic.size()))
+        || stream.Read<std::uint8_t>() != ProfileSnapshot::Version) {
+      LOG(warning) << "Profiling: unknown snapshot format, ignoring";
+      return;
+    }
+    const std::uint32_t count = stream.Read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < count; i++) {
+      IdentHash const ident(stream.ReadBytes(sizeof(IdentHash)));
+      auto profile = std::make_shared<RouterProfile>(ident);
+      profile->Deserialize(stream);
+      if (!profile->IsExpired())
+        g_Profiles[ident] = profile;
+    }
+  } catch (const std::exception& ex) {
+    LOG(warning) << "Profiling: invalid profile snapshot: " << ex.what();
+    g_Profiles.clear();
+    return;
+  }
+  LOG(debug) << "Profiling: " << g_Profiles.size() << " profiles loaded";
+}
+
+}  // namespace
+
 std::shared_ptr<RouterProfile> GetRouterProfile(
     const IdentHash& ident_hash) {
+  std::unique_lock<std::mutex> l(g_ProfilesMutex);
+  if (!g_ProfilesLoaded)
+    LoadProfiles();
+  auto it = g_Profiles.find(ident_hash);
+  if (it != g_Profiles.end())
+    return it->second;
   auto profile = std::make_shared<RouterProfile>(ident_hash);
-  profile->Load();  // if possible
+  g_Profiles[ident_hash] = profile;
   return profile;
 }
 
-void DeleteObsoleteProfiles()
-{
-  boost::filesystem::path path(core::GetPath(core::Path::Profiles));
+std::vector<IdentHash> GetMostUsedRouters(std::size_t limit) {
+  std::vector<std::pair<std::uint32_t, IdentHash>> used;
+  {
+    std::unique_lock<std::mutex> l(g_ProfilesMutex);
+    if (!g_ProfilesLoaded)
+      LoadProfiles();
+    for (const auto& it : g_Profiles)
+      if (it.second->GetNumTimesTaken() && !it.second->IsExpired())
+        used.emplace_back(it.second->GetNumTimesTaken(), it.first);
+  }
+  const std::size_t count = std::min(limit, used.size());
+  std::partial_sort(
+      used.begin(),
+      used.begin() + count,
+      used.end(),
+      [](const std::pair<std::uint32_t, IdentHash>& a,
+         const std::pair<std::uint32_t, IdentHash>& b) {
+        return a.first > b.first;
+      });
+  std::vector<IdentHash> idents;
+  idents.reserve(count);
+  for (std::size_t i = 0; i < count; i++)
+    idents.push_back(used[i].second);
+  return idents;
+}
+
+void DeleteObsoleteProfiles() {
+  std::unique_lock<std::mutex> l(g_ProfilesMutex);
   std::size_t num_profiles = 0;
-  auto RemoveProfiles = [&](const boost::filesystem::path& path) {
-    auto timestamp = boost::posix_time::second_clock::local_time();
-    if (boost::filesystem::exists(path))
-      {
-        boost::filesystem::directory_iterator end;
-        for (boost::filesystem::directory_iterator dir(path); dir != end; ++dir)
-          {
-            if (boost::filesystem::is_directory(dir->status()))
-              {
-                for (boost::filesystem::directory_iterator it(dir->path());
-                     it != end;
-                     ++it)
-                  {
-                    auto last_modified = boost::posix_time::from_time_t(
-                        boost::filesystem::last_write_time(it->path()));
-                    if ((timestamp - last_modified).hours()
-                        >= PEER_PROFILE_EXPIRATION_TIMEOUT)
-                      {
-                        boost::filesystem::remove(it->path());
-                        num_profiles++;
-                      }
-                  }
-              }
-          }
-      }
-  };
-// TODO(unassigned): this is a patch for #519 until we implement a database in #385
-#if defined(_WIN32) || defined(__APPLE__)
-  RemoveProfiles(path / "uppercase");
-  RemoveProfiles(path / "lowercase");
-#else
-  RemoveProfiles(path);
-#endif
-  LOG(debug) << "Profiling: " << num_profiles << " obsolete profiles deleted";
+  for (auto it = g_Profiles.begin(); it != g_Profiles.end();) {
+    if (it->second->IsExpired()) {
+      it = g_Profiles.erase(it);
+      num_profiles++;
+    } else {
+      ++it;
+    }
+  }
+  LOG(debug) << "Profiling: " << num_profiles << " obsolete profiles dropped";
+}
+
+void SaveRouterProfiles() {
+  std::unique_lock<std::mutex> l(g_ProfilesMutex);
+  if (!g_ProfilesLoaded)
+    return;  // nothing was ever requested, nothing to persist
+  // Fixed-size records: header plus ident and counters per profile
+  std::size_t const len =
+      ProfileSnapshotMagic.size() + sizeof(std::uint8_t)
+      + sizeof(std::uint32_t)
+      + g_Profiles.size()
+            * (sizeof(IdentHash) + 2 * sizeof(std::uint64_t)
+               + 14 * sizeof(std::uint32_t));
+  core::OutputByteStream stream(len);
+  stream.WriteData(ProfileSnapshotMagic.data(), ProfileSnapshotMagic.size());
+  stream.Write<std::uint8_t>(ProfileSnapshot::Version);
+  stream.Write<std::uint32_t>(g_Profiles.size());
+  for (auto const& it : g_Profiles) {
+    stream.WriteData(it.first, sizeof(IdentHash));
+    it.second->Serialize(stream);
+  }
+  try {
+    auto const directory = core::GetPath(core::Path::Profiles);
+    core::EnsurePath(directory);
+    auto const filename =
+        (directory / PEER_PROFILES_SNAPSHOT_FILENAME).string();
+    // hand the snapshot to the shared writer: the periodic save runs on
+    // the NetDb thread and must not block on disk
+    file_writer.QueueWrite(
+        filename,
+        std::vector<std::uint8_t>(
+            stream.data(), stream.data() + stream.size()));
+  } catch (...) {
+    core::Exception ex;
+    ex.Dispatch(__func__);
+    return;
+  }
+  LOG(debug) << "Profiling: " << g_Profiles.size() << " profiles queued for save";
 }
 
 }  // namespace core
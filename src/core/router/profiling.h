@@ -36,47 +36,106 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <memory>
+#include <vector>
 
 #include "core/router/identity.h"
 
-#include "core/util/exception.h"
+#include "core/util/byte_stream.h"
 
 namespace kovri {
 namespace core {
 
-const char PEER_PROFILE_PREFIX[] = "profile-";
-// sections
-const char PEER_PROFILE_SECTION_PARTICIPATION[] = "participation";
-const char PEER_PROFILE_SECTION_USAGE[] = "usage";
-// params
-const char PEER_PROFILE_LAST_UPDATE_TIME[] = "lastupdatetime";
-const char PEER_PROFILE_PARTICIPATION_AGREED[] = "agreed";
-const char PEER_PROFILE_PARTICIPATION_DECLINED[] = "declined";
-const char PEER_PROFILE_PARTICIPATION_NON_REPLIED[] = "nonreplied";
-const char PEER_PROFILE_USAGE_TAKEN[] = "taken";
-const char PEER_PROFILE_USAGE_REJECTED[] = "rejected";
+/// @brief Single snapshot file holding the whole profile table
+const char PEER_PROFILES_SNAPSHOT_FILENAME[] = "profiles.bin";
 
 const int PEER_PROFILE_EXPIRATION_TIMEOUT = 72;  // in hours (3 days)
 
+/// @brief Fast decay time constant for participation rates (milliseconds);
+///  build outcomes fade within minutes, so a recovering peer converges
+///  back into rotation after a handful of good responses
+const std::uint64_t PEER_PROFILE_FAST_TIME_CONSTANT = 10 * 60 * 1000;
+
+/// @brief Slow decay time constant for participation rates (milliseconds);
+///  keeps a memory of sustained behavior so one good streak cannot
+///  erase a long record of declines
+const std::uint64_t PEER_PROFILE_SLOW_TIME_CONSTANT = 6 * 60 * 60 * 1000;
+
+/// @brief Latency assumed when scoring a peer without any measurement
+///  (milliseconds); keeps unmeasured peers in rotation at a neutral rank
+const std::uint32_t PEER_PROFILE_NEUTRAL_LATENCY = 400;
+
 class RouterProfile {
  public:
   explicit RouterProfile(const IdentHash& ident_hash);
   RouterProfile& operator=(const RouterProfile&) = default;
 
-  void Save();
-  void Load();
+  /// @brief Appends this profile's counters to a snapshot stream
+  void Serialize(OutputByteStream& stream) const;
+
+  /// @brief Restores this profile's counters from a snapshot record
+  void Deserialize(InputByteStream& stream);
+
+  /// @brief Past the expiration window without an update
+  bool IsExpired() const {
+    return (GetTime() - m_LastUpdateTime).hours() >=
+           PEER_PROFILE_EXPIRATION_TIMEOUT;
+  }
 
   bool IsBad();
 
+  /// @brief Overall desirability of this peer as a tunnel hop
+  /// @return Score in (0, 1], higher is better: the decayed agree rate
+  ///   (fast component weighted above the slow one) scaled down by the
+  ///   measured latency; an unknown peer scores neutral, not extreme
+  double GetScore();
+
   void TunnelBuildResponse(std::uint8_t ret);
   void TunnelNonReplied();
 
+  /// @brief Folds a measured round trip into the running estimate
+  /// @param rtt this peer's share of a tunnel test round trip, in milliseconds
+  void RecordRTT(std::uint64_t rtt);
+
+  std::uint32_t GetMeanRTT() const {
+    return m_MeanRTT;
+  }
+
+  bool HasRTT() const {
+    return m_NumRTTSamples > 0;
+  }
+
+  /// @brief Folds a measured session establishment into the
+  ///   per-transport running estimate
+  /// @param ssu True for an SSU handshake, false for NTCP
+  /// @param latency time from dial to established, in milliseconds
+  void RecordHandshakeLatency(bool ssu, std::uint64_t latency);
+
+  /// @return Mean handshake latency for the transport, in milliseconds
+  std::uint32_t GetHandshakeLatency(bool ssu) const {
+    return ssu ? m_MeanSSUHandshake : m_MeanNTCPHandshake;
+  }
+
+  bool HasHandshakeLatency(bool ssu) const {
+    return (ssu ? m_NumSSUHandshakes : m_NumNTCPHandshakes) > 0;
+  }
+
+  /// @return Times this peer was taken into one of our tunnels, over the
+  ///   profile's lifetime; drives the connection prewarm order
+  std::uint32_t GetNumTimesTaken() const {
+    return m_NumTimesTaken;
+  }
+
  private:
   boost::posix_time::ptime GetTime() const;
   void UpdateTime();
 
+  /// @brief Applies the elapsed-time decay to the participation
+  ///   accumulators; called lazily before every read or update, so idle
+  ///   profiles decay without a timer touching them
+  void Decay();
+
   bool IsAlwaysDeclining() const {
-    return !m_NumTunnelsAgreed && m_NumTunnelsDeclined >= 5;
+    return m_SlowAgreed < 0.5 && m_FastDeclined >= 5;
   }
 
   bool IsLowPartcipationRate() const;
@@ -85,21 +144,47 @@ class RouterProfile {
  private:
   IdentHash m_IdentHash;
   boost::posix_time::ptime m_LastUpdateTime;
-  // participation
-  std::uint32_t m_NumTunnelsAgreed;
-  std::uint32_t m_NumTunnelsDeclined;
-  std::uint32_t m_NumTunnelsNonReplied;
+  // participation, as exponentially decaying event counts: the fast
+  // pair adapts within minutes, the slow pair remembers hours
+  double m_FastAgreed;
+  double m_FastDeclined;
+  double m_FastNonReplied;
+  double m_SlowAgreed;
+  double m_SlowDeclined;
+  double m_SlowNonReplied;
+  // last time the decay was applied (milliseconds since epoch)
+  std::uint64_t m_LastDecay;
   // usage
   std::uint32_t m_NumTimesTaken;
   std::uint32_t m_NumTimesRejected;
-  core::Exception m_Exception;
+  // latency (exponentially weighted mean, in milliseconds)
+  std::uint32_t m_MeanRTT;
+  std::uint32_t m_NumRTTSamples;
+  // per-transport handshake latency (exponentially weighted, milliseconds);
+  // drives the NTCP/SSU dial order in Transports::ConnectToPeer
+  std::uint32_t m_MeanNTCPHandshake;
+  std::uint32_t m_NumNTCPHandshakes;
+  std::uint32_t m_MeanSSUHandshake;
+  std::uint32_t m_NumSSUHandshakes;
 };
 
+/// @brief Returns the cached profile for a peer, creating one on first use
+/// @notes Profiles live in an in-memory table, so this never touches disk;
+///  the table is persisted in whole-table snapshots (SaveRouterProfiles)
 std::shared_ptr<RouterProfile> GetRouterProfile(
     const IdentHash& ident_hash);
 
+/// @brief Idents of our historically most-used peers, descending by how
+///   often they were taken into tunnels; at most limit entries
+/// @notes Used to prewarm transport sessions after a restart
+std::vector<IdentHash> GetMostUsedRouters(std::size_t limit);
+
+/// @brief Drops expired profiles from the in-memory table
 void DeleteObsoleteProfiles();
 
+/// @brief Writes all live profiles as one compact binary snapshot
+void SaveRouterProfiles();
+
 }  // namespace core
 }  // namespace kovri
 
@@ -40,100 +40,79 @@
 
 #include "core/router/context.h"
 #include "core/router/net_db/impl.h"
+#include "core/router/profiling.h"
+#include "core/router/transports/message_trace.h"
+#include "core/router/tunnel/impl.h"
 
+#include "core/util/event_bus.h"
+#include "core/util/histogram.h"
 #include "core/util/log.h"
+#include "core/util/memory_budget.h"
+#include "core/util/thread_registry.h"
+#include "core/util/trace.h"
 
 namespace kovri {
 namespace core {
 
 DHKeysPairSupplier::DHKeysPairSupplier(
     std::size_t size)
-    : m_QueueSize(size),
-      m_IsRunning(false),
-      m_Thread(nullptr),
+    : PrecomputePool<DHKeysPair>(
+          "DHKeysPairSupplier",
+          [this]() {
+            auto pair = std::make_unique<DHKeysPair>();
+            // TODO(anonimal): this try block should be larger or handled entirely by caller
+            try {
+              kovri::core::DiffieHellman().GenerateKeyPair(
+                  pair->private_key.data(),
+                  pair->public_key.data());
+            } catch (...) {
+              m_Exception.Dispatch(__func__);
+              // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+              throw;
+            }
+            return pair;
+          },
+          size,  // refill as soon as the pool dips below its full size
+          size),
       m_Exception(__func__) {}
 
-DHKeysPairSupplier::~DHKeysPairSupplier() {
-  Stop();
-}
-
-void DHKeysPairSupplier::Start() {
-  LOG(debug) << "DHKeysPairSupplier: starting";
-  m_IsRunning = true;
-  m_Thread =
-    std::make_unique<std::thread>(
-        std::bind(
-            &DHKeysPairSupplier::Run,
-            this));
-}
-
-void DHKeysPairSupplier::Stop() {
-  m_IsRunning = false;
-  m_Acquired.notify_one();
-  if (m_Thread) {
-    m_Thread->join();
-    m_Thread.reset(nullptr);
-  }
-}
-
-void DHKeysPairSupplier::Run() {
-  LOG(debug) << "DHKeysPairSupplier: running";
-  while (m_IsRunning) {
-    if (m_QueueSize > m_Queue.size ())
-      CreateDHKeysPairs(m_QueueSize - m_Queue.size());
-    std::unique_lock<std::mutex> l(m_AcquiredMutex);
-    m_Acquired.wait(l);  // wait for element gets acquired
-  }
+void Peer::Done() {
+  for (auto it : sessions)
+    it->Done();
 }
 
-void DHKeysPairSupplier::CreateDHKeysPairs(
-    std::size_t num) {
-  LOG(debug) << "DHKeysPairSupplier: creating";
-  // TODO(anonimal): this try block should be handled entirely by caller
-  try {
-    for (std::size_t i = 0; i < num; i++) {
-      auto pair = std::make_unique<kovri::core::DHKeysPair>();
-      kovri::core::DiffieHellman().GenerateKeyPair(
-          pair->private_key.data(),
-          pair->public_key.data());
-      std::unique_lock<std::mutex>  l(m_AcquiredMutex);
-      m_Queue.push(std::move(pair));
+bool Peer::QueueDelayed(std::shared_ptr<kovri::core::I2NPMessage> msg) {
+  auto const priority = GetI2NPMessagePriority(msg->GetTypeID());
+  if (delayed_messages.size() >= DELAYED_MESSAGE_LIMIT) {
+    // evict the oldest message of the least important class present;
+    // control messages are never evicted
+    auto victim = delayed_messages.end();
+    auto victim_priority = I2NPMessagePriority::Control;
+    for (auto it = delayed_messages.begin();
+         it != delayed_messages.end();
+         ++it) {
+      auto const queued = GetI2NPMessagePriority((*it)->GetTypeID());
+      if (queued > victim_priority) {
+        victim = it;
+        victim_priority = queued;
+        if (victim_priority == I2NPMessagePriority::Bulk)
+          break;  // nothing less important can follow
+      }
     }
-  } catch (...) {
-    m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
-  }
-}
-
-std::unique_ptr<DHKeysPair> DHKeysPairSupplier::Acquire() {
-  LOG(debug) << "DHKeysPairSupplier: acquiring";
-  std::unique_lock<std::mutex> l(m_AcquiredMutex);
-  if (!m_Queue.empty()) {
-    auto pair = std::move(m_Queue.front());
-    m_Queue.pop();
-    m_Acquired.notify_one();
-    return pair;
-  }
-  l.unlock();
-  // queue is empty, create new key pair
-  auto pair = std::make_unique<DHKeysPair>();
-  // TODO(anonimal): this try block should be larger or handled entirely by caller
-  try {
-    kovri::core::DiffieHellman().GenerateKeyPair(
-        pair->private_key.data(),
-        pair->public_key.data());
-  } catch (...) {
-    m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
+    if (victim != delayed_messages.end() && victim_priority >= priority) {
+      delayed_messages.erase(victim);
+      metrics.Inc(Metrics::TransportQueueDrops);
+    } else if (priority != I2NPMessagePriority::Control) {
+      // nothing expendable is queued: shed the arrival instead
+      LOG(debug) << "Transports: delayed queue full, message dropped";
+      metrics.Inc(Metrics::TransportQueueDrops);
+      return false;
+    }
+    // a control message rides regardless; the class is too small and
+    // too rare to threaten the bound
   }
-  return pair;
-}
-
-void Peer::Done() {
-  for (auto it : sessions)
-    it->Done();
+  delayed_messages.push_back(msg);
+  return true;
 }
 
 // Simply instantiating in namespace scope ties into, and is limited by, the current singleton design
@@ -142,11 +121,19 @@ Transports transports;
 
 Transports::Transports()
     : m_IsRunning(false),
-      m_Thread(nullptr),
       m_Work(m_Service),
+      m_Strand(m_Service),
       m_PeerCleanupTimer(m_Service),
       m_NTCPServer(nullptr),
       m_SSUServer(nullptr),
+      m_Scheduler(
+          m_Service,
+          m_Strand,
+          std::bind(
+              &Transports::DeliverMessages,
+              this,
+              std::placeholders::_1,
+              std::placeholders::_2)),
       // TODO(unassigned): get rid of magic number
       m_DHKeysPairSupplier(5),  // 5 pre-generated keys
       m_TotalSentBytes(0),
@@ -165,9 +152,41 @@ void Transports::Start() {
   if (context.GetOpts()["enable-upnp"].as<bool>())
     m_UPnP.Start();
 
+  const auto& trace_path =
+      context.GetOpts()["message-trace"].as<std::string>();
+  if (!trace_path.empty())
+    message_trace.Start(trace_path);
+
   m_DHKeysPairSupplier.Start();
   m_IsRunning = true;
-  m_Thread = std::make_unique<std::thread>(std::bind(&Transports::Run, this));
+  // Single shared io_service with N worker threads: sessions preserve
+  // their internal ordering through per-session/per-transport strands
+  std::uint16_t workers =
+      context.GetOpts()["transport-workers"].as<std::uint16_t>();
+  if (!workers)  // one worker per core
+    workers = std::max(1u, std::thread::hardware_concurrency());
+  LOG(debug) << "Transports: " << workers << " worker thread(s)";
+  for (std::uint16_t i = 0; i < workers; i++)
+    m_Threads.push_back(
+        std::make_unique<std::thread>(std::bind(&Transports::Run, this)));
+  m_Scheduler.Start();
+  // Handshake asymmetric crypto gets its own worker so connect storms
+  // queue behind each other instead of blocking the reactor threads
+  m_CryptoService.reset();
+  m_CryptoWork =
+      std::make_unique<boost::asio::io_service::work>(m_CryptoService);
+  m_CryptoThread = std::make_unique<std::thread>([this]() {
+    thread_registry.Register("handshake-crypto");
+    LOG(debug) << "Transports: handshake crypto worker running";
+    while (m_IsRunning) {
+      try {
+        m_CryptoService.run();
+      } catch (const std::exception& ex) {
+        LOG(error)
+          << "Transports: handshake crypto worker: '" << ex.what() << "'";
+      }
+    }
+  });
   // create acceptors
   const auto addresses = context.GetRouterInfo().GetAddresses();
   for (const auto& address : addresses) {
@@ -198,16 +217,44 @@ void Transports::Start() {
       boost::posix_time::seconds(
           5 * SESSION_CREATION_TIMEOUT));   // TODO(unassigned): why 5 seconds
   m_PeerCleanupTimer.async_wait(
-      std::bind(
+      m_Strand.wrap(std::bind(
           &Transports::HandlePeerCleanupTimer,
           this,
-          std::placeholders::_1));
+          std::placeholders::_1)));
+  const std::uint16_t prewarm =
+      context.GetOpts()["prewarm-connections"].as<std::uint16_t>();
+  if (prewarm)
+    m_Strand.post(
+        std::bind(&Transports::PrewarmConnections, this, prewarm));
+}
+
+void Transports::PrewarmConnections(std::uint16_t count) {
+  std::size_t dialed = 0;
+  for (const auto& ident : kovri::core::GetMostUsedRouters(count)) {
+    if (ident == context.GetRouterInfo().GetIdentHash()
+        || m_Peers.count(ident))
+      continue;
+    // an empty batch establishes the session and queues nothing; peers
+    // whose RI is gone fall into the usual NetDb request path
+    PostMessages(ident, {});
+    dialed++;
+  }
+  LOG(info)
+    << "Transports: prewarming " << dialed
+    << " connections to the most-used peers";
 }
 
 void Transports::Stop() {
+  message_trace.Stop();
   m_UPnP.Stop();
+  m_Scheduler.Stop();
   m_PeerCleanupTimer.cancel();
   m_Peers.clear();
+  memory_budget.Set(MemoryBudget::TransportQueues, 0);
+  {
+    std::lock_guard<std::mutex> lock(m_BackloggedMutex);
+    m_Backlogged.clear();
+  }
   if (m_SSUServer) {
     m_SSUServer->Stop();
     m_SSUServer.reset(nullptr);
@@ -218,14 +265,20 @@ void Transports::Stop() {
   }
   m_DHKeysPairSupplier.Stop();
   m_IsRunning = false;
-  m_Service.stop();
-  if (m_Thread) {
-    m_Thread->join();
-    m_Thread.reset(nullptr);
+  m_CryptoWork.reset(nullptr);
+  m_CryptoService.stop();
+  if (m_CryptoThread) {
+    m_CryptoThread->join();
+    m_CryptoThread.reset(nullptr);
   }
+  m_Service.stop();
+  for (auto& thread : m_Threads)
+    thread->join();
+  m_Threads.clear();
 }
 
 void Transports::Run() {
+  thread_registry.Register("transports");
   LOG(debug) << "Transports: running";
   while (m_IsRunning) {
     try {
@@ -252,6 +305,18 @@ void Transports::UpdateBandwidth() {
   m_LastBandwidthUpdateTime = ts;
   m_LastInBandwidthUpdateBytes = m_TotalReceivedBytes;
   m_LastOutBandwidthUpdateBytes = m_TotalSentBytes;
+  // feed the measured rate to the auto bandwidth-class advertisement
+  context.UpdateAdvertisedBandwidth(std::max(m_InBandwidth, m_OutBandwidth));
+  // sampled here so monitoring reads never touch the peers map
+  metrics.Set(Metrics::ActivePeers, m_Peers.size());
+  std::size_t delayed = 0, delayed_bytes = 0;
+  for (const auto& peer : m_Peers) {
+    delayed += peer.second.delayed_messages.size();
+    for (const auto& msg : peer.second.delayed_messages)
+      delayed_bytes += msg->GetLength();
+  }
+  metrics.Set(Metrics::DelayedQueueDepth, delayed);
+  memory_budget.Set(MemoryBudget::TransportQueues, delayed_bytes);
 }
 
 bool Transports::IsBandwidthExceeded() const {
@@ -276,7 +341,11 @@ void Transports::SendMessages(
     const kovri::core::IdentHash& ident,
     const std::vector<std::shared_ptr<kovri::core::I2NPMessage>>& msgs) {
   LOG(debug) << "Transports: sending messages";
-  m_Service.post(
+  if (message_trace.IsEnabled())
+    for (const auto& msg : msgs)
+      if (msg)
+        message_trace.Record(MessageTrace::Outbound, ident, *msg);
+  m_Strand.post(
       std::bind(
           &Transports::PostMessages,
           this,
@@ -288,6 +357,8 @@ void Transports::PostMessages(
     kovri::core::IdentHash ident,
     std::vector<std::shared_ptr<kovri::core::I2NPMessage>> msgs) {
   LOG(debug) << "Transports: posting messages";
+  // first ident word is enough to tell peers apart in a trace
+  KOVRI_PROBE2(transport_post, ident.GetLL()[0], msgs.size());
   if (ident == context.GetRouterInfo().GetIdentHash()) {
     // we send it to ourself
     for (auto msg : msgs)
@@ -310,13 +381,33 @@ void Transports::PostMessages(
       return;
   }
   if (!it->second.sessions.empty()) {
-    it->second.sessions.front()->SendI2NPMessages(msgs);
+    m_Scheduler.Send(ident, msgs);
   } else {
     for (auto msg : msgs)
-      it->second.delayed_messages.push_back(msg);
+      it->second.QueueDelayed(msg);
+    SetBacklogged(ident, it->second.IsBacklogged());
   }
 }
 
+void Transports::DeliverMessages(
+    const kovri::core::IdentHash& ident,
+    std::vector<std::shared_ptr<kovri::core::I2NPMessage>> msgs) {
+  auto it = m_Peers.find(ident);
+  if (it == m_Peers.end()) {
+    LOG(debug) << "Transports: peer gone before shaped delivery, dropping";
+    return;
+  }
+  if (it->second.sessions.empty()) {
+    // the session dropped while the batch was parked; hold the messages
+    // for the reconnect like any other sessionless send
+    for (auto msg : msgs)
+      it->second.QueueDelayed(msg);
+    SetBacklogged(ident, it->second.IsBacklogged());
+    return;
+  }
+  it->second.sessions.front()->SendI2NPMessages(msgs);
+}
+
 bool Transports::ConnectToPeer(
     const kovri::core::IdentHash& ident,
     Peer& peer) {
@@ -335,17 +426,22 @@ bool Transports::ConnectToPeer(
   LOG(debug)
     << "Transports: connecting to peer" << GetFormattedSessionInfo(peer.router);
   // If only NTCP or SSU is supported, always try the supported transport
-  // If both are supported, SSU is used for the second attempt
-  // Peers that fail on all supported transports are removed
+  // If both are supported, the historically faster handshake (from the
+  // peer's profile) is dialed first and the alternative on the second
+  // attempt. Peers that fail on all supported transports are removed
   bool result = false;
-  if (!m_NTCPServer && m_SSUServer)
+  if (!m_NTCPServer && m_SSUServer) {
     result = ConnectToPeerSSU(peer);
-  else if (m_NTCPServer && !m_SSUServer)
-    result = ConnectToPeerNTCP(peer);
-  else if (peer.num_attempts == 0)
+  } else if (m_NTCPServer && !m_SSUServer) {
     result = ConnectToPeerNTCP(peer);
-  else if (peer.num_attempts == 1)
-    result = ConnectToPeerSSU(peer);
+  } else if (peer.num_attempts == 0) {
+    peer.preferred_ssu = PreferSSU(peer);
+    result =
+      peer.preferred_ssu ? ConnectToPeerSSU(peer) : ConnectToPeerNTCP(peer);
+  } else if (peer.num_attempts == 1) {
+    result =
+      peer.preferred_ssu ? ConnectToPeerNTCP(peer) : ConnectToPeerSSU(peer);
+  }
   // Increase the number of attempts (even when no transports are available)
   ++peer.num_attempts;
   if (result)
@@ -354,9 +450,27 @@ bool Transports::ConnectToPeer(
              << __func__ << ": could not connect. Removing peer";
   peer.Done();
   m_Peers.erase(ident);
+  SetBacklogged(ident, false);
   return false;
 }
 
+bool Transports::PreferSSU(const Peer& peer) const {
+  auto profile = kovri::core::GetRouterProfile(peer.router->GetIdentHash());
+  bool const has_ntcp = profile->HasHandshakeLatency(false);
+  bool const has_ssu = profile->HasHandshakeLatency(true);
+  bool prefer_ssu = false;  // no history: keep the NTCP-first default
+  if (has_ntcp && has_ssu)
+    prefer_ssu =
+      profile->GetHandshakeLatency(true) < profile->GetHandshakeLatency(false);
+  else if (has_ssu)
+    prefer_ssu = true;
+  // ~10% of dials probe the alternative so a stale estimate (or an
+  // unmeasured transport) cannot pin us to the slower one forever
+  if ((has_ntcp || has_ssu) && !kovri::core::FastRandInRange32(0, 9))
+    prefer_ssu = !prefer_ssu;
+  return prefer_ssu;
+}
+
 bool Transports::ConnectToPeerNTCP(Peer& peer)
 {
   if (!m_NTCPServer)
@@ -377,6 +491,8 @@ bool Transports::ConnectToPeerNTCP(Peer& peer)
   if (!address->host.is_unspecified()) {
     if (!peer.router->UsesIntroducer() && !peer.router->IsUnreachable()) {
       auto s = std::make_shared<NTCPSession>(*m_NTCPServer, peer.router);
+      peer.connect_start = kovri::core::GetMillisecondsSinceEpoch();
+      peer.connecting_ssu = false;
       m_NTCPServer->Connect(address->host, address->port, s);
       return true;
     }
@@ -391,15 +507,18 @@ bool Transports::ConnectToPeerSSU(Peer& peer) {
   LOG(debug) <<
     "Transports: attempting SSU for peer"
     << GetFormattedSessionInfo(peer.router);
+  peer.connect_start = kovri::core::GetMillisecondsSinceEpoch();
+  peer.connecting_ssu = true;
   if (m_SSUServer->GetSession(peer.router))
     return true;
+  peer.connect_start = 0;
   return false;
 }
 
 void Transports::RequestComplete(
     std::shared_ptr<const kovri::core::RouterInfo> router,
     const kovri::core::IdentHash& ident) {
-  m_Service.post(
+  m_Strand.post(
       std::bind(
           &Transports::HandleRequestComplete,
           this,
@@ -421,6 +540,7 @@ void Transports::HandleRequestComplete(
     } else {
       LOG(warning) << "Transports: router not found, failed to send messages";
       m_Peers.erase(it);
+      SetBacklogged(ident, false);
     }
   }
 }
@@ -433,7 +553,7 @@ void Transports::CloseSession(
   LOG(debug)
     << "Transports: closing session for "
     << "[" << router->GetIdentHashAbbreviation() << "]";
-  m_Service.post(
+  m_Strand.post(
       std::bind(
           &Transports::PostCloseSession,
           this,
@@ -468,8 +588,10 @@ void Transports::DetectExternalIP() {
     return;
   }
   context.SetState(RouterState::Testing);
-  // TODO(unassigned): Why 5 times? (make constant)
-  for (int i = 0; i < 5; i++) {
+  // the testers run in parallel: every SessionCreated they trigger votes
+  // on our observed endpoint (see RouterContext::UpdateAddress) and the
+  // first quorum publishes the refreshed RouterInfo
+  for (std::size_t i = 0; i < NUM_PEER_TESTERS; i++) {
     auto router = kovri::core::netdb.GetRandomPeerTestRouter();
     if (router && router->HasSSU()) {
       m_SSUServer->GetSession(router, true);  // peer test
@@ -491,13 +613,28 @@ void Transports::PeerConnected(
     std::shared_ptr<TransportSession> session) {
   auto router = session->GetRemoteRouter();
   LOG(debug) << "Transports:" << GetFormattedSessionInfo(router) << "connecting";
-  m_Service.post([session, this]() {
+  m_Strand.post([session, this]() {
     auto ident = session->GetRemoteIdentity().GetIdentHash();
     auto it = m_Peers.find(ident);
     if (it != m_Peers.end()) {
+      // attribute an outgoing handshake to the dialed transport; an
+      // incoming connection racing our dial leaves the dial pending
+      if (it->second.connect_start) {
+        std::uint64_t const now = kovri::core::GetMillisecondsSinceEpoch();
+        if (now >= it->second.connect_start
+            && now - it->second.connect_start
+               < SESSION_CREATION_TIMEOUT * 1000) {
+          kovri::core::GetRouterProfile(ident)->RecordHandshakeLatency(
+              it->second.connecting_ssu, now - it->second.connect_start);
+          latency_histograms.Record(
+              LatencyHistograms::Handshake, now - it->second.connect_start);
+        }
+        it->second.connect_start = 0;
+      }
       it->second.sessions.push_back(session);
       session->SendI2NPMessages(it->second.delayed_messages);
       it->second.delayed_messages.clear();
+      SetBacklogged(ident, false);
     } else {  // incoming connection
       m_Peers.insert(
           std::make_pair(
@@ -505,27 +642,41 @@ void Transports::PeerConnected(
               Peer{ 0, nullptr, { session },
               kovri::core::GetSecondsSinceEpoch(), {} }));
     }
+    event_bus.Emit(EventBus::PeerConnected, m_Peers.size());
   });
 }
 
 void Transports::PeerDisconnected(
     std::shared_ptr<TransportSession> session) {
   LOG(debug) << "Transports: disconnecting peer";
-  m_Service.post([session, this]() {
+  m_Strand.post([session, this]() {
     auto ident = session->GetRemoteIdentity().GetIdentHash();
     auto it = m_Peers.find(ident);
     if (it != m_Peers.end()) {
       it->second.sessions.remove(session);
       if (it->second.sessions.empty()) {  // TODO(unassigned): why?
-        if (it->second.delayed_messages.size() > 0)
+        if (it->second.delayed_messages.size() > 0) {
           ConnectToPeer(ident, it->second);
-        else
+        } else {
           m_Peers.erase(it);
+          SetBacklogged(ident, false);
+        }
       }
+      event_bus.Emit(EventBus::PeerDisconnected, m_Peers.size());
     }
   });
 }
 
+void Transports::PeerFailed(
+    const kovri::core::IdentHash& ident) {
+  LOG(warning)
+    << "Transports: peer " << ident.ToBase64().substr(0, 8)
+    << " presumed dead, replacing its tunnels";
+  // hand the failure to the tunnel layer right away: tunnels through the
+  // dead peer get rebuilt instead of waiting for test traffic to notice
+  kovri::core::tunnels.HandlePeerFailure(ident);
+}
+
 bool Transports::IsConnected(
     const kovri::core::IdentHash& ident) const {
   LOG(debug) << "Transports: testing if connected";
@@ -538,6 +689,30 @@ bool Transports::IsConnected(
   return false;
 }
 
+bool Transports::IsBacklogged(
+    const kovri::core::IdentHash& ident) const {
+  std::lock_guard<std::mutex> lock(m_BackloggedMutex);
+  return m_Backlogged.count(ident) > 0;
+}
+
+void Transports::SetBacklogged(
+    const kovri::core::IdentHash& ident,
+    bool backlogged) {
+  bool changed;
+  {
+    std::lock_guard<std::mutex> lock(m_BackloggedMutex);
+    changed = backlogged
+        ? m_Backlogged.insert(ident).second
+        : m_Backlogged.erase(ident) > 0;
+  }
+  if (!changed)
+    return;
+  LOG(debug) << "Transports: peer backpressure "
+             << (backlogged ? "raised" : "cleared");
+  if (m_BackpressureHandler)
+    m_BackpressureHandler(ident, backlogged);
+}
+
 void Transports::HandlePeerCleanupTimer(
     const boost::system::error_code& ecode) {
   LOG(debug) << "Transports: handling peer cleanup timer";
@@ -550,6 +725,7 @@ void Transports::HandlePeerCleanupTimer(
           << "Transports: session to peer"
           << GetFormattedSessionInfo(it->second.router)
           << "has not been created in " << SESSION_CREATION_TIMEOUT << " seconds";
+        SetBacklogged(it->first, false);
         it = m_Peers.erase(it);
       } else {
         it++;
@@ -563,10 +739,10 @@ void Transports::HandlePeerCleanupTimer(
         boost::posix_time::seconds(
             5 * SESSION_CREATION_TIMEOUT));
     m_PeerCleanupTimer.async_wait(
-        std::bind(
+        m_Strand.wrap(std::bind(
             &Transports::HandlePeerCleanupTimer,
             this,
-            std::placeholders::_1));
+            std::placeholders::_1)));
   }
 }
 
@@ -578,7 +754,7 @@ std::shared_ptr<const kovri::core::RouterInfo> Transports::GetRandomPeer() const
   auto it = m_Peers.begin();
   std::advance(
       it,
-      kovri::core::RandInRange32(0, s - 1));
+      kovri::core::FastRandInRange32(0, s - 1));
   return it->second.router;
 }
 
@@ -44,6 +44,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -53,50 +54,34 @@
 #include "core/router/info.h"
 #include "core/router/transports/ntcp/server.h"
 #include "core/router/transports/ntcp/session.h"
+#include "core/router/transports/scheduler.h"
 #include "core/router/transports/session.h"
 #include "core/router/transports/ssu/server.h"
 #include "core/router/transports/upnp.h"
 
 #include "core/util/exception.h"
+#include "core/util/metrics.h"
+#include "core/util/precompute_pool.h"
 
 namespace kovri {
 namespace core {
 
 /// @class DHKeysPairSupplier
 /// @brief Pregenerates Diffie-Hellman key pairs for use in key exchange
-/// TODO(unassigned): Does this really need to run on a separate thread?
-class DHKeysPairSupplier {
+/// @notes Thin wrapper over the generic PrecomputePool service
+class DHKeysPairSupplier : public PrecomputePool<DHKeysPair> {
  public:
-  DHKeysPairSupplier(
+  explicit DHKeysPairSupplier(
       std::size_t size);
 
-  ~DHKeysPairSupplier();
-
-  void Start();
-
-  void Stop();
-
-  std::unique_ptr<DHKeysPair> Acquire();
-
-  void Return(
-      std::unique_ptr<DHKeysPair> pair);
-
- private:
-  void Run();
-
-  void CreateDHKeysPairs(
-      std::size_t num);
-
  private:
-  const std::size_t m_QueueSize;
-  bool m_IsRunning;
-  std::queue<std::unique_ptr<DHKeysPair>> m_Queue;
-  std::unique_ptr<std::thread> m_Thread;
-  std::condition_variable m_Acquired;
-  std::mutex m_AcquiredMutex;
   core::Exception m_Exception;
 };
 
+/// @brief Messages parked per peer while a session establishes; beyond
+///   this the class-aware drop policy in Peer::QueueDelayed applies
+const std::size_t DELAYED_MESSAGE_LIMIT = 128;
+
 /// @class Peer
 /// @brief Stores information about transport peers.
 struct Peer {
@@ -105,11 +90,29 @@ struct Peer {
   std::list<std::shared_ptr<TransportSession>> sessions;
   std::uint64_t creation_time{};  ///< Must be set as time since epoch, in implementation
   std::vector<std::shared_ptr<kovri::core::I2NPMessage>> delayed_messages;
+  std::uint64_t connect_start{};  ///< Dial time of the pending outgoing attempt, in ms since epoch
+  bool connecting_ssu{};  ///< Transport of the pending outgoing attempt
+  bool preferred_ssu{};  ///< Transport chosen for the first attempt
 
   void Done();
+
+  /// @brief Parks a message until a session establishes, enforcing the
+  ///   per-peer bound: the oldest bulk (then interactive) message is
+  ///   evicted first and control messages are never dropped
+  /// @return False when the message was shed instead of queued
+  bool QueueDelayed(std::shared_ptr<kovri::core::I2NPMessage> msg);
+
+  /// @return True once the delayed queue has filled to its bound
+  bool IsBacklogged() const {
+    return delayed_messages.size() >= DELAYED_MESSAGE_LIMIT;
+  }
 };
 
 const std::size_t SESSION_CREATION_TIMEOUT = 10;  // in seconds
+
+/// @brief Peer-test sessions launched in parallel after (re)start; sized so
+///   ADDRESS_VOTE_QUORUM observations form a majority of the testers
+const std::size_t NUM_PEER_TESTERS = 5;
 const std::uint32_t LOW_BANDWIDTH_LIMIT = 32 * 1024;  // 32KBps
 
 /// @class Transports
@@ -134,6 +137,20 @@ class Transports : public core::RouterInfoTraits {
     return m_Service;
   }
 
+  /// @return Number of worker threads running the transports io_service
+  std::size_t GetNumWorkers() const {
+    return m_Threads.size();
+  }
+
+  /// @return The io_service backing the dedicated handshake crypto
+  ///   worker. Sessions post their expensive asymmetric work (DH
+  ///   agreements, signature checks) here and resume on their own
+  ///   strand, so a burst of inbound connects queues behind itself
+  ///   instead of stalling the packet-forwarding reactor threads
+  boost::asio::io_service& GetCryptoService() {
+    return m_CryptoService;
+  }
+
   /// @return a pointer to a Diffie-Hellman pair
   std::unique_ptr<kovri::core::DHKeysPair> GetNextDHKeysPair();
 
@@ -169,17 +186,44 @@ class Transports : public core::RouterInfoTraits {
   void PeerDisconnected(
       std::shared_ptr<TransportSession> session);
 
+  /// @brief Declares a peer dead on transport-level evidence (exhausted
+  ///   SSU resends, a stalled NTCP write) rather than an idle timeout
+  /// @param ident the router hash of the unresponsive peer
+  /// @notes Propagates the failure to the tunnel layer so tunnels through
+  ///   the peer are replaced immediately; the failing session tears itself
+  ///   down and PeerDisconnected redials if messages are still queued
+  /// @note May be invoked from a transport worker thread
+  void PeerFailed(
+      const kovri::core::IdentHash& ident);
+
   bool IsConnected(
       const kovri::core::IdentHash& ident) const;
 
+  /// @brief Handler observing per-peer send backpressure; invoked with
+  ///   the peer hash and true when its delayed queue fills, false once
+  ///   it drains or the peer is dropped
+  /// @note May be invoked from a transport worker thread
+  typedef std::function<void (const kovri::core::IdentHash&, bool)>
+      BackpressureHandler;
+
+  void SetBackpressureHandler(BackpressureHandler handler) {
+    m_BackpressureHandler = handler;
+  }
+
+  /// @return True while the peer's delayed queue is full; producers
+  ///   (tunnel gateways, streaming) should pause or shed bulk sends
+  bool IsBacklogged(const kovri::core::IdentHash& ident) const;
+
   void UpdateSentBytes(
       std::uint64_t num_bytes) {
     m_TotalSentBytes += num_bytes;
+    metrics.Inc(Metrics::TransportOutBytes, num_bytes);
   }
 
   void UpdateReceivedBytes(
       std::uint64_t num_bytes) {
     m_TotalReceivedBytes += num_bytes;
+    metrics.Inc(Metrics::TransportInBytes, num_bytes);
   }
 
   std::uint64_t GetTotalSentBytes() const {
@@ -227,6 +271,12 @@ class Transports : public core::RouterInfoTraits {
       kovri::core::IdentHash ident,
       std::vector<std::shared_ptr<kovri::core::I2NPMessage>> msgs);
 
+  /// @brief Hands a batch released by the bandwidth scheduler to the
+  ///   peer's session (or back to its delayed queue if it dropped)
+  void DeliverMessages(
+      const kovri::core::IdentHash& ident,
+      std::vector<std::shared_ptr<kovri::core::I2NPMessage>> msgs);
+
   void PostCloseSession(
       std::shared_ptr<const kovri::core::RouterInfo> router);
 
@@ -236,6 +286,22 @@ class Transports : public core::RouterInfoTraits {
   bool ConnectToPeerNTCP(Peer& peer);
   bool ConnectToPeerSSU(Peer& peer);
 
+  /// @brief Dials our historically most-used peers in parallel right
+  ///   after startup so the first wave of tunnel builds finds warm
+  ///   sessions instead of each paying handshake latency serially; runs
+  ///   on the strand
+  void PrewarmConnections(std::uint16_t count);
+
+  /// @brief Publishes the peer's backpressure state and fires the
+  ///   handler on transitions
+  void SetBacklogged(
+      const kovri::core::IdentHash& ident, bool backlogged);
+
+  /// @brief Picks the transport to dial first for a peer reachable over
+  ///   both NTCP and SSU, from profiled handshake latency
+  /// @return True to dial SSU first
+  bool PreferSSU(const Peer& peer) const;
+
   void HandlePeerCleanupTimer(
       const boost::system::error_code& ecode);
 
@@ -246,16 +312,33 @@ class Transports : public core::RouterInfoTraits {
  private:
   bool m_IsRunning;
 
-  std::unique_ptr<std::thread> m_Thread;
+  std::vector<std::unique_ptr<std::thread>> m_Threads;
   boost::asio::io_service m_Service;
   boost::asio::io_service::work m_Work;
+  /// @brief Serializes peer bookkeeping when the io_service runs on
+  ///   multiple worker threads
+  boost::asio::io_service::strand m_Strand;
   boost::asio::deadline_timer m_PeerCleanupTimer;
 
+  /// @brief Single-thread io_service for handshake asymmetric crypto
+  ///   (see GetCryptoService)
+  boost::asio::io_service m_CryptoService;
+  std::unique_ptr<boost::asio::io_service::work> m_CryptoWork;
+  std::unique_ptr<std::thread> m_CryptoThread;
+
   std::unique_ptr<NTCPServer> m_NTCPServer;
   std::unique_ptr<SSUServer> m_SSUServer;
 
   std::map<kovri::core::IdentHash, Peer> m_Peers;
 
+  BackpressureHandler m_BackpressureHandler;
+  /// @brief Peers whose delayed queues are full; kept outside m_Peers so
+  ///   producers on other threads can poll without touching the strand
+  mutable std::mutex m_BackloggedMutex;
+  std::set<kovri::core::IdentHash> m_Backlogged;
+
+  BandwidthScheduler m_Scheduler;
+
   DHKeysPairSupplier m_DHKeysPairSupplier;
 
   std::atomic<uint64_t> m_TotalSentBytes, m_TotalReceivedBytes;
@@ -0,0 +1,150 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/router/transports/message_trace.h"
+
+#include <array>
+#include <cstring>
+
+#include "core/util/byte_stream.h"
+#include "core/util/log.h"
+#include "core/util/timestamp.h"
+
+namespace kovri {
+namespace core {
+
+MessageTrace message_trace;
+
+MessageTrace::MessageTrace()
+    : m_IsEnabled(false),
+      m_Exception(__func__) {}
+
+bool MessageTrace::Start(const std::string& path) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (m_IsEnabled) {
+    LOG(warning) << "MessageTrace: capture already running";
+    return false;
+  }
+  m_File.open(path, std::ofstream::binary | std::ofstream::trunc);
+  if (!m_File.is_open()) {
+    LOG(error) << "MessageTrace: can't open trace file " << path;
+    return false;
+  }
+  m_File.write(
+      reinterpret_cast<const char*>(MESSAGE_TRACE_MAGIC),
+      sizeof(MESSAGE_TRACE_MAGIC));
+  m_PeerNumbers.clear();
+  m_IsEnabled = true;
+  LOG(info) << "MessageTrace: capturing transport frames to " << path;
+  return true;
+}
+
+void MessageTrace::Stop() {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (!m_IsEnabled)
+    return;
+  m_IsEnabled = false;
+  m_File.close();
+  LOG(info)
+    << "MessageTrace: capture stopped, " << m_PeerNumbers.size() << " peers";
+}
+
+void MessageTrace::Record(
+    Direction direction,
+    const IdentHash& ident,
+    const I2NPMessage& msg) {
+  try {
+    std::array<std::uint8_t, MESSAGE_TRACE_RECORD_HEADER_SIZE> header;
+    std::unique_lock<std::mutex> l(m_Mutex);
+    if (!m_IsEnabled)  // lost the race against Stop()
+      return;
+    // first-seen order assigns the anonymized peer number
+    auto it = m_PeerNumbers.find(ident);
+    if (it == m_PeerNumbers.end())
+      it = m_PeerNumbers.emplace(
+          ident, static_cast<std::uint32_t>(m_PeerNumbers.size() + 1)).first;
+    core::OutputByteStream::Write<std::uint64_t>(
+        header.data(), core::GetMillisecondsSinceEpoch());
+    core::OutputByteStream::Write<std::uint32_t>(header.data() + 8, it->second);
+    header[12] = direction;
+    core::OutputByteStream::Write<std::uint32_t>(
+        header.data() + 13, static_cast<std::uint32_t>(msg.GetLength()));
+    m_File.write(reinterpret_cast<const char*>(header.data()), header.size());
+    m_File.write(
+        reinterpret_cast<const char*>(msg.GetBuffer()), msg.GetLength());
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+  }
+}
+
+MessageTraceReader::MessageTraceReader(const std::string& path)
+    : m_File(path, std::ifstream::binary),
+      m_IsOpen(false) {
+  std::array<std::uint8_t, sizeof(MESSAGE_TRACE_MAGIC)> magic;
+  if (!m_File.is_open()) {
+    LOG(error) << "MessageTraceReader: can't open trace file " << path;
+    return;
+  }
+  m_File.read(reinterpret_cast<char*>(magic.data()), magic.size());
+  if (!m_File.good() ||
+      std::memcmp(magic.data(), MESSAGE_TRACE_MAGIC, magic.size())) {
+    LOG(error) << "MessageTraceReader: " << path << " is not a message trace";
+    return;
+  }
+  m_IsOpen = true;
+}
+
+bool MessageTraceReader::Read(MessageTraceRecord& record) {
+  if (!m_IsOpen)
+    return false;
+  std::array<std::uint8_t, MESSAGE_TRACE_RECORD_HEADER_SIZE> header;
+  m_File.read(reinterpret_cast<char*>(header.data()), header.size());
+  if (m_File.gcount() != static_cast<std::streamsize>(header.size()))
+    return false;  // clean end of trace
+  record.timestamp = core::InputByteStream::Read<std::uint64_t>(header.data());
+  record.peer = core::InputByteStream::Read<std::uint32_t>(header.data() + 8);
+  record.direction = header[12];
+  std::uint32_t const len =
+      core::InputByteStream::Read<std::uint32_t>(header.data() + 13);
+  if (!len || len > I2NP_MAX_MESSAGE_SIZE) {
+    LOG(error) << "MessageTraceReader: corrupt record length " << len;
+    return false;
+  }
+  record.frame.resize(len);
+  m_File.read(reinterpret_cast<char*>(record.frame.data()), len);
+  if (m_File.gcount() != static_cast<std::streamsize>(len)) {
+    LOG(error) << "MessageTraceReader: truncated record";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,134 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_ROUTER_TRANSPORTS_MESSAGE_TRACE_H_
+#define SRC_CORE_ROUTER_TRANSPORTS_MESSAGE_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/router/i2np.h"
+#include "core/router/identity.h"
+
+#include "core/util/exception.h"
+
+namespace kovri {
+namespace core {
+
+/// @brief Leading bytes identifying a message trace file (includes the
+///   format version)
+const std::uint8_t MESSAGE_TRACE_MAGIC[4] = { 'K', 'M', 'T', '1' };
+
+/// @brief Fixed part of one trace record: timestamp (8), peer number (4),
+///   direction (1) and frame length (4), all big-endian
+const std::size_t MESSAGE_TRACE_RECORD_HEADER_SIZE = 17;
+
+/// @brief One captured frame as read back from a trace file
+struct MessageTraceRecord {
+  std::uint64_t timestamp;  ///< Milliseconds since epoch at capture
+  std::uint32_t peer;  ///< Anonymized peer number, stable within one trace
+  std::uint8_t direction;  ///< See MessageTrace::Direction
+  std::vector<std::uint8_t> frame;  ///< Complete I2NP message
+};
+
+/// @class MessageTrace
+/// @brief Captures timestamped I2NP frames crossing the transports
+///   boundary into a compact binary trace for offline replay
+/// @details Peer idents are replaced by sequential numbers at capture
+///   time, so a trace carries message sizes, types and timing - enough to
+///   reproduce a production message mix on a bench box - but no linkable
+///   router identities
+class MessageTrace {
+ public:
+  enum Direction : std::uint8_t { Inbound = 0, Outbound = 1 };
+
+  MessageTrace();
+
+  /// @brief Opens the trace file and begins recording
+  /// @return False when the file could not be opened
+  bool Start(const std::string& path);
+
+  /// @brief Flushes and closes the trace file
+  void Stop();
+
+  /// @return True while a capture is running; callers gate Record on
+  ///   this so the disabled path costs one relaxed atomic load
+  bool IsEnabled() const {
+    return m_IsEnabled.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Appends one frame to the trace
+  /// @note Callable from any transport thread
+  void Record(
+      Direction direction,
+      const IdentHash& ident,
+      const I2NPMessage& msg);
+
+ private:
+  std::atomic<bool> m_IsEnabled;
+  std::mutex m_Mutex;
+  std::ofstream m_File;
+  /// @brief Capture-scoped anonymization: first-seen order assigns the
+  ///   peer numbers written to disk
+  std::map<IdentHash, std::uint32_t> m_PeerNumbers;
+  core::Exception m_Exception;
+};
+
+extern MessageTrace message_trace;
+
+/// @class MessageTraceReader
+/// @brief Sequential reader over a capture written by MessageTrace
+class MessageTraceReader {
+ public:
+  explicit MessageTraceReader(const std::string& path);
+
+  /// @return True when the file opened and carried a valid header
+  bool IsOpen() const {
+    return m_IsOpen;
+  }
+
+  /// @brief Reads the next record
+  /// @return False at end of trace or on a truncated record
+  bool Read(MessageTraceRecord& record);
+
+ private:
+  std::ifstream m_File;
+  bool m_IsOpen;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_TRANSPORTS_MESSAGE_TRACE_H_
@@ -32,6 +32,8 @@
 
 #include "core/router/transports/ntcp/server.h"
 
+#include <algorithm>
+
 #include "core/router/context.h"
 #include "core/router/net_db/impl.h"
 #include "core/router/transports/impl.h"
@@ -42,15 +44,22 @@
 namespace kovri {
 namespace core {
 
+namespace {
+#if defined(SO_REUSEPORT)
+/// @brief Lets several listeners bind the same port; the kernel then
+///   load-balances inbound connections across them
+typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>
+    ReusePort;
+#endif
+}  // namespace
+
 NTCPServer::NTCPServer(
     boost::asio::io_service& service,
     std::size_t port)
     : m_IsRunning(false),
       m_Service(service),
       m_NTCPEndpoint(boost::asio::ip::tcp::v4(), port),
-      m_NTCPEndpointV6(boost::asio::ip::tcp::v6(), port),
-      m_NTCPAcceptor(nullptr),
-      m_NTCPV6Acceptor(nullptr) {}
+      m_NTCPEndpointV6(boost::asio::ip::tcp::v6(), port) {}
 
 NTCPServer::~NTCPServer() {}
 
@@ -58,40 +67,94 @@ void NTCPServer::Start() {
   if (!m_IsRunning) {
     LOG(debug) << "NTCPServer: starting";
     m_IsRunning = true;
-    // Create acceptors
-    m_NTCPAcceptor =
-      std::make_unique<boost::asio::ip::tcp::acceptor>(
-          m_Service,
-          m_NTCPEndpoint);
-    auto conn = std::make_shared<NTCPSession>(*this);
-    m_NTCPAcceptor->async_accept(
-        conn->GetSocket(),
-        std::bind(
-            &NTCPServer::HandleAccept,
-            this,
-            conn,
-            std::placeholders::_1));
-    // If IPv6 is enabled, create IPv6 acceptor
-    if (context.SupportsV6()) {
-      m_NTCPV6Acceptor =
+    // One accept loop per transport worker where the kernel can
+    // load-balance listeners; a slow handshake then only stalls its own
+    // loop instead of all accepts
+    std::size_t num_acceptors = 1;
+#if defined(SO_REUSEPORT)
+    num_acceptors = std::max<std::size_t>(1, transports.GetNumWorkers());
+#endif
+    LOG(debug) << "NTCPServer: " << num_acceptors << " acceptor(s)";
+    for (std::size_t i = 0; i < num_acceptors; i++) {
+      auto acceptor =
         std::make_unique<boost::asio::ip::tcp::acceptor>(m_Service);
-      m_NTCPV6Acceptor->open(boost::asio::ip::tcp::v6());
-      m_NTCPV6Acceptor->set_option(boost::asio::ip::v6_only(true));
-      m_NTCPV6Acceptor->bind(m_NTCPEndpointV6);
-      m_NTCPV6Acceptor->listen();
-      auto conn = std::make_shared<NTCPSession>(*this);
-      m_NTCPV6Acceptor->async_accept(
-          conn->GetSocket(),
-          std::bind(
-              &NTCPServer::HandleAcceptV6,
-              this,
-              conn,
-              std::placeholders::_1));
+      acceptor->open(boost::asio::ip::tcp::v4());
+      acceptor->set_option(
+          boost::asio::ip::tcp::acceptor::reuse_address(true));
+#if defined(SO_REUSEPORT)
+      if (num_acceptors > 1)
+        acceptor->set_option(ReusePort(true));
+#endif
+      acceptor->bind(m_NTCPEndpoint);
+      acceptor->listen();
+      m_NTCPAcceptors.push_back(std::move(acceptor));
+      Accept(*m_NTCPAcceptors.back());
     }
+    // If IPv6 is enabled, create IPv6 acceptors
+    if (context.SupportsV6()) {
+      for (std::size_t i = 0; i < num_acceptors; i++) {
+        auto acceptor =
+          std::make_unique<boost::asio::ip::tcp::acceptor>(m_Service);
+        acceptor->open(boost::asio::ip::tcp::v6());
+        acceptor->set_option(boost::asio::ip::v6_only(true));
+#if defined(SO_REUSEPORT)
+        if (num_acceptors > 1)
+          acceptor->set_option(ReusePort(true));
+#endif
+        acceptor->bind(m_NTCPEndpointV6);
+        acceptor->listen();
+        m_NTCPV6Acceptors.push_back(std::move(acceptor));
+        AcceptV6(*m_NTCPV6Acceptors.back());
+      }
+    }
+  }
+}
+
+void NTCPServer::Accept(
+    boost::asio::ip::tcp::acceptor& acceptor) {
+  auto conn = std::make_shared<NTCPSession>(*this);
+  acceptor.async_accept(
+      conn->GetSocket(),
+      std::bind(
+          &NTCPServer::HandleAccept,
+          this,
+          std::ref(acceptor),
+          conn,
+          std::placeholders::_1));
+}
+
+void NTCPServer::AcceptV6(
+    boost::asio::ip::tcp::acceptor& acceptor) {
+  auto conn = std::make_shared<NTCPSession>(*this);
+  acceptor.async_accept(
+      conn->GetSocket(),
+      std::bind(
+          &NTCPServer::HandleAcceptV6,
+          this,
+          std::ref(acceptor),
+          conn,
+          std::placeholders::_1));
+}
+
+bool NTCPServer::IsBanned(
+    const boost::asio::ip::address& address) {
+  std::unique_lock<std::mutex> l(m_BanListMutex);
+  auto it = m_BanList.find(address);
+  if (it == m_BanList.end())
+    return false;
+  std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
+  if (ts < it->second) {
+    LOG(debug)
+      << "NTCPServer: " << address << " is banned for "
+      << it->second - ts << " more seconds";
+    return true;
   }
+  m_BanList.erase(it);
+  return false;
 }
 
 void NTCPServer::HandleAccept(
+    boost::asio::ip::tcp::acceptor& acceptor,
     std::shared_ptr<NTCPSession> conn,
     const boost::system::error_code& ecode) {
   if (!ecode) {
@@ -100,18 +163,8 @@ void NTCPServer::HandleAccept(
     auto ep = conn->GetSocket().remote_endpoint(ec);
     if (!ec) {
       LOG(debug) << "NTCPServer: connected from " << ep;
-      auto it = m_BanList.find(ep.address());
-      if (it != m_BanList.end()) {
-        std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-        if (ts < it->second) {
-          LOG(debug)
-            << "NTCPServer: " << ep.address() << " is banned for "
-            << it->second - ts << " more seconds";
-          conn = nullptr;
-        } else {
-          m_BanList.erase(it);
-        }
-      }
+      if (IsBanned(ep.address()))
+        conn = nullptr;
       if (conn)
         conn->ServerLogin();
     } else {
@@ -123,19 +176,12 @@ void NTCPServer::HandleAccept(
         LOG(error) << "NTCPServer: " << __func__ << ": '" << ecode.message()
                    << "'";
   }
-  if (ecode != boost::asio::error::operation_aborted) {
-    conn = std::make_shared<NTCPSession>(*this);
-    m_NTCPAcceptor->async_accept(
-        conn->GetSocket(),
-        std::bind(
-            &NTCPServer::HandleAccept,
-            this,
-            conn,
-            std::placeholders::_1));
-  }
+  if (ecode != boost::asio::error::operation_aborted)
+    Accept(acceptor);
 }
 
 void NTCPServer::HandleAcceptV6(
+    boost::asio::ip::tcp::acceptor& acceptor,
     std::shared_ptr<NTCPSession> conn,
     const boost::system::error_code& ecode) {
   if (!ecode) {
@@ -144,18 +190,8 @@ void NTCPServer::HandleAcceptV6(
     auto ep = conn->GetSocket().remote_endpoint(ec);
     if (!ec) {
       LOG(debug) << "NTCPServer: V6 connected from " << ep;
-      auto it = m_BanList.find(ep.address());
-      if (it != m_BanList.end()) {
-        std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-        if (ts < it->second) {
-          LOG(debug)
-            << "NTCPServer: " << ep.address() << " is banned for "
-            << it->second - ts << " more seconds";
-          conn = nullptr;
-        } else {
-          m_BanList.erase(it);
-        }
-      }
+      if (IsBanned(ep.address()))
+        conn = nullptr;
       if (conn)
         conn->ServerLogin();
     } else {
@@ -167,16 +203,8 @@ void NTCPServer::HandleAcceptV6(
         LOG(error) << "NTCPServer: " << __func__ << ": '" << ecode.message()
                    << "'";
   }
-  if (ecode != boost::asio::error::operation_aborted) {
-    conn = std::make_shared<NTCPSession>(*this);
-    m_NTCPV6Acceptor->async_accept(
-        conn->GetSocket(),
-        std::bind(
-            &NTCPServer::HandleAcceptV6,
-            this,
-            conn,
-            std::placeholders::_1));
-  }
+  if (ecode != boost::asio::error::operation_aborted)
+    AcceptV6(acceptor);
 }
 
 void NTCPServer::Connect(
@@ -258,8 +286,11 @@ std::shared_ptr<NTCPSession> NTCPServer::FindNTCPSession(
 void NTCPServer::Ban(
     const std::shared_ptr<NTCPSession>& session) {
   std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-  m_BanList[session->GetRemoteEndpoint().address()] =
-    ts + GetType(NTCPTimeoutLength::BanExpiration);
+  {
+    std::unique_lock<std::mutex> l(m_BanListMutex);
+    m_BanList[session->GetRemoteEndpoint().address()] =
+      ts + GetType(NTCPTimeoutLength::BanExpiration);
+  }
   LOG(warning)
     << "NTCPServer:" << session->GetFormattedSessionInfo() << "has been banned for "
     << GetType(NTCPTimeoutLength::BanExpiration) << " seconds";
@@ -270,8 +301,8 @@ void NTCPServer::Stop() {
   m_NTCPSessions.clear();
   if (m_IsRunning) {
     m_IsRunning = false;
-    m_NTCPAcceptor.reset(nullptr);
-    m_NTCPV6Acceptor.reset(nullptr);
+    m_NTCPAcceptors.clear();
+    m_NTCPV6Acceptors.clear();
   }
 }
 
@@ -85,14 +85,30 @@ class NTCPServer {
       const std::shared_ptr<NTCPSession>& session);
 
  private:
+  /// @brief Arms one accept on the given acceptor; each acceptor keeps
+  ///   its own accept loop so the kernel spreads inbound connections
+  ///   (and their handshakes) across the transport workers
+  void Accept(
+      boost::asio::ip::tcp::acceptor& acceptor);
+
+  void AcceptV6(
+      boost::asio::ip::tcp::acceptor& acceptor);
+
   void HandleAccept(
+      boost::asio::ip::tcp::acceptor& acceptor,
       std::shared_ptr<NTCPSession> conn,
       const boost::system::error_code& ecode);
 
   void HandleAcceptV6(
+      boost::asio::ip::tcp::acceptor& acceptor,
       std::shared_ptr<NTCPSession> conn,
       const boost::system::error_code& ecode);
 
+  /// @return True when the accepted connection's address is currently
+  ///   banned (conn should then be dropped)
+  bool IsBanned(
+      const boost::asio::ip::address& address);
+
   void HandleConnect(
       std::shared_ptr<NTCPSession> conn,
       const boost::system::error_code& ecode);
@@ -103,11 +119,16 @@ class NTCPServer {
   boost::asio::io_service& m_Service;
 
   boost::asio::ip::tcp::endpoint m_NTCPEndpoint, m_NTCPEndpointV6;
-  std::unique_ptr<boost::asio::ip::tcp::acceptor> m_NTCPAcceptor, m_NTCPV6Acceptor;
+  /// @brief One listener per transport worker where SO_REUSEPORT is
+  ///   available, a single listener otherwise
+  std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>>
+      m_NTCPAcceptors, m_NTCPV6Acceptors;
 
   std::mutex m_NTCPSessionsMutex;
   std::map<kovri::core::IdentHash, std::shared_ptr<NTCPSession>> m_NTCPSessions;
 
+  /// @brief Serializes ban list access across concurrent accept loops
+  std::mutex m_BanListMutex;
   // IP -> ban expiration time in seconds
   std::map<boost::asio::ip::address, std::uint32_t> m_BanList;
 
@@ -35,6 +35,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
 #include <vector>
 #include <boost/endian/conversion.hpp>
 
@@ -45,12 +48,16 @@
 
 #include "core/router/context.h"
 #include "core/router/net_db/impl.h"
+#include "core/router/profiling.h"
 #include "core/router/transports/ntcp/server.h"
 #include "core/router/transports/impl.h"
+#include "core/router/transports/message_trace.h"
 
 #include "core/util/byte_stream.h"
 #include "core/util/log.h"
+#include "core/util/metrics.h"
 #include "core/util/timestamp.h"
+#include "core/util/trace.h"
 
 namespace kovri {
 namespace core {
@@ -61,6 +68,7 @@ NTCPSession::NTCPSession(
     : TransportSession(remote_router),
       m_Server(server),
       m_Socket(m_Server.GetService()),
+      m_Strand(m_Server.GetService()),
       m_TerminationTimer(m_Server.GetService()),
       m_IsEstablished(false),
       m_IsTerminated(false),
@@ -107,6 +115,22 @@ void NTCPSession::StartClientSession()
     }
 }
 
+/**
+ * Reconnects always pay the full 4-phase handshake (2 RTTs plus a DH
+ * agreement per side), even to peers we spoke to seconds ago. A
+ * session-ticket style resumption (cache established key material per
+ * ident for a short window, re-authenticate with an HMAC exchange) was
+ * considered, but NTCP has no extension or negotiation field in any
+ * phase, so a resumption path cannot be offered without breaking
+ * interop with peers that don't implement it. NTCP2 defines exactly
+ * this; revisit when that transport lands. The parts of the handshake
+ * that are reusable without protocol changes are already cached: our
+ * ephemeral DH keypairs come from the precompute pool and remote
+ * signature verifiers from the verifier cache.
+ *
+ * TODO(unassigned): revisit with NTCP2
+ */
+
 // Phase1: SessionRequest
 
 void NTCPSession::SendPhase1()
@@ -149,11 +173,11 @@ void NTCPSession::SendPhase1()
       boost::asio::buffer(
           &m_Establisher->phase1, sizeof(m_Establisher->phase1)),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase1Sent,
           shared_from_this(),
           std::placeholders::_1,
-          std::placeholders::_2));
+          std::placeholders::_2)));
 
   ScheduleTermination();
 }
@@ -178,11 +202,11 @@ void NTCPSession::HandlePhase1Sent(
           &m_Establisher->phase2,
           sizeof(m_Establisher->phase2)),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase2Received,
           shared_from_this(),
           std::placeholders::_1,
-          std::placeholders::_2));
+          std::placeholders::_2)));
 }
 
 // Phase2: SessionCreated
@@ -212,13 +236,26 @@ void NTCPSession::HandlePhase2Received(
   LOG(trace)
     << "NTCPSession:" << GetFormattedSessionInfo()
     << "Encrypted " << GetFormattedPhaseInfo(Phase::Two);
-  // TODO(anonimal): this try block should be larger or handled entirely by caller
+  // The DH agreement and our Phase3 signature dominate establishment
+  // cost: run them on the handshake crypto worker so a connect storm
+  // cannot stall forwarding for established sessions
+  transports.GetCryptoService().post(
+      std::bind(
+          &NTCPSession::ProcessPhase2,
+          shared_from_this()));
+}
+
+void NTCPSession::ProcessPhase2() {
   try {
     kovri::core::AESKey aes_key;
-    CreateAESKey(m_Establisher->phase2.pub_key.data(), aes_key);
-    m_Decryption.SetKey(aes_key);
+    if (!CreateAESKey(m_Establisher->phase2.pub_key.data(), aes_key)) {
+      m_DHKeysPair.reset(nullptr);
+      Done();
+      return;
+    }
+    m_Decryption.Rekey(aes_key);
     m_Decryption.SetIV(m_Establisher->phase2.pub_key.data() + NTCPSize::Phase2BobIVOffset);
-    m_Encryption.SetKey(aes_key);
+    m_Encryption.Rekey(aes_key);
     m_Encryption.SetIV(m_Establisher->phase1.HXxorHI.data() + NTCPSize::IV);
     m_Decryption.Decrypt(
         reinterpret_cast<std::uint8_t *>(&m_Establisher->phase2.encrypted),
@@ -245,13 +282,14 @@ void NTCPSession::HandlePhase2Received(
         << "NTCPSession:" << GetFormattedSessionInfo()
         << "Decrypted " << GetFormattedPhaseInfo(Phase::Two);
       m_DHKeysPair.reset(nullptr);
-      Terminate();
+      Done();
       return;
     }
   } catch (...) {
+    // no caller to rethrow to on the crypto worker: dispatch and tear down
     m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
+    Done();
+    return;
   }
   LOG(trace)
     << "NTCPSession:" << GetFormattedSessionInfo()
@@ -259,10 +297,10 @@ void NTCPSession::HandlePhase2Received(
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo()
     << "*** Phase2 successful, proceeding to Phase3";
-  SendPhase3();
+  SendPhase3();  // still on the worker: Phase3 signing happens there
 }
 
-void NTCPSession::CreateAESKey(
+bool NTCPSession::CreateAESKey(
     std::uint8_t* pub_key,
     kovri::core::AESKey& key) {
   LOG(debug)
@@ -275,8 +313,7 @@ void NTCPSession::CreateAESKey(
       LOG(error)
         << "NTCPSession:" << GetFormattedSessionInfo()
         << "!!! couldn't create shared key";
-      Terminate();
-      return;
+      return false;
     }
     std::uint8_t* aes_key = key;
     if (shared_key.at(0) & 0x80) {
@@ -299,7 +336,7 @@ void NTCPSession::CreateAESKey(
           LOG(warning) <<
               "NTCPSession:" << GetFormattedSessionInfo()
               << "*** first 32 bytes of shared key is all zeros. Ignored";
-          return;
+          return false;
         }
       }
       memcpy(aes_key, non_zero, NTCPSize::SessionKey);
@@ -309,6 +346,7 @@ void NTCPSession::CreateAESKey(
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
     throw;
   }
+  return true;
 }
 
 // Phase3: SessionConfirm A
@@ -347,10 +385,25 @@ void NTCPSession::SendPhase3() {
   try {
     m_Encryption.Encrypt(m_ReceiveBuffer, len, m_ReceiveBuffer);
   } catch (...) {
+    // runs on the crypto worker: dispatch and tear down, nobody rethrows
     m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
+    Done();
+    return;
   }
+  // back to the strand for the write so socket use stays serialized
+  m_Strand.post(
+      std::bind(
+          &NTCPSession::WritePhase3,
+          shared_from_this(),
+          len,
+          ts_A));
+}
+
+void NTCPSession::WritePhase3(
+    std::size_t len,
+    std::uint32_t ts_A) {
+  if (m_IsTerminated)
+    return;
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo() << "<-- Phase3, sending";
   boost::asio::async_write(
@@ -359,12 +412,12 @@ void NTCPSession::SendPhase3() {
           m_ReceiveBuffer,
           len),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase3Sent,
           shared_from_this(),
           std::placeholders::_1,
           std::placeholders::_2,
-          ts_A));
+          ts_A)));
 }
 
 void NTCPSession::HandlePhase3Sent(
@@ -392,12 +445,12 @@ void NTCPSession::HandlePhase3Sent(
           m_ReceiveBuffer,
           signature_len),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase4Received,
           shared_from_this(),
           std::placeholders::_1,
           std::placeholders::_2,
-          ts_A));
+          ts_A)));
 }
 
 // Phase4: SessionConfirm B
@@ -419,13 +472,25 @@ void NTCPSession::HandlePhase4Received(
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo()
     << "*** Phase4 received << processing " << bytes_transferred << " bytes";
-  // TODO(anonimal): this try block should be larger or handled entirely by caller
+  // signature verification can be expensive (DSA peers): crypto worker
+  transports.GetCryptoService().post(
+      std::bind(
+          &NTCPSession::ProcessPhase4,
+          shared_from_this(),
+          bytes_transferred,
+          ts_A));
+}
+
+void NTCPSession::ProcessPhase4(
+    std::size_t bytes_transferred,
+    std::uint32_t ts_A) {
   try {
     m_Decryption.Decrypt(m_ReceiveBuffer, bytes_transferred, m_ReceiveBuffer);
   } catch (...) {
+    // no caller to rethrow to on the crypto worker: dispatch and tear down
     m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
+    Done();
+    return;
   }
   // Verify signature
   SignedData s;
@@ -438,13 +503,22 @@ void NTCPSession::HandlePhase4Received(
     LOG(warning)
       << "NTCPSession:" << GetFormattedSessionInfo()
       << "!!! Phase4 signature verification failed";
-    Terminate();
+    Done();
     return;
   }
   m_RemoteIdentity.DropVerifier();
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo()
     << "*** Phase4, session connected";
+  m_Strand.post(
+      std::bind(
+          &NTCPSession::FinishClientHandshake,
+          shared_from_this()));
+}
+
+void NTCPSession::FinishClientHandshake() {
+  if (m_IsTerminated)
+    return;
   Connected();
   m_ReceiveBufferOffset = 0;
   m_NextMessage = nullptr;
@@ -479,11 +553,11 @@ void NTCPSession::ServerLogin() {
           &m_Establisher->phase1,
           sizeof(m_Establisher->phase1)),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase1Received,
           shared_from_this(),
           std::placeholders::_1,
-          std::placeholders::_2));
+          std::placeholders::_2)));
   ScheduleTermination();
 }
 
@@ -547,6 +621,12 @@ void NTCPSession::SendPhase2() {
       << "*** Phase2, acquiring DH keys pair";
     m_DHKeysPair = transports.GetNextDHKeysPair();
   }
+  // the DH agreement inside CreateAESKey is the expensive part: crypto worker
+  transports.GetCryptoService().post(
+      std::bind(&NTCPSession::CreatePhase2, shared_from_this()));
+}
+
+void NTCPSession::CreatePhase2() {
   // Y from Diffie Hellman
   const std::uint8_t* y = m_DHKeysPair->public_key.data();
   memcpy(
@@ -581,20 +661,33 @@ void NTCPSession::SendPhase2() {
         NTCPSize::Padding);
     // AES key
     kovri::core::AESKey aes_key;
-    CreateAESKey(m_Establisher->phase1.pub_key.data(), aes_key);
-    m_Encryption.SetKey(aes_key);
+    if (!CreateAESKey(m_Establisher->phase1.pub_key.data(), aes_key)) {
+      Done();
+      return;
+    }
+    m_Encryption.Rekey(aes_key);
     m_Encryption.SetIV(y + NTCPSize::Phase2BobIVOffset);
-    m_Decryption.SetKey(aes_key);
+    m_Decryption.Rekey(aes_key);
     m_Decryption.SetIV(m_Establisher->phase1.HXxorHI.data() + NTCPSize::IV);
     m_Encryption.Encrypt(
         reinterpret_cast<std::uint8_t *>(&m_Establisher->phase2.encrypted),
         sizeof(m_Establisher->phase2.encrypted),
         reinterpret_cast<std::uint8_t *>(&m_Establisher->phase2.encrypted));
   } catch (...) {
+    // no caller to rethrow to on the crypto worker: dispatch and tear down
     m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
+    Done();
+    return;
   }
+  // back to the strand for the write so socket use stays serialized
+  m_Strand.post(
+      std::bind(&NTCPSession::WritePhase2, shared_from_this(), ts_B));
+}
+
+void NTCPSession::WritePhase2(
+    std::uint32_t ts_B) {
+  if (m_IsTerminated)
+    return;
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo() << "<-- Phase2, sending";
   boost::asio::async_write(
@@ -603,12 +696,12 @@ void NTCPSession::SendPhase2() {
           &m_Establisher->phase2,
           sizeof(m_Establisher->phase2)),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase2Sent,
           shared_from_this(),
           std::placeholders::_1,
           std::placeholders::_2,
-          ts_B));
+          ts_B)));
 }
 
 void NTCPSession::HandlePhase2Sent(
@@ -632,12 +725,12 @@ void NTCPSession::HandlePhase2Sent(
           m_ReceiveBuffer,
           NTCPSize::Phase3Unencrypted),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase3Received,
           shared_from_this(),
           std::placeholders::_1,
           std::placeholders::_2,
-          ts_B));
+          ts_B)));
 }
 
 // Phase3: SessionConfirm A
@@ -693,15 +786,21 @@ void NTCPSession::HandlePhase3Received(
             m_ReceiveBuffer + NTCPSize::Phase3Unencrypted,
             expected_size),
         boost::asio::transfer_all(),
-        std::bind(
+        m_Strand.wrap(std::bind(
             &NTCPSession::HandlePhase3ExtraReceived,
             shared_from_this(),
             std::placeholders::_1,
             std::placeholders::_2,
             ts_B,
-            padding_len));
+            padding_len)));
   } else {
-    HandlePhase3(ts_B, padding_len);
+    // signature verification and our Phase4 signature: crypto worker
+    transports.GetCryptoService().post(
+        std::bind(
+            &NTCPSession::HandlePhase3,
+            shared_from_this(),
+            ts_B,
+            padding_len));
   }
 }
 
@@ -729,7 +828,12 @@ void NTCPSession::HandlePhase3ExtraReceived(
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
     throw;
   }
-  HandlePhase3(ts_B, padding_len);
+  transports.GetCryptoService().post(
+      std::bind(
+          &NTCPSession::HandlePhase3,
+          shared_from_this(),
+          ts_B,
+          padding_len));
 }
 
 void NTCPSession::HandlePhase3(
@@ -753,7 +857,7 @@ void NTCPSession::HandlePhase3(
     LOG(warning)
       << "NTCPSession:" << GetFormattedSessionInfo()
       << "!!! Phase3, signature verification failed";
-    Terminate();
+    Done();
     return;
   }
   m_RemoteIdentity.DropVerifier();
@@ -782,14 +886,22 @@ void NTCPSession::SendPhase4(
   std::size_t padding_size = signature_len & 0x0F;  // %16
   if (padding_size)
     signature_len += (NTCPSize::IV - padding_size);
-  // TODO(anonimal): this try block should be larger or handled entirely by caller
   try {
     m_Encryption.Encrypt(m_ReceiveBuffer, signature_len, m_ReceiveBuffer);
   } catch (...) {
+    // runs on the crypto worker: dispatch and tear down, nobody catches here
     m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
+    Done();
+    return;
   }
+  m_Strand.post(
+      std::bind(&NTCPSession::WritePhase4, shared_from_this(), signature_len));
+}
+
+void NTCPSession::WritePhase4(
+    std::size_t signature_len) {
+  if (m_IsTerminated)
+    return;
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo() << "<-- Phase4, sending";
   boost::asio::async_write(
@@ -798,11 +910,11 @@ void NTCPSession::SendPhase4(
           m_ReceiveBuffer,
           signature_len),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandlePhase4Sent,
           shared_from_this(),
           std::placeholders::_1,
-          std::placeholders::_2));
+          std::placeholders::_2)));
 }
 
 void NTCPSession::HandlePhase4Sent(
@@ -842,7 +954,7 @@ void NTCPSession::Connected() {
   m_DHKeysPair.reset(nullptr);
   SendTimeSyncMessage();
   // We tell immediately who we are
-  m_SendQueue.push_back(CreateDatabaseStoreMsg());
+  QueueI2NPMessage(CreateDatabaseStoreMsg());
   transports.PeerConnected(shared_from_this());
 }
 
@@ -859,22 +971,23 @@ void NTCPSession::SendPayload(
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo() << "<-- sending I2NP message";
   m_IsSending = true;
+  ScheduleLivenessProbe();
   boost::asio::async_write(
       m_Socket,
       CreateMsgBuffer(msg),
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandleSentPayload,
           shared_from_this(),
           std::placeholders::_1,
           std::placeholders::_2,
-          std::vector<std::shared_ptr<I2NPMessage> >{ msg }));
+          std::vector<std::shared_ptr<I2NPMessage> >{ msg })));
 }
 
 void NTCPSession::HandleSentPayload(
     const boost::system::error_code& ecode,
     std::size_t bytes_transferred,
-    std::vector<std::shared_ptr<I2NPMessage>> /*msgs*/) {
+    std::vector<std::shared_ptr<I2NPMessage>> msgs) {
   m_IsSending = false;
   if (ecode) {
     LOG(warning)
@@ -892,32 +1005,39 @@ void NTCPSession::HandleSentPayload(
     << "<-- " << bytes_transferred << " bytes transferred, "
     << GetNumSentBytes() << " total bytes sent";
   kovri::core::transports.UpdateSentBytes(bytes_transferred);
-  if (!m_SendQueue.empty()) {
-    SendPayload(m_SendQueue);
-    m_SendQueue.clear();
+  kovri::core::metrics.Inc(kovri::core::Metrics::NTCPOutMsgs, msgs.size());
+  if (!IsSendQueueEmpty()) {
+    SendPayload(DequeueSendBatch());
   } else {
     ScheduleTermination();  // Reset termination timer
   }
 }
 
 void NTCPSession::SendPayload(
-    const std::vector<std::shared_ptr<I2NPMessage>>& msgs) {
+    std::vector<std::shared_ptr<I2NPMessage>> msgs) {
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo() << "<-- sending I2NP messages";
   m_IsSending = true;
+  ScheduleLivenessProbe();
+  // Each message is framed and encrypted in place inside its own buffer,
+  // then the whole batch goes out as one gather-write (single syscall)
   std::vector<boost::asio::const_buffer> bufs;
-  for (auto it : msgs)
+  bufs.reserve(msgs.size());
+  for (const auto& it : msgs) {
+    // probe before framing: CreateMsgBuffer encrypts the header in place
+    KOVRI_PROBE2(ntcp_msg_tx, it ? it->GetMsgID() : 0, bufs.size());
     bufs.push_back(CreateMsgBuffer(it));
+  }
   boost::asio::async_write(
       m_Socket,
       bufs,
       boost::asio::transfer_all(),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandleSentPayload,
           shared_from_this(),
           std::placeholders::_1,
           std::placeholders::_2,
-          msgs));
+          std::move(msgs))));
 }
 
 boost::asio::const_buffers_1 NTCPSession::CreateMsgBuffer(
@@ -934,6 +1054,11 @@ boost::asio::const_buffers_1 NTCPSession::CreateMsgBuffer(
           << "NTCPSession:" << GetFormattedSessionInfo()
           << "!!! malformed I2NP message";  // TODO(unassigned): Error handling
       }
+      // Tunnel messages defer their checksum to this point (the only
+      // place the chks byte actually goes on the wire); peers verify it
+      const auto type_ID = msg->GetTypeID();
+      if (type_ID == I2NPTunnelData || type_ID == I2NPTunnelGateway)
+        msg->UpdateChks();
       send_buffer = msg->GetBuffer() - NTCPSize::Phase3AliceRI;
       len = msg->GetLength();
       core::OutputByteStream::Write<std::uint16_t>(send_buffer, len);
@@ -978,11 +1103,11 @@ void NTCPSession::ReceivePayload() {
           m_ReceiveBuffer + m_ReceiveBufferOffset,
           NTCPSize::Buffer - m_ReceiveBufferOffset),
       boost::asio::transfer_at_least(NTCPSize::IV),
-      std::bind(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandleReceivedPayload,
           shared_from_this(),
           std::placeholders::_1,
-          std::placeholders::_2));
+          std::placeholders::_2)));
 }
 
 void NTCPSession::HandleReceivedPayload(
@@ -1015,19 +1140,26 @@ void NTCPSession::HandleReceivedPayload(
     << GetNumReceivedBytes() << " total bytes received";
   kovri::core::transports.UpdateReceivedBytes(bytes_transferred);
   m_ReceiveBufferOffset += bytes_transferred;
-  // Decrypt as many 16 byte blocks as possible
-  std::uint8_t* next_block = m_ReceiveBuffer;
-  while(m_ReceiveBufferOffset >= block_size) {
-    // Try to decrypt one block
-    if (!DecryptNextBlock(next_block)) {
-      Terminate();
-      return;
+  // Decrypt every complete 16 byte block in a single CBC call, then
+  // walk the plaintext; per-block Decrypt calls dominated this path on
+  // high-throughput sessions
+  std::size_t const decrypted_len =
+      (m_ReceiveBufferOffset / block_size) * block_size;
+  if (decrypted_len) {
+    m_Decryption.Decrypt(m_ReceiveBuffer, decrypted_len, m_DecryptedBuffer);
+    for (std::size_t offset = 0; offset < decrypted_len; offset += block_size) {
+      if (!ProcessDecryptedBlock(m_DecryptedBuffer + offset)) {
+        Terminate();
+        return;
+      }
     }
-    next_block += block_size;
-    m_ReceiveBufferOffset -= block_size;
+    m_ReceiveBufferOffset -= decrypted_len;
+    if (m_ReceiveBufferOffset)  // Do we have an incomplete block?
+      std::memcpy(
+          m_ReceiveBuffer,
+          m_ReceiveBuffer + decrypted_len,
+          m_ReceiveBufferOffset);
   }
-  if (m_ReceiveBufferOffset) // Do we have an incomplete block?
-    std::memcpy(m_ReceiveBuffer, next_block, m_ReceiveBufferOffset);
   // Flush and reset termination timer if a full message was read
   if (m_NextMessage == nullptr) {
     m_Handler.Flush();
@@ -1042,17 +1174,15 @@ void NTCPSession::HandleReceivedPayload(
     ReceivePayload();
 }
 
-bool NTCPSession::DecryptNextBlock(
-    const std::uint8_t* encrypted) {  // 16 bytes
+bool NTCPSession::ProcessDecryptedBlock(
+    const std::uint8_t* block) {  // 16 bytes
   // TODO(anonimal): this try block should be larger or handled entirely by caller
   try {
     // New message, header expected
     if (!m_NextMessage) {
-      // Decrypt header and extract length
-      std::array<std::uint8_t, NTCPSize::IV> buf;
-      m_Decryption.Decrypt(encrypted, buf.data());
+      // Extract length from header
       std::uint16_t const data_size =
-          core::InputByteStream::Read<std::uint16_t>(buf.data());
+          core::InputByteStream::Read<std::uint16_t>(block);
       if (data_size) {
         // New message
         if (data_size > NTCPSize::MaxMessage) {
@@ -1068,7 +1198,7 @@ bool NTCPSession::DecryptNextBlock(
               ? NewI2NPShortMessage()
               : NewI2NPMessage();
         m_NextMessage = ToSharedI2NPMessage(std::move(msg));
-        memcpy(m_NextMessage->buf, buf.data(), NTCPSize::IV);
+        memcpy(m_NextMessage->buf, block, NTCPSize::IV);
         m_NextMessageOffset = NTCPSize::IV;
         m_NextMessage->offset = NTCPSize::Phase3AliceRI;  // size field
         m_NextMessage->len = data_size + NTCPSize::Phase3AliceRI;
@@ -1079,7 +1209,7 @@ bool NTCPSession::DecryptNextBlock(
         return true;
       }
     } else {  // Message continues
-      m_Decryption.Decrypt(encrypted, m_NextMessage->buf + m_NextMessageOffset);
+      memcpy(m_NextMessage->buf + m_NextMessageOffset, block, NTCPSize::IV);
       m_NextMessageOffset += NTCPSize::IV;
     }
     if (m_NextMessageOffset >=
@@ -1088,9 +1218,17 @@ bool NTCPSession::DecryptNextBlock(
       if (kovri::core::Adler32().VerifyDigest(
             m_NextMessage->buf + m_NextMessageOffset - NTCPSize::Adler32,
             m_NextMessage->buf,
-            m_NextMessageOffset - NTCPSize::Adler32))
+            m_NextMessageOffset - NTCPSize::Adler32)) {
+        KOVRI_PROBE2(
+            ntcp_msg_rx, m_NextMessage->GetMsgID(), m_NextMessage->len);
+        if (message_trace.IsEnabled())
+          message_trace.Record(
+              MessageTrace::Inbound,
+              GetRemoteIdentity().GetIdentHash(),
+              *m_NextMessage);
         m_Handler.PutNextMessage(m_NextMessage);
-      else
+        kovri::core::metrics.Inc(kovri::core::Metrics::NTCPInMsgs);
+      } else
         LOG(warning)
           << "NTCPSession:" << GetFormattedSessionInfo()
           << "!!! incorrect Adler checksum of NTCP message, dropped";
@@ -1108,7 +1246,7 @@ bool NTCPSession::DecryptNextBlock(
 
 void NTCPSession::SendI2NPMessages(
     const std::vector<std::shared_ptr<I2NPMessage>>& msgs) {
-  m_Server.GetService().post(
+  m_Strand.post(
       std::bind(
           &NTCPSession::PostI2NPMessages,
           shared_from_this(),
@@ -1119,12 +1257,49 @@ void NTCPSession::PostI2NPMessages(
     std::vector<std::shared_ptr<I2NPMessage>> msgs) {
   if (m_IsTerminated)
     return;
-  if (m_IsSending) {
-    for (auto it : msgs)
-      m_SendQueue.push_back(it);
-  } else {
-    SendPayload(msgs);
-  }
+  // Always merge into the queues first so anything left over from an
+  // earlier write goes out ahead of this batch within its priority class
+  for (auto& it : msgs)
+    QueueI2NPMessage(std::move(it));
+  if (!m_IsSending)
+    SendPayload(DequeueSendBatch());
+}
+
+void NTCPSession::QueueI2NPMessage(
+    std::shared_ptr<I2NPMessage> msg) {
+  const auto priority = GetI2NPMessagePriority(msg->GetTypeID());
+  m_SendQueue.at(static_cast<std::size_t>(priority)).push_back(
+      std::move(msg));
+}
+
+bool NTCPSession::IsSendQueueEmpty() const {
+  for (const auto& queue : m_SendQueue)
+    if (!queue.empty())
+      return false;
+  return true;
+}
+
+std::vector<std::shared_ptr<I2NPMessage>> NTCPSession::DequeueSendBatch() {
+  auto& control =
+      m_SendQueue.at(static_cast<std::size_t>(I2NPMessagePriority::Control));
+  auto& interactive = m_SendQueue.at(
+      static_cast<std::size_t>(I2NPMessagePriority::Interactive));
+  auto& bulk =
+      m_SendQueue.at(static_cast<std::size_t>(I2NPMessagePriority::Bulk));
+  std::vector<std::shared_ptr<I2NPMessage>> batch = std::move(control);
+  control.clear();
+  batch.insert(
+      batch.end(),
+      std::make_move_iterator(interactive.begin()),
+      std::make_move_iterator(interactive.end()));
+  interactive.clear();
+  const std::size_t num_bulk = std::min(bulk.size(), NTCP_MAX_BULK_PER_WRITE);
+  batch.insert(
+      batch.end(),
+      std::make_move_iterator(bulk.begin()),
+      std::make_move_iterator(bulk.begin() + num_bulk));
+  bulk.erase(bulk.begin(), bulk.begin() + num_bulk);
+  return batch;
 }
 
 /**
@@ -1141,10 +1316,32 @@ void NTCPSession::ScheduleTermination() {
       boost::posix_time::seconds(
           GetType(NTCPTimeoutLength::Termination)));
   m_TerminationTimer.async_wait(
-      std::bind(
+      m_Strand.wrap(std::bind(
+          &NTCPSession::HandleTerminationTimer,
+          shared_from_this(),
+          std::placeholders::_1)));
+}
+
+void NTCPSession::ScheduleLivenessProbe() {
+  m_TerminationTimer.cancel();
+  m_TerminationTimer.expires_from_now(
+      boost::posix_time::milliseconds(
+          static_cast<long>(GetLivenessTimeout())));
+  m_TerminationTimer.async_wait(
+      m_Strand.wrap(std::bind(
           &NTCPSession::HandleTerminationTimer,
           shared_from_this(),
-          std::placeholders::_1));
+          std::placeholders::_1)));
+}
+
+std::uint64_t NTCPSession::GetLivenessTimeout() const {
+  const auto rtt = kovri::core::GetRouterProfile(
+      GetRemoteIdentity().GetIdentHash())->GetMeanRTT();
+  if (!rtt)
+    return NTCP_LIVENESS_MAX_TIMEOUT;
+  return std::min(
+      NTCP_LIVENESS_MAX_TIMEOUT,
+      std::max(NTCP_LIVENESS_RTT_FACTOR * rtt, NTCP_LIVENESS_MIN_TIMEOUT));
 }
 
 void NTCPSession::HandleTerminationTimer(
@@ -1153,10 +1350,20 @@ void NTCPSession::HandleTerminationTimer(
     << "NTCPSession:" << GetFormattedSessionInfo()
     << "*** handling termination timer";
   if (ecode != boost::asio::error::operation_aborted) {
-    LOG(warning)
-      << "NTCPSession:" << GetFormattedSessionInfo()
-      << "!!! no activity for "
-      << GetType(NTCPTimeoutLength::Termination) << " seconds";
+    if (m_IsSending) {
+      // a write stalled past its RTT-scaled deadline: the peer stopped
+      // draining its socket, i.e. a black hole rather than mere idleness
+      LOG(warning)
+        << "NTCPSession:" << GetFormattedSessionInfo()
+        << "!!! write stalled, peer presumed dead";
+      if (m_IsEstablished)
+        transports.PeerFailed(GetRemoteIdentity().GetIdentHash());
+    } else {
+      LOG(warning)
+        << "NTCPSession:" << GetFormattedSessionInfo()
+        << "!!! no activity for "
+        << GetType(NTCPTimeoutLength::Termination) << " seconds";
+    }
     // Terminate();
     m_Socket.close();  // invoke Terminate() from HandleReceive
   }
@@ -1165,7 +1372,7 @@ void NTCPSession::HandleTerminationTimer(
 void NTCPSession::Done() {
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo() << "*** done with session";
-  m_Server.GetService().post(
+  m_Strand.post(
       std::bind(
           &NTCPSession::Terminate,
           shared_from_this()));
@@ -1181,7 +1388,8 @@ void NTCPSession::Terminate() {
     m_Socket.close(ec);
     transports.PeerDisconnected(shared_from_this());
     m_Server.RemoveNTCPSession(shared_from_this());
-    m_SendQueue.clear();
+    for (auto& queue : m_SendQueue)
+      queue.clear();
     m_NextMessage = nullptr;
     m_TerminationTimer.cancel();
     LOG(debug)
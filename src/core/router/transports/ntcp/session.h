@@ -35,6 +35,7 @@
 
 #include <boost/asio.hpp>
 
+#include <array>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -45,6 +46,7 @@
 #include <vector>
 
 #include "core/crypto/aes.h"
+#include "core/crypto/cipher_pool.h"
 
 #include "core/router/i2np.h"
 #include "core/router/identity.h"
@@ -64,6 +66,23 @@ enum struct NTCPTimeoutLength : std::uint16_t {
   BanExpiration = 70,
 };
 
+/// @brief Max bulk-priority messages drained into one gather-write.
+///   Capping the bulk share keeps writes bounded under data-plane load,
+///   so control messages arriving mid-transfer wait for at most one
+///   bounded write instead of the whole backlog
+const std::size_t NTCP_MAX_BULK_PER_WRITE = 32;
+
+/// @brief A pending write is scaled from the peer's profiled round trip
+///   by this factor before it counts as stalled
+const std::uint64_t NTCP_LIVENESS_RTT_FACTOR = 8;
+/// @brief Floor of the write-liveness deadline (in milliseconds), so a
+///   single delayed ACK round never condemns a fast peer
+const std::uint64_t NTCP_LIVENESS_MIN_TIMEOUT = 5000;
+/// @brief Cap of the write-liveness deadline (in milliseconds); also the
+///   deadline for peers without a profiled round trip. Well under the
+///   idle termination timeout: a black-holed peer dies in seconds
+const std::uint64_t NTCP_LIVENESS_MAX_TIMEOUT = 30000;
+
 class NTCPServer;
 class NTCPSession
     : public TransportSession,
@@ -143,6 +162,16 @@ class NTCPSession
   void PostI2NPMessages(
       std::vector<std::shared_ptr<I2NPMessage>> msgs);
 
+  /// @brief Queues an outbound message under its priority class
+  void QueueI2NPMessage(
+      std::shared_ptr<I2NPMessage> msg);
+
+  bool IsSendQueueEmpty() const;
+
+  /// @brief Drains queued messages into one write batch: control first,
+  ///   then interactive, then at most NTCP_MAX_BULK_PER_WRITE bulk
+  std::vector<std::shared_ptr<I2NPMessage>> DequeueSendBatch();
+
   void Connected();
 
   void SendTimeSyncMessage();
@@ -152,17 +181,44 @@ class NTCPSession
     m_IsEstablished = is_established;
   }
 
-  void CreateAESKey(
+  /// @brief Runs the DH agreement for the session AES key
+  /// @return False when the agreement fails or the shared secret is
+  ///   degenerate; the caller decides how to tear the session down
+  bool CreateAESKey(
       std::uint8_t* pub_key,
       kovri::core::AESKey& key);
 
   // TODO(anonimal): simplify phase impl/handler
+  //
+  // The expensive half of each phase (DH agreement, signing, signature
+  // verification) runs on the transports handshake crypto worker; the
+  // Write*/Finish* continuations are posted back to the session strand
+  // so all socket use stays serialized. No socket operation is pending
+  // on a session while its phase crypto is in flight, so the worker has
+  // the establishment state to itself.
 
   void SendPhase1();
 
   // Client
+
+  /// @brief Phase2 crypto (DH agreement and hash check); crypto worker
+  void ProcessPhase2();
+
   void SendPhase3();
 
+  /// @brief Writes the Phase3 buffer prepared by SendPhase3
+  void WritePhase3(
+      std::size_t len,
+      std::uint32_t ts_A);
+
+  /// @brief Phase4 crypto (signature verification); crypto worker
+  void ProcessPhase4(
+      std::size_t bytes_transferred,
+      std::uint32_t ts_A);
+
+  /// @brief Completes the client handshake on the session strand
+  void FinishClientHandshake();
+
   void HandlePhase1Sent(
       const boost::system::error_code& ecode,
       std::size_t bytes_transferred);
@@ -184,10 +240,21 @@ class NTCPSession
   // Server
   void SendPhase2();
 
+  /// @brief Phase2 crypto (DH agreement and encryption); crypto worker
+  void CreatePhase2();
+
+  /// @brief Writes the Phase2 message prepared by CreatePhase2
+  void WritePhase2(
+      std::uint32_t ts_B);
+
   void SendPhase4(
       std::uint32_t ts_A,
       std::uint32_t ts_B);
 
+  /// @brief Writes the Phase4 buffer prepared by SendPhase4
+  void WritePhase4(
+      std::size_t signature_len);
+
   void HandlePhase1Received(
       const boost::system::error_code& ecode,
       std::size_t bytes_transferred);
@@ -223,18 +290,23 @@ class NTCPSession
       const boost::system::error_code& ecode,
       std::size_t bytes_transferred);
 
-  bool DecryptNextBlock(
-      const std::uint8_t* encrypted);
+  /// @brief Consumes one already-decrypted 16-byte block of the payload
+  ///   stream, assembling I2NP messages as their blocks complete
+  /// @param block Plaintext block (see HandleReceivedPayload's bulk decrypt)
+  /// @return False if the stream is malformed and the session must die
+  bool ProcessDecryptedBlock(
+      const std::uint8_t* block);
 
   /// @brief Send payload (I2NP message)
   /// @param msg shared pointer to payload (I2NPMessage)
   void SendPayload(
       std::shared_ptr<kovri::core::I2NPMessage> msg);
 
-  /// @brief Send payload (I2NP messages)
-  /// @param msg shared pointer to payload (I2NPMessages)
+  /// @brief Send payload (I2NP messages) as a single gather-write
+  /// @param msgs shared pointers to payload (I2NPMessages), taken by value
+  ///   so callers can move and avoid copying the batch
   void SendPayload(
-      const std::vector<std::shared_ptr<I2NPMessage>>& msgs);
+      std::vector<std::shared_ptr<I2NPMessage>> msgs);
 
   boost::asio::const_buffers_1 CreateMsgBuffer(
       std::shared_ptr<I2NPMessage> msg);
@@ -247,6 +319,17 @@ class NTCPSession
   // Timer
   void ScheduleTermination();
 
+  /// @brief Re-arms the termination timer with a write-liveness deadline
+  ///   (see GetLivenessTimeout); called when a write starts, so a peer
+  ///   that stops draining its socket is torn down at RTT scale instead
+  ///   of after the full idle timeout
+  void ScheduleLivenessProbe();
+
+  /// @brief Deadline for the pending write (in milliseconds): the peer's
+  ///   profiled round trip scaled by NTCP_LIVENESS_RTT_FACTOR, clamped to
+  ///   [NTCP_LIVENESS_MIN_TIMEOUT, NTCP_LIVENESS_MAX_TIMEOUT]
+  std::uint64_t GetLivenessTimeout() const;
+
   void HandleTerminationTimer(
       const boost::system::error_code& ecode);
 
@@ -262,12 +345,15 @@ class NTCPSession
 
   NTCPServer& m_Server;
   boost::asio::ip::tcp::socket m_Socket;
+  /// @brief Serializes this session's handlers when the transports
+  ///   io_service runs on multiple worker threads
+  boost::asio::io_service::strand m_Strand;
   boost::asio::ip::tcp::endpoint m_RemoteEndpoint;
   boost::asio::deadline_timer m_TerminationTimer;
   bool m_IsEstablished, m_IsTerminated;
 
-  kovri::core::CBCDecryption m_Decryption;
-  kovri::core::CBCEncryption m_Encryption;
+  kovri::core::PooledCBCDecryption m_Decryption;
+  kovri::core::PooledCBCEncryption m_Encryption;
 
   /// @enum NTCPSize
   enum NTCPSize : std::uint16_t {
@@ -330,6 +416,9 @@ class NTCPSession
   std::array<std::uint8_t, NTCPSize::Hash> m_HX;
 
   kovri::core::AESAlignedBuffer<NTCPSize::Buffer + NTCPSize::IV> m_ReceiveBuffer;
+  /// @brief Scratch for bulk-decrypting the whole receive window in one
+  ///   CBC call instead of one call per 16-byte block
+  kovri::core::AESAlignedBuffer<NTCPSize::Buffer + NTCPSize::IV> m_DecryptedBuffer;
   kovri::core::AESAlignedBuffer<NTCPSize::IV> m_TimeSyncBuffer;
 
   std::size_t m_ReceiveBufferOffset;
@@ -339,7 +428,10 @@ class NTCPSession
   kovri::core::I2NPMessagesHandler m_Handler;
 
   bool m_IsSending;
-  std::vector<std::shared_ptr<I2NPMessage>> m_SendQueue;
+  /// @brief Outbound backlog, one queue per I2NPMessagePriority class
+  std::array<
+      std::vector<std::shared_ptr<I2NPMessage>>,
+      I2NP_NUM_PRIORITIES> m_SendQueue;
 
   kovri::core::Exception m_Exception;
 };
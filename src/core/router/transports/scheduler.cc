@@ -0,0 +1,232 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "core/router/transports/scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "core/router/context.h"
+
+#include "core/util/log.h"
+#include "core/util/metrics.h"
+#include "core/util/timestamp.h"
+
+namespace kovri {
+namespace core {
+
+void BandwidthScheduler::TokenBucket::SetRate(
+    std::uint64_t bytes_per_second) {
+  rate = bytes_per_second;
+  burst = std::max<std::int64_t>(
+      rate * BANDWIDTH_BURST_INTERVAL / 1000,
+      2 * I2NP_MAX_MESSAGE_SIZE);
+  tokens = burst;
+}
+
+void BandwidthScheduler::TokenBucket::Refill(
+    std::uint64_t elapsed) {
+  if (!rate)
+    return;
+  tokens = std::min<std::int64_t>(tokens + rate * elapsed / 1000, burst);
+}
+
+BandwidthScheduler::BandwidthScheduler(
+    boost::asio::io_service& service,
+    boost::asio::io_service::strand& strand,
+    DeliverHandler deliver)
+    : m_IsRunning(false),
+      m_Strand(strand),
+      m_Timer(service),
+      m_Deliver(std::move(deliver)),
+      m_LastTick(0) {}
+
+void BandwidthScheduler::Start() {
+  std::uint64_t const limit =
+      context.GetOpts()["bandwidth-limit"].as<std::uint32_t>() * 1024ull;
+  if (!limit) {
+    LOG(debug) << "BandwidthScheduler: no bandwidth-limit, pass-through";
+    return;
+  }
+  std::uint64_t transit =
+      context.GetOpts()["transit-bandwidth"].as<std::uint32_t>() * 1024ull;
+  if (!transit)  // leave headroom for our own traffic by default
+    transit = limit * 8 / 10;
+  m_Total.SetRate(limit);
+  // Control and client classes may use the full rate; the parent bucket
+  // enforces the aggregate and the drain order enforces their priority
+  m_Classes[static_cast<std::size_t>(BandwidthClass::Control)]
+      .bucket.SetRate(limit);
+  m_Classes[static_cast<std::size_t>(BandwidthClass::Client)]
+      .bucket.SetRate(limit);
+  m_Classes[static_cast<std::size_t>(BandwidthClass::Transit)]
+      .bucket.SetRate(transit);
+  LOG(info)
+    << "BandwidthScheduler: shaping at " << limit
+    << " Bps total, " << transit << " Bps transit";
+  m_IsRunning = true;
+  m_LastTick = kovri::core::GetMillisecondsSinceEpoch();
+  ScheduleTick();
+}
+
+void BandwidthScheduler::Stop() {
+  m_IsRunning = false;
+  m_Timer.cancel();
+  for (auto& traffic : m_Classes) {
+    traffic.queue.clear();
+    traffic.queued_bytes = 0;
+  }
+}
+
+BandwidthClass BandwidthScheduler::Classify(
+    const kovri::core::I2NPMessage& msg) {
+  if (msg.transit)
+    return BandwidthClass::Transit;
+  if (GetI2NPMessagePriority(msg.GetTypeID()) == I2NPMessagePriority::Control)
+    return BandwidthClass::Control;
+  return BandwidthClass::Client;
+}
+
+bool BandwidthScheduler::TryConsume(
+    TrafficClass& traffic,
+    std::size_t num_bytes) {
+  if (!traffic.bucket.HasTokens() || !m_Total.HasTokens())
+    return false;
+  traffic.bucket.Consume(num_bytes);
+  m_Total.Consume(num_bytes);
+  return true;
+}
+
+void BandwidthScheduler::Send(
+    const kovri::core::IdentHash& ident,
+    const std::vector<std::shared_ptr<kovri::core::I2NPMessage>>& msgs) {
+  if (!m_IsRunning) {  // pass-through
+    m_Deliver(ident, msgs);
+    return;
+  }
+  // Split by class; batches are nearly always homogeneous
+  Batch batches[NUM_BANDWIDTH_CLASSES];
+  for (const auto& msg : msgs) {
+    Batch& batch = batches[static_cast<std::size_t>(Classify(*msg))];
+    batch.msgs.push_back(msg);
+    batch.num_bytes += msg->GetLength();
+  }
+  for (std::size_t i = 0; i < NUM_BANDWIDTH_CLASSES; i++) {
+    Batch& batch = batches[i];
+    if (batch.msgs.empty())
+      continue;
+    batch.ident = ident;
+    TrafficClass& traffic = m_Classes[i];
+    if (traffic.queue.empty() && TryConsume(traffic, batch.num_bytes))
+      m_Deliver(ident, std::move(batch.msgs));
+    else
+      Enqueue(static_cast<BandwidthClass>(i), std::move(batch));
+  }
+  PublishQueueDepth();
+}
+
+void BandwidthScheduler::Enqueue(
+    BandwidthClass bandwidth_class,
+    Batch batch) {
+  TrafficClass& traffic =
+      m_Classes[static_cast<std::size_t>(bandwidth_class)];
+  if (traffic.queued_bytes + batch.num_bytes > BANDWIDTH_MAX_QUEUE_SIZE) {
+    // Dropping at the rate limit beats queueing toward bufferbloat;
+    // tunnel test messages will flag persistently starved routes
+    LOG(warning)
+      << "BandwidthScheduler: class "
+      << static_cast<std::size_t>(bandwidth_class)
+      << " queue full, dropping " << batch.num_bytes << " bytes";
+    return;
+  }
+  traffic.queued_bytes += batch.num_bytes;
+  traffic.queue.push_back(std::move(batch));
+}
+
+void BandwidthScheduler::Drain() {
+  for (auto& traffic : m_Classes) {
+    while (!traffic.queue.empty()
+           && traffic.bucket.HasTokens()
+           && m_Total.HasTokens()) {
+      Batch batch = std::move(traffic.queue.front());
+      traffic.queue.pop_front();
+      traffic.queued_bytes -= batch.num_bytes;
+      traffic.bucket.Consume(batch.num_bytes);
+      m_Total.Consume(batch.num_bytes);
+      m_Deliver(batch.ident, std::move(batch.msgs));
+    }
+  }
+  PublishQueueDepth();
+}
+
+void BandwidthScheduler::PublishQueueDepth() {
+  metrics.Set(
+      Metrics::ShapedControlQueue,
+      m_Classes[static_cast<std::size_t>(BandwidthClass::Control)]
+          .queued_bytes);
+  metrics.Set(
+      Metrics::ShapedClientQueue,
+      m_Classes[static_cast<std::size_t>(BandwidthClass::Client)]
+          .queued_bytes);
+  metrics.Set(
+      Metrics::ShapedTransitQueue,
+      m_Classes[static_cast<std::size_t>(BandwidthClass::Transit)]
+          .queued_bytes);
+}
+
+void BandwidthScheduler::ScheduleTick() {
+  m_Timer.expires_from_now(
+      boost::posix_time::milliseconds(BANDWIDTH_TICK_INTERVAL));
+  m_Timer.async_wait(
+      m_Strand.wrap(
+          std::bind(
+              &BandwidthScheduler::HandleTick,
+              this,
+              std::placeholders::_1)));
+}
+
+void BandwidthScheduler::HandleTick(
+    const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted || !m_IsRunning)
+    return;
+  std::uint64_t const now = kovri::core::GetMillisecondsSinceEpoch();
+  std::uint64_t const elapsed = now > m_LastTick ? now - m_LastTick : 0;
+  m_LastTick = now;
+  m_Total.Refill(elapsed);
+  for (auto& traffic : m_Classes)
+    traffic.bucket.Refill(elapsed);
+  Drain();
+  ScheduleTick();
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,166 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_ROUTER_TRANSPORTS_SCHEDULER_H_
+#define SRC_CORE_ROUTER_TRANSPORTS_SCHEDULER_H_
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/router/i2np.h"
+#include "core/router/identity.h"
+
+namespace kovri {
+namespace core {
+
+/// @enum BandwidthClass
+/// @brief Traffic classes shaped at the transport send layer, drained
+///   in declaration order so control traffic never waits behind bulk
+enum struct BandwidthClass : std::uint8_t {
+  Control = 0,  ///< Tunnel builds/replies, DeliveryStatus acks
+  Client = 1,  ///< Our own tunnels' data and direct router traffic
+  Transit = 2,  ///< Traffic relayed for other routers' tunnels
+};
+
+const std::size_t NUM_BANDWIDTH_CLASSES = 3;
+const std::uint64_t BANDWIDTH_TICK_INTERVAL = 10;  // in milliseconds
+/// @brief Largest burst a bucket may pass at once, in milliseconds of
+///   its configured rate (floored so one full batch always fits)
+const std::uint64_t BANDWIDTH_BURST_INTERVAL = 125;
+/// @brief Bytes parked per class before further batches are dropped
+const std::size_t BANDWIDTH_MAX_QUEUE_SIZE = 2 * 1024 * 1024;
+
+/// @class BandwidthScheduler
+/// @brief Token-bucket shaper for outbound transport traffic. Each
+///   class has its own bucket under a shared parent bucket (the total
+///   outbound rate); transit relay is additionally capped so it cannot
+///   starve our own streams, while control and client traffic may use
+///   the full configured rate. Unconfigured (rate 0) the scheduler
+///   passes batches straight through
+/// @note Strand-confined: Send() and the drain timer both run on the
+///   transports strand, so no locking is needed
+class BandwidthScheduler {
+ public:
+  typedef std::function<
+      void(const kovri::core::IdentHash&,
+           std::vector<std::shared_ptr<kovri::core::I2NPMessage>>)>
+      DeliverHandler;
+
+  BandwidthScheduler(
+      boost::asio::io_service& service,
+      boost::asio::io_service::strand& strand,
+      DeliverHandler deliver);
+
+  /// @brief Reads the configured rates and arms the drain timer;
+  ///   without a bandwidth-limit the scheduler stays in pass-through
+  void Start();
+
+  /// @brief Cancels the drain timer and drops all parked batches
+  void Stop();
+
+  /// @brief Delivers the batch within its class rate, or parks it until
+  ///   tokens refill. Mixed-class batches are split per class
+  /// @note Must be called from the transports strand
+  void Send(
+      const kovri::core::IdentHash& ident,
+      const std::vector<std::shared_ptr<kovri::core::I2NPMessage>>& msgs);
+
+ private:
+  struct TokenBucket {
+    std::uint64_t rate{};  ///< Bytes per second; 0 = unlimited
+    std::int64_t burst{};
+    std::int64_t tokens{};
+
+    void SetRate(std::uint64_t bytes_per_second);
+
+    void Refill(std::uint64_t elapsed);  // in milliseconds
+
+    /// @return True while the bucket is not in debt (batches may
+    ///   overdraw; the debt is paid by later refills)
+    bool HasTokens() const {
+      return !rate || tokens > 0;
+    }
+
+    void Consume(std::uint64_t num_bytes) {
+      if (rate)
+        tokens -= num_bytes;
+    }
+  };
+
+  struct Batch {
+    kovri::core::IdentHash ident;
+    std::vector<std::shared_ptr<kovri::core::I2NPMessage>> msgs;
+    std::size_t num_bytes{};
+  };
+
+  struct TrafficClass {
+    TokenBucket bucket;
+    std::deque<Batch> queue;
+    std::size_t queued_bytes{};
+  };
+
+  static BandwidthClass Classify(const kovri::core::I2NPMessage& msg);
+
+  /// @return True when both the class and the parent bucket had tokens
+  ///   (and consumed them) for an inline delivery
+  bool TryConsume(TrafficClass& traffic, std::size_t num_bytes);
+
+  void Enqueue(BandwidthClass bandwidth_class, Batch batch);
+
+  /// @brief Sends parked batches, highest class first, while tokens last
+  void Drain();
+
+  void PublishQueueDepth();
+
+  void ScheduleTick();
+
+  void HandleTick(const boost::system::error_code& ecode);
+
+ private:
+  bool m_IsRunning;
+  boost::asio::io_service::strand& m_Strand;
+  boost::asio::deadline_timer m_Timer;
+  DeliverHandler m_Deliver;
+  TrafficClass m_Classes[NUM_BANDWIDTH_CLASSES];
+  TokenBucket m_Total;  ///< Parent bucket: the aggregate outbound rate
+  std::uint64_t m_LastTick;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_TRANSPORTS_SCHEDULER_H_
@@ -35,11 +35,18 @@
 #include <boost/bind.hpp>
 #include <boost/endian/conversion.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 #include "core/router/info.h"
 #include "core/router/net_db/impl.h"
+#include "core/router/transports/impl.h"
+#include "core/router/transports/message_trace.h"
 #include "core/router/transports/ssu/server.h"
 
 #include "core/util/log.h"
+#include "core/util/metrics.h"
 #include "core/util/timestamp.h"
 
 namespace kovri {
@@ -66,13 +73,20 @@ void IncompleteMessage::AttachNextFragment(
 SSUData::SSUData(
     SSUSession& session)
     : m_Session(session),
+      m_IsACKSendScheduled(false),
       m_ResendTimer(session.GetService()),
       m_DecayTimer(session.GetService()),
-      m_IncompleteMessagesCleanupTimer(session.GetService()) {
+      m_IncompleteMessagesCleanupTimer(session.GetService()),
+      m_ACKSendTimer(session.GetService()),
+      m_MTUReprobeTimer(session.GetService()) {
   m_MaxPacketSize = session.IsV6()
     ? SSUSize::PacketMaxIPv6
     : SSUSize::PacketMaxIPv4;
   m_PacketSize = m_MaxPacketSize;
+  m_ProbeLow = m_ProbeHigh = m_ProbeSize = 0;
+  m_ProbeMsgID = 0;
+  m_ProbeInFlight = false;
+  m_RTT = 0;
   auto remote_router = session.GetRemoteRouter();
   if (remote_router)
     AdjustPacketSize(*remote_router);
@@ -83,6 +97,7 @@ SSUData::~SSUData() {}
 void SSUData::Start() {
   LOG(debug) << "SSUData: starting";
   ScheduleIncompleteMessagesCleanup();
+  StartMTUProbe();
 }
 
 void SSUData::Stop() {
@@ -90,12 +105,18 @@ void SSUData::Stop() {
   m_ResendTimer.cancel();
   m_DecayTimer.cancel();
   m_IncompleteMessagesCleanupTimer.cancel();
+  m_ACKSendTimer.cancel();
+  m_MTUReprobeTimer.cancel();
 }
 
 void SSUData::AdjustPacketSize(
     const kovri::core::RouterInfo& remote_router) {
   LOG(debug) << "SSUData: adjusting packet size";
 
+  if (!m_ProbeSize && m_ProbeLow) {
+    // probing already validated the path; the published MTU is only a hint
+    return;
+  }
   const auto* ssu_address =
       remote_router.GetAddress(m_Session.IsV6(), Transport::SSU);
 
@@ -136,6 +157,68 @@ void SSUData::UpdatePacketSize(
     AdjustPacketSize(*router_info);
 }
 
+std::size_t SSUData::MinPacketSize() const {
+  // minimum SSU MTUs (620 for IPv4, 1280 for IPv6) less IP and UDP
+  // headers; both land on a 16-byte boundary
+  return m_Session.IsV6()
+    ? 1280 - SSUSize::HeaderIPv6 - SSUSize::HeaderUDP
+    : 620 - SSUSize::HeaderIPv4 - SSUSize::HeaderUDP;
+}
+
+void SSUData::StartMTUProbe() {
+  m_ProbeLow = MinPacketSize();
+  m_ProbeHigh = m_MaxPacketSize;
+  // try the full packet size first: on clean paths one probe settles it
+  m_ProbeSize = m_ProbeHigh;
+  m_ProbeInFlight = false;
+  LOG(debug)
+    << "SSUData:" << m_Session.GetFormattedSessionInfo()
+    << "probing path MTU in [" << m_ProbeLow << ", " << m_ProbeHigh << "]";
+}
+
+void SSUData::HandleMTUProbeResult(
+    bool success) {
+  if (success) {
+    m_ProbeLow = m_ProbeSize;
+    if (m_PacketSize < m_ProbeSize)
+      m_PacketSize = m_ProbeSize;  // validated, use immediately
+  } else {
+    m_ProbeHigh = m_ProbeSize - 16;
+    if (m_PacketSize > m_ProbeHigh)
+      m_PacketSize = std::max(m_ProbeHigh, MinPacketSize());
+  }
+  if (m_ProbeHigh <= m_ProbeLow) {
+    m_PacketSize = m_ProbeLow;
+    m_ProbeSize = 0;  // converged
+    LOG(debug)
+      << "SSUData:" << m_Session.GetFormattedSessionInfo()
+      << "path MTU probing settled on packet size " << m_PacketSize;
+    ScheduleMTUReprobe();
+    return;
+  }
+  std::size_t mid = (m_ProbeLow + m_ProbeHigh) / 2;
+  m_ProbeSize = ((mid + 15) >> 4) << 4;  // round up: candidate stays > low
+}
+
+void SSUData::ScheduleMTUReprobe() {
+  m_MTUReprobeTimer.cancel();
+  m_MTUReprobeTimer.expires_from_now(
+      boost::posix_time::seconds{
+          static_cast<long>(SSUDuration::MTUReprobeInterval)});
+  auto s = m_Session.shared_from_this();
+  m_MTUReprobeTimer.async_wait(
+      m_Session.GetStrand().wrap(
+      [s](const boost::system::error_code& ecode) {
+      s->m_Data.HandleMTUReprobeTimer(ecode);
+      }));
+}
+
+void SSUData::HandleMTUReprobeTimer(
+    const boost::system::error_code& ecode) {
+  if (ecode != boost::asio::error::operation_aborted)
+    StartMTUProbe();  // the path may have changed either way
+}
+
 void SSUData::ProcessSentMessageACK(
     std::uint32_t msg_id) {
   // TODO(unassigned): too spammy? keep?
@@ -144,10 +227,24 @@ void SSUData::ProcessSentMessageACK(
       //"processing sent message ACK");
   auto it = m_SentMessages.find(msg_id);
   if (it != m_SentMessages.end()) {
+    // Karn's rule: only a never-retransmitted message gives a clean RTT
+    // sample (a resent one can't tell which copy this ACK answers)
+    if (!it->second->num_resends) {
+      const auto ts = kovri::core::GetMillisecondsSinceEpoch();
+      if (ts > it->second->send_time) {
+        const std::uint64_t sample = ts - it->second->send_time;
+        m_RTT = m_RTT ? (7 * m_RTT + sample) / 8 : sample;
+      }
+    }
     m_SentMessages.erase(it);
     if (m_SentMessages.empty())
       m_ResendTimer.cancel();
   }
+  if (m_ProbeInFlight && msg_id == m_ProbeMsgID) {
+    // still in flight, so the padded packet itself made it through
+    m_ProbeInFlight = false;
+    HandleMTUProbeResult(true);
+  }
 }
 
 void SSUData::ProcessACKs(
@@ -195,6 +292,34 @@ void SSUData::ProcessACKs(
         buf++;
       }
       while (is_not_last);
+      if (it == m_SentMessages.end())
+        continue;
+      auto& sent = *it->second;
+      bool complete = true;
+      bool gap = false;  // a missing fragment behind an ACKed later one
+      bool seen_missing = false;
+      for (const auto& fragment : sent.fragments) {
+        if (fragment) {
+          complete = false;
+          seen_missing = true;
+        } else if (seen_missing) {
+          gap = true;
+        }
+      }
+      if (complete) {
+        // the bitfields covered every fragment: same as an explicit ACK
+        ProcessSentMessageACK(msg_id);
+      } else if (gap) {
+        // later fragments keep getting ACKed while earlier ones do not:
+        // after enough sightings, treat that as loss and resend the gaps
+        // ahead of the timer
+        if (++sent.dup_ack_evidence >= SSUDuration::FastRetransmitThreshold
+            && sent.num_resends < SSUDuration::MaxResends) {
+          sent.dup_ack_evidence = 0;
+          ResendMissingFragments(
+              sent, kovri::core::GetMillisecondsSinceEpoch());
+        }
+      }
     }
   }
 }
@@ -305,7 +430,13 @@ void SSUData::ProcessFragments(
           else
             ScheduleDecay();
           m_ReceivedMessages.insert(msg_id);
+          if (message_trace.IsEnabled())
+            message_trace.Record(
+                MessageTrace::Inbound,
+                m_Session.GetRemoteIdentity().GetIdentHash(),
+                *msg);
           m_Handler.PutNextMessage(msg);
+          metrics.Inc(Metrics::SSUInMsgs);
         } else {
           LOG(warning)
             << "SSUData:" << m_Session.GetFormattedSessionInfo()
@@ -325,7 +456,13 @@ void SSUData::ProcessFragments(
             << "SSUData:" << m_Session.GetFormattedSessionInfo()
             << "Got DSM From SSU";
           m_ReceivedMessages.insert(msg_id);
+          if (message_trace.IsEnabled())
+            message_trace.Record(
+                MessageTrace::Inbound,
+                m_Session.GetRemoteIdentity().GetIdentHash(),
+                *msg);
           m_Handler.PutNextMessage(msg);
+          metrics.Inc(Metrics::SSUInMsgs);
         } else {
           LOG(warning)
             << "SSUData:" << m_Session.GetFormattedSessionInfo()
@@ -389,8 +526,8 @@ void SSUData::Send(
       << "message " << msg_id << " was already sent";
     return;
   }
-  if (m_SentMessages.empty())  // schedule resend at first message only
-    ScheduleResend();
+  const bool first_message = m_SentMessages.empty();
+  metrics.Inc(Metrics::SSUOutMsgs);
   auto ret =
     m_SentMessages.insert(
         std::make_pair(
@@ -398,11 +535,14 @@ void SSUData::Send(
             std::unique_ptr<SentMessage>(std::make_unique<SentMessage>())));
   std::unique_ptr<SentMessage>& sent_message = ret.first->second;
   if (ret.second) {
-    sent_message->next_resend_time =
-      kovri::core::GetSecondsSinceEpoch()
-      + SSUDuration::ResendInterval;
+    const auto now = kovri::core::GetMillisecondsSinceEpoch();
+    sent_message->next_resend_time = now + GetResendTimeout();
+    sent_message->send_time = now;
     sent_message->num_resends = 0;
+    sent_message->dup_ack_evidence = 0;
   }
+  if (first_message)  // schedule resend at first message only
+    ScheduleResend();
   auto& fragments = sent_message->fragments;
   // 9 = flag + #frg(1) + messageID(4) + frag info (3)
   auto payload_size = m_PacketSize - SSUSize::HeaderMin - 9;
@@ -435,14 +575,41 @@ void SSUData::Send(
       size = ((size >> 4) + 1) << 4;  // (/16 + 1) * 16
     fragment->len = size;
     fragments.push_back(std::unique_ptr<Fragment>(std::move(fragment)));
+    // A single-fragment packet with room to spare can double as a path-MTU
+    // probe: the same payload goes out once, padded to the candidate size
+    // (receivers ignore bytes past the last fragment). The unpadded copy
+    // encrypted below is only stored; if the probe exceeds the path MTU
+    // the resend timer delivers it at the proven size
+    bool is_probe =
+      is_last && !fragment_num && m_ProbeSize && !m_ProbeInFlight
+      && size <= m_ProbeSize;
+    if (is_probe) {
+      std::array<std::uint8_t, SSUSize::FragmentBuffer> probe_buf;
+      memcpy(probe_buf.data(), buf, size);
+      memset(probe_buf.data() + size, 0, m_ProbeSize - size);
+      m_Session.FillHeaderAndEncrypt(
+          SSUPayloadType::Data, probe_buf.data(), m_ProbeSize);
+      try {
+        m_Session.Send(probe_buf.data(), m_ProbeSize);
+        m_ProbeMsgID = msg_id;
+        m_ProbeInFlight = true;
+      } catch (const boost::system::system_error& ec) {
+        LOG(error)
+          << "SSUData:" << m_Session.GetFormattedSessionInfo()
+          << "can't send SSU MTU probe: '" << ec.what() << "'";
+        is_probe = false;  // fall through to the regular send
+      }
+    }
     // encrypt message with session key
     m_Session.FillHeaderAndEncrypt(SSUPayloadType::Data, buf, size);
-    try {
-      m_Session.Send(buf, size);
-    } catch (const boost::system::system_error& ec) {
-      LOG(error)
-        << "SSUData:" << m_Session.GetFormattedSessionInfo()
-        << "can't send SSU fragment: '" << ec.what() << "'";
+    if (!is_probe) {
+      try {
+        m_Session.Send(buf, size);
+      } catch (const boost::system::system_error& ec) {
+        LOG(error)
+          << "SSUData:" << m_Session.GetFormattedSessionInfo()
+          << "can't send SSU fragment: '" << ec.what() << "'";
+      }
     }
     if (!is_last) {
       len -= payload_size;
@@ -458,20 +625,9 @@ void SSUData::SendMsgACK(
     std::uint32_t msg_id) {
   LOG(debug)
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
-    << "sending message ACK";
-  // actual length is 44 = 37 + 7 but pad it to multiple of 16
-  std::array<std::uint8_t, 48 + 18> buf;
-  auto payload = buf.data() + SSUSize::HeaderMin;
-  *payload = SSUFlag::DataExplicitACKsIncluded;  // flag
-  payload++;
-  *payload = 1;  // number of ACKs
-  payload++;
-  *(reinterpret_cast<std::uint32_t *>(payload)) = boost::endian::native_to_big(msg_id);  // msg_id
-  payload += 4;
-  *payload = 0;  // number of fragments
-  // encrypt message with session key
-  m_Session.FillHeaderAndEncrypt(SSUPayloadType::Data, buf.data(), 48);
-  m_Session.Send(buf.data(), 48);
+    << "queueing message ACK";
+  m_PendingACKs.push_back(msg_id);
+  ScheduleACKSend();
 }
 
 void SSUData::SendFragmentACK(
@@ -479,32 +635,115 @@ void SSUData::SendFragmentACK(
     std::size_t fragment_num) {
   LOG(debug)
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
-    << "sending fragment ACK";
-  if (fragment_num > 64) {
+    << "queueing fragment ACK";
+  if (fragment_num >= 64) {
     LOG(warning)
       << "SSUData:" << m_Session.GetFormattedSessionInfo()
       << "fragment number " << fragment_num << " exceeds 64";
     return;
   }
-  std::array<std::uint8_t, 64 + 18> buf;  // TODO(unassigned): document values
-  auto payload = buf.data() + SSUSize::HeaderMin;
-  *payload = SSUFlag::DataACKBitfieldsIncluded;  // flag
-  payload++;
-  *payload = 1;  // number of ACK bitfields
-  payload++;
-  // one ack
-  *(reinterpret_cast<std::uint32_t *>(payload)) = boost::endian::native_to_big(msg_id);  // msg_id
-  payload += 4;
-  div_t d = div(fragment_num, 7);
-  memset(payload, 0x80, d.quot);  // 0x80 means non-last
-  payload += d.quot;
-  *payload = 0x01 << d.rem;  // set corresponding bit
-  payload++;
-  *payload = 0;  // number of fragments
-  auto len = d.quot < 4 ? 48 : 64;  // 48 = 37 + 7 + 4 (3+1)
-  // encrypt message with session key
-  m_Session.FillHeaderAndEncrypt(SSUPayloadType::Data, buf.data(), len);
-  m_Session.Send(buf.data(), len);
+  m_PendingFragmentACKs[msg_id] |= std::uint64_t(1) << fragment_num;
+  ScheduleACKSend();
+}
+
+void SSUData::ScheduleACKSend() {
+  // all ACKs queued within the window ride in the same data packet
+  if (m_IsACKSendScheduled)
+    return;
+  m_IsACKSendScheduled = true;
+  m_ACKSendTimer.expires_from_now(
+      boost::posix_time::milliseconds{
+          static_cast<long>(SSUDuration::ACKSendInterval)});
+  auto s = m_Session.shared_from_this();
+  m_ACKSendTimer.async_wait(
+      m_Session.GetStrand().wrap(
+      [s](const boost::system::error_code& ecode) {
+      s->m_Data.HandleACKSendTimer(ecode);
+      }));
+}
+
+void SSUData::HandleACKSendTimer(
+    const boost::system::error_code& ecode) {
+  m_IsACKSendScheduled = false;
+  if (ecode != boost::asio::error::operation_aborted)
+    FlushACKs();
+}
+
+void SSUData::FlushACKs() {
+  while (!m_PendingACKs.empty() || !m_PendingFragmentACKs.empty()) {
+    std::array<std::uint8_t, SSUSize::FragmentBuffer> buf;
+    auto payload = buf.data() + SSUSize::HeaderMin;
+    // keep room for the trailing fragment count and mod-16 padding
+    std::uint8_t* const end = buf.data() + m_PacketSize - SSUSize::IV;
+    std::uint8_t* const flag = payload;
+    *flag = 0;
+    payload++;
+    if (!m_PendingACKs.empty()) {
+      // explicit ACKs for completely received messages
+      *flag |= SSUFlag::DataExplicitACKsIncluded;
+      std::uint8_t* const num_ACKs = payload;
+      payload++;
+      std::size_t count = 0;
+      while (!m_PendingACKs.empty() && count < 0xFF && payload + 4 <= end) {
+        core::OutputByteStream::Write<std::uint32_t>(
+            payload, m_PendingACKs.back());
+        m_PendingACKs.pop_back();
+        payload += 4;
+        count++;
+      }
+      *num_ACKs = count;
+    }
+    if (!m_PendingFragmentACKs.empty() && payload + 1 < end) {
+      // ACK bitfields for partially received messages
+      *flag |= SSUFlag::DataACKBitfieldsIncluded;
+      std::uint8_t* const num_bitfields = payload;
+      payload++;
+      std::size_t count = 0;
+      for (auto it = m_PendingFragmentACKs.begin();
+          it != m_PendingFragmentACKs.end() && count < 0xFF;) {
+        std::size_t num_bytes = 1;
+        for (auto bits = it->second >> 7; bits; bits >>= 7)
+          num_bytes++;
+        if (payload + 4 + num_bytes > end)
+          break;  // next packet
+        core::OutputByteStream::Write<std::uint32_t>(payload, it->first);
+        payload += 4;
+        for (std::size_t i = 0; i < num_bytes; i++) {
+          *payload = (it->second >> (7 * i)) & 0x7F;
+          if (i + 1 < num_bytes)
+            *payload |= 0x80;  // 0x80 means non-last
+          payload++;
+        }
+        it = m_PendingFragmentACKs.erase(it);
+        count++;
+      }
+      *num_bitfields = count;
+    }
+    *payload = 0;  // number of fragments
+    payload++;
+    std::size_t len = payload - buf.data();
+    if (len & 0x0F)  // make sure 16 bytes boundary
+      len = ((len >> 4) + 1) << 4;  // (/16 + 1) * 16
+    // encrypt message with session key
+    m_Session.FillHeaderAndEncrypt(SSUPayloadType::Data, buf.data(), len);
+    try {
+      m_Session.Send(buf.data(), len);
+    } catch (const boost::system::system_error& ec) {
+      LOG(error)
+        << "SSUData:" << m_Session.GetFormattedSessionInfo()
+        << "can't send SSU ACKs: '" << ec.what() << "'";
+      return;
+    }
+  }
+}
+
+std::uint64_t SSUData::GetResendTimeout() const {
+  const std::uint64_t interval = SSUDuration::ResendInterval * 1000;
+  if (!m_RTT)
+    return interval;  // no sample yet: legacy fixed interval
+  return std::min(
+      interval,
+      std::max<std::uint64_t>(2 * m_RTT, SSUDuration::MinResendTimeout));
 }
 
 void SSUData::ScheduleResend() {
@@ -512,14 +751,28 @@ void SSUData::ScheduleResend() {
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
     << "scheduling resend";
   m_ResendTimer.cancel();
+  // wake at the earliest deadline instead of a fixed coarse tick, so an
+  // RTT-scaled timeout actually fires at RTT scale
+  std::uint64_t delay = SSUDuration::ResendInterval * 1000;
+  if (!m_SentMessages.empty()) {
+    const auto ts = kovri::core::GetMillisecondsSinceEpoch();
+    auto next_due = std::numeric_limits<std::uint64_t>::max();
+    for (const auto& sent : m_SentMessages)
+      next_due = std::min(next_due, sent.second->next_resend_time);
+    delay = std::min<std::uint64_t>(
+        delay,
+        std::max<std::uint64_t>(
+            next_due > ts ? next_due - ts : 0,
+            SSUDuration::MinResendTimeout));
+  }
   m_ResendTimer.expires_from_now(
-      boost::posix_time::seconds{
-        static_cast<long>(SSUDuration::ResendInterval)});
+      boost::posix_time::milliseconds{static_cast<long>(delay)});
   auto s = m_Session.shared_from_this();
   m_ResendTimer.async_wait(
+      m_Session.GetStrand().wrap(
       [s](const boost::system::error_code& ecode) {
       s->m_Data.HandleResendTimer(ecode);
-      });
+      }));
 }
 
 void SSUData::HandleResendTimer(
@@ -528,23 +781,19 @@ void SSUData::HandleResendTimer(
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
     << "handling resend timer";
   if (ecode != boost::asio::error::operation_aborted) {
-    auto ts = kovri::core::GetSecondsSinceEpoch();
+    auto ts = kovri::core::GetMillisecondsSinceEpoch();
+    bool peer_dead = false;
     for (auto it = m_SentMessages.begin(); it != m_SentMessages.end();) {
       if (ts >= it->second->next_resend_time) {
+        if (m_ProbeInFlight && it->first == m_ProbeMsgID) {
+          // the padded probe was not ACKed in time; the unpadded fragment
+          // resent below still delivers the message. A random loss counts
+          // as failure too, but the periodic re-probe heals that
+          m_ProbeInFlight = false;
+          HandleMTUProbeResult(false);
+        }
         if (it->second->num_resends < SSUDuration::MaxResends) {
-          for (auto& fragment : it->second->fragments)
-            if (fragment) {
-              try {
-                m_Session.Send(fragment->buffer.data(), fragment->len);  // resend
-              } catch (const boost::system::system_error& ec) {
-                LOG(error)
-                  << "SSUData:" << m_Session.GetFormattedSessionInfo()
-                  << "can't resend SSU fragment: '" << ec.what() << "'";
-              }
-            }
-          it->second->num_resends++;
-          it->second->next_resend_time
-             += it->second->num_resends * SSUDuration::ResendInterval;
+          ResendMissingFragments(*it->second, ts);
           it++;
         } else {
           LOG(warning)
@@ -552,15 +801,42 @@ void SSUData::HandleResendTimer(
             << "SSU message has not been ACKed after "
             << static_cast<std::size_t>(SSUDuration::MaxResends) << " attempts. Deleted";
           it = m_SentMessages.erase(it);
+          peer_dead = true;
         }
       } else {
         it++;
       }
     }
+    if (peer_dead && m_Session.GetState() == SessionState::Established) {
+      // every RTT-scaled resend went unanswered: the peer is a black
+      // hole. Fail the session now instead of letting further traffic
+      // queue against it until the idle timeout expires
+      transports.PeerFailed(m_Session.GetRemoteIdentity().GetIdentHash());
+      m_Session.Done();
+      return;
+    }
     ScheduleResend();
   }
 }
 
+void SSUData::ResendMissingFragments(
+    SentMessage& msg,
+    std::uint64_t ts) {
+  for (auto& fragment : msg.fragments)
+    if (fragment) {
+      try {
+        m_Session.Send(fragment->buffer.data(), fragment->len);  // resend
+      } catch (const boost::system::system_error& ec) {
+        LOG(error)
+          << "SSUData:" << m_Session.GetFormattedSessionInfo()
+          << "can't resend SSU fragment: '" << ec.what() << "'";
+      }
+    }
+  msg.num_resends++;
+  msg.send_time = ts;
+  msg.next_resend_time = ts + msg.num_resends * GetResendTimeout();
+}
+
 void SSUData::ScheduleDecay() {
   LOG(debug)
     << "SSUData:" << m_Session.GetFormattedSessionInfo() << "scheduling decay";
@@ -570,9 +846,10 @@ void SSUData::ScheduleDecay() {
           static_cast<long>(SSUDuration::DecayInterval)});
   auto s = m_Session.shared_from_this();
   m_ResendTimer.async_wait(
+      m_Session.GetStrand().wrap(
       [s](const boost::system::error_code& ecode) {
       s->m_Data.HandleDecayTimer(ecode);
-      });
+      }));
 }
 
 void SSUData::HandleDecayTimer(
@@ -594,9 +871,10 @@ void SSUData::ScheduleIncompleteMessagesCleanup() {
           static_cast<long>(SSUDuration::IncompleteMessagesCleanupTimeout)});
   auto s = m_Session.shared_from_this();
   m_IncompleteMessagesCleanupTimer.async_wait(
+      m_Session.GetStrand().wrap(
       [s](const boost::system::error_code& ecode) {
       s->m_Data.HandleIncompleteMessagesCleanupTimer(ecode);
-      });
+      }));
 }
 
 void SSUData::HandleIncompleteMessagesCleanupTimer(
@@ -37,9 +37,10 @@
 
 #include <array>
 #include <cstdint>
-#include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "core/router/i2np.h"
@@ -56,6 +57,9 @@ namespace core {
 enum SSUDuration : std::uint16_t
 {
   ResendInterval = 3,  // Seconds
+  MinResendTimeout = 250,  // Milliseconds; RTO floor when scaling by RTT
+  FastRetransmitThreshold = 3,  // Bitfield sightings of a gap before early resend
+  ACKSendInterval = 10,  // Milliseconds; window for coalescing ACKs per packet
   MaxResends = 5,
   DecayInterval = 20,  // Number of message IDs we store for duplicates check
   IncompleteMessagesCleanupTimeout = 30,  // Seconds
@@ -64,6 +68,8 @@ enum SSUDuration : std::uint16_t
   KeepAliveInterval = 30,  // Seconds
   PeerTestTimeout = 60,  // Seconds
   ToIntroducerSessionDuration = 3600,  // 1 hour
+  MTUReprobeInterval = 600,  // Seconds; revalidate the discovered path MTU
+  IntroducerCacheDuration = 1200,  // Seconds; remember working introducers per peer
 };
 
 struct Fragment {
@@ -112,8 +118,12 @@ struct IncompleteMessage {
 
 struct SentMessage {
   std::vector<std::unique_ptr<Fragment>> fragments;
-  std::uint32_t next_resend_time;  // in seconds
+  std::uint64_t next_resend_time;  // in milliseconds
+  std::uint64_t send_time;  // in milliseconds; last (re)send, for RTT sampling
   std::size_t num_resends;
+  // bitfield-ACK sightings that left an earlier fragment missing behind an
+  // ACKed later one; reaching the threshold triggers an early resend
+  std::size_t dup_ack_evidence;
 };
 
 class SSUSession;
@@ -148,6 +158,13 @@ class SSUData : public RouterInfoTraits {
       std::uint32_t msg_id,
       std::size_t fragment_num);
 
+  void ScheduleACKSend();
+
+  void HandleACKSendTimer(
+      const boost::system::error_code& ecode);
+
+  void FlushACKs();
+
   void ProcessACKs(
       std::uint8_t*& buf,
       std::uint8_t flag);
@@ -158,6 +175,17 @@ class SSUData : public RouterInfoTraits {
   void ProcessSentMessageACK(
       std::uint32_t msg_id);
 
+  /// @brief Resends every not-yet-ACKed fragment of the message and pushes
+  ///   its resend deadline out by the (backed-off) resend timeout
+  void ResendMissingFragments(
+      SentMessage& msg,
+      std::uint64_t ts);
+
+  /// @return Resend timeout in milliseconds: twice the smoothed session
+  ///   RTT once measured (floored at MinResendTimeout), the legacy fixed
+  ///   interval before the first sample
+  std::uint64_t GetResendTimeout() const;
+
   void ScheduleResend();
 
   void HandleResendTimer(
@@ -176,14 +204,48 @@ class SSUData : public RouterInfoTraits {
   void AdjustPacketSize(
       const kovri::core::RouterInfo& remoteRouter);
 
+  /// @brief Smallest packet size any conforming path must carry
+  ///   (minimum SSU MTU less IP and UDP headers)
+  std::size_t MinPacketSize() const;
+
+  /// @brief Arms a fresh probe of the full [min, max] packet size range.
+  ///   Probes ride outgoing single-fragment data packets as padding, so
+  ///   the search advances only while the session carries traffic
+  void StartMTUProbe();
+
+  /// @brief Advances the binary search after a probe was ACKed (success)
+  ///   or had to be resent (failure) and applies validated sizes
+  void HandleMTUProbeResult(
+      bool success);
+
+  void ScheduleMTUReprobe();
+
+  void HandleMTUReprobeTimer(
+      const boost::system::error_code& ecode);
+
  private:
   SSUSession& m_Session;
-  std::map<std::uint32_t, std::unique_ptr<IncompleteMessage>> m_IncompleteMessages;
-  std::map<std::uint32_t, std::unique_ptr<SentMessage>> m_SentMessages;
-  std::set<std::uint32_t> m_ReceivedMessages;
+  std::unordered_map<std::uint32_t, std::unique_ptr<IncompleteMessage>> m_IncompleteMessages;
+  std::unordered_map<std::uint32_t, std::unique_ptr<SentMessage>> m_SentMessages;
+  std::unordered_set<std::uint32_t> m_ReceivedMessages;
+  // ACKs queued for the next delayed-ACK packet: complete message IDs, and
+  // per-message bitmasks of individually received fragments
+  std::vector<std::uint32_t> m_PendingACKs;
+  std::unordered_map<std::uint32_t, std::uint64_t> m_PendingFragmentACKs;
+  bool m_IsACKSendScheduled;
   boost::asio::deadline_timer m_ResendTimer, m_DecayTimer,
-                              m_IncompleteMessagesCleanupTimer;
+                              m_IncompleteMessagesCleanupTimer, m_ACKSendTimer,
+                              m_MTUReprobeTimer;
   std::size_t m_MaxPacketSize, m_PacketSize;
+  // Path-MTU search bounds and the candidate size under test (0 when the
+  // search has converged); the probe is a regular data packet padded to
+  // m_ProbeSize, identified by its message ID
+  std::size_t m_ProbeLow, m_ProbeHigh, m_ProbeSize;
+  std::uint32_t m_ProbeMsgID;
+  bool m_ProbeInFlight;
+  // smoothed session RTT in milliseconds, 0 until the first sample; only
+  // never-retransmitted messages contribute (Karn's rule)
+  std::uint64_t m_RTT;
   kovri::core::I2NPMessagesHandler m_Handler;
 };
 
@@ -89,14 +89,11 @@ SSUPacketParser::SSUPacketParser(
     const std::size_t len)
     : InputByteStream(data, len) {}
 
-SSUFragment SSUPacketParser::ParseFragment()
+bool SSUPacketParser::ParseFragment(SSUFragment& fragment)
 {
-  // Patch for #823 so we can keep running with assertions
   if (gcount() < 4 /* message ID */ + 3 /* fragment info */)
-    throw std::length_error(
-        "SSUPacketParser: invalid packet size, fragment unavailable");
+    return false;
 
-  SSUFragment fragment;
   fragment.set_msg_id(Read<std::uint32_t>());
 
   // TODO(unassigned): we should not setup a 4 byte array to parse 3 bytes
@@ -111,43 +108,58 @@ SSUFragment SSUPacketParser::ParseFragment()
 
   std::uint16_t const frag_size = fragment.get_size();
 
-  // End session if fragmented size is greater than buffer size
+  // Reject if fragmented size is greater than buffer size
   if (frag_size > gcount())
     {
       // TODO(anonimal): invalid size could be an implementation issue rather
       //   than an attack. Reconsider how we mitigate invalid fragment size.
-      throw std::length_error("SSUPacketParser: invalid fragment size");
+      return false;
     }
 
   // Don't read if purported size is 0
   if (frag_size)
     fragment.set_data(ReadBytes(frag_size));
 
-  return fragment;
+  return true;
 }
 
+// NOTE: malformed input is routine on the open network, so the parsers
+// below validate every length up front and report garbage with a null
+// return (a predicted branch) instead of throwing through the transport
+// thread; exceptions stay at the session boundary for the unexpected
 std::unique_ptr<SSUHeader> SSUPacketParser::ParseHeader() {
   if (m_Length < SSUSize::HeaderMin)
-    throw std::length_error("SSU header too small");
+    return nullptr;
   auto header = std::make_unique<SSUHeader>();
   // Set MAC and IV
   header->set_mac(ReadBytes(SSUSize::MAC));
   header->set_iv(ReadBytes(SSUSize::IV));
-  // Extract information from flag (payload type and rekey/extened options)
-  const std::uint8_t flag = Read<std::uint8_t>();
+  // Extract flag (payload type and rekey/extended options) and time in
+  // one fixed-layout read: covered by the HeaderMin check above
+  std::uint8_t flag;
+  std::uint32_t time;
+  if (!ReadFixed(flag, time))
+    return nullptr;
   header->set_rekey(flag & SSUFlag::Rekey);
   header->set_ext_opts(flag & SSUFlag::ExtendedOptions);
+  if ((flag >> 4) > static_cast<std::uint8_t>(SSUPayloadType::SessionDestroyed))
+    return nullptr;  // set_payload_type would reject it with a throw
   header->set_payload_type(flag >> 4);
-  // Extract the time
-  header->set_time(Read<std::uint32_t>());
+  header->set_time(time);
   if (header->has_rekey()) {
     // TODO(EinMByte): Actually do something with the data
     // TODO(EinMByte): See issue #119, for some reason some rekey options
     //                 are sometimes set?
+    if (gcount() < SSUSize::KeyingMaterial)
+      return nullptr;
     SkipBytes(SSUSize::KeyingMaterial);
   }
   if (header->has_ext_opts()) {
+    if (!gcount())
+      return nullptr;
     const std::size_t options_size = Read<std::uint8_t>();
+    if (gcount() < options_size)
+      return nullptr;
     header->set_ext_opts_data(ReadBytes(options_size), options_size);
   }
   return header;
@@ -155,6 +167,8 @@ std::unique_ptr<SSUHeader> SSUPacketParser::ParseHeader() {
 
 std::unique_ptr<SSUPacket> SSUPacketParser::ParsePacket() {
   m_Header = ParseHeader();
+  if (!m_Header)
+    return nullptr;
   std::unique_ptr<SSUPacket> packet;
   std::uint8_t* const old_data = m_DataPtr;
   const std::size_t old_length = m_Length;
@@ -188,8 +202,11 @@ std::unique_ptr<SSUPacket> SSUPacketParser::ParsePacket() {
       break;
     case SSUPayloadType::Unknown:
     default:
-      throw std::runtime_error("SSUPacketParser: unknown payload type");
+      LOG(warning) << "SSUPacketParser: unknown payload type";
+      return nullptr;
   }
+  if (!packet)
+    return nullptr;
   // TODO(EinMByte): Get rid of this
   packet->m_RawDataLength = old_length;
   packet->m_RawData = old_data;
@@ -198,50 +215,76 @@ std::unique_ptr<SSUPacket> SSUPacketParser::ParsePacket() {
 }
 
 std::unique_ptr<SSUSessionRequestPacket> SSUPacketParser::ParseSessionRequest() {
+  if (gcount() < SSUSize::DHPublic + 1)
+    return nullptr;
   auto packet = std::make_unique<SSUSessionRequestPacket>();
   packet->set_dh_x(ReadBytes(SSUSize::DHPublic));
   std::uint8_t const size = Read<std::uint8_t>();
+  if (gcount() < size)
+    return nullptr;
   packet->set_ip(ReadBytes(size), size);
   return packet;
 }
 
 std::unique_ptr<SSUSessionCreatedPacket> SSUPacketParser::ParseSessionCreated() {
+  if (gcount() < SSUSize::DHPublic + 1)
+    return nullptr;
   auto packet = std::make_unique<SSUSessionCreatedPacket>();
   packet->set_dh_y(ReadBytes(SSUSize::DHPublic));
   std::uint8_t const address_size = Read<std::uint8_t>();
+  if (gcount() < address_size + 2u /* port */ + 4 /* tag */ + 4 /* time */)
+    return nullptr;
   packet->set_ip(ReadBytes(address_size), address_size);
-  packet->set_port(Read<std::uint16_t>());
-  packet->set_relay_tag(Read<std::uint32_t>());
-  packet->set_time(Read<std::uint32_t>());
+  // port, relay tag and time are a fixed layout: read unchecked
+  std::uint16_t port;
+  std::uint32_t relay_tag, time;
+  ReadFixed(port, relay_tag, time);
+  packet->set_port(port);
+  packet->set_relay_tag(relay_tag);
+  packet->set_time(time);
   packet->set_sig(m_DataPtr, m_Length);
   return packet;
 }
 
 std::unique_ptr<SSUSessionConfirmedPacket> SSUPacketParser::ParseSessionConfirmed() {
   const std::size_t init_length = m_Length;
+  if (gcount() < 1 /* info */ + 2 /* identity size */)
+    return nullptr;
   auto packet = std::make_unique<SSUSessionConfirmedPacket>();
   SkipBytes(1);  // Info byte
   std::uint16_t identity_size = Read<std::uint16_t>();
+  if (gcount() < identity_size)
+    return nullptr;
   kovri::core::IdentityEx identity;
   if (!identity.FromBuffer(ReadBytes(identity_size), identity_size))
-    throw std::length_error("SSUPacketParser: invalid length within identity");
+    return nullptr;
   packet->set_remote_ident(identity);
+  if (gcount() < 4 /* time */)
+    return nullptr;
   packet->set_time(Read<std::uint32_t>());
   const std::size_t padding_size = SSUPacketBuilder::get_padding_size(
       m_Header->get_size() + init_length - m_Length
       + identity.GetSignatureLen());
+  if (gcount() < padding_size + identity.GetSignatureLen())
+    return nullptr;
   SkipBytes(padding_size);  // Padding
   packet->set_sig(m_DataPtr);
   return packet;
 }
 
 std::unique_ptr<SSURelayRequestPacket> SSUPacketParser::ParseRelayRequest() {
+  if (gcount() < 4 /* relay tag */ + 1)
+    return nullptr;
   auto packet = std::make_unique<SSURelayRequestPacket>();
   packet->set_relay_tag(Read<std::uint32_t>());
   std::uint8_t const address_size = Read<std::uint8_t>();
+  if (gcount() < address_size + 2u /* port */ + 1 /* challenge size */)
+    return nullptr;
   packet->set_ip(ReadBytes(address_size), address_size);
   packet->set_port(Read<std::uint16_t>());
   const std::size_t challenge_size = Read<std::uint8_t>();
+  if (gcount() < challenge_size + SSUSize::IntroKey + 4 /* nonce */)
+    return nullptr;
   packet->set_challenge(ReadBytes(challenge_size), challenge_size);
   packet->set_intro_key(ReadBytes(SSUSize::IntroKey));
   packet->set_nonce(Read<std::uint32_t>());
@@ -249,11 +292,17 @@ std::unique_ptr<SSURelayRequestPacket> SSUPacketParser::ParseRelayRequest() {
 }
 
 std::unique_ptr<SSURelayResponsePacket> SSUPacketParser::ParseRelayResponse() {
+  if (gcount() < 1)
+    return nullptr;
   auto packet = std::make_unique<SSURelayResponsePacket>();
   std::uint8_t const charlie_address_size = Read<std::uint8_t>();
+  if (gcount() < charlie_address_size + 2u /* port */ + 1 /* address size */)
+    return nullptr;
   packet->set_charlie_ip(ReadBytes(charlie_address_size), charlie_address_size);
   packet->set_charlie_port(Read<std::uint16_t>());
   std::uint8_t const alice_address_size = Read<std::uint8_t>();
+  if (gcount() < alice_address_size + 2u /* port */ + 4 /* nonce */)
+    return nullptr;
   packet->set_alice_ip(ReadBytes(alice_address_size), alice_address_size);
   packet->set_alice_port(Read<std::uint16_t>());
   packet->set_nonce(Read<std::uint32_t>());
@@ -261,51 +310,88 @@ std::unique_ptr<SSURelayResponsePacket> SSUPacketParser::ParseRelayResponse() {
 }
 
 std::unique_ptr<SSURelayIntroPacket> SSUPacketParser::ParseRelayIntro() {
+  if (gcount() < 1)
+    return nullptr;
   auto packet = std::make_unique<SSURelayIntroPacket>();
   std::uint8_t const address_size = Read<std::uint8_t>();
+  if (gcount() < address_size + 2u /* port */ + 1 /* challenge size */)
+    return nullptr;
   packet->set_ip(ReadBytes(address_size), address_size);
   packet->set_port(Read<std::uint16_t>());
   const std::size_t challenge_size = Read<std::uint8_t>();
+  if (gcount() < challenge_size)
+    return nullptr;
   packet->set_challenge(ReadBytes(challenge_size), challenge_size);
   return packet;
 }
 
 std::unique_ptr<SSUDataPacket> SSUPacketParser::ParseData() {
+  if (gcount() < 1 /* flags */)
+    return nullptr;
   auto packet = std::make_unique<SSUDataPacket>();
   const std::uint8_t flags = Read<std::uint8_t>();
   // Read ACKS
   if (flags & SSUFlag::DataExplicitACKsIncluded) {
+    if (gcount() < 1)
+      return nullptr;
     const std::size_t nb_explicit_ACKs = Read<std::uint8_t>();
+    if (gcount() < nb_explicit_ACKs * 4)
+      return nullptr;
     for(std::size_t i = 0; i < nb_explicit_ACKs; ++i)
       packet->AddExplicitACK(Read<std::uint32_t>());
   }
   // Read ACK bifields
   if (flags & SSUFlag::DataACKBitfieldsIncluded) {
+    if (gcount() < 1)
+      return nullptr;
     const std::size_t nb_ACKs = Read<std::uint8_t>();
+    if (gcount() < nb_ACKs * 4)
+      return nullptr;
     // Read message IDs
     for (std::size_t i = 0; i < nb_ACKs; ++i)
       packet->AddACK(Read<std::uint32_t>());
     // Read bitfields
     std::uint8_t bitfield;
     do {
+      if (!gcount())
+        return nullptr;
       bitfield = Read<std::uint8_t>();
       packet->AddACKBitfield(bitfield);
     } while (bitfield & SSUFlag::DataACKBitFieldHasNext);
   }
   // Ignore possible extended data
-  if (flags & SSUFlag::DataExtendedIncluded)
-    SkipBytes(Read<std::uint8_t>());
+  if (flags & SSUFlag::DataExtendedIncluded) {
+    if (!gcount())
+      return nullptr;
+    const std::size_t extended_size = Read<std::uint8_t>();
+    if (gcount() < extended_size)
+      return nullptr;
+    SkipBytes(extended_size);
+  }
+  if (gcount() < 1 /* fragment count */)
+    return nullptr;
   const std::size_t nb_flags = Read<std::uint8_t>();
   // Read fragments
-  for(std::size_t i = 0; i < nb_flags; ++i)
-    packet->AddFragment(ParseFragment());
+  for(std::size_t i = 0; i < nb_flags; ++i) {
+    SSUFragment fragment;
+    if (!ParseFragment(fragment))
+      return nullptr;
+    packet->AddFragment(fragment);
+  }
   return packet;
 }
 
 std::unique_ptr<SSUPeerTestPacket> SSUPacketParser::ParsePeerTest() {
+  if (gcount() < 4 /* nonce */ + 1 /* address size */)
+    return nullptr;
   auto packet = std::make_unique<SSUPeerTestPacket>();
   packet->set_nonce(Read<std::uint32_t>());
   std::uint8_t const size(Read<std::uint8_t>());
+  // only none (Alice), IPv4 or IPv6 are meaningful address sizes
+  if (size && size != 4 && size != 16)
+    return nullptr;
+  if (gcount() < size + 2u /* port */ + SSUSize::IntroKey)
+    return nullptr;
   if (size)  // Bob or Charlie
     packet->set_ip(core::BytesToAddress(ReadBytes(size), size));
   packet->set_ip_size(size);
@@ -334,8 +420,7 @@ void SSUPacketBuilder::WriteHeader(SSUHeader* header) {
       (header->get_payload_type() << 4) +
       (header->has_rekey() << 3) +
       (header->has_ext_opts() << 2);
-  Write<std::uint8_t>(flag);
-  Write<std::uint32_t>(header->get_time());
+  WriteFixed(flag, header->get_time());
   if (header->has_ext_opts()) {
     Write<std::uint8_t>(header->get_ext_opts_size());
     WriteData(
@@ -354,9 +439,7 @@ void SSUPacketBuilder::WriteSessionCreated(SSUSessionCreatedPacket* packet) {
   WriteData(packet->get_dh_y(), SSUSize::DHPublic);
   Write<std::uint8_t>(packet->get_ip_size());
   WriteData(packet->get_ip(), packet->get_ip_size());
-  Write<std::uint16_t>(packet->get_port());
-  Write<std::uint32_t>(packet->get_relay_tag());
-  Write<std::uint32_t>(packet->get_time());
+  WriteFixed(packet->get_port(), packet->get_relay_tag(), packet->get_time());
   WriteData(packet->get_sig(), packet->get_sig_size());
 }
 
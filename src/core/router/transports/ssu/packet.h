@@ -64,6 +64,10 @@ enum SSUSize : std::uint16_t
       + BufferMargin,
   KeyingMaterial = 64,
   DHPublic = 256,
+  // Signed session dataset (X + Y + addresses + ports + tag + time), both hosts IPv6
+  MaxExchangedData = DHPublic * 2 + 16 * 2 + 2 + 2 + 4 + 4,
+  // Largest supported signature (RSASHA5124096) plus non-mod-16 padding
+  MaxSignature = 512 + IV,
   MaxReceivedMessages = 1000,  // TODO(unassigned): research this value
   MaxIntroducers = 3,
   // Session buffer sizes imply *before* non-mod-16 padding. See SSU spec.
@@ -1102,13 +1106,13 @@ class SSUPacketParser : private kovri::core::InputByteStream {
   SSUPacketParser(std::uint8_t* data, const std::size_t len);
 
   /// @brief Parses an SSU header.
-  /// @return a pointer to the newly constructed SSUHeader object
-  /// @throw std::length_error if the buffer contains less data than the
-  ///    minimum SSU header size
+  /// @return a pointer to the newly constructed SSUHeader object,
+  ///    or nullptr if the buffer is too short or otherwise malformed
   std::unique_ptr<SSUHeader> ParseHeader();
 
   /// @brief Parses an SSUPacket, including the header
-  /// @return a pointer to the newly constructed SSUPacket object
+  /// @return a pointer to the newly constructed SSUPacket object,
+  ///    or nullptr if the packet is malformed
   std::unique_ptr<SSUPacket> ParsePacket();
 
   /// @brief Parses a session request packet, without the header
@@ -1141,8 +1145,9 @@ class SSUPacketParser : private kovri::core::InputByteStream {
 
  private:
   /// @brief Parses data fragment
-  /// @return A parsed data fragment
-  SSUFragment ParseFragment();
+  /// @param fragment Fragment to fill in
+  /// @return false if the buffer is too short for the fragment
+  bool ParseFragment(SSUFragment& fragment);
 
   /// @brief Parsed header
   std::unique_ptr<SSUHeader> m_Header;
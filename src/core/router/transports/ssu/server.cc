@@ -34,7 +34,15 @@
 
 #include <boost/bind.hpp>
 
+#ifdef __linux__
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
 #include <array>
+#include <cstring>
+#include <mutex>
+#include <vector>
 
 #include "core/crypto/rand.h"
 
@@ -46,9 +54,43 @@
 
 namespace kovri {
 namespace core {
+
+namespace {
+/// @brief Freelist of packet-sized blocks shared by receive and
+///   processing threads; the critical section is a pointer push/pop
+std::mutex g_PacketPoolMutex;
+std::vector<void*> g_PacketPool;
+/// @brief Cap on retained blocks (~1.5MB), sized for receive bursts
+const std::size_t MaxPooledPackets = 1024;
+}  // namespace
+
+void* RawSSUPacket::operator new(std::size_t size) {
+  if (size == sizeof(RawSSUPacket)) {
+    std::lock_guard<std::mutex> l(g_PacketPoolMutex);
+    if (!g_PacketPool.empty()) {
+      void* entry = g_PacketPool.back();
+      g_PacketPool.pop_back();
+      return entry;
+    }
+  }
+  return ::operator new(size);
+}
+
+void RawSSUPacket::operator delete(void* entry) {
+  {
+    std::lock_guard<std::mutex> l(g_PacketPoolMutex);
+    if (g_PacketPool.size() < MaxPooledPackets) {
+      g_PacketPool.push_back(entry);
+      return;
+    }
+  }
+  ::operator delete(entry);
+}
+
 SSUServer::SSUServer(boost::asio::io_service& service, const std::size_t port)
     : m_Exception(__func__),
       m_Service(service),
+      m_Strand(service),
       m_Endpoint(boost::asio::ip::udp::v4(), port),
       m_EndpointV6(boost::asio::ip::udp::v6(), port),
       m_Socket(m_Service, m_Endpoint),
@@ -73,12 +115,12 @@ SSUServer::~SSUServer() {}
 void SSUServer::Start() {
   LOG(debug) << "SSUServer: starting";
   m_IsRunning = true;
-  m_Service.post(
+  m_Strand.post(
       std::bind(
           &SSUServer::Receive,
           this));
   if (context.SupportsV6()) {
-    m_Service.post(
+    m_Strand.post(
         std::bind(
             &SSUServer::ReceiveV6,
             this));
@@ -113,6 +155,50 @@ std::shared_ptr<SSUSession> SSUServer::FindRelaySession(const std::uint32_t tag)
   return nullptr;
 }
 
+bool SSUServer::GetCachedIntroducer(
+    const kovri::core::IdentHash& ident,
+    kovri::core::RouterInfo::Introducer& introducer)
+{
+  std::unique_lock<std::mutex> l(m_IntroducerCacheMutex);
+  auto it = m_IntroducerCache.find(ident);
+  if (it == m_IntroducerCache.end())
+    return false;
+  if (it->second.expiration_time < kovri::core::GetMillisecondsSinceEpoch()) {
+    m_IntroducerCache.erase(it);
+    return false;
+  }
+  introducer = it->second.introducer;
+  return true;
+}
+
+void SSUServer::CacheIntroducer(
+    const kovri::core::IdentHash& ident,
+    const kovri::core::RouterInfo::Introducer& introducer)
+{
+  std::unique_lock<std::mutex> l(m_IntroducerCacheMutex);
+  auto& cached = m_IntroducerCache[ident];
+  cached.introducer = introducer;
+  cached.expiration_time =
+      kovri::core::GetMillisecondsSinceEpoch()
+      + SSUDuration::IntroducerCacheDuration * 1000;
+}
+
+void SSUServer::ConfirmCachedIntroducer(const kovri::core::IdentHash& ident)
+{
+  std::unique_lock<std::mutex> l(m_IntroducerCacheMutex);
+  auto it = m_IntroducerCache.find(ident);
+  if (it != m_IntroducerCache.end())
+    it->second.expiration_time =
+        kovri::core::GetMillisecondsSinceEpoch()
+        + SSUDuration::IntroducerCacheDuration * 1000;
+}
+
+void SSUServer::RemoveCachedIntroducer(const kovri::core::IdentHash& ident)
+{
+  std::unique_lock<std::mutex> l(m_IntroducerCacheMutex);
+  m_IntroducerCache.erase(ident);
+}
+
 void SSUServer::Send(
     const std::uint8_t* buf,
     const std::size_t len,
@@ -148,6 +234,8 @@ void SSUServer::Receive()
   m_Socket.async_receive_from(
       boost::asio::buffer(packet->buf, SSUSize::MTUv4),
       packet->from,
+      // not strand-wrapped: ordering holds with one outstanding receive
+      // per socket and processing is posted through the strand
       std::bind(
           &SSUServer::HandleReceivedFrom,
           this,
@@ -175,6 +263,7 @@ void SSUServer::ReceiveV6()
   m_SocketV6.async_receive_from(
       boost::asio::buffer(packet->buf, SSUSize::MTUv6),
       packet->from,
+      // see Receive() regarding strand wrapping
       std::bind(
           &SSUServer::HandleReceivedFromV6,
           this,
@@ -189,6 +278,129 @@ void SSUServer::ReceiveV6()
               ));
 }
 
+void SSUServer::DrainReceivedPackets(
+    boost::asio::ip::udp::socket& socket,
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+    std::vector<std::unique_ptr<RawSSUPacket>>& packets,
+#else
+    std::vector<RawSSUPacket*>& packets,
+#endif
+    const std::size_t mtu)
+{
+  try
+    {
+#ifdef __linux__
+      // Fast path: one recvmmsg syscall pulls every queued datagram,
+      // instead of one syscall (plus one available()) per packet
+      while (packets.size() < Batch::MaxPackets)
+        {
+          const std::size_t room = Batch::MaxPackets - packets.size();
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+          std::vector<std::unique_ptr<RawSSUPacket>> slots;
+#else
+          std::vector<RawSSUPacket*> slots;
+#endif
+          std::vector<struct mmsghdr> headers(room);
+          std::vector<struct iovec> iovecs(room);
+          std::vector<struct sockaddr_storage> addresses(room);
+          std::memset(headers.data(), 0, room * sizeof(struct mmsghdr));
+          for (std::size_t i = 0; i < room; i++)
+            {
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+              slots.push_back(std::make_unique<RawSSUPacket>());
+#else
+              slots.push_back(new RawSSUPacket());
+#endif
+              iovecs[i].iov_base = static_cast<std::uint8_t*>(slots[i]->buf);
+              iovecs[i].iov_len = mtu;
+              headers[i].msg_hdr.msg_iov = &iovecs[i];
+              headers[i].msg_hdr.msg_iovlen = 1;
+              headers[i].msg_hdr.msg_name = &addresses[i];
+              headers[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+            }
+          const int count = recvmmsg(
+              socket.native_handle(),
+              headers.data(),
+              room,
+              MSG_DONTWAIT,
+              nullptr);
+          if (count <= 0)
+            {
+#if (BOOST_VERSION < 106600)
+              for (auto* slot : slots)
+                delete slot;  // free unused slots, now
+#endif
+              break;  // nothing queued (EAGAIN) or error: async path resumes
+            }
+          for (int i = 0; i < count; i++)
+            {
+              slots[i]->len = headers[i].msg_len;
+              const auto* storage = &addresses[i];
+              if (storage->ss_family == AF_INET6)
+                {
+                  const auto* v6 =
+                      reinterpret_cast<const struct sockaddr_in6*>(storage);
+                  boost::asio::ip::address_v6::bytes_type bytes;
+                  std::memcpy(
+                      bytes.data(), v6->sin6_addr.s6_addr, bytes.size());
+                  slots[i]->from = boost::asio::ip::udp::endpoint(
+                      boost::asio::ip::address_v6(bytes, v6->sin6_scope_id),
+                      ntohs(v6->sin6_port));
+                }
+              else
+                {
+                  const auto* v4 =
+                      reinterpret_cast<const struct sockaddr_in*>(storage);
+                  slots[i]->from = boost::asio::ip::udp::endpoint(
+                      boost::asio::ip::address_v4(ntohl(v4->sin_addr.s_addr)),
+                      ntohs(v4->sin_port));
+                }
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+              packets.push_back(std::move(slots[i]));
+#else
+              packets.push_back(slots[i]);
+              slots[i] = nullptr;
+#endif
+            }
+#if (BOOST_VERSION < 106600)
+          for (auto* slot : slots)
+            delete slot;  // free unused slots, now
+#endif
+          if (static_cast<std::size_t>(count) < room)
+            break;  // drained the queue
+        }
+#else
+      std::size_t more_bytes = socket.available();
+      while (more_bytes && packets.size() < Batch::MaxPackets)
+        {
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+          auto pkt = std::make_unique<RawSSUPacket>();
+#else
+          RawSSUPacket* pkt = new RawSSUPacket();
+#endif
+          pkt->len = socket.receive_from(
+              boost::asio::buffer(pkt->buf, mtu), pkt->from);
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+          packets.push_back(std::move(pkt));
+#else
+          packets.push_back(pkt);
+#endif
+          more_bytes = socket.available();
+        }
+#endif  // __linux__
+    }
+  catch (...)
+    {
+      m_Exception.Dispatch(__func__);
+    }
+}
+
 // coverity[+free : arg-2]
 void SSUServer::HandleReceivedFrom(
     const boost::system::error_code& ecode,
@@ -213,29 +425,10 @@ void SSUServer::HandleReceivedFrom(
       std::vector<RawSSUPacket*> packets;
       packets.push_back(packet);
 #endif
-      boost::system::error_code ec;
-      std::size_t more_bytes = m_Socket.available(ec);
       // TODO(anonimal): but what about 0 length HolePunch?
       //   Current handler's null length check done in vain?
-      while (more_bytes && packets.size() < 25)
-        {
-// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
-#if (BOOST_VERSION >= 106600)
-          auto pkt = std::make_unique<RawSSUPacket>();
-#else
-          RawSSUPacket* pkt = new RawSSUPacket();
-#endif
-          pkt->len = m_Socket.receive_from(
-              boost::asio::buffer(pkt->buf, SSUSize::MTUv4), pkt->from);
-// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
-#if (BOOST_VERSION >= 106600)
-          packets.push_back(std::move(pkt));
-#else
-          packets.push_back(pkt);
-#endif
-          more_bytes = m_Socket.available();
-        }
-      m_Service.post(std::bind(
+      DrainReceivedPackets(m_Socket, packets, SSUSize::MTUv4);
+      m_Strand.post(std::bind(
           &SSUServer::HandleReceivedPackets,
           this,
 // BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
@@ -282,26 +475,8 @@ void SSUServer::HandleReceivedFromV6(
       std::vector<RawSSUPacket*> packets;
       packets.push_back(packet);
 #endif
-      std::size_t more_bytes = m_SocketV6.available();
-      while (more_bytes && packets.size() < 25)
-        {
-// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
-#if (BOOST_VERSION >= 106600)
-          auto pkt = std::make_unique<RawSSUPacket>();
-#else
-          RawSSUPacket* pkt = new RawSSUPacket();
-#endif
-          pkt->len = m_SocketV6.receive_from(
-              boost::asio::buffer(pkt->buf, SSUSize::MTUv6), pkt->from);
-// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
-#if (BOOST_VERSION >= 106600)
-          packets.push_back(std::move(pkt));
-#else
-          packets.push_back(pkt);
-#endif
-          more_bytes = m_SocketV6.available();
-        }
-      m_Service.post(std::bind(
+      DrainReceivedPackets(m_SocketV6, packets, SSUSize::MTUv6);
+      m_Strand.post(std::bind(
           &SSUServer::HandleReceivedPackets,
           this,
 // BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
@@ -335,6 +510,14 @@ void SSUServer::HandleReceivedPackets(
 {
   LOG(debug) << "SSUServer: handling received packets";
   std::shared_ptr<SSUSession> session;
+  // Consecutive datagrams from one peer form a run that the session
+  // crypto processes in fused passes (MAC verify all, then decrypt all)
+  std::vector<RawSSUPacket*> run;
+  const auto dispatch = [&run](const std::shared_ptr<SSUSession>& s) {
+    if (s && !run.empty())
+      s->ProcessNextMessages(run);
+    run.clear();
+  };
 // BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
 #if (BOOST_VERSION >= 106600)
   for (const auto& packet : packets)
@@ -348,14 +531,17 @@ void SSUServer::HandleReceivedPackets(
           // Packet received for a session other than the previous one
           if (!session || session->GetRemoteEndpoint() != packet->from)
             {
+              dispatch(session);
               if (session)
                 session->FlushData();
-              auto session_it = m_Sessions.find(packet->from);
-              if (session_it != m_Sessions.end())
-                {
-                  session = session_it->second;
-                }
+              // Key computed once per peer change, reused for probe and insert
+              const std::uint64_t key = SSUSessionTable::Key(packet->from);
+              if (m_LastSession && m_LastSessionKey == key
+                  && m_LastSession->GetRemoteEndpoint() == packet->from)
+                session = m_LastSession;
               else
+                session = m_Sessions.Find(key, packet->from);
+              if (!session)
                 {
                   session = std::make_shared<SSUSession>(*this, packet->from);
                   session->WaitForConnect();
@@ -363,27 +549,37 @@ void SSUServer::HandleReceivedPackets(
                     std::unique_lock<std::mutex> l(m_SessionsMutex);
                     // TODO(anonimal): assuming we get this far with 0 length HolePunch,
                     //   why would we add a session with Charlie *before* sending a SessionRequest?
-                    m_Sessions[packet->from] = session;
+                    m_Sessions.Insert(key, packet->from, session);
                   }
                   LOG(debug) << "SSUServer: created new SSU session from "
                              << session->GetRemoteEndpoint();
                 }
+              m_LastSessionKey = key;
+              m_LastSession = session;
             }
-          session->ProcessNextMessage(packet->buf, packet->len, packet->from);
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+          run.push_back(packet.get());
+#else
+          run.push_back(packet);
+#endif
         }
       catch (...)
         {
           m_Exception.Dispatch(__func__);
+          run.clear();
           if (session)
             session->FlushData();
           session = nullptr;
         }
-#if (BOOST_VERSION < 106600)
-      delete packet;  // free received packet
-#endif
     }
+  dispatch(session);
   if (session)
     session->FlushData();
+#if (BOOST_VERSION < 106600)
+  for (auto* packet : packets)
+    delete packet;  // free received packets, now that every run is done
+#endif
 }
 
 std::shared_ptr<SSUSession> SSUServer::FindSession(
@@ -409,11 +605,7 @@ std::shared_ptr<SSUSession> SSUServer::FindSession(
 std::shared_ptr<SSUSession> SSUServer::FindSession(
     const boost::asio::ip::udp::endpoint& ep) const {
   LOG(debug) << "SSUServer: finding session from endpoint";
-  auto it = m_Sessions.find(ep);
-  if (it != m_Sessions.end())
-    return it->second;
-  else
-    return nullptr;
+  return m_Sessions.Find(ep);
 }
 
 std::shared_ptr<SSUSession> SSUServer::GetSession(
@@ -428,10 +620,8 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
       boost::asio::ip::udp::endpoint remote_endpoint(
           address->host,
           address->port);
-      auto it = m_Sessions.find(remote_endpoint);
-      if (it != m_Sessions.end()) {
-        session = it->second;
-      } else {
+      session = m_Sessions.Find(remote_endpoint);
+      if (!session) {
         // otherwise create new session
         session = std::make_shared<SSUSession>(
             *this,
@@ -439,7 +629,7 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
             router,
             peer_test); {
           std::unique_lock<std::mutex> l(m_SessionsMutex);
-          m_Sessions[remote_endpoint] = session;
+          m_Sessions.Insert(remote_endpoint, session);
         }
         session->SetRemoteIdentHashAbbreviation();
         if (!router->UsesIntroducer()) {
@@ -451,20 +641,30 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
         } else {
           // connect through introducer
           auto num_introducers = address->introducers.size();
-          if (num_introducers > 0) {
+          // an introducer that relayed us to this peer recently is
+          // preferred over whatever the (possibly stale) RouterInfo lists
+          kovri::core::RouterInfo::Introducer cached_introducer;
+          const bool has_cached_introducer =
+              GetCachedIntroducer(router->GetIdentHash(), cached_introducer);
+          if (num_introducers > 0 || has_cached_introducer) {
             std::shared_ptr<SSUSession> introducer_session;
             const kovri::core::RouterInfo::Introducer* introducer = nullptr;
+            if (has_cached_introducer) {
+              introducer = &cached_introducer;
+              introducer_session = m_Sessions.Find(
+                  boost::asio::ip::udp::endpoint(
+                      cached_introducer.host,
+                      cached_introducer.port));
+            }
             // we might have a session to introducer already
-            for (std::size_t i = 0; i < num_introducers; i++) {
+            for (std::size_t i = 0;
+                 !introducer_session && i < num_introducers;
+                 i++) {
               introducer = &(address->introducers[i]);
-              it = m_Sessions.find(
-                       boost::asio::ip::udp::endpoint(
-                           introducer->host,
-                           introducer->port));
-              if (it != m_Sessions.end()) {
-                introducer_session = it->second;
-                break;
-              }
+              introducer_session = m_Sessions.Find(
+                  boost::asio::ip::udp::endpoint(
+                      introducer->host,
+                      introducer->port));
             }
             if (introducer_session) {  // session found
               LOG(debug)
@@ -472,7 +672,9 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
                 << "session to introducer already exists";
             } else {  // create new
               LOG(debug) << "SSUServer: creating new session to introducer";
-              introducer = &(address->introducers[0]);  // TODO(unassigned): ???
+              introducer = has_cached_introducer
+                  ? &cached_introducer
+                  : &(address->introducers[0]);  // TODO(unassigned): ???
               boost::asio::ip::udp::endpoint introducerEndpoint(
                   introducer->host,
                   introducer->port);
@@ -481,8 +683,11 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
                   introducerEndpoint,
                   router);
               std::unique_lock<std::mutex> l(m_SessionsMutex);
-              m_Sessions[introducerEndpoint] = introducer_session;
+              m_Sessions.Insert(introducerEndpoint, introducer_session);
             }
+            // remember the choice; confirmed or dropped once the
+            // introduction succeeds or times out
+            CacheIntroducer(router->GetIdentHash(), *introducer);
             // introduce
             LOG(debug)
               << "SSUServer: introducing new SSU session to "
@@ -494,6 +699,13 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
             if (context.GetRouterInfo().UsesIntroducer()) {
               std::array<std::uint8_t, 1> buf {{}};
               Send(buf.data(), 0, remote_endpoint);  // send HolePunch
+            } else if (has_cached_introducer) {
+              // repeat contact: probe the peer directly in parallel with
+              // the relayed introduction, so a NAT mapping surviving from
+              // the previous session is re-opened without waiting on the
+              // relay round trip
+              std::array<std::uint8_t, 1> buf {{}};
+              Send(buf.data(), 0, remote_endpoint);
             }
             introducer_session->Introduce(introducer->tag, introducer->key);
           } else {
@@ -501,7 +713,7 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
               << "SSUServer: can't connect to unreachable router."
               << "No introducers available";
             std::unique_lock<std::mutex> l(m_SessionsMutex);
-            m_Sessions.erase(remote_endpoint);
+            m_Sessions.Erase(remote_endpoint);
             session.reset();
           }
         }
@@ -522,16 +734,21 @@ void SSUServer::DeleteSession(const std::shared_ptr<SSUSession>& session)
   if (session) {
     session->Close();
     std::unique_lock<std::mutex> l(m_SessionsMutex);
-    m_Sessions.erase(session->GetRemoteEndpoint());
+    m_Sessions.Erase(session->GetRemoteEndpoint());
+    if (m_LastSession == session)
+      m_LastSession = nullptr;
   }
 }
 
 void SSUServer::DeleteAllSessions() {
   LOG(debug) << "SSUServer: deleting all sessions";
   std::unique_lock<std::mutex> l(m_SessionsMutex);
-  for (auto it : m_Sessions)
-    it.second->Close();
-  m_Sessions.clear();
+  m_Sessions.ForEach(
+      [](const std::shared_ptr<SSUSession>& session) {
+        session->Close();
+      });
+  m_Sessions.Clear();
+  m_LastSession = nullptr;
 }
 
 template <typename Filter>
@@ -539,12 +756,14 @@ std::shared_ptr<SSUSession> SSUServer::GetRandomSession(const Filter filter)
 {
   LOG(debug) << "SSUServer: getting random session";
   std::vector<std::shared_ptr<SSUSession>> filtered_sessions;
-  for (auto session : m_Sessions)
-    if (filter (session.second))
-      filtered_sessions.push_back(session.second);
+  m_Sessions.ForEach(
+      [&filtered_sessions, &filter](const std::shared_ptr<SSUSession>& session) {
+        if (filter(session))
+          filtered_sessions.push_back(session);
+      });
   if (filtered_sessions.size() > 0) {
     std::size_t s = filtered_sessions.size();
-    std::size_t ind = kovri::core::RandInRange32(0, s - 1);
+    std::size_t ind = kovri::core::FastRandInRange32(0, s - 1);
     return filtered_sessions[ind];
   }
   return nullptr;
@@ -590,10 +809,10 @@ void SSUServer::ScheduleIntroducersUpdateTimer() {
       boost::posix_time::seconds{
           static_cast<long>(SSUDuration::KeepAliveInterval)});
   m_IntroducersUpdateTimer.async_wait(
-      std::bind(
+      m_Strand.wrap(std::bind(
           &SSUServer::HandleIntroducersUpdateTimer,
           this,
-          std::placeholders::_1));
+          std::placeholders::_1)));
 }
 
 void SSUServer::HandleIntroducersUpdateTimer(
@@ -707,10 +926,10 @@ void SSUServer::SchedulePeerTestsCleanupTimer() {
       boost::posix_time::seconds{
           static_cast<long>(SSUDuration::PeerTestTimeout)});
   m_PeerTestsCleanupTimer.async_wait(
-      std::bind(
+      m_Strand.wrap(std::bind(
           &SSUServer::HandlePeerTestsCleanupTimer,
           this,
-          std::placeholders::_1));
+          std::placeholders::_1)));
 }
 
 void SSUServer::HandlePeerTestsCleanupTimer(
@@ -51,6 +51,7 @@
 #include "core/router/info.h"
 #include "core/router/transports/ssu/packet.h"
 #include "core/router/transports/ssu/session.h"
+#include "core/router/transports/ssu/session_table.h"
 
 #include "core/util/exception.h"
 
@@ -61,10 +62,24 @@ struct RawSSUPacket {
   kovri::core::AESAlignedBuffer<SSUSize::RawPacketBuffer> buf;
   boost::asio::ip::udp::endpoint from;
   std::size_t len{};
+
+  /// @brief Pooled allocation: packets released after processing are
+  ///   reused by the receive path, so steady-state SSU traffic performs
+  ///   no heap allocation per datagram
+  static void* operator new(std::size_t size);
+  static void operator delete(void* entry);
 };
 
 class SSUServer : public core::RouterInfoTraits {
  public:
+  /// @enum Batch
+  /// @brief Datagram batching traits
+  enum Batch : std::uint8_t
+  {
+    /// @brief Max packets drained from a socket per receive completion
+    MaxPackets = 32,
+  };
+
   SSUServer(boost::asio::io_service& service, const std::size_t port);
 
   ~SSUServer();
@@ -96,6 +111,13 @@ class SSUServer : public core::RouterInfoTraits {
     return m_Service;
   }
 
+  /// @brief Serializes all SSU processing (server, sessions and their
+  ///   timers) when the transports io_service runs on multiple threads
+  boost::asio::io_service::strand& GetStrand()
+  {
+    return m_Strand;
+  }
+
   const auto& GetEndpoint() const noexcept
   {
     return m_Endpoint;
@@ -112,6 +134,26 @@ class SSUServer : public core::RouterInfoTraits {
 
   std::shared_ptr<SSUSession> FindRelaySession(const std::uint32_t tag);
 
+  /// @brief Looks up a previously successful introducer for given peer
+  /// @param ident Ident hash of the unreachable peer
+  /// @param introducer Filled with the cached introducer when found
+  /// @return true if a non-expired cache entry was found
+  bool GetCachedIntroducer(
+      const kovri::core::IdentHash& ident,
+      kovri::core::RouterInfo::Introducer& introducer);
+
+  /// @brief Remembers the introducer used to reach given peer so repeat
+  ///   contacts skip introducer selection
+  void CacheIntroducer(
+      const kovri::core::IdentHash& ident,
+      const kovri::core::RouterInfo::Introducer& introducer);
+
+  /// @brief Refreshes the cache TTL after an introduced session establishes
+  void ConfirmCachedIntroducer(const kovri::core::IdentHash& ident);
+
+  /// @brief Drops the cache entry after an introduction attempt failed
+  void RemoveCachedIntroducer(const kovri::core::IdentHash& ident);
+
   void NewPeerTest(
       const std::uint32_t nonce,
       const PeerTestParticipant role,
@@ -132,6 +174,20 @@ class SSUServer : public core::RouterInfoTraits {
 
   void ReceiveV6();
 
+  /// @brief Drains datagrams already queued on given socket into packets,
+  ///   up to Batch::MaxPackets
+  /// @notes On Linux a single recvmmsg syscall pulls the whole batch;
+  ///   elsewhere packets are read one by one while available
+  void DrainReceivedPackets(
+      boost::asio::ip::udp::socket& socket,
+// BOOST_ASIO_MOVE_ACCEPT_HANDLER_CHECK enabled in 1.66
+#if (BOOST_VERSION >= 106600)
+      std::vector<std::unique_ptr<RawSSUPacket>>& packets,
+#else
+      std::vector<RawSSUPacket*>& packets,
+#endif
+      const std::size_t mtu);
+
   void HandleReceivedFrom(
       const boost::system::error_code& ecode,
       const std::size_t bytes_transferred,
@@ -184,6 +240,7 @@ class SSUServer : public core::RouterInfoTraits {
   };
 
   boost::asio::io_service& m_Service;
+  boost::asio::io_service::strand m_Strand;
 
   boost::asio::ip::udp::endpoint m_Endpoint, m_EndpointV6;
   boost::asio::ip::udp::socket m_Socket, m_SocketV6;
@@ -197,11 +254,27 @@ class SSUServer : public core::RouterInfoTraits {
 
   mutable std::mutex m_SessionsMutex;
 
-  std::map<boost::asio::ip::udp::endpoint, std::shared_ptr<SSUSession>> m_Sessions;
+  SSUSessionTable m_Sessions;
+
+  /// @brief One-entry cache for the last session resolved on the receive
+  ///   path; consecutive batches from the same peer skip the table probe.
+  ///   Only touched on the strand (and invalidated in the delete paths)
+  std::uint64_t m_LastSessionKey{};
+  std::shared_ptr<SSUSession> m_LastSession;
 
   // we are introducer
   std::map<std::uint32_t, boost::asio::ip::udp::endpoint> m_Relays;
 
+  struct CachedIntroducer {
+    kovri::core::RouterInfo::Introducer introducer;
+    std::uint64_t expiration_time{};  ///< Milliseconds since epoch
+  };
+
+  mutable std::mutex m_IntroducerCacheMutex;
+
+  // introducers that worked for a given unreachable peer
+  std::map<kovri::core::IdentHash, CachedIntroducer> m_IntroducerCache;
+
   // nonce -> creation time in milliseconds
   std::map<std::uint32_t, PeerTest> m_PeerTests;
 };
@@ -69,12 +69,16 @@ SSUSession::SSUSession(
       m_Timer(GetService()),
       m_PeerTest(peer_test),
       m_State(SessionState::Unknown),
+      m_WasIntroduced(false),
       m_IsSessionKey(false),
       m_RelayTag(0),
       m_Data(*this),
       m_IsDataReceived(false),
       m_Exception(__func__) {
   m_CreationTime = kovri::core::GetSecondsSinceEpoch();
+  // No exchanged dataset until SessionCreated is sent (a default-constructed
+  // core::Buffer reports full length)
+  m_SessionConfirmData.clear();
 }
 
 SSUSession::~SSUSession() {}
@@ -83,9 +87,14 @@ boost::asio::io_service& SSUSession::GetService() {
   return m_Server.GetService();
 }
 
-bool SSUSession::CreateAESandMACKey(
-    const std::uint8_t* pub_key) {
-  // TODO(anonimal): this try block should be handled entirely by caller
+boost::asio::io_service::strand& SSUSession::GetStrand() {
+  return m_Server.GetStrand();
+}
+
+bool SSUSession::DeriveSessionKeys(
+    const std::uint8_t* pub_key,
+    std::uint8_t* session_key,
+    std::uint8_t* mac_key) {
   try {
     kovri::core::DiffieHellman dh;
     std::array<std::uint8_t, 256> shared_key;
@@ -95,8 +104,6 @@ bool SSUSession::CreateAESandMACKey(
         << "couldn't create shared key";
       return false;
     }
-    std::uint8_t* session_key = m_SessionKey();
-    std::uint8_t* mac_key = m_MACKey();
     if (shared_key.at(0) & 0x80) {
       session_key[0] = 0;
       memcpy(session_key + 1, shared_key.data(), 31);
@@ -122,14 +129,22 @@ bool SSUSession::CreateAESandMACKey(
           non_zero,
           64 - (non_zero - shared_key.data()));
     }
-    m_SessionKeyEncryption.SetKey(m_SessionKey);
-    m_SessionKeyDecryption.SetKey(m_SessionKey);
   } catch (...) {
+    // runs on the crypto worker, so there is no caller to rethrow to
     m_Exception.Dispatch(__func__);
-    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
-    throw;
+    return false;
   }
-  return m_IsSessionKey = true;
+  return true;
+}
+
+void SSUSession::InstallSessionKeys(
+    const std::uint8_t* session_key,
+    const std::uint8_t* mac_key) {
+  memcpy(m_SessionKey(), session_key, 32);
+  memcpy(m_MACKey(), mac_key, 32);
+  m_SessionKeyEncryption.Rekey(m_SessionKey);
+  m_SessionKeyDecryption.Rekey(m_SessionKey);
+  m_IsSessionKey = true;
 }
 
 /**
@@ -138,63 +153,72 @@ bool SSUSession::CreateAESandMACKey(
  *
  */
 
-// TODO(anonimal): separate message validation / decryption from session
-void SSUSession::ProcessNextMessage(
+bool SSUSession::PreprocessMessage(
     std::uint8_t* buf,
-    std::size_t len,
-    const boost::asio::ip::udp::endpoint& sender_endpoint)
+    std::size_t len)
 {
-  try
+  if (!len && m_State != SessionState::Introduced)
     {
-      if (!len && m_State != SessionState::Introduced)
-        {
-          LOG(warning) << "SSUSession:" << GetFormattedSessionInfo()
-                       << ": ignoring zero-length message (expecting HolePunch)";
-          return;  // TODO(anonimal): throw/warn for potential attacks
-        }
+      LOG(warning) << "SSUSession:" << GetFormattedSessionInfo()
+                   << ": ignoring zero-length message (expecting HolePunch)";
+      return false;  // TODO(anonimal): throw/warn for potential attacks
+    }
 
-      assert(buf);
-      LOG(trace) << "SSUSession:" << GetFormattedSessionInfo() << __func__
-                 << GetFormattedHex(buf, len);
+  assert(buf);
+  LOG(trace) << "SSUSession:" << GetFormattedSessionInfo() << __func__
+             << GetFormattedHex(buf, len);
 
-      // Update session received byte count
-      m_NumReceivedBytes += len;
-      LOG(debug) << "SSUSession:" << GetFormattedSessionInfo() << "--> " << len
-                 << " bytes transferred, " << m_NumReceivedBytes
-                 << " total bytes received";
+  // Update session received byte count
+  m_NumReceivedBytes += len;
+  LOG(debug) << "SSUSession:" << GetFormattedSessionInfo() << "--> " << len
+             << " bytes transferred, " << m_NumReceivedBytes
+             << " total bytes received";
 
-      // Update total received bytes during router run
-      core::transports.UpdateReceivedBytes(len);
+  // Update total received bytes during router run
+  core::transports.UpdateReceivedBytes(len);
 
-      switch (m_State)
+  switch (m_State)
+    {
+      case SessionState::Introduced:
         {
-          case SessionState::Introduced:
-            {
-              // TODO(anonimal): verify
-              LOG(debug) << "SSUSession: SSU HolePunch received";
-              m_State = SessionState::Unknown;
-              // Proceed to SessionRequest
-              Connect();
-              return;
-            }
-            break;
-          case SessionState::Established:
-            {
-              // No further messages expected from this session
-              ScheduleTermination();
-            }
-            break;
-          case SessionState::Unknown:
-            // Continue to message processing
-            break;
-          default:
-            LOG(debug) << "SSUSession:" << GetFormattedSessionInfo() << __func__
-                       << ": session state="
-                       << static_cast<std::uint16_t>(m_State);
-
-            throw std::invalid_argument("SSUSession: invalid session state");
-            break;
+          // TODO(anonimal): verify
+          LOG(debug) << "SSUSession: SSU HolePunch received";
+          m_State = SessionState::Unknown;
+          // Proceed to SessionRequest
+          Connect();
+          return false;
+        }
+        break;
+      case SessionState::Established:
+        {
+          // No further messages expected from this session
+          ScheduleTermination();
         }
+        break;
+      case SessionState::Unknown:
+        // Continue to message processing
+        break;
+      default:
+        LOG(debug) << "SSUSession:" << GetFormattedSessionInfo() << __func__
+                   << ": session state="
+                   << static_cast<std::uint16_t>(m_State);
+
+        throw std::invalid_argument("SSUSession: invalid session state");
+        break;
+    }
+  return true;
+}
+
+// TODO(anonimal): separate message validation / decryption from session
+void SSUSession::ProcessNextMessage(
+    std::uint8_t* buf,
+    std::size_t len,
+    const boost::asio::ip::udp::endpoint& sender_endpoint)
+{
+  try
+    {
+      if (!PreprocessMessage(buf, len))
+        return;
 
       // Validate message using either session key or introducer key
       const bool is_session(m_IsSessionKey);
@@ -225,6 +249,54 @@ void SSUSession::ProcessNextMessage(
     }
 }
 
+void SSUSession::ProcessNextMessages(
+    const std::vector<RawSSUPacket*>& packets)
+{
+  try
+    {
+      // Bookkeeping and state handling first; datagrams that finish
+      // here (hole punches, zero-length noise) skip the crypto passes
+      std::vector<RawSSUPacket*> pending;
+      pending.reserve(packets.size());
+      for (auto* packet : packets)
+        if (PreprocessMessage(packet->buf, packet->len))
+          pending.push_back(packet);
+      if (pending.empty())
+        return;
+
+      // Both key schedules live on the session, set up once for the
+      // whole run: verify every MAC, then decrypt every datagram, so
+      // each pass stays hot instead of interleaving per packet
+      const bool is_session(m_IsSessionKey);
+      const std::uint8_t* key = is_session ? m_MACKey() : GetIntroKey();
+      assert(key);
+
+      for (auto* packet : pending)
+        if (!Validate(packet->buf, packet->len, key))
+          {
+            LOG(trace) << GetFormattedSessionInfo() << __func__
+                       << ": Key=" << GetFormattedHex(key, 32);
+
+            throw std::runtime_error(
+                "SSUSession:" + (is_session ? GetFormattedSessionInfo() : " ")
+                + "MAC verification failed with "
+                + (is_session ? "session key" : "introducer key"));
+          }
+
+      for (auto* packet : pending)
+        Decrypt(packet->buf, packet->len, key, is_session);
+
+      for (auto* packet : pending)
+        ProcessDecryptedMessage(packet->buf, packet->len, packet->from);
+    }
+  catch (...)
+    {
+      m_Exception.Dispatch(__func__);
+      m_Server.DeleteSession(shared_from_this());
+      return;  // TODO(anonimal): throw/warn for potential attacks
+    }
+}
+
 void SSUSession::ProcessDecryptedMessage(
     std::uint8_t* buf,
     std::size_t len,
@@ -241,39 +313,53 @@ void SSUSession::ProcessDecryptedMessage(
       m_Exception.Dispatch(__func__);
       throw;
     }
+  if (!packet) {
+    LOG(warning) << "SSUSession:" << GetFormattedSessionInfo()
+                 << "malformed packet, dropping";
+    return;
+  }
+  // Data dominates the relay path: dispatch it before the
+  // administrative switch so the common case is a single predicted branch
+  if (packet->get_header()->get_payload_type() == SSUPayloadType::Data) {
+    ProcessData(packet.get());
+    return;
+  }
+  ProcessAdministrativeMessage(packet.get(), sender_endpoint);
+}
+
+void SSUSession::ProcessAdministrativeMessage(
+    SSUPacket* packet,
+    const boost::asio::ip::udp::endpoint& sender_endpoint) {
   switch (packet->get_header()->get_payload_type()) {
-    case SSUPayloadType::Data:
-      ProcessData(packet.get());
-      break;
     case SSUPayloadType::SessionRequest:
-      ProcessSessionRequest(packet.get(), sender_endpoint);
+      ProcessSessionRequest(packet, sender_endpoint);
       break;
     case SSUPayloadType::SessionCreated:
-      ProcessSessionCreated(packet.get());
+      ProcessSessionCreated(packet);
       break;
     case SSUPayloadType::SessionConfirmed:
-      ProcessSessionConfirmed(packet.get());
+      ProcessSessionConfirmed(packet);
       break;
     case SSUPayloadType::PeerTest:
       LOG(debug) << "SSUSession: PeerTest received";
-      ProcessPeerTest(packet.get(), sender_endpoint);
+      ProcessPeerTest(packet, sender_endpoint);
       break;
     case SSUPayloadType::SessionDestroyed:
       LOG(debug) << "SSUSession: SessionDestroy received";
       m_Server.DeleteSession(shared_from_this());
       break;
     case SSUPayloadType::RelayResponse:
-      ProcessRelayResponse(packet.get());
+      ProcessRelayResponse(packet);
       if (m_State != SessionState::Established)
         m_Server.DeleteSession(shared_from_this());
       break;
     case SSUPayloadType::RelayRequest:
       LOG(debug) << "SSUSession: RelayRequest received";
-      ProcessRelayRequest(packet.get(), sender_endpoint);
+      ProcessRelayRequest(packet, sender_endpoint);
       break;
     case SSUPayloadType::RelayIntro:
       LOG(debug) << "SSUSession: RelayIntro received";
-      ProcessRelayIntro(packet.get());
+      ProcessRelayIntro(packet);
       break;
     default:
       LOG(warning)
@@ -318,13 +404,27 @@ void SSUSession::ProcessSessionRequest(
   SetRemoteEndpoint(sender_endpoint);
   if (!m_DHKeysPair)
     m_DHKeysPair = transports.GetNextDHKeysPair();
-  if (!CreateAESandMACKey(packet->get_dh_x())) {
-    LOG(error)
-      << "SSUSession:" << GetFormattedSessionInfo()
-      << "invalid DH-X, not sending SessionCreated";
-    return;
-  }
-  SendSessionCreated(packet->get_dh_x());
+  // The DH agreement dominates establishment cost: run it on the transports
+  // crypto worker. The packet points into the recycled receive buffer, so
+  // copy Alice's DH X out first; key installation and the reply stay on the
+  // strand because they mutate session state
+  auto dh_x = std::make_shared<std::array<std::uint8_t, DHKeySize::PubKey>>();
+  memcpy(dh_x->data(), packet->get_dh_x(), dh_x->size());
+  auto self = shared_from_this();
+  transports.GetCryptoService().post([self, dh_x] {
+    auto keys = std::make_shared<std::array<std::uint8_t, 64>>();
+    if (!self->DeriveSessionKeys(
+            dh_x->data(), keys->data(), keys->data() + 32)) {
+      LOG(error)
+        << "SSUSession:" << self->GetFormattedSessionInfo()
+        << "invalid DH-X, not sending SessionCreated";
+      return;
+    }
+    self->GetStrand().post([self, dh_x, keys] {
+      self->InstallSessionKeys(keys->data(), keys->data() + 32);
+      self->SendSessionCreated(dh_x->data());
+    });
+  });
 }
 
 // TODO(anonimal): separate message creation from session
@@ -363,8 +463,8 @@ void SSUSession::SendSessionRequest()
           options.data(), options.size());
     }
 
-  // Create encrypted message buffer
-  std::vector<std::uint8_t> buf(
+  // Create encrypted message buffer (borrowed from the thread's arena)
+  core::ArenaOutputByteStream buf(
       SSUPacketBuilder::get_padded_size(message.get_size())
       + SSUSize::BufferMargin);
 
@@ -407,29 +507,69 @@ void SSUSession::ProcessSessionCreated(const SSUPacket* packet)
       assert(packet);
       const auto* message = static_cast<const SSUSessionCreatedPacket*>(packet);
 
-      // Complete SessionRequest DH agreement using Bob's DH Y
-      if (!CreateAESandMACKey(message->get_dh_y()))
-        {
-          LOG(error) << "SSUSession:" << GetFormattedSessionInfo()
-                     << "invalid DH-Y, not sending SessionConfirmed";
-          return;  // TODO(anonimal): assert/throw?
-        }
+      // The DH agreement moves to the transports crypto worker while the
+      // strand keeps servicing retransmissions. The parsed packet points into
+      // the recycled receive buffer, so copy out everything needed afterwards
+      auto created = std::make_shared<SessionCreatedData>();
+      memcpy(created->dh_y.data(), message->get_dh_y(), created->dh_y.size());
+      created->ip.assign(
+          message->get_ip(), message->get_ip() + message->get_ip_size());
+      created->port = message->get_port();
+      created->relay_tag = message->get_relay_tag();
+      created->time = message->get_time();
+      memcpy(
+          created->iv.data(),
+          message->get_header()->get_iv(),
+          created->iv.size());
+      std::uint8_t const signature_len =
+          SSUPacketBuilder::get_padded_size(m_RemoteIdentity.GetSignatureLen());
+      created->sig.assign(
+          message->get_sig(), message->get_sig() + signature_len);
+
+      auto self = shared_from_this();
+      transports.GetCryptoService().post([self, created] {
+        auto keys = std::make_shared<std::array<std::uint8_t, 64>>();
+        if (!self->DeriveSessionKeys(
+                created->dh_y.data(), keys->data(), keys->data() + 32))
+          {
+            LOG(error) << "SSUSession:" << self->GetFormattedSessionInfo()
+                       << "invalid DH-Y, not sending SessionConfirmed";
+            return;
+          }
+        self->GetStrand().post([self, created, keys] {
+          self->InstallSessionKeys(keys->data(), keys->data() + 32);
+          self->HandleSessionCreated(created);
+        });
+      });
+    }
+  catch (...)
+    {
+      m_Exception.Dispatch(__func__);
+      // TODO(anonimal): ensure exception handling by callers
+      throw;
+    }
+}
 
+void SSUSession::HandleSessionCreated(
+    std::shared_ptr<SessionCreatedData> message)
+{
+  try
+    {
       // Create dataset of exchanged session data (the dataset Bob has signed)
       // TODO(anonimal): at this point, why would we allow mix-and-match IPv6 to send to IPv4 - or vice versa...
       bool const is_IPv6 = m_RemoteEndpoint.address().is_v6();
       core::OutputByteStream data(get_signed_data_size(
-          message->get_ip_size() + (is_IPv6 ? 16 : 4)));
+          message->ip.size() + (is_IPv6 ? 16 : 4)));
 
       // Our (Alice's) DH X
       data.WriteData(m_DHKeysPair->public_key.data(), DHKeySize::PubKey);
 
       // Bob's DH Y
-      data.WriteData(message->get_dh_y(), DHKeySize::PubKey);
+      data.WriteData(message->dh_y.data(), DHKeySize::PubKey);
 
       // Our (Alice's) IP and port
-      data.WriteData(message->get_ip(), message->get_ip_size());
-      data.Write<std::uint16_t>(message->get_port());
+      data.WriteData(message->ip.data(), message->ip.size());
+      data.Write<std::uint16_t>(message->port);
 
       // Bob's IP address
       data.WriteData(
@@ -441,24 +581,21 @@ void SSUSession::ProcessSessionCreated(const SSUPacket* packet)
       data.Write<std::uint16_t>(m_RemoteEndpoint.port());
 
       // Our (Alice's) relay tag
-      data.Write<std::uint32_t>(m_RelayTag = message->get_relay_tag());
+      data.Write<std::uint32_t>(m_RelayTag = message->relay_tag);
 
       // Bob's signed-on time
-      data.Write<std::uint32_t>(message->get_time());
+      data.Write<std::uint32_t>(message->time);
 
-      // Get Bob's padded signature length
-      std::uint8_t const signature_len =
-          SSUPacketBuilder::get_padded_size(m_RemoteIdentity.GetSignatureLen());
-
-      // Prepare decrypted-signature buffer
-      std::vector<std::uint8_t> signature(signature_len);
+      // Prepare decrypted-signature buffer (inline; an implausibly large
+      // signature throws length_error and rejects the session)
+      core::Buffer<0, SSUSize::MaxSignature> signature(message->sig.size());
 
       // Use Bob's IV to decrypt signature using our negotiated session key
-      m_SessionKeyDecryption.SetIV(message->get_header()->get_iv());
+      m_SessionKeyDecryption.SetIV(message->iv.data());
 
       // Decrypt signature
       m_SessionKeyDecryption.Decrypt(
-          message->get_sig(), signature.size(), signature.data());
+          message->sig.data(), signature.size(), signature.data());
 
       // TODO(anonimal): log debug of encrypted/decrypted sig + message data
 
@@ -480,22 +617,19 @@ void SSUSession::ProcessSessionCreated(const SSUPacket* packet)
 
       // An SSU'ism: update our external address as perceived by Bob
       context.UpdateAddress(
-          message->get_ip(),
-          message->get_ip_size(),
-          message->get_port());
+          message->ip.data(), message->ip.size(), message->port);
 
       // Session created, create/send confirmation
       SendSessionConfirmed(
-          message->get_dh_y(),
-          message->get_ip(),
-          message->get_ip_size(),
-          message->get_port());
+          message->dh_y.data(),
+          message->ip.data(),
+          message->ip.size(),
+          message->port);
     }
   catch (...)
     {
+      // posted handler: no caller prepared to catch, dispatch only
       m_Exception.Dispatch(__func__);
-      // TODO(anonimal): ensure exception handling by callers
-      throw;
     }
 }
 
@@ -548,7 +682,7 @@ void SSUSession::SendSessionCreated(const std::uint8_t* dh_x)
       // Prepare dataset of exchanged session data (the dataset we will sign)
       // TODO(anonimal): assert for bad design. Redesign.
       assert(!m_SessionConfirmData.size());
-      m_SessionConfirmData.reserve(data_size);
+      m_SessionConfirmData(data_size);
 
       core::OutputByteStream data(m_SessionConfirmData.data(), data_size);
 
@@ -598,7 +732,7 @@ void SSUSession::SendSessionCreated(const std::uint8_t* dh_x)
           SSUPacketBuilder::get_padding_size(message.get_size() + signature_size);
 
       // Create the signature + padding
-      std::vector<std::uint8_t> signature(signature_size + padding);
+      core::Buffer<0, SSUSize::MaxSignature> signature(signature_size + padding);
       context.GetPrivateKeys().Sign(data.data(), data.size(), signature.data());
 
       // Randomize signature padding
@@ -606,7 +740,7 @@ void SSUSession::SendSessionCreated(const std::uint8_t* dh_x)
       message.set_sig(signature.data(), signature.size());
 
       // Encrypt signature + padding with session key
-      std::vector<std::uint8_t> encrypted(message.get_sig_size());
+      core::Buffer<0, SSUSize::MaxSignature> encrypted(message.get_sig_size());
 
       m_SessionKeyEncryption.SetIV(message.get_header()->get_iv());
       m_SessionKeyEncryption.Encrypt(
@@ -620,7 +754,7 @@ void SSUSession::SendSessionCreated(const std::uint8_t* dh_x)
       // TODO(anonimal): IPv6 MTU...
       if (size <= SSUSize::MTUv4)
         {
-          std::vector<std::uint8_t> buf(size + SSUSize::BufferMargin);
+          core::ArenaOutputByteStream buf(size + SSUSize::BufferMargin);
           WriteAndEncrypt(
               &message, buf.data(), buf.size(), intro_key, intro_key);
           Send(buf.data(), buf.size() - SSUSize::BufferMargin);
@@ -667,19 +801,34 @@ void SSUSession::ProcessSessionConfirmed(SSUPacket* pkt) {
              << "SessionConfirmed data:"
              << core::GetFormattedHex(data.data(), data.size());
 
-  // Verify data with Alice's signature
-  if (!m_RemoteIdentity.Verify(
-          data.data(), data.size(), packet->get_sig()))
-    {
-      LOG(error) << "SSUSession:" << GetFormattedSessionInfo()
-                 << "SessionConfirmed verification failed";
-      return;  // TODO(anonimal): set threshold, throw/warn for potential attacks
-    }
+  // Verify Alice's signature on the transports crypto worker: copies of the
+  // identity, dataset and signature keep the worker off live session state
+  // (the signature points into the recycled receive buffer)
+  auto ident = std::make_shared<IdentityEx>(m_RemoteIdentity);
+  auto signed_data =
+      std::make_shared<core::Buffer<0, SSUSize::MaxExchangedData>>(
+          data.data(), data.size());
+  auto signature = std::make_shared<core::Buffer<0, SSUSize::MaxSignature>>(
+      packet->get_sig(), m_RemoteIdentity.GetSignatureLen());
+  auto self = shared_from_this();
+  transports.GetCryptoService().post([self, ident, signed_data, signature] {
+    if (!ident->Verify(
+            signed_data->data(), signed_data->size(), signature->data()))
+      {
+        LOG(error) << "SSUSession:" << self->GetFormattedSessionInfo()
+                   << "SessionConfirmed verification failed";
+        return;  // TODO(anonimal): set threshold, throw/warn for potential attacks
+      }
 
-  LOG(debug) << "SSUSession:" << GetFormattedSessionInfo()
-             << "SessionConfirmed success";
+    LOG(debug) << "SSUSession:" << self->GetFormattedSessionInfo()
+               << "SessionConfirmed success";
 
-  Established();
+    self->GetStrand().post([self] {
+      // A retransmitted SessionConfirmed may have raced us here
+      if (self->m_State != SessionState::Established)
+        self->Established();
+    });
+  });
 }
 
 // TODO(anonimal): separate message creation from session
@@ -737,13 +886,13 @@ void SSUSession::SendSessionConfirmed(
       data.Write<std::uint32_t>(message.get_time());
 
       // Sign message
-      std::vector<std::uint8_t> signature(
+      core::Buffer<0, SSUSize::MaxSignature> signature(
           context.GetIdentity().GetSignatureLen());
       context.GetPrivateKeys().Sign(data.data(), data.size(), signature.data());
       message.set_sig(signature.data());
 
       // Encrypt with session + mac keys generated from DH exchange, then send
-      std::vector<std::uint8_t> buf(
+      core::ArenaOutputByteStream buf(
           SSUPacketBuilder::get_padded_size(message.get_size())
           + SSUSize::BufferMargin);
       WriteAndEncrypt(&message, buf.data(), buf.size(), m_SessionKey, m_MACKey);
@@ -1353,7 +1502,7 @@ void SSUSession::FillHeaderAndEncrypt(
     pkt.put_time(kovri::core::GetSecondsSinceEpoch());
     auto encrypted = pkt.get_encrypted();
     auto encrypted_len = len - (encrypted - buf);
-    kovri::core::CBCEncryption encryption(aes_key, pkt.get_iv());
+    kovri::core::PooledCBCEncryption encryption(aes_key, pkt.get_iv());
     encryption.Encrypt(
         encrypted,
         encrypted_len,
@@ -1401,12 +1550,13 @@ void SSUSession::WriteAndEncrypt(
         SSUPacketBuilder::get_padding_size(encrypted_len);
     if (padding_size)
       {
-        std::vector<std::uint8_t> padding(padding_size);
+        core::Buffer<0, SSUSize::IV> padding(padding_size);
         core::RandBytes(padding.data(), padding.size());
         builder.WriteData(padding.data(), padding.size());
         encrypted_len += padding.size();
       }
-    kovri::core::CBCEncryption encryption(aes_key, packet->get_header()->get_iv());
+    kovri::core::PooledCBCEncryption encryption(
+        aes_key, packet->get_header()->get_iv());
     encryption.Encrypt(encrypted, encrypted_len, encrypted);
     // Compute HMAC of encryptedPayload + IV + (payloadLength ^ protocolVersion)
     // Currently, protocolVersion == 0
@@ -1480,9 +1630,7 @@ void SSUSession::Decrypt(
   // Set new key for this message
   if (!is_session)
     {
-      core::CBCDecryption decryption;
-      decryption.SetKey(aes_key);
-      decryption.SetIV(message.get_iv());
+      core::PooledCBCDecryption decryption(aes_key, message.get_iv());
       decryption.Decrypt(encrypted, encrypted_len, encrypted);
       return;
     }
@@ -1536,10 +1684,10 @@ void SSUSession::ScheduleConnectTimer() {
       boost::posix_time::seconds{
           static_cast<long>(SSUDuration::ConnectTimeout)});
   m_Timer.async_wait(
-      std::bind(
+      GetStrand().wrap(std::bind(
           &SSUSession::HandleConnectTimer,
           shared_from_this(),
-          std::placeholders::_1));
+          std::placeholders::_1)));
 }
 
 void SSUSession::HandleConnectTimer(
@@ -1563,25 +1711,26 @@ void SSUSession::Introduce(
         boost::posix_time::seconds{
             static_cast<long>(SSUDuration::ConnectTimeout)});
     m_Timer.async_wait(
-        std::bind(
+        GetStrand().wrap(std::bind(
           &SSUSession::HandleConnectTimer,
           shared_from_this(),
-          std::placeholders::_1));
+          std::placeholders::_1)));
   }
   SendRelayRequest(introducer_tag, introducer_key);
 }
 
 void SSUSession::WaitForIntroduction() {
   m_State = SessionState::Introduced;
+  m_WasIntroduced = true;
   // set connect timer
   m_Timer.expires_from_now(
       boost::posix_time::seconds{
           static_cast<long>(SSUDuration::ConnectTimeout)});
   m_Timer.async_wait(
-      std::bind(
+      GetStrand().wrap(std::bind(
         &SSUSession::HandleConnectTimer,
         shared_from_this(),
-        std::placeholders::_1));
+        std::placeholders::_1)));
 }
 
 void SSUSession::Close() {
@@ -1593,16 +1742,15 @@ void SSUSession::Close() {
 }
 
 void SSUSession::Done() {
-  GetService().post(
+  GetStrand().post(
       std::bind(
         &SSUSession::Failed,
         shared_from_this()));
 }
 
 void SSUSession::Established() {
-  // Remove SessionConfirmed data
+  // Remove (and wipe) SessionConfirmed data
   m_SessionConfirmData.clear();
-  m_SessionConfirmData.shrink_to_fit();
 
   m_State = SessionState::Established;
   if (m_DHKeysPair) {
@@ -1614,6 +1762,9 @@ void SSUSession::Established() {
   // send database store
   m_Data.Send(CreateDatabaseStoreMsg());
   transports.PeerConnected(shared_from_this());
+  // the introducer delivered: keep it cached for the next contact
+  if (m_WasIntroduced && m_RemoteRouter)
+    m_Server.ConfirmCachedIntroducer(m_RemoteRouter->GetIdentHash());
   if (m_PeerTest && (m_RemoteRouter && m_RemoteRouter->HasCap(RouterInfo::Cap::SSUTesting)))
     SendPeerTest();
   ScheduleTermination();
@@ -1621,6 +1772,10 @@ void SSUSession::Established() {
 
 void SSUSession::Failed() {
   if (m_State != SessionState::Failed) {
+    // still waiting on the introduction: the relay never came through,
+    // so stop trusting the cached introducer for this peer
+    if (m_State == SessionState::Introduced && m_RemoteRouter)
+      m_Server.RemoveCachedIntroducer(m_RemoteRouter->GetIdentHash());
     m_State = SessionState::Failed;
     m_Server.DeleteSession(shared_from_this());
   }
@@ -1632,10 +1787,10 @@ void SSUSession::ScheduleTermination() {
       boost::posix_time::seconds{
           static_cast<long>(SSUDuration::TerminationTimeout)});
   m_Timer.async_wait(
-      std::bind(
+      GetStrand().wrap(std::bind(
           &SSUSession::HandleTerminationTimer,
           shared_from_this(),
-          std::placeholders::_1));
+          std::placeholders::_1)));
 }
 
 void SSUSession::HandleTerminationTimer(
@@ -1670,7 +1825,7 @@ const std::uint8_t* SSUSession::GetIntroKey() const
 
 void SSUSession::SendI2NPMessages(
     const std::vector<std::shared_ptr<I2NPMessage>>& msgs) {
-  GetService().post(
+  GetStrand().post(
       std::bind(
           &SSUSession::PostI2NPMessages,
           shared_from_this(),
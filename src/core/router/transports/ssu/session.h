@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_ROUTER_TRANSPORTS_SSU_SESSION_H_
 #define SRC_CORE_ROUTER_TRANSPORTS_SSU_SESSION_H_
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <ostream>
@@ -41,12 +42,15 @@
 #include <vector>
 
 #include "core/crypto/aes.h"
+#include "core/crypto/cipher_pool.h"
 #include "core/crypto/hmac.h"
 
 #include "core/router/i2np.h"
 #include "core/router/transports/session.h"
 #include "core/router/transports/ssu/data.h"
+#include "core/router/transports/ssu/packet.h"
 
+#include "core/util/buffer.h"
 #include "core/util/exception.h"
 
 namespace kovri {
@@ -127,6 +131,7 @@ struct SSUSessionPacket  // TODO(unassigned): finish
 };
 
 class SSUServer;
+struct RawSSUPacket;
 class SSUSession : public RouterInfoTraits,
                    public TransportSession,
                    public std::enable_shared_from_this<SSUSession>
@@ -145,6 +150,14 @@ class SSUSession : public RouterInfoTraits,
       std::size_t len,
       const boost::asio::ip::udp::endpoint& sender_endpoint);
 
+  /// @brief Processes a run of datagrams addressed to this session in
+  ///   fused passes: every MAC is verified, then every datagram is
+  ///   decrypted, then the plaintexts are parsed, so each pass runs hot
+  ///   over the whole recvmmsg batch with the session's key schedules
+  ///   set up once instead of interleaving per packet
+  void ProcessNextMessages(
+      const std::vector<RawSSUPacket*>& packets);
+
   void Connect();
 
   void WaitForConnect();
@@ -228,18 +241,50 @@ class SSUSession : public RouterInfoTraits,
  private:
   boost::asio::io_service& GetService();
 
-  bool CreateAESandMACKey(
-      const std::uint8_t* pub_key);
+  boost::asio::io_service::strand& GetStrand();
+
+  /// @brief Computes the DH agreement and derives session/MAC key material
+  /// @details Reads only the fixed DH keypair and writes caller-owned
+  ///   buffers, so it is safe to run on the transports crypto worker while
+  ///   the strand keeps processing retransmissions
+  /// @param pub_key Peer's DH public key
+  /// @param session_key 32-byte output buffer for the session key
+  /// @param mac_key 32-byte output buffer for the MAC key
+  /// @return false if the agreement fails or produces unusable key material
+  bool DeriveSessionKeys(
+      const std::uint8_t* pub_key,
+      std::uint8_t* session_key,
+      std::uint8_t* mac_key);
+
+  /// @brief Installs derived keys and rekeys the session ciphers.
+  ///   Mutates session state: strand only
+  void InstallSessionKeys(
+      const std::uint8_t* session_key,
+      const std::uint8_t* mac_key);
 
   void PostI2NPMessages(
       std::vector<std::shared_ptr<I2NPMessage>> msgs);
 
+  /// @brief Per-packet bookkeeping and state handling ahead of the
+  ///   crypto passes (byte counters, hole punch, state transitions)
+  /// @return true when the datagram should continue to MAC
+  ///   verification and decryption
+  bool PreprocessMessage(
+      std::uint8_t* buf,
+      std::size_t len);
+
   /// @brief Call for established session
   void ProcessDecryptedMessage(
       std::uint8_t* buf,
       std::size_t len,
       const boost::asio::ip::udp::endpoint& sender_endpoint);
 
+  /// @brief Cold path for the rare administrative payload types;
+  ///   ProcessDecryptedMessage handles the dominant Data type inline
+  void ProcessAdministrativeMessage(
+      SSUPacket* packet,
+      const boost::asio::ip::udp::endpoint& sender_endpoint);
+
   // Payload type 0: SessionRequest
 
   void ProcessSessionRequest(
@@ -251,10 +296,27 @@ class SSUSession : public RouterInfoTraits,
 
   // Payload type 1: SessionCreated
 
+  /// @brief Fields copied out of Bob's SessionCreated message
+  /// @details The parsed packet points into the recycled receive buffer, so
+  ///   everything needed after the crypto-worker hop must be copied first
+  struct SessionCreatedData {
+    std::array<std::uint8_t, DHKeySize::PubKey> dh_y;
+    std::vector<std::uint8_t> ip;
+    std::uint16_t port;
+    std::uint32_t relay_tag;
+    std::uint32_t time;
+    std::array<std::uint8_t, SSUSize::IV> iv;
+    std::vector<std::uint8_t> sig;
+  };
+
   /// @brief We are Alice, processing Bob's SessionCreated message
   /// @param packet Bob's message (header + payload)
   void ProcessSessionCreated(const SSUPacket* packet);
 
+  /// @brief Continues SessionCreated processing on the strand once the
+  ///   crypto worker has derived the session keys
+  void HandleSessionCreated(std::shared_ptr<SessionCreatedData> message);
+
   /// @brief We are Bob, creating and sending SessionCreated message
   /// @param dh_x Diffie-Hellman X as created by Alice
   void SendSessionCreated(const std::uint8_t* dh_x);
@@ -423,19 +485,23 @@ class SSUSession : public RouterInfoTraits,
   boost::asio::deadline_timer m_Timer;
   bool m_PeerTest;
   SessionState m_State;
+  bool m_WasIntroduced;  // outgoing session reached through an introducer
   bool m_IsSessionKey;
   std::uint32_t m_RelayTag;
   SSUData m_Data;
-  kovri::core::CBCEncryption m_SessionKeyEncryption;
-  kovri::core::CBCDecryption m_SessionKeyDecryption;
+  kovri::core::PooledCBCEncryption m_SessionKeyEncryption;
+  kovri::core::PooledCBCDecryption m_SessionKeyDecryption;
   kovri::core::AESKey m_SessionKey;
   kovri::core::MACKey m_MACKey;
   std::uint32_t m_CreationTime;  // seconds since epoch
 
   /// @brief The unsigned SessionCreated data for SessionConfirmed processing
+  /// @notes Inline storage: the dataset is small and bounded, so nothing
+  ///   is heap-allocated per establishment. Length stays zero until
+  ///   SessionCreated is sent (cleared in the constructor)
   // TODO(anonimal): data should be separated from session class
   // TODO(anonimal): mutex lock if we ever expand member usage across threads (unlikely)
-  std::vector<std::uint8_t> m_SessionConfirmData;
+  kovri::core::Buffer<0, SSUSize::MaxExchangedData> m_SessionConfirmData;
 
   bool m_IsDataReceived;
   kovri::core::Exception m_Exception;
@@ -0,0 +1,238 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_ROUTER_TRANSPORTS_SSU_SESSION_TABLE_H_
+#define SRC_CORE_ROUTER_TRANSPORTS_SSU_SESSION_TABLE_H_
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+class SSUSession;
+
+/// @class SSUSessionTable
+/// @brief Open-addressing hash table of SSU sessions keyed by remote
+///   endpoint (same layout as TransitTunnelTable). The receive path looks
+///   a session up per peer change within a datagram batch; a v4 endpoint
+///   packs loss-free into a 6-byte address+port integer that is computed
+///   once and then probed over a flat slot array instead of walking a
+///   red-black tree of endpoint comparisons. v6 endpoints fold their
+///   address bytes into the same 64-bit key; slots keep the full endpoint
+///   so a fold collision is resolved by one comparison during the probe
+/// @note Not internally locked: callers follow the same discipline as the
+///   std::map this replaces (reads on the SSU strand, writes under the
+///   server's sessions mutex)
+class SSUSessionTable {
+ public:
+  explicit SSUSessionTable(
+      std::size_t initial_buckets = 256)
+      : m_Size(0),
+        m_Tombstones(0),
+        m_Buckets(initial_buckets) {}
+
+  /// @brief Packs a v4 endpoint into its 6-byte address+port integer;
+  ///   folds a v6 address into 64 bits (FNV-1a) mixed with the port.
+  ///   Computed once per peer change and passed to Find/Insert below
+  static std::uint64_t Key(
+      const boost::asio::ip::udp::endpoint& ep) {
+    if (ep.address().is_v4())
+      return (static_cast<std::uint64_t>(
+                  ep.address().to_v4().to_ulong()) << 16) | ep.port();
+    std::uint64_t key = 0xCBF29CE484222325ULL;
+    for (const auto byte : ep.address().to_v6().to_bytes()) {
+      key ^= byte;
+      key *= 0x100000001B3ULL;
+    }
+    return key ^ ep.port();
+  }
+
+  std::shared_ptr<SSUSession> Find(
+      const std::uint64_t key,
+      const boost::asio::ip::udp::endpoint& ep) const {
+    const Bucket* bucket = FindBucket(key, ep);
+    return bucket ? bucket->session : nullptr;
+  }
+
+  std::shared_ptr<SSUSession> Find(
+      const boost::asio::ip::udp::endpoint& ep) const {
+    return Find(Key(ep), ep);
+  }
+
+  /// @brief Inserts or replaces the session under the given endpoint
+  void Insert(
+      const std::uint64_t key,
+      const boost::asio::ip::udp::endpoint& ep,
+      std::shared_ptr<SSUSession> session) {
+    // 0.75 load factor counting tombstones: peer churn erases sessions
+    // constantly, and without reclaiming those buckets the Empty slots
+    // that terminate probe scans would eventually run out; rehashing at
+    // the current size merely clears accumulated tombstones
+    if ((m_Size + m_Tombstones + 1) * 4 > m_Buckets.size() * 3)
+      Rehash(
+          (m_Size + 1) * 4 > m_Buckets.size() * 3
+              ? m_Buckets.size() * 2
+              : m_Buckets.size());
+    InsertNonRehashing(key, ep, std::move(session));
+  }
+
+  void Insert(
+      const boost::asio::ip::udp::endpoint& ep,
+      std::shared_ptr<SSUSession> session) {
+    Insert(Key(ep), ep, std::move(session));
+  }
+
+  /// @return False when no session was present under the endpoint
+  bool Erase(
+      const boost::asio::ip::udp::endpoint& ep) {
+    Bucket* bucket = const_cast<Bucket*>(FindBucket(Key(ep), ep));
+    if (!bucket)
+      return false;
+    bucket->session = nullptr;
+    bucket->state = Bucket::Tombstone;
+    m_Size--;
+    m_Tombstones++;
+    return true;
+  }
+
+  void Clear() {
+    m_Size = 0;
+    m_Tombstones = 0;
+    m_Buckets.assign(m_Buckets.size(), Bucket());
+  }
+
+  std::size_t Size() const {
+    return m_Size;
+  }
+
+  /// @brief Visits every session; the visitor must not call back into
+  ///   this table
+  template<typename Visitor>
+  void ForEach(
+      Visitor visit) const {
+    for (const auto& bucket : m_Buckets)
+      if (bucket.state == Bucket::Full)
+        visit(bucket.session);
+  }
+
+ private:
+  struct Bucket {
+    enum State : std::uint8_t { Empty = 0, Full, Tombstone };
+    std::uint64_t key = 0;
+    State state = Empty;
+    boost::asio::ip::udp::endpoint ep;
+    std::shared_ptr<SSUSession> session;
+  };
+
+  /// @brief Packed keys carry structure (host bits, well-known ports);
+  ///   multiplicative mixing guards against probe clustering under the
+  ///   power-of-two mask
+  static std::size_t Hash(
+      const std::uint64_t key) {
+    return (key * 0x9E3779B97F4A7C15ULL) >> 32;
+  }
+
+  const Bucket* FindBucket(
+      const std::uint64_t key,
+      const boost::asio::ip::udp::endpoint& ep) const {
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::size_t pos = Hash(key) & mask;
+    for (std::size_t probe = 0; probe < m_Buckets.size(); probe++) {
+      const Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Empty)
+        return nullptr;
+      if (bucket.state == Bucket::Full
+          && bucket.key == key
+          && bucket.ep == ep)
+        return &bucket;
+      pos = (pos + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  void InsertNonRehashing(
+      const std::uint64_t key,
+      const boost::asio::ip::udp::endpoint& ep,
+      std::shared_ptr<SSUSession> session) {
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::size_t pos = Hash(key) & mask;
+    Bucket* tombstone = nullptr;
+    for (;;) {
+      Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Full
+          && bucket.key == key
+          && bucket.ep == ep) {
+        bucket.session = std::move(session);  // replace
+        return;
+      }
+      if (bucket.state == Bucket::Tombstone && !tombstone) {
+        tombstone = &bucket;
+      } else if (bucket.state == Bucket::Empty) {
+        Bucket& target = tombstone ? *tombstone : bucket;
+        if (tombstone)
+          m_Tombstones--;
+        target.key = key;
+        target.ep = ep;
+        target.session = std::move(session);
+        target.state = Bucket::Full;
+        m_Size++;
+        return;
+      }
+      pos = (pos + 1) & mask;
+    }
+  }
+
+  void Rehash(
+      std::size_t new_buckets) {
+    std::vector<Bucket> old = std::move(m_Buckets);
+    m_Buckets.assign(new_buckets, Bucket());
+    m_Size = 0;
+    m_Tombstones = 0;
+    for (auto& bucket : old)
+      if (bucket.state == Bucket::Full)
+        InsertNonRehashing(bucket.key, bucket.ep, std::move(bucket.session));
+  }
+
+ private:
+  std::size_t m_Size;
+  std::size_t m_Tombstones;
+  std::vector<Bucket> m_Buckets;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_TRANSPORTS_SSU_SESSION_TABLE_H_
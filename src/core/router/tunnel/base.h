@@ -56,6 +56,20 @@ enum TunnelDeliveryType {
 };
 
 struct TunnelMessageBlock {
+  TunnelMessageBlock() = default;
+
+  /// @brief In-place construction so call sites can emplace a block and
+  ///   hand the message over without a refcount bump
+  TunnelMessageBlock(
+      TunnelDeliveryType type,
+      const kovri::core::IdentHash& ident,
+      std::uint32_t tunnel,
+      std::shared_ptr<I2NPMessage> msg)
+      : delivery_type(type),
+        hash(ident),
+        tunnel_ID(tunnel),
+        data(std::move(msg)) {}
+
   TunnelDeliveryType delivery_type;
   kovri::core::IdentHash hash;
   std::uint32_t tunnel_ID;
@@ -87,6 +101,12 @@ class TunnelBase {
 
   virtual std::uint32_t GetTunnelID() const = 0;  // as known at our side
 
+  /// @brief True when this tunnel relays traffic for another router;
+  ///   the transport bandwidth scheduler shapes such traffic separately
+  virtual bool IsTransit() const {
+    return false;
+  }
+
   std::uint64_t GetCreationTime() const {
     return m_CreationTime;
   }
@@ -42,6 +42,8 @@
 #include "core/router/context.h"
 #include "core/router/net_db/impl.h"
 #include "core/router/transports/impl.h"
+#include "core/router/tunnel/impl.h"
+#include "core/router/tunnel/pool.h"
 
 #include "core/util/log.h"
 
@@ -73,7 +75,7 @@ void TunnelEndpoint::HandleDecryptedTunnelDataMsg(
     std::uint8_t hash[32];
     // TODO(anonimal): this try block should be larger or handled entirely by caller
     try {
-      kovri::core::SHA256().CalculateDigest(
+      kovri::core::ThreadLocalSHA256().CalculateDigest(
           hash,
           fragment,
           // payload + iv
@@ -149,10 +151,9 @@ void TunnelEndpoint::HandleDecryptedTunnelDataMsg(
         if (msg_ID) {  // msg_ID is presented, assume message is fragmented
           if (!is_follow_on_fragment) {  // create new incomplete message
             m.next_fragment_num = 1;
-            auto ret = m_IncompleteMessages.insert(
-                std::pair<std::uint32_t, TunnelMessageBlockEx>(msg_ID, m));
+            auto ret = m_IncompleteMessages.Insert(msg_ID, std::move(m));
             if (ret.second)
-              HandleOutOfSequenceFragment(msg_ID, ret.first->second);
+              HandleOutOfSequenceFragment(msg_ID, *ret.first);
             else
               LOG(error)
                 << "TunnelEndpoint: incomplete message "
@@ -172,6 +173,36 @@ void TunnelEndpoint::HandleDecryptedTunnelDataMsg(
   } else {
     LOG(error) << "TunnelEndpoint: " << __func__ << ": zero not found";
   }
+  FlushGarlicMessages();
+  FlushForwardedMessages();
+}
+
+void TunnelEndpoint::FlushGarlicMessages() {
+  if (m_GarlicBatch.empty())
+    return;
+  // every message of the cycle arrived through the same tunnel, so the
+  // whole batch shares one destination
+  std::shared_ptr<TunnelPool> pool;
+  if (m_GarlicBatch.front()->from)
+    pool = m_GarlicBatch.front()->from->GetTunnelPool();
+  if (pool) {
+    pool->ProcessGarlicMessages(std::move(m_GarlicBatch));
+  } else {
+    // no local pool (context traffic): single-message dispatch
+    for (auto& msg : m_GarlicBatch)
+      kovri::core::HandleI2NPMessage(std::move(msg));
+  }
+  m_GarlicBatch.clear();
+}
+
+void TunnelEndpoint::FlushForwardedMessages() {
+  if (m_ForwardBatch.empty())
+    return;
+  // a full TunnelData message usually unpacks to several blocks for the
+  // same next hop; one post per hop keeps the cross-thread cost per-peer
+  for (auto& batch : m_ForwardBatch)
+    kovri::core::transports.SendMessages(batch.first, batch.second);
+  m_ForwardBatch.clear();
 }
 
 void TunnelEndpoint::HandleFollowOnFragment(
@@ -180,9 +211,9 @@ void TunnelEndpoint::HandleFollowOnFragment(
     const TunnelMessageBlockEx& m) {
   auto fragment = m.data->GetBuffer();
   auto size = m.data->GetLength();
-  auto it = m_IncompleteMessages.find(msg_ID);
-  if (it != m_IncompleteMessages.end()) {
-    auto& msg = it->second;
+  auto* incomplete = m_IncompleteMessages.Find(msg_ID);
+  if (incomplete) {
+    auto& msg = *incomplete;
     if (m.next_fragment_num == msg.next_fragment_num) {
       // check if message is not too long
       if (msg.data->len + size < I2NP_MAX_MESSAGE_SIZE) {
@@ -200,7 +231,7 @@ void TunnelEndpoint::HandleFollowOnFragment(
         if (is_last_fragment) {
           // message complete
           HandleNextMessage(msg);
-          m_IncompleteMessages.erase(it);
+          m_IncompleteMessages.Erase(msg_ID);
         } else {
           msg.next_fragment_num++;
           HandleOutOfSequenceFragment(msg_ID, msg);
@@ -210,7 +241,7 @@ void TunnelEndpoint::HandleFollowOnFragment(
           << "TunnelEndpoint: fragment " << m.next_fragment_num
           << " of message " << msg_ID
           << "exceeds max I2NP message size. Message dropped";
-        m_IncompleteMessages.erase(it);
+        m_IncompleteMessages.Erase(msg_ID);
       }
     } else {
       LOG(debug)
@@ -242,24 +273,23 @@ void TunnelEndpoint::AddOutOfSequenceFragment(
     std::uint8_t fragment_num,
     bool is_last_fragment,
     std::shared_ptr<I2NPMessage> data) {
-  auto it = m_OutOfSequenceFragments.find(msg_ID);
-  if (it == m_OutOfSequenceFragments.end())
-    m_OutOfSequenceFragments.insert(
-        std::pair<std::uint32_t, Fragment> (
-          msg_ID,
-          {fragment_num, is_last_fragment, data}));
+  if (m_OutOfSequenceFragments
+          .Insert(msg_ID, Fragment{fragment_num, is_last_fragment, data})
+          .second
+      && m_OutOfSequenceFragments.Size() > m_MaxOutOfSequenceWindow)
+    m_MaxOutOfSequenceWindow = m_OutOfSequenceFragments.Size();
 }
 
 void TunnelEndpoint::HandleOutOfSequenceFragment(
     std::uint32_t msg_ID, TunnelMessageBlockEx& msg) {
-  auto it = m_OutOfSequenceFragments.find(msg_ID);
-  if (it != m_OutOfSequenceFragments.end()) {
-    if (it->second.fragment_num == msg.next_fragment_num) {
+  auto* frag = m_OutOfSequenceFragments.Find(msg_ID);
+  if (frag) {
+    if (frag->fragment_num == msg.next_fragment_num) {
       LOG(debug)
         << "TunnelEndpoint: out-of-sequence fragment "
-        << static_cast<int>(it->second.fragment_num)
+        << static_cast<int>(frag->fragment_num)
         << " of message " << msg_ID << " found";
-      auto size = it->second.data->GetLength();
+      auto size = frag->data->GetLength();
       if (msg.data->len + size > msg.data->max_len) {
         LOG(debug)
           << "TunnelEndpoint: I2NP message size "
@@ -270,17 +300,17 @@ void TunnelEndpoint::HandleOutOfSequenceFragment(
       }
       memcpy(  // concatenate out-of-sync fragment
           msg.data->buf + msg.data->len,
-          it->second.data->GetBuffer(),
+          frag->data->GetBuffer(),
           size);
       msg.data->len += size;
-      if (it->second.is_last_fragment) {
+      if (frag->is_last_fragment) {
         // message complete
         HandleNextMessage(msg);
-        m_IncompleteMessages.erase(msg_ID);
+        m_IncompleteMessages.Erase(msg_ID);
       } else {
         msg.next_fragment_num++;
       }
-      m_OutOfSequenceFragments.erase(it);
+      m_OutOfSequenceFragments.Erase(msg_ID);
     }
   }
 }
@@ -293,15 +323,21 @@ void TunnelEndpoint::HandleNextMessage(
     << static_cast<int>(msg.data->GetTypeID());
   switch (msg.delivery_type) {
     case e_DeliveryTypeLocal:
-      kovri::core::HandleI2NPMessage(msg.data);
+      // garlic messages wait in the cycle batch (see FlushGarlicMessages);
+      // everything else keeps the immediate dispatch
+      if (msg.data->GetTypeID() == I2NPGarlic)
+        m_GarlicBatch.push_back(msg.data);
+      else
+        kovri::core::HandleI2NPMessage(msg.data);
     break;
-    case e_DeliveryTypeTunnel:
-      kovri::core::transports.SendMessage(
-          msg.hash,
-          kovri::core::CreateTunnelGatewayMsg(
-            msg.tunnel_ID,
-            msg.data));
+    case e_DeliveryTypeTunnel: {
+      auto gateway_msg = kovri::core::CreateTunnelGatewayMsg(
+          msg.tunnel_ID,
+          msg.data);
+      gateway_msg->transit = !m_IsInbound;  // outbound endpoint => transit
+      m_ForwardBatch[msg.hash].push_back(gateway_msg);
     break;
+    }
     case e_DeliveryTypeRouter:
       // check if message is sent to us
       if (msg.hash == context.GetRouterInfo().GetIdentHash()) {
@@ -314,7 +350,8 @@ void TunnelEndpoint::HandleNextMessage(
             // catch RI or reply with new list of routers
             kovri::core::netdb.PostI2NPMsg (msg.data);*/
           // TODO(unassigned): ^ ???
-          kovri::core::transports.SendMessage(msg.hash, msg.data);
+          msg.data->transit = true;
+          m_ForwardBatch[msg.hash].push_back(msg.data);
         } else {  // we shouldn't send this message. possible leakage
           LOG(error)
             << "TunnelEndpoint: message to another router "
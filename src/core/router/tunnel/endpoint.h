@@ -36,7 +36,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "core/router/i2np.h"
 #include "core/router/tunnel/base.h"
@@ -46,6 +49,122 @@
 namespace kovri {
 namespace core {
 
+/// @class TunnelFragmentTable
+/// @brief Small open-addressing hash table keyed by message ID with entries
+///   stored inline in a flat array, so the per-fragment reassembly path does
+///   no node allocations. Endpoints are driven from a single thread, so the
+///   table is not synchronized
+template <typename Value>
+class TunnelFragmentTable {
+ public:
+  explicit TunnelFragmentTable(
+      std::size_t initial_buckets = 16)
+      : m_Size(0),
+        m_Tombstones(0),
+        m_Buckets(initial_buckets) {}
+
+  /// @brief Inserts the entry for msg_ID unless one already exists
+  /// @return The stored entry and whether it was newly inserted
+  std::pair<Value*, bool> Insert(
+      std::uint32_t msg_ID,
+      Value value) {
+    // 0.75 load factor counting tombstones, so probes stay short and an
+    // empty bucket always terminates the scan; rehashing at the same size
+    // merely clears accumulated tombstones
+    if ((m_Size + m_Tombstones + 1) * 4 > m_Buckets.size() * 3)
+      Rehash(
+          (m_Size + 1) * 4 > m_Buckets.size() * 3
+              ? m_Buckets.size() * 2
+              : m_Buckets.size());
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::size_t pos = Hash(msg_ID) & mask;
+    Bucket* tombstone = nullptr;
+    for (;;) {
+      Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Full && bucket.msg_ID == msg_ID)
+        return {&bucket.value, false};
+      if (bucket.state == Bucket::Tombstone && !tombstone) {
+        tombstone = &bucket;
+      } else if (bucket.state == Bucket::Empty) {
+        Bucket& target = tombstone ? *tombstone : bucket;
+        if (tombstone)
+          m_Tombstones--;
+        target.msg_ID = msg_ID;
+        target.value = std::move(value);
+        target.state = Bucket::Full;
+        m_Size++;
+        return {&target.value, true};
+      }
+      pos = (pos + 1) & mask;
+    }
+  }
+
+  Value* Find(
+      std::uint32_t msg_ID) {
+    Bucket* bucket = FindBucket(msg_ID);
+    return bucket ? &bucket->value : nullptr;
+  }
+
+  bool Erase(
+      std::uint32_t msg_ID) {
+    Bucket* bucket = FindBucket(msg_ID);
+    if (!bucket)
+      return false;
+    bucket->value = Value();
+    bucket->state = Bucket::Tombstone;
+    m_Size--;
+    m_Tombstones++;
+    return true;
+  }
+
+  std::size_t Size() const {
+    return m_Size;
+  }
+
+ private:
+  struct Bucket {
+    enum State : std::uint8_t { Empty = 0, Full, Tombstone };
+    std::uint32_t msg_ID = 0;
+    Value value;
+    State state = Empty;
+  };
+
+  static std::size_t Hash(
+      std::uint32_t msg_ID) {
+    return msg_ID * 2654435761U;  // Knuth multiplicative
+  }
+
+  Bucket* FindBucket(
+      std::uint32_t msg_ID) {
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::size_t pos = Hash(msg_ID) & mask;
+    for (std::size_t probe = 0; probe < m_Buckets.size(); probe++) {
+      Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Empty)
+        return nullptr;
+      if (bucket.state == Bucket::Full && bucket.msg_ID == msg_ID)
+        return &bucket;
+      pos = (pos + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  void Rehash(
+      std::size_t new_buckets) {
+    std::vector<Bucket> old = std::move(m_Buckets);
+    m_Buckets.assign(new_buckets, Bucket());
+    m_Size = 0;
+    m_Tombstones = 0;
+    for (auto& bucket : old)
+      if (bucket.state == Bucket::Full)
+        Insert(bucket.msg_ID, std::move(bucket.value));
+  }
+
+ private:
+  std::size_t m_Size, m_Tombstones;
+  std::vector<Bucket> m_Buckets;
+};
+
 class TunnelEndpoint {
   struct TunnelMessageBlockEx : public TunnelMessageBlock {
     std::uint8_t next_fragment_num;
@@ -62,6 +181,7 @@ class TunnelEndpoint {
         bool is_inbound)
         : m_IsInbound(is_inbound),
           m_NumReceivedBytes(0),
+          m_MaxOutOfSequenceWindow(0),
           m_Exception(__func__) {}
 
     ~TunnelEndpoint();
@@ -70,6 +190,17 @@ class TunnelEndpoint {
       return m_NumReceivedBytes;
     }
 
+    /// @brief Fragments currently parked ahead of their expected turn
+    std::size_t GetOutOfSequenceWindow() const {
+      return m_OutOfSequenceFragments.Size();
+    }
+
+    /// @brief Deepest the out-of-sequence window has been; a growing value
+    ///   points at reassembly stalls on this endpoint
+    std::size_t GetMaxOutOfSequenceWindow() const {
+      return m_MaxOutOfSequenceWindow;
+    }
+
     void HandleDecryptedTunnelDataMsg(
         std::shared_ptr<I2NPMessage> msg);
 
@@ -92,11 +223,26 @@ class TunnelEndpoint {
         std::uint32_t msg_ID,
         TunnelMessageBlockEx& msg);
 
+    /// @brief Hands the garlic messages accumulated over one processing
+    ///   cycle to their destination in a single cross-thread post
+    void FlushGarlicMessages();
+
+    /// @brief Forwards the messages accumulated over one processing cycle
+    ///   to the transports, one batched post per next hop instead of one
+    ///   per tunnel message block
+    void FlushForwardedMessages();
+
  private:
-    std::map<std::uint32_t, TunnelMessageBlockEx> m_IncompleteMessages;
-    std::map<std::uint32_t, Fragment> m_OutOfSequenceFragments;
+    TunnelFragmentTable<TunnelMessageBlockEx> m_IncompleteMessages;
+    TunnelFragmentTable<Fragment> m_OutOfSequenceFragments;
     bool m_IsInbound;
+    // locally delivered garlic messages of the current cycle
+    std::vector<std::shared_ptr<I2NPMessage>> m_GarlicBatch;
+    // messages of the current cycle to forward, grouped by next hop
+    std::map<IdentHash, std::vector<std::shared_ptr<I2NPMessage>>>
+        m_ForwardBatch;
     std::size_t m_NumReceivedBytes;
+    std::size_t m_MaxOutOfSequenceWindow;
     core::Exception m_Exception;
 };
 
@@ -34,6 +34,8 @@
 
 #include <string.h>
 
+#include <utility>
+
 #include "core/crypto/hash.h"
 #include "core/crypto/rand.h"
 
@@ -47,24 +49,65 @@ namespace core {
 
 // TODO(anonimal): bytestream refactor
 
+namespace {
+
+/// @brief Bulk randomness for gateway framing, refilled in one RandBytes
+///   call instead of one RNG trip per completed tunnel data message.
+///   Thread-local: gateways may run on sharded crypto workers
+struct GatewayRandom {
+  enum Size : std::uint16_t {
+    /// @brief Fresh IVs generated per refill (64 messages worth)
+    IVPool = 64 * 16,
+  };
+
+  /// @return Pointer to size non-zero bytes of padding
+  /// @notes Padding is random-looking filler and may repeat; a rolling
+  ///   cursor replaces the previous random offset per message
+  const std::uint8_t* Padding(const std::size_t size) {
+    if (!m_PaddingReady) {
+      kovri::core::RandNonZeroBytes(m_Padding, sizeof(m_Padding));
+      m_PaddingReady = true;
+    }
+    if (m_PaddingOffset + size > sizeof(m_Padding))
+      m_PaddingOffset = 0;
+    const std::uint8_t* pad = m_Padding + m_PaddingOffset;
+    m_PaddingOffset += size;
+    return pad;
+  }
+
+  /// @return Pointer to 16 fresh random bytes (never reused)
+  const std::uint8_t* NextIV() {
+    if (m_IVOffset + 16 > sizeof(m_IVs)) {
+      kovri::core::RandBytes(m_IVs, sizeof(m_IVs));
+      m_IVOffset = 0;
+    }
+    const std::uint8_t* IV = m_IVs + m_IVOffset;
+    m_IVOffset += 16;
+    return IV;
+  }
+
+ private:
+  std::uint8_t m_Padding[TUNNEL_DATA_MAX_PAYLOAD_SIZE];
+  std::uint8_t m_IVs[Size::IVPool];
+  std::size_t m_PaddingOffset{}, m_IVOffset{Size::IVPool};
+  bool m_PaddingReady{};
+};
+
+thread_local GatewayRandom g_GatewayRandom;
+
+}  // namespace
+
 TunnelGatewayBuffer::TunnelGatewayBuffer(
     std::uint32_t tunnel_ID)
     : m_TunnelID(tunnel_ID),
       m_CurrentTunnelDataMsg(nullptr),
       m_RemainingSize(0),
-      m_Exception(__func__) {
-  kovri::core::RandBytes(
-      m_NonZeroRandomBuffer,
-      TUNNEL_DATA_MAX_PAYLOAD_SIZE);
-  for (std::size_t i = 0; i < TUNNEL_DATA_MAX_PAYLOAD_SIZE; i++)
-    if (!m_NonZeroRandomBuffer[i])
-      m_NonZeroRandomBuffer[i] = 1;
-}
+      m_Exception(__func__) {}
 
 TunnelGatewayBuffer::~TunnelGatewayBuffer() {}
 
 void TunnelGatewayBuffer::PutI2NPMsg(
-    const TunnelMessageBlock& block) {
+    TunnelMessageBlock&& block) {
   bool message_created = false;
   if (!m_CurrentTunnelDataMsg) {
     CreateCurrentTunnelDataMessage();
@@ -84,7 +127,7 @@ void TunnelGatewayBuffer::PutI2NPMsg(
   // set delivery type
   di[0] = block.delivery_type << 5;
   // create fragments
-  std::shared_ptr<I2NPMessage> msg = block.data;
+  std::shared_ptr<I2NPMessage> msg = std::move(block.data);
   // delivery instructions + payload + 2 bytes length
   auto full_msg_len = di_len + msg->GetLength() + 2;
   if (full_msg_len <= m_RemainingSize) {
@@ -172,12 +215,71 @@ void TunnelGatewayBuffer::PutI2NPMsg(
     } else {
       // delivery instructions don't fit. Create new message
       CompleteCurrentTunnelDataMessage();
-      PutI2NPMsg(block);
+      block.data = std::move(msg);
+      PutI2NPMsg(std::move(block));
       // don't delete msg because it's taken care inside
     }
   }
 }
 
+bool TunnelGatewayBuffer::PutSingleFragment(
+    const TunnelMessageBlock& block) {
+  if (m_CurrentTunnelDataMsg)
+    return false;  // entries queued before us must stay ahead
+  // create delivery instructions
+  std::uint8_t di[43];  // max delivery instruction length is 43 for tunnel
+  std::size_t di_len = 1;  // flag
+  if (block.delivery_type != e_DeliveryTypeLocal) {  // tunnel or router
+    if (block.delivery_type == e_DeliveryTypeTunnel) {
+      core::OutputByteStream::Write<std::uint32_t>(di + di_len, block.tunnel_ID);
+      di_len += 4;  // tunnel_ID
+    }
+    memcpy(di + di_len, block.hash, 32);
+    di_len += 32;  // len
+  }
+  di[0] = block.delivery_type << 5;
+  const auto& msg = block.data;
+  std::size_t const entry_len = di_len + 2 + msg->GetLength();
+  if (entry_len > TUNNEL_DATA_MAX_PAYLOAD_SIZE)
+    return false;  // needs fragmenting
+  core::OutputByteStream::Write<std::uint16_t>(di + di_len, msg->GetLength());
+  di_len += 2;  // size
+  try {
+    // final positions are known up front, so the frame is laid out once:
+    // tunnel_ID | IV | checksum | padding | zero | instructions + payload
+    auto tunnel_msg = ToSharedI2NPMessage(NewI2NPShortMessage());
+    tunnel_msg->Align(12);
+    std::uint8_t* const frame = tunnel_msg->GetPayload();
+    std::size_t const padding_size = TUNNEL_DATA_MAX_PAYLOAD_SIZE - entry_len;
+    std::uint8_t* const entry = frame + 25 + padding_size;  // 25 = 24 + 1
+    memcpy(entry, di, di_len);
+    memcpy(entry + di_len, msg->GetBuffer(), msg->GetLength());
+    core::OutputByteStream::Write<std::uint32_t>(frame, m_TunnelID);
+    memcpy(frame + 4, g_GatewayRandom.NextIV(), 16);  // original IV
+    // the entry ends at the frame boundary; the IV copy for the checksum
+    // lands in the short message's spare tail
+    memcpy(entry + entry_len, frame + 4, 16);
+    std::uint8_t hash[32];
+    kovri::core::ThreadLocalSHA256().CalculateDigest(
+        hash, entry, entry_len + 16);
+    memcpy(frame + 20, hash, 4);  // checksum
+    if (padding_size > 0) {
+      // non-zero padding
+      memcpy(frame + 24, g_GatewayRandom.Padding(padding_size), padding_size);
+    }
+    frame[24 + padding_size] = 0;  // zero
+    tunnel_msg->len =
+      tunnel_msg->offset + I2NP_HEADER_SIZE + TUNNEL_DATA_MSG_SIZE;
+    // we can't fill message header yet because encryption is required
+    m_TunnelDataMsgs.push_back(tunnel_msg);
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+    throw;
+  }
+  return true;
+}
+
 void TunnelGatewayBuffer::ClearTunnelDataMsgs() {
   m_TunnelDataMsgs.clear();
 }
@@ -202,23 +304,19 @@ void TunnelGatewayBuffer::CompleteCurrentTunnelDataMessage() {
       m_CurrentTunnelDataMsg->len - TUNNEL_DATA_MSG_SIZE - I2NP_HEADER_SIZE;
     std::uint8_t* buf = m_CurrentTunnelDataMsg->GetPayload();
     core::OutputByteStream::Write<std::uint32_t>(buf, m_TunnelID);
-    kovri::core::RandBytes(buf + 4, 16);  // original IV
+    memcpy(buf + 4, g_GatewayRandom.NextIV(), 16);  // original IV
     memcpy(payload + size, buf + 4, 16);  // copy IV for checksum
     std::uint8_t hash[32];
-    kovri::core::SHA256().CalculateDigest(hash, payload, size + 16);
+    kovri::core::ThreadLocalSHA256().CalculateDigest(hash, payload, size + 16);
     memcpy(buf + 20, hash, 4);  // checksum
     // TODO(unassigned): review, refactor
     payload[-1] = 0;  // zero
     ptrdiff_t padding_size = payload - buf - 25;  // 25  = 24 + 1
     if (padding_size > 0) {
       // non-zero padding
-      std::uint32_t random_offset =
-        kovri::core::RandInRange32(
-          0,
-          TUNNEL_DATA_MAX_PAYLOAD_SIZE - padding_size);
       memcpy(
           buf + 24,
-          m_NonZeroRandomBuffer + random_offset,
+          g_GatewayRandom.Padding(padding_size),
           padding_size);
     }
     // we can't fill message header yet because encryption is required
@@ -232,25 +330,36 @@ void TunnelGatewayBuffer::CompleteCurrentTunnelDataMessage() {
 }
 
 void TunnelGateway::SendTunnelDataMsg(
-    const TunnelMessageBlock& block) {
+    TunnelMessageBlock&& block) {
   if (block.data) {
-    PutTunnelDataMsg(block);
+    // most gateway messages fit one frame: encode in a single pass and
+    // fall back to the fragmenting path only when they don't
+    if (!m_Buffer.PutSingleFragment(block))
+      PutTunnelDataMsg(std::move(block));
     SendBuffer();
   }
 }
 
 void TunnelGateway::PutTunnelDataMsg(
-    const TunnelMessageBlock& block) {
+    TunnelMessageBlock&& block) {
   if (block.data)
-    m_Buffer.PutI2NPMsg(block);
+    m_Buffer.PutI2NPMsg(std::move(block));
 }
 
 void TunnelGateway::SendBuffer() {
   m_Buffer.CompleteCurrentTunnelDataMessage();
+  // a transit hop has no way to pace its producer: when the next hop's
+  // send queue is full, shed here before paying for encryption
+  if (m_Tunnel->IsTransit()
+      && kovri::core::transports.IsBacklogged(m_Tunnel->GetNextIdentHash())) {
+    m_Buffer.ClearTunnelDataMsgs();
+    return;
+  }
   auto tunnel_msgs = m_Buffer.GetTunnelDataMsgs();
   for (auto tunnel_msg : tunnel_msgs) {
     m_Tunnel->EncryptTunnelMsg(tunnel_msg, tunnel_msg);
     tunnel_msg->FillI2NPMessageHeader(I2NPTunnelData);
+    tunnel_msg->transit = m_Tunnel->IsTransit();
     m_NumSentBytes += TUNNEL_DATA_MSG_SIZE;
   }
   kovri::core::transports.SendMessages(
@@ -53,6 +53,15 @@ class TunnelGatewayBuffer {
   ~TunnelGatewayBuffer();
 
   void PutI2NPMsg(
+      TunnelMessageBlock&& block);
+
+  /// @brief One-pass encoder for a message that fits a single tunnel
+  ///   data frame: writes delivery instructions, payload, padding, IV
+  ///   and checksum at their final positions, bypassing the
+  ///   fragmentation state machine
+  /// @return False when the block needs the fragmenting path (oversized,
+  ///   or a partially filled frame is already open)
+  bool PutSingleFragment(
       const TunnelMessageBlock& block);
 
   const std::vector<std::shared_ptr<I2NPMessage> >& GetTunnelDataMsgs() const {
@@ -71,7 +80,6 @@ class TunnelGatewayBuffer {
   std::vector<std::shared_ptr<I2NPMessage> > m_TunnelDataMsgs;
   std::shared_ptr<I2NPMessage> m_CurrentTunnelDataMsg;
   std::size_t m_RemainingSize;
-  std::uint8_t m_NonZeroRandomBuffer[TUNNEL_DATA_MAX_PAYLOAD_SIZE];
   core::Exception m_Exception;
 };
 
@@ -84,10 +92,10 @@ class TunnelGateway {
         m_NumSentBytes(0) {}
 
   void SendTunnelDataMsg(
-      const TunnelMessageBlock& block);
+      TunnelMessageBlock&& block);
 
   void PutTunnelDataMsg(
-      const TunnelMessageBlock& block);
+      TunnelMessageBlock&& block);
 
   void SendBuffer();
 
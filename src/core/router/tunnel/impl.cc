@@ -34,14 +34,25 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "core/crypto/rand.h"
 
 #include "core/router/context.h"
 #include "core/router/net_db/impl.h"
 #include "core/router/transports/impl.h"
 
+#include "core/util/event_bus.h"
+#include "core/util/histogram.h"
 #include "core/util/log.h"
+#include "core/util/metrics.h"
+#include "core/util/thread_registry.h"
 #include "core/util/timestamp.h"
+#include "core/util/trace.h"
 
 namespace kovri {
 namespace core {
@@ -54,6 +65,11 @@ Tunnel::Tunnel(
       m_Pool(nullptr),
       m_State(e_TunnelStatePending),
       m_IsRecreated(false),
+      m_IsSamePathRecreation(false),
+      m_RTTSamples{{}},
+      m_NumRTTSamples(0),
+      m_NumConsecutiveTests(0),
+      m_BuildStartTime(0),
       m_Exception(__func__) {}
 
 Tunnel::~Tunnel() {}
@@ -75,20 +91,57 @@ void Tunnel::Build(
     for (int i = 0; i < num_records; i++)
       record_indicies.push_back(i);
     kovri::core::Shuffle(record_indicies.begin(), record_indicies.end());
-    // create real records
+    // create real records; each record is independent and its ElGamal
+    // encryption dominates build latency, so encrypt the hops in parallel
     std::uint8_t* records = msg->GetPayload() + 1;
+    struct BuildRecordJob {
+      TunnelHopConfig* hop;
+      std::uint8_t* record;
+      std::uint32_t reply_msg_ID;
+    };
+    std::vector<BuildRecordJob> jobs;
     TunnelHopConfig* hop = m_Config->GetFirstHop();
     int i = 0;
     while (hop) {
       int idx = record_indicies[i];
-      hop->CreateBuildRequestRecord(
-          records + idx * TUNNEL_BUILD_RECORD_SIZE,
-          // we set reply_msg_ID for last hop only
-          hop->GetNextHop() ? Rand<std::uint32_t>() : reply_msg_ID);
+      jobs.push_back(
+          BuildRecordJob{
+              hop,
+              records + idx * TUNNEL_BUILD_RECORD_SIZE,
+              // we set reply_msg_ID for last hop only
+              hop->GetNextHop() ? Rand<std::uint32_t>() : reply_msg_ID});
       hop->SetRecordIndex(idx);
       i++;
       hop = hop->GetNextHop();
     }
+    std::vector<std::exception_ptr> errors(jobs.size());
+    std::vector<std::thread> encryptors;
+    for (std::size_t job = 1; job < jobs.size(); job++)
+      encryptors.push_back(
+          std::thread([&jobs, &errors, job]() {
+            try {
+              jobs[job].hop->CreateBuildRequestRecord(
+                  jobs[job].record,
+                  jobs[job].reply_msg_ID);
+            } catch (...) {
+              errors[job] = std::current_exception();
+            }
+          }));
+    if (!jobs.empty()) {
+      // first hop's record is encrypted on the calling thread
+      try {
+        jobs[0].hop->CreateBuildRequestRecord(
+            jobs[0].record,
+            jobs[0].reply_msg_ID);
+      } catch (...) {
+        errors[0] = std::current_exception();
+      }
+    }
+    for (auto& encryptor : encryptors)
+      encryptor.join();
+    for (const auto& error : errors)
+      if (error)
+        std::rethrow_exception(error);
     // fill up fake records with random data
     for (int i = num_hops; i < num_records; i++) {
       int idx = record_indicies[i];
@@ -114,6 +167,7 @@ void Tunnel::Build(
     }
     msg->FillI2NPMessageHeader(I2NPVariableTunnelBuild);
     // send message
+    m_BuildStartTime = kovri::core::GetMillisecondsSinceEpoch();
     if (outbound_tunnel)
       outbound_tunnel->SendTunnelDataMsg(
           GetNextIdentHash(),
@@ -138,37 +192,57 @@ bool Tunnel::HandleTunnelBuildResponse(
   try {
     LOG(debug)
       << "Tunnel: TunnelBuildResponse " << static_cast<int>(msg[0]) << " records.";
+    // A parallel build already filled the pool while this reply was in
+    // flight: skip the decryption chain entirely, the participants will
+    // time the unused tunnel out
+    auto pool = GetTunnelPool();
+    if (pool && pool->IsSatisfied(m_Config->IsInbound())) {
+      LOG(debug)
+        << "Tunnel: pool satisfied by a parallel build, dropping response";
+      return false;
+    }
+    // Decrypt and check records in hop order. The response of hop i is
+    // wrapped in the reply keys of hops i..last, so the first hop costs
+    // the full chain but a reject there skips every record behind it
     kovri::core::CBCDecryption decryption;
-    TunnelHopConfig* hop = m_Config->GetLastHop();
-    while (hop) {
-      decryption.SetKey(hop->GetAESAttributes().reply_key.data());
-      // decrypt records before and including current hop
-      TunnelHopConfig* hop1 = hop;
-      while (hop1) {
-        auto idx = hop1->GetRecordIndex();
-        if (idx >= 0 && idx < msg[0]) {
-          std::uint8_t* record = msg + 1 + idx * TUNNEL_BUILD_RECORD_SIZE;
-          decryption.SetIV(hop->GetAESAttributes().reply_IV.data());
-          decryption.Decrypt(record, TUNNEL_BUILD_RECORD_SIZE, record);
-        } else {
-          LOG(warning) << "Tunnel: hop index " << idx << " is out of range";
-        }
-        hop1 = hop1->GetPreviousHop();
+    std::vector<std::pair<std::shared_ptr<const RouterInfo>, std::uint8_t>>
+        replies;
+    TunnelHopConfig* hop = m_Config->GetFirstHop();
+    while (hop && established) {
+      auto idx = hop->GetRecordIndex();
+      if (idx < 0 || idx >= msg[0]) {
+        LOG(warning) << "Tunnel: hop index " << idx << " is out of range";
+        established = false;
+        break;
+      }
+      std::uint8_t* record = msg + 1 + idx * TUNNEL_BUILD_RECORD_SIZE;
+      // keys are peeled outermost first (last hop inward), mirroring how
+      // each participant wrapped the reply on its way back
+      for (TunnelHopConfig* key_hop = m_Config->GetLastHop();;
+           key_hop = key_hop->GetPreviousHop()) {
+        decryption.SetKey(key_hop->GetAESAttributes().reply_key.data());
+        decryption.SetIV(key_hop->GetAESAttributes().reply_IV.data());
+        decryption.Decrypt(record, TUNNEL_BUILD_RECORD_SIZE, record);
+        if (key_hop == hop)
+          break;
       }
-      hop = hop->GetPreviousHop();
-    }
-    hop = m_Config->GetFirstHop();
-    while (hop) {
-      const std::uint8_t* record =
-        msg + 1 + hop->GetRecordIndex() * TUNNEL_BUILD_RECORD_SIZE;
       std::uint8_t ret = record[BUILD_RESPONSE_RECORD_RET_OFFSET];
       LOG(debug) << "Tunnel: ret code=" << static_cast<int>(ret);
-      hop->GetCurrentRouter()->GetProfile()->TunnelBuildResponse(ret);
+      replies.emplace_back(hop->GetCurrentRouter(), ret);
       if (ret)
-        // if any of participants declined the tunnel is not established
+        // first decliner aborts the remaining per-record chains
         established = false;
       hop = hop->GetNextHop();
     }
+    if (!replies.empty()) {
+      // first-seen routers load their profile from disk; keep that off
+      // the build path (same short-lived thread pattern as the request
+      // record encryption above)
+      std::thread([replies = std::move(replies)]() {
+        for (const auto& reply : replies)
+          reply.first->GetProfile()->TunnelBuildResponse(reply.second);
+      }).detach();
+    }
     if (established) {
       // change reply keys to layer keys
       hop = m_Config->GetFirstHop();
@@ -179,8 +253,15 @@ bool Tunnel::HandleTunnelBuildResponse(
         hop = hop->GetNextHop();
       }
     }
-    if (established)
+    if (established) {
       m_State = e_TunnelStateEstablished;
+      // measure at the accepting response, not at the management tick
+      // that later sweeps the pending table
+      if (m_BuildStartTime)
+        latency_histograms.Record(
+            LatencyHistograms::TunnelBuild,
+            kovri::core::GetMillisecondsSinceEpoch() - m_BuildStartTime);
+    }
   } catch (...) {
     m_Exception.Dispatch(__func__);
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
@@ -242,17 +323,40 @@ void OutboundTunnel::SendTunnelDataMsg(
   } else {
     block.delivery_type = e_DeliveryTypeLocal;
   }
-  block.data = msg;
-  std::unique_lock<std::mutex> l(m_SendMutex);
-  m_Gateway.SendTunnelDataMsg(block);
+  block.data = std::move(msg);
+  // Publish lock-free, then volunteer to drain: on the common path the
+  // producing thread flushes its own block straight through the gateway
+  while (!m_SendQueue.TryEnqueue(std::move(block)))
+    FlushSendQueue();  // ring full: drain in place rather than drop
+  FlushSendQueue();
 }
 
 void OutboundTunnel::SendTunnelDataMsg(
-    const std::vector<TunnelMessageBlock>& msgs) {
-  std::unique_lock<std::mutex> l(m_SendMutex);
+    std::vector<TunnelMessageBlock>&& msgs) {
   for (auto& it : msgs)
-    m_Gateway.PutTunnelDataMsg(it);
-  m_Gateway.SendBuffer();
+    while (!m_SendQueue.TryEnqueue(std::move(it)))
+      FlushSendQueue();
+  FlushSendQueue();
+}
+
+void OutboundTunnel::FlushSendQueue() {
+  // One drainer at a time keeps the gateway single-threaded without a
+  // mutex on the producer path. A producer that loses the flag simply
+  // leaves; the winner re-checks after releasing, so a block published
+  // concurrently with its exit is picked up here or by the next sender
+  while (!m_SendQueue.Empty()) {
+    if (m_Flushing.exchange(true, std::memory_order_acquire))
+      return;  // someone else is draining and will re-check
+    TunnelMessageBlock block;
+    bool drained = false;
+    while (m_SendQueue.TryDequeue(block)) {
+      m_Gateway.PutTunnelDataMsg(std::move(block));
+      drained = true;
+    }
+    if (drained)
+      m_Gateway.SendBuffer();
+    m_Flushing.store(false, std::memory_order_release);
+  }
 }
 
 void OutboundTunnel::HandleTunnelDataMsg(
@@ -269,14 +373,12 @@ Tunnels tunnels;
 Tunnels::Tunnels()
     : m_IsRunning(false),
       m_Thread(nullptr),
+      m_PendingWorkerMsgs(0),
+      m_LastCandidateRefresh(0),
       m_NumSuccesiveTunnelCreations(0),
       m_NumFailedTunnelCreations(0) {}
 
-Tunnels::~Tunnels() {
-  for (auto& it : m_TransitTunnels)
-    delete it.second;
-  m_TransitTunnels.clear();
-}
+Tunnels::~Tunnels() {}  // m_TransitTunnels deletes its tunnels
 
 std::shared_ptr<InboundTunnel> Tunnels::GetInboundTunnel(
     std::uint32_t tunnel_ID) {
@@ -288,10 +390,8 @@ std::shared_ptr<InboundTunnel> Tunnels::GetInboundTunnel(
 
 TransitTunnel* Tunnels::GetTransitTunnel(
     std::uint32_t tunnel_ID) {
-  auto it = m_TransitTunnels.find(tunnel_ID);
-  if (it != m_TransitTunnels.end())
-    return it->second;
-  return nullptr;
+  // workers insert transit tunnels concurrently with this lookup
+  return m_TransitTunnels.Find(tunnel_ID);
 }
 
 std::shared_ptr<InboundTunnel> Tunnels::GetPendingInboundTunnel(
@@ -339,7 +439,7 @@ std::shared_ptr<InboundTunnel> Tunnels::GetNextInboundTunnel() {
 std::shared_ptr<OutboundTunnel> Tunnels::GetNextOutboundTunnel() {
   // TODO(unassigned): integer size
   std::uint32_t s = m_OutboundTunnels.size();
-  std::uint32_t ind = kovri::core::RandInRange32(0, s - 1);
+  std::uint32_t ind = kovri::core::FastRandInRange32(0, s - 1);
   std::uint32_t i = 0;
   std::shared_ptr<OutboundTunnel> tunnel;
   for (auto it : m_OutboundTunnels) {
@@ -392,11 +492,8 @@ void Tunnels::StopTunnelPool(
 
 void Tunnels::AddTransitTunnel(
     TransitTunnel* tunnel) {
-  std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
-  if (!m_TransitTunnels.insert(
-        std::make_pair(
-          tunnel->GetTunnelID(),
-          tunnel)).second) {
+  if (!m_TransitTunnels.Insert(
+          tunnel, tunnel->GetCreationTime() + TUNNEL_EXPIRATION_TIMEOUT)) {
     LOG(error)
       << "Tunnels: transit tunnel "
       << tunnel->GetTunnelID() << " already exists";
@@ -406,6 +503,20 @@ void Tunnels::AddTransitTunnel(
 
 void Tunnels::Start() {
   m_IsRunning = true;
+  // optional worker pool: shard tunnel crypto by tunnel ID across N threads
+  std::size_t num_workers = 0;
+  if (context.GetOpts().count("tunnel-crypto-workers"))
+    num_workers = context.GetOpts()["tunnel-crypto-workers"].as<std::uint16_t>();
+  for (std::size_t worker = 0; worker < num_workers; worker++)
+    m_WorkerQueues.push_back(
+        std::make_unique<kovri::core::Queue<TunnelWorkItem>>());
+  for (std::size_t worker = 0; worker < num_workers; worker++)
+    m_CryptoWorkers.push_back(
+        std::make_unique<std::thread>(
+            std::bind(
+              &Tunnels::RunCryptoWorker,
+              this,
+              worker)));
   m_Thread =
     std::make_unique<std::thread>(
         std::bind(
@@ -416,6 +527,12 @@ void Tunnels::Start() {
 void Tunnels::Stop() {
   m_IsRunning = false;
   m_Queue.WakeUp();
+  for (auto& queue : m_WorkerQueues)
+    queue->WakeUp();
+  for (auto& worker : m_CryptoWorkers)
+    worker->join();
+  m_CryptoWorkers.clear();
+  m_WorkerQueues.clear();
   if (m_Thread) {
     m_Thread->join();
     m_Thread.reset(nullptr);
@@ -423,18 +540,30 @@ void Tunnels::Stop() {
 }
 
 void Tunnels::Run() {
+  thread_registry.Register("tunnels");
   // wait for other parts are ready
   std::this_thread::sleep_for(std::chrono::seconds(1));
   std::uint64_t last_ts = 0;
   while (m_IsRunning) {
     try {
-      auto msg = m_Queue.GetNextWithTimeout(1000);  // 1 sec
-      if (msg) {
+      // drain a batch per wakeup instead of one mutex round-trip per message
+      const std::size_t max_batch = 64;
+      std::vector<std::shared_ptr<I2NPMessage>> msgs;
+      if (m_Queue.GetBatchWithTimeout(msgs, max_batch, 1000)) {  // 1 sec
         std::uint32_t prev_tunnel_ID = 0,
                  tunnel_ID = 0;
         TunnelBase* prev_tunnel = nullptr;
-        do {
-          TunnelBase* tunnel = nullptr;
+        TunnelBase* tunnel = nullptr;
+        const std::uint64_t now = kovri::core::GetMillisecondsSinceEpoch();
+        for (const auto& msg : msgs) {
+          // messages can age out while parked in the queue; drop them
+          // here rather than decrypt and forward dead traffic
+          if (msg->IsExpired(now)) {
+            LOG(debug) << "Tunnels: message expired in queue, dropped";
+            metrics.Inc(Metrics::ExpiredMsgDrops);
+            continue;
+          }
+          tunnel = nullptr;
           std::uint8_t type_ID = msg->GetTypeID();
           switch (type_ID) {
             case I2NPTunnelData:
@@ -442,25 +571,50 @@ void Tunnels::Run() {
               tunnel_ID = core::InputByteStream::Read<std::uint32_t>(msg->GetPayload());
               if (tunnel_ID == prev_tunnel_ID)
                 tunnel = prev_tunnel;
-              else if (prev_tunnel)
+              else if (prev_tunnel && m_WorkerQueues.empty())
                 prev_tunnel->FlushTunnelDataMsgs();
               if (!tunnel && type_ID == I2NPTunnelData)
                 tunnel = GetInboundTunnel(tunnel_ID).get();
               if (!tunnel)
                 tunnel = GetTransitTunnel(tunnel_ID);
               if (tunnel) {
-                if (type_ID == I2NPTunnelData)
+                if (!m_WorkerQueues.empty()) {
+                  // shard by tunnel ID so each tunnel's messages stay on one
+                  // worker in FIFO order; the worker flushes after its batch
+                  m_PendingWorkerMsgs++;
+                  m_WorkerQueues[tunnel_ID % m_WorkerQueues.size()]->Put(
+                      TunnelWorkItem{tunnel, msg});
+                } else if (type_ID == I2NPTunnelData) {
                   tunnel->HandleTunnelDataMsg(msg);
-                else  // tunnel gateway assumed
+                } else {  // tunnel gateway assumed
                   HandleTunnelGatewayMsg(tunnel, msg);
+                }
               } else {
                 LOG(warning) << "Tunnels: tunnel " << tunnel_ID << " not found";
               }
               break;
             }
             case I2NPVariableTunnelBuild:
+            case I2NPTunnelBuild: {
+              std::uint32_t const msg_ID =
+                  core::InputByteStream::Read<std::uint32_t>(
+                      msg->GetBuffer() + I2NP_HEADER_MSGID_OFFSET);
+              // A transit build record costs an ElGamal modexp, the most
+              // expensive single message this loop sees; hand it to a
+              // worker so build storms can't stall tunnel-data forwarding.
+              // Replies to our own builds stay inline: they touch the
+              // pending tunnel tables owned by this thread
+              if (!m_WorkerQueues.empty()
+                  && !m_PendingInboundTunnels.count(msg_ID)) {
+                m_PendingWorkerMsgs++;
+                m_WorkerQueues[msg_ID % m_WorkerQueues.size()]->Put(
+                    TunnelWorkItem{nullptr, msg});
+                break;
+              }
+              HandleI2NPMessage(msg->GetBuffer(), msg->GetLength());
+              break;
+            }
             case I2NPVariableTunnelBuildReply:
-            case I2NPTunnelBuild:
             case I2NPTunnelBuildReply:
               HandleI2NPMessage(msg->GetBuffer(), msg->GetLength());
             break;
@@ -469,18 +623,25 @@ void Tunnels::Run() {
                 << "Tunnels: unexpected messsage type "
                 << static_cast<int>(type_ID);
           }
-          msg = m_Queue.Get();
-          if (msg) {
-            prev_tunnel_ID = tunnel_ID;
-            prev_tunnel = tunnel;
-          } else if (tunnel) {
-            tunnel->FlushTunnelDataMsgs();
-          }
+          prev_tunnel_ID = tunnel_ID;
+          prev_tunnel = tunnel;
         }
-        while (msg);
+        if (tunnel && m_WorkerQueues.empty())
+          tunnel->FlushTunnelDataMsgs();
       }
+      // peer failures reported by the transports are acted on every
+      // wakeup, not on the coarse management tick: tunnels through a
+      // dead peer should stop carrying traffic within a second
+      ProcessPeerFailures();
       std::uint64_t ts = kovri::core::GetSecondsSinceEpoch();
+      // refresh gauges here so monitoring endpoints never probe the live
+      // queue or the transit table themselves
+      metrics.Set(Metrics::TunnelQueueDepth, m_Queue.GetSize());
+      metrics.Set(Metrics::TransitTunnels, GetNumTransitTunnels());
       if (ts - last_ts >= 15) {  // manage tunnels every 15 seconds
+        // workers hold raw tunnel pointers, so let them drain before
+        // management mutates the tunnel tables
+        DrainCryptoWorkers();
         ManageTunnels();
         last_ts = ts;
       }
@@ -490,6 +651,57 @@ void Tunnels::Run() {
   }
 }
 
+void Tunnels::RunCryptoWorker(
+    std::size_t worker) {
+  thread_registry.Register("tunnel-crypto");
+  auto& queue = *m_WorkerQueues.at(worker);
+  const std::size_t max_batch = 64;
+  std::vector<TunnelWorkItem> batch;
+  while (m_IsRunning) {
+    try {
+      if (queue.GetBatchWithTimeout(batch, max_batch, 1000)) {  // 1 sec
+        // the drain barrier must cover the raw tunnel pointers until the
+        // final flush below returns, or management could free a tunnel
+        // this worker still dereferences; the guard decrements on every
+        // exit path so an exception cannot wedge the barrier either
+        struct BatchGuard {
+          std::atomic<std::size_t>& pending;
+          std::size_t count;
+          ~BatchGuard() {
+            pending -= count;
+          }
+        } guard{m_PendingWorkerMsgs, batch.size()};
+        TunnelBase* prev_tunnel = nullptr;
+        for (auto& item : batch) {
+          try {
+            if (prev_tunnel && item.tunnel != prev_tunnel)
+              prev_tunnel->FlushTunnelDataMsgs();
+            if (!item.tunnel)  // offloaded transit build message
+              HandleI2NPMessage(item.msg->GetBuffer(), item.msg->GetLength());
+            else if (item.msg->GetTypeID() == I2NPTunnelData)
+              item.tunnel->HandleTunnelDataMsg(item.msg);
+            else  // tunnel gateway assumed
+              HandleTunnelGatewayMsg(item.tunnel, item.msg);
+          } catch (const std::exception& ex) {
+            LOG(error) << "Tunnels: " << __func__ << " exception: " << ex.what();
+          }
+          prev_tunnel = item.tunnel;
+        }
+        if (prev_tunnel)
+          prev_tunnel->FlushTunnelDataMsgs();
+        batch.clear();
+      }
+    } catch (const std::exception& ex) {
+      LOG(error) << "Tunnels: " << __func__ << " exception: " << ex.what();
+    }
+  }
+}
+
+void Tunnels::DrainCryptoWorkers() {
+  while (m_PendingWorkerMsgs.load())
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
 void Tunnels::HandleTunnelGatewayMsg(
     TunnelBase* tunnel,
     std::shared_ptr<I2NPMessage> msg) {
@@ -500,19 +712,30 @@ void Tunnels::HandleTunnelGatewayMsg(
   const std::uint8_t* payload = msg->GetPayload();
   std::uint16_t const len = core::InputByteStream::Read<std::uint16_t>(
       payload + TUNNEL_GATEWAY_HEADER_LENGTH_OFFSET);
-  // we make payload as new I2NP message to send
-  msg->offset += I2NP_HEADER_SIZE + TUNNEL_GATEWAY_HEADER_SIZE;
-  msg->len = msg->offset + len;
-  auto type_ID = msg->GetTypeID();
+  // the wrapped message lies contiguous inside the envelope, so unwrap is
+  // pointer arithmetic: alias it with views over the same pooled buffer
+  // rather than rebasing the shared envelope in place
+  const std::size_t inner_offset =
+      msg->offset + I2NP_HEADER_SIZE + TUNNEL_GATEWAY_HEADER_SIZE;
+  if (inner_offset + len > msg->len) {
+    LOG(error)
+      << "Tunnels: TunnelGateway length " << len
+      << " overruns the envelope, dropped";
+    return;
+  }
+  auto inner = CreateI2NPMessageView(msg, inner_offset, len);
+  auto type_ID = inner->GetTypeID();
   LOG(debug)
     << "Tunnels: TunnelGateway of " << len
     << " bytes for tunnel " << tunnel->GetTunnelID()
     << ". Msg type " << static_cast<int>(type_ID);
   if (type_ID == I2NPDatabaseStore || type_ID == I2NPDatabaseSearchReply)
     // transit DatabaseStore my contain new/updated RI
-    // or DatabaseSearchReply with new routers
-    kovri::core::netdb.PostI2NPMsg(msg);
-  tunnel->SendTunnelDataMsg(msg);
+    // or DatabaseSearchReply with new routers; netdb's thread gets its
+    // own view so the two consumers never share offset bookkeeping
+    kovri::core::netdb.PostI2NPMsg(
+        CreateI2NPMessageView(msg, inner_offset, len));
+  tunnel->SendTunnelDataMsg(inner);
 }
 
 void Tunnels::ManageTunnels() {
@@ -554,6 +777,9 @@ void Tunnels::ManagePendingTunnels(
           // delete
           it = pending_tunnels.erase(it);
           m_NumFailedTunnelCreations++;
+          metrics.Inc(Metrics::TunnelBuildsFailed);
+          event_bus.Emit(EventBus::TunnelBuildFailed, tunnel->GetTunnelID());
+          HandleRecreationFailure(tunnel);
         } else {
           it++;
         }
@@ -564,6 +790,9 @@ void Tunnels::ManagePendingTunnels(
           << it->first << " failed. Deleted";
         it = pending_tunnels.erase(it);
         m_NumFailedTunnelCreations++;
+        metrics.Inc(Metrics::TunnelBuildsFailed);
+        event_bus.Emit(EventBus::TunnelBuildFailed, tunnel->GetTunnelID());
+        HandleRecreationFailure(tunnel);
       break;
       case e_TunnelStateBuildReplyReceived:
         // intermediate state, will be either established of build failed
@@ -573,10 +802,30 @@ void Tunnels::ManagePendingTunnels(
         // success
         it = pending_tunnels.erase(it);
         m_NumSuccesiveTunnelCreations++;
+        metrics.Inc(Metrics::TunnelBuildsSucceeded);
+        event_bus.Emit(EventBus::TunnelBuilt, tunnel->GetTunnelID());
     }
   }
 }
 
+void Tunnels::HandleRecreationFailure(
+    std::shared_ptr<InboundTunnel> tunnel) {
+  if (!tunnel->IsSamePathRecreation())
+    return;
+  auto pool = tunnel->GetTunnelPool();
+  if (pool)
+    pool->SamePathRecreationFailed(tunnel);
+}
+
+void Tunnels::HandleRecreationFailure(
+    std::shared_ptr<OutboundTunnel> tunnel) {
+  if (!tunnel->IsSamePathRecreation())
+    return;
+  auto pool = tunnel->GetTunnelPool();
+  if (pool)
+    pool->SamePathRecreationFailed(tunnel);
+}
+
 void Tunnels::ManageOutboundTunnels() {
   std::uint64_t ts = kovri::core::GetSecondsSinceEpoch(); {
     for (auto it = m_OutboundTunnels.begin(); it != m_OutboundTunnels.end();) {
@@ -586,14 +835,18 @@ void Tunnels::ManageOutboundTunnels() {
         auto pool = tunnel->GetTunnelPool();
         if (pool)
           pool->TunnelExpired(tunnel);
+        event_bus.Emit(EventBus::TunnelExpired, tunnel->GetTunnelID());
         it = m_OutboundTunnels.erase(it);
       } else {
         if (tunnel->IsEstablished()) {
+          auto pool = tunnel->GetTunnelPool();
+          std::uint64_t const lead_time = pool ?
+            pool->GetRecreationLeadTime() :
+            TUNNEL_RECREATION_THRESHOLD;
           if (!tunnel->IsRecreated () &&
-              ts + TUNNEL_RECREATION_THRESHOLD >
+              ts + lead_time >
               tunnel->GetCreationTime() + TUNNEL_EXPIRATION_TIMEOUT) {
             tunnel->SetIsRecreated();
-            auto pool = tunnel->GetTunnelPool();
             if (pool)
               pool->RecreateOutboundTunnel(tunnel);
           }
@@ -628,14 +881,18 @@ void Tunnels::ManageInboundTunnels() {
         auto pool = tunnel->GetTunnelPool();
         if (pool)
           pool->TunnelExpired(tunnel);
+        event_bus.Emit(EventBus::TunnelExpired, tunnel->GetTunnelID());
         it = m_InboundTunnels.erase(it);
       } else {
         if (tunnel->IsEstablished()) {
+          auto pool = tunnel->GetTunnelPool();
+          std::uint64_t const lead_time = pool ?
+            pool->GetRecreationLeadTime() :
+            TUNNEL_RECREATION_THRESHOLD;
           if (!tunnel->IsRecreated() &&
-              ts + TUNNEL_RECREATION_THRESHOLD >
+              ts + lead_time >
               tunnel->GetCreationTime() + TUNNEL_EXPIRATION_TIMEOUT) {
             tunnel->SetIsRecreated();
-            auto pool = tunnel->GetTunnelPool();
             if (pool)
               pool->RecreateInboundTunnel(tunnel);
           }
@@ -652,7 +909,8 @@ void Tunnels::ManageInboundTunnels() {
     CreateZeroHopsInboundTunnel();
     if (!m_ExploratoryPool)
       m_ExploratoryPool =
-        // 2-hop exploratory, 5 tunnels
+        // 2-hop exploratory, 5 tunnels to start; resized each pool
+        // management round from NetDb health (ManageTunnelPools)
         CreateTunnelPool(&context, 2, 2, 5, 5);
     return;
   }
@@ -667,20 +925,22 @@ void Tunnels::ManageInboundTunnels() {
 }
 
 void Tunnels::ManageTransitTunnels() {
-  std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
-
   const std::uint64_t ts = kovri::core::GetSecondsSinceEpoch();
-  for (auto it = m_TransitTunnels.begin(); it != m_TransitTunnels.end();) {
-    if (ts > it->second->GetCreationTime() + TUNNEL_EXPIRATION_TIMEOUT) {
-      LOG(debug) << "Tunnels: transit tunnel " << it->second->GetTunnelID() << " expired";
-      it = m_TransitTunnels.erase(it);
-    } else {
-      it++;
-    }
-  }
+  const std::size_t expired = m_TransitTunnels.SweepExpired(ts);
+  if (expired)
+    LOG(debug) << "Tunnels: " << expired << " transit tunnels expired";
 }
 
 void Tunnels::ManageTunnelPools() {
+  RefreshPeerCandidates();
+  if (m_ExploratoryPool) {
+    // exploratory capacity follows NetDb health: wide while the lookup
+    // backlog grows or bootstrap is still filling the database, pared
+    // back to a minimum once lookups succeed in steady state
+    std::uint16_t const num =
+        kovri::core::netdb.GetDesiredExploratoryTunnels();
+    m_ExploratoryPool->SetNumTunnels(num, num);
+  }
   std::unique_lock<std::mutex> l(m_PoolsMutex);
   for (auto it : m_Pools) {
     auto pool = it;
@@ -691,14 +951,163 @@ void Tunnels::ManageTunnelPools() {
   }
 }
 
+void Tunnels::HandlePeerFailure(
+    const kovri::core::IdentHash& ident) {
+  std::unique_lock<std::mutex> l(m_FailedPeersMutex);
+  m_FailedPeers.push_back(ident);
+}
+
+void Tunnels::ProcessPeerFailures() {
+  std::vector<kovri::core::IdentHash> failed;
+  {
+    std::unique_lock<std::mutex> l(m_FailedPeersMutex);
+    failed.swap(m_FailedPeers);
+  }
+  if (failed.empty())
+    return;
+  std::unique_lock<std::mutex> l(m_PoolsMutex);
+  for (auto pool : m_Pools)
+    if (pool && pool->IsActive())
+      for (const auto& ident : failed)
+        pool->HandlePeerFailure(ident);
+}
+
+void Tunnels::RefreshPeerCandidates() {
+  const std::uint64_t now = kovri::core::GetSecondsSinceEpoch();
+  if (now - m_LastCandidateRefresh < TUNNEL_SHARED_CANDIDATES_REFRESH)
+    return;
+  m_LastCandidateRefresh = now;
+  std::vector<std::shared_ptr<const kovri::core::RouterInfo>> candidates;
+  for (std::size_t i = 0; i < TUNNEL_SHARED_CANDIDATES_SAMPLES; i++) {
+    auto router = kovri::core::netdb.GetHighBandwidthRandomRouter(nullptr);
+    if (!router || router->GetProfile()->IsBad())
+      continue;
+    candidates.push_back(router);
+  }
+  // Drop duplicate samples, then rank fastest-first: every pool's test
+  // traffic feeds the profiles this ordering is built from
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const std::shared_ptr<const kovri::core::RouterInfo>& a,
+         const std::shared_ptr<const kovri::core::RouterInfo>& b) {
+        return a->GetIdentHash() < b->GetIdentHash();
+      });
+  candidates.erase(
+      std::unique(
+          candidates.begin(),
+          candidates.end(),
+          [](const std::shared_ptr<const kovri::core::RouterInfo>& a,
+             const std::shared_ptr<const kovri::core::RouterInfo>& b) {
+            return a->GetIdentHash() == b->GetIdentHash();
+          }),
+      candidates.end());
+  auto rtt = [](const std::shared_ptr<const kovri::core::RouterInfo>& router) {
+    auto profile = router->GetProfile();
+    return profile->HasRTT() ?
+      profile->GetMeanRTT() :
+      TUNNEL_POOL_UNMEASURED_PEER_RTT;
+  };
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [&rtt](const std::shared_ptr<const kovri::core::RouterInfo>& a,
+             const std::shared_ptr<const kovri::core::RouterInfo>& b) {
+        return rtt(a) < rtt(b);
+      });
+  if (candidates.size() > TUNNEL_SHARED_CANDIDATES_SIZE)
+    candidates.resize(TUNNEL_SHARED_CANDIDATES_SIZE);
+  LOG(debug)
+    << "Tunnels: refreshed " << candidates.size() << " shared peer candidates";
+  std::unique_lock<std::mutex> lock(m_PeerCandidatesMutex);
+  m_PeerCandidates.swap(candidates);
+}
+
+std::shared_ptr<const kovri::core::RouterInfo> Tunnels::GetRankedPeer(
+    std::shared_ptr<const kovri::core::RouterInfo> skip) {
+  std::unique_lock<std::mutex> lock(m_PeerCandidatesMutex);
+  if (m_PeerCandidates.empty())
+    return nullptr;
+  const std::uint32_t window = std::min(
+      m_PeerCandidates.size(),
+      TUNNEL_SHARED_CANDIDATES_WINDOW);
+  for (std::size_t attempt = 0; attempt < 3; attempt++) {
+    const auto& peer =
+      m_PeerCandidates[kovri::core::FastRandInRange32(0, window - 1)];
+    if (!skip || peer->GetIdentHash() != skip->GetIdentHash())
+      return peer;
+  }
+  return nullptr;
+}
+
+bool Tunnels::HasEquivalentPendingBuild(
+    const std::shared_ptr<TunnelConfig>& config) {
+  const auto peers = config->GetPeers();
+  auto walks_same_path = [&peers](const auto& tunnel) {
+    if (tunnel->GetState() != e_TunnelStatePending)
+      return false;
+    const auto pending_peers = tunnel->GetTunnelConfig()->GetPeers();
+    if (pending_peers.size() != peers.size())
+      return false;
+    for (std::size_t i = 0; i < peers.size(); i++)
+      if (pending_peers[i]->GetIdentHash() != peers[i]->GetIdentHash())
+        return false;
+    return true;
+  };
+  for (const auto& it : m_PendingInboundTunnels)
+    if (walks_same_path(it.second))
+      return true;
+  for (const auto& it : m_PendingOutboundTunnels)
+    if (walks_same_path(it.second))
+      return true;
+  return false;
+}
+
+// When the queue is deep, a message that expires within the drain window
+// will die waiting: shed it at enqueue, before any crypto is spent on it
+static bool ShedSoonToExpire(
+    const std::shared_ptr<I2NPMessage>& msg,
+    std::uint64_t now) {
+  const std::uint64_t expiration = msg->GetExpiration();
+  if (!expiration || expiration >= now + TUNNEL_QUEUE_MIN_LIFETIME)
+    return false;
+  metrics.Inc(Metrics::ExpiredMsgDrops);
+  return true;
+}
+
 void Tunnels::PostTunnelData(
     std::shared_ptr<I2NPMessage> msg) {
-  if (msg)
-    m_Queue.Put(msg);
+  if (msg) {
+    if (m_Queue.GetSize() > TUNNEL_QUEUE_OVERLOAD_DEPTH
+        && ShedSoonToExpire(msg, kovri::core::GetMillisecondsSinceEpoch()))
+      return;
+    KOVRI_PROBE2(tunnel_post, msg->GetMsgID(), msg->GetTypeID());
+    m_Queue.Put(std::move(msg));
+  }
 }
 
 void Tunnels::PostTunnelData(
     const std::vector<std::shared_ptr<I2NPMessage> >& msgs) {
+  if (m_Queue.GetSize() > TUNNEL_QUEUE_OVERLOAD_DEPTH) {
+    const std::uint64_t now = kovri::core::GetMillisecondsSinceEpoch();
+    std::vector<std::shared_ptr<I2NPMessage>> kept;
+    kept.reserve(msgs.size());
+    for (const auto& msg : msgs)
+      if (msg && !ShedSoonToExpire(msg, now))
+        kept.push_back(msg);
+#if defined(WITH_USDT)
+    for (const auto& msg : kept)
+      KOVRI_PROBE2(tunnel_post, msg->GetMsgID(), msg->GetTypeID());
+#endif
+    if (!kept.empty())
+      m_Queue.Put(kept);
+    return;
+  }
+#if defined(WITH_USDT)
+  for (const auto& msg : msgs)
+    if (msg)
+      KOVRI_PROBE2(tunnel_post, msg->GetMsgID(), msg->GetTypeID());
+#endif
   m_Queue.Put(msgs);
 }
 
@@ -760,18 +1169,22 @@ void Tunnels::CreateZeroHopsInboundTunnel() {
       }));
 }
 
+std::size_t Tunnels::GetNumTransitTunnels()
+{
+  return m_TransitTunnels.Size();
+}
+
 std::uint64_t Tunnels::GetTransitTunnelsExpirationTimeout()
 {
   std::uint64_t timeout = 0;
   std::uint64_t timestamp = kovri::core::GetSecondsSinceEpoch();
-  std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
-  for (auto tunnel : m_TransitTunnels)
-    {
-      std::uint64_t time = tunnel.second->GetCreationTime()
-                           + TUNNEL_EXPIRATION_TIMEOUT - timestamp;
-      if (time > timeout)
-        timeout = time;
-    }
+  m_TransitTunnels.ForEach(
+      [&timeout, timestamp](TransitTunnel* tunnel) {
+        std::uint64_t time = tunnel->GetCreationTime()
+                             + TUNNEL_EXPIRATION_TIMEOUT - timestamp;
+        if (time > timeout)
+          timeout = time;
+      });
   return timeout;
 }
 
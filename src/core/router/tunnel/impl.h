@@ -33,6 +33,9 @@
 #ifndef SRC_CORE_ROUTER_TUNNEL_IMPL_H_
 #define SRC_CORE_ROUTER_TUNNEL_IMPL_H_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <list>
@@ -50,8 +53,10 @@
 #include "core/router/tunnel/gateway.h"
 #include "core/router/tunnel/pool.h"
 #include "core/router/tunnel/transit.h"
+#include "core/router/tunnel/transit_table.h"
 
 #include "core/util/exception.h"
+#include "core/util/mpsc_ring.h"
 #include "core/util/queue.h"
 
 namespace kovri {
@@ -63,6 +68,34 @@ const int TUNNEL_EXPIRATION_TIMEOUT = 660,    // 11 minutes
           TUNNEL_CREATION_TIMEOUT = 30,       // 30 seconds
           STANDARD_NUM_RECORDS = 4;           // in VariableTunnelBuild message
 
+/// @brief Queue depth past which enqueue sheds soon-to-expire messages
+///   instead of paying tunnel crypto for traffic that dies in the backlog
+const std::size_t TUNNEL_QUEUE_OVERLOAD_DEPTH = 1024;
+
+/// @brief Remaining lifetime in milliseconds under which a message
+///   counts as soon-to-expire for overload shedding
+const std::uint64_t TUNNEL_QUEUE_MIN_LIFETIME = 2 * 1000;
+
+/// @brief Test round trips kept per tunnel for the mean RTT estimate
+const std::size_t TUNNEL_RTT_WINDOW_SIZE = 8;
+
+/// @brief Size of the ranked peer candidate list shared across pools
+const std::size_t TUNNEL_SHARED_CANDIDATES_SIZE = 32;
+
+/// @brief Routers sampled from the NetDb per candidate refresh
+const std::size_t TUNNEL_SHARED_CANDIDATES_SAMPLES = 64;
+
+/// @brief Peers drawn randomly from the front of the ranked list, so
+///   concurrent pools don't all converge on the single fastest peer
+const std::size_t TUNNEL_SHARED_CANDIDATES_WINDOW = 8;
+
+/// @brief Seconds between refreshes of the shared candidate list
+const std::uint64_t TUNNEL_SHARED_CANDIDATES_REFRESH = 30;
+
+/// @brief Slots in an outbound tunnel's lock-free send ring; a full
+///   ring makes the producer drain it in place, so nothing is dropped
+const std::size_t TUNNEL_SEND_RING_CAPACITY = 256;
+
 enum TunnelState {
   e_TunnelStatePending,
   e_TunnelStateBuildReplyReceived,
@@ -114,6 +147,16 @@ class Tunnel : public TunnelBase {
     m_IsRecreated = true;
   }
 
+  /// @brief Whether this build reuses an expiring tunnel's proven hop
+  ///   sequence; a failed same-path build falls back to fresh selection
+  bool IsSamePathRecreation() const {
+    return m_IsSamePathRecreation;
+  }
+
+  void SetIsSamePathRecreation() {
+    m_IsSamePathRecreation = true;
+  }
+
   std::shared_ptr<TunnelPool> GetTunnelPool() const {
     return m_Pool;
   }
@@ -123,6 +166,36 @@ class Tunnel : public TunnelBase {
     m_Pool = pool;
   }
 
+  /// @brief Records a successful test round trip (in milliseconds)
+  void AddRTTSample(
+      std::uint64_t rtt) {
+    m_RTTSamples[m_NumRTTSamples % TUNNEL_RTT_WINDOW_SIZE] = rtt;
+    m_NumRTTSamples++;
+    m_NumConsecutiveTests++;
+  }
+
+  /// @brief Mean test round trip over the sample window (in milliseconds)
+  /// @return 0 if the tunnel has never passed a test
+  std::uint64_t GetMeanRTT() const {
+    std::size_t const num =
+        std::min(m_NumRTTSamples, TUNNEL_RTT_WINDOW_SIZE);
+    if (!num)
+      return 0;
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < num; i++)
+      sum += m_RTTSamples.at(i);
+    return sum / num;
+  }
+
+  /// @brief Successful tests in a row since the last failure
+  std::uint32_t GetNumConsecutiveTests() const {
+    return m_NumConsecutiveTests;
+  }
+
+  void ResetConsecutiveTests() {
+    m_NumConsecutiveTests = 0;
+  }
+
   bool HandleTunnelBuildResponse(
       std::uint8_t* msg,
       std::size_t len);
@@ -148,6 +221,13 @@ class Tunnel : public TunnelBase {
   std::shared_ptr<TunnelPool> m_Pool;  // pool, tunnel belongs to, or null
   TunnelState m_State;
   bool m_IsRecreated;
+  bool m_IsSamePathRecreation;
+  std::array<std::uint64_t, TUNNEL_RTT_WINDOW_SIZE> m_RTTSamples;
+  std::size_t m_NumRTTSamples;
+  std::uint32_t m_NumConsecutiveTests;
+  // when Build sent the request (in milliseconds), for the build
+  // duration histogram; creation time is only second-resolution
+  std::uint64_t m_BuildStartTime;
   core::Exception m_Exception;
 };
 
@@ -167,9 +247,10 @@ class OutboundTunnel
   // Exposes hidden overloaded virtual function until we do a tunnel refactor
   using Tunnel::SendTunnelDataMsg;
 
-  // multiple messages
+  // multiple messages; the batch is consumed so callers hand it off
+  // instead of copying every block through the gateway
   void SendTunnelDataMsg(
-      const std::vector<TunnelMessageBlock>& msgs);
+      std::vector<TunnelMessageBlock>&& msgs);
 
   const std::shared_ptr<const kovri::core::RouterInfo>& GetEndpointRouter() const noexcept {
     return GetTunnelConfig()->GetLastHop()->GetCurrentRouter();
@@ -188,7 +269,18 @@ class OutboundTunnel
   }
 
  private:
-  std::mutex m_SendMutex;
+  /// @brief Drains the send ring through the gateway. Any producer may
+  ///   call this; the flusher flag elects one drainer at a time, losers
+  ///   just leave their blocks behind and the winner re-checks after
+  ///   releasing, so no block is ever stranded
+  void FlushSendQueue();
+
+ private:
+  /// @brief Producers (destination io_service, NetDb, tunnels thread)
+  ///   publish blocks lock-free; whoever wins the flusher flag feeds
+  ///   the gateway with the whole backlog in one drain
+  MpscRing<TunnelMessageBlock, TUNNEL_SEND_RING_CAPACITY> m_SendQueue;
+  std::atomic<bool> m_Flushing{false};
   TunnelGateway m_Gateway;
 };
 
@@ -245,6 +337,9 @@ class Tunnels {
   TransitTunnel* GetTransitTunnel(
       std::uint32_t tunnel_ID);
 
+  /// @return Current transit tunnel count (safe from any thread)
+  std::size_t GetNumTransitTunnels();
+
   std::uint64_t GetTransitTunnelsExpirationTimeout();
 
   void AddTransitTunnel(
@@ -287,7 +382,29 @@ class Tunnels {
   void StopTunnelPool(
       std::shared_ptr<TunnelPool> pool);
 
+  /// @brief Draws a peer from the ranked candidate list shared across
+  ///   pools, skipping the given router
+  /// @return Null when the list is empty or only contains skip
+  std::shared_ptr<const kovri::core::RouterInfo> GetRankedPeer(
+      std::shared_ptr<const kovri::core::RouterInfo> skip);
+
+  /// @brief True when a pending build already walks the exact hop
+  ///   sequence of the given config
+  bool HasEquivalentPendingBuild(
+      const std::shared_ptr<TunnelConfig>& config);
+
+  /// @brief Records a peer the transport layer has declared dead; the
+  ///   tunnel thread replaces tunnels through it on its next wakeup
+  /// @param ident the router hash of the failed peer
+  /// @note Safe to call from any thread
+  void HandlePeerFailure(
+      const kovri::core::IdentHash& ident);
+
  private:
+  /// @brief Re-samples and re-ranks the shared candidate list when the
+  ///   refresh interval has elapsed
+  void RefreshPeerCandidates();
+
   template<class TTunnel>
   std::shared_ptr<TTunnel> GetPendingTunnel(
       std::uint32_t reply_msg_ID,
@@ -300,6 +417,15 @@ class Tunnels {
 
   void Run();
 
+  /// @brief Crypto worker loop: drains the worker's own queue and performs
+  ///   the layered tunnel AES off the dispatcher thread
+  void RunCryptoWorker(
+      std::size_t worker);
+
+  /// @brief Blocks until all offloaded messages have been processed, so
+  ///   tunnel management can safely mutate the tunnel tables
+  void DrainCryptoWorkers();
+
   void ManageTunnels();
 
   void ManageOutboundTunnels();
@@ -314,14 +440,41 @@ class Tunnels {
   void ManagePendingTunnels(
       PendingTunnels& pending_tunnels);
 
+  /// @brief Hands a failed same-path replacement build back to its pool
+  ///   so the recreate retries with fresh peer selection
+  void HandleRecreationFailure(
+      std::shared_ptr<InboundTunnel> tunnel);
+  void HandleRecreationFailure(
+      std::shared_ptr<OutboundTunnel> tunnel);
+
   void ManageTunnelPools();
 
+  /// @brief Drains the failed-peer list on the tunnel thread and has every
+  ///   pool fail and replace its tunnels through those peers
+  void ProcessPeerFailures();
+
   void CreateZeroHopsInboundTunnel();
 
+ private:
+  /// @brief One unit of offloaded tunnel crypto work; the tunnel pointer is
+  ///   resolved by the dispatcher and stays valid until DrainCryptoWorkers.
+  ///   A null tunnel marks a transit tunnel-build message whose ElGamal
+  ///   record decryption runs entirely on the worker
+  struct TunnelWorkItem {
+    TunnelBase* tunnel;
+    std::shared_ptr<I2NPMessage> msg;
+  };
+
  private:
   bool m_IsRunning;
   std::unique_ptr<std::thread> m_Thread;
 
+  // optional crypto worker pool: messages are sharded by tunnel ID onto one
+  // queue (and thread) each, preserving per-tunnel ordering
+  std::vector<std::unique_ptr<std::thread>> m_CryptoWorkers;
+  std::vector<std::unique_ptr<kovri::core::Queue<TunnelWorkItem>>> m_WorkerQueues;
+  std::atomic<std::size_t> m_PendingWorkerMsgs;
+
   // by reply_msg_ID
   std::map<std::uint32_t, std::shared_ptr<InboundTunnel> > m_PendingInboundTunnels;
   // by reply_msg_ID
@@ -329,10 +482,17 @@ class Tunnels {
 
   std::map<std::uint32_t, std::shared_ptr<InboundTunnel> > m_InboundTunnels;
   std::list<std::shared_ptr<OutboundTunnel> > m_OutboundTunnels;
-  std::mutex m_TransitTunnelsMutex;
-  std::map<std::uint32_t, TransitTunnel *> m_TransitTunnels;
+  // flat table: relayed messages look a tunnel up per message
+  TransitTunnelTable m_TransitTunnels;
   std::mutex m_PoolsMutex;
   std::list<std::shared_ptr<TunnelPool>> m_Pools;
+  // peers the transport layer declared dead, drained by the tunnel thread
+  std::mutex m_FailedPeersMutex;
+  std::vector<kovri::core::IdentHash> m_FailedPeers;
+  // ranked fastest-first; refreshed by ManageTunnelPools
+  std::mutex m_PeerCandidatesMutex;
+  std::vector<std::shared_ptr<const kovri::core::RouterInfo>> m_PeerCandidates;
+  std::uint64_t m_LastCandidateRefresh;
   std::shared_ptr<TunnelPool> m_ExploratoryPool;
   kovri::core::Queue<std::shared_ptr<I2NPMessage> > m_Queue;
 
@@ -350,10 +510,6 @@ class Tunnels {
     return m_InboundTunnels;
   }
 
-  const decltype(m_TransitTunnels)& GetTransitTunnels() const {
-    return m_TransitTunnels;
-  }
-
   int GetQueueSize() const {
     return m_Queue.GetSize();
   }
@@ -33,6 +33,7 @@
 #include "core/router/tunnel/pool.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "core/crypto/rand.h"
 
@@ -59,6 +60,10 @@ TunnelPool::TunnelPool(
       m_NumOutboundHops(num_outbound_hops),
       m_NumInboundTunnels(num_inbound_tunnels),
       m_NumOutboundTunnels(num_outbound_tunnels),
+      m_TargetLatency(0),
+      m_NumStandbyTunnels(TUNNEL_POOL_DEFAULT_STANDBY_TUNNELS),
+      m_RecreationLeadTime(TUNNEL_RECREATION_THRESHOLD),
+      m_NumTestRounds(0),
       m_IsActive(true) {}
 
 TunnelPool::~TunnelPool() {
@@ -84,6 +89,8 @@ void TunnelPool::SetExplicitPeers(
     }
     m_NumInboundTunnels = 1;
     m_NumOutboundTunnels = 1;
+    // pinned peers: spares would just rebuild the same route
+    m_NumStandbyTunnels = 0;
   }
 }
 
@@ -100,9 +107,39 @@ void TunnelPool::DetachTunnels() {
       it->SetTunnelPool(nullptr);
     m_OutboundTunnels.clear();
   }
+  RebuildInboundSnapshot();
+  RebuildOutboundSnapshot();
   m_Tests.clear();
 }
 
+void TunnelPool::RebuildInboundSnapshot() {
+  auto snapshot = std::make_shared<TunnelSnapshot<InboundTunnel>>();
+  {
+    std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
+    for (const auto& it : m_InboundTunnels)
+      if (it->IsEstablished())
+        snapshot->tunnels.push_back(it);
+  }
+  std::atomic_store(
+      &m_InboundSnapshot,
+      std::shared_ptr<const TunnelSnapshot<InboundTunnel>>(
+          std::move(snapshot)));
+}
+
+void TunnelPool::RebuildOutboundSnapshot() {
+  auto snapshot = std::make_shared<TunnelSnapshot<OutboundTunnel>>();
+  {
+    std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
+    for (const auto& it : m_OutboundTunnels)
+      if (it->IsEstablished())
+        snapshot->tunnels.push_back(it);
+  }
+  std::atomic_store(
+      &m_OutboundSnapshot,
+      std::shared_ptr<const TunnelSnapshot<OutboundTunnel>>(
+          std::move(snapshot)));
+}
+
 void TunnelPool::TunnelCreated(
     std::shared_ptr<InboundTunnel> created_tunnel) {
   if (!m_IsActive)
@@ -111,6 +148,7 @@ void TunnelPool::TunnelCreated(
     std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
     m_InboundTunnels.insert(created_tunnel);
   }
+  RebuildInboundSnapshot();
   if (m_LocalDestination)
     m_LocalDestination->SetLeaseSetUpdated();
 }
@@ -122,8 +160,11 @@ void TunnelPool::TunnelExpired(
     for (auto it : m_Tests)
       if (it.second.second == expired_tunnel)
         it.second.second = nullptr;
-    std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
-    m_InboundTunnels.erase(expired_tunnel);
+    {
+      std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
+      m_InboundTunnels.erase(expired_tunnel);
+    }
+    RebuildInboundSnapshot();
   }
 }
 
@@ -135,6 +176,7 @@ void TunnelPool::TunnelCreated(
     std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
     m_OutboundTunnels.insert(created_tunnel);
   }
+  RebuildOutboundSnapshot();
   // CreatePairedInboundTunnel (created_tunnel);
   // TODO(unassigned): ^ ???
 }
@@ -146,8 +188,11 @@ void TunnelPool::TunnelExpired(
     for (auto it : m_Tests)
       if (it.second.first == expired_tunnel)
         it.second.first = nullptr;
-    std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
-    m_OutboundTunnels.erase(expired_tunnel);
+    {
+      std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
+      m_OutboundTunnels.erase(expired_tunnel);
+    }
+    RebuildOutboundSnapshot();
   }
 }
 
@@ -166,37 +211,98 @@ std::vector<std::shared_ptr<InboundTunnel> > TunnelPool::GetInboundTunnels(
   return v;
 }
 
+std::vector<std::shared_ptr<OutboundTunnel> > TunnelPool::GetOutboundTunnels(
+    int num) const {
+  std::vector<std::shared_ptr<OutboundTunnel> > v;
+  int i = 0;
+  std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
+  for (auto it : m_OutboundTunnels) {
+    if (i >= num) break;
+    if (it->IsEstablished()) {
+      v.push_back(it);
+      i++;
+    }
+  }
+  return v;
+}
+
 std::shared_ptr<OutboundTunnel> TunnelPool::GetNextOutboundTunnel(
     std::shared_ptr<OutboundTunnel> excluded) const {
+  if (auto tunnel = SelectFromSnapshot(
+          std::atomic_load(&m_OutboundSnapshot), m_OutboundCursor, excluded))
+    return tunnel;
   std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
   return GetNextTunnel(m_OutboundTunnels, excluded);
 }
 
 std::shared_ptr<InboundTunnel> TunnelPool::GetNextInboundTunnel(
     std::shared_ptr<InboundTunnel> excluded) const {
+  if (auto tunnel = SelectFromSnapshot(
+          std::atomic_load(&m_InboundSnapshot), m_InboundCursor, excluded))
+    return tunnel;
   std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
   return GetNextTunnel(m_InboundTunnels, excluded);
 }
 
+template <class T>
+std::shared_ptr<T> TunnelPool::SelectFromSnapshot(
+    const std::shared_ptr<const TunnelSnapshot<T>>& snapshot,
+    std::atomic<std::uint32_t>& cursor,
+    const std::shared_ptr<T>& excluded) {
+  if (!snapshot || snapshot->tunnels.empty())
+    return nullptr;
+  auto const size = snapshot->tunnels.size();
+  // Round-robin first candidate spreads load; random second candidate
+  // with the lower measured round trip keeps the quality bias of the
+  // locked path
+  auto const first = snapshot->tunnels.at(
+      cursor.fetch_add(1, std::memory_order_relaxed) % size);
+  auto const second =
+      snapshot->tunnels.at(kovri::core::FastRandInRange32(0, size - 1));
+  std::shared_ptr<T> pick;
+  for (const auto& candidate : {first, second}) {
+    // a snapshot can briefly trail a state change; stale entries defer
+    // to the locked path's authoritative view
+    if (candidate == excluded || !candidate->IsEstablished())
+      continue;
+    if (!pick) {
+      pick = candidate;
+      continue;
+    }
+    std::uint64_t const rtt = pick->GetMeanRTT(),
+                        other_rtt = candidate->GetMeanRTT();
+    if (other_rtt && (!rtt || other_rtt < rtt))
+      pick = candidate;
+  }
+  return pick;
+}
+
 template<class TTunnels>
 typename TTunnels::value_type TunnelPool::GetNextTunnel(
     TTunnels& tunnels,
     typename TTunnels::value_type excluded) const {
   if (tunnels.empty ())
     return nullptr;
-  std::uint32_t ind = kovri::core::RandInRange32(0, tunnels.size() / 2);
-  std::uint32_t i = 0;
-  typename TTunnels::value_type tunnel = nullptr;
-  for (auto it : tunnels) {
-    if (it->IsEstablished() && it != excluded) {
-      tunnel = it;
-      i++;
-    }
-    if (i > ind && tunnel)
-      break;
+  std::vector<typename TTunnels::value_type> established;
+  for (auto it : tunnels)
+    if (it->IsEstablished() && it != excluded)
+      established.push_back(it);
+  if (established.empty()) {
+    if (excluded && excluded->IsEstablished())
+      return excluded;
+    return nullptr;
   }
-  if (!tunnel && excluded && excluded->IsEstablished())
-    tunnel = excluded;
+  // Draw two candidates and keep the one with the lower measured round
+  // trip: biases selection toward fast tunnels while untested ones still
+  // win against each other and stay in rotation
+  auto tunnel = established.at(
+      kovri::core::FastRandInRange32(0, established.size() - 1));
+  auto const other = established.at(
+      kovri::core::FastRandInRange32(0, established.size() - 1));
+  std::uint64_t const rtt = tunnel->GetMeanRTT(),
+                      other_rtt = other->GetMeanRTT();
+  if (other_rtt && (!rtt || other_rtt < rtt))
+    tunnel = other;
   return tunnel;
 }
 
@@ -221,6 +327,8 @@ std::shared_ptr<OutboundTunnel> TunnelPool::GetNewOutboundTunnel(
 }
 
 void TunnelPool::CreateTunnels() {
+  // Expiring tunnels no longer count as established, so builds start
+  // before rotation; the standby spares absorb expiry without a stall
   int num = 0;
   {
     std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
@@ -228,7 +336,7 @@ void TunnelPool::CreateTunnels() {
       if (it->IsEstablished())
         num++;
   }
-  for (int i = num; i < m_NumInboundTunnels; i++)
+  for (int i = num; i < m_NumInboundTunnels + m_NumStandbyTunnels; i++)
     CreateInboundTunnel();
   num = 0;
   {
@@ -237,15 +345,51 @@ void TunnelPool::CreateTunnels() {
       if (it->IsEstablished())
         num++;
   }
-  for (int i = num; i < m_NumOutboundTunnels; i++)
+  for (int i = num; i < m_NumOutboundTunnels + m_NumStandbyTunnels; i++)
     CreateOutboundTunnel();
 }
 
+bool TunnelPool::IsSatisfied(const bool is_inbound) const {
+  // Mirrors the CreateTunnels() criterion: expiring tunnels already
+  // dropped out of the established state, so they don't mask the need
+  // for a replacement
+  int num = 0;
+  if (is_inbound) {
+    std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
+    for (auto it : m_InboundTunnels)
+      if (it->IsEstablished())
+        num++;
+    return num >= m_NumInboundTunnels + m_NumStandbyTunnels;
+  }
+  std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
+  for (auto it : m_OutboundTunnels)
+    if (it->IsEstablished())
+      num++;
+  return num >= m_NumOutboundTunnels + m_NumStandbyTunnels;
+}
+
+bool TunnelPool::IsOverProvisioned(const bool is_inbound) const {
+  int num = 0;
+  if (is_inbound) {
+    std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
+    for (auto it : m_InboundTunnels)
+      if (it->IsEstablished())
+        num++;
+    return num > m_NumInboundTunnels + m_NumStandbyTunnels;
+  }
+  std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
+  for (auto it : m_OutboundTunnels)
+    if (it->IsEstablished())
+      num++;
+  return num > m_NumOutboundTunnels + m_NumStandbyTunnels;
+}
+
 void TunnelPool::TestTunnels() {
   for (auto it : m_Tests) {
     LOG(warning) << "TunnelPool: tunnel test " << it.first << " failed";
     // if test failed again with another tunnel we consider it failed
     if (it.second.first) {
+      it.second.first->ResetConsecutiveTests();
       if (it.second.first->GetState() == e_TunnelStateTestFailed) {
         it.second.first->SetState(e_TunnelStateFailed);
         std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
@@ -255,6 +399,7 @@ void TunnelPool::TestTunnels() {
       }
     }
     if (it.second.second) {
+      it.second.second->ResetConsecutiveTests();
       if (it.second.second->GetState() == e_TunnelStateTestFailed) {
         it.second.second->SetState(e_TunnelStateFailed);
         {
@@ -269,7 +414,11 @@ void TunnelPool::TestTunnels() {
     }
   }
   m_Tests.clear();
+  // failed tunnels just left the established state (or the sets entirely)
+  RebuildInboundSnapshot();
+  RebuildOutboundSnapshot();
   // new tests
+  m_NumTestRounds++;
   auto it1 = m_OutboundTunnels.begin();
   auto it2 = m_InboundTunnels.begin();
   while (it1 != m_OutboundTunnels.end() && it2 != m_InboundTunnels.end()) {
@@ -283,6 +432,16 @@ void TunnelPool::TestTunnels() {
       it2++;
     }
     if (!failed) {
+      // Stable pairs back off to every Nth round; a failure resets the
+      // streak and restores the full probe rate
+      if ((*it1)->GetNumConsecutiveTests() >= TUNNEL_POOL_STABLE_TEST_STREAK
+          && (*it2)->GetNumConsecutiveTests()
+              >= TUNNEL_POOL_STABLE_TEST_STREAK
+          && m_NumTestRounds % TUNNEL_POOL_STABLE_TEST_INTERVAL) {
+        it1++;
+        it2++;
+        continue;
+      }
       std::uint32_t msg_ID = kovri::core::Rand<std::uint32_t>();
       m_Tests[msg_ID] = std::make_pair(*it1, *it2);
       (*it1)->SendTunnelDataMsg(
@@ -295,10 +454,59 @@ void TunnelPool::TestTunnels() {
   }
 }
 
+void TunnelPool::HandlePeerFailure(
+    const kovri::core::IdentHash& ident) {
+  auto through_peer =
+      [&ident](const std::shared_ptr<const TunnelConfig>& config) {
+        for (const auto& peer : config->GetPeers())
+          if (peer->GetIdentHash() == ident)
+            return true;
+        return false;
+      };
+  bool outbound_failed = false, inbound_failed = false;
+  {
+    std::unique_lock<std::mutex> l(m_OutboundTunnelsMutex);
+    for (auto it : m_OutboundTunnels)
+      if (it->IsEstablished() && through_peer(it->GetTunnelConfig())) {
+        LOG(warning)
+          << "TunnelPool: failing outbound tunnel through dead peer";
+        it->SetState(e_TunnelStateTestFailed);
+        it->ResetConsecutiveTests();
+        outbound_failed = true;
+      }
+  }
+  {
+    std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
+    for (auto it : m_InboundTunnels)
+      if (it->IsEstablished() && through_peer(it->GetTunnelConfig())) {
+        LOG(warning)
+          << "TunnelPool: failing inbound tunnel through dead peer";
+        it->SetState(e_TunnelStateTestFailed);
+        it->ResetConsecutiveTests();
+        inbound_failed = true;
+      }
+  }
+  if (outbound_failed)
+    RebuildOutboundSnapshot();
+  if (inbound_failed)
+    RebuildInboundSnapshot();
+  // start replacement builds now instead of on the next management round
+  if (outbound_failed || inbound_failed)
+    CreateTunnels();
+}
+
 void TunnelPool::ProcessGarlicMessage(
     std::shared_ptr<I2NPMessage> msg) {
   if (m_LocalDestination)
-    m_LocalDestination->ProcessGarlicMessage(msg);
+    m_LocalDestination->ProcessGarlicMessage(std::move(msg));
+  else
+    LOG(warning) << "TunnelPool: local destination doesn't exist, dropped";
+}
+
+void TunnelPool::ProcessGarlicMessages(
+    std::vector<std::shared_ptr<I2NPMessage>> msgs) {
+  if (m_LocalDestination)
+    m_LocalDestination->ProcessGarlicMessages(std::move(msgs));
   else
     LOG(warning) << "TunnelPool: local destination doesn't exist, dropped";
 }
@@ -313,18 +521,36 @@ void TunnelPool::ProcessDeliveryStatus(
   auto it = m_Tests.find(msg_ID);
   if (it != m_Tests.end()) {
     // restore from test failed state if any
-    if (it->second.first->GetState() == e_TunnelStateTestFailed)
+    if (it->second.first->GetState() == e_TunnelStateTestFailed) {
       it->second.first->SetState(e_TunnelStateEstablished);
-    if (it->second.second->GetState() == e_TunnelStateTestFailed)
+      RebuildOutboundSnapshot();
+    }
+    if (it->second.second->GetState() == e_TunnelStateTestFailed) {
       it->second.second->SetState(e_TunnelStateEstablished);
+      RebuildInboundSnapshot();
+    }
+    auto const rtt = kovri::core::GetMillisecondsSinceEpoch() - timestamp;
     LOG(debug)
       << "TunnelPool: tunnel test " << it->first
-      << " successful: " << kovri::core::GetMillisecondsSinceEpoch() - timestamp
-      << " milliseconds";
+      << " successful: " << rtt << " milliseconds";
+    // Both tunnels see the pair's round trip: GetNextTunnel uses the
+    // per-tunnel mean to favor fast pairs
+    it->second.first->AddRTTSample(rtt);
+    it->second.second->AddRTTSample(rtt);
+    // Credit every hop on the tested pair with an equal share of the round
+    // trip, so SelectNextHop can bias future builds toward fast peers
+    auto peers = it->second.first->GetTunnelConfig()->GetPeers();
+    auto const inbound_peers = it->second.second->GetTunnelConfig()->GetPeers();
+    peers.insert(peers.end(), inbound_peers.begin(), inbound_peers.end());
+    if (!peers.empty()) {
+      auto const rtt_share = rtt / peers.size();
+      for (const auto& peer : peers)
+        peer->GetProfile()->RecordRTT(rtt_share);
+    }
     m_Tests.erase(it);
   } else {
     if (m_LocalDestination)
-      m_LocalDestination->ProcessDeliveryStatusMessage(msg);
+      m_LocalDestination->ProcessDeliveryStatusMessage(std::move(msg));
     else
       LOG(warning) << "TunnelPool: local destination doesn't exist, dropped";
   }
@@ -332,14 +558,44 @@ void TunnelPool::ProcessDeliveryStatus(
 
 std::shared_ptr<const kovri::core::RouterInfo> TunnelPool::SelectNextHop(
     std::shared_ptr<const kovri::core::RouterInfo> prev_hop) const {
-  // TODO(unassigned): implement it better
   bool is_exploratory = (m_LocalDestination == &context);
-  auto hop = is_exploratory ?
-    kovri::core::netdb.GetRandomRouter(prev_hop) :
-    kovri::core::netdb.GetHighBandwidthRandomRouter(prev_hop);
-  if (!hop || hop->GetProfile ()->IsBad())
-    hop = kovri::core::netdb.GetRandomRouter();
-  return hop;
+  // Client pools draw from the ranked substrate shared across pools
+  // first: fast peers found by any pool's tests benefit the rest.
+  // Exploratory pools keep sampling the NetDb so new peers get measured
+  std::shared_ptr<const kovri::core::RouterInfo> best_hop;
+  double best_score = 0;
+  if (!is_exploratory) {
+    best_hop = tunnels.GetRankedPeer(prev_hop);
+    if (best_hop) {
+      auto profile = best_hop->GetProfile();
+      best_score = profile->GetScore();
+      if (m_TargetLatency && profile->HasRTT()
+          && profile->GetMeanRTT() * 2 <= m_TargetLatency)
+        return best_hop;
+    }
+  }
+  // Sample a few candidates and keep the best-scoring one instead of
+  // settling for the first random pick
+  for (int i = 0; i < TUNNEL_POOL_NUM_PEER_CANDIDATES; i++) {
+    auto hop = is_exploratory ?
+      kovri::core::netdb.GetRandomRouter(prev_hop) :
+      kovri::core::netdb.GetHighBandwidthRandomRouter(prev_hop);
+    if (!hop || hop->GetProfile()->IsBad())
+      continue;
+    auto profile = hop->GetProfile();
+    double const score = profile->GetScore();
+    if (!best_hop || score > best_score) {
+      best_hop = hop;
+      best_score = score;
+      // Measured well under the pool's target: no need to keep sampling
+      if (m_TargetLatency && profile->HasRTT()
+          && profile->GetMeanRTT() * 2 <= m_TargetLatency)
+        break;
+    }
+  }
+  if (!best_hop)
+    best_hop = kovri::core::netdb.GetRandomRouter();
+  return best_hop;
 }
 
 bool TunnelPool::SelectPeers(
@@ -351,6 +607,13 @@ bool TunnelPool::SelectPeers(
   int num_hops = is_inbound ?
     m_NumInboundHops :
     m_NumOutboundHops;
+  // zero-hop pool: the router itself terminates the tunnel (destination
+  // gateway = router), same self-only config the exploratory fallback
+  // inbound tunnel uses
+  if (!num_hops) {
+    hops.push_back(prev_hop);
+    return true;
+  }
   if (kovri::core::transports.GetNumPeers() > 25) {
     auto r = kovri::core::transports.GetRandomPeer();
     if (r && !r->GetProfile()->IsBad()) {
@@ -378,7 +641,7 @@ bool TunnelPool::SelectExplicitPeers(
   std::vector<int> peer_indicies;
   for (int i = 0; i < size; i++)
     peer_indicies.push_back(i);
-  kovri::core::Shuffle(peer_indicies.begin(), peer_indicies.end());
+  kovri::core::FastShuffle(peer_indicies.begin(), peer_indicies.end());
   int num_hops = is_inbound ? m_NumInboundHops : m_NumOutboundHops;
   for (int i = 0; i < num_hops; i++) {
     auto& ident = (*m_ExplicitPeers)[peer_indicies[i]];
@@ -386,7 +649,7 @@ bool TunnelPool::SelectExplicitPeers(
     if (r) {
       hops.push_back(r);
     } else {
-      LOG(debug) << "TunnelPool: can't find router for " << ident.ToBase64();
+      LOG(debug) << "TunnelPool: can't find router for " << ToBase64Cached(ident);
       kovri::core::netdb.RequestDestination(ident);
       return false;
     }
@@ -402,8 +665,14 @@ void TunnelPool::CreateInboundTunnel() {
   std::vector<std::shared_ptr<const kovri::core::RouterInfo> > hops;
   if (SelectPeers(hops, true)) {
     std::reverse(hops.begin(), hops.end());
+    auto config = std::make_shared<TunnelConfig>(hops);
+    if (tunnels.HasEquivalentPendingBuild(config)) {
+      LOG(debug)
+        << "TunnelPool: identical inbound build already pending, skipping";
+      return;
+    }
     auto tunnel = tunnels.CreateTunnel<InboundTunnel> (
-        std::make_shared<TunnelConfig> (hops),
+        config,
         outbound_tunnel);
     tunnel->SetTunnelPool(shared_from_this());
   } else {
@@ -413,15 +682,49 @@ void TunnelPool::CreateInboundTunnel() {
 
 void TunnelPool::RecreateInboundTunnel(
     std::shared_ptr<InboundTunnel> tunnel) {
+  if (IsOverProvisioned(true)) {
+    // the pool was scaled down: let surplus tunnels expire unreplaced
+    LOG(debug) << "TunnelPool: inbound tunnel not re-created, pool shrunk";
+    return;
+  }
   auto outbound_tunnel = GetNextOutboundTunnel();
   if (!outbound_tunnel)
     outbound_tunnel = tunnels.GetNextOutboundTunnel();
   LOG(debug) << "TunnelPool: re-creating destination inbound tunnel";
+  auto config = tunnel->GetTunnelConfig()->Clone();
+  if (tunnels.HasEquivalentPendingBuild(config)) {
+    LOG(debug)
+      << "TunnelPool: identical inbound build already pending, skipping";
+    return;
+  }
   auto new_tunnel =
     tunnels.CreateTunnel<InboundTunnel> (
-      tunnel->GetTunnelConfig()->Clone(),
+      config,
       outbound_tunnel);
   new_tunnel->SetTunnelPool(shared_from_this());
+  // reusing the expiring tunnel's proven hops; a build failure falls
+  // back to fresh selection (SamePathRecreationFailed)
+  new_tunnel->SetIsSamePathRecreation();
+}
+
+void TunnelPool::SamePathRecreationFailed(
+    std::shared_ptr<InboundTunnel> tunnel) {
+  if (!m_IsActive)
+    return;
+  LOG(debug)
+    << "TunnelPool: same-path recreation of inbound tunnel "
+    << tunnel->GetTunnelID() << " failed, retrying with fresh peers";
+  CreateInboundTunnel();
+}
+
+void TunnelPool::SamePathRecreationFailed(
+    std::shared_ptr<OutboundTunnel> tunnel) {
+  if (!m_IsActive)
+    return;
+  LOG(debug)
+    << "TunnelPool: same-path recreation of outbound tunnel "
+    << tunnel->GetTunnelID() << " failed, retrying with fresh peers";
+  CreateOutboundTunnel();
 }
 
 void TunnelPool::CreateOutboundTunnel() {
@@ -432,10 +735,15 @@ void TunnelPool::CreateOutboundTunnel() {
     LOG(debug) << "TunnelPool: creating destination outbound tunnel";
     std::vector<std::shared_ptr<const kovri::core::RouterInfo> > hops;
     if (SelectPeers(hops, false)) {
-      auto tunnel = tunnels.CreateTunnel<OutboundTunnel> (
-        std::make_shared<TunnelConfig> (
+      auto config = std::make_shared<TunnelConfig>(
           hops,
-          inbound_tunnel->GetTunnelConfig()));
+          inbound_tunnel->GetTunnelConfig());
+      if (tunnels.HasEquivalentPendingBuild(config)) {
+        LOG(debug)
+          << "TunnelPool: identical outbound build already pending, skipping";
+        return;
+      }
+      auto tunnel = tunnels.CreateTunnel<OutboundTunnel> (config);
       tunnel->SetTunnelPool(shared_from_this());
     } else {
       LOG(error)
@@ -450,15 +758,28 @@ void TunnelPool::CreateOutboundTunnel() {
 
 void TunnelPool::RecreateOutboundTunnel(
     std::shared_ptr<OutboundTunnel> tunnel) {
+  if (IsOverProvisioned(false)) {
+    // the pool was scaled down: let surplus tunnels expire unreplaced
+    LOG(debug) << "TunnelPool: outbound tunnel not re-created, pool shrunk";
+    return;
+  }
   auto inbound_tunnel = GetNextInboundTunnel();
   if (!inbound_tunnel)
     inbound_tunnel = tunnels.GetNextInboundTunnel();
   if (inbound_tunnel) {
     LOG(debug) << "TunnelPool: re-creating destination outbound tunnel";
-    auto new_tunnel = tunnels.CreateTunnel<OutboundTunnel> (
-      tunnel->GetTunnelConfig()->Clone(
-        inbound_tunnel->GetTunnelConfig()));
+    auto config = tunnel->GetTunnelConfig()->Clone(
+        inbound_tunnel->GetTunnelConfig());
+    if (tunnels.HasEquivalentPendingBuild(config)) {
+      LOG(debug)
+        << "TunnelPool: identical outbound build already pending, skipping";
+      return;
+    }
+    auto new_tunnel = tunnels.CreateTunnel<OutboundTunnel> (config);
     new_tunnel->SetTunnelPool(shared_from_this());
+    // reusing the expiring tunnel's proven hops; a build failure falls
+    // back to fresh selection (SamePathRecreationFailed)
+    new_tunnel->SetIsSamePathRecreation();
   } else {
     LOG(error)
       << "TunnelPool: can't re-create outbound tunnel, no inbound tunnels found";
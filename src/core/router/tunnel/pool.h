@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_ROUTER_TUNNEL_POOL_H_
 #define SRC_CORE_ROUTER_TUNNEL_POOL_H_
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <map>
@@ -57,6 +58,20 @@ class Tunnel;
 class InboundTunnel;
 class OutboundTunnel;
 
+/// @brief Candidate routers sampled per hop slot before picking the fastest
+const int TUNNEL_POOL_NUM_PEER_CANDIDATES = 4;
+/// @brief Assumed RTT share of peers without measurements (in milliseconds);
+///  keeps unmeasured peers in rotation without displacing known-fast ones
+const std::uint64_t TUNNEL_POOL_UNMEASURED_PEER_RTT = 400;
+/// @brief Spare verified tunnels kept per direction beyond the configured
+///  quantity, promoted instantly when a tunnel expires
+const int TUNNEL_POOL_DEFAULT_STANDBY_TUNNELS = 1;
+/// @brief Successful tests in a row after which a tunnel counts as stable
+const std::uint32_t TUNNEL_POOL_STABLE_TEST_STREAK = 3;
+/// @brief Pairs of stable tunnels are probed only every Nth test round,
+///  saving probe bandwidth for tunnels that actually need watching
+const std::uint32_t TUNNEL_POOL_STABLE_TEST_INTERVAL = 4;
+
 class TunnelPool
     : public std::enable_shared_from_this<TunnelPool> {  // per local destination
  public:
@@ -80,8 +95,55 @@ class TunnelPool
   void SetExplicitPeers(
       std::shared_ptr<std::vector<kovri::core::IdentHash> > explicit_peers);
 
+  /// @brief Sets the round trip this pool's tunnels should aim for
+  /// @param target_latency desired tunnel RTT in milliseconds (0 = no target)
+  void SetTargetLatency(
+      std::uint64_t target_latency) {
+    m_TargetLatency = target_latency;
+  }
+
+  std::uint64_t GetTargetLatency() const {
+    return m_TargetLatency;
+  }
+
+  /// @brief Rescales how many tunnels this pool maintains per direction
+  /// @notes Growth takes effect on the next build round; after a
+  ///   shrink, surplus tunnels are simply not replaced as they expire
+  void SetNumTunnels(
+      int num_inbound_tunnels,
+      int num_outbound_tunnels) {
+    m_NumInboundTunnels = num_inbound_tunnels > 0 ? num_inbound_tunnels : 1;
+    m_NumOutboundTunnels = num_outbound_tunnels > 0 ? num_outbound_tunnels : 1;
+  }
+
+  /// @brief Sets how many spare verified tunnels to keep per direction
+  void SetStandbyTunnels(
+      int num_standby_tunnels) {
+    m_NumStandbyTunnels = num_standby_tunnels;
+  }
+
+  int GetStandbyTunnels() const {
+    return m_NumStandbyTunnels;
+  }
+
+  /// @brief Sets how long before expiry replacement builds start
+  /// @param lead_time in seconds
+  void SetRecreationLeadTime(
+      std::uint64_t lead_time) {
+    m_RecreationLeadTime = lead_time;
+  }
+
+  std::uint64_t GetRecreationLeadTime() const {
+    return m_RecreationLeadTime;
+  }
+
   void CreateTunnels();
 
+  /// @brief Whether the pool already holds its configured quantity of
+  ///   established tunnels (plus standby) in the given direction, none of
+  ///   them close enough to expiry to need a replacement build
+  bool IsSatisfied(bool is_inbound) const;
+
   void TunnelCreated(
       std::shared_ptr<InboundTunnel> created_tunnel);
 
@@ -100,6 +162,18 @@ class TunnelPool
   void RecreateOutboundTunnel(
       std::shared_ptr<OutboundTunnel> tunnel);
 
+  /// @brief Retries a failed same-path replacement build with fresh peer
+  ///   selection, so the proven-path preference never costs the pool its
+  ///   replacement before the old tunnel expires
+  void SamePathRecreationFailed(
+      std::shared_ptr<InboundTunnel> tunnel);
+
+  void SamePathRecreationFailed(
+      std::shared_ptr<OutboundTunnel> tunnel);
+
+  std::vector<std::shared_ptr<OutboundTunnel> > GetOutboundTunnels(
+      int num) const;
+
   std::vector<std::shared_ptr<InboundTunnel> > GetInboundTunnels(
       int num) const;
 
@@ -114,9 +188,21 @@ class TunnelPool
 
   void TestTunnels();
 
+  /// @brief Fails every established tunnel that runs through the given
+  ///   peer and starts replacement builds right away
+  /// @param ident the router hash of a peer the transports declared dead
+  /// @notes Tunnels are put into the test-failed state, the same state a
+  ///   lost test round leaves them in, so a peer that recovers before the
+  ///   next test can still be reprieved by ProcessDeliveryStatus
+  void HandlePeerFailure(
+      const kovri::core::IdentHash& ident);
+
   void ProcessGarlicMessage(
       std::shared_ptr<I2NPMessage> msg);
 
+  void ProcessGarlicMessages(
+      std::vector<std::shared_ptr<I2NPMessage>> msgs);
+
   void ProcessDeliveryStatus(
       std::shared_ptr<I2NPMessage> msg);
 
@@ -136,6 +222,10 @@ class TunnelPool
 
   void CreateOutboundTunnel();
 
+  /// @brief Whether a direction holds more established tunnels than the
+  ///   configured quantity plus standby; true after the pool shrank
+  bool IsOverProvisioned(bool is_inbound) const;
+
   void CreatePairedInboundTunnel(
       std::shared_ptr<OutboundTunnel> outbound_tunnel);
 
@@ -144,6 +234,30 @@ class TunnelPool
       TTunnels& tunnels,
       typename TTunnels::value_type excluded) const;
 
+  /// @brief Immutable flat array of a direction's established tunnels,
+  ///   swapped in whole whenever the backing set mutates. Per-message
+  ///   selection reads the current snapshot lock-free; the ordered sets
+  ///   stay authoritative and serve the locked fallback path
+  template <class T>
+  struct TunnelSnapshot {
+    std::vector<std::shared_ptr<T>> tunnels;
+  };
+
+  /// @brief Lock-free selection from a snapshot: one round-robin cursor
+  ///   pick, one random pick, keep the lower measured round trip
+  /// @return nullptr when the snapshot yields no usable tunnel (empty,
+  ///   excluded, or gone stale); the caller then takes the locked path
+  template <class T>
+  static std::shared_ptr<T> SelectFromSnapshot(
+      const std::shared_ptr<const TunnelSnapshot<T>>& snapshot,
+      std::atomic<std::uint32_t>& cursor,
+      const std::shared_ptr<T>& excluded);
+
+  /// @brief Recomputes the established-tunnel snapshots from the sets;
+  ///   call after any insert, erase or tunnel state change
+  void RebuildInboundSnapshot();
+  void RebuildOutboundSnapshot();
+
   std::shared_ptr<const kovri::core::RouterInfo> SelectNextHop(
       std::shared_ptr<const kovri::core::RouterInfo> prev_hop) const;
 
@@ -162,6 +276,12 @@ class TunnelPool
       m_NumInboundTunnels,
       m_NumOutboundTunnels;
   std::shared_ptr<std::vector<kovri::core::IdentHash> > m_ExplicitPeers;
+  /// @brief Desired tunnel RTT in milliseconds (0 = no target)
+  std::uint64_t m_TargetLatency;
+  /// @brief Spare verified tunnels kept per direction
+  int m_NumStandbyTunnels;
+  /// @brief Seconds before expiry at which replacement builds start
+  std::uint64_t m_RecreationLeadTime;
 
   mutable std::mutex m_InboundTunnelsMutex;
   mutable std::mutex m_OutboundTunnelsMutex;
@@ -184,7 +304,18 @@ class TunnelPool
   std::set<std::shared_ptr<InboundTunnel>, CompareTime> m_InboundTunnels;
   std::set<std::shared_ptr<OutboundTunnel>, CompareTime> m_OutboundTunnels;
 
+  // selection snapshots (std::atomic_load/store) and round-robin cursors;
+  // mutable so the const GetNext* selectors stay lock-free
+  mutable std::shared_ptr<const TunnelSnapshot<InboundTunnel>>
+      m_InboundSnapshot;
+  mutable std::shared_ptr<const TunnelSnapshot<OutboundTunnel>>
+      m_OutboundSnapshot;
+  mutable std::atomic<std::uint32_t> m_InboundCursor{0};
+  mutable std::atomic<std::uint32_t> m_OutboundCursor{0};
+
   std::map<std::uint32_t, std::pair<std::shared_ptr<OutboundTunnel>, std::shared_ptr<InboundTunnel> > > m_Tests;
+  /// @brief Test rounds run so far; stable pairs only probe every Nth
+  std::uint32_t m_NumTestRounds;
   bool m_IsActive;
 
  public:
@@ -34,11 +34,14 @@
 
 #include <string.h>
 
+#include <utility>
+
 #include "core/router/context.h"
 #include "core/router/transports/impl.h"
 #include "core/router/tunnel/impl.h"
 
 #include "core/util/log.h"
+#include "core/util/trace.h"
 
 namespace kovri {
 namespace core {
@@ -67,7 +70,31 @@ void TransitTunnel::EncryptTunnelMsg(
     std::shared_ptr<I2NPMessage> out) {
   // TODO(anonimal): this try block should be handled entirely by caller
   try {
+    KOVRI_PROBE2(transit_crypto_begin, GetTunnelID(), 1);
     m_Encryption.Encrypt(in->GetPayload() + 4, out->GetPayload() + 4);
+    KOVRI_PROBE2(transit_crypto_end, GetTunnelID(), 1);
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+    throw;
+  }
+}
+
+void TransitTunnel::EncryptTunnelMsgBatch(
+    const std::vector<std::shared_ptr<I2NPMessage>>& msgs) {
+  std::vector<const std::uint8_t*> in;
+  std::vector<std::uint8_t*> out;
+  in.reserve(msgs.size());
+  out.reserve(msgs.size());
+  for (const auto& msg : msgs) {
+    in.push_back(msg->GetPayload() + 4);
+    out.push_back(msg->GetPayload() + 4);
+  }
+  // TODO(anonimal): this try block should be handled entirely by caller
+  try {
+    KOVRI_PROBE2(transit_crypto_begin, GetTunnelID(), msgs.size());
+    m_Encryption.EncryptBatch(in.data(), out.data(), msgs.size());
+    KOVRI_PROBE2(transit_crypto_end, GetTunnelID(), msgs.size());
   } catch (...) {
     m_Exception.Dispatch(__func__);
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
@@ -79,28 +106,35 @@ TransitTunnelParticipant::~TransitTunnelParticipant() {}
 
 void TransitTunnelParticipant::HandleTunnelDataMsg(
     std::shared_ptr<const kovri::core::I2NPMessage> tunnel_msg) {
-  auto new_msg = CreateEmptyTunnelDataMsg();
-  EncryptTunnelMsg(tunnel_msg, new_msg);
   m_NumTransmittedBytes += tunnel_msg->GetLength();
-  core::OutputByteStream::Write<std::uint32_t>(
-      new_msg->GetPayload(), GetNextTunnelID());
-  new_msg->FillI2NPMessageHeader(I2NPTunnelData);
-  m_TunnelDataMsgs.push_back(new_msg);
+  // the dispatcher routed this frame to us alone and never rereads it, so
+  // relay the received message itself: it is re-keyed in place at flush
+  // instead of being cloned into a fresh message
+  m_PendingMsgs.push_back(
+      std::const_pointer_cast<kovri::core::I2NPMessage>(tunnel_msg));
 }
 
 void TransitTunnelParticipant::FlushTunnelDataMsgs() {
-  if (!m_TunnelDataMsgs.empty()) {
-    auto num = m_TunnelDataMsgs.size();
-    if (num > 1)
-      LOG(debug)
-        << "TransitTunnelParticipant: " << GetTunnelID()
-        << "->" << GetNextTunnelID()
-        << " " << num;
-    kovri::core::transports.SendMessages(
-        GetNextIdentHash(),
-        m_TunnelDataMsgs);
-    m_TunnelDataMsgs.clear();
+  if (m_PendingMsgs.empty())
+    return;
+  // layer encryption was deferred so it can run as one in-place batch
+  EncryptTunnelMsgBatch(m_PendingMsgs);
+  for (const auto& msg : m_PendingMsgs) {
+    core::OutputByteStream::Write<std::uint32_t>(
+        msg->GetPayload(), GetNextTunnelID());
+    msg->FillI2NPMessageHeader(I2NPTunnelData);
+    msg->transit = true;
   }
+  auto num = m_PendingMsgs.size();
+  if (num > 1)
+    LOG(debug)
+      << "TransitTunnelParticipant: " << GetTunnelID()
+      << "->" << GetNextTunnelID()
+      << " " << num;
+  kovri::core::transports.SendMessages(
+      GetNextIdentHash(),
+      m_PendingMsgs);
+  m_PendingMsgs.clear();
 }
 
 void TransitTunnel::SendTunnelDataMsg(
@@ -119,9 +153,9 @@ void TransitTunnelGateway::SendTunnelDataMsg(
     std::shared_ptr<kovri::core::I2NPMessage> msg) {
   TunnelMessageBlock block;
   block.delivery_type = e_DeliveryTypeLocal;
-  block.data = msg;
+  block.data = std::move(msg);
   std::unique_lock<std::mutex> l(m_SendMutex);
-  m_Gateway.PutTunnelDataMsg(block);
+  m_Gateway.PutTunnelDataMsg(std::move(block));
 }
 
 void TransitTunnelGateway::FlushTunnelDataMsgs() {
@@ -37,6 +37,7 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "core/crypto/tunnel.h"
@@ -79,6 +80,11 @@ class TransitTunnel : public TunnelBase {
       std::shared_ptr<const I2NPMessage> in,
       std::shared_ptr<I2NPMessage> out);
 
+  /// @brief Encrypts the payloads of the given messages in place in one
+  ///   batched crypto call (see TunnelEncryption::EncryptBatch)
+  void EncryptTunnelMsgBatch(
+      const std::vector<std::shared_ptr<I2NPMessage>>& msgs);
+
   std::uint32_t GetNextTunnelID() const {
     return m_NextTunnelID;
   }
@@ -87,6 +93,10 @@ class TransitTunnel : public TunnelBase {
     return m_NextIdent;
   }
 
+  bool IsTransit() const {
+    return true;
+  }
+
  private:
   std::uint32_t m_TunnelID,
            m_NextTunnelID;
@@ -123,7 +133,9 @@ class TransitTunnelParticipant : public TransitTunnel {
 
  private:
   std::size_t m_NumTransmittedBytes;
-  std::vector<std::shared_ptr<kovri::core::I2NPMessage> > m_TunnelDataMsgs;
+  // received frames relayed as-is: layer-encrypted in place in batch at
+  // flush, then handed to the transports without cloning
+  std::vector<std::shared_ptr<kovri::core::I2NPMessage>> m_PendingMsgs;
 };
 
 class TransitTunnelGateway : public TransitTunnel {
@@ -0,0 +1,254 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_ROUTER_TUNNEL_TRANSIT_TABLE_H_
+#define SRC_CORE_ROUTER_TUNNEL_TRANSIT_TABLE_H_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "core/router/tunnel/transit.h"
+
+namespace kovri {
+namespace core {
+
+/// @class TransitTunnelTable
+/// @brief Open-addressing hash table of transit tunnels keyed by tunnel
+///   ID, guarded by a reader-writer lock (same layout as
+///   RouterInfoTable). The relay fast path looks a tunnel up per relayed
+///   message; slots inline the ID next to the tunnel pointer in a flat
+///   array, so a lookup is a short probe over one or two cache lines
+///   instead of a red-black-tree walk, followed by exactly one pointer
+///   dereference into the tunnel's key schedule and next-hop ident
+/// @note Owns the tunnels: whatever is left at destruction is deleted.
+///   Erased entries are only unlinked, matching the previous map
+///   behavior (a crypto worker may still hold the raw pointer)
+/// @details Entries are also filed into a coarse expiry wheel at insert
+///   (transit tunnels all live a fixed lifetime, so insertion order is
+///   expiry order): each management sweep visits only the slots that
+///   came due since the last one, keeping the write lock held for
+///   O(expiring) work instead of a scan over every tunnel
+class TransitTunnelTable {
+ public:
+  explicit TransitTunnelTable(
+      std::size_t initial_buckets = 1024)
+      : m_Size(0),
+        m_Tombstones(0),
+        m_LastSweepTick(0),
+        m_Buckets(initial_buckets) {}
+
+  ~TransitTunnelTable() {
+    for (auto& bucket : m_Buckets)
+      if (bucket.state == Bucket::Full)
+        delete bucket.tunnel;
+  }
+
+  /// @brief Inserts the tunnel under its tunnel ID and files it into the
+  ///   wheel slot covering expiry (seconds since epoch)
+  /// @return False when the ID is already present (tunnel not inserted)
+  bool Insert(
+      TransitTunnel* tunnel,
+      std::uint64_t expiry) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    // 0.75 load factor counting tombstones: every expiry sweep leaves
+    // some behind, and a relay below the growth threshold would never
+    // otherwise rehash and reclaim them; rehashing at the current size
+    // merely clears accumulated tombstones
+    if ((m_Size + m_Tombstones + 1) * 4 > m_Buckets.size() * 3)
+      Rehash(
+          (m_Size + 1) * 4 > m_Buckets.size() * 3
+              ? m_Buckets.size() * 2
+              : m_Buckets.size());
+    if (!InsertNonThreadSafe(tunnel))
+      return false;
+    m_Wheel[(expiry / WheelGranularity) % WheelSlots].push_back(
+        WheelEntry{tunnel->GetTunnelID(), tunnel, expiry});
+    return true;
+  }
+
+  TransitTunnel* Find(
+      std::uint32_t tunnel_ID) const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    const Bucket* bucket = FindBucket(tunnel_ID);
+    return bucket ? bucket->tunnel : nullptr;
+  }
+
+  std::size_t Size() const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    return m_Size;
+  }
+
+  /// @brief Visits every entry under a shared lock; the visitor must not
+  ///   call back into this table
+  template<typename Visitor>
+  void ForEach(
+      Visitor visit) const {
+    std::shared_lock<std::shared_timed_mutex> l(m_Mutex);
+    for (const auto& bucket : m_Buckets)
+      if (bucket.state == Bucket::Full)
+        visit(bucket.tunnel);
+  }
+
+  /// @brief Unlinks every tunnel whose expiry has passed by walking only
+  ///   the wheel slots that came due since the last sweep; a slot comes
+  ///   due one granule after its window closes, so tunnels always get
+  ///   their full lifetime (and at most one granule of grace)
+  /// @param ts Current time in seconds since epoch
+  /// @return Number of unlinked entries
+  std::size_t SweepExpired(
+      std::uint64_t ts) {
+    std::unique_lock<std::shared_timed_mutex> l(m_Mutex);
+    const std::uint64_t tick = ts / WheelGranularity;
+    if (!m_LastSweepTick || tick - m_LastSweepTick > WheelSlots)
+      m_LastSweepTick = tick > WheelSlots ? tick - WheelSlots : 0;
+    std::size_t erased = 0;
+    for (std::uint64_t due = m_LastSweepTick + 1; due < tick; due++) {
+      auto& slot = m_Wheel[due % WheelSlots];
+      std::vector<WheelEntry> keep;
+      for (const auto& entry : slot) {
+        if (entry.expiry > ts) {  // lapped after a long sweep gap
+          keep.push_back(entry);
+          continue;
+        }
+        Bucket* bucket =
+            const_cast<Bucket*>(FindBucket(entry.tunnel_ID));
+        // the pointer match skips IDs reused since this entry was filed
+        if (bucket && bucket->tunnel == entry.tunnel) {
+          bucket->tunnel = nullptr;
+          bucket->state = Bucket::Tombstone;
+          m_Size--;
+          m_Tombstones++;
+          erased++;
+        }
+      }
+      slot = std::move(keep);
+    }
+    if (tick)
+      m_LastSweepTick = tick - 1;
+    return erased;
+  }
+
+ private:
+  struct Bucket {
+    enum State : std::uint8_t { Empty = 0, Full, Tombstone };
+    std::uint32_t tunnel_ID = 0;
+    State state = Empty;
+    TransitTunnel* tunnel = nullptr;
+  };
+
+  // Expiry wheel geometry: 64 slots of 32 seconds span ~34 minutes,
+  // comfortably past the fixed transit lifetime plus sweep-interval slack
+  enum : std::uint64_t { WheelGranularity = 32, WheelSlots = 64 };
+
+  /// @brief Wheel entries keep the pointer filed at insert so a tunnel
+  ///   ID reused after an early teardown is never unlinked prematurely
+  struct WheelEntry {
+    std::uint32_t tunnel_ID;
+    TransitTunnel* tunnel;
+    std::uint64_t expiry;
+  };
+
+  /// @brief Tunnel IDs are random but cheap mixing guards against probe
+  ///   clustering under the power-of-two mask
+  static std::size_t Hash(
+      std::uint32_t tunnel_ID) {
+    return (tunnel_ID * 0x9E3779B97F4A7C15ULL) >> 32;
+  }
+
+  const Bucket* FindBucket(
+      std::uint32_t tunnel_ID) const {
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::size_t pos = Hash(tunnel_ID) & mask;
+    for (std::size_t probe = 0; probe < m_Buckets.size(); probe++) {
+      const Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Empty)
+        return nullptr;
+      if (bucket.state == Bucket::Full && bucket.tunnel_ID == tunnel_ID)
+        return &bucket;
+      pos = (pos + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  bool InsertNonThreadSafe(
+      TransitTunnel* tunnel) {
+    const std::size_t mask = m_Buckets.size() - 1;
+    std::uint32_t const tunnel_ID = tunnel->GetTunnelID();
+    std::size_t pos = Hash(tunnel_ID) & mask;
+    Bucket* tombstone = nullptr;
+    for (;;) {
+      Bucket& bucket = m_Buckets[pos];
+      if (bucket.state == Bucket::Full && bucket.tunnel_ID == tunnel_ID)
+        return false;  // already exists
+      if (bucket.state == Bucket::Tombstone && !tombstone) {
+        tombstone = &bucket;
+      } else if (bucket.state == Bucket::Empty) {
+        Bucket& target = tombstone ? *tombstone : bucket;
+        if (tombstone)
+          m_Tombstones--;
+        target.tunnel_ID = tunnel_ID;
+        target.tunnel = tunnel;
+        target.state = Bucket::Full;
+        m_Size++;
+        return true;
+      }
+      pos = (pos + 1) & mask;
+    }
+  }
+
+  void Rehash(
+      std::size_t new_buckets) {
+    std::vector<Bucket> old = std::move(m_Buckets);
+    m_Buckets.assign(new_buckets, Bucket());
+    m_Size = 0;
+    m_Tombstones = 0;
+    for (auto& bucket : old)
+      if (bucket.state == Bucket::Full)
+        InsertNonThreadSafe(bucket.tunnel);
+  }
+
+ private:
+  mutable std::shared_timed_mutex m_Mutex;
+  std::size_t m_Size;
+  std::size_t m_Tombstones;
+  std::uint64_t m_LastSweepTick;
+  std::vector<Bucket> m_Buckets;
+  std::array<std::vector<WheelEntry>, WheelSlots> m_Wheel;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_TUNNEL_TRANSIT_TABLE_H_
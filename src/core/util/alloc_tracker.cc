@@ -0,0 +1,109 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/alloc_tracker.h"
+
+namespace kovri
+{
+namespace core
+{
+namespace
+{
+// Plain thread-locals with constant initialization: touching them from
+// inside operator new/delete must never itself allocate or lock
+thread_local bool t_Enabled = false;
+thread_local AllocStats t_Stats;
+thread_local std::size_t t_CapturedCount = 0;
+thread_local std::size_t t_CapturedSizes[AllocTracker::MaxCapturedSites];
+thread_local const void* t_CapturedSites[AllocTracker::MaxCapturedSites];
+}  // namespace
+
+void AllocTracker::Enable() noexcept
+{
+  t_Stats = AllocStats();
+  t_CapturedCount = 0;
+  t_Enabled = true;
+}
+
+void AllocTracker::Disable() noexcept
+{
+  t_Enabled = false;
+}
+
+bool AllocTracker::IsEnabled() noexcept
+{
+  return t_Enabled;
+}
+
+AllocStats AllocTracker::GetStats() noexcept
+{
+  return t_Stats;
+}
+
+std::size_t AllocTracker::GetCapturedCount() noexcept
+{
+  return t_CapturedCount;
+}
+
+std::size_t AllocTracker::GetCapturedSize(const std::size_t index) noexcept
+{
+  return index < t_CapturedCount ? t_CapturedSizes[index] : 0;
+}
+
+const void* AllocTracker::GetCapturedSite(const std::size_t index) noexcept
+{
+  return index < t_CapturedCount ? t_CapturedSites[index] : nullptr;
+}
+
+void AllocTracker::RecordAllocation(
+    const std::size_t size,
+    const void* site) noexcept
+{
+  if (!t_Enabled)
+    return;
+  t_Stats.allocations++;
+  t_Stats.bytes += size;
+  if (t_CapturedCount < MaxCapturedSites)
+    {
+      t_CapturedSizes[t_CapturedCount] = size;
+      t_CapturedSites[t_CapturedCount] = site;
+      t_CapturedCount++;
+    }
+}
+
+void AllocTracker::RecordDeallocation() noexcept
+{
+  if (!t_Enabled)
+    return;
+  t_Stats.deallocations++;
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,119 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_ALLOC_TRACKER_H_
+#define SRC_CORE_UTIL_ALLOC_TRACKER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kovri
+{
+namespace core
+{
+
+/// @brief Heap allocation counters for one thread (see AllocTracker)
+struct AllocStats
+{
+  std::uint64_t allocations = 0;
+  std::uint64_t deallocations = 0;
+  std::uint64_t bytes = 0;  ///< Total bytes requested while enabled
+};
+
+/// @class AllocTracker
+/// @brief Per-thread allocation bookkeeping behind the interposed global
+///   operator new/delete of instrumented (test) builds
+/// @notes The production libraries only carry these counters; the
+///   operators that feed them are defined by the test binary, so hot
+///   paths can be regression-gated to zero allocations without touching
+///   release allocation behavior. Everything is thread-local: enabling
+///   the tracker on one thread never observes another thread's traffic
+/// @notes Record functions must not allocate; they are called from
+///   inside operator new/delete
+class AllocTracker
+{
+ public:
+  /// @brief First allocations whose size/call site are kept per Enable
+  enum : std::size_t
+  {
+    MaxCapturedSites = 16,
+  };
+
+  /// @brief Resets the counters and starts recording on this thread
+  static void Enable() noexcept;
+
+  static void Disable() noexcept;
+
+  static bool IsEnabled() noexcept;
+
+  static AllocStats GetStats() noexcept;
+
+  /// @brief Allocations captured since Enable, at most MaxCapturedSites
+  static std::size_t GetCapturedCount() noexcept;
+
+  /// @brief Requested size of the index-th captured allocation
+  static std::size_t GetCapturedSize(std::size_t index) noexcept;
+
+  /// @brief Return address of the index-th captured allocation's caller;
+  ///   null where the toolchain offers no cheap way to take it
+  static const void* GetCapturedSite(std::size_t index) noexcept;
+
+  /// @brief Called by the interposed operator new; no-op while disabled
+  static void RecordAllocation(
+      std::size_t size,
+      const void* site) noexcept;
+
+  /// @brief Called by the interposed operator delete; no-op while disabled
+  static void RecordDeallocation() noexcept;
+};
+
+/// @class AllocTrackerScope
+/// @brief Counts this thread's heap allocations for its lifetime
+class AllocTrackerScope
+{
+ public:
+  AllocTrackerScope()
+  {
+    AllocTracker::Enable();
+  }
+
+  ~AllocTrackerScope()
+  {
+    AllocTracker::Disable();
+  }
+
+  AllocTrackerScope(const AllocTrackerScope&) = delete;
+  AllocTrackerScope& operator=(const AllocTrackerScope&) = delete;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_ALLOC_TRACKER_H_
@@ -0,0 +1,75 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/arena.h"
+
+#include <algorithm>
+
+namespace kovri
+{
+namespace core
+{
+std::uint8_t* SerializationArena::Allocate(const std::size_t len)
+{
+  if (ARENA_BLOCK_SIZE - m_Offset >= len)
+    {
+      std::uint8_t* data = m_Block.data() + m_Offset;
+      m_Offset += len;
+      return data;
+    }
+  m_Overflow.push_back(std::make_unique<std::uint8_t[]>(len));
+  return m_Overflow.back().get();
+}
+
+void SerializationArena::Release(const std::uint8_t* data, const std::size_t len)
+{
+  if (data + len == m_Block.data() + m_Offset)
+    {
+      m_Offset -= len;
+      return;
+    }
+  const auto it = std::find_if(
+      m_Overflow.begin(),
+      m_Overflow.end(),
+      [data](const std::unique_ptr<std::uint8_t[]>& block) {
+        return block.get() == data;
+      });
+  if (it != m_Overflow.end())
+    m_Overflow.erase(it);
+}
+
+SerializationArena& SerializationArena::ThreadLocal()
+{
+  static thread_local SerializationArena arena;
+  return arena;
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,79 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_ARENA_H_
+#define SRC_CORE_UTIL_ARENA_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace kovri
+{
+namespace core
+{
+/// @brief Per-thread arena block size. Sized for the scratch buffers of a
+///   serialization cycle (an SSU packet tops out near the MTU, an RI at a
+///   few KB); larger requests fall back to a tracked heap allocation
+const std::size_t ARENA_BLOCK_SIZE = 32 * 1024;
+
+/// @class SerializationArena
+/// @brief Per-thread bump allocator for short-lived serialization
+///   buffers. Scoped borrowers release in LIFO order, so the bump offset
+///   rewinds to zero at the end of each serialization cycle and steady
+///   state does no heap allocation.
+class SerializationArena
+{
+ public:
+  /// @brief Borrows len bytes from the thread's block, falling back to a
+  ///   tracked heap allocation when the block cannot fit the request
+  /// @return Pointer to uninitialized storage, never null
+  std::uint8_t* Allocate(const std::size_t len);
+
+  /// @brief Returns a borrowed allocation. The common scoped (LIFO) case
+  ///   rewinds the bump offset; a non-LIFO block release is reclaimed
+  ///   when the enclosing borrowers release in turn
+  void Release(const std::uint8_t* data, const std::size_t len);
+
+  /// @brief The calling thread's arena
+  static SerializationArena& ThreadLocal();
+
+ private:
+  std::array<std::uint8_t, ARENA_BLOCK_SIZE> m_Block;
+  std::size_t m_Offset{};
+  std::vector<std::unique_ptr<std::uint8_t[]>> m_Overflow;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_ARENA_H_
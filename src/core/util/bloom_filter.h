@@ -0,0 +1,114 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_UTIL_BLOOM_FILTER_H_
+#define SRC_CORE_UTIL_BLOOM_FILTER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kovri
+{
+namespace core
+{
+/// @class RotatingBloomFilter
+/// @brief Approximate set of recently seen 64-bit keys, kept as two
+///   epoch bit arrays. Insert() tests both epochs and records into the
+///   current one; Rotate() discards the older epoch, so membership
+///   covers one to two rotation intervals before a key is forgotten.
+///   False positives are possible (a fresh key reported as seen), false
+///   negatives are not within the covered window. Not internally
+///   synchronized: callers confine it to a single thread
+class RotatingBloomFilter
+{
+ public:
+  /// @brief Default bits per epoch (16 KB), comfortably below a percent
+  ///   of false positives for a few thousand entries per epoch
+  static const std::size_t DefaultBits = 1 << 17;
+
+  /// @param num_bits Bits per epoch, rounded down to a power of two
+  explicit RotatingBloomFilter(std::size_t num_bits = DefaultBits)
+  {
+    std::size_t bits = 64;
+    while (bits * 2 <= num_bits)
+      bits *= 2;
+    m_Mask = bits - 1;
+    m_Current.resize(bits / 64);
+    m_Previous.resize(bits / 64);
+  }
+
+  /// @brief Tests and records a key
+  /// @return False when the key was already present
+  bool Insert(std::uint64_t key) noexcept
+  {
+    const std::uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+    const std::size_t bit1 = hash & m_Mask;
+    const std::size_t bit2 = (hash >> 32) & m_Mask;
+    const bool seen = (Test(m_Current, bit1) && Test(m_Current, bit2))
+                      || (Test(m_Previous, bit1) && Test(m_Previous, bit2));
+    // Recording regardless refreshes keys still seen in the old epoch
+    Set(m_Current, bit1);
+    Set(m_Current, bit2);
+    return !seen;
+  }
+
+  /// @brief Ages the filter: the current epoch becomes the previous one
+  ///   and a cleared array starts collecting
+  void Rotate() noexcept
+  {
+    std::swap(m_Current, m_Previous);
+    std::fill(m_Current.begin(), m_Current.end(), 0);
+  }
+
+ private:
+  static bool Test(const std::vector<std::uint64_t>& bits,
+                   std::size_t bit) noexcept
+  {
+    return bits[bit / 64] & (1ULL << (bit % 64));
+  }
+
+  static void Set(std::vector<std::uint64_t>& bits, std::size_t bit) noexcept
+  {
+    bits[bit / 64] |= 1ULL << (bit % 64);
+  }
+
+ private:
+  std::size_t m_Mask;
+  std::vector<std::uint64_t> m_Current, m_Previous;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_BLOOM_FILTER_H_
@@ -32,10 +32,12 @@
 #define SRC_CORE_UTIL_BUFFER_H_
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <exception>
 #include <string>
+#include <utility>
 
 namespace kovri
 {
@@ -66,6 +68,29 @@ class Buffer final
 
   explicit Buffer(const Buffer&) = delete;
 
+  /// @brief Moves contents into a fresh buffer, wiping the source
+  /// @notes Storage is always inline (never heap), so a move copies the
+  ///   used prefix; the moved-from buffer is zeroed so scratch contents
+  ///   (keys, signatures) don't linger in dead frames
+  Buffer(Buffer&& other) noexcept
+  {
+    *this = std::move(other);
+  }
+
+  Buffer& operator=(Buffer&& other) noexcept
+  {
+    if (this != &other)
+      {
+        std::copy(
+            other.m_Buffer.begin(),
+            other.m_Buffer.begin() + other.m_Length,
+            m_Buffer.begin());
+        m_Length = other.m_Length;
+        other.clear();
+      }
+    return *this;
+  }
+
   ~Buffer() = default;
 
   bool operator==(Buffer& other)
@@ -114,6 +139,35 @@ class Buffer final
     return m_Length;
   }
 
+  bool empty() const noexcept
+  {
+    return !m_Length;
+  }
+
+  /// @brief Span-style iteration over the used prefix
+  /// @notes Together with data()/size(), the interop surface for
+  ///   span-like consumers (asio buffers, std algorithms) until we move
+  ///   to a real span type
+  std::uint8_t* begin() noexcept
+  {
+    return m_Buffer.data();
+  }
+
+  std::uint8_t* end() noexcept
+  {
+    return m_Buffer.data() + m_Length;
+  }
+
+  const std::uint8_t* begin() const noexcept
+  {
+    return m_Buffer.data();
+  }
+
+  const std::uint8_t* end() const noexcept
+  {
+    return m_Buffer.data() + m_Length;
+  }
+
   void clear()
   {
     m_Buffer.fill(0);
@@ -39,6 +39,7 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "core/util/arena.h"
 #include "core/util/log.h"
 
 // TODO(anonimal): a secure bytestream implementation that ensures wiped memory when needed.
@@ -154,6 +155,18 @@ void OutputByteStream::SkipBytes(const std::size_t len)
   WriteData(nullptr, len, true);
 }
 
+ArenaOutputByteStream::ArenaOutputByteStream(const std::size_t len)
+    : OutputByteStream(SerializationArena::ThreadLocal().Allocate(len), len)
+{
+  // Match the zeroed internal-buffer semantics callers expect
+  std::memset(data(), 0, len);
+}
+
+ArenaOutputByteStream::~ArenaOutputByteStream()
+{
+  SerializationArena::ThreadLocal().Release(data(), size());
+}
+
 // Misc
 
 const std::string GetFormattedHex(
@@ -110,6 +110,22 @@ class ByteStream
   std::vector<std::uint8_t> m_Data;  ///< Internal buffer if no buffer supplied
 };
 
+/// @brief Compile-time byte size of a fixed-layout run of unsigned
+///   integral header fields (I2NP, TunnelData and SSU headers have
+///   layouts fully known at compile time)
+/// @notes Recursive overload pair: C++14 has no fold expressions
+template <typename UInt>
+constexpr std::size_t FixedLayoutSize() noexcept
+{
+  return sizeof(UInt);
+}
+
+template <typename UInt, typename Next, typename... Rest>
+constexpr std::size_t FixedLayoutSize() noexcept
+{
+  return sizeof(UInt) + FixedLayoutSize<Next, Rest...>();
+}
+
 /// @class InputByteStream
 /// @brief Wraps an array of bytes to provide stream-like functionality.
 class InputByteStream : public ByteStream
@@ -159,6 +175,35 @@ class InputByteStream : public ByteStream
   {
     return Read<UInt>(ReadBytes(sizeof(UInt)), big_to_native);
   }
+
+  /// @brief Reads a whole fixed-layout run of unsigned integral fields
+  ///   with a single up-front bounds check; the per-field loads are
+  ///   unchecked (the layout size is computed at compile time)
+  /// @param fields Fields to read, in wire order
+  /// @return false if the stream holds fewer bytes than the layout
+  template <typename UInt, typename... Rest>
+  bool ReadFixed(UInt& field, Rest&... rest)
+  {
+    constexpr std::size_t size = FixedLayoutSize<UInt, Rest...>();
+    if (m_Length < size)
+      return false;
+    const std::uint8_t* buf = m_DataPtr;
+    m_DataPtr += size;
+    m_Length -= size;
+    m_Counter += size;
+    ReadFixedFields(buf, field, rest...);
+    return true;
+  }
+
+ private:
+  static void ReadFixedFields(const std::uint8_t*) noexcept {}
+
+  template <typename UInt, typename... Rest>
+  static void ReadFixedFields(const std::uint8_t* buf, UInt& field, Rest&... rest)
+  {
+    field = Read<UInt>(buf);
+    ReadFixedFields(buf + sizeof(UInt), rest...);
+  }
 };
 
 /// @class OutputByteStream
@@ -199,6 +244,16 @@ class OutputByteStream : public ByteStream
       const std::size_t len,
       const bool allow_null_data = false);
 
+  /// @brief Writes a whole contiguous buffer (vector, array, Buffer)
+  ///   into data member buffer
+  /// @note Increments buffer pointer position after writing data
+  /// @param buf Buffer exposing data()/size()
+  template <typename Buffer>
+  void WriteData(const Buffer& buf)
+  {
+    WriteData(buf.data(), buf.size());
+  }
+
   /// @brief Writes an unsigned integral value into given buffer
   /// @note Converts data from host order to big endian (when applicable)
   /// @param buf Buffer to write to
@@ -227,6 +282,57 @@ class OutputByteStream : public ByteStream
     Write(buf, data, native_to_big);  // Write to buffer
     WriteData(buf, sizeof(buf));  // Write buffer to stream
   }
+
+  /// @brief Writes consecutive unsigned integral fields of a
+  ///   fixed-layout header into the given buffer, as big endian
+  /// @param buf Buffer to write to (caller guarantees the layout fits)
+  /// @param fields Fields to write, in wire order
+  template <typename... UInts>
+  static void WriteFixed(std::uint8_t* buf, UInts... fields)
+  {
+    WriteFixedFields(buf, fields...);
+  }
+
+  /// @brief Writes a whole fixed-layout run of unsigned integral fields
+  ///   into member 'stream' with a single up-front bounds check; the
+  ///   per-field stores are unchecked
+  /// @note Increments buffer pointer position after writing data
+  /// @param fields Fields to write, in wire order
+  template <typename UInt, typename... Rest>
+  void WriteFixed(UInt field, Rest... rest)
+  {
+    std::uint8_t* const buf = m_DataPtr;
+    Advance(FixedLayoutSize<UInt, Rest...>());  // the only bounds check
+    WriteFixedFields(buf, field, rest...);
+  }
+
+ private:
+  static void WriteFixedFields(std::uint8_t*) noexcept {}
+
+  template <typename UInt, typename... Rest>
+  static void WriteFixedFields(std::uint8_t* buf, UInt field, Rest... rest)
+  {
+    Write<UInt>(buf, field);
+    WriteFixedFields(buf + sizeof(UInt), rest...);
+  }
+};
+
+/// @class ArenaOutputByteStream
+/// @brief OutputByteStream whose buffer is borrowed from the calling
+///   thread's SerializationArena for the stream's lifetime, so scoped
+///   serialization (SSU packets, handshake scratch) does no heap
+///   allocation in steady state
+class ArenaOutputByteStream : public OutputByteStream
+{
+ public:
+  /// @brief Borrows a zero-initialized buffer of len bytes from the
+  ///   thread's arena, returned on destruction
+  explicit ArenaOutputByteStream(const std::size_t len);
+
+  ~ArenaOutputByteStream();
+
+  ArenaOutputByteStream(const ArenaOutputByteStream&) = delete;
+  ArenaOutputByteStream& operator=(const ArenaOutputByteStream&) = delete;
 };
 
 /// @brief Returns hex encoding of given data
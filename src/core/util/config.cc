@@ -130,6 +130,15 @@ void Configuration::ParseConfig()
       "log-file-name",
       bpo::value<std::string>()->default_value("")->value_name("path"))(
 
+      // Per-role thread placement: entries of the form
+      // "role:cpu[,cpu...][@nice]" joined with ';', for example
+      // "tunnel-crypto:2,3;netdb:4@10" pins the tunnel crypto workers to
+      // cores 2-3 and runs NetDb on core 4 at nice 10. Roles: tunnels,
+      // tunnel-crypto, netdb, netdb-verify, transports, client-dest,
+      // DHKeysPairSupplier
+      "thread-policy",
+      bpo::value<std::string>()->default_value(""))(
+
       "kovriconf,c",
       bpo::value<std::string>()->default_value("")->value_name("path"))(
 
@@ -152,6 +161,96 @@ void Configuration::ParseConfig()
       "bandwidth,b",
       bpo::value<std::string>()->default_value("L"))(
 
+      // Let measured sustained transport throughput steer the advertised
+      // bandwidth class between the configured "bandwidth" floor and the
+      // high class (never raised past what bandwidth-limit leaves room for)
+      "auto-bandwidth",
+      bpo::bool_switch()->default_value(false))(
+
+      // 0 keeps tunnel crypto on the dispatcher thread; N > 0 shards
+      // TunnelData/TunnelGateway crypto by tunnel ID onto N worker threads
+      "tunnel-crypto-workers",
+      bpo::value<std::uint16_t>()->default_value(0))(
+
+      // Worker threads running the transports io_service; 0 spawns one
+      // per core, sessions stay ordered through strands
+      "transport-workers",
+      bpo::value<std::uint16_t>()->default_value(1))(
+
+      // Dial up to N of our historically most-used peers (from profile
+      // data) right after startup, in parallel, so the first tunnel
+      // builds find warm sessions; 0 keeps lazy connect-on-first-message
+      "prewarm-connections",
+      bpo::value<std::uint16_t>()->default_value(0))(
+
+      // Total outbound rate in KBps shaped by the transport token-bucket
+      // scheduler; 0 disables shaping
+      "bandwidth-limit",
+      bpo::value<std::uint32_t>()->default_value(0))(
+
+      // Outbound rate ceiling in KBps for transit relay traffic; 0 uses
+      // 80% of bandwidth-limit
+      "transit-bandwidth",
+      bpo::value<std::uint32_t>()->default_value(0))(
+
+      // Streaming congestion window cap in packets (clamped to 512); raise
+      // it so a single stream can fill a long-RTT tunnel
+      "streaming-max-window",
+      bpo::value<std::uint16_t>()->default_value(256))(
+
+      // Outbound tunnel/remote lease pairs one stream stripes packets
+      // across (clamped to 3); 1 pins each stream to a single pair
+      "streaming-paths",
+      bpo::value<std::uint16_t>()->default_value(1))(
+
+      // Negotiate XOR forward-error-correction on streams: one parity
+      // packet per 8 data packets lets the receiver repair a single loss
+      // without waiting out a retransmission timeout
+      "streaming-fec",
+      bpo::bool_switch()->default_value(false))(
+
+      // RouterInfo signature checks from NetDb flood bursts run on N worker
+      // threads; 0 keeps verification inline on the NetDb thread
+      "netdb-verify-workers",
+      bpo::value<std::uint16_t>()->default_value(0))(
+
+      // Approximate byte budget in MB for the in-memory router store;
+      // crossing it evicts serialized buffers of the least recently
+      // accessed routers (their bytes stay on disk) and then drops cold
+      // entries entirely. 0 leaves retention to the age-based purges
+      "netdb-budget-mb",
+      bpo::value<std::uint16_t>()->default_value(0))(
+
+      // Garlic messages missing the session-tag cache need a full
+      // asymmetric decrypt; N > 0 moves those off the destination threads
+      // onto N shared workers, 0 keeps them inline
+      "garlic-decrypt-workers",
+      bpo::value<std::uint16_t>()->default_value(0))(
+
+      // Total memory ceiling in MB for the accounted subsystems (I2NP
+      // pools, NetDb caches, transport queues, streaming, garlic tags);
+      // crossing it sheds load (transit first, then caches). 0 disables
+      "memory-budget-mb",
+      bpo::value<std::uint32_t>()->default_value(0))(
+
+      // Carve message-pool buffers from per-NUMA-node slabs so each
+      // thread refills with node-local memory; pointless (but harmless)
+      // on single-socket machines
+      "enable-numa-pools",
+      bpo::bool_switch()->default_value(false))(
+
+      // Back those slabs with 2 MB huge pages (implies the slab pools);
+      // needs a populated hugetlb pool or transparent huge pages, falls
+      // back to base pages otherwise
+      "enable-huge-pages",
+      bpo::bool_switch()->default_value(false))(
+
+      // Capture timestamped I2NP frames crossing the transports into the
+      // given binary trace file (peer idents anonymized); replay with
+      // kovri-util trace. Empty disables capture
+      "message-trace",
+      bpo::value<std::string>()->default_value("")->value_name("path"))(
+
       "disable-ssu",
       bpo::bool_switch()->default_value(false))(
 
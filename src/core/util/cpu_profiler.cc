@@ -0,0 +1,209 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/cpu_profiler.h"
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+CpuProfiler cpu_profiler;
+
+#ifdef __linux__
+
+void CpuProfiler::HandleSignal(int) {
+  // a handler must leave errno exactly as it found it
+  const int saved_errno = errno;
+  if (cpu_profiler.m_Running.load(std::memory_order_acquire)) {
+    // two extra frames cover the signal trampoline and this handler
+    void* frames[CPU_PROFILER_MAX_FRAMES + 2];
+    int depth = ::backtrace(frames, CPU_PROFILER_MAX_FRAMES + 2);
+    const int skip = depth > 2 ? 2 : 0;
+    depth -= skip;
+    Sample sample;
+    for (int i = 0; i < depth; i++)
+      sample.frames[i] = frames[i + skip];
+    sample.depth = static_cast<std::uint8_t>(depth);
+    ::prctl(PR_GET_NAME, sample.thread_name.data(), 0, 0, 0);
+    if (!cpu_profiler.m_Samples->TryEnqueue(std::move(sample)))
+      cpu_profiler.m_Lost.fetch_add(1, std::memory_order_relaxed);
+  }
+  errno = saved_errno;
+}
+
+bool CpuProfiler::Start() {
+  if (m_Running.load(std::memory_order_acquire)) {
+    LOG(warning) << "CpuProfiler: already running";
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_AggregateMutex);
+    if (!m_Samples)
+      m_Samples = std::make_unique<
+          MpscRing<Sample, CPU_PROFILER_RING_CAPACITY>>();
+    m_FoldedCounts.clear();
+    m_Lost.store(0, std::memory_order_relaxed);
+  }
+  // glibc's backtrace() loads libgcc on first use (not signal-safe):
+  // take the hit here, before the handler ever runs
+  void* prime[2];
+  ::backtrace(prime, 2);
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = &CpuProfiler::HandleSignal;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, nullptr)) {
+    LOG(error) << "CpuProfiler: could not install SIGPROF handler";
+    return false;
+  }
+  m_Running.store(true, std::memory_order_release);
+  itimerval timer;
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = 1000000 / CPU_PROFILER_HZ;
+  timer.it_value = timer.it_interval;
+  // ITIMER_PROF counts consumed CPU time: busy threads get sampled in
+  // proportion, a mostly idle router costs next to nothing to profile
+  if (setitimer(ITIMER_PROF, &timer, nullptr)) {
+    LOG(error) << "CpuProfiler: could not arm profiling timer";
+    m_Running.store(false, std::memory_order_release);
+    return false;
+  }
+  LOG(info) << "CpuProfiler: sampling at " << CPU_PROFILER_HZ << "Hz";
+  return true;
+}
+
+bool CpuProfiler::Stop() {
+  if (!m_Running.load(std::memory_order_acquire))
+    return false;
+  itimerval disarm;
+  memset(&disarm, 0, sizeof(disarm));
+  setitimer(ITIMER_PROF, &disarm, nullptr);
+  m_Running.store(false, std::memory_order_release);
+  signal(SIGPROF, SIG_IGN);  // late deliveries after the disarm
+  Aggregate();
+  LOG(info) << "CpuProfiler: stopped";
+  return true;
+}
+
+void CpuProfiler::Aggregate() {
+  std::lock_guard<std::mutex> lock(m_AggregateMutex);
+  if (!m_Samples)
+    return;
+  Sample sample;
+  while (m_Samples->TryDequeue(sample)) {
+    std::string folded(sample.thread_name.data());
+    // fold root-first, the way flame-graph tooling expects
+    for (int i = sample.depth - 1; i >= 0; i--) {
+      folded.push_back(';');
+      folded += Symbolize(sample.frames[i]);
+    }
+    m_FoldedCounts[folded]++;
+  }
+}
+
+const std::string& CpuProfiler::Symbolize(void* address) {
+  auto it = m_SymbolCache.find(address);
+  if (it != m_SymbolCache.end())
+    return it->second;
+  std::string name;
+  Dl_info info;
+  if (dladdr(address, &info) && info.dli_sname) {
+    name = info.dli_sname;  // mangled; c++filt/flamegraph demangle later
+  } else {
+    std::ostringstream hex;
+    hex << "0x" << std::hex << reinterpret_cast<std::uintptr_t>(address);
+    name = hex.str();
+  }
+  return m_SymbolCache.insert(std::make_pair(address, std::move(name)))
+      .first->second;
+}
+
+std::string CpuProfiler::Report() {
+  Aggregate();
+  std::lock_guard<std::mutex> lock(m_AggregateMutex);
+  std::string report;
+  for (const auto& folded : m_FoldedCounts) {
+    report += folded.first;
+    report.push_back(' ');
+    report += std::to_string(folded.second);
+    report.push_back('\n');
+  }
+  const std::uint64_t lost = m_Lost.load(std::memory_order_relaxed);
+  if (lost) {
+    report += "lost;ring_full ";
+    report += std::to_string(lost);
+    report.push_back('\n');
+  }
+  return report;
+}
+
+#else  // !__linux__
+
+void CpuProfiler::HandleSignal(int) {}
+
+bool CpuProfiler::Start() {
+  LOG(warning) << "CpuProfiler: unsupported on this platform";
+  return false;
+}
+
+bool CpuProfiler::Stop() {
+  return false;
+}
+
+void CpuProfiler::Aggregate() {}
+
+const std::string& CpuProfiler::Symbolize(void*) {
+  static const std::string none;
+  return none;
+}
+
+std::string CpuProfiler::Report() {
+  return std::string();
+}
+
+#endif  // __linux__
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,124 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_CPU_PROFILER_H_
+#define SRC_CORE_UTIL_CPU_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/util/mpsc_ring.h"
+
+namespace kovri {
+namespace core {
+
+/// @brief Sampling rate; a prime keeps samples from locking step with
+///   the router's own 10/100ms periodic timers
+const int CPU_PROFILER_HZ = 97;
+
+/// @brief Deepest recorded call stack; deeper frames are truncated
+const std::size_t CPU_PROFILER_MAX_FRAMES = 32;
+
+/// @brief Pending (not yet aggregated) sample slots; at the sampling
+///   rate this absorbs well over half a minute of full-core activity
+///   between report pulls, further samples are counted as lost
+const std::size_t CPU_PROFILER_RING_CAPACITY = 4096;
+
+/// @class CpuProfiler
+/// @brief Embedded sampling CPU profiler for routers where attaching
+///   perf is not an option (containers, operator policy). A process
+///   ITIMER_PROF delivers SIGPROF to whichever thread is consuming CPU,
+///   so all registered router threads are sampled in proportion to use
+///   and idle threads cost nothing. The handler records the call stack
+///   and thread name (as set by ThreadRegistry) into a lock-free ring;
+///   reports are folded stacks, ready for flame-graph tooling
+/// @notes Linux-only; Start() reports unavailability elsewhere
+class CpuProfiler {
+ public:
+  /// @brief Starts sampling
+  /// @return false when already running or unsupported on this platform
+  bool Start();
+
+  /// @brief Disarms the timer and folds pending samples into the report
+  /// @return false when not running
+  bool Stop();
+
+  /// @return Whether the timer is currently armed
+  bool IsRunning() const {
+    return m_Running.load(std::memory_order_acquire);
+  }
+
+  /// @return Aggregated profile as folded stacks, one
+  ///   "thread;root;...;leaf count" line per distinct stack
+  /// @notes May be called while running; pulls pending samples first.
+  ///   Lost samples (ring overflow) appear as a synthetic "lost" line
+  std::string Report();
+
+ private:
+  /// @brief One captured stack, written from the signal handler
+  struct Sample {
+    std::array<void*, CPU_PROFILER_MAX_FRAMES> frames{{}};
+    std::array<char, 16> thread_name{{}};
+    std::uint8_t depth{0};
+  };
+
+  /// @brief SIGPROF handler: capture and enqueue, nothing else
+  static void HandleSignal(int signum);
+
+  /// @brief Drains the ring into the folded-stack counts (consumer side)
+  void Aggregate();
+
+  /// @return Symbol (or module+offset) naming of a return address
+  const std::string& Symbolize(void* address);
+
+  std::atomic<bool> m_Running{false};
+  /// @brief Allocated on first Start() and kept for the process lifetime
+  ///   so the handler never races a teardown
+  std::unique_ptr<MpscRing<Sample, CPU_PROFILER_RING_CAPACITY>> m_Samples;
+  std::atomic<std::uint64_t> m_Lost{0};
+
+  /// @brief Serializes Stop/Report aggregation (the ring's one consumer)
+  std::mutex m_AggregateMutex;
+  std::map<std::string, std::uint64_t> m_FoldedCounts;
+  std::map<void*, std::string> m_SymbolCache;
+};
+
+extern CpuProfiler cpu_profiler;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_CPU_PROFILER_H_
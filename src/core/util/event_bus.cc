@@ -0,0 +1,80 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/event_bus.h"
+
+#include <utility>
+
+namespace kovri {
+namespace core {
+
+EventBus event_bus;
+
+std::size_t EventBus::Subscribe(Handler handler) {
+  std::lock_guard<std::mutex> lock(m_HandlersMutex);
+  const std::size_t id = m_NextID++;
+  m_Handlers.insert(std::make_pair(id, std::move(handler)));
+  m_NumHandlers.store(m_Handlers.size(), std::memory_order_relaxed);
+  return id;
+}
+
+void EventBus::Unsubscribe(std::size_t id) {
+  std::lock_guard<std::mutex> lock(m_HandlersMutex);
+  m_Handlers.erase(id);
+  m_NumHandlers.store(m_Handlers.size(), std::memory_order_relaxed);
+}
+
+void EventBus::Emit(Event event, std::uint64_t subject) {
+  if (!m_NumHandlers.load(std::memory_order_relaxed))
+    return;  // nobody listening: the usual case, keep the hook free
+  std::lock_guard<std::mutex> lock(m_HandlersMutex);
+  for (const auto& handler : m_Handlers)
+    handler.second(event, subject);
+}
+
+const char* EventBus::GetName(Event event) {
+  switch (event) {
+    case TunnelBuilt:
+      return "TunnelBuilt";
+    case TunnelBuildFailed:
+      return "TunnelBuildFailed";
+    case TunnelExpired:
+      return "TunnelExpired";
+    case PeerConnected:
+      return "PeerConnected";
+    case PeerDisconnected:
+      return "PeerDisconnected";
+    default:
+      return "Unknown";
+  }
+}
+
+}  // namespace core
+}  // namespace kovri
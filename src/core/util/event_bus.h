@@ -0,0 +1,102 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_EVENT_BUS_H_
+#define SRC_CORE_UTIL_EVENT_BUS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace kovri {
+namespace core {
+
+/// @class EventBus
+/// @brief Router state transitions as a push stream. Subsystems emit an
+///   event where they already flip state (tunnel built/expired, transport
+///   peer up/down); monitoring endpoints subscribe instead of polling and
+///   rebuilding full reports every interval. With no subscribers an emit
+///   is a single relaxed load, so the hooks are free in normal operation
+class EventBus {
+ public:
+  /// @enum Event
+  /// @brief Emitted state transitions
+  enum Event : std::uint8_t
+  {
+    /// @brief A tunnel of ours completed building (subject: tunnel ID)
+    TunnelBuilt,
+    /// @brief A tunnel of ours failed or timed out building (subject: tunnel ID)
+    TunnelBuildFailed,
+    /// @brief A tunnel of ours reached end of life (subject: tunnel ID)
+    TunnelExpired,
+    /// @brief A transport session came up (subject: connected peer count)
+    PeerConnected,
+    /// @brief A transport session went down (subject: connected peer count)
+    PeerDisconnected,
+    NumEvents,
+  };
+
+  /// @brief Subscriber callback
+  /// @warning Runs on the emitting subsystem's thread while the bus lock
+  ///   is held: handlers must only hand the event off (e.g. post to their
+  ///   own io_service), never block or re-enter the bus
+  typedef std::function<void(Event event, std::uint64_t subject)> Handler;
+
+  /// @brief Registers a handler for all events
+  /// @return Subscription ID for Unsubscribe()
+  std::size_t Subscribe(Handler handler);
+
+  /// @brief Removes a subscription
+  /// @notes Once this returns the handler will not be called again
+  void Unsubscribe(std::size_t id);
+
+  /// @brief Delivers an event to all subscribers (safe from any thread)
+  void Emit(Event event, std::uint64_t subject);
+
+  /// @return Stable wire name of given event
+  static const char* GetName(Event event);
+
+ private:
+  /// @brief Subscriber count mirror so Emit() can bail without the lock
+  std::atomic<std::size_t> m_NumHandlers{0};
+  std::mutex m_HandlersMutex;
+  std::map<std::size_t, Handler> m_Handlers;
+  std::size_t m_NextID{1};
+};
+
+extern EventBus event_bus;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_EVENT_BUS_H_
@@ -0,0 +1,140 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "core/util/file_writer.h"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <utility>
+
+#include "core/util/filesystem.h"
+#include "core/util/log.h"
+#include "core/util/thread_registry.h"
+
+namespace kovri {
+namespace core {
+
+AsyncFileWriter file_writer;
+
+void AsyncFileWriter::Start() {
+  if (m_Thread)
+    return;
+  m_IsRunning = true;
+  m_Thread =
+    std::make_unique<std::thread>(
+        std::bind(
+          &AsyncFileWriter::Run,
+          this));
+}
+
+void AsyncFileWriter::Stop() {
+  if (!m_Thread)
+    return;
+  m_IsRunning = false;
+  m_Queue.WakeUp();
+  m_Thread->join();
+  m_Thread.reset(nullptr);
+}
+
+void AsyncFileWriter::QueueWrite(
+    std::string path,
+    std::vector<std::uint8_t> buffer,
+    bool append) {
+  auto job = std::make_shared<WriteJob>();
+  job->path = std::move(path);
+  job->buffer = std::move(buffer);
+  job->append = append;
+  if (!m_IsRunning) {
+    // no writer thread (unit tests, early shutdown): write in place
+    WriteNow(*job);
+    return;
+  }
+  m_Pending++;
+  m_Queue.Put(std::move(job));
+}
+
+void AsyncFileWriter::Flush() {
+  while (m_Pending.load())
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+bool AsyncFileWriter::WriteNow(
+    WriteJob& job) {
+  std::ios_base::openmode mode = std::ofstream::binary;
+  mode |= job.append ? std::ofstream::app : std::ofstream::trunc;
+  OutputFileStream stream(job.path, mode);
+  if (stream.Fail()
+      || !stream.Write(job.buffer.data(), job.buffer.size())) {
+    LOG(error) << "AsyncFileWriter: cannot write " << job.path;
+    return false;
+  }
+  return true;
+}
+
+void AsyncFileWriter::Run() {
+  thread_registry.Register("file-writer");
+  const std::size_t max_batch = 64;
+  // keep draining after shutdown so queued snapshots reach disk
+  while (m_IsRunning || !m_Queue.IsEmpty()) {
+    try {
+      std::vector<std::shared_ptr<WriteJob>> jobs;
+      if (!m_Queue.GetBatchWithTimeout(jobs, max_batch, 1000))  // 1 sec
+        continue;
+      for (std::size_t i = 0; i < jobs.size(); i++) {
+        // decrement up front so a failed write cannot wedge Flush
+        m_Pending--;
+        // a later truncating write of the same path in this batch
+        // supersedes this one; appends always hit disk in queue order
+        bool superseded = false;
+        if (!jobs[i]->append)
+          for (std::size_t j = i + 1; j < jobs.size() && !superseded; j++)
+            superseded = !jobs[j]->append && jobs[j]->path == jobs[i]->path;
+        if (superseded)
+          continue;
+        try {
+          WriteNow(*jobs[i]);
+        } catch (const std::exception& ex) {
+          LOG(error)
+            << "AsyncFileWriter: " << __func__
+            << " exception: " << ex.what();
+        }
+      }
+    } catch (const std::exception& ex) {
+      LOG(error)
+        << "AsyncFileWriter: " << __func__ << " exception: " << ex.what();
+    }
+  }
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,97 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_UTIL_FILE_WRITER_H_
+#define SRC_CORE_UTIL_FILE_WRITER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/util/queue.h"
+
+namespace kovri {
+namespace core {
+
+/// @class AsyncFileWriter
+/// @brief Shared write-behind service for persistence files
+/// @details Callers snapshot their serialized state into a buffer and
+///   queue it; a dedicated I/O thread batches the queued writes to disk
+///   so periodic save cycles (profile snapshots, address-book files)
+///   never block a message-processing thread on the filesystem. Writes
+///   queued before Stop are flushed during shutdown. When the service is
+///   not running the write happens synchronously on the caller's thread
+class AsyncFileWriter {
+ public:
+  void Start();
+
+  /// @brief Wakes the writer and joins it after the queue drains
+  void Stop();
+
+  /// @brief Queues buffer to be written to path
+  /// @param append Append to the file instead of truncating it
+  void QueueWrite(
+      std::string path,
+      std::vector<std::uint8_t> buffer,
+      bool append = false);
+
+  /// @brief Blocks until every queued write has been attempted
+  void Flush();
+
+ private:
+  struct WriteJob {
+    std::string path;
+    std::vector<std::uint8_t> buffer;
+    bool append;
+  };
+
+  static bool WriteNow(
+      WriteJob& job);
+
+  void Run();
+
+ private:
+  bool m_IsRunning = false;
+  std::atomic<std::size_t> m_Pending{0};
+  kovri::core::Queue<std::shared_ptr<WriteJob>> m_Queue;
+  std::unique_ptr<std::thread> m_Thread;
+};
+
+extern AsyncFileWriter file_writer;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_FILE_WRITER_H_
@@ -0,0 +1,150 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/histogram.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+namespace kovri {
+namespace core {
+
+LatencyHistograms latency_histograms;
+
+std::size_t LatencyHistogram::SlotFor(std::uint64_t value) noexcept {
+  // the first two buckets hold one value per slot
+  if (value < 2 * SubBuckets)
+    return static_cast<std::size_t>(value);
+  // shift down until the sub-bucket bits remain; the shift count picks
+  // the bucket, the remaining low bits the linear sub-bucket within it
+  std::size_t exp = 0;
+  std::uint64_t v = value;
+  while (v >= 2 * SubBuckets) {
+    v >>= 1;
+    exp++;
+  }
+  const std::size_t slot = (exp + 1) * SubBuckets + (v - SubBuckets);
+  // off-scale values saturate into the last slot
+  return slot < NumSlots ? slot : NumSlots - 1;
+}
+
+std::uint64_t LatencyHistogram::SlotUpperBound(std::size_t slot) noexcept {
+  if (slot < 2 * SubBuckets)
+    return slot;
+  const std::size_t exp = slot / SubBuckets - 1;
+  const std::uint64_t sub = SubBuckets + slot % SubBuckets;
+  return ((sub + 1) << exp) - 1;
+}
+
+void LatencyHistogram::Record(std::uint64_t value) noexcept {
+  m_Slots.at(SlotFor(value)).fetch_add(1, std::memory_order_relaxed);
+  m_Count.fetch_add(1, std::memory_order_relaxed);
+  m_Sum.fetch_add(value, std::memory_order_relaxed);
+  std::uint64_t prev = m_Max.load(std::memory_order_relaxed);
+  while (value > prev
+         && !m_Max.compare_exchange_weak(
+                prev, value, std::memory_order_relaxed)) {}
+}
+
+LatencyHistogram::Summary LatencyHistogram::GetSummary() const noexcept {
+  // one consistent-enough snapshot; percentiles come from the slots so
+  // a sample racing in mid-walk shifts the result by at most one count
+  std::array<std::uint64_t, NumSlots> slots;
+  std::uint64_t count = 0;
+  for (std::size_t i = 0; i < NumSlots; i++) {
+    slots.at(i) = m_Slots.at(i).load(std::memory_order_relaxed);
+    count += slots.at(i);
+  }
+  Summary summary;
+  summary.count = count;
+  if (!count)
+    return summary;
+  summary.mean =
+      m_Sum.load(std::memory_order_relaxed)
+      / m_Count.load(std::memory_order_relaxed);
+  summary.max = m_Max.load(std::memory_order_relaxed);
+  // ranks of the requested percentiles, then one walk fills them all
+  const std::array<std::pair<std::uint64_t, std::uint64_t*>, 4> wanted {{
+    { (count * 50 + 99) / 100, &summary.p50 },
+    { (count * 90 + 99) / 100, &summary.p90 },
+    { (count * 99 + 99) / 100, &summary.p99 },
+    { (count * 999 + 999) / 1000, &summary.p999 },
+  }};
+  std::uint64_t seen = 0;
+  std::size_t next = 0;
+  for (std::size_t i = 0; i < NumSlots && next < wanted.size(); i++) {
+    seen += slots.at(i);
+    while (next < wanted.size() && seen >= wanted.at(next).first)
+      *wanted.at(next++).second = SlotUpperBound(i);
+  }
+  // a slot's upper bound can overshoot what was actually recorded
+  summary.p50 = std::min(summary.p50, summary.max);
+  summary.p90 = std::min(summary.p90, summary.max);
+  summary.p99 = std::min(summary.p99, summary.max);
+  summary.p999 = std::min(summary.p999, summary.max);
+  return summary;
+}
+
+std::string LatencyHistograms::Report() const {
+  std::stringstream ss;
+  for (std::uint8_t histogram = 0; histogram < NumHistograms; histogram++) {
+    const auto summary = m_Histograms.at(histogram).GetSummary();
+    if (histogram)
+      ss << "; ";
+    ss << HistogramName(histogram)
+       << ": count=" << summary.count
+       << " mean=" << summary.mean
+       << " p50=" << summary.p50
+       << " p90=" << summary.p90
+       << " p99=" << summary.p99
+       << " p999=" << summary.p999
+       << " max=" << summary.max;
+  }
+  return ss.str();
+}
+
+std::string LatencyHistograms::HistogramName(std::uint8_t histogram) {
+  switch (histogram) {
+    case TunnelBuild:
+      return "tunnel_build_ms";
+    case Handshake:
+      return "handshake_ms";
+    case StreamRTT:
+      return "stream_rtt_ms";
+    case LeaseSetLookup:
+      return "leaseset_lookup_ms";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,138 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_HISTOGRAM_H_
+#define SRC_CORE_UTIL_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace kovri {
+namespace core {
+
+/// @class LatencyHistogram
+/// @brief Fixed-memory latency distribution in the HDR histogram style:
+///   values land in a power-of-two bucket subdivided into linear
+///   sub-buckets, so relative error stays bounded (at most 1/SubBuckets)
+///   across the whole range while memory stays a small constant.
+///   Recording is one relaxed atomic add, safe from any thread; averages
+///   hide bimodal tails, the percentile summary does not
+class LatencyHistogram {
+ public:
+  enum : std::size_t {
+    /// @brief Sub-buckets per power-of-two bucket; 8 bounds the relative
+    ///   error of a reported percentile at 12.5 percent
+    SubBuckets = 8,
+    /// @brief Power-of-two buckets; covers values up to ~16.7M (in
+    ///   milliseconds about 4.6 hours), far beyond any sane latency
+    Buckets = 22,
+    NumSlots = Buckets * SubBuckets,
+  };
+
+  /// @brief Percentile summary of everything recorded so far
+  struct Summary {
+    std::uint64_t count = 0;
+    std::uint64_t mean = 0;
+    std::uint64_t p50 = 0;
+    std::uint64_t p90 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t p999 = 0;
+    std::uint64_t max = 0;
+  };
+
+  /// @brief Folds one sample into the distribution (relaxed atomics,
+  ///   no locks or allocation; safe from any thread)
+  void Record(std::uint64_t value) noexcept;
+
+  /// @return Percentile summary computed from a slot snapshot; reported
+  ///   percentiles are slot upper bounds (exact below 2 * SubBuckets)
+  Summary GetSummary() const noexcept;
+
+ private:
+  /// @return Slot index for a value; values below 2 * SubBuckets map
+  ///   one-to-one, larger ones share a slot with their bucket neighbors
+  static std::size_t SlotFor(std::uint64_t value) noexcept;
+
+  /// @return Largest value a slot can hold
+  static std::uint64_t SlotUpperBound(std::size_t slot) noexcept;
+
+  std::array<std::atomic<std::uint64_t>, NumSlots> m_Slots{{}};
+  std::atomic<std::uint64_t> m_Count{0};
+  std::atomic<std::uint64_t> m_Sum{0};
+  std::atomic<std::uint64_t> m_Max{0};
+};
+
+/// @class LatencyHistograms
+/// @brief The router's always-on latency distributions, one histogram
+///   per instrumented path (all samples in milliseconds). Counterpart to
+///   Metrics for durations: counters say how often, these say how slowly
+class LatencyHistograms {
+ public:
+  /// @enum Histogram
+  enum Histogram : std::uint8_t {
+    /// @brief Our own tunnels, request sent to response accepted
+    TunnelBuild,
+    /// @brief Transport sessions, dial to established (NTCP and SSU)
+    Handshake,
+    /// @brief Streaming packet round trips, as sampled for RTO
+    StreamRTT,
+    /// @brief Remote LeaseSet lookups, request sent to store received
+    LeaseSetLookup,
+    NumHistograms,
+  };
+
+  /// @brief Folds a sample into one histogram (safe from any thread)
+  void Record(Histogram histogram, std::uint64_t value) noexcept {
+    m_Histograms.at(histogram).Record(value);
+  }
+
+  LatencyHistogram::Summary GetSummary(Histogram histogram) const noexcept {
+    return m_Histograms.at(histogram).GetSummary();
+  }
+
+  /// @return One-line percentile report over all histograms, for logs
+  ///   and monitoring endpoints
+  std::string Report() const;
+
+  static std::string HistogramName(std::uint8_t histogram);
+
+ private:
+  std::array<LatencyHistogram, NumHistograms> m_Histograms;
+};
+
+extern LatencyHistograms latency_histograms;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_HISTOGRAM_H_
@@ -130,54 +130,94 @@ logging::formatter GetFormat(bool has_color)
   return format;
 }
 
-void SetupLogging(const boost::program_options::variables_map& kovri_config)
+/// @brief Maps a config-style log level to a boost.log severity
+static logging::trivial::severity_level GetSeverity(std::uint16_t log_level)
 {
-  namespace sinks = boost::log::sinks;
-  namespace keywords = boost::log::keywords;
-  // Get global logger
-  // TODO(unassigned): depends on global logging initialization. See notes in log impl
-  auto core = logging::core::get();
-  // Add core attributes
-  core->add_global_attribute("TimeStamp", attrs::utc_clock());
-  core->add_global_attribute("ThreadID", attrs::current_thread_id());
-  // Get/Set filter log level
-  auto log_level = kovri_config["log-level"].as<std::uint16_t>();
-  logging::trivial::severity_level severity;
   switch (log_level)
     {
       case 0:
-        severity = logging::trivial::fatal;
-        break;
+        return logging::trivial::fatal;
       case 1:
-        severity = logging::trivial::error;
-        break;
+        return logging::trivial::error;
       case 2:
-        severity = logging::trivial::warning;
-        break;
+        return logging::trivial::warning;
       case 3:
-        severity = logging::trivial::info;
-        break;
+        return logging::trivial::info;
       case 4:
-        severity = logging::trivial::debug;
-        break;
+        return logging::trivial::debug;
       case 5:
-        severity = logging::trivial::trace;
-        break;
+        return logging::trivial::trace;
       default:
         throw std::invalid_argument(
             "Configuration: invalid log-level, see documentation");
-        break;
     };
+}
+
+// Console sink: bounded asynchronous frontend so callers only enqueue the
+// record; the feeding thread formats and writes. Overflowing records are
+// dropped rather than stalling relay traffic on console I/O.
+typedef boost::log::sinks::asynchronous_sink<
+    boost::log::sinks::text_ostream_backend,
+    boost::log::sinks::bounded_fifo_queue<
+        2048,
+        boost::log::sinks::drop_on_overflow>>
+    text_ostream_sink;
+
+// File sink: asynchronous with the default (unbounded) queue, as records
+// written to file should not be dropped under bursts
+typedef boost::log::sinks::asynchronous_sink<
+    boost::log::sinks::text_file_backend>
+    text_file_sink;
+
+// Kept so StopLogging can flush and stop the feeding threads at exit
+static boost::shared_ptr<text_ostream_sink> g_TextSink;
+static boost::shared_ptr<text_file_sink> g_FileSink;
+
+void SetLogLevel(std::uint16_t log_level)
+{
+  logging::core::get()->set_filter(
+      expr::attr<logging::trivial::severity_level>("Severity")
+      >= GetSeverity(log_level));
+}
+
+void StopLogging()
+{
+  auto core = logging::core::get();
+  if (g_TextSink)
+    {
+      core->remove_sink(g_TextSink);
+      g_TextSink->stop();
+      g_TextSink->flush();
+      g_TextSink.reset();
+    }
+  if (g_FileSink)
+    {
+      core->remove_sink(g_FileSink);
+      g_FileSink->stop();
+      g_FileSink->flush();
+      g_FileSink.reset();
+    }
+}
+
+void SetupLogging(const boost::program_options::variables_map& kovri_config)
+{
+  namespace sinks = boost::log::sinks;
+  namespace keywords = boost::log::keywords;
+  // Get global logger
+  // TODO(unassigned): depends on global logging initialization. See notes in log impl
+  auto core = logging::core::get();
+  // Add core attributes
+  core->add_global_attribute("TimeStamp", attrs::utc_clock());
+  core->add_global_attribute("ThreadID", attrs::current_thread_id());
+  // Get/Set filter log level
+  auto severity = GetSeverity(kovri_config["log-level"].as<std::uint16_t>());
   core->set_filter(
       expr::attr<logging::trivial::severity_level>("Severity") >= severity);
   // Create text backend + sink
-  typedef sinks::synchronous_sink<sinks::text_ostream_backend>
-      text_ostream_sink;
   auto text_sink = boost::make_shared<text_ostream_sink>();
   text_sink->locked_backend()->add_stream(
       boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
   // Create file backend
-  typedef sinks::asynchronous_sink<sinks::text_file_backend> text_file_sink;
   auto file_backend = boost::make_shared<sinks::text_file_backend>(
       keywords::file_name =
           kovri_config["log-file-name"].defaulted()
@@ -205,6 +245,9 @@ void SetupLogging(const boost::program_options::variables_map& kovri_config)
     core->remove_sink(text_sink);
   if (kovri_config["disable-file-log"].as<bool>())
     core->remove_sink(file_sink);
+  // Keep handles so StopLogging can drain the feeding threads
+  g_TextSink = text_sink;
+  g_FileSink = file_sink;
 }
 
 }  // namespace core
@@ -48,7 +48,26 @@
 // Also note that a singleton will effect having multiple logging library options (there's no need to do that though when we have huge flexibility with sinks)
 
 BOOST_LOG_GLOBAL_LOGGER(g_Logger, boost::log::sources::severity_logger_mt<boost::log::trivial::severity_level>)
-#define LOG(severity) BOOST_LOG_SEV(g_Logger::get(), boost::log::trivial::severity)
+
+// Minimum severity compiled into the binary, as a boost::log::trivial
+// enumerator value (trace = 0 ... fatal = 5). Statements below it become a
+// never-taken branch of a constant condition, so the optimizer drops the
+// record pump and the stream arguments entirely - relay builds can elide
+// trace/debug on the packet path (-DKOVRI_MIN_LOG_LEVEL, see the CMake
+// option of the same name) while info and above keep their runtime filter.
+#ifndef KOVRI_MIN_LOG_LEVEL
+#define KOVRI_MIN_LOG_LEVEL 0  // trace: everything compiled in
+#endif
+
+// The inner if always carries its else, so a surrounding unbraced
+// if/else still binds the way it reads
+#define LOG(severity)                                               \
+  if (static_cast<int>(boost::log::trivial::severity)              \
+      < KOVRI_MIN_LOG_LEVEL)                                        \
+    {                                                               \
+    }                                                               \
+  else                                                              \
+    BOOST_LOG_SEV(g_Logger::get(), boost::log::trivial::severity)
 
 namespace kovri
 {
@@ -60,6 +79,17 @@ namespace core
 void SetupLogging(
     const boost::program_options::variables_map& parsed_kovri_config);
 
+/// @brief Resets the global severity filter at runtime
+/// @param log_level Config-style level (0 = fatal only ... 5 = trace)
+/// @notes The filter runs in open_record, so rejected statements never
+///   build their message, format, or touch a sink
+void SetLogLevel(std::uint16_t log_level);
+
+/// @brief Flushes queued records and stops the sink feeding threads
+/// @warning Must run before exit so asynchronously queued records reach
+///   their streams; logging after this call is dropped
+void StopLogging();
+
 /// @brief Log source and destination of a network request or response
 /// @param boost::network::http::client:: request or response
 /// @return human readable string
@@ -0,0 +1,112 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/memory_budget.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/util/log.h"
+#include "core/util/timestamp.h"
+
+namespace kovri {
+namespace core {
+
+MemoryBudget memory_budget;
+
+namespace {
+
+/// @brief Minimum interval between shedding rounds; sheds free memory
+///   asynchronously, so firing again before the last round landed would
+///   only pile on log noise and duplicate work
+const std::uint64_t ShedCooldownMs = 10 * 1000;
+
+}  // namespace
+
+void MemoryBudget::RegisterShedder(
+    std::uint8_t priority,
+    const std::string& name,
+    std::function<void (void)> shed) {
+  std::unique_lock<std::mutex> l(m_SheddersMutex);
+  m_Shedders.push_back(Shedder{priority, name, std::move(shed)});
+  std::sort(
+      m_Shedders.begin(),
+      m_Shedders.end(),
+      [](const Shedder& a, const Shedder& b) {
+        return a.priority < b.priority;
+      });
+}
+
+void MemoryBudget::Shed(std::size_t total) {
+  std::uint64_t const now = GetMillisecondsSinceEpoch();
+  std::uint64_t until = m_ShedCooldownUntil.load(std::memory_order_relaxed);
+  // one thread wins the CAS and runs the shedders; everyone else carries on
+  do {
+    if (now < until)
+      return;
+  } while (!m_ShedCooldownUntil.compare_exchange_weak(
+      until, now + ShedCooldownMs, std::memory_order_relaxed));
+  LOG(warning) << "MemoryBudget: " << total << " bytes accounted, ceiling "
+               << GetCeiling() << "; shedding (" << Report() << ")";
+  std::unique_lock<std::mutex> l(m_SheddersMutex);
+  for (const auto& shedder : m_Shedders) {
+    LOG(warning) << "MemoryBudget: shedding via " << shedder.name;
+    shedder.shed();
+  }
+}
+
+std::string MemoryBudget::Report() const {
+  std::stringstream ss;
+  ss << "total=" << GetTotal() << "/" << GetCeiling();
+  for (std::uint8_t sub = 0; sub < NumSubsystems; sub++)
+    ss << ", " << SubsystemName(sub) << "="
+       << m_Bytes.at(sub).load(std::memory_order_relaxed);
+  return ss.str();
+}
+
+std::string MemoryBudget::SubsystemName(std::uint8_t subsystem) {
+  switch (subsystem) {
+    case I2NPPool:
+      return "i2np";
+    case NetDbCache:
+      return "netdb";
+    case TransportQueues:
+      return "transport";
+    case Streaming:
+      return "streaming";
+    case GarlicTags:
+      return "garlic";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace core
+}  // namespace kovri
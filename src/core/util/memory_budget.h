@@ -0,0 +1,168 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_MEMORY_BUDGET_H_
+#define SRC_CORE_UTIL_MEMORY_BUDGET_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @class MemoryBudget
+/// @brief Per-subsystem byte accounting with a configurable total ceiling
+///   and prioritized load-shedding hooks. Hot paths bump relaxed atomics
+///   (same cost model as Metrics); crossing the ceiling triggers the
+///   registered shedders in priority order, rate limited, so a router on a
+///   small box degrades (transit first, caches second) instead of growing
+///   until the OOM killer picks it
+/// @note Figures are estimates: buffers are counted at their nominal
+///   sizes, container node overhead is approximated, and subsystems may
+///   overlap (a message parked in a transport queue also shows under its
+///   pool), which is enough to steer shedding and answer "where does
+///   memory go"
+class MemoryBudget {
+ public:
+  /// @enum Subsystem
+  /// @brief Accounted memory consumers
+  enum Subsystem : std::uint8_t
+  {
+    /// @brief I2NP message blocks (live and pooled per-thread caches)
+    I2NPPool,
+    /// @brief NetDb reply caches (compressed stores, floodfill picks)
+    NetDbCache,
+    /// @brief Per-peer transport queues awaiting a session
+    TransportQueues,
+    /// @brief Streaming packets (live and pooled)
+    Streaming,
+    /// @brief Incoming garlic session tags
+    GarlicTags,
+    NumSubsystems,
+  };
+
+  /// @brief Accounts bytes to a subsystem; sheds when the total crosses
+  ///   the ceiling (relaxed; safe from any thread)
+  void Add(Subsystem subsystem, std::size_t bytes) noexcept {
+    m_Bytes.at(subsystem).fetch_add(bytes, std::memory_order_relaxed);
+    AddTotal(bytes);
+  }
+
+  /// @brief Replaces a subsystem's figure with a freshly sampled one, for
+  ///   consumers that sweep their containers periodically instead of
+  ///   tracking every mutation
+  void Set(Subsystem subsystem, std::size_t bytes) noexcept {
+    std::size_t const prev =
+        m_Bytes.at(subsystem).exchange(bytes, std::memory_order_relaxed);
+    if (bytes >= prev)
+      AddTotal(bytes - prev);
+    else
+      m_Total.fetch_sub(prev - bytes, std::memory_order_relaxed);
+  }
+
+  /// @brief Releases bytes from a subsystem (relaxed; safe from any thread)
+  void Sub(Subsystem subsystem, std::size_t bytes) noexcept {
+    m_Bytes.at(subsystem).fetch_sub(bytes, std::memory_order_relaxed);
+    m_Total.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  /// @return Accounted bytes of one subsystem
+  std::size_t Get(Subsystem subsystem) const noexcept {
+    return m_Bytes.at(subsystem).load(std::memory_order_relaxed);
+  }
+
+  /// @return Accounted bytes across all subsystems
+  std::size_t GetTotal() const noexcept {
+    return m_Total.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Sets the total ceiling in bytes; 0 disables shedding
+  void SetCeiling(std::size_t bytes) noexcept {
+    m_Ceiling.store(bytes, std::memory_order_relaxed);
+  }
+
+  std::size_t GetCeiling() const noexcept {
+    return m_Ceiling.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Registers a shedding hook; lower priority runs first
+  /// @param name For the shed log line
+  /// @param shed Must be safe to call from any accounting thread and must
+  ///   not block on the caller's locks; prefer posting real work elsewhere
+  void RegisterShedder(
+      std::uint8_t priority,
+      const std::string& name,
+      std::function<void (void)> shed);
+
+  /// @return One line of per-subsystem figures for logs and I2PControl
+  std::string Report() const;
+
+ private:
+  /// @brief Grows the total and sheds when it crosses the ceiling
+  void AddTotal(std::size_t bytes) noexcept {
+    std::size_t const total =
+        m_Total.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t const ceiling = m_Ceiling.load(std::memory_order_relaxed);
+    if (ceiling && total > ceiling)
+      Shed(total);
+  }
+
+  /// @brief Runs the shedders in priority order, at most once per
+  ///   cooldown interval across all threads
+  void Shed(std::size_t total);
+
+  static std::string SubsystemName(std::uint8_t subsystem);
+
+  struct Shedder {
+    std::uint8_t priority;
+    std::string name;
+    std::function<void (void)> shed;
+  };
+
+  std::array<std::atomic<std::size_t>, NumSubsystems> m_Bytes{{}};
+  std::atomic<std::size_t> m_Total{0};
+  std::atomic<std::size_t> m_Ceiling{0};
+  /// @brief Milliseconds timestamp before which shedding stays quiet
+  std::atomic<std::uint64_t> m_ShedCooldownUntil{0};
+  std::mutex m_SheddersMutex;
+  std::vector<Shedder> m_Shedders;
+};
+
+extern MemoryBudget memory_budget;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_MEMORY_BUDGET_H_
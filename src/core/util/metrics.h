@@ -0,0 +1,126 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_METRICS_H_
+#define SRC_CORE_UTIL_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace kovri {
+namespace core {
+
+/// @class Metrics
+/// @brief Always-on router counters for monitoring endpoints. Hot paths
+///   bump relaxed atomics (one uncontended add, no locks); consumers read
+///   a plain snapshot instead of walking live structures and their mutexes.
+///   Counters are monotonic since startup, gauges are last-written samples
+class Metrics {
+ public:
+  /// @enum Counter
+  /// @brief Monotonic event/byte counters
+  enum Counter : std::uint8_t
+  {
+    /// @brief Payload bytes received across all transports
+    TransportInBytes,
+    /// @brief Payload bytes sent across all transports
+    TransportOutBytes,
+    /// @brief Complete I2NP messages received over NTCP
+    NTCPInMsgs,
+    /// @brief I2NP messages sent over NTCP
+    NTCPOutMsgs,
+    /// @brief Complete I2NP messages received over SSU
+    SSUInMsgs,
+    /// @brief I2NP messages sent over SSU
+    SSUOutMsgs,
+    /// @brief Tunnels of ours that completed building
+    TunnelBuildsSucceeded,
+    /// @brief Tunnels of ours that failed or timed out building
+    TunnelBuildsFailed,
+    /// @brief Messages shed from full per-peer transport send queues
+    TransportQueueDrops,
+    /// @brief Messages dropped at ingestion or enqueue for being expired
+    ///   (or, under overload, about to expire) before any crypto was paid
+    ExpiredMsgDrops,
+    NumCounters,
+  };
+
+  /// @enum Gauge
+  /// @brief Point-in-time samples, refreshed by their owning threads
+  enum Gauge : std::uint8_t
+  {
+    /// @brief Depth of the tunnel message queue
+    TunnelQueueDepth,
+    /// @brief Current number of transit tunnels
+    TransitTunnels,
+    /// @brief Currently connected transport peers
+    ActivePeers,
+    /// @brief Bytes parked in the control bandwidth class
+    ShapedControlQueue,
+    /// @brief Bytes parked in the client bandwidth class
+    ShapedClientQueue,
+    /// @brief Bytes parked in the transit bandwidth class
+    ShapedTransitQueue,
+    /// @brief Messages parked across all peers awaiting a session
+    DelayedQueueDepth,
+    NumGauges,
+  };
+
+  /// @brief Plain copy of all metrics, safe to use without synchronization
+  struct Snapshot {
+    std::array<std::uint64_t, NumCounters> counters;
+    std::array<std::uint64_t, NumGauges> gauges;
+  };
+
+  /// @brief Bumps a counter (relaxed; safe from any thread)
+  void Inc(Counter counter, std::uint64_t count = 1) noexcept {
+    m_Counters.at(counter).fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /// @brief Publishes a gauge sample (relaxed; safe from any thread)
+  void Set(Gauge gauge, std::uint64_t value) noexcept {
+    m_Gauges.at(gauge).store(value, std::memory_order_relaxed);
+  }
+
+  /// @return Snapshot of all counters and gauges
+  Snapshot Get() const noexcept;
+
+ private:
+  std::array<std::atomic<std::uint64_t>, NumCounters> m_Counters{{}};
+  std::array<std::atomic<std::uint64_t>, NumGauges> m_Gauges{{}};
+};
+
+extern Metrics metrics;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_METRICS_H_
@@ -0,0 +1,134 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_UTIL_MPSC_RING_H_
+#define SRC_CORE_UTIL_MPSC_RING_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace kovri {
+namespace core {
+
+/// @brief Bounded lock-free ring: any number of producers, one consumer
+///   at a time. Each slot carries a sequence number (Vyukov scheme), so
+///   producers claim slots with a single CAS and the consumer advances
+///   without any atomic read-modify-write
+/// @notes The single-consumer side is a protocol obligation, not
+///   enforced: callers serialize draining themselves (see the flusher
+///   flag in OutboundTunnel)
+template <typename Element, std::size_t Capacity>
+class MpscRing {
+  static_assert(
+      Capacity && !(Capacity & (Capacity - 1)),
+      "MpscRing: capacity must be a power of two");
+
+ public:
+  MpscRing() {
+    for (std::size_t i = 0; i < Capacity; i++)
+      m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  /// @brief Claims a slot and publishes the element
+  /// @return false when the ring is full (consumer has fallen behind)
+  bool TryEnqueue(Element&& element) {
+    std::size_t pos = m_Head.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = m_Slots[pos & (Capacity - 1)];
+      const std::size_t sequence =
+          slot.sequence.load(std::memory_order_acquire);
+      const std::intptr_t diff = static_cast<std::intptr_t>(sequence)
+          - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (m_Head.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed))
+          break;  // slot claimed; pos was reloaded on failure
+      } else if (diff < 0) {
+        return false;  // full: the slot still holds an unread element
+      } else {
+        pos = m_Head.load(std::memory_order_relaxed);
+      }
+    }
+    Slot& slot = m_Slots[pos & (Capacity - 1)];
+    slot.element = std::move(element);
+    slot.sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Takes the oldest published element (consumer side only)
+  /// @return false when nothing is published; an element mid-publish
+  ///   counts as nothing yet
+  bool TryDequeue(Element& element) {
+    const std::size_t pos = m_Tail.load(std::memory_order_relaxed);
+    Slot& slot = m_Slots[pos & (Capacity - 1)];
+    const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const std::intptr_t diff = static_cast<std::intptr_t>(sequence)
+        - static_cast<std::intptr_t>(pos + 1);
+    if (diff < 0)
+      return false;
+    element = std::move(slot.element);
+    slot.element = Element();  // drop what the move left behind
+    slot.sequence.store(pos + Capacity, std::memory_order_release);
+    m_Tail.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// @brief Whether any slot is claimed; a claim precedes its publish,
+  ///   so emptiness here is safe for "anything left to drain?" re-checks
+  bool Empty() const {
+    return m_Head.load(std::memory_order_acquire)
+           == m_Tail.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Slot {
+    std::atomic<std::size_t> sequence;
+    Element element;
+  };
+
+  std::array<Slot, Capacity> m_Slots;
+  /// @brief Next slot producers will claim
+  std::atomic<std::size_t> m_Head{0};
+  /// @brief Next slot the consumer will read
+  std::atomic<std::size_t> m_Tail{0};
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_MPSC_RING_H_
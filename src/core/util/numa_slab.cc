@@ -0,0 +1,214 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/numa_slab.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+NumaSlabPool numa_slabs;
+
+void NumaSlabPool::Configure(
+    bool numa_pools,
+    bool huge_pages)
+{
+#ifdef __linux__
+  m_Enabled = numa_pools || huge_pages;
+  m_HugePages = huge_pages;
+  if (!m_Enabled)
+    return;
+  // Map every CPU to its node from sysfs; each nodeN/cpulist is a list
+  // of ranges like "0-15,32-47"
+  std::size_t nodes = 0;
+  for (std::size_t node = 0; node < 64; node++) {
+    std::ostringstream path;
+    path << "/sys/devices/system/node/node" << node << "/cpulist";
+    std::ifstream cpulist(path.str());
+    if (!cpulist)
+      break;
+    nodes = node + 1;
+    std::string range;
+    while (std::getline(cpulist, range, ',')) {
+      std::size_t first, last;
+      const auto dash = range.find('-');
+      first = std::stoul(range);
+      last = (dash == std::string::npos)
+                 ? first
+                 : std::stoul(range.substr(dash + 1));
+      if (last >= m_CpuToNode.size())
+        m_CpuToNode.resize(last + 1, 0);
+      for (std::size_t cpu = first; cpu <= last; cpu++)
+        m_CpuToNode[cpu] = node;
+    }
+  }
+  if (!nodes)
+    nodes = 1;  // no sysfs topology: treat the machine as one node
+  m_FreeLists.resize(nodes);
+  LOG(info) << "NumaSlabPool: slab-backed message pools enabled, "
+            << nodes << " node(s)"
+            << (m_HugePages ? ", preferring huge pages" : "");
+#else
+  if (numa_pools || huge_pages)
+    LOG(warning)
+        << "NumaSlabPool: slab-backed pools unsupported on this platform";
+#endif
+}
+
+void* NumaSlabPool::Allocate(
+    std::size_t size)
+{
+#ifdef __linux__
+  if (m_Enabled) {
+    // Round the carve size so payloads stay 16-byte aligned and a few
+    // size classes cover all callers instead of one class per request
+    const std::size_t block_size =
+        (size + NUMA_SLAB_HEADER_SIZE + 63) & ~static_cast<std::size_t>(63);
+    const std::size_t node = CurrentNode();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto& list = m_FreeLists[node][block_size];
+    if (list.empty())
+      Refill(node, block_size);
+    if (!list.empty()) {
+      void* base = list.back();
+      list.pop_back();
+      // First touch: writing the header here faults the page in on the
+      // acquiring thread, so the kernel places it on this thread's node
+      auto* header = static_cast<BlockHeader*>(base);
+      header->magic = SlabMagic;
+      header->node = static_cast<std::uint16_t>(node);
+      header->reserved = 0;
+      header->block_size = block_size;
+      return static_cast<std::uint8_t*>(base) + NUMA_SLAB_HEADER_SIZE;
+    }
+    // mmap refused (hugetlb pool empty, overcommit): heap fallback below
+  }
+#endif
+  void* base = ::operator new(size + NUMA_SLAB_HEADER_SIZE);
+  auto* header = static_cast<BlockHeader*>(base);
+  header->magic = HeapMagic;
+  header->node = 0;
+  header->reserved = 0;
+  header->block_size = 0;
+  return static_cast<std::uint8_t*>(base) + NUMA_SLAB_HEADER_SIZE;
+}
+
+void NumaSlabPool::Free(
+    void* block)
+{
+  auto* base = static_cast<std::uint8_t*>(block) - NUMA_SLAB_HEADER_SIZE;
+  auto* header = reinterpret_cast<BlockHeader*>(base);
+  if (header->magic == SlabMagic) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_FreeLists[header->node][header->block_size].push_back(base);
+    return;
+  }
+  ::operator delete(base);
+}
+
+std::size_t NumaSlabPool::CurrentNode() const
+{
+#ifdef __linux__
+  const int cpu = sched_getcpu();
+  if (cpu >= 0 && static_cast<std::size_t>(cpu) < m_CpuToNode.size())
+    return m_CpuToNode[cpu];
+#endif
+  return 0;
+}
+
+bool NumaSlabPool::Refill(
+    std::size_t node,
+    std::size_t block_size)
+{
+#ifdef __linux__
+  void* slab = MAP_FAILED;
+  bool huge = false;
+#ifdef MAP_HUGETLB
+  if (m_HugePages) {
+    slab = ::mmap(
+        nullptr,
+        NUMA_SLAB_SIZE,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0);
+    huge = (slab != MAP_FAILED);
+  }
+#endif
+  if (slab == MAP_FAILED) {
+    slab = ::mmap(
+        nullptr,
+        NUMA_SLAB_SIZE,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (slab == MAP_FAILED) {
+      LOG(warning) << "NumaSlabPool: slab mmap failed, using the heap";
+      return false;
+    }
+#ifdef MADV_HUGEPAGE
+    if (m_HugePages)  // second best: let khugepaged collapse the slab
+      ::madvise(slab, NUMA_SLAB_SIZE, MADV_HUGEPAGE);
+#endif
+  }
+  m_SlabCount++;
+  if (huge)
+    m_HugeBacked++;
+  auto& list = m_FreeLists[node][block_size];
+  auto* cursor = static_cast<std::uint8_t*>(slab);
+  for (std::size_t offset = 0; offset + block_size <= NUMA_SLAB_SIZE;
+       offset += block_size)
+    list.push_back(cursor + offset);
+  LOG(debug) << "NumaSlabPool: slab " << m_SlabCount << " ("
+             << (huge ? "huge" : "base") << " pages) carved into "
+             << list.size() << " blocks of " << block_size
+             << " bytes for node " << node;
+  return true;
+#else
+  (void)node;
+  (void)block_size;
+  return false;
+#endif
+}
+
+}  // namespace core
+}  // namespace kovri
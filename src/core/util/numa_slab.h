@@ -0,0 +1,158 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_NUMA_SLAB_H_
+#define SRC_CORE_UTIL_NUMA_SLAB_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @brief Bytes mapped per slab refill; matches the x86-64 huge page size
+///   so one slab is one TLB entry when huge-page backing is on
+const std::size_t NUMA_SLAB_SIZE = 2 * 1024 * 1024;
+
+/// @brief Bytes prepended to every handed-out block (slab- and
+///   heap-backed alike) recording where it must be returned
+const std::size_t NUMA_SLAB_HEADER_SIZE = 16;
+
+/// @class NumaSlabPool
+/// @brief Optional mmap-backed block source for the message pools.
+///   Blocks are carved from per-NUMA-node slabs and handed to whichever
+///   thread asks from that node, so the thread-local I2NP caches fill
+///   with node-local memory (first touch happens on the acquiring
+///   thread) instead of wherever the heap last grew. Slabs can further
+///   be backed by 2 MB huge pages, collapsing thousands of 1 KB-32 KB
+///   message buffers onto a handful of TLB entries
+/// @details Disabled (the default) it degrades to plain operator new, so
+///   the pools route through it unconditionally. Every block carries a
+///   small header naming its origin; Free() dispatches on it, which keeps
+///   blocks allocated before configuration (or on non-Linux builds)
+///   correct. Slabs are never unmapped: the pools above cap how many
+///   blocks stay cached, so slab footprint is bounded by the same caps
+/// @notes The refill path takes one mutex; the thread-local caches in
+///   I2NPMessagePool absorb the hot path, so contention here is rare
+class NumaSlabPool {
+ public:
+  /// @brief Chooses the backing mode; call once at startup before the
+  ///   transports start allocating (earlier allocations stay heap-backed
+  ///   and are freed correctly via their headers)
+  /// @param numa_pools Carve blocks from per-node slabs
+  /// @param huge_pages Back the slabs with 2 MB huge pages (implies
+  ///   slab carving); falls back to transparent huge pages, then to
+  ///   ordinary pages, when the hugetlb pool is empty
+  void Configure(
+      bool numa_pools,
+      bool huge_pages);
+
+  /// @brief Returns a block of at least size bytes, slab-backed when
+  ///   enabled, 16-byte aligned either way
+  void* Allocate(
+      std::size_t size);
+
+  /// @brief Returns a block to the free list of the node it was carved
+  ///   from (any thread), or to the heap for heap-backed blocks
+  void Free(
+      void* block);
+
+  /// @brief Is slab carving active?
+  bool IsEnabled() const
+  {
+    return m_Enabled;
+  }
+
+ private:
+  /// @brief Per-block bookkeeping living in the 16 bytes before the
+  ///   pointer handed out; pointer-free so slabs need no destruction
+  struct BlockHeader {
+    std::uint32_t magic;       ///< SlabMagic or HeapMagic
+    std::uint16_t node;        ///< Origin NUMA node (slab blocks)
+    std::uint16_t reserved;
+    std::uint64_t block_size;  ///< Rounded carve size (slab blocks)
+  };
+
+  enum : std::uint32_t {
+    SlabMagic = 0x4b534c42,  // "KSLB"
+    HeapMagic = 0x4b484541,  // "KHEA"
+  };
+
+  /// @brief NUMA node the calling thread currently runs on (0 when the
+  ///   topology is unknown or single-node)
+  std::size_t CurrentNode() const;
+
+  /// @brief Maps a fresh slab for node and carves it into block_size
+  ///   pieces on the node's free list; the caller holds m_Mutex
+  /// @return false when mmap failed and the caller must fall back
+  bool Refill(
+      std::size_t node,
+      std::size_t block_size);
+
+ private:
+  /// @var m_Enabled
+  /// @brief Whether Allocate() carves from slabs (set by Configure)
+  bool m_Enabled = false;
+
+  /// @var m_HugePages
+  /// @brief Whether slabs prefer MAP_HUGETLB backing
+  bool m_HugePages = false;
+
+  /// @var m_CpuToNode
+  /// @brief NUMA node per CPU, read from sysfs at Configure time;
+  ///   empty means everything is node 0
+  std::vector<std::uint16_t> m_CpuToNode;
+
+  /// @var m_Mutex
+  /// @brief Guards the free lists and slab refills
+  std::mutex m_Mutex;
+
+  /// @var m_FreeLists
+  /// @brief Per-node free blocks keyed by rounded carve size
+  std::vector<std::map<std::size_t, std::vector<void*>>> m_FreeLists;
+
+  /// @var m_SlabCount
+  /// @brief Slabs mapped so far, for the occasional log line
+  std::size_t m_SlabCount = 0;
+
+  /// @var m_HugeBacked
+  /// @brief Of those, how many got genuine hugetlb backing
+  std::size_t m_HugeBacked = 0;
+};
+
+extern NumaSlabPool numa_slabs;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_NUMA_SLAB_H_
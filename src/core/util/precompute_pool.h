@@ -0,0 +1,158 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_UTIL_PRECOMPUTE_POOL_H_
+#define SRC_CORE_UTIL_PRECOMPUTE_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "core/util/log.h"
+#include "core/util/thread_registry.h"
+
+namespace kovri {
+namespace core {
+
+/// @class PrecomputePool
+/// @brief Pre-generates expensive resources (key pairs, ephemeral exponents,
+///   tag blocks) on a background thread so hot paths never block on them.
+///   Generalizes what DHKeysPairSupplier did for transports: the pool refills
+///   to its high watermark whenever consumption drains it below the low one.
+template<typename Resource>
+class PrecomputePool {
+ public:
+  typedef std::function<std::unique_ptr<Resource>()> Generator;
+
+  PrecomputePool(
+      const std::string& name,
+      Generator generator,
+      std::size_t low_watermark,
+      std::size_t high_watermark)
+      : m_Name(name),
+        m_Generator(generator),
+        m_LowWatermark(low_watermark),
+        m_HighWatermark(high_watermark),
+        m_IsRunning(false),
+        m_Thread(nullptr) {}
+
+  ~PrecomputePool() {
+    Stop();
+  }
+
+  void Start() {
+    LOG(debug) << "PrecomputePool: " << m_Name << ": starting";
+    m_IsRunning = true;
+    m_Thread =
+      std::make_unique<std::thread>(
+          std::bind(
+              &PrecomputePool<Resource>::Run,
+              this));
+  }
+
+  void Stop() {
+    m_IsRunning = false;
+    m_Acquired.notify_one();
+    if (m_Thread) {
+      m_Thread->join();
+      m_Thread.reset(nullptr);
+    }
+  }
+
+  /// @brief Pops a pre-generated resource, generating inline when drained
+  std::unique_ptr<Resource> Acquire() {
+    {
+      std::unique_lock<std::mutex> l(m_AcquiredMutex);
+      if (!m_Queue.empty()) {
+        auto resource = std::move(m_Queue.front());
+        m_Queue.pop();
+        m_Acquired.notify_one();
+        return resource;
+      }
+    }
+    LOG(debug) << "PrecomputePool: " << m_Name << ": drained, creating inline";
+    return m_Generator();
+  }
+
+  /// @brief Returns an unused resource to the pool
+  void Return(
+      std::unique_ptr<Resource> resource) {
+    std::unique_lock<std::mutex> l(m_AcquiredMutex);
+    m_Queue.push(std::move(resource));
+  }
+
+  std::size_t GetSize() const {
+    std::unique_lock<std::mutex> l(m_AcquiredMutex);
+    return m_Queue.size();
+  }
+
+ private:
+  void Run() {
+    thread_registry.Register(m_Name);
+    LOG(debug) << "PrecomputePool: " << m_Name << ": running";
+    while (m_IsRunning) {
+      if (GetSize() < m_LowWatermark)
+        Refill();
+      std::unique_lock<std::mutex> l(m_AcquiredMutex);
+      m_Acquired.wait(l);  // wait for element gets acquired
+    }
+  }
+
+  void Refill() {
+    while (m_IsRunning && GetSize() < m_HighWatermark) {
+      auto resource = m_Generator();
+      std::unique_lock<std::mutex> l(m_AcquiredMutex);
+      m_Queue.push(std::move(resource));
+    }
+  }
+
+ private:
+  const std::string m_Name;
+  Generator m_Generator;
+  const std::size_t m_LowWatermark, m_HighWatermark;
+  volatile bool m_IsRunning;
+  std::queue<std::unique_ptr<Resource>> m_Queue;
+  std::unique_ptr<std::thread> m_Thread;
+  std::condition_variable m_Acquired;
+  mutable std::mutex m_AcquiredMutex;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_PRECOMPUTE_POOL_H_
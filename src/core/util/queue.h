@@ -33,13 +33,19 @@
 #ifndef SRC_CORE_UTIL_QUEUE_H_
 #define SRC_CORE_UTIL_QUEUE_H_
 
+#include <atomic>
+#include <array>
 #include <condition_variable>
+#include <cstddef>
 #include <functional>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "core/util/trace.h"
+
 namespace kovri {
 namespace core {
 
@@ -49,15 +55,17 @@ class Queue {
   void Put(
       Element e) {
     std::unique_lock<std::mutex> l(m_QueueMutex);
-    m_Queue.push(e);
+    m_Queue.push(std::move(e));
+    KOVRI_PROBE2(queue_put, this, m_Queue.size());
     m_NonEmpty.notify_one();
   }
   void Put(
       const std::vector<Element>& vec) {
     if (!vec.empty()) {
       std::unique_lock<std::mutex> l(m_QueueMutex);
-      for (auto it : vec)
+      for (const auto& it : vec)
         m_Queue.push(it);
+      KOVRI_PROBE2(queue_put, this, m_Queue.size());
       m_NonEmpty.notify_one();
     }
   }
@@ -83,6 +91,27 @@ class Queue {
     return el;
   }
 
+  /// @brief Drains up to max elements into batch with a single lock round-trip
+  /// @return Number of elements appended to batch
+  std::size_t GetBatch(
+      std::vector<Element>& batch,
+      std::size_t max) {
+    std::unique_lock<std::mutex> l(m_QueueMutex);
+    return GetBatchNonThreadSafe(batch, max);
+  }
+
+  /// @brief Like GetBatch but waits up to the given timeout when empty
+  /// @return Number of elements appended to batch
+  std::size_t GetBatchWithTimeout(
+      std::vector<Element>& batch,
+      std::size_t max,
+      int usec) {
+    std::unique_lock<std::mutex> l(m_QueueMutex);
+    if (m_Queue.empty())
+      m_NonEmpty.wait_for(l, std::chrono::milliseconds(usec));
+    return GetBatchNonThreadSafe(batch, max);
+  }
+
   void Wait() {
     std::unique_lock<std::mutex> l(m_QueueMutex);
     m_NonEmpty.wait(l);
@@ -127,19 +156,151 @@ class Queue {
       bool peek = false) {
     if (!m_Queue.empty()) {
       auto el = m_Queue.front();
-      if (!peek)
+      if (!peek) {
         m_Queue.pop();
+        KOVRI_PROBE2(queue_get, this, 1);
+      }
       return el;
     }
     return nullptr;
   }
 
+  std::size_t GetBatchNonThreadSafe(
+      std::vector<Element>& batch,
+      std::size_t max) {
+    std::size_t count = 0;
+    while (count < max && !m_Queue.empty()) {
+      batch.push_back(m_Queue.front());
+      m_Queue.pop();
+      count++;
+    }
+    if (count)
+      KOVRI_PROBE2(queue_get, this, count);
+    return count;
+  }
+
  private:
   std::queue<Element> m_Queue;
   mutable std::mutex m_QueueMutex;
   std::condition_variable m_NonEmpty;
 };
 
+/// @brief Sharded MPMC queue: producers are spread round-robin across
+///   independently locked shards so they no longer serialize on a single
+///   mutex under load. Consumers drain whole shards per wakeup with GetBatch.
+/// @notes Ordering is FIFO per shard only; consumers needing per-key ordering
+///   (e.g. per-tunnel) should shard by key via PutKeyed and dedicate a
+///   consumer per shard
+template<typename Element, std::size_t NumShards = 4>
+class ShardedQueue {
+ public:
+  void Put(
+      Element e) {
+    Shard& shard =
+      m_Shards[m_NextShard.fetch_add(1, std::memory_order_relaxed) % NumShards];
+    {
+      std::unique_lock<std::mutex> l(shard.m_Mutex);
+      shard.m_Queue.push(std::move(e));
+    }
+    m_NonEmpty.notify_one();
+  }
+
+  /// @brief Enqueues to the shard owning the given key,
+  ///   preserving FIFO order among elements sharing that key
+  void PutKeyed(
+      std::size_t key,
+      Element e) {
+    Shard& shard = m_Shards[key % NumShards];
+    {
+      std::unique_lock<std::mutex> l(shard.m_Mutex);
+      shard.m_Queue.push(std::move(e));
+    }
+    m_NonEmpty.notify_all();
+  }
+
+  /// @brief Drains up to max elements across all shards
+  /// @return Number of elements appended to batch
+  std::size_t GetBatch(
+      std::vector<Element>& batch,
+      std::size_t max) {
+    std::size_t count = 0;
+    for (std::size_t s = 0; s < NumShards && count < max; s++)
+      count += DrainShard(m_Shards[s], batch, max - count);
+    return count;
+  }
+
+  /// @brief Drains up to max elements from a single shard
+  ///   (for one dedicated consumer per shard)
+  std::size_t GetShardBatch(
+      std::size_t shard,
+      std::vector<Element>& batch,
+      std::size_t max) {
+    return DrainShard(m_Shards[shard % NumShards], batch, max);
+  }
+
+  /// @brief Like GetBatch but waits up to the given timeout when empty
+  std::size_t GetBatchWithTimeout(
+      std::vector<Element>& batch,
+      std::size_t max,
+      int usec) {
+    auto count = GetBatch(batch, max);
+    if (!count) {
+      std::unique_lock<std::mutex> l(m_WaitMutex);
+      m_NonEmpty.wait_for(l, std::chrono::milliseconds(usec));
+      count = GetBatch(batch, max);
+    }
+    return count;
+  }
+
+  bool IsEmpty() const {
+    for (const auto& shard : m_Shards) {
+      std::unique_lock<std::mutex> l(shard.m_Mutex);
+      if (!shard.m_Queue.empty())
+        return false;
+    }
+    return true;
+  }
+
+  std::size_t GetSize() const {
+    std::size_t size = 0;
+    for (const auto& shard : m_Shards) {
+      std::unique_lock<std::mutex> l(shard.m_Mutex);
+      size += shard.m_Queue.size();
+    }
+    return size;
+  }
+
+  void WakeUp() {
+    m_NonEmpty.notify_all();
+  }
+
+ private:
+  struct Shard {
+    std::queue<Element> m_Queue;
+    mutable std::mutex m_Mutex;
+  };
+
+  std::size_t DrainShard(
+      Shard& shard,
+      std::vector<Element>& batch,
+      std::size_t max) {
+    std::size_t count = 0;
+    std::unique_lock<std::mutex> l(shard.m_Mutex);
+    while (count < max && !shard.m_Queue.empty()) {
+      batch.push_back(std::move(shard.m_Queue.front()));
+      shard.m_Queue.pop();
+      count++;
+    }
+    return count;
+  }
+
+ private:
+  std::array<Shard, NumShards> m_Shards;
+  std::atomic<std::size_t> m_NextShard{0};
+  mutable std::mutex m_WaitMutex;
+  std::condition_variable m_NonEmpty;
+};
+
 template<class Msg>
 class MsgQueue : public Queue<Msg *> {
  public:
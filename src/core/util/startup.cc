@@ -0,0 +1,126 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/startup.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+void StartupExecutor::AddStage(
+    const std::string& name,
+    std::function<void()> stage,
+    const std::vector<std::string>& dependencies) {
+  Stage entry;
+  entry.name = name;
+  entry.run = std::move(stage);
+  for (const std::string& dependency : dependencies) {
+    std::size_t index = 0;
+    for (; index < m_Stages.size(); index++)
+      if (m_Stages[index].name == dependency)
+        break;
+    if (index == m_Stages.size())
+      throw std::logic_error(
+          "StartupExecutor: stage '" + name + "' depends on unknown stage '"
+          + dependency + "'");
+    entry.dependencies.push_back(index);
+  }
+  m_Stages.push_back(std::move(entry));
+}
+
+void StartupExecutor::Run() {
+  const std::size_t count = m_Stages.size();
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<bool> done(count, false);
+  std::exception_ptr failure;
+  std::vector<std::thread> threads;
+  threads.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    threads.emplace_back([this, i, &mutex, &cv, &done, &failure] {
+      const Stage& stage = m_Stages[i];
+      {
+        std::unique_lock<std::mutex> l(mutex);
+        cv.wait(l, [this, &stage, &done, &failure] {
+          if (failure)
+            return true;
+          for (std::size_t dependency : stage.dependencies)
+            if (!done[dependency])
+              return false;
+          return true;
+        });
+        // Once one stage fails the rest are abandoned; the caller's
+        // exception path tears the router down anyway
+        if (failure) {
+          done[i] = true;
+          cv.notify_all();
+          return;
+        }
+      }
+      LOG(debug) << "StartupExecutor: starting " << stage.name;
+      const auto started = std::chrono::steady_clock::now();
+      std::exception_ptr error;
+      try {
+        stage.run();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      const auto elapsed =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - started).count();
+      std::unique_lock<std::mutex> l(mutex);
+      done[i] = true;
+      if (error) {
+        LOG(error) << "StartupExecutor: " << stage.name << " failed after "
+                   << elapsed << "ms";
+        if (!failure)
+          failure = error;
+      } else {
+        LOG(debug) << "StartupExecutor: " << stage.name << " up in "
+                   << elapsed << "ms";
+      }
+      cv.notify_all();
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  if (failure)
+    std::rethrow_exception(failure);
+}
+
+}  // namespace core
+}  // namespace kovri
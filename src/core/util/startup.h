@@ -0,0 +1,76 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_STARTUP_H_
+#define SRC_CORE_UTIL_STARTUP_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @class StartupExecutor
+/// @brief Runs named startup stages concurrently, honoring declared
+///   dependencies between them
+/// @details Bring-up used to wait on one subsystem at a time even though
+///   most of the wall time (NetDb file load, transport socket setup) is
+///   independent. Each stage starts on its own thread as soon as all of
+///   its dependencies have finished; Run returns once every stage is
+///   done and rethrows the first stage failure, so callers keep the
+///   fail-fast semantics of the old sequential code
+class StartupExecutor {
+ public:
+  /// @brief Declares a stage and the names of stages it must wait for
+  /// @notes Dependencies must refer to stages already added
+  void AddStage(
+      const std::string& name,
+      std::function<void()> stage,
+      const std::vector<std::string>& dependencies = {});
+
+  /// @brief Runs all stages and blocks until the last one finishes
+  /// @throws The first stage exception, after all stages have stopped
+  void Run();
+
+ private:
+  struct Stage {
+    std::string name;
+    std::function<void()> run;
+    std::vector<std::size_t> dependencies;
+  };
+
+  std::vector<Stage> m_Stages;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_STARTUP_H_
@@ -37,7 +37,12 @@
 #include <cstdint>
 #include <cstring>
 
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))  // TODO(unassigned): hack until we implement NEON kernels
+#include <immintrin.h>
+#endif
+
 #include <exception>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -104,6 +109,59 @@ class alignas(8) Tag
     return std::memcmp(m_Buf, other.m_Buf, Size) < 0;
   }
 
+  /// @brief Early-exit equality for public identifiers (router hashes,
+  ///   table keys): one wide compare instead of a byte loop
+  /// @warning Timing leaks the position of the first differing byte.
+  ///   Keep operator== (constant time) for anything secret, e.g.
+  ///   session tags
+  bool Eq(const Tag<Size>& other) const
+  {
+#if (defined(__x86_64__) || defined(_M_X64)) && (!defined(_MSC_VER))
+    if (Size == 32)
+      {
+        __m128i const lo = _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_Buf)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(other.m_Buf)));
+        __m128i const hi = _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_Buf + 16)),
+            _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(other.m_Buf + 16)));
+        return _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xFFFF;
+      }
+#endif
+    std::uint64_t diff = 0;
+    for (std::uint64_t i = 0; i < Size / 8; i++)
+      diff |= GetLL()[i] ^ other.GetLL()[i];
+    return !diff;
+  }
+
+  /// @brief XOR (Kademlia) distance to other, computed word-wise
+  Tag<Size> Xor(const Tag<Size>& other) const
+  {
+    Tag<Size> distance;
+    std::uint64_t* const out = reinterpret_cast<std::uint64_t*>(distance.m_Buf);
+    for (std::uint64_t i = 0; i < Size / 8; i++)
+      out[i] = GetLL()[i] ^ other.GetLL()[i];
+    return distance;
+  }
+
+  /// @brief 64-bit hash for open-addressed tables: folds every word so
+  ///   structured tags still spread across buckets, then applies a
+  ///   splitmix64-style finalizer
+  std::uint64_t Hash64() const
+  {
+    std::uint64_t hash = 0x9E3779B97F4A7C15ULL;
+    for (std::uint64_t i = 0; i < Size / 8; i++)
+      {
+        hash ^= GetLL()[i];
+        hash *= 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 27;
+      }
+    hash *= 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+    return hash;
+  }
+
   bool IsZero() const
   {
     for (std::uint64_t i = 0; i < Size / 8; i++)
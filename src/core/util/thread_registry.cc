@@ -0,0 +1,125 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/thread_registry.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstdlib>
+#include <sstream>
+
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+// Instantiated in namespace scope like the other process-wide services
+// (see netdb/context); threads register against it as they start
+ThreadRegistry thread_registry;
+
+void ThreadRegistry::SetPolicy(const std::string& policy) {
+  std::lock_guard<std::mutex> l(m_Mutex);
+  m_Policies.clear();
+  std::istringstream roles(policy);
+  std::string entry;
+  while (std::getline(roles, entry, ';')) {
+    if (entry.empty())
+      continue;
+    auto const colon = entry.find(':');
+    if (colon == std::string::npos || !colon) {
+      LOG(warning) << "ThreadRegistry: ignoring malformed policy " << entry;
+      continue;
+    }
+    RolePolicy role_policy;
+    std::string spec = entry.substr(colon + 1);
+    auto const at = spec.find('@');
+    if (at != std::string::npos) {
+      role_policy.nice_value = std::atoi(spec.substr(at + 1).c_str());
+      role_policy.has_nice = true;
+      spec = spec.substr(0, at);
+    }
+    std::istringstream cpu_list(spec);
+    std::string cpu;
+    while (std::getline(cpu_list, cpu, ','))
+      if (!cpu.empty())
+        role_policy.cpus.push_back(std::atoi(cpu.c_str()));
+    m_Policies[entry.substr(0, colon)] = role_policy;
+  }
+}
+
+void ThreadRegistry::Register(const std::string& role) {
+#ifdef __linux__
+  // the kernel limit is 15 visible characters
+  pthread_setname_np(pthread_self(), role.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+  pthread_setname_np(role.c_str());
+#endif
+  RolePolicy policy;
+  {
+    std::lock_guard<std::mutex> l(m_Mutex);
+    auto it = m_Policies.find(role);
+    if (it == m_Policies.end())
+      return;
+    policy = it->second;
+  }
+#ifdef __linux__
+  if (!policy.cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : policy.cpus)
+      CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set))
+      LOG(warning) << "ThreadRegistry: could not pin thread " << role;
+    else
+      LOG(debug) << "ThreadRegistry: thread " << role << " pinned";
+  }
+  if (policy.has_nice) {
+    // affects only the calling thread on Linux
+    if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), policy.nice_value))
+      LOG(warning)
+        << "ThreadRegistry: could not set priority for thread " << role;
+  }
+#else
+  if (!policy.cpus.empty() || policy.has_nice)
+    LOG(warning)
+      << "ThreadRegistry: affinity/priority unsupported on this platform, "
+      << "thread " << role << " left as is";
+#endif
+}
+
+}  // namespace core
+}  // namespace kovri
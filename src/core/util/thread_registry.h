@@ -0,0 +1,76 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_THREAD_REGISTRY_H_
+#define SRC_CORE_UTIL_THREAD_REGISTRY_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @class ThreadRegistry
+/// @brief Names router threads by role and applies config-driven CPU
+///   affinity and priority, so crypto-heavy threads can be pinned to a
+///   core set (keeping them on one NUMA node) and background work niced
+/// @notes Subsystems call Register from inside their thread; roles
+///   without a configured policy just get the platform thread name
+class ThreadRegistry {
+ public:
+  /// @brief Per-role assignment parsed from the policy string
+  struct RolePolicy {
+    std::vector<int> cpus;
+    int nice_value = 0;
+    bool has_nice = false;
+  };
+
+  /// @brief Replaces role policies from a config string of the form
+  ///   "role:cpu[,cpu...][@nice]" with entries joined by ';',
+  ///   e.g. "tunnel-crypto:2,3;netdb:4@10"
+  void SetPolicy(const std::string& policy);
+
+  /// @brief Names the calling thread after role and applies the role's
+  ///   configured CPU set and nice value, if any
+  void Register(const std::string& role);
+
+ private:
+  mutable std::mutex m_Mutex;
+  std::map<std::string, RolePolicy> m_Policies;
+};
+
+extern ThreadRegistry thread_registry;
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_THREAD_REGISTRY_H_
@@ -0,0 +1,132 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/timer_wheel.h"
+
+#include <utility>
+
+namespace kovri {
+namespace core {
+
+TimerWheel::TimerWheel(boost::asio::io_service& service)
+    : m_Service(service),
+      m_Tick(service),
+      m_Slots(Trait::NumSlots),
+      m_NextToken(0),
+      m_CurrentSlot(0),
+      m_IsTicking(false) {}
+
+TimerWheel::~TimerWheel() {
+  Stop();
+}
+
+TimerWheel::Token TimerWheel::Add(
+    std::uint64_t delay,
+    Callback callback) {
+  // Round up so short delays still get at least one full tick
+  std::uint64_t ticks = (delay + Trait::TickInterval - 1) / Trait::TickInterval;
+  if (!ticks)
+    ticks = 1;
+  Entry entry;
+  entry.token = ++m_NextToken;
+  entry.rounds = static_cast<std::uint32_t>(ticks / Trait::NumSlots);
+  entry.callback = std::move(callback);
+  std::size_t const slot = (m_CurrentSlot + ticks) % Trait::NumSlots;
+  auto& list = m_Slots.at(slot);
+  list.push_back(std::move(entry));
+  m_Entries[m_NextToken] = std::make_pair(slot, std::prev(list.end()));
+  if (!m_IsTicking)
+    ScheduleTick();
+  return m_NextToken;
+}
+
+void TimerWheel::Cancel(
+    Token token,
+    bool invoke) {
+  auto it = m_Entries.find(token);
+  if (it == m_Entries.end())
+    return;  // Never armed, already expired, or already cancelled
+  if (invoke) {
+    // Match deadline_timer::cancel: the handler runs from the service,
+    // not from inside the caller
+    m_Service.post(
+        std::bind(std::move(it->second.second->callback), true));
+  }
+  m_Slots.at(it->second.first).erase(it->second.second);
+  m_Entries.erase(it);
+}
+
+void TimerWheel::Stop() {
+  m_Entries.clear();
+  for (auto& slot : m_Slots)
+    slot.clear();
+  m_IsTicking = false;
+  m_Tick.cancel();
+}
+
+void TimerWheel::ScheduleTick() {
+  m_IsTicking = true;
+  m_Tick.expires_from_now(
+      boost::posix_time::milliseconds(
+          static_cast<long>(Trait::TickInterval)));  // NOLINT(runtime/int)
+  m_Tick.async_wait(
+      std::bind(
+          &TimerWheel::HandleTick,
+          this,
+          std::placeholders::_1));
+}
+
+void TimerWheel::HandleTick(
+    const boost::system::error_code& ecode) {
+  if (ecode == boost::asio::error::operation_aborted || !m_IsTicking)
+    return;
+  m_CurrentSlot = (m_CurrentSlot + 1) % Trait::NumSlots;
+  auto& list = m_Slots.at(m_CurrentSlot);
+  auto it = list.begin();
+  while (it != list.end()) {
+    if (it->rounds) {
+      it->rounds--;
+      ++it;
+      continue;
+    }
+    Callback callback = std::move(it->callback);
+    m_Entries.erase(it->token);
+    it = list.erase(it);
+    // The callback may re-arm timers on this wheel; state is consistent here
+    callback(false);
+  }
+  if (m_Entries.empty())
+    m_IsTicking = false;  // Idle wheel: stop ticking until the next Add
+  else
+    ScheduleTick();
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,118 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_CORE_UTIL_TIMER_WHEEL_H_
+#define SRC_CORE_UTIL_TIMER_WHEEL_H_
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @class TimerWheel
+/// @brief Hashed timing wheel multiplexing many logical timers onto a
+///   single asio deadline_timer. Arming and cancelling are O(1), and an
+///   object owning N logical timers no longer pays N timer-heap entries
+///   and allocations in the io_service.
+/// @notes Not thread-safe: all calls (and all callbacks) run on the
+///   owning io_service's thread, matching a plain deadline_timer wrapped
+///   in that service. Resolution is Trait::TickInterval milliseconds
+class TimerWheel {
+ public:
+  /// @brief Expiry/abort handler; aborted is true only for an invoking
+  ///   Cancel (mirroring deadline_timer's operation_aborted)
+  typedef std::function<void (bool aborted)> Callback;
+
+  /// @brief Handle for one armed logical timer; 0 is never returned and
+  ///   is safely ignored by Cancel
+  typedef std::uint64_t Token;
+
+  /// @enum Trait
+  /// @brief Wheel geometry
+  enum Trait : std::uint16_t
+  {
+    /// @brief Tick resolution, in milliseconds
+    TickInterval = 10,
+    /// @brief Slots per revolution (longer delays carry a round count)
+    NumSlots = 512,
+  };
+
+  explicit TimerWheel(boost::asio::io_service& service);
+  ~TimerWheel();
+
+  /// @brief Arms a logical timer
+  /// @param delay Expiry delay in milliseconds (rounded up to a tick)
+  /// @param callback Invoked with aborted=false on expiry
+  /// @return Token to cancel with; stays unique for the wheel's lifetime
+  Token Add(std::uint64_t delay, Callback callback);
+
+  /// @brief Disarms a logical timer; unknown/expired tokens are ignored
+  /// @param invoke If true, the callback is posted with aborted=true,
+  ///   like a cancelled deadline_timer's pending handler
+  void Cancel(Token token, bool invoke = false);
+
+  /// @brief Drops all armed timers without invoking them and stops ticking
+  void Stop();
+
+ private:
+  /// @brief Ticks the driving timer while any logical timer is armed
+  void ScheduleTick();
+
+  /// @brief Advances the wheel one slot, firing due entries
+  void HandleTick(const boost::system::error_code& ecode);
+
+ private:
+  struct Entry {
+    Token token;
+    std::uint32_t rounds;  ///< Revolutions left before expiry
+    Callback callback;
+  };
+
+  boost::asio::io_service& m_Service;
+  boost::asio::deadline_timer m_Tick;
+  std::vector<std::list<Entry>> m_Slots;
+  /// @brief Token -> (slot, entry) for O(1) cancellation
+  std::map<Token, std::pair<std::size_t, std::list<Entry>::iterator>> m_Entries;
+  Token m_NextToken;
+  std::size_t m_CurrentSlot;
+  bool m_IsTicking;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_TIMER_WHEEL_H_
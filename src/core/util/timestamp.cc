@@ -0,0 +1,78 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "core/util/byte_stream.h"
+
+
+#include "core/util/timestamp.h"
+
+#include <memory>
+#include <thread>
+
+namespace kovri {
+namespace core {
+
+std::atomic<std::uint64_t> g_CoarseMilliseconds(0);
+
+namespace {
+std::atomic<bool> g_CoarseClockRunning(false);
+std::unique_ptr<std::thread> g_CoarseClockThread;
+}  // namespace
+
+void StartCoarseClock() {
+  if (g_CoarseClockRunning.exchange(true))
+    return;
+  g_CoarseMilliseconds.store(
+      GetExactMillisecondsSinceEpoch(),
+      std::memory_order_relaxed);
+  g_CoarseClockThread = std::make_unique<std::thread>([]() {
+    while (g_CoarseClockRunning.load(std::memory_order_relaxed)) {
+      g_CoarseMilliseconds.store(
+          GetExactMillisecondsSinceEpoch(),
+          std::memory_order_relaxed);
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(COARSE_CLOCK_RESOLUTION));
+    }
+  });
+}
+
+void StopCoarseClock() {
+  if (!g_CoarseClockRunning.exchange(false))
+    return;
+  if (g_CoarseClockThread) {
+    g_CoarseClockThread->join();
+    g_CoarseClockThread.reset();
+  }
+  // reads fall back to the exact clock
+  g_CoarseMilliseconds.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace core
+}  // namespace kovri
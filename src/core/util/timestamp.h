@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_UTIL_TIMESTAMP_H_
 #define SRC_CORE_UTIL_TIMESTAMP_H_
 
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -40,21 +41,44 @@
 namespace kovri {
 namespace core {
 
-inline std::uint64_t GetMillisecondsSinceEpoch() {
+/// @brief Refresh interval of the cached coarse clock
+const std::uint64_t COARSE_CLOCK_RESOLUTION = 10;  // in milliseconds
+
+/// @brief Backing store of the cached coarse clock; refreshed by the
+///  ticker thread (0 = ticker not running)
+extern std::atomic<std::uint64_t> g_CoarseMilliseconds;
+
+/// @brief Reads the wall clock directly
+/// @notes Only for callers needing sub-tick precision; per-message paths
+///  should use GetMillisecondsSinceEpoch() and skip the clock syscall
+inline std::uint64_t GetExactMillisecondsSinceEpoch() {
   return std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+/// @brief Current time served from the cached coarse clock
+///  (COARSE_CLOCK_RESOLUTION granularity); falls back to the exact clock
+///  until StartCoarseClock() has run
+inline std::uint64_t GetMillisecondsSinceEpoch() {
+  std::uint64_t const cached =
+      g_CoarseMilliseconds.load(std::memory_order_relaxed);
+  return cached ? cached : GetExactMillisecondsSinceEpoch();
+}
+
 inline std::uint32_t GetHoursSinceEpoch() {
-  return std::chrono::duration_cast<std::chrono::hours>(
-      std::chrono::system_clock::now().time_since_epoch()).count();
+  return GetMillisecondsSinceEpoch() / (3600 * 1000);
 }
 
 inline std::uint64_t GetSecondsSinceEpoch() {
-  return std::chrono::duration_cast<std::chrono::seconds>(
-      std::chrono::system_clock::now().time_since_epoch()).count();
+  return GetMillisecondsSinceEpoch() / 1000;
 }
 
+/// @brief Starts the background ticker refreshing the coarse clock
+void StartCoarseClock();
+
+/// @brief Stops the ticker; time reads fall back to the exact clock
+void StopCoarseClock();
+
 }  // namespace core
 }  // namespace kovri
 
@@ -0,0 +1,63 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#ifndef SRC_CORE_UTIL_TRACE_H_
+#define SRC_CORE_UTIL_TRACE_H_
+
+/// @brief Static tracepoints (USDT) on the message hot path, under the
+///   "kovri" provider. An unattached probe is a single nop, so they stay
+///   compiled into production builds (-DWITH_USDT) and perf/bpftrace can
+///   attach stage-latency histograms without a rebuild, e.g.:
+///     bpftrace -e 'usdt:./kovri:kovri:transit_crypto_begin
+///       { @in[arg0] = nsecs; }'
+///   Without WITH_USDT (or off Linux) the macros expand to nothing.
+
+#if defined(WITH_USDT)
+
+#include <sys/sdt.h>
+
+#define KOVRI_PROBE1(probe, a1) \
+  DTRACE_PROBE1(kovri, probe, a1)
+#define KOVRI_PROBE2(probe, a1, a2) \
+  DTRACE_PROBE2(kovri, probe, a1, a2)
+#define KOVRI_PROBE3(probe, a1, a2, a3) \
+  DTRACE_PROBE3(kovri, probe, a1, a2, a3)
+
+#else
+
+#define KOVRI_PROBE1(probe, a1) ((void)0)
+#define KOVRI_PROBE2(probe, a1, a2) ((void)0)
+#define KOVRI_PROBE3(probe, a1, a2, a3) ((void)0)
+
+#endif
+
+#endif  // SRC_CORE_UTIL_TRACE_H_
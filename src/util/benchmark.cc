@@ -30,9 +30,19 @@
 
 #include "util/benchmark.h"
 
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
 #include <cryptopp/secblock.h>
 
+#include <utility>
+
+#include "core/crypto/elgamal.h"
+#include "core/crypto/radix.h"
 #include "core/crypto/signature.h"
+#include "core/crypto/tunnel.h"
+#include "core/router/i2np.h"
+#include "core/router/tunnel/gateway.h"
 #include "core/util/exception.h"
 #include "core/util/log.h"
 
@@ -48,6 +58,7 @@ void Benchmark::PerformTests()
   uint8_t output_DSA[kovri::core::DSA_SIGNATURE_LENGTH];
   LOG(info) << "--------DSA---------";
   BenchmarkTest<kovri::core::DSAVerifier, kovri::core::DSASigner>(
+      "DSA",
       Benchmark::BenchmarkCount,
       private_key_DSA,
       public_key_DSA,
@@ -59,6 +70,7 @@ void Benchmark::PerformTests()
   uint8_t output_ECDSAP256[kovri::core::ECDSAP256_KEY_LENGTH];
   LOG(info) << "-----ECDSAP256------";
   BenchmarkTest<kovri::core::ECDSAP256Verifier, kovri::core::ECDSAP256Signer>(
+      "ECDSAP256",
       Benchmark::BenchmarkCount,
       private_key_ECDSAP256,
       public_key_ECDSAP256,
@@ -70,6 +82,7 @@ void Benchmark::PerformTests()
   uint8_t public_key_ECDSAP384[kovri::core::ECDSAP384_KEY_LENGTH / 2];
   uint8_t output_ECDSAP384[kovri::core::ECDSAP384_KEY_LENGTH];
   BenchmarkTest<kovri::core::ECDSAP384Verifier, kovri::core::ECDSAP384Signer>(
+      "ECDSAP384",
       Benchmark::BenchmarkCount,
       private_key_ECDSAP384,
       public_key_ECDSAP384,
@@ -81,6 +94,7 @@ void Benchmark::PerformTests()
   uint8_t public_key_ECDSAP521[kovri::core::ECDSAP521_KEY_LENGTH / 2];
   uint8_t output_ECDSAP521[kovri::core::ECDSAP521_KEY_LENGTH];
   BenchmarkTest<kovri::core::ECDSAP521Verifier, kovri::core::ECDSAP521Signer>(
+      "ECDSAP521",
       Benchmark::BenchmarkCount,
       private_key_ECDSAP521,
       public_key_ECDSAP521,
@@ -96,17 +110,33 @@ void Benchmark::PerformTests()
   CryptoPP::SecByteBlock ed25519_sig(crypto::SigLen::Ed25519);
 
   BenchmarkTest<core::Ed25519Verifier, core::Ed25519Signer>(
+      "EdDSA25519",
       Benchmark::BenchmarkCount,
       ed25519_sk.data(),
       ed25519_pk.data(),
       ed25519_sig.data(),
       kovri::core::CreateEd25519KeyPair);
+
+  LOG(info) << "------ElGamal-------";
+  // Bignum-heavy: a tenth of the iterations keeps the run short
+  BenchmarkElGamal(Benchmark::BenchmarkCount / 10);
+
+  LOG(info) << "----TunnelCrypto----";
+  BenchmarkTunnelCrypto(Benchmark::BenchmarkCount);
+
+  LOG(info) << "-------Radix--------";
+  BenchmarkRadix(Benchmark::BenchmarkCount);
+
+  LOG(info) << "---TunnelGateway----";
+  BenchmarkTunnelGateway(Benchmark::BenchmarkCount);
 }
 
 Benchmark::Benchmark() : m_Desc("Options")
 {
   m_Desc.add_options()("help,h", "produce this help message")
-     ("test,t", bpo::bool_switch()->default_value(true), "all tests");
+     ("test,t", bpo::bool_switch()->default_value(true), "all tests")
+     ("output,o", bpo::value<std::string>(),
+      "write results as JSON to given file");
 }
 /// @brief parse options and perform action
 bool Benchmark::Impl(const std::string& cmd_name,
@@ -136,11 +166,16 @@ bool Benchmark::Impl(const std::string& cmd_name,
     {
       PerformTests();
     }
+  if (vm.count("output"))  // write results
+    {
+      WriteJSON(vm["output"].as<std::string>());
+    }
   return true;
 }
 /// @brief perform single benchmark test
 template <class Verifier, class Signer>
 void Benchmark::BenchmarkTest(
+    const std::string& name,
     std::size_t count,
     uint8_t * private_key,
     uint8_t * public_key,
@@ -178,15 +213,213 @@ void Benchmark::BenchmarkTest(
           break;
         }
     }
-  LOG(info) << "Conducted " << count << " experiments.";
-  LOG(info) << "Total sign time: "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(
-                   sign_duration)
-                   .count();
-  LOG(info) << "Total verify time: "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(
-                   verify_duration)
-                   .count();
+  Record(name + ".sign", count, sign_duration);
+  Record(name + ".verify", count, verify_duration);
+}
+
+void Benchmark::BenchmarkTunnelCrypto(std::size_t count)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds encrypt_duration(0);
+  std::chrono::nanoseconds decrypt_duration(0);
+  try
+    {
+      core::AESKey layer_key, iv_key;
+      core::RandBytes(layer_key, sizeof(core::AESKey));
+      core::RandBytes(iv_key, sizeof(core::AESKey));
+      core::TunnelEncryption encryption;
+      core::TunnelDecryption decryption;
+      encryption.SetKeys(layer_key, iv_key);
+      decryption.SetKeys(layer_key, iv_key);
+      uint8_t block[1024];  // 16 IV + 1008 data
+      core::RandBytes(block, sizeof(block));
+      for (std::size_t i = 0; i < count; ++i)
+        {
+          TimePoint begin1 = std::chrono::high_resolution_clock::now();
+          encryption.Encrypt(block, block);
+          TimePoint end1 = std::chrono::high_resolution_clock::now();
+          encrypt_duration +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end1 - begin1);
+          TimePoint begin2 = std::chrono::high_resolution_clock::now();
+          decryption.Decrypt(block, block);
+          TimePoint end2 = std::chrono::high_resolution_clock::now();
+          decrypt_duration +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end2 - begin2);
+        }
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("tunnel.encrypt", count, encrypt_duration);
+  Record("tunnel.decrypt", count, decrypt_duration);
+}
+
+void Benchmark::BenchmarkElGamal(std::size_t count)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds encrypt_duration(0);
+  std::chrono::nanoseconds decrypt_duration(0);
+  try
+    {
+      uint8_t private_key[256], public_key[256];
+      core::GenerateElGamalKeyPair(private_key, public_key);
+      core::ElGamalEncryption encryption(public_key);
+      uint8_t plaintext[222], decrypted[222], encrypted[514];
+      core::RandBytes(plaintext, sizeof(plaintext));
+      for (std::size_t i = 0; i < count; ++i)
+        {
+          TimePoint begin1 = std::chrono::high_resolution_clock::now();
+          encryption.Encrypt(
+              plaintext, sizeof(plaintext), encrypted, true);
+          TimePoint end1 = std::chrono::high_resolution_clock::now();
+          encrypt_duration +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end1 - begin1);
+          TimePoint begin2 = std::chrono::high_resolution_clock::now();
+          core::ElGamalDecrypt(private_key, encrypted, decrypted, true);
+          TimePoint end2 = std::chrono::high_resolution_clock::now();
+          decrypt_duration +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end2 - begin2);
+        }
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("elgamal.encrypt", count, encrypt_duration);
+  Record("elgamal.decrypt", count, decrypt_duration);
+}
+
+void Benchmark::BenchmarkRadix(std::size_t count)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds base32_encode(0), base32_decode(0);
+  std::chrono::nanoseconds base64_encode(0), base64_decode(0);
+  try
+    {
+      uint8_t data[512];  // typical identity-sized input
+      core::RandBytes(data, sizeof(data));
+      for (std::size_t i = 0; i < count; ++i)
+        {
+          TimePoint begin = std::chrono::high_resolution_clock::now();
+          std::string encoded32 = core::Base32::Encode(data, sizeof(data));
+          TimePoint end = std::chrono::high_resolution_clock::now();
+          base32_encode +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end - begin);
+          begin = std::chrono::high_resolution_clock::now();
+          core::Base32::Decode(encoded32.c_str(), encoded32.size());
+          end = std::chrono::high_resolution_clock::now();
+          base32_decode +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end - begin);
+          begin = std::chrono::high_resolution_clock::now();
+          std::string encoded64 = core::Base64::Encode(data, sizeof(data));
+          end = std::chrono::high_resolution_clock::now();
+          base64_encode +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end - begin);
+          begin = std::chrono::high_resolution_clock::now();
+          core::Base64::Decode(encoded64.c_str(), encoded64.size());
+          end = std::chrono::high_resolution_clock::now();
+          base64_decode +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end - begin);
+        }
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("base32.encode", count, base32_encode);
+  Record("base32.decode", count, base32_decode);
+  Record("base64.encode", count, base64_encode);
+  Record("base64.decode", count, base64_decode);
+}
+
+void Benchmark::BenchmarkTunnelGateway(std::size_t count)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds put_duration(0);
+  try
+    {
+      // Payload larger than one tunnel data message so every PutI2NPMsg
+      // exercises the fragmentation path
+      uint8_t payload[2048];
+      core::RandBytes(payload, sizeof(payload));
+      core::TunnelMessageBlock block;
+      block.delivery_type = core::e_DeliveryTypeLocal;
+      block.tunnel_ID = 0;
+      core::TunnelGatewayBuffer buffer(core::Rand<uint32_t>());
+      for (std::size_t i = 0; i < count; ++i)
+        {
+          block.data = core::ToSharedI2NPMessage(core::CreateI2NPMessage(
+              core::I2NPData, payload, sizeof(payload)));
+          TimePoint begin = std::chrono::high_resolution_clock::now();
+          buffer.PutI2NPMsg(std::move(block));
+          TimePoint end = std::chrono::high_resolution_clock::now();
+          put_duration +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  end - begin);
+          buffer.CompleteCurrentTunnelDataMessage();
+          buffer.ClearTunnelDataMsgs();
+        }
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("tunnel_gateway.put_i2np_msg", count, put_duration);
+}
+
+void Benchmark::Record(
+    const std::string& name,
+    std::size_t count,
+    const std::chrono::nanoseconds& total)
+{
+  m_Results.push_back(Result{name, count, total});
+  LOG(info) << name << ": " << count << " ops in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(total)
+                   .count()
+            << " ms";
+}
+
+void Benchmark::WriteJSON(const std::string& path) const
+{
+  try
+    {
+      boost::property_tree::ptree results;
+      for (const auto& result : m_Results)
+        {
+          boost::property_tree::ptree entry;
+          entry.put("iterations", result.iterations);
+          entry.put("total_ns", result.total.count());
+          entry.put(
+              "ns_per_op",
+              result.iterations ? result.total.count() / result.iterations
+                                : 0);
+          results.add_child(result.name, entry);
+        }
+      boost::property_tree::write_json(path, results);
+      LOG(info) << "Benchmark: results written to " << path;
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+    }
 }
 
 void Benchmark::PrintUsage(const std::string& name) const
@@ -45,6 +45,14 @@ class Benchmark : public Command
  public:
   typedef void (*KeyGenerator)(uint8_t*, uint8_t*);
   static const std::size_t BenchmarkCount = 1000;
+
+  /// @brief Timing result of one benchmarked operation
+  struct Result
+  {
+    std::string name;
+    std::size_t iterations;
+    std::chrono::nanoseconds total;
+  };
   Benchmark();
   boost::program_options::options_description m_Desc;
   std::string m_OptType;
@@ -66,16 +74,41 @@ class Benchmark : public Command
 
   template <class Verifier, class Signer>
   void BenchmarkTest(
+      const std::string& name,
       std::size_t count,
       uint8_t * private_key_size,
       uint8_t * public_key_size,
       uint8_t * output,
       KeyGenerator generator);
 
+  /// @brief Time tunnel layer encryption/decryption of 1024-byte blocks
+  void BenchmarkTunnelCrypto(std::size_t count);
+
+  /// @brief Time ElGamal block encryption/decryption
+  void BenchmarkElGamal(std::size_t count);
+
+  /// @brief Time Base32/Base64 encoding and decoding
+  void BenchmarkRadix(std::size_t count);
+
+  /// @brief Time gateway fragmentation of I2NP messages into tunnel data
+  void BenchmarkTunnelGateway(std::size_t count);
+
+  /// @brief Log a timing result and keep it for JSON output
+  void Record(
+      const std::string& name,
+      std::size_t count,
+      const std::chrono::nanoseconds& total);
+
+  /// @brief Write recorded results as JSON for comparison across releases
+  void WriteJSON(const std::string& path) const;
+
   std::string GetName(void) const
   {
     return "benchmark";
   }
+
+ private:
+  std::vector<Result> m_Results;
 };
 
 #endif  // SRC_UTIL_BENCHMARK_H_
@@ -42,7 +42,9 @@
 #endif  // WITH_FUZZ_TESTS
 #include "util/i2pcontrol.h"
 #include "util/routerinfo.h"
+#include "util/simulation.h"
 #include "util/su3file.h"
+#include "util/trace.h"
 
 #ifndef _WIN32
 #include "util/kovri.h"
@@ -84,6 +86,12 @@ int main(int argc, const char* argv[])
       Benchmark benchmark_cmd;
       list_cmd[benchmark_cmd.GetName()] = &benchmark_cmd;
 
+      Simulation simulation_cmd;
+      list_cmd[simulation_cmd.GetName()] = &simulation_cmd;
+
+      TraceCommand trace_cmd;
+      list_cmd[trace_cmd.GetName()] = &trace_cmd;
+
       I2PControlCommand i2pcontrol_cmd;
       list_cmd[i2pcontrol_cmd.GetName()] = &i2pcontrol_cmd;
 
@@ -0,0 +1,479 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "util/simulation.h"
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <array>
+#include <memory>
+#include <utility>
+
+#include "core/crypto/elgamal.h"
+#include "core/crypto/rand.h"
+#include "core/crypto/tunnel.h"
+#include "core/router/context.h"
+#include "core/router/garlic.h"
+#include "core/router/i2np.h"
+#include "core/router/identity.h"
+#include "core/router/tunnel/endpoint.h"
+#include "core/router/tunnel/gateway.h"
+#include "core/util/exception.h"
+#include "core/util/log.h"
+
+namespace bpo = boost::program_options;
+namespace core = kovri::core;
+
+namespace {
+
+/// @brief In-process garlic receiver standing in for a remote destination
+class SimDestination : public core::GarlicDestination
+{
+ public:
+  SimDestination()
+      : m_Keys(core::PrivateKeys::CreateRandomKeys()),
+        m_DeliveredMsgs(0),
+        m_DeliveredBytes(0)
+  {
+    core::GenerateElGamalKeyPair(
+        m_EncryptionPrivateKey,
+        m_EncryptionPublicKey);
+  }
+
+  const core::PrivateKeys& GetPrivateKeys() const
+  {
+    return m_Keys;
+  }
+
+  const std::uint8_t* GetEncryptionPrivateKey() const
+  {
+    return m_EncryptionPrivateKey;
+  }
+
+  const std::uint8_t* GetEncryptionPublicKey() const
+  {
+    return m_EncryptionPublicKey;
+  }
+
+  std::shared_ptr<const core::LeaseSet> GetLeaseSet()
+  {
+    return nullptr;
+  }
+
+  std::shared_ptr<core::TunnelPool> GetTunnelPool() const
+  {
+    return nullptr;
+  }
+
+  void HandleI2NPMessage(
+      const std::uint8_t* buf,
+      std::size_t,
+      std::shared_ptr<core::InboundTunnel>)
+  {
+    m_DeliveredMsgs++;
+    m_DeliveredBytes += core::GetI2NPMessageLength(buf);
+  }
+
+  std::size_t GetDeliveredMsgs() const
+  {
+    return m_DeliveredMsgs;
+  }
+
+ private:
+  core::PrivateKeys m_Keys;
+  std::uint8_t m_EncryptionPublicKey[256], m_EncryptionPrivateKey[256];
+  std::size_t m_DeliveredMsgs, m_DeliveredBytes;
+};
+
+/// @brief Routing-destination view of a SimDestination, as a sender sees it
+class SimRoutingDestination : public core::RoutingDestination
+{
+ public:
+  explicit SimRoutingDestination(const SimDestination& dest)
+      : m_IdentHash(dest.GetIdentHash()),
+        m_EncryptionKey(dest.GetEncryptionPublicKey()) {}
+
+  const core::IdentHash& GetIdentHash() const
+  {
+    return m_IdentHash;
+  }
+
+  const std::uint8_t* GetEncryptionPublicKey() const
+  {
+    return m_EncryptionKey;
+  }
+
+  bool IsDestination() const
+  {
+    return true;
+  }
+
+ private:
+  core::IdentHash m_IdentHash;
+  const std::uint8_t* m_EncryptionKey;
+};
+
+/// @brief Random payload of the given size, typed DeliveryStatus so the
+///   dispatch at the end of a pipeline lands on the quiet garlic
+///   bookkeeping path instead of warning once per message
+std::shared_ptr<core::I2NPMessage> CreatePayloadMessage(std::size_t size)
+{
+  std::vector<std::uint8_t> payload(size);
+  core::RandBytes(payload.data(), payload.size());
+  return core::ToSharedI2NPMessage(core::CreateI2NPMessage(
+      core::I2NPDeliveryStatus, payload.data(), payload.size()));
+}
+
+}  // namespace
+
+Simulation::Simulation() : m_Desc("Options")
+{
+  m_Desc.add_options()("help,h", "produce this help message")
+     ("count,c", bpo::value<std::size_t>()->default_value(DefaultMessageCount),
+      "messages per pipeline")
+     ("size,s", bpo::value<std::size_t>()->default_value(DefaultPayloadSize),
+      "payload bytes per message")
+     ("hops,n", bpo::value<std::size_t>()->default_value(DefaultHopCount),
+      "simulated tunnel hops")
+     ("output,o", bpo::value<std::string>(),
+      "write results as JSON to given file");
+}
+
+bool Simulation::Impl(const std::string& cmd_name,
+    const std::vector<std::string>& args)
+{
+  bpo::variables_map vm;
+  try
+    {
+      bpo::parsed_options parsed =
+          bpo::command_line_parser(args).options(m_Desc).run();
+      bpo::store(parsed, vm);
+      bpo::notify(vm);
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return false;
+    }
+
+  if (vm.count("help"))
+    {
+      PrintUsage(cmd_name);
+      return false;
+    }
+  std::size_t count = vm["count"].as<std::size_t>();
+  std::size_t size = vm["size"].as<std::size_t>();
+  std::size_t hops = vm["hops"].as<std::size_t>();
+  if (!count || !hops || hops > 8 || size < 16 || size > 16384)
+    {
+      LOG(error) << GetName()
+                 << ": count > 0, 1-8 hops and 16-16384 byte payloads only";
+      return false;
+    }
+  RunAll(count, size, hops);
+  if (vm.count("output"))
+    {
+      WriteJSON(vm["output"].as<std::string>());
+    }
+  return true;
+}
+
+void Simulation::RunAll(std::size_t count, std::size_t size, std::size_t hops)
+{
+  LOG(info) << "---TunnelPipeline---";
+  RunTunnelPipeline(count, size, hops);
+
+  LOG(info) << "--GarlicEstablish---";
+  // One ElGamal bootstrap per message: a tenth of the iterations keeps
+  // the run short
+  RunGarlicEstablish(count / 10 ? count / 10 : 1, size);
+
+  LOG(info) << "---GarlicSession----";
+  RunGarlicSession(count, size);
+
+  LOG(info) << "------EndToEnd------";
+  RunEndToEnd(count, size, hops);
+}
+
+void Simulation::RunTunnelPipeline(
+    std::size_t count,
+    std::size_t size,
+    std::size_t hops)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds total(0);
+  try
+    {
+      // Per-hop layer keys: each simulated transit router re-keys the
+      // frame with its encryption, the gateway pre-applies the matching
+      // decryptions exactly as Tunnel::EncryptTunnelMsg does
+      std::vector<core::TunnelEncryption> hop_encryption(hops);
+      std::vector<core::TunnelDecryption> gateway_decryption(hops);
+      for (std::size_t i = 0; i < hops; i++)
+        {
+          core::AESKey layer_key, iv_key;
+          core::RandBytes(layer_key, sizeof(core::AESKey));
+          core::RandBytes(iv_key, sizeof(core::AESKey));
+          hop_encryption[i].SetKeys(layer_key, iv_key);
+          gateway_decryption[i].SetKeys(layer_key, iv_key);
+        }
+      core::TunnelGatewayBuffer buffer(core::Rand<std::uint32_t>());
+      core::TunnelEndpoint endpoint(true);
+      core::TunnelMessageBlock block;
+      block.delivery_type = core::e_DeliveryTypeLocal;
+      block.tunnel_ID = 0;
+      for (std::size_t n = 0; n < count; n++)
+        {
+          block.data = CreatePayloadMessage(size);
+          TimePoint begin = std::chrono::high_resolution_clock::now();
+          buffer.PutI2NPMsg(std::move(block));
+          buffer.CompleteCurrentTunnelDataMessage();
+          for (auto msg : buffer.GetTunnelDataMsgs())
+            {
+              // innermost (last-hop) layer first, as the gateway stacks them
+              for (std::size_t i = hops; i-- > 0;)
+                gateway_decryption[i].Decrypt(
+                    msg->GetPayload() + 4, msg->GetPayload() + 4);
+              // one layer peeled back per simulated transit hop
+              for (std::size_t i = 0; i < hops; i++)
+                hop_encryption[i].Encrypt(
+                    msg->GetPayload() + 4, msg->GetPayload() + 4);
+              msg->FillI2NPMessageHeader(core::I2NPTunnelData);
+              endpoint.HandleDecryptedTunnelDataMsg(msg);
+            }
+          buffer.ClearTunnelDataMsgs();
+          TimePoint end = std::chrono::high_resolution_clock::now();
+          total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+              end - begin);
+        }
+      if (!endpoint.GetNumReceivedBytes())
+        LOG(warning) << GetName() << ": tunnel endpoint received nothing";
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("tunnel.pipeline", count, count * size, total);
+}
+
+void Simulation::RunGarlicEstablish(std::size_t count, std::size_t size)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds total(0);
+  try
+    {
+      SimDestination receiver;
+      auto routing_dest = std::make_shared<SimRoutingDestination>(receiver);
+      for (std::size_t n = 0; n < count; n++)
+        {
+          auto payload = CreatePayloadMessage(size);
+          TimePoint begin = std::chrono::high_resolution_clock::now();
+          // fresh session per message: every wrap pays the ElGamal block
+          core::GarlicRoutingSession session(nullptr, routing_dest, 0, false);
+          receiver.ProcessGarlicMessage(session.WrapSingleMessage(payload));
+          TimePoint end = std::chrono::high_resolution_clock::now();
+          total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+              end - begin);
+        }
+      if (receiver.GetDeliveredMsgs() != count)
+        LOG(warning) << GetName() << ": garlic delivered "
+                     << receiver.GetDeliveredMsgs() << " of " << count;
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("garlic.establish", count, count * size, total);
+}
+
+void Simulation::RunGarlicSession(std::size_t count, std::size_t size)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds total(0);
+  try
+    {
+      SimDestination receiver;
+      for (std::size_t n = 0; n < count; n++)
+        {
+          std::array<std::uint8_t, 32> key, tag;
+          core::RandBytes(key.data(), key.size());
+          core::RandBytes(tag.data(), tag.size());
+          auto payload = CreatePayloadMessage(size);
+          TimePoint begin = std::chrono::high_resolution_clock::now();
+          // pre-shared tag, the steady-state AES path on both sides
+          receiver.AddSessionKey(key.data(), tag.data());
+          core::GarlicRoutingSession session(key.data(), tag.data());
+          receiver.ProcessGarlicMessage(session.WrapSingleMessage(payload));
+          TimePoint end = std::chrono::high_resolution_clock::now();
+          total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+              end - begin);
+        }
+      if (receiver.GetDeliveredMsgs() != count)
+        LOG(warning) << GetName() << ": garlic delivered "
+                     << receiver.GetDeliveredMsgs() << " of " << count;
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("garlic.session", count, count * size, total);
+}
+
+void Simulation::RunEndToEnd(
+    std::size_t count,
+    std::size_t size,
+    std::size_t hops)
+{
+  typedef std::chrono::time_point<std::chrono::high_resolution_clock> TimePoint;
+  std::chrono::nanoseconds total(0);
+  try
+    {
+      std::vector<core::TunnelEncryption> hop_encryption(hops);
+      std::vector<core::TunnelDecryption> gateway_decryption(hops);
+      for (std::size_t i = 0; i < hops; i++)
+        {
+          core::AESKey layer_key, iv_key;
+          core::RandBytes(layer_key, sizeof(core::AESKey));
+          core::RandBytes(iv_key, sizeof(core::AESKey));
+          hop_encryption[i].SetKeys(layer_key, iv_key);
+          gateway_decryption[i].SetKeys(layer_key, iv_key);
+        }
+      core::TunnelGatewayBuffer buffer(core::Rand<std::uint32_t>());
+      core::TunnelEndpoint endpoint(true);
+      core::TunnelMessageBlock block;
+      block.delivery_type = core::e_DeliveryTypeLocal;
+      block.tunnel_ID = 0;
+      for (std::size_t n = 0; n < count; n++)
+        {
+          std::array<std::uint8_t, 32> key, tag;
+          core::RandBytes(key.data(), key.size());
+          core::RandBytes(tag.data(), tag.size());
+          auto payload = CreatePayloadMessage(size);
+          TimePoint begin = std::chrono::high_resolution_clock::now();
+          // the process's own router context is the receiving garlic
+          // destination: hand it the session key out of band, then the
+          // reassembled message unwraps there after the last hop
+          kovri::core::context.AddSessionKey(key.data(), tag.data());
+          core::GarlicRoutingSession garlic(key.data(), tag.data());
+          block.data = garlic.WrapSingleMessage(payload);
+          buffer.PutI2NPMsg(std::move(block));
+          buffer.CompleteCurrentTunnelDataMessage();
+          for (auto msg : buffer.GetTunnelDataMsgs())
+            {
+              for (std::size_t i = hops; i-- > 0;)
+                gateway_decryption[i].Decrypt(
+                    msg->GetPayload() + 4, msg->GetPayload() + 4);
+              for (std::size_t i = 0; i < hops; i++)
+                hop_encryption[i].Encrypt(
+                    msg->GetPayload() + 4, msg->GetPayload() + 4);
+              msg->FillI2NPMessageHeader(core::I2NPTunnelData);
+              endpoint.HandleDecryptedTunnelDataMsg(msg);
+            }
+          buffer.ClearTunnelDataMsgs();
+          TimePoint end = std::chrono::high_resolution_clock::now();
+          total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+              end - begin);
+        }
+      if (!endpoint.GetNumReceivedBytes())
+        LOG(warning) << GetName() << ": tunnel endpoint received nothing";
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return;
+    }
+  Record("end_to_end", count, count * size, total);
+}
+
+void Simulation::Record(
+    const std::string& name,
+    std::size_t messages,
+    std::size_t bytes,
+    const std::chrono::nanoseconds& total)
+{
+  m_Results.push_back(Result{name, messages, bytes, total});
+  // bytes per nanosecond scaled to megabytes per second
+  double const mb_per_sec =
+      total.count() ? bytes * 1000.0 / total.count() : 0;
+  LOG(info) << name << ": " << messages << " msgs (" << bytes << " bytes) in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(total)
+                   .count()
+            << " ms, "
+            << (messages
+                    ? std::chrono::duration_cast<std::chrono::microseconds>(
+                          total).count() / messages
+                    : 0)
+            << " us/msg, " << mb_per_sec << " MB/s";
+}
+
+void Simulation::WriteJSON(const std::string& path) const
+{
+  try
+    {
+      boost::property_tree::ptree results;
+      for (const auto& result : m_Results)
+        {
+          boost::property_tree::ptree entry;
+          entry.put("messages", result.messages);
+          entry.put("bytes", result.bytes);
+          entry.put("total_ns", result.total.count());
+          entry.put(
+              "ns_per_msg",
+              result.messages ? result.total.count() / result.messages : 0);
+          entry.put(
+              "mb_per_sec",
+              result.total.count()
+                  ? result.bytes * 1000.0 / result.total.count()
+                  : 0);
+          results.add_child(result.name, entry);
+        }
+      boost::property_tree::write_json(path, results);
+      LOG(info) << "Simulation: results written to " << path;
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+    }
+}
+
+void Simulation::PrintUsage(const std::string& name) const
+{
+  LOG(info) << name << ": " << m_Desc << std::endl;
+}
@@ -0,0 +1,115 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_UTIL_SIMULATION_H_
+#define SRC_UTIL_SIMULATION_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "util/command.h"
+
+/**
+ * @class Simulation
+ * @brief In-process message pipeline simulation
+ * @details Integration-level companion to the benchmark command: drives
+ *   whole messages through the real garlic, tunnel gateway, per-hop layer
+ *   crypto and endpoint reassembly components wired back to back in
+ *   memory, with per-hop key isolation standing in for remote routers.
+ *   No sockets or router threads are involved, so the numbers isolate the
+ *   message pipeline itself
+ */
+class Simulation : public Command
+{
+ public:
+  static const std::size_t DefaultMessageCount = 1000;
+  static const std::size_t DefaultPayloadSize = 2048;
+  static const std::size_t DefaultHopCount = 3;
+
+  /// @brief Timing result of one simulated pipeline
+  struct Result
+  {
+    std::string name;
+    std::size_t messages;
+    std::size_t bytes;
+    std::chrono::nanoseconds total;
+  };
+
+  Simulation();
+  boost::program_options::options_description m_Desc;
+
+  bool Impl(const std::string& path, const std::vector<std::string>& args);
+
+  void PrintUsage(const std::string& cmd_name) const;
+
+  /// @brief Run every pipeline with the configured parameters
+  void RunAll(std::size_t count, std::size_t size, std::size_t hops);
+
+  /// @brief Gateway fragmentation, per-hop layer crypto and endpoint
+  ///   reassembly of whole I2NP messages across a simulated tunnel
+  void RunTunnelPipeline(
+      std::size_t count,
+      std::size_t size,
+      std::size_t hops);
+
+  /// @brief Garlic wrap/unwrap with a fresh session per message
+  ///   (ElGamal establishment cost)
+  void RunGarlicEstablish(std::size_t count, std::size_t size);
+
+  /// @brief Garlic wrap/unwrap over pre-shared session tags
+  ///   (steady-state cost)
+  void RunGarlicSession(std::size_t count, std::size_t size);
+
+  /// @brief Full chain: garlic wrap, gateway fragmentation, per-hop layer
+  ///   crypto, endpoint reassembly and garlic unwrap at the router context
+  void RunEndToEnd(std::size_t count, std::size_t size, std::size_t hops);
+
+  /// @brief Log a pipeline result and keep it for JSON output
+  void Record(
+      const std::string& name,
+      std::size_t messages,
+      std::size_t bytes,
+      const std::chrono::nanoseconds& total);
+
+  /// @brief Write recorded results as JSON for comparison across releases
+  void WriteJSON(const std::string& path) const;
+
+  std::string GetName(void) const
+  {
+    return "simulation";
+  }
+
+ private:
+  std::vector<Result> m_Results;
+};
+
+#endif  // SRC_UTIL_SIMULATION_H_
@@ -0,0 +1,236 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "util/trace.h"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <set>
+#include <thread>
+
+#include "core/crypto/rand.h"
+#include "core/router/i2np.h"
+#include "core/router/transports/message_trace.h"
+#include "core/router/tunnel/impl.h"
+#include "core/router/tunnel/transit.h"
+#include "core/util/byte_stream.h"
+#include "core/util/exception.h"
+#include "core/util/log.h"
+
+namespace bpo = boost::program_options;
+namespace core = kovri::core;
+
+namespace {
+
+/// @brief Message types the tunnels dispatcher consumes; everything else
+///   in a trace is skipped during replay
+bool IsTunnelBound(std::uint8_t type_ID)
+{
+  switch (type_ID)
+    {
+      case core::I2NPTunnelData:
+      case core::I2NPTunnelGateway:
+      case core::I2NPVariableTunnelBuild:
+      case core::I2NPVariableTunnelBuildReply:
+      case core::I2NPTunnelBuild:
+      case core::I2NPTunnelBuildReply:
+        return true;
+      default:
+        return false;
+    }
+}
+
+}  // namespace
+
+TraceCommand::TraceCommand() : m_Desc("Options")
+{
+  m_Desc.add_options()("help,h", "produce this help message")
+     ("file,f", bpo::value<std::string>(), "message trace to read")
+     ("replay,r", bpo::bool_switch()->default_value(false),
+      "feed the trace through the tunnels dispatcher")
+     ("speed", bpo::value<double>()->default_value(1.0),
+      "pacing factor: 1 keeps captured gaps, 2 halves them, 0 = no pacing")
+     ("register-tunnels", bpo::bool_switch()->default_value(false),
+      "install transit participants for traced tunnel IDs so layer "
+      "crypto runs (relayed frames then queue at the stopped transports)");
+}
+
+bool TraceCommand::Impl(const std::string& cmd_name,
+    const std::vector<std::string>& args)
+{
+  bpo::variables_map vm;
+  try
+    {
+      bpo::parsed_options parsed =
+          bpo::command_line_parser(args).options(m_Desc).run();
+      bpo::store(parsed, vm);
+      bpo::notify(vm);
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+      return false;
+    }
+
+  if (vm.count("help") || !vm.count("file"))
+    {
+      PrintUsage(cmd_name);
+      return false;
+    }
+  const auto& path = vm["file"].as<std::string>();
+  if (vm["replay"].as<bool>())
+    return Replay(
+        path,
+        vm["speed"].as<double>(),
+        vm["register-tunnels"].as<bool>());
+  return Summarize(path);
+}
+
+bool TraceCommand::Summarize(const std::string& path)
+{
+  core::MessageTraceReader reader(path);
+  if (!reader.IsOpen())
+    return false;
+  core::MessageTraceRecord record;
+  std::size_t records = 0, bytes = 0, inbound = 0;
+  std::uint64_t first_ts = 0, last_ts = 0;
+  std::set<std::uint32_t> peers;
+  std::map<int, std::size_t> types;
+  while (reader.Read(record))
+    {
+      if (!records)
+        first_ts = record.timestamp;
+      last_ts = record.timestamp;
+      records++;
+      bytes += record.frame.size();
+      if (record.direction == core::MessageTrace::Inbound)
+        inbound++;
+      peers.insert(record.peer);
+      types[record.frame[core::I2NP_HEADER_TYPEID_OFFSET]]++;
+    }
+  LOG(info) << GetName() << ": " << records << " records (" << inbound
+            << " in, " << records - inbound << " out), " << bytes
+            << " bytes, " << peers.size() << " peers, "
+            << (last_ts - first_ts) << " ms span";
+  for (const auto& type : types)
+    LOG(info) << GetName() << ": type " << type.first << ": "
+              << type.second << " messages";
+  return records != 0;
+}
+
+bool TraceCommand::Replay(
+    const std::string& path,
+    double speed,
+    bool register_tunnels)
+{
+  typedef std::chrono::steady_clock Clock;
+  core::MessageTraceReader reader(path);
+  if (!reader.IsOpen())
+    return false;
+  kovri::core::tunnels.Start();
+  core::MessageTraceRecord record;
+  std::size_t posted = 0, skipped = 0, bytes = 0;
+  std::uint64_t first_ts = 0;
+  std::set<std::uint32_t> registered;
+  Clock::time_point start = Clock::now();
+  try
+    {
+      while (reader.Read(record))
+        {
+          std::uint8_t const type_ID =
+              record.frame[core::I2NP_HEADER_TYPEID_OFFSET];
+          if (!IsTunnelBound(type_ID))
+            {
+              skipped++;
+              continue;
+            }
+          if (!first_ts)
+            first_ts = record.timestamp;
+          if (speed > 0)
+            {
+              // captured inter-arrival gap, scaled
+              auto due = start + std::chrono::milliseconds(
+                  static_cast<std::uint64_t>(
+                      (record.timestamp - first_ts) / speed));
+              std::this_thread::sleep_until(due);
+            }
+          if (register_tunnels
+              && (type_ID == core::I2NPTunnelData
+                  || type_ID == core::I2NPTunnelGateway))
+            {
+              std::uint32_t const tunnel_ID =
+                  core::InputByteStream::Read<std::uint32_t>(
+                      record.frame.data() + core::I2NP_HEADER_SIZE);
+              if (registered.insert(tunnel_ID).second)
+                {
+                  // key-isolated stand-in for the traced hop; the next
+                  // ident is random, so relayed frames sink at the
+                  // (stopped) transports after paying for layer crypto
+                  std::array<std::uint8_t, 32> next_ident, layer_key, iv_key;
+                  core::RandBytes(next_ident.data(), next_ident.size());
+                  core::RandBytes(layer_key.data(), layer_key.size());
+                  core::RandBytes(iv_key.data(), iv_key.size());
+                  kovri::core::tunnels.AddTransitTunnel(
+                      new core::TransitTunnelParticipant(
+                          tunnel_ID,
+                          next_ident.data(),
+                          core::Rand<std::uint32_t>(),
+                          layer_key.data(),
+                          iv_key.data()));
+                }
+            }
+          kovri::core::tunnels.PostTunnelData(core::CreateI2NPMessage(
+              record.frame.data(), record.frame.size()));
+          posted++;
+          bytes += record.frame.size();
+        }
+    }
+  catch (...)
+    {
+      kovri::core::Exception ex(GetName().c_str());
+      ex.Dispatch(__func__);
+    }
+  // let the dispatcher drain before tearing it down
+  std::this_thread::sleep_for(std::chrono::seconds(2));
+  kovri::core::tunnels.Stop();
+  auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      Clock::now() - start).count();
+  LOG(info) << GetName() << ": replayed " << posted << " messages ("
+            << bytes << " bytes, " << skipped << " skipped) in "
+            << elapsed << " ms";
+  return posted != 0;
+}
+
+void TraceCommand::PrintUsage(const std::string& name) const
+{
+  LOG(info) << name << ": " << m_Desc << std::endl;
+}
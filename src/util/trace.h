@@ -0,0 +1,75 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#ifndef SRC_UTIL_TRACE_H_
+#define SRC_UTIL_TRACE_H_
+
+#include <string>
+#include <vector>
+
+#include "util/command.h"
+
+/**
+ * @class TraceCommand
+ * @brief Inspect and replay message traces captured with the router's
+ *   message-trace option
+ * @details Without --replay the trace is summarized (record, peer, byte
+ *   and per-type counts). With --replay the tunnel-bound frames are fed
+ *   through Tunnels::PostTunnelData at the captured pacing (or scaled by
+ *   --speed), reproducing a production message mix on a bench box
+ */
+class TraceCommand : public Command
+{
+ public:
+  TraceCommand();
+  boost::program_options::options_description m_Desc;
+
+  bool Impl(const std::string& path, const std::vector<std::string>& args);
+
+  void PrintUsage(const std::string& cmd_name) const;
+
+  /// @brief Prints record/peer/byte counts and the per-type breakdown
+  bool Summarize(const std::string& path);
+
+  /// @brief Feeds the trace through the tunnels dispatcher
+  /// @param speed Pacing factor; 1 keeps the captured gaps, 2 halves
+  ///   them, 0 posts as fast as possible
+  /// @param register_tunnels Install key-isolated transit participants
+  ///   for every tunnel ID in the trace so layer crypto runs instead of
+  ///   the not-found drop path
+  bool Replay(const std::string& path, double speed, bool register_tunnels);
+
+  std::string GetName(void) const
+  {
+    return "trace";
+  }
+};
+
+#endif  // SRC_UTIL_TRACE_H_
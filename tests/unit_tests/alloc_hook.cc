@@ -0,0 +1,120 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+// Global operator new/delete interposition for the test binary: every
+// heap allocation in the process is reported to core::AllocTracker, so
+// tests can assert that a warmed-up hot path performs none. Tracking is
+// per-thread and off by default; with no AllocTrackerScope active these
+// operators are a plain malloc/free shim.
+
+#include <cstdlib>
+#include <new>
+
+#include "core/util/alloc_tracker.h"
+
+// The caller of operator new, for AllocTracker's captured sites
+#if defined(__GNUC__)
+#define KOVRI_ALLOC_SITE __builtin_return_address(0)
+#else
+#define KOVRI_ALLOC_SITE nullptr
+#endif
+
+namespace
+{
+void* TrackedAlloc(const std::size_t size, const void* site) noexcept
+{
+  kovri::core::AllocTracker::RecordAllocation(size, site);
+  return std::malloc(size ? size : 1);
+}
+
+void TrackedFree(void* ptr) noexcept
+{
+  if (!ptr)
+    return;
+  kovri::core::AllocTracker::RecordDeallocation();
+  std::free(ptr);
+}
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+  void* ptr = TrackedAlloc(size, KOVRI_ALLOC_SITE);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+  void* ptr = TrackedAlloc(size, KOVRI_ALLOC_SITE);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return TrackedAlloc(size, KOVRI_ALLOC_SITE);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return TrackedAlloc(size, KOVRI_ALLOC_SITE);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  TrackedFree(ptr);
+}
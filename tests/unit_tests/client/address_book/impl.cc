@@ -51,7 +51,8 @@ struct SubscriptionFixture {
     std::stringstream stream;
     for (auto const& l : lines)
       stream << l << "\n";
-    return book.ValidateSubscription(stream);
+    num_known = 0;
+    return book.ValidateSubscription(stream, num_known);
   }
 
   /// @brief Compares and validates lines against subscription fixture
@@ -80,6 +81,9 @@ struct SubscriptionFixture {
   /// @brief Test data to verify against Host=Address
   std::vector<std::string> lines;
 
+  /// @brief Count of entries the last validation skipped as already loaded
+  std::size_t num_known{};
+
   /// @brief Addressbook instance
   kovri::client::AddressBook book;
 };
@@ -123,6 +127,21 @@ BOOST_AUTO_TEST_CASE(BadAddresses) {
   BOOST_CHECK(Validate());
 }
 
+// Entries already loaded into the book must be skipped (and counted)
+// instead of re-validated and re-decoded
+BOOST_AUTO_TEST_CASE(KnownHostsSkipped) {
+  auto const parsed = Validate(subscription);
+  BOOST_CHECK_EQUAL(num_known, 0);
+  BOOST_CHECK_EQUAL(parsed.size(), subscription.size());
+  for (auto const& address : parsed)
+    book.InsertAddress(
+        address.first,
+        address.second.GetIdentHash(),
+        kovri::client::SubscriptionType::Default);
+  BOOST_CHECK(Validate(subscription).empty());
+  BOOST_CHECK_EQUAL(num_known, subscription.size());
+}
+
 BOOST_AUTO_TEST_CASE(GarbageLines) {
   for (std::size_t i = 0; i < subscription.size(); i++) {
     std::array<std::uint8_t, 100> rand;
@@ -162,6 +162,52 @@ BOOST_AUTO_TEST_CASE(ValidLoadSubscription)
   BOOST_CHECK(m_Addresses.size() == m_Hosts.size());
 }
 
+BOOST_AUTO_TEST_CASE(ValidBinaryCacheRoundTrip)
+{
+  // Check we have a storage instance
+  BOOST_CHECK(m_Storage);
+
+  // Ensure successful address insertion
+  BOOST_CHECK_NO_THROW(ToAddressMap(SubscriptionType::Default));
+
+  // Ensure addresses written to the binary cache
+  BOOST_CHECK_NO_THROW(saved_addresses = m_Storage->SaveBinaryCache(m_Addresses));
+  BOOST_CHECK(saved_addresses == m_Hosts.size());
+
+  // Keep original entries to compare against the loaded cache
+  const auto expected = m_Addresses;
+
+  // Reset the address map
+  m_Addresses.clear();
+
+  // Ensure addresses loaded from the binary cache
+  BOOST_CHECK_NO_THROW(m_Storage->LoadBinaryCache(m_Addresses));
+  BOOST_CHECK(m_Addresses.size() == m_Hosts.size());
+
+  // Ensure loaded entries match the saved entries
+  for (const auto& entry : expected)
+    {
+      const auto it = m_Addresses.find(entry.first);
+      BOOST_CHECK(it != m_Addresses.end());
+      BOOST_CHECK(
+          std::get<core::IdentHash>(it->second)
+          == std::get<core::IdentHash>(entry.second));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InvalidLoadBinaryCache)
+{
+  // Check we have a storage instance
+  BOOST_CHECK(m_Storage);
+
+  // Load from a non-existent binary cache
+  std::size_t loaded_addresses{};
+  BOOST_CHECK_NO_THROW(loaded_addresses = m_Storage->LoadBinaryCache(m_Addresses));
+
+  // Ensure no addresses are loaded
+  BOOST_CHECK(!loaded_addresses && m_Addresses.empty());
+}
+
 BOOST_AUTO_TEST_CASE(InvalidLoadSubscription)
 {
   // Check we have a storage instance
@@ -230,6 +230,7 @@ struct I2PControlRouterManagerFixture : public I2PControlSessionFixture
       "{\"id\":123,\"method\":\"RouterManager\",\"params\":{"
       "\"Token\":\"some_token\","
       "\"FindUpdates\":null,"
+      "\"ReloadTunnelsConfig\":null,"
       "\"Reseed\":null,"
       "\"Restart\":null,"
       "\"RestartGraceful\":null,"
@@ -242,6 +243,7 @@ struct I2PControlRouterManagerFixture : public I2PControlSessionFixture
   std::string m_RouterManagerResponse{
       "{\"id\":123,\"result\":{"
       "\"FindUpdates\":false,"
+      "\"ReloadTunnelsConfig\":null,"
       "\"Reseed\":null,"
       "\"Restart\":null,"
       "\"RestartGraceful\":null,"
@@ -639,6 +641,7 @@ BOOST_AUTO_TEST_CASE(WriteRouterManagerRequest)
   // Set specific params
   std::string empty;
   request.SetParam(RouterManager::FindUpdates, empty);
+  request.SetParam(RouterManager::ReloadTunnelsConfig, empty);
   request.SetParam(RouterManager::Reseed, empty);
   request.SetParam(RouterManager::Restart, empty);
   request.SetParam(RouterManager::RestartGraceful, empty);
@@ -676,6 +679,7 @@ BOOST_AUTO_TEST_CASE(WriteRouterManagerResponse)
   response.SetMethod(Method::RouterManager);
   // Set specific params
   response.SetParam(RouterManager::FindUpdates, false);
+  response.SetParam(RouterManager::ReloadTunnelsConfig, empty);
   response.SetParam(RouterManager::Reseed, empty);
   response.SetParam(RouterManager::Restart, empty);
   response.SetParam(RouterManager::RestartGraceful, empty);
@@ -0,0 +1,83 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+#include "client/service.h"
+
+BOOST_AUTO_TEST_SUITE(HandlerMemoryPoolTests)
+
+// A released block of the same size must be handed back on the next
+// acquire, so a steady connection rate stops hitting the heap
+BOOST_AUTO_TEST_CASE(ReusesReleasedBlocks) {
+  kovri::client::HandlerMemoryPool pool;
+  void* first = pool.Acquire(128);
+  BOOST_CHECK(first != nullptr);
+  pool.Release(first, 128);
+  BOOST_CHECK_EQUAL(pool.Acquire(128), first);
+  pool.Release(first, 128);
+}
+
+// Distinct sizes get distinct buckets; a block is only reused verbatim
+BOOST_AUTO_TEST_CASE(KeepsSizesApart) {
+  kovri::client::HandlerMemoryPool pool;
+  void* small = pool.Acquire(64);
+  void* large = pool.Acquire(256);
+  pool.Release(small, 64);
+  pool.Release(large, 256);
+  BOOST_CHECK_EQUAL(pool.Acquire(256), large);
+  BOOST_CHECK_EQUAL(pool.Acquire(64), small);
+  pool.Release(small, 64);
+  pool.Release(large, 256);
+}
+
+// allocate_shared through the allocator recycles the combined
+// object-plus-control-block allocation across construct/destroy cycles
+BOOST_AUTO_TEST_CASE(AllocatorRecyclesSharedObjects) {
+  auto pool = std::make_shared<kovri::client::HandlerMemoryPool>();
+  struct Payload {
+    explicit Payload(int v) : value(v) {}
+    int value;
+  };
+  auto first = std::allocate_shared<Payload>(
+      kovri::client::HandlerAllocator<Payload>(pool), 1);
+  auto* address = first.get();
+  first.reset();
+  auto second = std::allocate_shared<Payload>(
+      kovri::client::HandlerAllocator<Payload>(pool), 2);
+  BOOST_CHECK_EQUAL(second.get(), address);
+  BOOST_CHECK_EQUAL(second->value, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ * Parts of the project are originally copyright (c) 2013-2015 The PurpleI2P Project          //
+ */
+
+#include "tests/unit_tests/main.h"
+
+#include <array>
+#include <vector>
+
+#include "core/crypto/aead.h"
+#include "core/crypto/rand.h"
+#include "core/crypto/x25519.h"
+
+BOOST_AUTO_TEST_SUITE(AEADTests)
+
+struct AEADFixture {
+  AEADFixture() {
+    kovri::core::RandBytes(key.data(), key.size());
+    kovri::core::RandBytes(nonce.data(), nonce.size());
+    encryption.SetKey(key.data());
+    decryption.SetKey(key.data());
+  }
+  std::array<std::uint8_t, kovri::core::AEADSize::Key> key;
+  std::array<std::uint8_t, kovri::core::AEADSize::Nonce> nonce;
+  kovri::core::AEADEncryption encryption;
+  kovri::core::AEADDecryption decryption;
+};
+
+BOOST_FIXTURE_TEST_CASE(SealOpenRoundTrip, AEADFixture) {
+  const std::vector<std::uint8_t> payload(1000, 0xAB);
+  const std::array<std::uint8_t, 4> ad {{ 1, 2, 3, 4 }};
+  std::vector<std::uint8_t> sealed(payload.size() + kovri::core::AEADSize::Tag);
+  encryption.Encrypt(
+      nonce.data(), ad.data(), ad.size(),
+      payload.data(), payload.size(), sealed.data());
+  std::vector<std::uint8_t> opened(payload.size());
+  BOOST_CHECK(
+      decryption.Decrypt(
+          nonce.data(), ad.data(), ad.size(),
+          sealed.data(), sealed.size(), opened.data()));
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      payload.begin(), payload.end(),
+      opened.begin(), opened.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(TamperedCiphertextRejected, AEADFixture) {
+  const std::vector<std::uint8_t> payload(64, 0xCD);
+  std::vector<std::uint8_t> sealed(payload.size() + kovri::core::AEADSize::Tag);
+  encryption.Encrypt(
+      nonce.data(), nullptr, 0,
+      payload.data(), payload.size(), sealed.data());
+  sealed[10] ^= 1;
+  std::vector<std::uint8_t> opened(payload.size());
+  BOOST_CHECK(
+      !decryption.Decrypt(
+          nonce.data(), nullptr, 0,
+          sealed.data(), sealed.size(), opened.data()));
+}
+
+BOOST_FIXTURE_TEST_CASE(TamperedADRejected, AEADFixture) {
+  const std::vector<std::uint8_t> payload(64, 0xCD);
+  std::array<std::uint8_t, 4> ad {{ 1, 2, 3, 4 }};
+  std::vector<std::uint8_t> sealed(payload.size() + kovri::core::AEADSize::Tag);
+  encryption.Encrypt(
+      nonce.data(), ad.data(), ad.size(),
+      payload.data(), payload.size(), sealed.data());
+  ad[0] ^= 1;
+  std::vector<std::uint8_t> opened(payload.size());
+  BOOST_CHECK(
+      !decryption.Decrypt(
+          nonce.data(), ad.data(), ad.size(),
+          sealed.data(), sealed.size(), opened.data()));
+}
+
+BOOST_FIXTURE_TEST_CASE(TruncatedInputRejected, AEADFixture) {
+  std::array<std::uint8_t, 8> short_input {{}};
+  std::array<std::uint8_t, 8> out {{}};
+  BOOST_CHECK(
+      !decryption.Decrypt(
+          nonce.data(), nullptr, 0,
+          short_input.data(), short_input.size(), out.data()));
+}
+
+BOOST_AUTO_TEST_CASE(X25519AgreementMatches) {
+  kovri::core::X25519KeysPair alice, bob;
+  kovri::core::X25519::GenerateKeyPair(
+      alice.private_key.data(), alice.public_key.data());
+  kovri::core::X25519::GenerateKeyPair(
+      bob.private_key.data(), bob.public_key.data());
+  std::array<std::uint8_t, kovri::core::X25519Size::SharedKey> k1, k2;
+  BOOST_CHECK(
+      kovri::core::X25519::Agree(
+          k1.data(), alice.private_key.data(), bob.public_key.data()));
+  BOOST_CHECK(
+      kovri::core::X25519::Agree(
+          k2.data(), bob.private_key.data(), alice.public_key.data()));
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      k1.begin(), k1.end(), k2.begin(), k2.end());
+}
+
+BOOST_AUTO_TEST_CASE(X25519RejectsZeroPoint) {
+  kovri::core::X25519KeysPair alice;
+  kovri::core::X25519::GenerateKeyPair(
+      alice.private_key.data(), alice.public_key.data());
+  const std::array<std::uint8_t, kovri::core::X25519Size::PubKey> zero {{}};
+  std::array<std::uint8_t, kovri::core::X25519Size::SharedKey> k;
+  BOOST_CHECK(
+      !kovri::core::X25519::Agree(
+          k.data(), alice.private_key.data(), zero.data()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -112,4 +112,20 @@ BOOST_FIXTURE_TEST_CASE(ElgamalEncryptDecryptZeroPadSmallMessageSuccess, Elgamal
     result, result + key_message_len - key_smaller);
 }
 
+BOOST_FIXTURE_TEST_CASE(ElgamalPrecomputedEncryptDecryptSuccess, ElgamalFixture) {
+  // Encryption built from a precomputed (k, g^k) pair must round-trip
+  kovri::core::PrecomputeElGamal(2);
+  BOOST_CHECK_GE(kovri::core::GetNumPrecomputedElGamal(), 1);
+  kovri::core::ElGamalEncryption precomputed(public_key);
+  uint8_t plaintext[key_message_len];
+  uint8_t ciphertext[key_ciphertext_len];
+  uint8_t result[key_message_len];
+  kovri::core::RandBytes(plaintext, key_message_len);
+  precomputed.Encrypt(plaintext, key_message_len, ciphertext, false);
+  BOOST_CHECK(kovri::core::ElGamalDecrypt(private_key, ciphertext, result, false));
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    plaintext, plaintext + key_message_len,
+    result, result + key_message_len);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -30,9 +30,12 @@
 
 #include "tests/unit_tests/main.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <numeric>
 #include <stdexcept>
+#include <vector>
 
 #include "core/crypto/rand.h"
 
@@ -127,3 +130,34 @@ BOOST_AUTO_TEST_CASE(Outer) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(FastRand)
+
+BOOST_AUTO_TEST_CASE(InRangeBounds) {
+  for (std::uint32_t i = 0; i < 1000; i++) {
+    std::uint32_t const result = kovri::core::FastRandInRange32(3, 8);
+    BOOST_REQUIRE(result >= 3 && result <= 8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NotStuck) {
+  std::uint64_t last = kovri::core::FastRand64(), repeated = 0;
+  for (std::uint32_t i = 0; i < 100; i++) {
+    std::uint64_t const result = kovri::core::FastRand64();
+    if (result == last)
+      repeated++;
+    last = result;
+  }
+  BOOST_CHECK_EQUAL(repeated, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ShuffleIsPermutation) {
+  std::vector<std::uint32_t> values(64);
+  std::iota(values.begin(), values.end(), 0);
+  kovri::core::FastShuffle(values.begin(), values.end());
+  std::sort(values.begin(), values.end());
+  for (std::uint32_t i = 0; i < values.size(); i++)
+    BOOST_REQUIRE_EQUAL(values.at(i), i);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,98 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "core/crypto/util/checksum.h"
+
+namespace {
+
+/// @brief Textbook byte-at-a-time Adler-32, the reference for the kernels
+std::uint32_t ReferenceAdler32(const std::uint8_t* input, std::size_t length) {
+  std::uint32_t s1 = 1, s2 = 0;
+  for (std::size_t i = 0; i < length; i++) {
+    s1 = (s1 + input[i]) % 65521;
+    s2 = (s2 + s1) % 65521;
+  }
+  return (s2 << 16) | s1;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Adler32Checksum);
+
+BOOST_AUTO_TEST_CASE(KnownVectors) {
+  const std::uint8_t wikipedia[] = "Wikipedia";
+  BOOST_CHECK_EQUAL(
+      kovri::core::Adler32Digest(wikipedia, sizeof(wikipedia) - 1),
+      0x11E60398);
+  // Empty input is the initial state
+  BOOST_CHECK_EQUAL(kovri::core::Adler32Digest(wikipedia, 0), 1);
+}
+
+// Lengths straddling the kernels' internal chunking (32-byte blocks,
+// 5536/5552-byte reductions) must all agree with the reference
+BOOST_AUTO_TEST_CASE(MatchesReferenceAcrossLengths) {
+  std::vector<std::uint8_t> buf(20000);
+  for (std::size_t i = 0; i < buf.size(); i++)
+    buf[i] = static_cast<std::uint8_t>(i * 197 + 91);
+  const std::size_t lengths[] =
+      {1, 7, 31, 32, 33, 63, 64, 65, 5535, 5536, 5537, 5551, 5552, 5553,
+       11072, 20000};
+  for (const auto length : lengths)
+    BOOST_CHECK_EQUAL(
+        kovri::core::Adler32Digest(buf.data(), length),
+        ReferenceAdler32(buf.data(), length));
+}
+
+BOOST_AUTO_TEST_CASE(DigestRoundTrip) {
+  std::vector<std::uint8_t> buf(997);
+  for (std::size_t i = 0; i < buf.size(); i++)
+    buf[i] = static_cast<std::uint8_t>(i);
+  std::uint8_t digest[4];
+  kovri::core::Adler32 adler;
+  adler.CalculateDigest(digest, buf.data(), buf.size());
+  // Big-endian wire layout of (s2 << 16) | s1
+  const std::uint32_t expected = ReferenceAdler32(buf.data(), buf.size());
+  BOOST_CHECK_EQUAL(digest[0], (expected >> 24) & 0xFF);
+  BOOST_CHECK_EQUAL(digest[1], (expected >> 16) & 0xFF);
+  BOOST_CHECK_EQUAL(digest[2], (expected >> 8) & 0xFF);
+  BOOST_CHECK_EQUAL(digest[3], expected & 0xFF);
+  BOOST_CHECK(adler.VerifyDigest(digest, buf.data(), buf.size()));
+  digest[3] ^= 0x01;
+  BOOST_CHECK(!adler.VerifyDigest(digest, buf.data(), buf.size()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
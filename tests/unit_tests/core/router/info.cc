@@ -30,6 +30,11 @@
 
 #include "tests/unit_tests/main.h"
 
+#include <array>
+
+#include "core/crypto/radix.h"
+#include "core/crypto/rand.h"
+
 #include "core/router/identity.h"
 #include "core/router/info.h"
 
@@ -155,6 +160,34 @@ BOOST_AUTO_TEST_CASE(GetAddressIPv6only)
   BOOST_CHECK_EQUAL(ri.GetAnyAddress(true, Transport::SSU)->host.is_v6(), true);
 }
 
+BOOST_AUTO_TEST_CASE(GarlicX25519KeyOption)
+{
+  core::RouterInfo ri(keys, {{"127.0.0.1", 12345}}, {true, true});
+
+  // No key published
+  BOOST_CHECK(ri.GetX25519StaticKey() == nullptr);
+
+  // Publish a key and round-trip through the wire format
+  std::array<std::uint8_t, 32> key;
+  core::RandBytes(key.data(), key.size());
+  ri.SetOption(
+      GetTrait(Trait::GarlicKey), core::Base64::Encode(key.data(), key.size()));
+  ri.CreateBuffer(keys);
+
+  core::RouterInfo parsed(ri.data(), ri.size());
+  BOOST_REQUIRE(parsed.GetX25519StaticKey() != nullptr);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      key.begin(), key.end(),
+      parsed.GetX25519StaticKey(), parsed.GetX25519StaticKey() + key.size());
+
+  // Malformed values are ignored
+  core::RouterInfo bad(keys, {{"127.0.0.1", 12345}}, {true, true});
+  bad.SetOption(GetTrait(Trait::GarlicKey), "too-short");
+  bad.CreateBuffer(keys);
+  core::RouterInfo bad_parsed(bad.data(), bad.size());
+  BOOST_CHECK(bad_parsed.GetX25519StaticKey() == nullptr);
+}
+
 // TODO(unassigned): expand test cases
 
 BOOST_AUTO_TEST_SUITE_END()
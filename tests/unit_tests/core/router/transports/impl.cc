@@ -0,0 +1,106 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "tests/unit_tests/main.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "core/router/i2np.h"
+#include "core/router/transports/impl.h"
+
+struct DelayedQueueFixture
+{
+  /// @brief Builds a message of the given type, tagged with msg_ID so
+  ///   tests can tell queued messages apart
+  std::shared_ptr<core::I2NPMessage> MakeMsg(
+      core::I2NPMessageType type,
+      std::uint32_t msg_ID = 1)
+  {
+    auto msg = core::ToSharedI2NPMessage(core::NewI2NPShortMessage());
+    msg->FillI2NPMessageHeader(type, msg_ID);
+    return msg;
+  }
+
+  core::Peer peer;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TransportDelayedQueue, DelayedQueueFixture)
+
+BOOST_AUTO_TEST_CASE(QueueIsBounded)
+{
+  for (std::size_t i = 0; i < 2 * core::DELAYED_MESSAGE_LIMIT; i++)
+    peer.QueueDelayed(MakeMsg(core::I2NPTunnelData));
+  BOOST_CHECK_EQUAL(
+      peer.delayed_messages.size(), core::DELAYED_MESSAGE_LIMIT);
+  BOOST_CHECK(peer.IsBacklogged());
+}
+
+BOOST_AUTO_TEST_CASE(OldestBulkEvictedFirst)
+{
+  for (std::size_t i = 0; i < core::DELAYED_MESSAGE_LIMIT; i++)
+    peer.QueueDelayed(MakeMsg(core::I2NPTunnelData, i + 1));
+  // admitting another bulk message sheds the oldest one
+  BOOST_CHECK(peer.QueueDelayed(
+      MakeMsg(core::I2NPTunnelData, core::DELAYED_MESSAGE_LIMIT + 1)));
+  BOOST_CHECK_EQUAL(peer.delayed_messages.front()->GetMsgID(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ControlDisplacesBulk)
+{
+  for (std::size_t i = 0; i < core::DELAYED_MESSAGE_LIMIT; i++)
+    peer.QueueDelayed(MakeMsg(core::I2NPTunnelData));
+  BOOST_CHECK(peer.QueueDelayed(MakeMsg(core::I2NPDeliveryStatus)));
+  BOOST_CHECK_EQUAL(
+      peer.delayed_messages.size(), core::DELAYED_MESSAGE_LIMIT);
+  BOOST_CHECK_EQUAL(
+      peer.delayed_messages.back()->GetTypeID(), core::I2NPDeliveryStatus);
+}
+
+BOOST_AUTO_TEST_CASE(ControlNeverDropped)
+{
+  for (std::size_t i = 0; i < core::DELAYED_MESSAGE_LIMIT; i++)
+    peer.QueueDelayed(MakeMsg(core::I2NPDeliveryStatus));
+  // nothing expendable to evict, but control still rides
+  BOOST_CHECK(peer.QueueDelayed(MakeMsg(core::I2NPDeliveryStatus)));
+  BOOST_CHECK_EQUAL(
+      peer.delayed_messages.size(), core::DELAYED_MESSAGE_LIMIT + 1);
+}
+
+BOOST_AUTO_TEST_CASE(BulkShedAgainstFullControlQueue)
+{
+  for (std::size_t i = 0; i < core::DELAYED_MESSAGE_LIMIT; i++)
+    peer.QueueDelayed(MakeMsg(core::I2NPDeliveryStatus));
+  BOOST_CHECK(!peer.QueueDelayed(MakeMsg(core::I2NPTunnelData)));
+  BOOST_CHECK_EQUAL(
+      peer.delayed_messages.size(), core::DELAYED_MESSAGE_LIMIT);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
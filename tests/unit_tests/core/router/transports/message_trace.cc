@@ -0,0 +1,137 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "tests/unit_tests/main.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "core/crypto/rand.h"
+#include "core/router/i2np.h"
+#include "core/router/transports/message_trace.h"
+
+struct MessageTraceFixture
+{
+  MessageTraceFixture()
+  {
+    trace_path = (boost::filesystem::temp_directory_path()
+                  / boost::filesystem::unique_path()).string();
+    core::RandBytes(alice(), alice.size());
+    core::RandBytes(bob(), bob.size());
+  }
+
+  ~MessageTraceFixture()
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove(trace_path, ec);
+  }
+
+  /// @brief Builds a complete message of the given type
+  std::shared_ptr<core::I2NPMessage> MakeMsg(core::I2NPMessageType type)
+  {
+    auto msg = core::ToSharedI2NPMessage(core::NewI2NPShortMessage());
+    msg->FillI2NPMessageHeader(type);
+    return msg;
+  }
+
+  std::string trace_path;
+  core::IdentHash alice, bob;
+  core::MessageTrace trace;
+};
+
+BOOST_FIXTURE_TEST_SUITE(MessageTraceTests, MessageTraceFixture)
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  BOOST_REQUIRE(trace.Start(trace_path));
+  auto data = MakeMsg(core::I2NPData);
+  auto status = MakeMsg(core::I2NPDeliveryStatus);
+  trace.Record(core::MessageTrace::Inbound, alice, *data);
+  trace.Record(core::MessageTrace::Outbound, bob, *status);
+  trace.Record(core::MessageTrace::Outbound, alice, *data);
+  trace.Stop();
+
+  core::MessageTraceReader reader(trace_path);
+  BOOST_REQUIRE(reader.IsOpen());
+  core::MessageTraceRecord record;
+
+  // peer numbers follow first-seen order, so alice is 1 and bob is 2
+  BOOST_REQUIRE(reader.Read(record));
+  BOOST_CHECK_EQUAL(record.peer, 1);
+  BOOST_CHECK_EQUAL(record.direction, core::MessageTrace::Inbound);
+  BOOST_REQUIRE_EQUAL(record.frame.size(), data->GetLength());
+  BOOST_CHECK_EQUAL(
+      std::memcmp(record.frame.data(), data->GetBuffer(), data->GetLength()),
+      0);
+
+  BOOST_REQUIRE(reader.Read(record));
+  BOOST_CHECK_EQUAL(record.peer, 2);
+  BOOST_CHECK_EQUAL(record.direction, core::MessageTrace::Outbound);
+  BOOST_CHECK_EQUAL(
+      record.frame[core::I2NP_HEADER_TYPEID_OFFSET],
+      core::I2NPDeliveryStatus);
+
+  BOOST_REQUIRE(reader.Read(record));
+  BOOST_CHECK_EQUAL(record.peer, 1);  // alice keeps her number
+
+  // clean end of trace
+  BOOST_CHECK(!reader.Read(record));
+}
+
+BOOST_AUTO_TEST_CASE(RecordAfterStopIsDropped)
+{
+  BOOST_REQUIRE(trace.Start(trace_path));
+  trace.Record(core::MessageTrace::Inbound, alice, *MakeMsg(core::I2NPData));
+  trace.Stop();
+  BOOST_CHECK(!trace.IsEnabled());
+  trace.Record(core::MessageTrace::Inbound, bob, *MakeMsg(core::I2NPData));
+
+  core::MessageTraceReader reader(trace_path);
+  BOOST_REQUIRE(reader.IsOpen());
+  core::MessageTraceRecord record;
+  BOOST_CHECK(reader.Read(record));
+  BOOST_CHECK(!reader.Read(record));
+}
+
+BOOST_AUTO_TEST_CASE(RejectsForeignFile)
+{
+  std::ofstream file(trace_path, std::ofstream::binary);
+  file << "not a trace";
+  file.close();
+  core::MessageTraceReader reader(trace_path);
+  BOOST_CHECK(!reader.IsOpen());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "tests/unit_tests/main.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "client/api/streaming.h"
+
+#include "core/router/i2np.h"
+#include "core/router/tunnel/transit.h"
+
+#include "core/util/alloc_tracker.h"
+
+BOOST_AUTO_TEST_SUITE(AllocTrackerTests)
+
+BOOST_AUTO_TEST_CASE(CountsAllocationsWithinScope)
+{
+  core::AllocStats stats;
+  {
+    core::AllocTrackerScope scope;
+    auto* buf = new std::uint8_t[64];
+    delete[] buf;
+    stats = core::AllocTracker::GetStats();
+  }
+  BOOST_CHECK_GE(stats.allocations, 1u);
+  BOOST_CHECK_GE(stats.deallocations, 1u);
+  BOOST_CHECK_GE(stats.bytes, 64u);
+  BOOST_CHECK_GE(core::AllocTracker::GetCapturedCount(), 1u);
+  BOOST_CHECK_GE(core::AllocTracker::GetCapturedSize(0), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(ScopeEndStopsCounting)
+{
+  {
+    core::AllocTrackerScope scope;
+  }
+  auto* buf = new std::uint8_t[64];
+  delete[] buf;
+  BOOST_CHECK_EQUAL(core::AllocTracker::GetStats().allocations, 0u);
+  BOOST_CHECK(!core::AllocTracker::IsEnabled());
+}
+
+// Regression gate: relaying a tunnel-data message through a warmed-up
+// transit participant must not touch the heap. Messages come from the
+// I2NP pool and the pending-message vector keeps its capacity, so in
+// steady state the per-message cost is pointer work only.
+BOOST_AUTO_TEST_CASE(TransitParticipantSteadyStateIsAllocationFree)
+{
+  std::uint8_t ident[32] = {};
+  std::uint8_t layer_key[32] = {};
+  std::uint8_t iv_key[32] = {};
+  core::TransitTunnelParticipant participant(
+      1, ident, 2, layer_key, iv_key);
+
+  // Warm up: pre-build pooled messages and grow the pending vector past
+  // any growth boundary the measured message could hit
+  std::vector<std::shared_ptr<core::I2NPMessage>> msgs;
+  for (std::size_t i = 0; i < 8; i++)
+    msgs.push_back(core::CreateEmptyTunnelDataMsg());
+  for (std::size_t i = 0; i < 7; i++)
+    participant.HandleTunnelDataMsg(msgs[i]);
+
+  core::AllocStats stats;
+  {
+    core::AllocTrackerScope scope;
+    participant.HandleTunnelDataMsg(msgs[7]);
+    stats = core::AllocTracker::GetStats();
+  }
+  BOOST_CHECK_EQUAL(stats.allocations, 0u);
+  BOOST_CHECK_EQUAL(stats.bytes, 0u);
+}
+
+// Regression gate: the streaming send/receive buffering loops recycle
+// packets and send segments, so a warmed-up cycle is allocation-free
+BOOST_AUTO_TEST_CASE(StreamingBuffersSteadyStateAreAllocationFree)
+{
+  client::PacketPool pool;
+  client::SendBufferQueue queue;
+  std::uint8_t data[1024] = {};
+  std::uint8_t drained[1024];
+
+  // Warm up: put one packet on the free list and cycle one send segment
+  // through the queue's free list
+  pool.Release(pool.Acquire());
+  queue.Append(data, sizeof(data));
+  queue.Read(drained, sizeof(drained));
+
+  core::AllocStats stats;
+  {
+    core::AllocTrackerScope scope;
+    auto* packet = pool.Acquire();
+    pool.Release(packet);
+    queue.Append(data, sizeof(data));
+    queue.Read(drained, sizeof(drained));
+    stats = core::AllocTracker::GetStats();
+  }
+  BOOST_CHECK_EQUAL(stats.allocations, 0u);
+  BOOST_CHECK_EQUAL(stats.bytes, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "tests/unit_tests/main.h"
+
+#include <cstdint>
+
+#include "core/util/bloom_filter.h"
+
+struct BloomFilterFixture
+{
+  core::RotatingBloomFilter filter;
+};
+
+BOOST_FIXTURE_TEST_SUITE(BloomFilterTests, BloomFilterFixture)
+
+BOOST_AUTO_TEST_CASE(InsertReportsNewOnce)
+{
+  BOOST_CHECK(filter.Insert(0xDEADBEEF));
+  BOOST_CHECK(!filter.Insert(0xDEADBEEF));
+  BOOST_CHECK(filter.Insert(0xCAFEBABE));
+  BOOST_CHECK(!filter.Insert(0xCAFEBABE));
+}
+
+BOOST_AUTO_TEST_CASE(SingleRotationRemembers)
+{
+  BOOST_CHECK(filter.Insert(42));
+  filter.Rotate();
+  BOOST_CHECK(!filter.Insert(42));
+}
+
+BOOST_AUTO_TEST_CASE(DoubleRotationForgets)
+{
+  BOOST_CHECK(filter.Insert(42));
+  filter.Rotate();
+  filter.Rotate();
+  // a key untouched for two rotations is forgotten
+  BOOST_CHECK(filter.Insert(42));
+}
+
+BOOST_AUTO_TEST_CASE(ManyKeysStayDistinct)
+{
+  for (std::uint64_t key = 1; key <= 1000; key++)
+    filter.Insert(key);
+  // membership holds for all recorded keys
+  for (std::uint64_t key = 1; key <= 1000; key++)
+    BOOST_CHECK(!filter.Insert(key));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
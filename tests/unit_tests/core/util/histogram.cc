@@ -0,0 +1,116 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "tests/unit_tests/main.h"
+
+#include <cstdint>
+
+#include "core/util/histogram.h"
+
+BOOST_AUTO_TEST_SUITE(LatencyHistogramTests)
+
+BOOST_AUTO_TEST_CASE(EmptySummaryIsZero)
+{
+  core::LatencyHistogram histogram;
+  const auto summary = histogram.GetSummary();
+  BOOST_CHECK_EQUAL(summary.count, 0u);
+  BOOST_CHECK_EQUAL(summary.p50, 0u);
+  BOOST_CHECK_EQUAL(summary.p999, 0u);
+  BOOST_CHECK_EQUAL(summary.max, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(SmallValuesAreExact)
+{
+  core::LatencyHistogram histogram;
+  // values below twice the sub-bucket count occupy one slot each
+  for (std::uint64_t value = 0; value < 10; value++)
+    histogram.Record(value);
+  const auto summary = histogram.GetSummary();
+  BOOST_CHECK_EQUAL(summary.count, 10u);
+  BOOST_CHECK_EQUAL(summary.p50, 4u);
+  BOOST_CHECK_EQUAL(summary.max, 9u);
+}
+
+BOOST_AUTO_TEST_CASE(PercentilesSeeTheTail)
+{
+  core::LatencyHistogram histogram;
+  // bimodal: the mean lands between the modes, p99/p999 must not
+  for (int i = 0; i < 990; i++)
+    histogram.Record(100);
+  for (int i = 0; i < 10; i++)
+    histogram.Record(8000);
+  const auto summary = histogram.GetSummary();
+  BOOST_CHECK_EQUAL(summary.count, 1000u);
+  // slot resolution is 12.5 percent, so compare with slack
+  BOOST_CHECK_LE(summary.p50, 120u);
+  BOOST_CHECK_GE(summary.p999, 7000u);
+  BOOST_CHECK_LE(summary.p999, 9000u);
+  BOOST_CHECK_EQUAL(summary.max, 8000u);
+  BOOST_CHECK_LT(summary.mean, 7000u);
+}
+
+BOOST_AUTO_TEST_CASE(PercentilesAreOrdered)
+{
+  core::LatencyHistogram histogram;
+  for (std::uint64_t value = 1; value <= 10000; value++)
+    histogram.Record(value);
+  const auto summary = histogram.GetSummary();
+  BOOST_CHECK_LE(summary.p50, summary.p90);
+  BOOST_CHECK_LE(summary.p90, summary.p99);
+  BOOST_CHECK_LE(summary.p99, summary.p999);
+  BOOST_CHECK_LE(summary.p999, summary.max);
+  // each reported percentile stays within the slot's relative error
+  BOOST_CHECK_GE(summary.p50, 5000u);
+  BOOST_CHECK_LE(summary.p50, 5625u);
+  BOOST_CHECK_GE(summary.p99, 9900u);
+  BOOST_CHECK_LE(summary.p99, 11250u);
+}
+
+BOOST_AUTO_TEST_CASE(OffScaleValuesSaturate)
+{
+  core::LatencyHistogram histogram;
+  histogram.Record(std::uint64_t(1) << 60);
+  const auto summary = histogram.GetSummary();
+  BOOST_CHECK_EQUAL(summary.count, 1u);
+  BOOST_CHECK_GT(summary.p50, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(ReportNamesEveryHistogram)
+{
+  const auto report = core::latency_histograms.Report();
+  for (std::uint8_t histogram = 0;
+       histogram < core::LatencyHistograms::NumHistograms;
+       histogram++)
+    BOOST_CHECK_NE(
+        report.find(core::LatencyHistograms::HistogramName(histogram)),
+        std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
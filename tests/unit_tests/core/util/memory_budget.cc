@@ -0,0 +1,98 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+
+
+#include "tests/unit_tests/main.h"
+
+#include <string>
+#include <vector>
+
+#include "core/util/memory_budget.h"
+
+struct MemoryBudgetFixture
+{
+  core::MemoryBudget budget;
+};
+
+BOOST_FIXTURE_TEST_SUITE(MemoryBudgetTests, MemoryBudgetFixture)
+
+BOOST_AUTO_TEST_CASE(AccountsPerSubsystem)
+{
+  budget.Add(core::MemoryBudget::I2NPPool, 100);
+  budget.Add(core::MemoryBudget::GarlicTags, 50);
+  budget.Sub(core::MemoryBudget::I2NPPool, 40);
+
+  BOOST_CHECK_EQUAL(budget.Get(core::MemoryBudget::I2NPPool), 60);
+  BOOST_CHECK_EQUAL(budget.Get(core::MemoryBudget::GarlicTags), 50);
+  BOOST_CHECK_EQUAL(budget.Get(core::MemoryBudget::Streaming), 0);
+  BOOST_CHECK_EQUAL(budget.GetTotal(), 110);
+}
+
+BOOST_AUTO_TEST_CASE(SetReplacesSampledFigure)
+{
+  budget.Add(core::MemoryBudget::I2NPPool, 100);
+  budget.Set(core::MemoryBudget::TransportQueues, 300);
+  BOOST_CHECK_EQUAL(budget.GetTotal(), 400);
+
+  budget.Set(core::MemoryBudget::TransportQueues, 20);
+  BOOST_CHECK_EQUAL(budget.Get(core::MemoryBudget::TransportQueues), 20);
+  BOOST_CHECK_EQUAL(budget.GetTotal(), 120);
+}
+
+BOOST_AUTO_TEST_CASE(ShedsInPriorityOrderAboveCeiling)
+{
+  std::vector<std::string> fired;
+  budget.RegisterShedder(1, "second", [&fired] { fired.push_back("second"); });
+  budget.RegisterShedder(0, "first", [&fired] { fired.push_back("first"); });
+  budget.SetCeiling(1000);
+
+  budget.Add(core::MemoryBudget::NetDbCache, 1000);
+  BOOST_CHECK(fired.empty());  // at the ceiling, not over it
+
+  budget.Add(core::MemoryBudget::NetDbCache, 1);
+  BOOST_REQUIRE_EQUAL(fired.size(), 2);
+  BOOST_CHECK_EQUAL(fired.at(0), "first");
+  BOOST_CHECK_EQUAL(fired.at(1), "second");
+
+  // still over budget, but inside the cooldown window
+  budget.Add(core::MemoryBudget::NetDbCache, 1);
+  BOOST_CHECK_EQUAL(fired.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ZeroCeilingNeverSheds)
+{
+  bool fired = false;
+  budget.RegisterShedder(0, "any", [&fired] { fired = true; });
+  budget.Add(core::MemoryBudget::Streaming, 1 << 30);
+  BOOST_CHECK(!fired);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
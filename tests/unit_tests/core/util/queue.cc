@@ -0,0 +1,109 @@
+/**                                                                                           //
+ * Copyright (c) 2015-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+
+#include "tests/unit_tests/main.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/util/queue.h"
+
+struct QueueFixture
+{
+  core::Queue<std::shared_ptr<int>> queue;
+  core::ShardedQueue<std::shared_ptr<int>> sharded;
+};
+
+BOOST_FIXTURE_TEST_SUITE(QueueTests, QueueFixture)
+
+BOOST_AUTO_TEST_CASE(GetBatchDrainsInOrder)
+{
+  for (int i = 0; i < 10; i++)
+    queue.Put(std::make_shared<int>(i));
+
+  std::vector<std::shared_ptr<int>> batch;
+  BOOST_CHECK_EQUAL(queue.GetBatch(batch, 4), 4);
+  BOOST_CHECK_EQUAL(batch.size(), 4);
+  BOOST_CHECK_EQUAL(*batch.front(), 0);
+  BOOST_CHECK_EQUAL(*batch.back(), 3);
+
+  BOOST_CHECK_EQUAL(queue.GetBatch(batch, 100), 6);
+  BOOST_CHECK_EQUAL(batch.size(), 10);
+  BOOST_CHECK_EQUAL(*batch.back(), 9);
+  BOOST_CHECK(queue.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(GetBatchEmpty)
+{
+  std::vector<std::shared_ptr<int>> batch;
+  BOOST_CHECK_EQUAL(queue.GetBatch(batch, 4), 0);
+  BOOST_CHECK(batch.empty());
+  BOOST_CHECK_EQUAL(queue.GetBatchWithTimeout(batch, 4, 1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ShardedPutAndDrain)
+{
+  for (int i = 0; i < 32; i++)
+    sharded.Put(std::make_shared<int>(i));
+  BOOST_CHECK_EQUAL(sharded.GetSize(), 32);
+
+  std::vector<std::shared_ptr<int>> batch;
+  BOOST_CHECK_EQUAL(sharded.GetBatch(batch, 32), 32);
+  BOOST_CHECK(sharded.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(ShardedKeyedOrdering)
+{
+  // all elements sharing a key land on one shard, in FIFO order
+  for (int i = 0; i < 8; i++)
+    sharded.PutKeyed(42, std::make_shared<int>(i));
+
+  std::vector<std::shared_ptr<int>> batch;
+  BOOST_CHECK_EQUAL(sharded.GetShardBatch(42, batch, 8), 8);
+  for (int i = 0; i < 8; i++)
+    BOOST_CHECK_EQUAL(*batch.at(i), i);
+}
+
+BOOST_AUTO_TEST_CASE(ShardedConcurrentProducers)
+{
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 4; t++)
+    producers.emplace_back([this] {
+      for (int i = 0; i < 100; i++)
+        sharded.Put(std::make_shared<int>(i));
+    });
+  for (auto& t : producers)
+    t.join();
+  BOOST_CHECK_EQUAL(sharded.GetSize(), 400);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2018, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ */
+
+#include "tests/unit_tests/main.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "core/util/startup.h"
+
+BOOST_AUTO_TEST_SUITE(StartupExecutorTests)
+
+BOOST_AUTO_TEST_CASE(DependenciesRunFirst)
+{
+  core::StartupExecutor startup;
+  std::atomic<int> sequence(0);
+  int first = 0, second = 0, third = 0;
+  startup.AddStage("first", [&] { first = ++sequence; });
+  startup.AddStage("second", [&] { second = ++sequence; }, {"first"});
+  startup.AddStage("third", [&] { third = ++sequence; }, {"first", "second"});
+  startup.Run();
+  BOOST_CHECK_LT(first, second);
+  BOOST_CHECK_LT(second, third);
+}
+
+BOOST_AUTO_TEST_CASE(IndependentStagesAllRun)
+{
+  core::StartupExecutor startup;
+  std::atomic<int> count(0);
+  for (int i = 0; i < 8; i++)
+    startup.AddStage("stage" + std::to_string(i), [&] { count++; });
+  startup.Run();
+  BOOST_CHECK_EQUAL(count.load(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(FailureAbandonsDependents)
+{
+  core::StartupExecutor startup;
+  bool dependent_ran = false;
+  startup.AddStage("failing", [] {
+    throw std::runtime_error("boom");
+  });
+  startup.AddStage(
+      "dependent", [&] { dependent_ran = true; }, {"failing"});
+  BOOST_CHECK_THROW(startup.Run(), std::runtime_error);
+  BOOST_CHECK(!dependent_ran);
+}
+
+BOOST_AUTO_TEST_CASE(UnknownDependencyRejected)
+{
+  core::StartupExecutor startup;
+  BOOST_CHECK_THROW(
+      startup.AddStage("stage", [] {}, {"missing"}), std::logic_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()